@@ -630,7 +630,10 @@ std::vector<std::byte> mainEncode() {
     ZoneScoped;
     LTRACE("main::mainEncode(begin)");
 
-    std::vector<std::byte> data = global::openSpaceEngine->encode();
+    // SGCT takes ownership of the synchronization data, so this is the only place where
+    // the encoded frame is copied
+    const std::span<const std::byte> encoded = global::openSpaceEngine->encode();
+    std::vector<std::byte> data(encoded.begin(), encoded.end());
 
     LTRACE("main::mainEncode(end)");
     return data;
@@ -0,0 +1,75 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___COLUMNKERNELS___H__
+#define __OPENSPACE_CORE___COLUMNKERNELS___H__
+
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * Kernels that operate on a single column of a Dataset or DatasetView. Each of them
+ * processes the values in blocks of SIMD registers when the instruction set is available
+ * (AVX if the build enables it, SSE2 on all x86-64 builds) and falls back to a scalar
+ * loop otherwise. NaN values are treated as missing values by all kernels.
+ */
+namespace openspace::dataloader::kernels {
+
+/**
+ * Returns the smallest and largest value in \p values, ignoring all NaN values. If there
+ * are no non-NaN values, the returned range is `(max float, -max float)`.
+ *
+ * \param values The values for which to find the range
+ * \return The minimum value in `x` and the maximum value in `y`
+ */
+glm::vec2 findValueRange(std::span<const float> values);
+
+/**
+ * Maps every value in \p values from the range [\p minValue, \p maxValue] to [0, 1].
+ * NaN values stay NaN.
+ *
+ * \param values The values that are normalized in place
+ * \param minValue The value that is mapped to 0
+ * \param maxValue The value that is mapped to 1
+ */
+void normalize(std::span<float> values, float minValue, float maxValue);
+
+/**
+ * Appends the indices of all values that are in the closed range [\p minValue,
+ * \p maxValue] to \p result in increasing order. NaN values are never in range.
+ *
+ * \param values The values that are tested
+ * \param minValue The lower bound of the range
+ * \param maxValue The upper bound of the range
+ * \param result The vector to which the indices of the values in range are appended
+ * \return The number of indices that were appended
+ */
+size_t filterInRange(std::span<const float> values, float minValue, float maxValue,
+    std::vector<uint32_t>& result);
+
+} // namespace openspace::dataloader::kernels
+
+#endif // __OPENSPACE_CORE___COLUMNKERNELS___H__
@@ -26,16 +26,22 @@
 #define __OPENSPACE_CORE___DATALOADER___H__
 
 #include <openspace/data/datamapping.h>
+#include <openspace/util/memorymappedfile.h>
 #include <ghoul/glm.h>
 #include <ghoul/misc/boolean.h>
 #include <ghoul/misc/csvreader.h>
+#include <cstdint>
 #include <filesystem>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace openspace::dataloader {
 
+struct DatasetView;
+
 /**
  * A dataset representing objects with positions and various other data columns.
  * Based on the SPECK format originally used for the digital universe datasets.
@@ -43,6 +49,12 @@ namespace openspace::dataloader {
  *
  * The read data files may also have associated texture values to be used for the
  * points.
+ *
+ * The data is stored in a columnar layout: the positions of all entries are stored in
+ * one packed array, the values for each data index are stored in one contiguous column,
+ * and the comments of all entries share a single string pool. This means that operations
+ * that work on a single variable, such as finding its range, only touch the memory of
+ * that variable.
  */
 struct Dataset {
     struct Variable {
@@ -60,25 +72,106 @@ struct Dataset {
     int textureDataIndex = -1;
     int orientationDataIndex = -1;
 
-    struct Entry {
-        glm::vec3 position = glm::vec3(0.f);
-        std::vector<float> data;
-        std::optional<std::string> comment;
-    };
-    std::vector<Entry> entries;
+    /// The position of each entry in the dataset
+    std::vector<glm::vec3> positions;
+
+    /// One column per data index, each containing the values of all entries in order
+    std::vector<std::vector<float>> columns;
+
+    /// Contains `size() + 1` offsets into the #commentPool. The comment for entry `i` is
+    /// stored in the range `[commentOffsets[i], commentOffsets[i + 1])` and an empty
+    /// range means that the entry does not have a comment
+    std::vector<uint64_t> commentOffsets = { 0 };
+    std::string commentPool;
 
     /// This variable can be used to get an understanding of the world scale size of
     /// the dataset
     float maxPositionComponent = 0.f;
 
+    size_t size() const;
     bool isEmpty() const;
 
+    /// Returns the number of data values that are stored for each entry
+    size_t nValues() const;
+
+    /**
+     * Adds a new entry to the end of the dataset. If the dataset does not have any
+     * columns yet, one column is created for each of the \p values.
+     *
+     * \param position The position of the new entry
+     * \param values The data values of the new entry, one for each column
+     * \param comment The optional comment of the new entry
+     */
+    void addEntry(const glm::vec3& position, std::span<const float> values,
+        std::optional<std::string_view> comment = std::nullopt);
+
+    /// Reserves memory for \p nEntries entries in the positions and all columns
+    void reserve(size_t nEntries);
+
+    /// Returns the comment of the entry \p entry, if it has one
+    std::optional<std::string_view> comment(size_t entry) const;
+
+    /// Returns a view on this dataset that is valid for as long as it is not modified
+    DatasetView view() const;
+
     int index(std::string_view variableName) const;
     bool normalizeVariable(std::string_view variableName);
     glm::vec2 findValueRange(int variableIndex) const;
     glm::vec2 findValueRange(std::string_view variableName) const;
 };
 
+/**
+ * A read-only, columnar view of a dataset whose values are stored elsewhere, for example
+ * in a Dataset or in a memory-mapped cache file (see data::mapCachedFile). The layout is
+ * the same as for the Dataset. None of the spans own their data, so the view is only
+ * valid for as long as the storage it was created from.
+ */
+struct DatasetView {
+    std::span<const Dataset::Variable> variables;
+    std::span<const Dataset::Texture> textures;
+
+    int textureDataIndex = -1;
+    int orientationDataIndex = -1;
+
+    /// The positions of all entries in the dataset
+    std::span<const glm::vec3> positions;
+
+    /// One column per data index, each containing the values of all entries in order
+    std::vector<std::span<const float>> columns;
+
+    /// See Dataset::commentOffsets
+    std::span<const uint64_t> commentOffsets;
+    std::string_view commentPool;
+
+    float maxPositionComponent = 0.f;
+
+    size_t size() const;
+    bool isEmpty() const;
+
+    /// Returns the number of data values that are stored for each entry
+    size_t nValues() const;
+
+    /// Returns the comment of the entry \p entry, if it has one
+    std::optional<std::string_view> comment(size_t entry) const;
+
+    int index(std::string_view variableName) const;
+    glm::vec2 findValueRange(int variableIndex) const;
+    glm::vec2 findValueRange(std::string_view variableName) const;
+};
+
+/**
+ * A dataset that is backed by a memory-mapped cache file. The #view points directly into
+ * the mapped file, so no per-entry memory is allocated when it is opened and the pages of
+ * the file are only read from disk when they are accessed. The members of this struct
+ * should be treated as read-only, as the #view references them.
+ */
+struct MappedDataset {
+    MemoryMappedFile file;
+    std::vector<Dataset::Variable> variables;
+    std::vector<Dataset::Texture> textures;
+    DatasetView view;
+};
+
 struct Labelset {
     int textColorIndex = -1;
 
@@ -109,6 +202,27 @@ namespace data {
     Dataset loadFileWithCache(std::filesystem::path path,
         std::optional<DataMapping> specs = std::nullopt);
 
+    /**
+     * Maps the cache file at \p path into memory without deserializing it. Returns
+     * `std::nullopt` if the file does not exist, is from an incompatible version, or is
+     * corrupted.
+     */
+    std::optional<MappedDataset> mapCachedFile(const std::filesystem::path& path);
+
+    /**
+     * Same as loadFileWithCache, but returns the memory-mapped cache file instead of a
+     * deserialized Dataset. If no valid cache file exists, the data file is loaded and
+     * the cache file is created first. Returns `std::nullopt` if the data file did not
+     * contain any entries, as no cache file is created in that case.
+     */
+    std::optional<MappedDataset> mapFileWithCache(std::filesystem::path path,
+        std::optional<DataMapping> specs = std::nullopt);
+
+    /**
+     * Creates a Dataset that contains a copy of all of the values in the \p view.
+     */
+    Dataset toDataset(const DatasetView& view);
+
 } // namespace data
 
 namespace label {
@@ -122,6 +236,7 @@ namespace label {
     Labelset loadFileWithCache(std::filesystem::path path);
 
     Labelset loadFromDataset(const dataloader::Dataset& dataset);
+    Labelset loadFromDataset(const dataloader::DatasetView& dataset);
 } // namespace label
 
 namespace color {
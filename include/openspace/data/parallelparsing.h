@@ -0,0 +1,88 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___PARALLELPARSING___H__
+#define __OPENSPACE_CORE___PARALLELPARSING___H__
+
+#include <charconv>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+/**
+ * Helper functions that are shared between the data file loaders to parse a file that
+ * has been mapped into memory on multiple threads. The file is split into chunks that
+ * only contain complete lines, each chunk is parsed independently, and the results are
+ * merged in the order of the chunks afterwards.
+ */
+namespace openspace::dataloader {
+
+/**
+ * Returns the number of threads that should be used to parse \p nBytes bytes of text.
+ * Small inputs are parsed on a single thread, as the cost of starting additional threads
+ * would be larger than the gain.
+ *
+ * \param nBytes The number of bytes that should be parsed
+ * \return The number of threads, which is always at least 1
+ */
+size_t parsingThreadCount(size_t nBytes);
+
+/**
+ * Splits \p data into at most \p nChunks consecutive chunks of roughly equal size. Each
+ * chunk except the last one ends directly after a newline character, so no line is ever
+ * split between two chunks. Concatenating all chunks results in \p data again.
+ *
+ * \param data The text that should be split
+ * \param nChunks The maximum number of chunks that are created
+ * \return The chunks in the order in which they appear in \p data
+ */
+std::vector<std::string_view> splitIntoLineChunks(std::string_view data, size_t nChunks);
+
+/**
+ * Parses a floating point value at the beginning of [\p first, \p last) with the same
+ * rules and results as `std::from_chars` in the general format. This function exists as
+ * not all standard libraries that are supported provide the floating point overloads of
+ * `std::from_chars`. The input does not have to be null-terminated.
+ *
+ * \param first The beginning of the characters that are parsed
+ * \param last The end of the characters that are parsed
+ * \param value The parsed value, which is only modified if parsing was successful
+ * \return The pointer to the first character that was not parsed and the error code
+ */
+std::from_chars_result floatFromChars(const char* first, const char* last, float& value);
+
+/**
+ * Calls \p function once for each index in [0, \p n) on the worker threads of a
+ * TaskScheduler that is shared by all data loaders, and returns when all calls have
+ * finished. The index 0 is executed on the calling thread. The \p function must not
+ * throw.
+ *
+ * \param n The number of times that \p function is called
+ * \param function The function that is called with the index of the call
+ */
+void runInParallel(size_t n, const std::function<void(size_t)>& function);
+
+} // namespace openspace::dataloader
+
+#endif // __OPENSPACE_CORE___PARALLELPARSING___H__
@@ -109,6 +109,10 @@ struct Configuration {
     bool usePerProfileCache = false;
 
     bool isRenderingOnMasterDisabled = false;
+    bool useDeltaSynchronization = false;
+    int synchronizationKeyframeInterval = 60;
+    bool useEphemerisCache = false;
+    double ephemerisCacheTolerance = 1.0;
     glm::vec3 globalRotation = glm::vec3(0.0);
     glm::vec3 screenSpaceRotation = glm::vec3(0.0);
     glm::vec3 masterRotation = glm::vec3(0.0);
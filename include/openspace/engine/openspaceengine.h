@@ -40,6 +40,7 @@
 #include <ghoul/glm.h>
 #include <future>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -112,8 +113,8 @@ public:
     void touchUpdateCallback(TouchInput input);
     void touchExitCallback(TouchInput input);
     void handleDragDrop(std::filesystem::path file);
-    std::vector<std::byte> encode();
-    void decode(std::vector<std::byte> data);
+    std::span<const std::byte> encode();
+    void decode(std::span<const std::byte> data);
 
     properties::Property::Visibility visibility() const;
     void toggleShutdownMode();
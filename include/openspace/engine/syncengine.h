@@ -28,7 +28,9 @@
 #include <openspace/util/syncbuffer.h>
 
 #include <ghoul/misc/boolean.h>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <vector>
 
 namespace openspace {
@@ -38,6 +40,15 @@ class Syncable;
 /**
  * Manages a collection of `Syncable`s and ensures they are synchronized over SGCT nodes.
  * Encoding/Decoding order is handles internally.
+ *
+ * If delta encoding is enabled, the master only sends the encoded bytes of the Syncables
+ * that have changed since the previous frame. The clients keep the last received bytes
+ * of every Syncable and decode all of them every frame, so the result is the same as if
+ * the full state had been sent. Every `keyframeInterval` frames, the full state is sent
+ * as a keyframe, which allows clients that have missed a frame to resynchronize. Every
+ * frame carries a checksum of the full state which the clients use to detect when they
+ * are out of sync. While a client is out of sync, it does not decode any Syncables until
+ * the next keyframe has been verified.
  */
 class SyncEngine {
 public:
@@ -52,15 +63,35 @@ public:
 
     /**
      * Encodes all added Syncables in the injected `SyncBuffer`. This method is only
-     * called on the SGCT master node.
+     * called on the SGCT master node. The returned bytes are stored in a buffer that is
+     * reused every frame and they are only valid until the next call to
+     * `encodeSyncables` or `decodeSyncables`.
      */
-    std::vector<std::byte> encodeSyncables();
+    std::span<const std::byte> encodeSyncables();
 
     /**
      * Decodes the `SyncBuffer` into the added Syncables. This method is only called on
-     * the SGCT client nodes.
+     * the SGCT client nodes. The \p data is not copied and only has to be valid for the
+     * duration of this call.
      */
-    void decodeSyncables(std::vector<std::byte> data);
+    void decodeSyncables(std::span<const std::byte> data);
+
+    /**
+     * Enables or disables the delta encoding of the synchronized state. This only has to
+     * be set on the master node, as the clients detect the encoding from the data.
+     *
+     * \param enabled Whether the delta encoding should be used
+     * \param keyframeInterval The number of frames after which the full state is sent
+     *
+     * \pre keyframeInterval must be bigger than 0
+     */
+    void setDeltaEncoding(bool enabled, int keyframeInterval = 60);
+
+    /**
+     * Returns `false` if this client has detected that its synchronized state differs
+     * from the master's state and is waiting for the next keyframe.
+     */
+    bool isInSync() const;
 
     /**
      * Invokes the presync method of all added Syncables.
@@ -97,11 +128,34 @@ public:
     void removeSyncables(const std::vector<Syncable*>& syncables);
 
 private:
+    enum class FrameType : uint8_t {
+        Full = 0,
+        Keyframe,
+        Delta
+    };
+
+    std::span<const std::byte> encodeDelta();
+    void decodeDelta(FrameType type, std::span<const std::byte> data);
+
     /// Vector of Syncables. The vectors ensures consistent encode/decode order.
     std::vector<Syncable*> _syncables;
 
     /// Databuffer used in encoding/decoding
     SyncBuffer _syncBuffer;
+
+    bool _useDeltaEncoding = false;
+    int _keyframeInterval = 60;
+    bool _forceKeyframe = true;
+    uint32_t _frameNumber = 0;
+    bool _isInSync = true;
+    bool _hasReceivedKeyframe = false;
+
+    /// The encoded bytes of each Syncable in the last frame that was sent or received
+    std::vector<std::vector<std::byte>> _syncableState;
+    /// The byte offsets of the Syncables in the SyncBuffer of the current frame
+    std::vector<size_t> _syncableOffsets;
+    /// The delta encoded frame that was returned by the last call to encodeSyncables
+    std::vector<std::byte> _encodedFrame;
 };
 
 } // namespace openspace
@@ -63,14 +63,14 @@ public:
      *
      * \param dataset The *loaded* input dataset
      */
-    void initialize(const dataloader::Dataset& dataset);
+    void initialize(const dataloader::DatasetView& dataset);
 
     /**
      * Initialize a 1D texture based on the entries in the color map file.
      */
     void initializeTexture();
 
-    void update(const dataloader::Dataset& dataset);
+    void update(const dataloader::DatasetView& dataset);
 
     static documentation::Documentation Documentation();
 
@@ -98,7 +98,7 @@ private:
      * Fill parameter options list and range data based on the dataset and provided
      * information.
      */
-    void initializeParameterData(const dataloader::Dataset& dataset);
+    void initializeParameterData(const dataloader::DatasetView& dataset);
 
     // One item per color parameter option
     std::vector<glm::vec2> _colorRangeData;
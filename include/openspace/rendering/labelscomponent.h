@@ -65,7 +65,7 @@ public:
      *        a string to be used for the text.
      * \param unit The unit to use when interpreting the point information in the dataset
      */
-    void loadLabelsFromDataset(const dataloader::Dataset& dataset, DistanceUnit unit);
+    void loadLabelsFromDataset(const dataloader::DatasetView& dataset, DistanceUnit unit);
 
     void loadLabels();
 
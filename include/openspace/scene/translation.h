@@ -27,9 +27,12 @@
 
 #include <openspace/properties/propertyowner.h>
 
+#include <openspace/util/taskscheduler.h>
 #include <ghoul/glm.h>
 #include <ghoul/misc/managedmemoryuniqueptr.h>
 #include <functional>
+#include <optional>
+#include <vector>
 
 namespace ghoul { class Dictionary; }
 
@@ -53,6 +56,20 @@ public:
 
     virtual glm::dvec3 position(const UpdateData& data) const = 0;
 
+    /**
+     * Requests the positions at each of the \p times without blocking the calling
+     * thread. Translations that can compute their positions away from the main thread
+     * return a future that will contain the positions in the same order as the \p times.
+     * All other translations return `std::nullopt`, in which case the positions have to
+     * be computed by calling #position for each of the times instead.
+     *
+     * \param times The times, in J2000 seconds, for which the positions are requested
+     * \return The future that will contain the positions, or `std::nullopt` if this
+     *         translation does not support asynchronous requests
+     */
+    virtual std::optional<TaskFuture<std::vector<glm::dvec3>>> requestPositions(
+        std::vector<double> times) const;
+
     // Registers a callback that gets called when a significant change has been made that
     // invalidates potentially stored points, for example in trails
     void onParameterChange(std::function<void()> callback);
@@ -36,7 +36,8 @@ template <typename T> struct Job;
 
 /**
  * Templated Concurrent Job Manager
- * This class is used execute specific jobs on one (1) parallel thread
+ * This class is used execute specific jobs on the threads of the provided ThreadPool. The
+ * pool can either own its threads or share a TaskScheduler with other systems.
  */
 template<typename P>
 class ConcurrentJobManager {
@@ -0,0 +1,206 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___EPHEMERISCACHE___H__
+#define __OPENSPACE_CORE___EPHEMERISCACHE___H__
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A cache that approximates time-dependent ephemeris quantities, such as the position of
+ * a target relative to an observer or the rotation between two reference frames, by
+ * piecewise Chebyshev polynomials. Each entry samples the exact quantity at the
+ * Chebyshev nodes of a segment of time and, after checking the fit against additional
+ * samples, answers all further queries inside the segment without asking for the exact
+ * value again. Segments that do not fit within the tolerance are split in half until
+ * they do or until they reach the minimum length, in which case the entry is not cached.
+ *
+ * Only a small window of segments around the most recently queried times is kept for
+ * each entry. A segment is only created when two consecutive misses of an entry fall into
+ * the same segment, so that quantities that are queried at times far apart, for example
+ * with a high delta time, do not pay for the sampling of segments that would be used
+ * only once.
+ *
+ * This class is not thread-safe.
+ */
+class EphemerisCache {
+public:
+    /// The kinds of quantities that are stored in the cache
+    enum class Quantity {
+        /// The x, y, and z coordinates of a position in km and the light time in seconds
+        Position = 0,
+        /// The nine elements of a 3x3 rotation matrix
+        Rotation
+    };
+
+    /**
+     * Identifies an entry in the cache. For positions, these are the target, observer,
+     * reference frame, and aberration correction. For rotations, the \p target is the
+     * source frame, the \p observer is the destination frame and the remaining values
+     * are empty.
+     */
+    struct Key {
+        std::string_view target = {};
+        std::string_view observer = {};
+        std::string_view frame = {};
+        std::string_view aberrationCorrection = {};
+    };
+
+    struct Settings {
+        /// The maximum error of a cached position in km
+        double positionTolerance = 1e-3;
+        /// The maximum error of each element of a cached rotation matrix
+        double rotationTolerance = 1e-10;
+        /// The length of the longest segment in seconds
+        double segmentLength = 3600.0;
+        /// The length of the shortest segment in seconds
+        double minimumSegmentLength = 1.0;
+        /// The number of segments that are kept for each entry
+        int nSegmentsPerEntry = 4;
+    };
+
+    /**
+     * Samples the exact value of a quantity at the provided time and writes it into the
+     * provided values. The number of values is the number of components of the quantity.
+     */
+    using Sampler = std::function<void(double time, std::span<double> values)>;
+
+    /// The number of values that are written by a Sampler for each Quantity
+    static constexpr int nComponents(Quantity quantity) {
+        return quantity == Quantity::Position ? 4 : 9;
+    }
+
+    EphemerisCache();
+    explicit EphemerisCache(Settings settings);
+
+    /**
+     * Looks up the value of the \p quantity identified by the \p key at the \p time in
+     * the cache and writes it into the \p result.
+     *
+     * \param quantity The kind of quantity that is requested
+     * \param key The key that identifies the requested entry
+     * \param time The time for which the value is requested
+     * \param result The destination of the value, which has to contain as many elements
+     *        as the \p quantity has components
+     * \return `true` if the value was cached, `false` otherwise, in which case the
+     *         \p result is not modified
+     */
+    bool find(Quantity quantity, const Key& key, double time,
+        std::span<double> result);
+
+    /**
+     * Informs the cache that the value of the \p quantity identified by the \p key was
+     * not found at the \p time. If the previous miss of the same entry happened within
+     * the same segment, a segment is created by calling the \p sampler. Exceptions that
+     * are thrown from the \p sampler are caught and prevent the segment from being
+     * cached.
+     *
+     * \param quantity The kind of quantity that was requested
+     * \param key The key that identifies the requested entry
+     * \param time The time for which the value was requested
+     * \param sampler The function that provides the exact values of the quantity
+     */
+    void miss(Quantity quantity, const Key& key, double time, const Sampler& sampler);
+
+    /**
+     * Removes all entries from the cache. This has to be called whenever the data from
+     * which the exact values are computed changes, for example when kernels are loaded or
+     * unloaded.
+     */
+    void clear();
+
+    /**
+     * Changes the settings of the cache, which also removes all cached entries.
+     */
+    void setSettings(Settings settings);
+    const Settings& settings() const;
+
+    /// Returns the number of segments that are currently stored over all entries
+    size_t nSegments() const;
+
+private:
+    struct Segment {
+        double begin = 0.0;
+        double end = 0.0;
+        /// The Chebyshev coefficients, stored consecutively for each component
+        std::vector<double> coefficients;
+        uint64_t lastUsed = 0;
+    };
+
+    struct Entry {
+        std::vector<Segment> segments;
+        /// The number of times the segment length was halved for this entry
+        int level = 0;
+        /// The segment in which the last miss occurred
+        int64_t lastMissSlot = -1;
+        bool hasMissed = false;
+    };
+
+    struct StoredKey {
+        std::string target;
+        std::string observer;
+        std::string frame;
+        std::string aberrationCorrection;
+    };
+
+    struct KeyHash {
+        using is_transparent = void;
+        size_t operator()(const Key& key) const;
+        size_t operator()(const StoredKey& key) const;
+    };
+
+    struct KeyEqual {
+        using is_transparent = void;
+        bool operator()(const Key& lhs, const StoredKey& rhs) const;
+        bool operator()(const StoredKey& lhs, const Key& rhs) const;
+        bool operator()(const StoredKey& lhs, const StoredKey& rhs) const;
+    };
+
+    using Table = std::unordered_map<StoredKey, Entry, KeyHash, KeyEqual>;
+
+    /**
+     * Samples the quantity over the provided segment and fits the Chebyshev coefficients.
+     * Returns `false` if the fit does not stay within the tolerance of the quantity.
+     */
+    bool fitSegment(Quantity quantity, Segment& segment, const Sampler& sampler) const;
+
+    double segmentLength(int level) const;
+
+    Settings _settings;
+    std::array<Table, 2> _tables;
+    uint64_t _useCounter = 0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___EPHEMERISCACHE___H__
@@ -0,0 +1,128 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___LOCKFREE_CONCURRENT_QUEUE___H__
+#define __OPENSPACE_CORE___LOCKFREE_CONCURRENT_QUEUE___H__
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace openspace {
+
+/**
+ * A bounded multi-producer/multi-consumer queue that does not use any locks. Its capacity
+ * is fixed at construction and rounded up to the next power of two. Every slot carries a
+ * sequence number that tells producers and consumers whether the slot is free or filled,
+ * so a push or pop only consists of a single compare-and-swap on the shared position
+ * counter (based on the bounded MPMC queue by Dmitry Vyukov).
+ *
+ * The bulk operations reserve a contiguous range of slots with a single compare-and-swap,
+ * which makes it possible to drain all available items in one call without any per-item
+ * synchronization between the consumers.
+ *
+ * The stored type has to be default constructible and move assignable; popped slots are
+ * left in a moved-from state until they are reused.
+ */
+template <typename T>
+class LockFreeConcurrentQueue {
+public:
+    explicit LockFreeConcurrentQueue(size_t capacity);
+
+    LockFreeConcurrentQueue(const LockFreeConcurrentQueue&) = delete;
+    LockFreeConcurrentQueue& operator=(const LockFreeConcurrentQueue&) = delete;
+
+    /**
+     * Adds the \p item to the queue if there is space left. Returns `false` and leaves
+     * \p item untouched if the queue is full.
+     */
+    bool tryPush(T&& item);
+    bool tryPush(const T& item);
+
+    /**
+     * Adds the \p item to the queue, yielding the calling thread until there is space.
+     */
+    void push(T item);
+
+    /**
+     * Moves as many of the \p count items starting at \p items into the queue as there
+     * is space for and returns the number of items that were pushed. The pushed items
+     * occupy consecutive positions in the queue.
+     */
+    size_t tryPushBulk(T* items, size_t count);
+
+    /**
+     * Moves all \p count items starting at \p items into the queue, yielding the calling
+     * thread whenever the queue is full.
+     */
+    void pushBulk(T* items, size_t count);
+
+    /**
+     * Removes the oldest item and writes it to \p item. Returns `false` if the queue was
+     * empty.
+     */
+    bool tryPop(T& item);
+
+    /**
+     * Removes up to \p maxCount of the oldest items and writes them to the output
+     * iterator \p out. Returns the number of items that were removed.
+     */
+    template <typename OutputIt>
+    size_t tryPopBulk(OutputIt out, size_t maxCount);
+
+    /**
+     * Returns the number of items in the queue. As other threads might modify the queue
+     * concurrently, the value is only a snapshot.
+     */
+    size_t size() const;
+
+    bool empty() const;
+
+    size_t capacity() const;
+
+private:
+    // Assumed size of a cache line, used to keep the producer and consumer counters from
+    // sharing a cache line
+    static constexpr size_t CacheLineSize = 64;
+
+    struct Cell {
+        std::atomic_size_t sequence;
+        T data;
+    };
+
+    size_t reserve(std::atomic_size_t& position, size_t maxCount, size_t offset,
+        size_t& start);
+
+    const size_t _mask;
+    std::unique_ptr<Cell[]> _cells;
+
+    alignas(CacheLineSize) std::atomic_size_t _enqueuePosition = 0;
+    alignas(CacheLineSize) std::atomic_size_t _dequeuePosition = 0;
+};
+
+} // namespace openspace
+
+#include "lockfreeconcurrentqueue.inl"
+
+#endif // __OPENSPACE_CORE___LOCKFREE_CONCURRENT_QUEUE___H__
@@ -0,0 +1,162 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <algorithm>
+#include <bit>
+#include <thread>
+#include <utility>
+
+namespace openspace {
+
+template <typename T>
+LockFreeConcurrentQueue<T>::LockFreeConcurrentQueue(size_t capacity)
+    : _mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1)
+    , _cells(std::make_unique<Cell[]>(_mask + 1))
+{
+    for (size_t i = 0; i <= _mask; i++) {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+size_t LockFreeConcurrentQueue<T>::reserve(std::atomic_size_t& position, size_t maxCount,
+                                           size_t offset, size_t& start)
+{
+    // A cell at position `pos` is ready for a producer if its sequence is `pos` and ready
+    // for a consumer if its sequence is `pos + 1`; `offset` selects between the two. We
+    // count how many consecutive cells are ready and claim all of them with a single
+    // compare-and-swap. A ready cell can only become unready by a thread that claimed it
+    // through `position`, so the count is still valid if the compare-and-swap succeeds
+    size_t pos = position.load(std::memory_order_relaxed);
+    while (true) {
+        size_t count = 0;
+        while (count < maxCount) {
+            const Cell& cell = _cells[(pos + count) & _mask];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            if (seq != pos + count + offset) {
+                break;
+            }
+            count++;
+        }
+
+        if (count == 0) {
+            // Either the queue is full (or empty), or another thread has claimed the cell
+            // at `pos` in the meantime. Only the latter is worth another try
+            const size_t current = position.load(std::memory_order_relaxed);
+            if (current == pos) {
+                return 0;
+            }
+            pos = current;
+            continue;
+        }
+
+        if (position.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+            start = pos;
+            return count;
+        }
+        // `pos` was updated by the failed compare-and-swap, so we just try again
+    }
+}
+
+template <typename T>
+bool LockFreeConcurrentQueue<T>::tryPush(T&& item) {
+    return tryPushBulk(&item, 1) == 1;
+}
+
+template <typename T>
+bool LockFreeConcurrentQueue<T>::tryPush(const T& item) {
+    T copy = item;
+    return tryPushBulk(&copy, 1) == 1;
+}
+
+template <typename T>
+void LockFreeConcurrentQueue<T>::push(T item) {
+    while (!tryPush(std::move(item))) {
+        std::this_thread::yield();
+    }
+}
+
+template <typename T>
+size_t LockFreeConcurrentQueue<T>::tryPushBulk(T* items, size_t count) {
+    size_t start = 0;
+    const size_t n = reserve(_enqueuePosition, count, 0, start);
+    for (size_t i = 0; i < n; i++) {
+        Cell& cell = _cells[(start + i) & _mask];
+        cell.data = std::move(items[i]);
+        cell.sequence.store(start + i + 1, std::memory_order_release);
+    }
+    return n;
+}
+
+template <typename T>
+void LockFreeConcurrentQueue<T>::pushBulk(T* items, size_t count) {
+    while (count > 0) {
+        const size_t n = tryPushBulk(items, count);
+        items += n;
+        count -= n;
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template <typename T>
+bool LockFreeConcurrentQueue<T>::tryPop(T& item) {
+    return tryPopBulk(&item, 1) == 1;
+}
+
+template <typename T>
+template <typename OutputIt>
+size_t LockFreeConcurrentQueue<T>::tryPopBulk(OutputIt out, size_t maxCount) {
+    size_t start = 0;
+    const size_t n = reserve(_dequeuePosition, maxCount, 1, start);
+    for (size_t i = 0; i < n; i++) {
+        Cell& cell = _cells[(start + i) & _mask];
+        *out = std::move(cell.data);
+        ++out;
+        cell.sequence.store(start + i + _mask + 1, std::memory_order_release);
+    }
+    return n;
+}
+
+template <typename T>
+size_t LockFreeConcurrentQueue<T>::size() const {
+    const size_t dequeue = _dequeuePosition.load(std::memory_order_relaxed);
+    const size_t enqueue = _enqueuePosition.load(std::memory_order_relaxed);
+    // Producers might have claimed positions whose data is not yet visible, and the two
+    // loads are not atomic with respect to each other, so clamp the result
+    return enqueue > dequeue ? std::min(enqueue - dequeue, _mask + 1) : 0;
+}
+
+template <typename T>
+bool LockFreeConcurrentQueue<T>::empty() const {
+    return size() == 0;
+}
+
+template <typename T>
+size_t LockFreeConcurrentQueue<T>::capacity() const {
+    return _mask + 1;
+}
+
+} // namespace openspace
@@ -0,0 +1,101 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___MEMORYMAPPEDFILE___H__
+#define __OPENSPACE_CORE___MEMORYMAPPEDFILE___H__
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace openspace {
+
+/**
+ * A read-only view of the contents of a file that is mapped into the address space of
+ * the process. Pages are only read from disk when they are first accessed and are shared
+ * with the operating system's file cache, so opening even a very large file is cheap and
+ * does not copy its contents. The mapping is kept alive for the lifetime of this object.
+ */
+class MemoryMappedFile {
+public:
+    /**
+     * Creates an object that does not map any file and whose data() is empty.
+     */
+    MemoryMappedFile() = default;
+
+    /**
+     * Maps the full contents of the file at \p path into memory.
+     *
+     * \param path The path to the file that should be mapped
+     *
+     * \throw ghoul::RuntimeError If the file could not be opened or mapped
+     */
+    explicit MemoryMappedFile(const std::filesystem::path& path);
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+    MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept;
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    /**
+     * Returns the contents of the mapped file. The returned span is valid for as long as
+     * this object is alive. The start of the span is aligned to at least the page size.
+     *
+     * \return The contents of the mapped file
+     */
+    std::span<const std::byte> data() const;
+
+    /**
+     * Returns the size of the mapped file in bytes.
+     *
+     * \return The size of the mapped file in bytes
+     */
+    size_t size() const;
+
+    /**
+     * Tells the operating system that the bytes in [\p offset, \p offset + \p size) will
+     * be accessed soon, so that they can be read from disk in the background. This is
+     * only a hint and returns immediately. Ranges outside of the file are clamped.
+     *
+     * \param offset The offset of the first byte that will be accessed
+     * \param size The number of bytes that will be accessed
+     */
+    void prefetch(size_t offset, size_t size) const;
+
+private:
+    void unmap();
+
+    const std::byte* _data = nullptr;
+    size_t _size = 0;
+
+#ifdef WIN32
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#endif // WIN32
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___MEMORYMAPPEDFILE___H__
@@ -25,6 +25,7 @@
 #ifndef __OPENSPACE_CORE___SPICEMANAGER___H__
 #define __OPENSPACE_CORE___SPICEMANAGER___H__
 
+#include <openspace/util/ephemeriscache.h>
 #include <ghoul/format.h>
 #include <ghoul/glm.h>
 #include <ghoul/misc/assert.h>
@@ -32,9 +33,11 @@
 #include <ghoul/misc/exception.h>
 #include <array>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
-#include <set>
 
 #ifdef __clang__
 #pragma clang diagnostic push
@@ -56,6 +59,7 @@
 namespace openspace {
 
 namespace scripting { struct LuaLibrary; }
+class SpiceQueryService;
 
 void throwSpiceError(const std::string& errorMessage);
 
@@ -576,6 +580,7 @@ public:
         static_assert(N != 0, "Format must not be empty");
         ghoul_assert(N >= bufferSize - 1, "Buffer size too small");
 
+        std::lock_guard lock(_mutex);
         timout_c(ephemerisTime, format, bufferSize, outBuf);
         if (failed_c()) {
             throwSpiceError(std::format(
@@ -1009,6 +1014,46 @@ public:
      */
     UseException exceptionHandling() const;
 
+    /**
+     * Enables or disables the EphemerisCache that answers calls to #targetPosition and
+     * #positionTransformMatrix by evaluating polynomial approximations of the positions
+     * and rotations instead of calling into CSPICE for every query. The results of the
+     * cached functions differ from the exact values by at most the tolerances that are
+     * specified in the \p settings. Changing the state of the cache removes all of its
+     * entries.
+     *
+     * \param enabled Whether the cache should be used
+     * \param settings The settings of the cache, including the tolerances
+     */
+    void setEphemerisCacheEnabled(bool enabled,
+        EphemerisCache::Settings settings = EphemerisCache::Settings());
+
+    /**
+     * Returns whether the EphemerisCache is currently used by #targetPosition and
+     * #positionTransformMatrix.
+     */
+    bool isEphemerisCacheEnabled() const;
+
+    /**
+     * Removes all entries from the EphemerisCache. This happens automatically whenever a
+     * kernel is loaded or unloaded, but has to be called manually if the kernel pool is
+     * modified through other means than this class.
+     */
+    void invalidateEphemerisCache();
+
+    /**
+     * Returns the service through which batched queries can be executed asynchronously
+     * on a dedicated thread. See SpiceQueryService for more information.
+     */
+    SpiceQueryService& queryService();
+
+    /**
+     * Returns the mutex that serializes all calls into CSPICE, which is not reentrant.
+     * All member functions of this class lock this mutex, so it only has to be locked by
+     * code that calls CSPICE functions directly.
+     */
+    std::recursive_mutex& spiceMutex() const;
+
     static scripting::LuaLibrary luaLibrary();
 
 private:
@@ -1117,6 +1162,24 @@ private:
     glm::dmat3 getEstimatedTransformMatrix(const std::string& fromFrame,
         const std::string& toFrame, double time) const;
 
+    /**
+     * Computes the position of the \p target relative to the \p observer without
+     * consulting the EphemerisCache. See #targetPosition for the description of the
+     * parameters.
+     */
+    glm::dvec3 uncachedTargetPosition(const std::string& target,
+        const std::string& observer, const std::string& referenceFrame,
+        AberrationCorrection aberrationCorrection, double ephemerisTime,
+        double& lightTime) const;
+
+    /**
+     * Computes the rotation from the \p sourceFrame to the \p destinationFrame without
+     * consulting the EphemerisCache. See #positionTransformMatrix for the description of
+     * the parameters.
+     */
+    glm::dmat3 uncachedPositionTransformMatrix(const std::string& sourceFrame,
+        const std::string& destinationFrame, double ephemerisTime) const;
+
     /**
      * Loads pre defined leap seconds time kernel (naif00012.tls).
      */
@@ -1131,11 +1194,62 @@ private:
     /// A list of all loaded kernels
     std::vector<KernelInformation> _loadedKernels;
 
-    // Map: id, vector of pairs. Pair: Start time, end time;
-    std::map<int, std::vector< std::pair<double, double>>> _ckIntervals;
-    std::map<int, std::vector< std::pair<double, double>>> _spkIntervals;
-    std::map<int, std::set<double>> _ckCoverageTimes;
-    std::map<int, std::set<double>> _spkCoverageTimes;
+    /**
+     * The coverage of a single SPK object or CK frame over all loaded kernels.
+     */
+    struct Coverage {
+        /// The intervals as they are reported by the kernels, in the order of loading
+        std::vector<std::pair<double, double>> intervals;
+
+        /// The sorted, disjoint [start, end] windows that are searched with a binary
+        /// search. Overlapping or touching intervals are merged into a single window
+        std::vector<std::pair<double, double>> windows;
+
+        /// Positions (xyz) and light times (w) at the window boundaries. The key is the
+        /// observer, reference frame, and aberration correction and the boundary time
+        mutable std::map<std::pair<std::string, double>, glm::dvec4> boundaryPositions;
+
+        /// Transform matrices at the window boundaries. The key is the destination
+        /// frame and the boundary time
+        mutable std::map<std::pair<std::string, double>, glm::dmat3> boundaryTransforms;
+    };
+
+    /**
+     * Sorts and merges the coverage windows of \p coverage after new intervals were
+     * added to it.
+     */
+    static void updateWindows(Coverage& coverage);
+
+    /**
+     * Returns whether \p time lies strictly inside one of the windows of \p coverage.
+     */
+    static bool isCovered(const Coverage& coverage, double time);
+
+    /**
+     * Returns the times between which a value at \p time is estimated. Before the
+     * first window or after the last window, both times are the closest boundary. In a
+     * gap, they are the end of the preceding and the start of the following window.
+     *
+     * \pre \p coverage must have at least one window
+     */
+    static std::pair<double, double> estimationBracket(const Coverage& coverage,
+        double time);
+
+    /// Removes the cached boundary values of all coverages
+    void clearCoverageBoundaries();
+
+    // Map: id, coverage of the object or frame
+    std::map<int, Coverage> _ckCoverage;
+    std::map<int, Coverage> _spkCoverage;
+
+    /// Serializes all calls into CSPICE and the access to the members of this class
+    mutable std::recursive_mutex _mutex;
+
+    std::unique_ptr<SpiceQueryService> _queryService;
+
+    /// The cache of positions and rotations, which is only used if it is enabled
+    mutable EphemerisCache _ephemerisCache;
+    bool _isEphemerisCacheEnabled = false;
 
     /// Stores whether the SpiceManager throws exceptions (Yes) or fails silently (No)
     UseException _useExceptions = UseException::Yes;
@@ -0,0 +1,115 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___SPICEQUERYSERVICE___H__
+#define __OPENSPACE_CORE___SPICEQUERYSERVICE___H__
+
+#include <openspace/util/spicemanager.h>
+#include <openspace/util/taskscheduler.h>
+#include <ghoul/glm.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A service that executes SPICE queries asynchronously on a dedicated thread. Requests
+ * can be submitted from any thread and are executed in the order in which they were
+ * submitted; the results are returned through TaskFuture%s. Each request covers a batch
+ * of queries, for example the positions of one target at a number of epochs, so that
+ * clients that need many values only wait for a single result.
+ *
+ * As CSPICE is not reentrant, the SpiceManager serializes all calls into it, so requests
+ * that are executed by this service interleave with direct calls to the SpiceManager
+ * made from other threads without interfering with them.
+ */
+class SpiceQueryService {
+public:
+    SpiceQueryService();
+
+    /**
+     * Discards all requests that have not been started and waits for the current request
+     * to finish. The futures of discarded requests throw a `std::future_error`.
+     */
+    ~SpiceQueryService() = default;
+
+    /**
+     * Requests the positions of the \p target relative to the \p observer at each of the
+     * \p ephemerisTimes. See SpiceManager::targetPosition for a description of the
+     * parameters. If one of the positions cannot be computed, the returned future
+     * contains the SpiceManager::SpiceException that was thrown.
+     *
+     * \return The future that will contain the positions in km, in the same order as the
+     *         \p ephemerisTimes
+     */
+    TaskFuture<std::vector<glm::dvec3>> targetPositions(std::string target,
+        std::string observer, std::string referenceFrame,
+        SpiceManager::AberrationCorrection aberrationCorrection,
+        std::vector<double> ephemerisTimes);
+
+    /**
+     * Requests the rotation matrices from the \p sourceFrame to the \p destinationFrame
+     * at each of the \p ephemerisTimes. See SpiceManager::positionTransformMatrix for a
+     * description of the parameters.
+     *
+     * \return The future that will contain the matrices, in the same order as the
+     *         \p ephemerisTimes
+     */
+    TaskFuture<std::vector<glm::dmat3>> positionTransformMatrices(std::string sourceFrame,
+        std::string destinationFrame, std::vector<double> ephemerisTimes);
+
+    /**
+     * Requests the conversion of each of the \p dates into an ephemeris time. See
+     * SpiceManager::ephemerisTimeFromDate for the supported formats.
+     *
+     * \return The future that will contain the ephemeris times, in the same order as the
+     *         \p dates
+     */
+    TaskFuture<std::vector<double>> ephemerisTimesFromDates(
+        std::vector<std::string> dates);
+
+    /**
+     * Executes an arbitrary function that calls into the SpiceManager on the thread of
+     * this service and returns its result. This can be used for queries that are not
+     * covered by the other functions of this class.
+     */
+    template <typename F>
+    TaskFuture<std::invoke_result_t<std::decay_t<F>>> submit(F&& func);
+
+    /// Returns the number of requests that have not been started yet
+    size_t nQueuedRequests() const;
+
+private:
+    TaskScheduler _scheduler;
+};
+
+template <typename F>
+TaskFuture<std::invoke_result_t<std::decay_t<F>>> SpiceQueryService::submit(F&& func) {
+    return _scheduler.submit(std::forward<F>(func));
+}
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___SPICEQUERYSERVICE___H__
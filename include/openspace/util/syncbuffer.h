@@ -27,6 +27,7 @@
 
 #include <ghoul/glm.h>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -59,14 +60,31 @@ public:
 
     void reset();
 
+    /**
+     * Takes ownership of \p data, which is used for subsequent calls to `decode`.
+     */
     void setData(std::vector<std::byte> data);
-    std::vector<std::byte> data();
+
+    /**
+     * Uses \p data for subsequent calls to `decode` without copying it. The memory
+     * referenced by \p data has to stay valid until `reset` or `setData` is called.
+     */
+    void setData(std::span<const std::byte> data);
+
+    /**
+     * Returns a view of the bytes that have been encoded since the last `reset`. The view
+     * is invalidated by the next call to `encode` or `reset`.
+     */
+    std::span<const std::byte> data() const;
 
 private:
     size_t _n;
     size_t _encodeOffset = 0;
     size_t _decodeOffset = 0;
     std::vector<std::byte> _dataStream;
+    /// The bytes that are read by `decode`, either pointing to `_dataStream` or to
+    /// external memory provided through `setData`
+    std::span<const std::byte> _decodeData;
 };
 
 } // namespace openspace
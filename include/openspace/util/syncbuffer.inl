@@ -24,6 +24,7 @@
 
 #include <ghoul/misc/assert.h>
 #include <ghoul/glm.h>
+#include <algorithm>
 #include <cstring>
 
 namespace openspace {
@@ -32,9 +33,10 @@ template <typename T>
 void SyncBuffer::encode(const T& v) {
     const size_t size = sizeof(T);
 
-    size_t anticpatedBufferSize = _encodeOffset + size;
-    if (anticpatedBufferSize >= _n) {
-        _dataStream.resize(anticpatedBufferSize);
+    const size_t anticpatedBufferSize = _encodeOffset + size;
+    if (anticpatedBufferSize > _dataStream.size()) {
+        // Grow geometrically so that the buffer quickly settles on its final size
+        _dataStream.resize(std::max(anticpatedBufferSize, 2 * _dataStream.size()));
     }
 
     std::memcpy(_dataStream.data() + _encodeOffset, &v, size);
@@ -44,9 +46,9 @@ void SyncBuffer::encode(const T& v) {
 template <typename T>
 T SyncBuffer::decode() {
     const size_t size = sizeof(T);
-    ghoul_assert(_decodeOffset + size < _n, "");
+    ghoul_assert(_decodeOffset + size <= _decodeData.size(), "Reading past the end");
     T value;
-    std::memcpy(&value, _dataStream.data() + _decodeOffset, size);
+    std::memcpy(&value, _decodeData.data() + _decodeOffset, size);
     _decodeOffset += size;
     return value;
 }
@@ -54,8 +56,8 @@ T SyncBuffer::decode() {
 template <typename T>
 void SyncBuffer::decode(T& value) {
     const size_t size = sizeof(T);
-    ghoul_assert(_decodeOffset + size < _n, "");
-    std::memcpy(&value, _dataStream.data() + _decodeOffset, size);
+    ghoul_assert(_decodeOffset + size <= _decodeData.size(), "Reading past the end");
+    std::memcpy(&value, _decodeData.data() + _decodeOffset, size);
     _decodeOffset += size;
 }
 
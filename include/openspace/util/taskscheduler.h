@@ -0,0 +1,278 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___TASK_SCHEDULER___H__
+#define __OPENSPACE_CORE___TASK_SCHEDULER___H__
+
+#include <atomic>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace openspace {
+
+namespace detail {
+    struct TaskVTable {
+        void (*invoke)(void* storage);
+        void (*move)(void* from, void* to) noexcept;
+        void (*destroy)(void* storage) noexcept;
+    };
+} // namespace detail
+
+/**
+ * A move-only, type-erased callable with the signature `void()`. Callables that are at
+ * most `InlineSize` bytes large and are nothrow move constructible are stored inside the
+ * ScheduledTask object itself, so that enqueueing the typical small lambda (a `this`
+ * pointer and a `std::shared_ptr` or two) does not cause a heap allocation like
+ * `std::function` does. Larger callables fall back to a heap allocation.
+ */
+class ScheduledTask {
+public:
+    static constexpr size_t InlineSize = 64;
+
+    ScheduledTask() = default;
+
+    template <typename F>
+        requires (!std::is_same_v<std::remove_cvref_t<F>, ScheduledTask>)
+    ScheduledTask(F&& func);
+
+    ScheduledTask(ScheduledTask&& other) noexcept;
+    ScheduledTask& operator=(ScheduledTask&& other) noexcept;
+    ScheduledTask(const ScheduledTask&) = delete;
+    ScheduledTask& operator=(const ScheduledTask&) = delete;
+    ~ScheduledTask();
+
+    /**
+     * Executes the stored callable. Calling this on an empty ScheduledTask is undefined.
+     */
+    void operator()();
+
+    explicit operator bool() const;
+
+    /**
+     * Returns `true` if the callable is stored in the small buffer of this object rather
+     * than on the heap. Empty tasks return `false`.
+     */
+    bool isStoredInline() const;
+
+private:
+    void reset() noexcept;
+
+    alignas(std::max_align_t) std::byte _storage[InlineSize];
+    const detail::TaskVTable* _vtable = nullptr;
+    bool _isInline = false;
+};
+
+template <typename T> class TaskFuture;
+
+/**
+ * A thread pool that schedules ScheduledTask%s using work stealing. Every worker thread
+ * owns one queue per priority level, so producers and workers only contend on the queue
+ * they are currently touching instead of a single global lock. Tasks that are enqueued
+ * from a worker thread go to that worker's own queue, tasks enqueued from other threads
+ * are distributed round-robin. Idle workers first look at their own queue and then steal
+ * from the other workers' queues, always picking the highest priority that has work
+ * available.
+ *
+ * Within a single queue, tasks of the same priority are executed in FIFO order; across
+ * queues no ordering is guaranteed.
+ */
+class TaskScheduler {
+public:
+    enum class Priority {
+        High = 0,
+        Normal,
+        Low
+    };
+    static constexpr size_t NumPriorities = 3;
+
+    /**
+     * Creates a new scheduler with \p numThreads worker threads. If \p numThreads is 0,
+     * a single worker thread is created.
+     */
+    explicit TaskScheduler(size_t numThreads);
+
+    /**
+     * Stops all worker threads and waits for the tasks currently being executed to
+     * finish. Tasks that have not started yet are discarded; if they belong to a
+     * TaskFuture, that future will throw a `std::future_error` with
+     * `std::future_errc::broken_promise`.
+     */
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+     * Adds the \p task to the queue of tasks with the provided \p priority.
+     */
+    void enqueue(ScheduledTask task, Priority priority = Priority::Normal);
+
+    /**
+     * Enqueues the callable \p func and returns a future that will contain its result or
+     * the exception that was thrown by it. Additional work can be chained onto the result
+     * using TaskFuture::then.
+     */
+    template <typename F>
+    TaskFuture<std::invoke_result_t<std::decay_t<F>>> submit(F&& func,
+        Priority priority = Priority::Normal);
+
+    /**
+     * Calls \p function with consecutive ranges `[begin, end)` that together cover
+     * `[0, n)` and returns once all calls have finished. The range is split into at most
+     * one batch per worker thread plus one, each with at least \p minBatchSize elements.
+     * The calling thread processes the first batch while the worker threads process the
+     * rest. If this function is called from one of the worker threads, or if \p n is too
+     * small to be split, the whole range is processed on the calling thread. If any of
+     * the calls throws, the first exception is rethrown after all batches have finished.
+     *
+     * \param n The number of elements that are processed
+     * \param minBatchSize The smallest number of elements for which scheduling a batch
+     *        on another thread is worth its overhead
+     * \param function The function that is called as `function(begin, end)`
+     * \param priority The priority of the batches that run on the worker threads
+     */
+    template <typename F>
+    void parallelFor(size_t n, size_t minBatchSize, const F& function,
+        Priority priority = Priority::High);
+
+    /**
+     * Removes all tasks that have not started executing yet. Tasks that are currently
+     * being executed are unaffected.
+     */
+    void clearTasks();
+
+    /**
+     * Returns the number of tasks that are enqueued, but have not started executing yet.
+     */
+    size_t numQueuedTasks() const;
+
+    size_t numThreads() const;
+
+    /**
+     * Returns `true` if this function is called from one of the worker threads of this
+     * scheduler.
+     */
+    bool isWorkerThread() const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::array<std::deque<ScheduledTask>, NumPriorities> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool tryPop(size_t index, ScheduledTask& task);
+    bool tryPopFrom(WorkerQueue& queue, size_t priority, ScheduledTask& task, bool block);
+
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
+    std::vector<std::thread> _workers;
+
+    std::atomic_int64_t _numQueued = 0;
+    std::array<std::atomic_int64_t, NumPriorities> _numQueuedPerPriority = {};
+    std::atomic_size_t _nextQueue = 0;
+    std::atomic_bool _stop = false;
+
+    // Only used to put idle worker threads to sleep, never touched on the hot path
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    std::atomic_int _numSleeping = 0;
+};
+
+namespace detail {
+    template <typename T>
+    struct FutureState {
+        using Value = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+        void setValue(Value v);
+        void setException(std::exception_ptr e);
+        void wait();
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::optional<Value> value;
+        std::exception_ptr exception;
+        bool isReady = false;
+
+        TaskScheduler* scheduler = nullptr;
+        std::vector<std::pair<ScheduledTask, TaskScheduler::Priority>> continuations;
+    };
+} // namespace detail
+
+/**
+ * The eventual result of a task that was submitted through TaskScheduler::submit. In
+ * contrast to `std::future`, a TaskFuture can have continuations attached to it that are
+ * scheduled on the same TaskScheduler as soon as the result is available.
+ *
+ * Calling #wait or #get from inside a worker thread of the same scheduler blocks that
+ * worker and can deadlock if all workers end up waiting; use #then instead.
+ */
+template <typename T>
+class TaskFuture {
+public:
+    TaskFuture() = default;
+    explicit TaskFuture(std::shared_ptr<detail::FutureState<T>> state);
+
+    bool isValid() const;
+    bool isReady() const;
+
+    /**
+     * Blocks until the result is available.
+     */
+    void wait() const;
+
+    /**
+     * Blocks until the result is available and returns it, or rethrows the exception
+     * that was thrown by the task. The result is moved out of the future, so this
+     * function may only be called once.
+     */
+    T get();
+
+    /**
+     * Schedules \p func to be called with the result of this future once it is
+     * available. If this future holds an exception, \p func is not called and the
+     * exception is forwarded to the returned future instead.
+     */
+    template <typename F>
+    auto then(F&& func, TaskScheduler::Priority priority =
+        TaskScheduler::Priority::Normal);
+
+private:
+    std::shared_ptr<detail::FutureState<T>> _state;
+};
+
+} // namespace openspace
+
+#include "taskscheduler.inl"
+
+#endif // __OPENSPACE_CORE___TASK_SCHEDULER___H__
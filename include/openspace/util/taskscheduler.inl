@@ -0,0 +1,315 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <algorithm>
+#include <future>
+#include <new>
+#include <utility>
+
+namespace openspace {
+
+namespace detail {
+    template <typename F>
+    constexpr bool FitsInlineTask =
+        sizeof(F) <= ScheduledTask::InlineSize &&
+        alignof(F) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<F>;
+
+    template <typename F>
+    struct InlineTaskOps {
+        static F* get(void* storage) {
+            return std::launder(reinterpret_cast<F*>(storage));
+        }
+        static void invoke(void* storage) {
+            (*get(storage))();
+        }
+        static void move(void* from, void* to) noexcept {
+            F* f = get(from);
+            new (to) F(std::move(*f));
+            f->~F();
+        }
+        static void destroy(void* storage) noexcept {
+            get(storage)->~F();
+        }
+
+        static constexpr TaskVTable VTable = { &invoke, &move, &destroy };
+    };
+
+    template <typename F>
+    struct HeapTaskOps {
+        static F*& get(void* storage) {
+            return *std::launder(reinterpret_cast<F**>(storage));
+        }
+        static void invoke(void* storage) {
+            (*get(storage))();
+        }
+        static void move(void* from, void* to) noexcept {
+            new (to) F*(get(from));
+            get(from) = nullptr;
+        }
+        static void destroy(void* storage) noexcept {
+            delete get(storage);
+        }
+
+        static constexpr TaskVTable VTable = { &invoke, &move, &destroy };
+    };
+
+    /**
+     * The callable that is enqueued by TaskScheduler::submit. It forwards the result of
+     * the wrapped function to the future state and breaks the promise if it is destroyed
+     * without ever having been executed.
+     */
+    template <typename F, typename R>
+    struct PromiseTask {
+        PromiseTask(F f, std::shared_ptr<FutureState<R>> s)
+            : func(std::move(f))
+            , state(std::move(s))
+        {}
+        PromiseTask(PromiseTask&&) = default;
+        PromiseTask& operator=(PromiseTask&&) = delete;
+
+        ~PromiseTask() {
+            if (state) {
+                state->setException(std::make_exception_ptr(
+                    std::future_error(std::future_errc::broken_promise)
+                ));
+            }
+        }
+
+        void operator()() {
+            std::shared_ptr<FutureState<R>> s = std::move(state);
+            try {
+                if constexpr (std::is_void_v<R>) {
+                    func();
+                    s->setValue(std::monostate());
+                }
+                else {
+                    s->setValue(func());
+                }
+            }
+            catch (...) {
+                s->setException(std::current_exception());
+            }
+        }
+
+        F func;
+        std::shared_ptr<FutureState<R>> state;
+    };
+
+    template <typename T>
+    void FutureState<T>::setValue(Value v) {
+        std::vector<std::pair<ScheduledTask, TaskScheduler::Priority>> conts;
+        {
+            std::lock_guard lock(mutex);
+            value = std::move(v);
+            isReady = true;
+            conts = std::move(continuations);
+        }
+        condition.notify_all();
+        for (std::pair<ScheduledTask, TaskScheduler::Priority>& c : conts) {
+            scheduler->enqueue(std::move(c.first), c.second);
+        }
+    }
+
+    template <typename T>
+    void FutureState<T>::setException(std::exception_ptr e) {
+        std::vector<std::pair<ScheduledTask, TaskScheduler::Priority>> conts;
+        {
+            std::lock_guard lock(mutex);
+            exception = std::move(e);
+            isReady = true;
+            conts = std::move(continuations);
+        }
+        condition.notify_all();
+        for (std::pair<ScheduledTask, TaskScheduler::Priority>& c : conts) {
+            scheduler->enqueue(std::move(c.first), c.second);
+        }
+    }
+
+    template <typename T>
+    void FutureState<T>::wait() {
+        std::unique_lock lock(mutex);
+        condition.wait(lock, [this]() { return isReady; });
+    }
+} // namespace detail
+
+template <typename F>
+    requires (!std::is_same_v<std::remove_cvref_t<F>, ScheduledTask>)
+ScheduledTask::ScheduledTask(F&& func) {
+    using Func = std::decay_t<F>;
+    if constexpr (detail::FitsInlineTask<Func>) {
+        new (_storage) Func(std::forward<F>(func));
+        _vtable = &detail::InlineTaskOps<Func>::VTable;
+        _isInline = true;
+    }
+    else {
+        new (_storage) Func*(new Func(std::forward<F>(func)));
+        _vtable = &detail::HeapTaskOps<Func>::VTable;
+        _isInline = false;
+    }
+}
+
+template <typename F>
+TaskFuture<std::invoke_result_t<std::decay_t<F>>> TaskScheduler::submit(F&& func,
+                                                                      Priority priority)
+{
+    using R = std::invoke_result_t<std::decay_t<F>>;
+
+    auto state = std::make_shared<detail::FutureState<R>>();
+    state->scheduler = this;
+    TaskFuture<R> future(state);
+    enqueue(
+        detail::PromiseTask<std::decay_t<F>, R>(std::forward<F>(func), std::move(state)),
+        priority
+    );
+    return future;
+}
+
+template <typename F>
+void TaskScheduler::parallelFor(size_t n, size_t minBatchSize, const F& function,
+                                Priority priority)
+{
+    // Waiting for the batches on a worker thread could deadlock if the other workers are
+    // waiting as well, so the work is done inline instead
+    const size_t nBatches = isWorkerThread() ?
+        1 :
+        std::min(numThreads() + 1, n / std::max<size_t>(minBatchSize, 1));
+    if (nBatches <= 1) {
+        function(size_t(0), n);
+        return;
+    }
+
+    const size_t batchSize = (n + nBatches - 1) / nBatches;
+    std::vector<TaskFuture<void>> futures;
+    futures.reserve(nBatches - 1);
+    for (size_t batch = 1; batch < nBatches; batch++) {
+        const size_t begin = batch * batchSize;
+        if (begin >= n) {
+            break;
+        }
+        const size_t end = std::min(begin + batchSize, n);
+        futures.push_back(submit(
+            [&function, begin, end]() { function(begin, end); },
+            priority
+        ));
+    }
+
+    // The batches reference the function, so all of them have to be finished before an
+    // exception can leave this function
+    std::exception_ptr exception;
+    try {
+        function(size_t(0), batchSize);
+    }
+    catch (...) {
+        exception = std::current_exception();
+    }
+    for (TaskFuture<void>& future : futures) {
+        try {
+            future.get();
+        }
+        catch (...) {
+            if (!exception) {
+                exception = std::current_exception();
+            }
+        }
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+template <typename T>
+TaskFuture<T>::TaskFuture(std::shared_ptr<detail::FutureState<T>> state)
+    : _state(std::move(state))
+{}
+
+template <typename T>
+bool TaskFuture<T>::isValid() const {
+    return _state != nullptr;
+}
+
+template <typename T>
+bool TaskFuture<T>::isReady() const {
+    std::lock_guard lock(_state->mutex);
+    return _state->isReady;
+}
+
+template <typename T>
+void TaskFuture<T>::wait() const {
+    _state->wait();
+}
+
+template <typename T>
+T TaskFuture<T>::get() {
+    std::shared_ptr<detail::FutureState<T>> state = std::move(_state);
+    state->wait();
+    if (state->exception) {
+        std::rethrow_exception(state->exception);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*state->value);
+    }
+}
+
+template <typename T>
+template <typename F>
+auto TaskFuture<T>::then(F&& func, TaskScheduler::Priority priority) {
+    using Func = std::decay_t<F>;
+    using R = typename std::conditional_t<
+        std::is_void_v<T>,
+        std::invoke_result<Func>,
+        std::invoke_result<Func, const T&>
+    >::type;
+
+    auto next = std::make_shared<detail::FutureState<R>>();
+    next->scheduler = _state->scheduler;
+
+    auto continuation = [f = Func(std::forward<F>(func)), parent = _state]() mutable {
+        if (parent->exception) {
+            std::rethrow_exception(parent->exception);
+        }
+        if constexpr (std::is_void_v<T>) {
+            return f();
+        }
+        else {
+            return f(std::as_const(*parent->value));
+        }
+    };
+    ScheduledTask task = detail::PromiseTask<decltype(continuation), R>(
+        std::move(continuation),
+        next
+    );
+
+    {
+        std::unique_lock lock(_state->mutex);
+        if (!_state->isReady) {
+            _state->continuations.emplace_back(std::move(task), priority);
+            return TaskFuture<R>(std::move(next));
+        }
+    }
+    _state->scheduler->enqueue(std::move(task), priority);
+    return TaskFuture<R>(std::move(next));
+}
+
+} // namespace openspace
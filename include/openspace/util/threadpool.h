@@ -25,52 +25,89 @@
 #ifndef __OPENSPACE_CORE___THREAD_POOL___H__
 #define __OPENSPACE_CORE___THREAD_POOL___H__
 
+#include <openspace/util/taskscheduler.h>
+
+#include <atomic>
 #include <condition_variable>
-#include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
-#include <thread>
-#include <vector>
-
-// Implementation based on http://progsch.net/wordpress/?p=81
 
 namespace openspace {
 
-class ThreadPool;
-
-class Worker {
-public:
-    Worker(ThreadPool& p);
-    void operator()();
-
-private:
-    ThreadPool& pool;
-};
-
+/**
+ * A pool of worker threads that execute enqueued functions. The tasks are scheduled by a
+ * TaskScheduler which is either owned by this pool or shared with other users.
+ */
 class ThreadPool {
 public:
+    /**
+     * Creates a thread pool that owns a TaskScheduler with \p numThreads threads.
+     */
     ThreadPool(size_t numThreads);
+
+    /**
+     * Creates a thread pool that enqueues its tasks on an existing \p scheduler, which
+     * has to outlive this object.
+     */
+    ThreadPool(TaskScheduler& scheduler);
+
+    /**
+     * Creates a new thread pool with the same number of threads as \p toCopy. If
+     * \p toCopy is using a shared TaskScheduler, the copy uses the same scheduler.
+     */
     ThreadPool(const ThreadPool& toCopy);
+
+    /**
+     * Waits for the tasks of this pool that are currently executing to finish. Tasks of
+     * this pool that have not started yet will not be executed.
+     */
     ~ThreadPool();
 
-    void enqueue(std::function<void()> f);
+    /**
+     * Enqueues the callable \p f on the scheduler. The callable is moved into the
+     * scheduler's task directly, so small callables do not cause a heap allocation.
+     */
+    template <typename F>
+    void enqueue(F&& f,
+        TaskScheduler::Priority priority = TaskScheduler::Priority::Normal);
     void clearTasks();
 
     bool hasOutstandingTasks() const;
 
-private:
-    friend class Worker;
-
-    std::vector<std::thread> workers;
+    TaskScheduler& scheduler();
 
-    std::deque<std::function<void()>> tasks;
-
-    std::mutex queue_mutex;
-    std::condition_variable condition;
-
-    bool stop;
+private:
+    /// State shared with the enqueued tasks, which might outlive this pool when the
+    /// scheduler is shared
+    struct State {
+        /// Registers a new queued task and returns the generation it belongs to
+        uint64_t registerTask();
+
+        /// Marks a task of the \p taskGeneration as running. Returns `false` if the
+        /// task was cleared or the pool was stopped, in which case it must not be
+        /// executed
+        bool beginTask(uint64_t taskGeneration);
+
+        /// Marks a task that was started with #beginTask as finished
+        void endTask();
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        uint64_t generation = 0;
+        size_t nRunning = 0;
+        bool isStopped = false;
+        /// The number of tasks of the current generation that have not started yet. It
+        /// is only modified while holding the mutex
+        std::atomic_size_t nQueued = 0;
+    };
+
+    std::shared_ptr<State> _state = std::make_shared<State>();
+    std::unique_ptr<TaskScheduler> _ownedScheduler;
+    TaskScheduler* _scheduler = nullptr;
 };
 
 } // namespace openspace
 
+#include "threadpool.inl"
+
 #endif // __OPENSPACE_CORE___THREAD_POOL___H__
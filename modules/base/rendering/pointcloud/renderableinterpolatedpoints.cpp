@@ -36,6 +36,7 @@
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <optional>
+#include <span>
 
 namespace {
     constexpr std::string_view _loggerCat = "RenderableInterpolatedPoints";
@@ -372,14 +373,10 @@ void RenderableInterpolatedPoints::addPositionDataForPoint(unsigned int index,
                                                            std::vector<float>& result,
                                                            double& maxRadius) const
 {
-    using namespace dataloader;
     auto [firstIndex, secondIndex] = interpolationIndices(index);
 
-    const Dataset::Entry& e0 = _dataset.entries[firstIndex];
-    const Dataset::Entry& e1 = _dataset.entries[secondIndex];
-
-    glm::dvec3 position0 = transformedPosition(e0);
-    glm::dvec3 position1 = transformedPosition(e1);
+    glm::dvec3 position0 = transformedPosition(_dataset.positions[firstIndex]);
+    glm::dvec3 position1 = transformedPosition(_dataset.positions[secondIndex]);
 
     const double r = glm::max(glm::length(position0), glm::length(position1));
     maxRadius = glm::max(maxRadius, r);
@@ -403,10 +400,8 @@ void RenderableInterpolatedPoints::addPositionDataForPoint(unsigned int index,
             maxAllowedindex
         );
 
-        const Dataset::Entry& e00 = _dataset.entries[beforeIndex];
-        const Dataset::Entry& e11 = _dataset.entries[afterIndex];
-        glm::dvec3 positionBefore = transformedPosition(e00);
-        glm::dvec3 positionAfter = transformedPosition(e11);
+        glm::dvec3 positionBefore = transformedPosition(_dataset.positions[beforeIndex]);
+        glm::dvec3 positionAfter = transformedPosition(_dataset.positions[afterIndex]);
 
         for (int j = 0; j < 3; ++j) {
             result.push_back(static_cast<float>(positionBefore[j]));
@@ -421,15 +416,13 @@ void RenderableInterpolatedPoints::addPositionDataForPoint(unsigned int index,
 void RenderableInterpolatedPoints::addColorAndSizeDataForPoint(unsigned int index,
                                                          std::vector<float>& result) const
 {
-    using namespace dataloader;
     auto [firstIndex, secondIndex] = interpolationIndices(index);
-    const Dataset::Entry& e0 = _dataset.entries[firstIndex];
-    const Dataset::Entry& e1 = _dataset.entries[secondIndex];
 
     int colorParamIndex = currentColorParameterIndex();
     if (_hasColorMapFile && colorParamIndex >= 0) {
-        result.push_back(e0.data[colorParamIndex]);
-        result.push_back(e1.data[colorParamIndex]);
+        const std::span<const float> column = _dataset.columns[colorParamIndex];
+        result.push_back(column[firstIndex]);
+        result.push_back(column[secondIndex]);
     }
 
     int sizeParamIndex = currentSizeParameterIndex();
@@ -437,8 +430,9 @@ void RenderableInterpolatedPoints::addColorAndSizeDataForPoint(unsigned int inde
         // @TODO: Consider more detailed control over the scaling. Currently the value
         // is multiplied with the value as is. Should have similar mapping properties
         // as the color mapping
-        result.push_back(e0.data[sizeParamIndex]);
-        result.push_back(e1.data[sizeParamIndex]);
+        const std::span<const float> column = _dataset.columns[sizeParamIndex];
+        result.push_back(column[firstIndex]);
+        result.push_back(column[secondIndex]);
     }
 }
 
@@ -488,7 +482,7 @@ void RenderableInterpolatedPoints::initializeBufferData() {
 }
 
 void RenderableInterpolatedPoints::updateBufferData() {
-    if (!_hasDataFile || _dataset.entries.empty()) {
+    if (!_hasDataFile || _dataset.size() == 0) {
         return;
     }
 
@@ -749,12 +749,18 @@ void RenderablePointCloud::initialize() {
 
     if (_hasDataFile) {
         if (_useCaching) {
-            _dataset = dataloader::data::loadFileWithCache(_dataFile, _dataMapping);
+            // The points are only created from the dataset, so the cache file is used in
+            // place instead of being deserialized
+            _mappedDataset = dataloader::data::mapFileWithCache(_dataFile, _dataMapping);
+            _dataset = _mappedDataset.has_value() ?
+                _mappedDataset->view :
+                dataloader::DatasetView();
         }
         else {
-            _dataset = dataloader::data::loadFile(_dataFile, _dataMapping);
+            _loadedDataset = dataloader::data::loadFile(_dataFile, _dataMapping);
+            _dataset = _loadedDataset.view();
         }
-        _nDataPoints = static_cast<unsigned int>(_dataset.entries.size());
+        _nDataPoints = static_cast<unsigned int>(_dataset.size());
 
         // If no scale exponent was specified, compute one that will at least show the
         // points based on the scale of the positions in the dataset
@@ -1083,7 +1089,7 @@ void RenderablePointCloud::renderBillboards(const RenderData& data,
                                             const glm::dvec3& orthoUp,
                                             float fadeInVariable)
 {
-    if (!_hasDataFile || _dataset.entries.empty()) {
+    if (!_hasDataFile || _dataset.size() == 0) {
         return;
     }
 
@@ -1293,12 +1299,10 @@ void RenderablePointCloud::update(const UpdateData&) {
     }
 }
 
-glm::dvec3 RenderablePointCloud::transformedPosition(
-                                                const dataloader::Dataset::Entry& e) const
-{
+glm::dvec3 RenderablePointCloud::transformedPosition(const glm::vec3& position) const {
     const double unitMeter = toMeter(_unit);
-    glm::dvec4 position = glm::dvec4(glm::dvec3(e.position) * unitMeter, 1.0);
-    return glm::dvec3(_transformationMatrix * position);
+    glm::dvec4 pos = glm::dvec4(glm::dvec3(position) * unitMeter, 1.0);
+    return glm::dvec3(_transformationMatrix * pos);
 }
 
 int RenderablePointCloud::nAttributesPerPoint() const {
@@ -1327,7 +1331,7 @@ int RenderablePointCloud::bufferVertexAttribute(const std::string& name, GLint n
 }
 
 void RenderablePointCloud::updateBufferData() {
-    if (!_hasDataFile || _dataset.entries.empty()) {
+    if (!_hasDataFile || _dataset.size() == 0) {
         return;
     }
 
@@ -1440,8 +1444,7 @@ void RenderablePointCloud::addPositionDataForPoint(unsigned int index,
                                                    std::vector<float>& result,
                                                    double& maxRadius) const
 {
-    const dataloader::Dataset::Entry& e = _dataset.entries[index];
-    glm::dvec3 position = transformedPosition(e);
+    glm::dvec3 position = transformedPosition(_dataset.positions[index]);
     const double r = glm::length(position);
 
     // Add values to result
@@ -1455,11 +1458,9 @@ void RenderablePointCloud::addPositionDataForPoint(unsigned int index,
 void RenderablePointCloud::addColorAndSizeDataForPoint(unsigned int index,
                                                        std::vector<float>& result) const
 {
-    const dataloader::Dataset::Entry& e = _dataset.entries[index];
-
     int colorParamIndex = currentColorParameterIndex();
     if (_hasColorMapFile && colorParamIndex >= 0) {
-        result.push_back(e.data[colorParamIndex]);
+        result.push_back(_dataset.columns[colorParamIndex][index]);
     }
 
     int sizeParamIndex = currentSizeParameterIndex();
@@ -1467,14 +1468,14 @@ void RenderablePointCloud::addColorAndSizeDataForPoint(unsigned int index,
         // @TODO: Consider more detailed control over the scaling. Currently the value
         // is multiplied with the value as is. Should have similar mapping properties
         // as the color mapping
-        result.push_back(e.data[sizeParamIndex]);
+        result.push_back(_dataset.columns[sizeParamIndex][index]);
     }
 }
 
 std::vector<float> RenderablePointCloud::createDataSlice() {
     ZoneScoped;
 
-    if (_dataset.entries.empty()) {
+    if (_dataset.size() == 0) {
         return std::vector<float>();
     }
 
@@ -1491,12 +1492,10 @@ std::vector<float> RenderablePointCloud::createDataSlice() {
 
     // Reserve enough space for all points in each for now
     for (std::vector<float>& subres : subResults) {
-        subres.reserve(nAttributesPerPoint() * _dataset.entries.size());
+        subres.reserve(nAttributesPerPoint() * _dataset.size());
     }
 
     for (unsigned int i = 0; i < _nDataPoints; i++) {
-        const dataloader::Dataset::Entry& e = _dataset.entries[i];
-
         unsigned int subresultIndex = 0;
         float textureLayer = 0.f;
 
@@ -1504,7 +1503,7 @@ std::vector<float> RenderablePointCloud::createDataSlice() {
             (textureIdIndex >= 0);
 
         if (_hasSpriteTexture && useMultiTexture) {
-            int texId = static_cast<int>(e.data[textureIdIndex]);
+            int texId = static_cast<int>(_dataset.columns[textureIdIndex][i]);
             size_t texIndex = _indexInDataToTextureIndex[texId];
             textureLayer = static_cast<float>(
                 _textureIndexToArrayMap[texIndex].layer
@@ -1530,7 +1529,7 @@ std::vector<float> RenderablePointCloud::createDataSlice() {
 
     // Combine subresults, which should be in same order as texture arrays
     std::vector<float> result;
-    result.reserve(nAttributesPerPoint() * _dataset.entries.size());
+    result.reserve(nAttributesPerPoint() * _dataset.size());
     size_t vertexCount = 0;
     for (size_t i = 0; i < subResults.size(); ++i) {
         result.insert(result.end(), subResults[i].begin(), subResults[i].end());
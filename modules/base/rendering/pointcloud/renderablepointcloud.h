@@ -43,6 +43,7 @@
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
 #include <functional>
+#include <optional>
 
 namespace ghoul::opengl {
     class ProgramObject;
@@ -96,7 +97,7 @@ protected:
     virtual void setExtraUniforms();
     virtual void preUpdate();
 
-    glm::dvec3 transformedPosition(const dataloader::Dataset::Entry& e) const;
+    glm::dvec3 transformedPosition(const glm::vec3& position) const;
 
     virtual int nAttributesPerPoint() const;
 
@@ -231,7 +232,11 @@ protected:
     bool _shouldComputeScaleExponent = false;
     bool _createLabelsFromDataset = false;
 
-    dataloader::Dataset _dataset;
+    /// The memory-mapped cache file that #_dataset points into if caching is enabled
+    std::optional<dataloader::MappedDataset> _mappedDataset;
+    /// The loaded data file that #_dataset points into if caching is disabled
+    dataloader::Dataset _loadedDataset;
+    dataloader::DatasetView _dataset;
     dataloader::DataMapping _dataMapping;
 
     std::unique_ptr<LabelsComponent> _labels;
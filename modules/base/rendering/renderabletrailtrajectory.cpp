@@ -197,6 +197,8 @@ void RenderableTrailTrajectory::deinitializeGL() {
 void RenderableTrailTrajectory::reset() {
     _needsFullSweep = true;
     _sweepIteration = 0;
+    // Positions that are still being computed are no longer valid
+    _requestedPositions = TaskFuture<std::vector<glm::dvec3>>();
     _maxVertex = glm::vec3(-std::numeric_limits<float>::max());
     _minVertex = glm::vec3(std::numeric_limits<float>::max());
 }
@@ -204,7 +206,7 @@ void RenderableTrailTrajectory::reset() {
 void RenderableTrailTrajectory::update(const UpdateData& data) {
     if (_needsFullSweep) {
 
-        if (_sweepIteration == 0) {
+        if (_sweepIteration == 0 && !_requestedPositions.isValid()) {
             // Max number of vertices
             constexpr unsigned int maxNumberOfVertices = 1000000;
 
@@ -231,46 +233,86 @@ void RenderableTrailTrajectory::update(const UpdateData& data) {
             // Make space for the vertices
             _vertexArray.clear();
             _vertexArray.resize(_numberOfVertices + 1);
-        }
 
-        // Calculate sweeping range for this iteration
-        const unsigned int startIndex = _sweepIteration * _sweepChunkSize;
-        const unsigned int nextIndex = (_sweepIteration + 1) * _sweepChunkSize;
-        const unsigned int stopIndex = std::min(nextIndex, _numberOfVertices);
-
-        // Calculate all vertex positions
-        for (unsigned int i = startIndex; i < stopIndex; i++) {
-            const glm::vec3 p = _translation->position({
-                {},
-                Time(_start + i * _totalSampleInterval),
-                Time(0.0)
-            });
-            _vertexArray[i] = { p.x, p.y, p.z };
-
-            // Set max and min vertex for bounding sphere calculations
-            _maxVertex = glm::max(_maxVertex, p);
-            _minVertex = glm::min(_minVertex, p);
+            // If the translation can compute the positions on a different thread, we
+            // request all of them at once instead of sweeping over multiple frames
+            std::vector<double> times;
+            times.reserve(_numberOfVertices + 1);
+            for (unsigned int i = 0; i < _numberOfVertices; i++) {
+                times.push_back(_start + i * _totalSampleInterval);
+            }
+            times.push_back(_end);
+            std::optional<TaskFuture<std::vector<glm::dvec3>>> request =
+                _translation->requestPositions(std::move(times));
+            if (request.has_value()) {
+                _requestedPositions = std::move(*request);
+            }
         }
-        ++_sweepIteration;
-
-        // Full sweep is complete here.
-        // Adds the last point in time to the _vertexArray so that we
-        // ensure that points for _start and _end always exists
-        if (stopIndex == _numberOfVertices) {
-            const glm::vec3 p = _translation->position({
-                {},
-                Time(_end),
-                Time(0.0)
-            });
-            _vertexArray[stopIndex] = { p.x, p.y, p.z };
-
-            _sweepIteration = 0;
+
+        if (_requestedPositions.isValid()) {
+            if (!_requestedPositions.isReady()) {
+                // Early return as we don't need to render until all of the positions
+                // have been computed
+                return;
+            }
+
+            TaskFuture<std::vector<glm::dvec3>> request = std::move(_requestedPositions);
+            _requestedPositions = TaskFuture<std::vector<glm::dvec3>>();
+            const std::vector<glm::dvec3> positions = request.get();
+            ghoul_assert(
+                positions.size() == _vertexArray.size(),
+                "Wrong number of positions"
+            );
+            for (size_t i = 0; i < positions.size(); i++) {
+                const glm::vec3 p = positions[i];
+                _vertexArray[i] = { p.x, p.y, p.z };
+
+                // Set max and min vertex for bounding sphere calculations
+                _maxVertex = glm::max(_maxVertex, p);
+                _minVertex = glm::min(_minVertex, p);
+            }
             setBoundingSphere(glm::distance(_maxVertex, _minVertex) / 2.f);
         }
         else {
-            // Early return as we don't need to render if we are still
-            // doing full sweep calculations
-            return;
+            // Calculate sweeping range for this iteration
+            const unsigned int startIndex = _sweepIteration * _sweepChunkSize;
+            const unsigned int nextIndex = (_sweepIteration + 1) * _sweepChunkSize;
+            const unsigned int stopIndex = std::min(nextIndex, _numberOfVertices);
+
+            // Calculate all vertex positions
+            for (unsigned int i = startIndex; i < stopIndex; i++) {
+                const glm::vec3 p = _translation->position({
+                    {},
+                    Time(_start + i * _totalSampleInterval),
+                    Time(0.0)
+                });
+                _vertexArray[i] = { p.x, p.y, p.z };
+
+                // Set max and min vertex for bounding sphere calculations
+                _maxVertex = glm::max(_maxVertex, p);
+                _minVertex = glm::min(_minVertex, p);
+            }
+            ++_sweepIteration;
+
+            // Full sweep is complete here.
+            // Adds the last point in time to the _vertexArray so that we
+            // ensure that points for _start and _end always exists
+            if (stopIndex == _numberOfVertices) {
+                const glm::vec3 p = _translation->position({
+                    {},
+                    Time(_end),
+                    Time(0.0)
+                });
+                _vertexArray[stopIndex] = { p.x, p.y, p.z };
+
+                _sweepIteration = 0;
+                setBoundingSphere(glm::distance(_maxVertex, _minVertex) / 2.f);
+            }
+            else {
+                // Early return as we don't need to render if we are still
+                // doing full sweep calculations
+                return;
+            }
         }
 
         // Upload vertices to the GPU
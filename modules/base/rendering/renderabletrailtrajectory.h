@@ -31,7 +31,9 @@
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/doubleproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
+#include <openspace/util/taskscheduler.h>
 #include <array>
+#include <vector>
 
 namespace openspace {
 
@@ -97,6 +99,9 @@ private:
     /// Tracks sweep iteration, is used to calculate which vertices to work on per frame
     int _sweepIteration = 0;
 
+    /// The positions of the full sweep if the translation computes them asynchronously
+    TaskFuture<std::vector<glm::dvec3>> _requestedPositions;
+
     /// How many points do we need to compute given the distance between the
     /// start and end date and the desired sample interval
     unsigned int _numberOfVertices = 0;
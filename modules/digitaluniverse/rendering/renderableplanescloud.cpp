@@ -309,7 +309,7 @@ RenderablePlanesCloud::RenderablePlanesCloud(const ghoul::Dictionary& dictionary
 }
 
 bool RenderablePlanesCloud::isReady() const {
-    bool isReady = _program && !_dataset.entries.empty();
+    bool isReady = _program && _dataset.size() > 0;
 
     // If we have labels, they also need to be loaded
     if (_hasLabels) {
@@ -322,10 +322,13 @@ void RenderablePlanesCloud::initialize() {
     ZoneScoped;
 
     if (_hasSpeckFile && std::filesystem::is_regular_file(_speckFile)) {
-        _dataset = dataloader::data::loadFileWithCache(_speckFile);
-        if (_dataset.entries.empty()) {
+        // The planes are only created from the dataset, so the cache file is used in
+        // place instead of being deserialized
+        _mappedDataset = dataloader::data::mapFileWithCache(_speckFile);
+        if (!_mappedDataset.has_value() || _mappedDataset->view.isEmpty()) {
             throw ghoul::RuntimeError("Error loading data");
         }
+        _dataset = _mappedDataset->view;
     }
 
     if (_hasLabels) {
@@ -540,9 +543,9 @@ void RenderablePlanesCloud::createPlanes() {
         LDEBUG("Creating planes...");
         float maxSize = 0.f;
         double maxRadius = 0.0;
-        for (const dataloader::Dataset::Entry& e : _dataset.entries) {
+        for (size_t entry = 0; entry < _dataset.size(); entry++) {
             const glm::vec4 transformedPos = glm::vec4(
-                _transformationMatrix * glm::dvec4(e.position, 1.0)
+                _transformationMatrix * glm::dvec4(_dataset.positions[entry], 1.0)
             );
 
             const double r = glm::length(glm::dvec3(transformedPos) * scale);
@@ -552,9 +555,9 @@ void RenderablePlanesCloud::createPlanes() {
             glm::vec4 u = glm::vec4(
                 _transformationMatrix *
                 glm::dvec4(
-                    e.data[_dataset.orientationDataIndex + 0],
-                    e.data[_dataset.orientationDataIndex + 1],
-                    e.data[_dataset.orientationDataIndex + 2],
+                    _dataset.columns[_dataset.orientationDataIndex + 0][entry],
+                    _dataset.columns[_dataset.orientationDataIndex + 1][entry],
+                    _dataset.columns[_dataset.orientationDataIndex + 2][entry],
                     1.f
                 )
             );
@@ -564,9 +567,9 @@ void RenderablePlanesCloud::createPlanes() {
             glm::vec4 v = glm::vec4(
                 _transformationMatrix *
                 glm::dvec4(
-                    e.data[_dataset.orientationDataIndex + 3],
-                    e.data[_dataset.orientationDataIndex + 4],
-                    e.data[_dataset.orientationDataIndex + 5],
+                    _dataset.columns[_dataset.orientationDataIndex + 3][entry],
+                    _dataset.columns[_dataset.orientationDataIndex + 4][entry],
+                    _dataset.columns[_dataset.orientationDataIndex + 5][entry],
                     1.f
                 )
             );
@@ -574,7 +577,7 @@ void RenderablePlanesCloud::createPlanes() {
             v.w = 0.f;
 
             if (!_luminosityVar.empty()) {
-                float lumS = e.data[lumIdx] * _sluminosity;
+                float lumS = _dataset.columns[lumIdx][entry] * _sluminosity;
                 u *= lumS;
                 v *= lumS;
             }
@@ -609,7 +612,8 @@ void RenderablePlanesCloud::createPlanes() {
                 vertex1.x, vertex1.y, vertex1.z, 1.f, 1.f, 1.f,
             };
 
-            int textureIndex = static_cast<int>(e.data[_dataset.textureDataIndex]);
+            const float textureValue = _dataset.columns[_dataset.textureDataIndex][entry];
+            int textureIndex = static_cast<int>(textureValue);
             std::unordered_map<int, PlaneAggregate>::iterator found =
                 _planesMap.find(textureIndex);
             if (found != _planesMap.end()) {
@@ -40,6 +40,7 @@
 #include <ghoul/opengl/uniformcache.h>
 #include <filesystem>
 #include <functional>
+#include <optional>
 #include <unordered_map>
 
 namespace ghoul::filesystem { class File; }
@@ -112,7 +113,9 @@ private:
 
     DistanceUnit _unit = DistanceUnit::Parsec;
 
-    dataloader::Dataset _dataset;
+    /// The memory-mapped cache file of the speck file that #_dataset points into
+    std::optional<dataloader::MappedDataset> _mappedDataset;
+    dataloader::DatasetView _dataset;
 
     // Everything related to the labels is handled by LabelsComponent
     std::unique_ptr<LabelsComponent> _labels;
@@ -0,0 +1,86 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/gaia/rendering/nodelru.h>
+
+namespace openspace {
+
+void NodeLru::touch(unsigned long long octreePositionIndex, size_t nBytes) {
+    auto it = _lookup.find(octreePositionIndex);
+    if (it != _lookup.end()) {
+        // The node might have been reloaded with a different amount of data
+        Entry& entry = *it->second;
+        _totalBytes = _totalBytes - entry.nBytes + nBytes;
+        entry.nBytes = nBytes;
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return;
+    }
+
+    _entries.push_front({ octreePositionIndex, nBytes });
+    _lookup[octreePositionIndex] = _entries.begin();
+    _totalBytes += nBytes;
+}
+
+void NodeLru::erase(unsigned long long octreePositionIndex) {
+    auto it = _lookup.find(octreePositionIndex);
+    if (it == _lookup.end()) {
+        return;
+    }
+
+    _totalBytes -= it->second->nBytes;
+    _entries.erase(it->second);
+    _lookup.erase(it);
+}
+
+std::vector<unsigned long long> NodeLru::evict(size_t byteBudget) {
+    std::vector<unsigned long long> res;
+    while (_totalBytes > byteBudget && !_entries.empty()) {
+        const Entry& entry = _entries.back();
+        res.push_back(entry.octreePositionIndex);
+        _totalBytes -= entry.nBytes;
+        _lookup.erase(entry.octreePositionIndex);
+        _entries.pop_back();
+    }
+    return res;
+}
+
+bool NodeLru::contains(unsigned long long octreePositionIndex) const {
+    return _lookup.contains(octreePositionIndex);
+}
+
+size_t NodeLru::totalBytes() const {
+    return _totalBytes;
+}
+
+size_t NodeLru::size() const {
+    return _entries.size();
+}
+
+void NodeLru::clear() {
+    _entries.clear();
+    _lookup.clear();
+    _totalBytes = 0;
+}
+
+} // namespace openspace
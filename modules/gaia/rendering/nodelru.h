@@ -0,0 +1,102 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GAIA___NODELRU___H__
+#define __OPENSPACE_MODULE_GAIA___NODELRU___H__
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Keeps track of the Octree nodes that are loaded into RAM, ordered by when they were
+ * last used, together with the number of bytes each of them occupies. This is used to
+ * decide which nodes to unload once the RAM budget is exhausted. This class is not
+ * thread-safe.
+ */
+class NodeLru {
+public:
+    /**
+     * Marks the node with the provided \p octreePositionIndex as the most recently used
+     * one. If the node was not tracked before, it is added with \p nBytes bytes,
+     * otherwise its number of bytes is replaced by \p nBytes.
+     *
+     * \param octreePositionIndex The position index of the node that was used
+     * \param nBytes The number of bytes that the data of the node occupies
+     */
+    void touch(unsigned long long octreePositionIndex, size_t nBytes);
+
+    /**
+     * Stops tracking the node with the provided \p octreePositionIndex. Does nothing if
+     * the node was not tracked.
+     */
+    void erase(unsigned long long octreePositionIndex);
+
+    /**
+     * Removes the least recently used nodes until the total number of bytes is at most
+     * \p byteBudget and returns the position indices of the removed nodes, starting with
+     * the least recently used one.
+     *
+     * \param byteBudget The maximum number of bytes that the remaining nodes may occupy
+     * \return The position indices of the nodes that should be unloaded
+     */
+    std::vector<unsigned long long> evict(size_t byteBudget);
+
+    /**
+     * \return `true` if the node with the provided \p octreePositionIndex is tracked
+     */
+    bool contains(unsigned long long octreePositionIndex) const;
+
+    /**
+     * \return The sum of the bytes of all tracked nodes
+     */
+    size_t totalBytes() const;
+
+    /**
+     * \return The number of tracked nodes
+     */
+    size_t size() const;
+
+    /**
+     * Stops tracking all nodes.
+     */
+    void clear();
+
+private:
+    struct Entry {
+        unsigned long long octreePositionIndex;
+        size_t nBytes;
+    };
+
+    // The most recently used node is at the front
+    std::list<Entry> _entries;
+    std::unordered_map<unsigned long long, std::list<Entry>::iterator> _lookup;
+    size_t _totalBytes = 0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_GAIA___NODELRU___H__
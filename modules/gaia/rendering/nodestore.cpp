@@ -0,0 +1,250 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/gaia/rendering/nodestore.h>
+
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+    constexpr std::string_view _loggerCat = "NodeStore";
+
+    constexpr std::array<char, 8> Magic = { 'G', 'A', 'I', 'A', 'N', 'O', 'D', 'E' };
+    constexpr uint32_t CurrentVersion = 1;
+
+    // The data of each node starts at a multiple of this many bytes
+    constexpr uint64_t DataAlignment = 16;
+
+    struct Header {
+        std::array<char, 8> magic;
+        uint32_t version;
+        uint32_t padding;
+        uint64_t nNodes;
+    };
+    static_assert(sizeof(Header) == 24);
+
+    uint64_t alignOffset(uint64_t offset) {
+        return (offset + DataAlignment - 1) / DataAlignment * DataAlignment;
+    }
+
+    // Returns the position index of the node that is stored in the file at `path`, or 0
+    // if the file is not a node file. Node files are named after their position index
+    // without the leading root index 8
+    unsigned long long nodeIndexFromPath(const std::filesystem::path& path) {
+        if (path.extension() != ".bin") {
+            return 0;
+        }
+        const std::string stem = path.stem().string();
+        const bool isNodeIndex = std::all_of(
+            stem.begin(),
+            stem.end(),
+            [](char c) { return c >= '0' && c <= '7'; }
+        );
+        if (stem.empty() || !isNodeIndex) {
+            return 0;
+        }
+        return std::stoull("8" + stem);
+    }
+} // namespace
+
+namespace openspace {
+
+void NodeStore::pack(const std::filesystem::path& folder,
+                     const std::filesystem::path& storePath)
+{
+    std::vector<std::pair<unsigned long long, std::filesystem::path>> nodeFiles;
+    for (const std::filesystem::directory_entry& e :
+         std::filesystem::directory_iterator(folder))
+    {
+        if (!e.is_regular_file()) {
+            continue;
+        }
+        const unsigned long long index = nodeIndexFromPath(e.path());
+        if (index != 0) {
+            nodeFiles.emplace_back(index, e.path());
+        }
+    }
+    std::sort(nodeFiles.begin(), nodeFiles.end());
+
+    LINFO(std::format(
+        "Packing {} node files from '{}' into '{}'", nodeFiles.size(), folder, storePath
+    ));
+
+    // Write into a temporary file first so that an interrupted packing never leaves a
+    // partial node store behind
+    std::filesystem::path tempPath = storePath;
+    tempPath += ".tmp";
+    std::ofstream out = std::ofstream(tempPath, std::ofstream::binary);
+    if (!out.good()) {
+        throw ghoul::RuntimeError(std::format(
+            "Error opening file '{}' as node store output file", tempPath
+        ));
+    }
+
+    Header header = {
+        .magic = Magic,
+        .version = CurrentVersion,
+        .padding = 0,
+        .nNodes = nodeFiles.size()
+    };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    // The index is written once the offsets of all nodes are known
+    std::vector<IndexEntry> index;
+    index.reserve(nodeFiles.size());
+    const uint64_t indexOffset = sizeof(Header);
+    uint64_t offset = alignOffset(indexOffset + nodeFiles.size() * sizeof(IndexEntry));
+
+    std::vector<float> data;
+    for (const auto& [octreePositionIndex, path] : nodeFiles) {
+        std::ifstream in = std::ifstream(path, std::ifstream::binary);
+        int32_t nValues = 0;
+        in.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
+        if (!in.good() || nValues < 0) {
+            throw ghoul::RuntimeError(std::format(
+                "Error reading node data file '{}'", path
+            ));
+        }
+        data.resize(nValues);
+        in.read(reinterpret_cast<char*>(data.data()), nValues * sizeof(float));
+        if (in.gcount() != static_cast<std::streamsize>(nValues * sizeof(float))) {
+            throw ghoul::RuntimeError(std::format(
+                "Error reading node data file '{}'", path
+            ));
+        }
+
+        out.seekp(offset);
+        out.write(reinterpret_cast<const char*>(data.data()), nValues * sizeof(float));
+        index.push_back({
+            .octreePositionIndex = octreePositionIndex,
+            .offset = offset,
+            .nValues = static_cast<uint64_t>(nValues)
+        });
+        offset = alignOffset(offset + nValues * sizeof(float));
+    }
+
+    out.seekp(indexOffset);
+    out.write(
+        reinterpret_cast<const char*>(index.data()),
+        index.size() * sizeof(IndexEntry)
+    );
+    out.close();
+    if (!out) {
+        throw ghoul::RuntimeError(std::format(
+            "Error writing node store file '{}'", tempPath
+        ));
+    }
+
+    std::filesystem::rename(tempPath, storePath);
+}
+
+NodeStore::NodeStore(const std::filesystem::path& storePath)
+    : _file(storePath)
+{
+    const std::span<const std::byte> data = _file.data();
+    if (data.size() < sizeof(Header)) {
+        throw ghoul::RuntimeError(std::format(
+            "Node store file '{}' is too small", storePath
+        ));
+    }
+
+    Header header;
+    std::memcpy(&header, data.data(), sizeof(Header));
+    if (header.magic != Magic || header.version != CurrentVersion) {
+        throw ghoul::RuntimeError(std::format(
+            "File '{}' is not a node store file of version {}", storePath, CurrentVersion
+        ));
+    }
+    if (header.nNodes > (data.size() - sizeof(Header)) / sizeof(IndexEntry)) {
+        throw ghoul::RuntimeError(std::format(
+            "Index of node store file '{}' is truncated", storePath
+        ));
+    }
+
+    // The header size is a multiple of the alignment of the index entries and the
+    // mapping itself is page aligned, so the index can be used in place
+    _index = std::span<const IndexEntry>(
+        reinterpret_cast<const IndexEntry*>(data.data() + sizeof(Header)),
+        header.nNodes
+    );
+    for (const IndexEntry& entry : _index) {
+        if (entry.offset % DataAlignment != 0 || entry.offset > data.size() ||
+            entry.nValues > (data.size() - entry.offset) / sizeof(float))
+        {
+            throw ghoul::RuntimeError(std::format(
+                "Node {} in node store file '{}' is out of bounds",
+                entry.octreePositionIndex, storePath
+            ));
+        }
+    }
+}
+
+std::span<const float> NodeStore::nodeData(unsigned long long octreePositionIndex) const
+{
+    const IndexEntry* entry = findEntry(octreePositionIndex);
+    if (!entry) {
+        return std::span<const float>();
+    }
+
+    return std::span<const float>(
+        reinterpret_cast<const float*>(_file.data().data() + entry->offset),
+        entry->nValues
+    );
+}
+
+void NodeStore::prefetch(unsigned long long octreePositionIndex) const {
+    const IndexEntry* entry = findEntry(octreePositionIndex);
+    if (entry) {
+        _file.prefetch(entry->offset, entry->nValues * sizeof(float));
+    }
+}
+
+size_t NodeStore::numNodes() const {
+    return _index.size();
+}
+
+const NodeStore::IndexEntry* NodeStore::findEntry(
+                                          unsigned long long octreePositionIndex) const
+{
+    auto it = std::lower_bound(
+        _index.begin(),
+        _index.end(),
+        octreePositionIndex,
+        [](const IndexEntry& e, unsigned long long i) {
+            return e.octreePositionIndex < i;
+        }
+    );
+    if (it == _index.end() || it->octreePositionIndex != octreePositionIndex) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+} // namespace openspace
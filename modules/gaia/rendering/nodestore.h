@@ -0,0 +1,112 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GAIA___NODESTORE___H__
+#define __OPENSPACE_MODULE_GAIA___NODESTORE___H__
+
+#include <openspace/util/memorymappedfile.h>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+namespace openspace {
+
+/**
+ * A single file that contains the data of all nodes of a streamed Octree, together with
+ * an index that maps the position index of a node to the location of its data. The file
+ * is memory-mapped, so looking up a node does neither open a file nor copy any data.
+ *
+ * The file starts with a header, followed by the index entries sorted by the position
+ * index of the node and finally the data of all nodes. The data of each node consists
+ * of the same values as the individual node files that are written by
+ * `OctreeManager::writeToMultipleFiles`.
+ */
+class NodeStore {
+public:
+    /// The name of the node store file inside the folder of a streamed Octree
+    static constexpr std::string_view FileName = "nodes.store";
+
+    /**
+     * Packs all individual node files in \p folder into a single node store file at
+     * \p storePath.
+     *
+     * \param folder The folder that contains the node files of a streamed Octree
+     * \param storePath The path to which the node store file is written
+     *
+     * \throw ghoul::RuntimeError If any of the node files could not be read or the node
+     *        store file could not be written
+     */
+    static void pack(const std::filesystem::path& folder,
+        const std::filesystem::path& storePath);
+
+    /**
+     * Maps the node store file at \p storePath into memory.
+     *
+     * \param storePath The path to a file that was created by #pack
+     *
+     * \throw ghoul::RuntimeError If the file could not be mapped or is not a valid node
+     *        store file
+     */
+    explicit NodeStore(const std::filesystem::path& storePath);
+
+    /**
+     * Returns the data of the node with the provided \p octreePositionIndex. The span is
+     * pointing into the mapped file and is valid for as long as this object is alive.
+     *
+     * \param octreePositionIndex The position index of the requested node
+     * \return The values of the node or an empty span if the node does not exist
+     */
+    std::span<const float> nodeData(unsigned long long octreePositionIndex) const;
+
+    /**
+     * Asks the operating system to read the data of the node with the provided
+     * \p octreePositionIndex from disk in the background, so that a later call to
+     * #nodeData will not have to wait for it.
+     *
+     * \param octreePositionIndex The position index of the node that will be needed soon
+     */
+    void prefetch(unsigned long long octreePositionIndex) const;
+
+    /**
+     * \return The number of nodes in the node store
+     */
+    size_t numNodes() const;
+
+private:
+    struct IndexEntry {
+        uint64_t octreePositionIndex;
+        uint64_t offset;
+        uint64_t nValues;
+    };
+
+    const IndexEntry* findEntry(unsigned long long octreePositionIndex) const;
+
+    MemoryMappedFile _file;
+    std::span<const IndexEntry> _index;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_GAIA___NODESTORE___H__
@@ -24,17 +24,34 @@
 
 #include <modules/gaia/rendering/octreemanager.h>
 
+#include <modules/gaia/rendering/nodestore.h>
 #include <modules/gaia/rendering/octreeculler.h>
 #include <openspace/util/distanceconstants.h>
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
 #include <ghoul/format.h>
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
 #include <fstream>
 #include <thread>
 
 namespace {
     constexpr std::string_view _loggerCat = "OctreeManager";
 
+    // The number of threads that load and unload nodes in the background while streaming
+    constexpr size_t NumStreamingThreads = 2;
+
+    // The number of frames that the camera's current velocity is extrapolated to predict
+    // which nodes will be needed next
+    constexpr double PrefetchLookAheadFrames = 30.0;
+
+    // Once the loaded nodes use more than this fraction of the RAM budget, the least
+    // recently used nodes are unloaded until they use less than the second fraction
+    constexpr double EvictionThreshold = 0.9;
+    constexpr double EvictionTarget = 0.8;
+
     /**
      * \return the correct index of child node. Maps [1,1,1] to 0 and [-1,-1,-1] to 7
      */
@@ -57,7 +74,92 @@ namespace {
 
 namespace openspace {
 
+OctreeManager::OctreeManager() = default;
+
+OctreeManager::~OctreeManager() {
+    // Exceptions thrown by a traversal can't be handled here
+    if (_pendingTraversal.isValid()) {
+        _pendingTraversal.wait();
+    }
+}
+
+std::span<const float> OctreeManager::TraversalResult::data(const Update& update) const {
+    return std::span<const float>(values.data() + update.offset, update.size);
+}
+
+void OctreeManager::TraversalResult::clear() {
+    updates.clear();
+    values.clear();
+    deltaStars = 0;
+}
+
+void OctreeManager::TraversalResult::finalize() {
+    std::stable_sort(
+        updates.begin(),
+        updates.end(),
+        [](const Update& lhs, const Update& rhs) {
+            return lhs.bufferIndex < rhs.bufferIndex;
+        }
+    );
+
+    // A chunk can be cleared by one node and claimed by another one in the same
+    // traversal while the buffer is rebuilt. Keep the data in that case
+    auto out = updates.begin();
+    for (auto it = updates.begin(); it != updates.end();) {
+        auto last = it;
+        Update update = *it;
+        while (last != updates.end() && last->bufferIndex == it->bufferIndex) {
+            if (last->size > 0) {
+                update = *last;
+            }
+            ++last;
+        }
+        *out = update;
+        ++out;
+        it = last;
+    }
+    updates.erase(out, updates.end());
+}
+
+void OctreeManager::TraversalResult::mergePrevious(const TraversalResult& previous) {
+    const size_t nUpdates = updates.size();
+    for (const Update& update : previous.updates) {
+        // The updates of this traversal happened later, so they take precedence
+        const auto it = std::lower_bound(
+            updates.begin(),
+            updates.begin() + nUpdates,
+            update.bufferIndex,
+            [](const Update& u, int bufferIndex) { return u.bufferIndex < bufferIndex; }
+        );
+        if (it != updates.begin() + nUpdates && it->bufferIndex == update.bufferIndex) {
+            continue;
+        }
+
+        const std::span<const float> v = previous.data(update);
+        updates.push_back({
+            .bufferIndex = update.bufferIndex,
+            .offset = values.size(),
+            .size = v.size()
+        });
+        values.insert(values.end(), v.begin(), v.end());
+    }
+    std::inplace_merge(
+        updates.begin(),
+        updates.begin() + nUpdates,
+        updates.end(),
+        [](const Update& lhs, const Update& rhs) {
+            return lhs.bufferIndex < rhs.bufferIndex;
+        }
+    );
+    deltaStars += previous.deltaStars;
+}
+
 void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStarsPerNode) {
+    waitForTraversal();
+
+    // Stop loading nodes into the old Octree before it is cleared
+    _streamingScheduler = nullptr;
+
     if (_root) {
         LDEBUG("Clear existing Octree");
         clearAllData();
@@ -73,7 +175,10 @@ void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStars
     box.max = glm::vec3(1.f, 1.f, 100.f);
     _culler = std::make_unique<OctreeCuller>(box);
     _removedKeysInPrevCall = std::set<int>();
-    _leastRecentlyFetchedNodes = std::queue<unsigned long long>();
+    {
+        const std::lock_guard lock(_loadedNodesMutex);
+        _loadedNodes.clear();
+    }
 
     // Reset default values when rebuilding the Octree during runtime
     _numInnerNodes = 0;
@@ -83,6 +188,8 @@ void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStars
     _maxCpuRamBudget = cpuRamBudget;
     _cpuRamBudget = cpuRamBudget;
     _parentNodeOfCamera = 8;
+    _predictedParentNode = 8;
+    _previousCameraPos = std::nullopt;
 
     if (maxDist > 0) {
         MAX_DIST = static_cast<size_t>(maxDist);
@@ -119,6 +226,13 @@ void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStars
 
 void OctreeManager::initBufferIndexStack(long long maxNodes, bool useVBO,
                                          bool datasetFitInMemory)
+{
+    waitForTraversal();
+    resetBufferIndexStack(maxNodes, useVBO, datasetFitInMemory);
+}
+
+void OctreeManager::resetBufferIndexStack(long long maxNodes, bool useVBO,
+                                          bool datasetFitInMemory)
 {
     // Clear stack if we've used it before
     _biggestChunkIndexInUse = 0;
@@ -136,17 +250,21 @@ void OctreeManager::initBufferIndexStack(long long maxNodes, bool useVBO,
 }
 
 void OctreeManager::insert(const std::vector<float>& starValues) {
-    const size_t index = childIndex(starValues[0], starValues[1], starValues[2]);
+    const size_t index = branchIndex(starValues[0], starValues[1], starValues[2]);
 
     insertInNode(*_root->children[index], starValues);
 }
 
+size_t OctreeManager::branchIndex(float x, float y, float z) {
+    return childIndex(x, y, z);
+}
+
 void OctreeManager::sliceLodData(size_t branchIndex) {
     if (branchIndex != 8) {
         sliceNodeLodCache(*_root->children[branchIndex]);
     }
     else {
-        for (int i = 0; i < 7; i++) {
+        for (int i = 0; i < 8; i++) {
             sliceNodeLodCache(*_root->children[i]);
         }
     }
@@ -166,7 +284,6 @@ void OctreeManager::printStarsPerNode() const {
 }
 
 void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
-                                          size_t chunkSizeInBytes,
                                           const glm::ivec2& additionalNodes)
 {
 
@@ -196,24 +313,25 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
         return;
     }
 
+    // Get the number of levels to fetch from user input
+    int additionalLevelsToFetch = additionalNodes.y;
+
     // Get leaf node in which the camera resides
     const glm::vec3 fCameraPos = cameraPos / (1000.0 * distanceconstants::Parsec);
-    size_t idx = childIndex(fCameraPos.x, fCameraPos.y, fCameraPos.z);
-    std::shared_ptr<OctreeNode> node = _root->children[idx];
+    const unsigned long long leafId = findLeafNode(fCameraPos)->octreePositionIndex;
+    const unsigned long long firstParentId = leafId / 10;
 
-    while (!node->isLeaf) {
-        idx = childIndex(
-            fCameraPos.x,
-            fCameraPos.y,
-            fCameraPos.z,
-            node->originX,
-            node->originY,
-            node->originZ
+    // Extrapolate the movement of the camera since the last frame to start loading the
+    // nodes that it is heading towards before it gets there
+    if (_previousCameraPos.has_value()) {
+        const glm::dvec3 velocity = cameraPos - *_previousCameraPos;
+        const glm::dvec3 predictedPos = cameraPos + velocity * PrefetchLookAheadFrames;
+        prefetchPredictedNodes(
+            predictedPos / (1000.0 * distanceconstants::Parsec),
+            additionalLevelsToFetch
         );
-        node = node->children[idx];
     }
-    const unsigned long long leafId = node->octreePositionIndex;
-    const unsigned long long firstParentId = leafId / 10;
+    _previousCameraPos = cameraPos;
 
     // Return early if camera resides in the same first parent as before.
     // Otherwise camera has moved and may need to load more nodes
@@ -228,9 +346,6 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
     const unsigned long long fourthParentId = (thirdParentId == 8) ? 8 : leafId / 10000;
     const unsigned long long fifthParentId = (fourthParentId == 8) ? 8 : leafId / 100000;
 
-    // Get the number of levels to fetch from user input
-    int additionalLevelsToFetch = additionalNodes.y;
-
     // Get more descendants when closer to root.
     if (_parentNodeOfCamera < 80000) {
         additionalLevelsToFetch++;
@@ -291,37 +406,116 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
         }
     }
 
-    // Check if we should remove any nodes from RAM
-    const long long tenthOfRamBudget = _maxCpuRamBudget / 10;
-    if (_cpuRamBudget < tenthOfRamBudget) {
-        const long long bytesToTenthOfRam = tenthOfRamBudget - _cpuRamBudget;
-        size_t nNodesToRemove = static_cast<size_t>(bytesToTenthOfRam / chunkSizeInBytes);
-        std::vector<unsigned long long> nodesToRemove;
-        while (nNodesToRemove > 0) {
-            // Dequeue nodes that were least recently fetched by findAndFetchNeighborNode
-            nodesToRemove.push_back(_leastRecentlyFetchedNodes.front());
-            _leastRecentlyFetchedNodes.pop();
-            nNodesToRemove--;
+    // Unload the least recently used nodes if we are running out of RAM
+    std::vector<unsigned long long> nodesToRemove;
+    {
+        const std::lock_guard lock(_loadedNodesMutex);
+        const double threshold = _maxCpuRamBudget * EvictionThreshold;
+        if (static_cast<double>(_loadedNodes.totalBytes()) > threshold) {
+            nodesToRemove = _loadedNodes.evict(
+                static_cast<size_t>(_maxCpuRamBudget * EvictionTarget)
+            );
         }
-        // Use asynchronous removal.
-        if (!nodesToRemove.empty()) {
-            std::thread(&OctreeManager::removeNodesFromRam, this, nodesToRemove).detach();
+    }
+    // Use asynchronous removal.
+    if (!nodesToRemove.empty()) {
+        _streamingScheduler->enqueue(
+            [this, nodes = std::move(nodesToRemove)]() { removeNodesFromRam(nodes); },
+            TaskScheduler::Priority::High
+        );
+    }
+}
+
+std::shared_ptr<OctreeManager::OctreeNode> OctreeManager::findLeafNode(
+                                                              const glm::vec3& pos) const
+{
+    size_t idx = childIndex(pos.x, pos.y, pos.z);
+    std::shared_ptr<OctreeNode> node = _root->children[idx];
+
+    while (!node->isLeaf) {
+        idx = childIndex(
+            pos.x,
+            pos.y,
+            pos.z,
+            node->originX,
+            node->originY,
+            node->originZ
+        );
+        node = node->children[idx];
+    }
+    return node;
+}
+
+void OctreeManager::prefetchPredictedNodes(const glm::vec3& predictedPos,
+                                           int additionalLevelsToFetch)
+{
+    const unsigned long long firstParentId =
+        findLeafNode(predictedPos)->octreePositionIndex / 10;
+
+    // Nothing to do if the camera isn't moving fast enough to leave its current parent,
+    // or if the nodes have already been requested for a previous prediction
+    if (firstParentId == _parentNodeOfCamera || firstParentId == _predictedParentNode) {
+        return;
+    }
+    _predictedParentNode = firstParentId;
+
+    for (int x = -1; x <= 1; x += 1) {
+        for (int y = -2; y <= 2; y += 2) {
+            for (int z = -4; z <= 4; z += 4) {
+                findAndFetchNeighborNode(
+                    firstParentId,
+                    x,
+                    y,
+                    z,
+                    additionalLevelsToFetch,
+                    TaskScheduler::Priority::Low
+                );
+            }
         }
     }
 }
 
 void OctreeManager::findAndFetchNeighborNode(unsigned long long firstParentId, int x,
-                                             int y, int z, int additionalLevelsToFetch)
+                                             int y, int z, int additionalLevelsToFetch,
+                                             TaskScheduler::Priority priority)
 {
-    unsigned long long parentId = firstParentId;
-    std::stack<int> indexStack;
-
     // Fetch first layer children if we're already at root
-    if (parentId == 8) {
+    if (firstParentId == 8) {
         fetchChildrenNodes(*_root, 0);
         return;
     }
 
+    std::shared_ptr<OctreeNode> node = findNeighborNode(firstParentId, x, y, z);
+    if (!node) {
+        return;
+    }
+
+    // Let the OS start reading the data of the children from disk right away, the
+    // background thread might not get to them immediately
+    if (_nodeStore) {
+        for (const std::shared_ptr<OctreeNode>& child : node->children) {
+            if (!child->isLoaded && child->numStars > 0) {
+                _nodeStore->prefetch(child->octreePositionIndex);
+            }
+        }
+    }
+
+    // Fetch all children nodes from found parent asynchronously
+    _streamingScheduler->enqueue(
+        [this, node, additionalLevelsToFetch]() {
+            fetchChildrenNodes(*node, additionalLevelsToFetch);
+        },
+        priority
+    );
+}
+
+std::shared_ptr<OctreeManager::OctreeNode> OctreeManager::findNeighborNode(
+                                                         unsigned long long firstParentId,
+                                                                      int x, int y, int z)
+{
+    unsigned long long parentId = firstParentId;
+    std::stack<int> indexStack;
+
     //----------------- Change first index -------------------//
     int nodeIndex = parentId % 10;
 
@@ -383,7 +577,7 @@ void OctreeManager::findAndFetchNeighborNode(unsigned long long firstParentId, i
     // Take care of edge cases. If we got to the root but still need to switch to a
     // common parent then no neighbor exists in that direction
     if (needToSwitchX || needToSwitchY || needToSwitchZ) {
-        return;
+        return nullptr;
     }
 
     // Continue to root if we didn't reach it
@@ -401,21 +595,79 @@ void OctreeManager::findAndFetchNeighborNode(unsigned long long firstParentId, i
         indexStack.pop();
     }
 
-    // Fetch all children nodes from found parent. Use multithreading to load files
-    // asynchronously! Detach thread from main execution so it can execute independently.
-    // Thread will then be destroyed when it has finished
-    std::thread([this, node, additionalLevelsToFetch]() {
-        fetchChildrenNodes(*node, additionalLevelsToFetch);
-    }).detach();
+    return node;
 }
 
-std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4& mvp,
+const OctreeManager::TraversalResult& OctreeManager::traverseData(
+                                                              const glm::dmat4& mvp,
                                                               const glm::vec2& screenSize,
-                                                              int& deltaStars,
                                                               gaia::RenderMode mode,
                                                               float lodPixelThreshold)
 {
-    std::map<int, std::vector<float>> renderData;
+    // A traversal that was started asynchronously but never finished has already
+    // claimed and freed buffer indices, so its updates have to be passed on as well
+    const bool hasPendingResult = _pendingTraversal.isValid();
+    waitForTraversal();
+    const TraversalResult& pending = _traversalResults[_currentTraversalResult];
+
+    // Don't overwrite the result that was returned by the previous traversal, as it
+    // might still be in use
+    _currentTraversalResult = (_currentTraversalResult + 1) % _traversalResults.size();
+    TraversalResult& result = _traversalResults[_currentTraversalResult];
+    traverseOctree(mvp, screenSize, mode, lodPixelThreshold, result);
+    if (hasPendingResult) {
+        result.mergePrevious(pending);
+    }
+    return result;
+}
+
+void OctreeManager::beginTraversal(const glm::dmat4& mvp, const glm::vec2& screenSize,
+                                   gaia::RenderMode mode, float lodPixelThreshold)
+{
+    waitForTraversal();
+
+    if (!_traversalScheduler) {
+        _traversalScheduler = std::make_unique<TaskScheduler>(1);
+    }
+
+    _currentTraversalResult = (_currentTraversalResult + 1) % _traversalResults.size();
+    TraversalResult& result = _traversalResults[_currentTraversalResult];
+    _pendingTraversal = _traversalScheduler->submit(
+        [this, mvp, screenSize, mode, lodPixelThreshold, &result]() {
+            traverseOctree(mvp, screenSize, mode, lodPixelThreshold, result);
+        },
+        TaskScheduler::Priority::High
+    );
+}
+
+const OctreeManager::TraversalResult& OctreeManager::finishTraversal() {
+    if (!_pendingTraversal.isValid()) {
+        // Nothing was traversed, so there is nothing to update either
+        _currentTraversalResult =
+            (_currentTraversalResult + 1) % _traversalResults.size();
+        TraversalResult& result = _traversalResults[_currentTraversalResult];
+        result.clear();
+        result.biggestChunkIndexInUse = _biggestChunkIndexInUse;
+        result.numFreeSpotsInBuffer = _freeSpotsInBuffer.size();
+        return result;
+    }
+
+    waitForTraversal();
+    return _traversalResults[_currentTraversalResult];
+}
+
+void OctreeManager::waitForTraversal() {
+    if (_pendingTraversal.isValid()) {
+        // Rethrows any exception that was thrown during the traversal
+        _pendingTraversal.get();
+    }
+}
+
+void OctreeManager::traverseOctree(const glm::dmat4& mvp, const glm::vec2& screenSize,
+                                   gaia::RenderMode mode, float lodPixelThreshold,
+                                   TraversalResult& result)
+{
+    result.clear();
     bool innerRebuild = false;
     _minTotalPixelsLod = lodPixelThreshold;
 
@@ -447,12 +699,12 @@ std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4&
             _biggestChunkIndexInUse, _maxStackSize * 4 / 5, _freeSpotsInBuffer.size(),
             _maxStackSize * 5 / 6
         ));
-        initBufferIndexStack(_maxStackSize, _useVBO, _datasetFitInMemory);
+        resetBufferIndexStack(_maxStackSize, _useVBO, _datasetFitInMemory);
         innerRebuild = true;
     }
 
     // Check if entire tree is too small to see, and if so remove it
-    std::vector<glm::dvec4> corners(8);
+    std::array<glm::dvec4, 8> corners;
     const float fMaxDist = static_cast<float>(MAX_DIST);
     for (int i = 0; i < 8; i++) {
         const float x = (i % 2 == 0) ? fMaxDist : -fMaxDist;
@@ -462,20 +714,21 @@ std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4&
         corners[i] = glm::dvec4(pos, 1.0);
     }
     if (!_culler->isVisible(corners, mvp)) {
-        return renderData;
+        result.biggestChunkIndexInUse = _biggestChunkIndexInUse;
+        result.numFreeSpotsInBuffer = _freeSpotsInBuffer.size();
+        return;
     }
-    const glm::vec2 nodeSize = _culler->getNodeSizeInPixels(corners, mvp, screenSize);
+    const glm::vec2 nodeSize = _culler->getNodeSizeInPixels(screenSize);
     const float totalPixels = nodeSize.x * nodeSize.y;
     if (totalPixels < _minTotalPixelsLod * 2) {
         // Remove LOD from first layer of children
         for (const std::shared_ptr<OctreeNode>& child : _root->children) {
-            std::map<int, std::vector<float>> tmpData = removeNodeFromCache(
-                *child,
-                deltaStars
-            );
-            renderData.insert(tmpData.begin(), tmpData.end());
+            removeNodeFromCache(*child, result);
         }
-        return renderData;
+        result.finalize();
+        result.biggestChunkIndexInUse = _biggestChunkIndexInUse;
+        result.numFreeSpotsInBuffer = _freeSpotsInBuffer.size();
+        return;
     }
 
     for (size_t i = 0; i < 8; i++) {
@@ -483,39 +736,25 @@ std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4&
             continue;
         }
 
-        std::map<int, std::vector<float>> tmpData = checkNodeIntersection(
-            *_root->children[i],
-            mvp,
-            screenSize,
-            deltaStars,
-            mode
-        );
+        checkNodeIntersection(*_root->children[i], mvp, screenSize, mode, result);
 
         // Avoid freezing when switching render mode for large datasets by only fetching
         // one branch at a time when rebuilding buffer
         if (_rebuildBuffer) {
             _traversedBranchesInRenderCall++;
         }
-
-        // Observe that if there exists identical keys in renderData then those values in
-        // tmpData will be ignored! Thus we store the removed keys until next render call
-        renderData.insert(tmpData.begin(), tmpData.end());
     }
 
     if (_rebuildBuffer) {
         if (_useVBO) {
-            // We need to overwrite bigger indices that had data before! No need for SSBO
-            std::map<int, std::vector<float>> idxToRemove;
+            // We need to overwrite bigger indices that had data before! No need for SSBO.
+            // These are dropped in favor of new data for the same index when finalizing
             for (const int idx : _removedKeysInPrevCall) {
-                idxToRemove[idx] = std::vector<float>();
+                result.updates.push_back({ idx, result.values.size(), 0 });
             }
-
-            // This will only insert indices that doesn't already exist in map
-            // (i.e. > biggestIdx)
-            renderData.insert(idxToRemove.begin(), idxToRemove.end());
         }
         if (innerRebuild) {
-            deltaStars = 0;
+            result.deltaStars = 0;
         }
 
         // Clear potential removed keys for both VBO and SSBO
@@ -533,7 +772,10 @@ std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4&
             _traversedBranchesInRenderCall = 0;
         }
     }
-    return renderData;
+
+    result.finalize();
+    result.biggestChunkIndexInUse = _biggestChunkIndexInUse;
+    result.numFreeSpotsInBuffer = _freeSpotsInBuffer.size();
 }
 
 std::vector<float> OctreeManager::getAllData(gaia::RenderMode mode) {
@@ -613,6 +855,7 @@ int OctreeManager::readFromFile(std::ifstream& inFileStream, bool readData,
     _streamOctree = !readData;
     if (_streamOctree) {
         _streamFolderPath = folderPath;
+        _streamingScheduler = std::make_unique<TaskScheduler>(NumStreamingThreads);
     }
 
     _valuesPerStar = 0;
@@ -649,9 +892,51 @@ int OctreeManager::readFromFile(std::ifstream& inFileStream, bool readData,
     for (const std::shared_ptr<OctreeNode>& child : _root->children) {
         nStarsRead += readNodeFromFile(inFileStream, *child, readData);
     }
+
+    if (_streamOctree) {
+        openNodeStore(folderPath);
+    }
     return nStarsRead;
 }
 
+void OctreeManager::openNodeStore(const std::filesystem::path& folderPath) {
+    _nodeStore = nullptr;
+
+    std::filesystem::path storePath = folderPath / NodeStore::FileName;
+    if (!std::filesystem::is_regular_file(storePath)) {
+        // Older datasets only come with individual node files, so we pack them once
+        storePath = FileSys.cacheManager()->cachedFilename(
+            folderPath / "index.bin",
+            std::string(NodeStore::FileName)
+        );
+        if (!std::filesystem::is_regular_file(storePath)) {
+            try {
+                NodeStore::pack(folderPath, storePath);
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LWARNING(std::format(
+                    "Could not create node store, reading individual node files instead: "
+                    "{}", e.message
+                ));
+                return;
+            }
+        }
+    }
+
+    try {
+        _nodeStore = std::make_unique<NodeStore>(storePath);
+        LDEBUG(std::format(
+            "Streaming {} nodes from node store '{}'", _nodeStore->numNodes(), storePath
+        ));
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LWARNING(std::format(
+            "Could not open node store, reading individual node files instead: {}",
+            e.message
+        ));
+    }
+}
+
 int OctreeManager::readNodeFromFile(std::ifstream& inFileStream, OctreeNode& node,
                                     bool readData)
 {
@@ -784,6 +1069,14 @@ void OctreeManager::fetchChildrenNodes(OctreeNode& parentNode,
         {
             fetchNodeDataFromFile(*child);
         }
+        else if (child->isLoaded && !_datasetFitInMemory) {
+            // The node is still needed, so it should be the last one to be unloaded
+            const std::lock_guard g(_loadedNodesMutex);
+            _loadedNodes.touch(
+                child->octreePositionIndex,
+                child->numStars * _valuesPerStar * sizeof(float)
+            );
+        }
 
         // Fetch all Children's Children if recursive is set to true
         if (additionalLevelsToFetch != 0 && !child->isLeaf) {
@@ -793,15 +1086,30 @@ void OctreeManager::fetchChildrenNodes(OctreeNode& parentNode,
 }
 
 void OctreeManager::fetchNodeDataFromFile(OctreeNode& node) {
-    // Remove root ID ("8") from index before loading file
-    std::string posId = std::to_string(node.octreePositionIndex);
-    posId.erase(posId.begin());
-
-    const std::string inFilePath = _streamFolderPath + posId + BINARY_SUFFIX;
-    std::ifstream inFileStream(inFilePath, std::ifstream::binary);
-    // LINFO("Fetch node data file: " + inFilePath);
+    std::span<const float> data;
+    std::vector<float> readData;
+    if (_nodeStore) {
+        // The data is mapped into memory, so it can be split up without reading it first
+        data = _nodeStore->nodeData(node.octreePositionIndex);
+        if (data.empty()) {
+            LERROR(std::format(
+                "Node {} is missing in the node store", node.octreePositionIndex
+            ));
+            return;
+        }
+    }
+    else {
+        // Remove root ID ("8") from index before loading file
+        std::string posId = std::to_string(node.octreePositionIndex);
+        posId.erase(posId.begin());
+
+        const std::string inFilePath = _streamFolderPath + posId + BINARY_SUFFIX;
+        std::ifstream inFileStream(inFilePath, std::ifstream::binary);
+        if (!inFileStream.good()) {
+            LERROR("Error opening node data file: " + inFilePath);
+            return;
+        }
 
-    if (inFileStream.good()) {
         // Read node data
         int32_t nDataSize = 0;
 
@@ -809,31 +1117,32 @@ void OctreeManager::fetchNodeDataFromFile(OctreeNode& node) {
         // Otherwise don't call this function!
         inFileStream.read(reinterpret_cast<char*>(&nDataSize), sizeof(int32_t));
 
-        std::vector<float> readData(nDataSize, 0.f);
-        const int nBytes = nDataSize * sizeof(float);
+        readData = std::vector<float>(nDataSize, 0.f);
         if (nDataSize > 0) {
-            inFileStream.read(reinterpret_cast<char*>(readData.data()), nBytes);
-        }
-
-        const int starsInNode = static_cast<int>(nDataSize / _valuesPerStar);
-        const auto posEnd = readData.begin() + (starsInNode * POS_SIZE);
-        const auto colEnd = posEnd + (starsInNode * COL_SIZE);
-        const auto velEnd = colEnd + (starsInNode * VEL_SIZE);
-        node.posData = std::vector<float>(readData.begin(), posEnd);
-        node.colData = std::vector<float>(posEnd, colEnd);
-        node.velData = std::vector<float>(colEnd, velEnd);
-
-        // Keep track of nodes that are loaded and update CPU RAM budget
-        node.isLoaded = true;
-        if (!_datasetFitInMemory) {
-            const std::lock_guard g(_leastRecentlyFetchedNodesMutex);
-            _leastRecentlyFetchedNodes.push(node.octreePositionIndex);
+            inFileStream.read(
+                reinterpret_cast<char*>(readData.data()),
+                nDataSize * sizeof(float)
+            );
         }
-        _cpuRamBudget -= nBytes;
+        data = readData;
     }
-    else {
-        LERROR("Error opening node data file: " + inFilePath);
+
+    const int starsInNode = static_cast<int>(data.size() / _valuesPerStar);
+    const auto posEnd = data.begin() + (starsInNode * POS_SIZE);
+    const auto colEnd = posEnd + (starsInNode * COL_SIZE);
+    const auto velEnd = colEnd + (starsInNode * VEL_SIZE);
+    node.posData = std::vector<float>(data.begin(), posEnd);
+    node.colData = std::vector<float>(posEnd, colEnd);
+    node.velData = std::vector<float>(colEnd, velEnd);
+
+    // Keep track of nodes that are loaded and update CPU RAM budget
+    const size_t nBytes = data.size() * sizeof(float);
+    node.isLoaded = true;
+    const std::lock_guard g(_loadedNodesMutex);
+    if (!_datasetFitInMemory) {
+        _loadedNodes.touch(node.octreePositionIndex, nBytes);
     }
+    _cpuRamBudget -= static_cast<long long>(nBytes);
 }
 
 void OctreeManager::removeNodesFromRam(
@@ -842,6 +1151,14 @@ void OctreeManager::removeNodesFromRam(
     // LINFO("Removed " + std::to_string(nodesToRemove.size()) + " nodes from RAM");
 
     for (unsigned long long nodePosIndex : nodesToRemove) {
+        {
+            // Skip nodes that have been used again since they were chosen for removal
+            const std::lock_guard g(_loadedNodesMutex);
+            if (_loadedNodes.contains(nodePosIndex)) {
+                continue;
+            }
+        }
+
         std::stack<int> indexStack;
         while (nodePosIndex != 8) {
             const int nodeIndex = nodePosIndex % 10;
@@ -866,13 +1183,17 @@ void OctreeManager::removeNodesFromRam(
 void OctreeManager::removeNode(OctreeNode& node) {
     // Lock node to make sure nobody else is trying to access it while removing
     const std::lock_guard lock(node.loadingLock);
+    if (!node.isLoaded) {
+        return;
+    }
 
-    const int nBytes = static_cast<int>(
-        node.numStars * _valuesPerStar * sizeof(node.posData[0])
-    );
+    const size_t nBytes = node.numStars * _valuesPerStar * sizeof(node.posData[0]);
     // Keep track of which nodes that are loaded and update CPU RAM budget
     node.isLoaded = false;
-    _cpuRamBudget += nBytes;
+    {
+        const std::lock_guard g(_loadedNodesMutex);
+        _cpuRamBudget += static_cast<long long>(nBytes);
+    }
 
     // Clear data
     node.posData.clear();
@@ -961,9 +1282,11 @@ bool OctreeManager::insertInNode(OctreeNode& node, const std::vector<float>& sta
         // Node is a leaf and it's not yet full -> insert star
         storeStarData(node, starValues);
 
-        if (depth > static_cast<int>(_totalDepth)) {
-            _totalDepth = depth;
-        }
+        // Other branches might be constructed concurrently, so only ever increase it
+        size_t totalDepth = _totalDepth;
+        while (static_cast<size_t>(depth) > totalDepth &&
+               !_totalDepth.compare_exchange_weak(totalDepth, depth))
+        {}
         return true;
     }
     else if (node.isLeaf) {
@@ -1097,16 +1420,12 @@ std::string OctreeManager::printStarsPerNode(const OctreeNode& node,
     }
 }
 
-std::map<int, std::vector<float>> OctreeManager::checkNodeIntersection(OctreeNode& node,
-                                                                    const glm::dmat4& mvp,
-                                                              const glm::vec2& screenSize,
-                                                                          int& deltaStars,
-                                                                    gaia::RenderMode mode)
+void OctreeManager::checkNodeIntersection(OctreeNode& node, const glm::dmat4& mvp,
+                                          const glm::vec2& screenSize,
+                                          gaia::RenderMode mode, TraversalResult& result)
 {
-    std::map<int, std::vector<float>> fetchedData;
-
     // Calculate the corners of the node
-    std::vector<glm::dvec4> corners(8);
+    std::array<glm::dvec4, 8> corners;
     for (int i = 0; i < 8; i++) {
         const float x = (i % 2 == 0) ?
             node.originX + node.halfDimension :
@@ -1125,8 +1444,8 @@ std::map<int, std::vector<float>> OctreeManager::checkNodeIntersection(OctreeNod
     if (!(_culler->isVisible(corners, mvp))) {
         // Check if this node or any of its children existed in cache previously.
         // If so, then remove them from cache and add those indices to stack
-        fetchedData = removeNodeFromCache(node, deltaStars);
-        return fetchedData;
+        removeNodeFromCache(node, result);
+        return;
     }
 
     // Remove node if it has been unloaded while still in view.
@@ -1134,13 +1453,14 @@ std::map<int, std::vector<float>> OctreeManager::checkNodeIntersection(OctreeNod
     if (node.bufferIndex != DEFAULT_INDEX && !node.isLoaded && _streamOctree &&
         !_datasetFitInMemory)
     {
-        fetchedData = removeNodeFromCache(node, deltaStars);
-        return fetchedData;
+        removeNodeFromCache(node, result);
+        return;
     }
 
     // Take care of inner nodes.
     if (!(node.isLeaf)) {
-        const glm::vec2 nodeSize = _culler->getNodeSizeInPixels(corners, mvp, screenSize);
+        // The culler still holds the bounds of this node from the visibility check
+        const glm::vec2 nodeSize = _culler->getNodeSizeInPixels(screenSize);
         const float totalPixels = nodeSize.x * nodeSize.y;
 
         // Check if we should return any LOD cache data. If we're streaming a big dataset
@@ -1155,26 +1475,24 @@ std::map<int, std::vector<float>> OctreeManager::checkNodeIntersection(OctreeNod
             if ((node.bufferIndex == DEFAULT_INDEX) || _rebuildBuffer) {
                 // Return empty if we couldn't claim a buffer stream index
                 if (!updateBufferIndex(node)) {
-                    return fetchedData;
+                    return;
                 }
 
                 // We're in an inner node, remove indices from potential children in cache
                 for (const std::shared_ptr<OctreeNode>& child : node.children) {
-                    std::map<int, std::vector<float>> tmpData = removeNodeFromCache(
-                        *child,
-                        deltaStars
-                    );
-                    fetchedData.insert(tmpData.begin(), tmpData.end());
+                    removeNodeFromCache(*child, result);
                 }
 
                 // Insert data and adjust stars added in this frame.
-                fetchedData[node.bufferIndex] = constructInsertData(
-                    node,
-                    mode,
-                    deltaStars
-                );
+                const size_t offset = result.values.size();
+                constructInsertData(node, mode, result.deltaStars, result.values);
+                result.updates.push_back({
+                    node.bufferIndex,
+                    offset,
+                    result.values.size() - offset
+                });
             }
-            return fetchedData;
+            return;
         }
     }
     // Return node data if node is a leaf
@@ -1183,45 +1501,34 @@ std::map<int, std::vector<float>> OctreeManager::checkNodeIntersection(OctreeNod
         if ((node.bufferIndex == DEFAULT_INDEX) || _rebuildBuffer) {
             // Return empty if we couldn't claim a buffer stream index
             if (!updateBufferIndex(node)) {
-                return fetchedData;
+                return;
             }
 
             // Insert data and adjust stars added in this frame.
-            fetchedData[node.bufferIndex] = constructInsertData(
-                node,
-                mode,
-                deltaStars
-            );
+            const size_t offset = result.values.size();
+            constructInsertData(node, mode, result.deltaStars, result.values);
+            result.updates.push_back({
+                node.bufferIndex,
+                offset,
+                result.values.size() - offset
+            });
         }
-        return fetchedData;
+        return;
     }
 
     // We're in a big, visible inner node -> remove it from cache if it existed.
     // But not its children -> set recursive check to false
-    fetchedData = removeNodeFromCache(node, deltaStars, false);
+    removeNodeFromCache(node, result, false);
 
     // Recursively check if children should be rendered.
     for (const std::shared_ptr<OctreeNode>& child : node.children) {
-        // Observe that if there exists identical keys in fetchedData then those values in
-        // tmpData will be ignored! Thus we store the removed keys until next render call
-        std::map<int, std::vector<float>> tmpData = checkNodeIntersection(
-            *child,
-            mvp,
-            screenSize,
-            deltaStars,
-            mode
-        );
-        fetchedData.insert(tmpData.begin(), tmpData.end());
+        checkNodeIntersection(*child, mvp, screenSize, mode, result);
     }
-    return fetchedData;
 }
 
-std::map<int, std::vector<float>> OctreeManager::removeNodeFromCache(OctreeNode& node,
-                                                                     int& deltaStars,
-                                                                     bool recursive)
+void OctreeManager::removeNodeFromCache(OctreeNode& node, TraversalResult& result,
+                                        bool recursive)
 {
-    std::map<int, std::vector<float>> keysToRemove;
-
     // If we're in rebuilding mode then there is no need to remove any nodes
 
     // Check if this node was rendered == had a specified index
@@ -1231,24 +1538,19 @@ std::map<int, std::vector<float>> OctreeManager::removeNodeFromCache(OctreeNode&
         _removedKeysInPrevCall.insert(node.bufferIndex);
 
         // Insert dummy node at offset index that should be removed from render
-        keysToRemove[node.bufferIndex] = std::vector<float>();
+        result.updates.push_back({ node.bufferIndex, result.values.size(), 0 });
 
         // Reset index and adjust stars removed this frame
         node.bufferIndex = DEFAULT_INDEX;
-        deltaStars -= static_cast<int>(node.numStars);
+        result.deltaStars -= static_cast<int>(node.numStars);
     }
 
     // Check children recursively if we're in an inner node
     if (!(node.isLeaf) && recursive) {
         for (const std::shared_ptr<OctreeNode>& child : node.children) {
-            std::map<int, std::vector<float>> tmpData = removeNodeFromCache(
-                *child,
-                deltaStars
-            );
-            keysToRemove.insert(tmpData.begin(), tmpData.end());
+            removeNodeFromCache(*child, result);
         }
     }
-    return keysToRemove;
 }
 
 std::vector<float> OctreeManager::getNodeData(const OctreeNode& node,
@@ -1257,7 +1559,9 @@ std::vector<float> OctreeManager::getNodeData(const OctreeNode& node,
     // Return node data if node is a leaf
     if (node.isLeaf) {
         int dStars = 0;
-        return constructInsertData(node, mode, dStars);
+        std::vector<float> insertData;
+        constructInsertData(node, mode, dStars, insertData);
+        return insertData;
     }
 
     // If we're not in a leaf, get data from all children recursively
@@ -1355,31 +1659,32 @@ bool OctreeManager::updateBufferIndex(OctreeNode& node) {
     return true;
 }
 
-std::vector<float> OctreeManager::constructInsertData(const OctreeNode& node,
-                                                      gaia::RenderMode mode,
-                                                      int& deltaStars) const
+void OctreeManager::constructInsertData(const OctreeNode& node, gaia::RenderMode mode,
+                                        int& deltaStars,
+                                        std::vector<float>& insertData) const
 {
     // Return early if node doesn't contain any stars
     if (node.numStars == 0) {
-        return std::vector<float>();
+        return;
     }
 
     // Fill chunk by appending zeroes to data so we overwrite possible earlier values
     // And more importantly so our attribute pointers knows where to read
-    auto insertData = std::vector<float>(node.posData.begin(), node.posData.end());
+    const size_t start = insertData.size();
+    insertData.insert(insertData.end(), node.posData.begin(), node.posData.end());
     if (_useVBO) {
-        insertData.resize(POS_SIZE * MAX_STARS_PER_NODE, 0.f);
+        insertData.resize(start + POS_SIZE * MAX_STARS_PER_NODE, 0.f);
     }
     if (mode != gaia::RenderMode::Static) {
         insertData.insert(insertData.end(), node.colData.begin(), node.colData.end());
         if (_useVBO) {
-            insertData.resize((POS_SIZE + COL_SIZE) * MAX_STARS_PER_NODE, 0.f);
+            insertData.resize(start + (POS_SIZE + COL_SIZE) * MAX_STARS_PER_NODE, 0.f);
         }
         if (mode == gaia::RenderMode::Motion) {
             insertData.insert(insertData.end(), node.velData.begin(), node.velData.end());
             if (_useVBO) {
                 insertData.resize(
-                    (POS_SIZE + COL_SIZE + VEL_SIZE) * MAX_STARS_PER_NODE, 0.f
+                    start + (POS_SIZE + COL_SIZE + VEL_SIZE) * MAX_STARS_PER_NODE, 0.f
                 );
             }
         }
@@ -1387,7 +1692,6 @@ std::vector<float> OctreeManager::constructInsertData(const OctreeNode& node,
 
     // Update deltaStars
     deltaStars += static_cast<int>(node.numStars);
-    return insertData;
 }
 
 }  // namespace openspace
@@ -26,17 +26,24 @@
 #define __OPENSPACE_MODULE_GAIA___OCTREEMANAGER___H__
 
 #include <modules/gaia/rendering/gaiaoptions.h>
+#include <modules/gaia/rendering/nodelru.h>
+#include <openspace/util/taskscheduler.h>
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <array>
-#include <map>
+#include <atomic>
+#include <filesystem>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
+#include <set>
+#include <span>
 #include <stack>
 #include <vector>
 
 namespace openspace {
 
+class NodeStore;
 class OctreeCuller;
 
 class OctreeManager {
@@ -60,8 +67,57 @@ public:
         unsigned long long octreePositionIndex;
     };
 
-    OctreeManager() = default;
-    ~OctreeManager() = default;
+    /**
+     * The buffer updates that are produced by one traversal of the Octree. The values of
+     * all updates are stored back to back in one arena that keeps its memory between
+     * traversals, so that no allocations are needed once the traversal has warmed up.
+     */
+    struct TraversalResult {
+        struct Update {
+            // The index of the chunk in the streaming buffer that is updated
+            int bufferIndex;
+            // The range of the values in the arena. An empty range clears the chunk
+            size_t offset;
+            size_t size;
+        };
+
+        /**
+         * \return the values of the \p update
+         */
+        std::span<const float> data(const Update& update) const;
+
+        /**
+         * Removes all updates but keeps the allocated memory.
+         */
+        void clear();
+
+        /**
+         * Sorts the updates by their buffer index and removes duplicate updates of the
+         * same chunk. If a chunk is both cleared and filled, the data is kept.
+         */
+        void finalize();
+
+        /**
+         * Adds the updates of \p previous, the finalized result of an earlier traversal
+         * that was never uploaded, for all chunks that this result does not update
+         * itself. This result has to be finalized and stays finalized.
+         */
+        void mergePrevious(const TraversalResult& previous);
+
+        // Sorted by buffer index with at most one update per chunk
+        std::vector<Update> updates;
+        std::vector<float> values;
+
+        // The number of stars that were added or removed by this traversal
+        int deltaStars = 0;
+
+        // The state of the buffer index stack after the traversal
+        size_t biggestChunkIndexInUse = 0;
+        size_t numFreeSpotsInBuffer = 0;
+    };
+
+    OctreeManager();
+    ~OctreeManager();
 
     /**
      * Initializes a one layer Octree with root and 8 children that covers all stars.
@@ -79,14 +135,21 @@ public:
 
     /**
      * Inserts star values in correct position in Octree. Makes use of a recursive
-     * traversal strategy. Internally calls #insertInNode.
+     * traversal strategy. Internally calls #insertInNode. Stars that belong to different
+     * branches (see #branchIndex) can be inserted concurrently from different threads.
      */
     void insert(const std::vector<float>& starValues);
 
+    /**
+     * \return the index of the top-level branch into which #insert places a star at the
+     *         position (\p x, \p y, \p z)
+     */
+    static size_t branchIndex(float x, float y, float z);
+
     /**
      * Slices LOD data so only the MAX_STARS_PER_NODE brightest stars are stored in inner
      * nodes. If \p branchIndex is defined then only that branch will be sliced. Calls
-     * #sliceNodeLodCache internally.
+     * #sliceNodeLodCache internally. Different branches can be sliced concurrently.
      */
     void sliceLodData(size_t branchIndex = 8);
 
@@ -100,23 +163,44 @@ public:
     /**
      * Used while streaming nodes from files. Checks if any nodes need to be loaded or
      * unloaded. If entire dataset fits in RAM then the whole dataset will be loaded
-     * asynchronously. Otherwise only nodes close to the camera will be fetched. When RAM
-     * stars to fill up least-recently used nodes will start to unload. Calls
-     * #findAndFetchNeighborNode and #removeNodesFromRam internally.
+     * asynchronously. Otherwise only nodes close to the camera will be fetched, as well
+     * as the nodes around the position where the camera is predicted to be in the near
+     * future based on its current velocity. When RAM starts to fill up the least
+     * recently used nodes will be unloaded. Calls #findAndFetchNeighborNode,
+     * #prefetchPredictedNodes, and #removeNodesFromRam internally.
      */
-    void fetchSurroundingNodes(const glm::dvec3& cameraPos, size_t chunkSizeInBytes,
+    void fetchSurroundingNodes(const glm::dvec3& cameraPos,
         const glm::ivec2& additionalNodes);
 
     /**
      * Builds render data structure by traversing the Octree and checking for intersection
-     * with view frustum. Every vector in map contains data for one node. The
-     * corresponding integer key is the index where chunk should be inserted into
-     * streaming buffer. Calls #checkNodeIntersection for every branch. \p deltaStars
-     * keeps track of how many stars that were added/removed this render call.
+     * with view frustum. Every update in the result contains data for one node and the
+     * index where that chunk should be inserted into the streaming buffer. Calls
+     * #checkNodeIntersection for every branch. The returned result stays valid until
+     * the next traversal after this one has been started. If a traversal that was
+     * started by #beginTraversal has not been finished, its updates are included in the
+     * returned result, so that switching between the two modes does not lose any.
+     */
+    const TraversalResult& traverseData(const glm::dmat4& mvp,
+        const glm::vec2& screenSize, gaia::RenderMode mode, float lodPixelThreshold);
+
+    /**
+     * Starts the same traversal as #traverseData on a worker thread. The result is
+     * retrieved with #finishTraversal, which makes it possible to traverse the Octree
+     * for the next frame while the current one is rendered. Until then, no other
+     * function of this OctreeManager may be called, with the exception of the getters.
+     */
+    void beginTraversal(const glm::dmat4& mvp, const glm::vec2& screenSize,
+        gaia::RenderMode mode, float lodPixelThreshold);
+
+    /**
+     * Waits for the traversal that was started by #beginTraversal to finish.
+     *
+     * \return the result of that traversal, or an empty result if no traversal was
+     *         started. It stays valid until the next traversal after this one has been
+     *         started
      */
-    std::map<int, std::vector<float>> traverseData(const glm::dmat4& mvp,
-        const glm::vec2& screenSize, int& deltaStars, gaia::RenderMode mode,
-        float lodPixelThreshold);
+    const TraversalResult& finishTraversal();
 
     /**
      * Builds full render data structure by traversing all leaves in the Octree.
@@ -235,6 +319,23 @@ private:
     std::string printStarsPerNode(const OctreeNode& node,
         const std::string& prefix) const;
 
+    /**
+     * Implementation of #initBufferIndexStack that can be called during a traversal.
+     */
+    void resetBufferIndexStack(long long maxNodes, bool useVBO, bool datasetFitInMemory);
+
+    /**
+     * Traverses the Octree into \p result. Implementation of #traverseData and
+     * #beginTraversal.
+     */
+    void traverseOctree(const glm::dmat4& mvp, const glm::vec2& screenSize,
+        gaia::RenderMode mode, float lodPixelThreshold, TraversalResult& result);
+
+    /**
+     * Waits for a traversal that was started with #beginTraversal, if there is one.
+     */
+    void waitForTraversal();
+
     /**
      * Private help function for `traverseData()`. Recursively checks which
      * nodes intersect with the view frustum (interpreted as an AABB) and decides if data
@@ -244,13 +345,12 @@ private:
      * \param node the node that should be checked
      * \param mvp the model-view-projection matrix used to check intersection
      * \param screenSize the size of the screen in pixels
-     * \param deltaStars keeps track of how many stars that were added/removed this render
-     *        call
      * \param mode the render mode that should be used
+     * \param result the buffer updates and the number of stars that were added/removed
+     *        this render call are added to this result
      */
-    std::map<int, std::vector<float>> checkNodeIntersection(OctreeNode& node,
-        const glm::dmat4& mvp, const glm::vec2& screenSize, int& deltaStars,
-        gaia::RenderMode mode);
+    void checkNodeIntersection(OctreeNode& node, const glm::dmat4& mvp,
+        const glm::vec2& screenSize, gaia::RenderMode mode, TraversalResult& result);
 
     /**
      * Checks if specified node existed in cache, and removes it if that's the case.
@@ -258,11 +358,11 @@ private:
      * long as \p recursive is not set to false.
      *
      * \param node the node that should be removed
-     * \param deltaStars keeps track of how many stars that were removed.
+     * \param result the removed chunks and stars are added to this result
      * \param recursive defines if decentents should be removed as well
      */
-    std::map<int, std::vector<float>> removeNodeFromCache(OctreeNode& node,
-        int& deltaStars, bool recursive = true);
+    void removeNodeFromCache(OctreeNode& node, TraversalResult& result,
+        bool recursive = true);
 
     /**
      * Get data in node and its descendants regardless if they are visible or not.
@@ -293,10 +393,10 @@ private:
      * \param node the node that should be inserted
      * \param mode the render mode that should be used
      * \param deltaStars keeps track of how many stars that were added.
-     * \return the data to be inserted
+     * \param insertData the data to be inserted is appended to this vector
      */
-    std::vector<float> constructInsertData(const OctreeNode& node,
-        gaia::RenderMode mode, int& deltaStars) const;
+    void constructInsertData(const OctreeNode& node, gaia::RenderMode mode,
+        int& deltaStars, std::vector<float>& insertData) const;
 
     /**
      * Write a node to outFileStream.
@@ -330,6 +430,24 @@ private:
     void writeNodeToMultipleFiles(const std::string& outFilePrefix, OctreeNode& node,
         bool threadWrites);
 
+    /**
+     * \return The leaf node that contains the position \p pos, which is in kiloparsec
+     */
+    std::shared_ptr<OctreeNode> findLeafNode(const glm::vec3& pos) const;
+
+    /**
+     * Finds the neighboring node on the same level (or a higher level if there is no
+     * corresponding level) in the specified direction.
+     *
+     * \param firstParentId the id of the first parent node that should be checked
+     * \param x the x coordinate of the node that should be found
+     * \param y the y coordinate of the node that should be found
+     * \param z the z coordinate of the node that should be found
+     * \return the found node or `nullptr` if there is no neighbor in that direction
+     */
+    std::shared_ptr<OctreeNode> findNeighborNode(unsigned long long firstParentId, int x,
+        int y, int z);
+
     /**
      * Finds the neighboring node on the same level (or a higher level if there is no
      * corresponding level) in the specified direction. Also fetches data from found node
@@ -341,10 +459,32 @@ private:
      * \param z the z coordinate of the node that should be found
      * \param additionalLevelsToFetch determines if any descendants of the found node
      *        should be fetched as well (if they exists).
+     * \param priority the priority with which the data is fetched in the background
      */
     void findAndFetchNeighborNode(unsigned long long firstParentId, int x, int y, int z,
+        int additionalLevelsToFetch,
+        TaskScheduler::Priority priority = TaskScheduler::Priority::Normal);
+
+    /**
+     * Fetches the nodes around \p predictedPos with a low priority, so that they are
+     * already loaded when the camera gets there. Nothing is done if the position lies
+     * in the same parent node as the camera or the previous prediction.
+     *
+     * \param predictedPos the predicted future position of the camera in kiloparsec
+     * \param additionalLevelsToFetch determines how many levels of descendants of the
+     *        found nodes are fetched as well
+     */
+    void prefetchPredictedNodes(const glm::vec3& predictedPos,
         int additionalLevelsToFetch);
 
+    /**
+     * Opens the node store for the streamed Octree in \p folderPath. If the folder does
+     * not contain a node store, one is created from the individual node files in the
+     * cache. If no node store can be opened, the nodes are read from the individual
+     * node files instead.
+     */
+    void openNodeStore(const std::filesystem::path& folderPath);
+
     /**
      * Fetches data from all children of the \p parentNode, as long as it's not already
      * fetched, it exists and it can fit in RAM.
@@ -392,27 +532,46 @@ private:
     std::unique_ptr<OctreeCuller> _culler;
     std::stack<int> _freeSpotsInBuffer;
     std::set<int> _removedKeysInPrevCall;
-    std::queue<unsigned long long> _leastRecentlyFetchedNodes;
-    std::mutex _leastRecentlyFetchedNodesMutex;
 
-    size_t _totalDepth = 0;
-    size_t _numLeafNodes = 0;
-    size_t _numInnerNodes = 0;
+    // Nodes that are loaded while streaming, ordered by when they were last used. The
+    // mutex also guards the _cpuRamBudget while streaming
+    NodeLru _loadedNodes;
+    std::mutex _loadedNodesMutex;
+    std::unique_ptr<NodeStore> _nodeStore;
+
+    // These are atomic as the branches of the Octree can be constructed concurrently
+    std::atomic<size_t> _totalDepth = 0;
+    std::atomic<size_t> _numLeafNodes = 0;
+    std::atomic<size_t> _numInnerNodes = 0;
     size_t _biggestChunkIndexInUse = 0;
     size_t _valuesPerStar = 0;
     float _minTotalPixelsLod = 0.f;
 
     size_t _maxStackSize = 0;
-    bool _rebuildBuffer = false;
+    // Atomic as it is queried while the Octree is traversed on a worker thread
+    std::atomic_bool _rebuildBuffer = false;
     bool _useVBO = false;
     bool _streamOctree = false;
     bool _datasetFitInMemory = false;
     long long _cpuRamBudget = 0;
     long long _maxCpuRamBudget = 0;
     unsigned long long _parentNodeOfCamera = 8;
+    unsigned long long _predictedParentNode = 8;
+    std::optional<glm::dvec3> _previousCameraPos;
     std::string _streamFolderPath;
     size_t _traversedBranchesInRenderCall = 0;
 
+    // The arenas of the two most recent traversals. One is being written by the current
+    // traversal while the other one is uploaded by the renderer
+    std::array<TraversalResult, 2> _traversalResults;
+    size_t _currentTraversalResult = 0;
+    TaskFuture<void> _pendingTraversal;
+    std::unique_ptr<TaskScheduler> _traversalScheduler;
+
+    // Loads and unloads nodes in the background while streaming. This has to be the last
+    // member so that its workers are stopped before the nodes they access are destroyed
+    std::unique_ptr<TaskScheduler> _streamingScheduler;
+
 }; // class OctreeManager
 
 }  // namespace openspace
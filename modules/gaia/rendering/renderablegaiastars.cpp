@@ -343,6 +343,15 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo AsyncTraversalInfo = {
+        "AsyncTraversal",
+        "Asynchronous Traversal",
+        "If set to true, the Octree is traversed on a worker thread while the previous "
+        "frame is rendered. This takes the culling and level-of-detail selection off the "
+        "render thread, at the cost of the stars lagging one frame behind the camera",
+        openspace::properties::Property::Visibility::Developer
+    };
+
     struct [[codegen::Dictionary(RenderableGaiaStars)]] Parameters {
         // [[codegen::verbatim(FilePathInfo.description)]]
         std::string file;
@@ -449,6 +458,9 @@ namespace {
 
         // [codegen::verbatim(ReportGlErrorsInfo.description)]]
         std::optional<bool> reportGlErrors;
+
+        // [codegen::verbatim(AsyncTraversalInfo.description)]]
+        std::optional<bool> asyncTraversal;
     };
 #include "renderablegaiastars_codegen.cpp"
 }  // namespace
@@ -496,6 +508,7 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
     , _maxGpuMemoryPercent(MaxGpuMemoryPercentInfo, 0.45f, 0.f, 1.f)
     , _maxCpuMemoryPercent(MaxCpuMemoryPercentInfo, 0.5f, 0.f, 1.f)
     , _reportGlErrors(ReportGlErrorsInfo, false)
+    , _asyncTraversal(AsyncTraversalInfo, false)
     , _accumulatedIndices(1, 0)
 {
     using File = ghoul::filesystem::File;
@@ -675,6 +688,9 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
     _reportGlErrors = p.reportGlErrors.value_or(_reportGlErrors);
     addProperty(_reportGlErrors);
 
+    _asyncTraversal = p.asyncTraversal.value_or(_asyncTraversal);
+    addProperty(_asyncTraversal);
+
     // Add a read-only property for the number of rendered stars per frame.
     _nRenderedStars.setReadOnly(true);
     addProperty(_nRenderedStars);
@@ -982,36 +998,54 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
         _firstDrawCalls = false;
     }
 
+    // When the Octree is traversed asynchronously, the traversal for this frame runs on a
+    // worker thread while the result of the previous frame is uploaded. It has to be
+    // finished before nodes are fetched as both modify the Octree. The result stays valid
+    // until the traversal after the next one is started
+    const int renderOption = _renderMode;
+    const bool asyncTraversal = _asyncTraversal;
+    const OctreeManager::TraversalResult* updateData = nullptr;
+    if (asyncTraversal) {
+        updateData = &_octreeManager.finishTraversal();
+    }
+
     // Update which nodes that are stored in memory as the camera moves around
     // (if streaming)
     if (_fileReaderOption == gaia::FileReaderOption::StreamOctree) {
         const glm::dvec3 cameraPos = data.camera.positionVec3();
-        const size_t chunkSizeBytes = _chunkSize * sizeof(GLfloat);
-        _octreeManager.fetchSurroundingNodes(cameraPos, chunkSizeBytes, _additionalNodes);
+        _octreeManager.fetchSurroundingNodes(cameraPos, _additionalNodes);
 
         // Update CPU Budget property.
         _cpuRamBudgetProperty = static_cast<float>(_octreeManager.cpuRamBudget());
     }
 
-    // Traverse Octree and build a map with new nodes to render, uses mvp matrix to decide
-    const int renderOption = _renderMode;
-    int deltaStars = 0;
-    const std::map<int, std::vector<float>> updateData = _octreeManager.traverseData(
-        modelViewProjMat,
-        screenSize,
-        deltaStars,
-        gaia::RenderMode(renderOption),
-        _lodPixelThreshold
-    );
+    // Traverse Octree and build a list with new nodes to render, uses mvp matrix to
+    // decide
+    if (asyncTraversal) {
+        _octreeManager.beginTraversal(
+            modelViewProjMat,
+            screenSize,
+            gaia::RenderMode(renderOption),
+            _lodPixelThreshold
+        );
+    }
+    else {
+        updateData = &_octreeManager.traverseData(
+            modelViewProjMat,
+            screenSize,
+            gaia::RenderMode(renderOption),
+            _lodPixelThreshold
+        );
+    }
 
     // Update number of rendered stars.
-    _nStarsToRender += deltaStars;
+    _nStarsToRender += updateData->deltaStars;
     _nRenderedStars = _nStarsToRender;
 
     // Update GPU Stream Budget property.
-    _gpuStreamBudgetProperty = static_cast<float>(_octreeManager.numFreeSpotsInBuffer());
+    _gpuStreamBudgetProperty = static_cast<float>(updateData->numFreeSpotsInBuffer);
 
-    const int nChunksToRender = static_cast<int>(_octreeManager.biggestChunkIndexInUse());
+    const int nChunksToRender = static_cast<int>(updateData->biggestChunkIndexInUse);
     const int maxStarsPerNode = static_cast<int>(_octreeManager.maxStarsPerNode());
     const int valuesPerStar = static_cast<int>(_nRenderValuesPerStar);
 
@@ -1029,8 +1063,10 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
         _accumulatedIndices.resize(nChunksToRender + 1, lastValue);
 
         // Update vector with accumulated indices.
-        for (const auto& [offset, subData] : updateData) {
-            if (offset >= _accumulatedIndices.size() - 1) {
+        for (const auto& update : updateData->updates) {
+            const int offset = update.bufferIndex;
+            const std::span<const float> subData = updateData->data(update);
+            if (offset >= static_cast<int>(_accumulatedIndices.size()) - 1) {
                 // @TODO(2023-03-08, alebo) We want to redo the whole rendering pipeline
                 // anyway, so right now we just bail out early if we get an invalid index
                 // that would trigger a crash
@@ -1075,8 +1111,10 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
         );
 
         // Update SSBO with one insert per chunk/node.
-        // The key in map holds the offset index.
-        for (const auto& [offset, subData] : updateData) {
+        // The buffer index of the update holds the offset index.
+        for (const auto& update : updateData->updates) {
+            const int offset = update.bufferIndex;
+            const std::span<const float> subData = updateData->data(update);
             // We don't need to fill chunk with zeros for SSBOs!
             // Just check if we have any values to update.
             if (!subData.empty()) {
@@ -1115,19 +1153,25 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
             GL_STREAM_DRAW
         );
 
+        // The data of added nodes is already padded to full chunks by the Octree, so
+        // only the chunks of removed nodes have to be filled with zeroes
+        const std::vector<float> emptyChunk(_chunkSize, 0.f);
+
         // Update buffer with one insert per chunk/node.
-        //The key in map holds the offset index.
-        for (const auto& [offset, subData] : updateData) {
-            // Fill chunk by appending zeroes so we overwrite possible earlier values.
+        // The buffer index of the update holds the offset index.
+        for (const auto& update : updateData->updates) {
+            const int offset = update.bufferIndex;
+            const std::span<const float> subData = updateData->data(update);
+            // Overwrite the chunk with zeroes so we overwrite possible earlier values.
             // Only required when removing nodes because chunks are filled up in octree
             // fetch on add.
-            std::vector<float> vectorData(subData.begin(), subData.end());
-            vectorData.resize(posChunkSize, 0.f);
+            const float* values =
+                subData.size() >= posChunkSize ? subData.data() : emptyChunk.data();
             glBufferSubData(
                 GL_ARRAY_BUFFER,
                 offset * posChunkSize * sizeof(GLfloat),
                 posChunkSize * sizeof(GLfloat),
-                vectorData.data()
+                values
             );
         }
 
@@ -1150,16 +1194,19 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
             );
 
             // Update buffer with one insert per chunk/node.
-            //The key in map holds the offset index.
-            for (const auto& [offset, subData] : updateData) {
-                // Fill chunk by appending zeroes so we overwrite possible earlier values.
-                std::vector<float> vectorData(subData.begin(), subData.end());
-                vectorData.resize(posChunkSize + colChunkSize, 0.f);
+            // The buffer index of the update holds the offset index.
+            for (const auto& update : updateData->updates) {
+                const int offset = update.bufferIndex;
+                const std::span<const float> subData = updateData->data(update);
+                // Overwrite with zeroes so we overwrite possible earlier values.
+                const float* values = subData.size() >= posChunkSize + colChunkSize ?
+                    subData.data() + posChunkSize :
+                    emptyChunk.data();
                 glBufferSubData(
                     GL_ARRAY_BUFFER,
                     offset * colChunkSize * sizeof(GLfloat),
                     colChunkSize * sizeof(GLfloat),
-                    vectorData.data() + posChunkSize
+                    values
                 );
             }
 
@@ -1182,16 +1229,19 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
                 );
 
                 // Update buffer with one insert per chunk/node.
-                //The key in map holds the offset index.
-                for (const auto& [offset, subData] : updateData) {
-                    // Fill chunk by appending zeroes.
-                    std::vector<float> vectorData(subData.begin(), subData.end());
-                    vectorData.resize(_chunkSize, 0.f);
+                // The buffer index of the update holds the offset index.
+                for (const auto& update : updateData->updates) {
+                    const int offset = update.bufferIndex;
+                    const std::span<const float> subData = updateData->data(update);
+                    // Overwrite with zeroes.
+                    const float* values = subData.size() >= _chunkSize ?
+                        subData.data() + posChunkSize + colChunkSize :
+                        emptyChunk.data();
                     glBufferSubData(
                         GL_ARRAY_BUFFER,
                         offset * velChunkSize * sizeof(GLfloat),
                         velChunkSize * sizeof(GLfloat),
-                        vectorData.data() + posChunkSize + colChunkSize
+                        values
                     );
                 }
             }
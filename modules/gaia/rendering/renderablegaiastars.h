@@ -165,6 +165,7 @@ private:
     properties::FloatProperty _maxCpuMemoryPercent;
 
     properties::BoolProperty _reportGlErrors;
+    properties::BoolProperty _asyncTraversal;
 
     std::unique_ptr<ghoul::opengl::ProgramObject> _program;
     UniformCache(model, view, cameraPos, cameraLookUp, viewScaling, projection,
@@ -24,14 +24,20 @@
 
 #include <modules/gaia/tasks/constructoctreetask.h>
 
+#include <modules/gaia/rendering/nodestore.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/util/taskscheduler.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/exception.h>
+#include <array>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <thread>
 
 namespace {
@@ -59,6 +65,17 @@ namespace {
         // folder and output multiple files for the Octree
         std::optional<bool> singleFileInput;
 
+        // If true then the Octree is constructed on multiple threads. The stars are
+        // binned by the top-level branch of the Octree they belong to and all branches
+        // are then constructed and sliced concurrently. For a single input file, the
+        // resulting Octree is the same as the one constructed on a single thread. When
+        // reading from a folder, each branch is written to its files as soon as all
+        // input files that can contain stars for it have been read. Input files named
+        // after a branch (octant_<i>) are expected to only contain stars of that branch
+        // and any star that belongs to a different branch is dropped with a warning, as
+        // that branch might already have been written
+        std::optional<bool> parallel;
+
         // If defined then only stars with Position X values between [min, max] will be
         // inserted into Octree (if min is set to 0.0 it is read as -Inf, if max is set to
         // 0.0 it is read as +Inf). If min = max then all values equal min|max will be
@@ -204,6 +221,33 @@ namespace {
         std::optional<glm::vec2> filterRvError;
     };
 #include "constructoctreetask_codegen.cpp"
+
+    std::vector<std::filesystem::path> inputFiles(const std::filesystem::path& folder) {
+        std::vector<std::filesystem::path> res;
+        if (std::filesystem::is_directory(folder)) {
+            namespace fs = std::filesystem;
+            for (const fs::directory_entry& e : fs::directory_iterator(folder)) {
+                if (e.is_regular_file()) {
+                    res.push_back(e.path());
+                }
+            }
+        }
+        return res;
+    }
+
+    // Returns the branch whose stars are stored in the file, based on the name that the
+    // ReadFitsTask gives to its output files, or -1 if the file can contain any stars
+    int branchOfFile(const std::filesystem::path& file) {
+        const std::string stem = file.stem().string();
+        constexpr std::string_view Prefix = "octant_";
+        if (stem.size() == Prefix.size() + 1 && stem.starts_with(Prefix)) {
+            const char c = stem.back();
+            if (c >= '0' && c <= '7') {
+                return c - '0';
+            }
+        }
+        return -1;
+    }
 } // namespace
 
 namespace openspace {
@@ -216,6 +260,7 @@ ConstructOctreeTask::ConstructOctreeTask(const ghoul::Dictionary& dictionary) {
     _maxDist = p.maxDist.value_or(_maxDist);
     _maxStarsPerNode = p.maxStarsPerNode.value_or(_maxStarsPerNode);
     _singleFileInput = p.singleFileInput.value_or(_singleFileInput);
+    _parallel = p.parallel.value_or(_parallel);
 
     _octreeManager = std::make_shared<OctreeManager>();
     _indexOctreeManager = std::make_shared<OctreeManager>();
@@ -307,6 +352,9 @@ void ConstructOctreeTask::perform(const Task::ProgressCallback& onProgress) {
     if (_singleFileInput) {
         constructOctreeFromSingleFile(onProgress);
     }
+    else if (_parallel) {
+        constructOctreeFromFolderInParallel(onProgress);
+    }
     else {
         constructOctreeFromFolder(onProgress);
     }
@@ -386,21 +434,26 @@ void ConstructOctreeTask::constructOctreeFromSingleFile(
         progressCallback(0.3f);
         LINFO("Constructing Octree");
 
-        // Insert star into octree. We assume the data already is in correct order.
-        for (size_t i = 0; i < fullData.size(); i += nValuesPerStar) {
-            auto first = fullData.begin() + i;
-            auto last = fullData.begin() + i + nValuesPerStar;
-            const std::vector<float> filterValues(first, last);
-            const std::vector<float> renderValues(first, first + RENDER_VALUES);
-
-            // Filter data by parameters.
-            if (checkAllFilters(filterValues)) {
-                nFilteredStars++;
-                continue;
-            }
+        if (_parallel) {
+            nFilteredStars = insertInParallel(fullData, nValuesPerStar);
+        }
+        else {
+            // Insert star into octree. We assume the data already is in correct order.
+            for (size_t i = 0; i < fullData.size(); i += nValuesPerStar) {
+                auto first = fullData.begin() + i;
+                auto last = fullData.begin() + i + nValuesPerStar;
+                const std::vector<float> filterValues(first, last);
+                const std::vector<float> renderValues(first, first + RENDER_VALUES);
 
-            // If all filters passed then insert render values into Octree.
-            _octreeManager->insert(renderValues);
+                // Filter data by parameters.
+                if (checkAllFilters(filterValues)) {
+                    nFilteredStars++;
+                    continue;
+                }
+
+                // If all filters passed then insert render values into Octree.
+                _octreeManager->insert(renderValues);
+            }
         }
         inFileStream.close();
     }
@@ -411,8 +464,11 @@ void ConstructOctreeTask::constructOctreeFromSingleFile(
     }
     LINFO(std::format("{} of {} read stars were filtered", nFilteredStars, nTotalStars));
 
-    // Slice LOD data before writing to files.
-    _octreeManager->sliceLodData();
+    // Slice LOD data before writing to files. The parallel construction has already
+    // sliced each branch once it was done
+    if (!_parallel) {
+        _octreeManager->sliceLodData();
+    }
 
     LINFO(std::format("Writing octree to '{}'", _outFileOrFolderPath));
     std::ofstream outFileStream(_outFileOrFolderPath, std::ofstream::binary);
@@ -453,15 +509,8 @@ void ConstructOctreeTask::constructOctreeFromFolder(
     //int starsOutside2000 = 0;
     //int starsOutside5000 = 0;
 
-    std::vector<std::filesystem::path> allInputFiles;
-    if (std::filesystem::is_directory(_inFileOrFolderPath)) {
-        namespace fs = std::filesystem;
-        for (const fs::directory_entry& e : fs::directory_iterator(_inFileOrFolderPath)) {
-            if (!e.is_regular_file()) {
-                allInputFiles.push_back(e.path());
-            }
-        }
-    }
+    const std::vector<std::filesystem::path> allInputFiles =
+        inputFiles(_inFileOrFolderPath);
 
     std::vector<float> filterValues;
     auto writeThreads = std::vector<std::thread>(8);
@@ -590,6 +639,204 @@ void ConstructOctreeTask::constructOctreeFromFolder(
     //    " - 2000kPc is " + std::to_string(starsOutside2000) + "\n" +
     //    " - 5000kPc is " + std::to_string(starsOutside5000));
 
+    // Make sure all threads are done.
+    for (int i = 0; i < 8; i++) {
+        writeThreads[i].join();
+    }
+
+    writeIndexFiles();
+}
+
+void ConstructOctreeTask::constructOctreeFromFolderInParallel(
+                                           const Task::ProgressCallback& progressCallback)
+{
+    const std::vector<std::filesystem::path> allInputFiles =
+        inputFiles(_inFileOrFolderPath);
+
+    _indexOctreeManager->initOctree(0, _maxDist, _maxStarsPerNode);
+
+    LINFO(std::format(
+        "MAX DIST: {} - MAX STARS PER NODE: {}",
+        _indexOctreeManager->maxDist(), _indexOctreeManager->maxStarsPerNode()
+    ));
+
+    // The files written by ReadFitsTask only contain the stars of a single branch. We
+    // know that a branch is done once all files that can contain stars of it are read
+    std::vector<int> fileBranches;
+    std::array<std::atomic_int, 8> nRemainingFiles;
+    for (std::atomic_int& n : nRemainingFiles) {
+        n = 0;
+    }
+    for (const std::filesystem::path& file : allInputFiles) {
+        const int branch = branchOfFile(file);
+        fileBranches.push_back(branch);
+        for (int i = 0; i < 8; i++) {
+            if (branch == -1 || branch == i) {
+                nRemainingFiles[i]++;
+            }
+        }
+    }
+
+    // Only files that are not named after a branch can insert stars into any branch,
+    // so the mutex of a branch is uncontended when reading the files of ReadFitsTask
+    std::array<std::mutex, 8> branchMutexes;
+    std::atomic<size_t> nStars = 0;
+    std::atomic<size_t> nFilteredStars = 0;
+    std::atomic<size_t> nMisplacedStars = 0;
+
+    auto finishBranch = [this](size_t branch) {
+        // Slice LOD data and write the branch to its files. The data is cleared after it
+        // has been written
+        _indexOctreeManager->sliceLodData(branch);
+        _indexOctreeManager->writeToMultipleFiles(_outFileOrFolderPath.string(), branch);
+    };
+
+    auto readFile = [&](size_t fileIndex) {
+        const std::filesystem::path& inFilePath = allInputFiles[fileIndex];
+        const int fileBranch = fileBranches[fileIndex];
+
+        LINFO(std::format("Reading data file '{}'", inFilePath));
+
+        std::ifstream inFileStream(inFilePath, std::ifstream::binary);
+        if (inFileStream.good()) {
+            int32_t nValuesPerStar = 0;
+            inFileStream.read(reinterpret_cast<char*>(&nValuesPerStar), sizeof(int32_t));
+            std::vector<float> filterValues(nValuesPerStar, 0.f);
+
+            while (inFileStream.read(
+                reinterpret_cast<char*>(filterValues.data()),
+                nValuesPerStar * sizeof(filterValues[0])
+            ))
+            {
+                // Filter data by parameters.
+                if (checkAllFilters(filterValues)) {
+                    nFilteredStars++;
+                    continue;
+                }
+
+                const size_t branch = OctreeManager::branchIndex(
+                    filterValues[0],
+                    filterValues[1],
+                    filterValues[2]
+                );
+                if (fileBranch != -1 && static_cast<int>(branch) != fileBranch) {
+                    // The branch this star belongs to might already have been written
+                    nMisplacedStars++;
+                    continue;
+                }
+
+                // If all filters passed then insert render values into Octree.
+                const std::vector<float> renderValues(
+                    filterValues.begin(),
+                    filterValues.begin() + RENDER_VALUES
+                );
+
+                const std::lock_guard lock(branchMutexes[branch]);
+                _indexOctreeManager->insert(renderValues);
+                nStars++;
+            }
+        }
+        else {
+            LERROR(std::format(
+                "Error opening file '{}' for loading preprocessed file", inFilePath
+            ));
+        }
+
+        for (size_t i = 0; i < 8; i++) {
+            if ((fileBranch == -1 || fileBranch == static_cast<int>(i)) &&
+                --nRemainingFiles[i] == 0)
+            {
+                finishBranch(i);
+            }
+        }
+    };
+
+    TaskScheduler scheduler = TaskScheduler(std::thread::hardware_concurrency());
+
+    // Branches without any input files are already done
+    std::vector<TaskFuture<void>> futures;
+    for (size_t i = 0; i < 8; i++) {
+        if (nRemainingFiles[i] == 0) {
+            futures.push_back(
+                scheduler.submit([&finishBranch, i]() { finishBranch(i); })
+            );
+        }
+    }
+    std::vector<TaskFuture<void>> fileFutures;
+    for (size_t i = 0; i < allInputFiles.size(); i++) {
+        fileFutures.push_back(scheduler.submit([&readFile, i]() { readFile(i); }));
+    }
+
+    for (size_t i = 0; i < fileFutures.size(); i++) {
+        fileFutures[i].get();
+        progressCallback(static_cast<float>(i + 1) / fileFutures.size());
+    }
+    for (TaskFuture<void>& future : futures) {
+        future.get();
+    }
+
+    LINFO(std::format(
+        "A total of {} stars were read from files and distributed into {} total nodes",
+        nStars.load(), _indexOctreeManager->totalNodes()
+    ));
+    LINFO(std::format("{} stars were filtered", nFilteredStars.load()));
+    if (nMisplacedStars > 0) {
+        LWARNING(std::format(
+            "{} stars were skipped as they were in a file of a different branch",
+            nMisplacedStars.load()
+        ));
+    }
+
+    writeIndexFiles();
+}
+
+size_t ConstructOctreeTask::insertInParallel(const std::vector<float>& data,
+                                             int32_t nValuesPerStar)
+{
+    // First pass: Filter the stars and bin them by the branch that they are inserted
+    // into, keeping the order of the stars within each branch
+    std::array<std::vector<size_t>, 8> branches;
+    size_t nFilteredStars = 0;
+    for (size_t i = 0; i < data.size(); i += nValuesPerStar) {
+        auto first = data.begin() + i;
+        auto last = data.begin() + i + nValuesPerStar;
+        const std::vector<float> filterValues(first, last);
+
+        // Filter data by parameters.
+        if (checkAllFilters(filterValues)) {
+            nFilteredStars++;
+            continue;
+        }
+
+        const size_t branch =
+            OctreeManager::branchIndex(data[i], data[i + 1], data[i + 2]);
+        branches[branch].push_back(i);
+    }
+
+    // Second pass: Construct and slice all branches concurrently
+    TaskScheduler scheduler = TaskScheduler(8);
+    std::vector<TaskFuture<void>> futures;
+    for (size_t branch = 0; branch < 8; branch++) {
+        futures.push_back(scheduler.submit([this, &data, &branches, branch]() {
+            for (size_t i : branches[branch]) {
+                auto first = data.begin() + i;
+                const std::vector<float> renderValues(first, first + RENDER_VALUES);
+                _octreeManager->insert(renderValues);
+            }
+            // Release the memory of the bin before slicing to keep the peak memory down
+            branches[branch] = std::vector<size_t>();
+
+            _octreeManager->sliceLodData(branch);
+        }));
+    }
+    for (TaskFuture<void>& future : futures) {
+        future.get();
+    }
+
+    return nFilteredStars;
+}
+
+void ConstructOctreeTask::writeIndexFiles() {
     // Write index file of Octree structure.
     std::filesystem::path indexFileOutPath = std::format(
         "{}/index.bin", _outFileOrFolderPath.string()
@@ -607,9 +854,12 @@ void ConstructOctreeTask::constructOctreeFromFolder(
         ));
     }
 
-    // Make sure all threads are done.
-    for (int i = 0; i < 8; i++) {
-        writeThreads[i].join();
+    // Pack all node files into a single file that is memory-mapped when streaming
+    try {
+        NodeStore::pack(_outFileOrFolderPath, _outFileOrFolderPath / NodeStore::FileName);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(std::format("Error writing node store: {}", e.message));
     }
 }
 
@@ -62,6 +62,33 @@ private:
      */
     void constructOctreeFromFolder(const Task::ProgressCallback& progressCallback);
 
+    /**
+     * Parallel version of #constructOctreeFromFolder. Every input file is read and
+     * inserted on its own worker thread, with one lock per octree branch. As soon as the
+     * last file belonging to a branch (identified by the `octant_<i>` file name written
+     * by ReadFitsTask) has been inserted, that branch is sliced and written to disk while
+     * the remaining files are still being processed.
+     */
+    void constructOctreeFromFolderInParallel(
+                                          const Task::ProgressCallback& progressCallback);
+
+    /**
+     * Bins the stars in \p data by the octree branch they belong to and inserts and
+     * slices every branch on its own worker thread.
+     *
+     * \param data The full dataset with \p nValuesPerStar values for every star
+     * \param nValuesPerStar The number of values that are stored for every star
+     *
+     * \return The number of stars that were removed by the filters
+     */
+    size_t insertInParallel(const std::vector<float>& data, int32_t nValuesPerStar);
+
+    /**
+     * Writes the index file of the octree structure into the output folder and packs
+     * all node files into a single NodeStore next to it.
+     */
+    void writeIndexFiles();
+
     /**
      * Checks all defined filter ranges and returns true if any of the corresponding
      * \p filterValues are outside of the defined range.
@@ -86,6 +113,7 @@ private:
     int _maxDist = 0;
     int _maxStarsPerNode = 0;
     bool _singleFileInput = false;
+    bool _parallel = false;
 
     std::shared_ptr<OctreeManager> _octreeManager;
     std::shared_ptr<OctreeManager> _indexOctreeManager;
@@ -26,6 +26,7 @@
 
 #include <modules/globebrowsing/src/basictypes.h>
 #include <modules/globebrowsing/src/dashboarditemglobelocation.h>
+#include <modules/globebrowsing/src/disktilecache.h>
 #include <modules/globebrowsing/src/gdalwrapper.h>
 #include <modules/globebrowsing/src/geodeticpatch.h>
 #include <modules/globebrowsing/src/geojson/geojsoncomponent.h>
@@ -65,6 +66,7 @@
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/scripting/lualibrary.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/taskscheduler.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/format.h>
@@ -73,6 +75,8 @@
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/misc/profiling.h>
 #include <ghoul/systemcapabilities/generalcapabilitiescomponent.h>
+#include <algorithm>
+#include <thread>
 #include <vector>
 
 #include <gdal.h>
@@ -124,6 +128,41 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo DiskTileCacheEnabledInfo = {
+        "DiskTileCacheEnabled",
+        "Disk Tile Cache Enabled",
+        "Determines whether decoded tiles are also stored in a persistent cache on disk, "
+        "from which they can be loaded without decoding the original data again. "
+        "Changing this value only has an effect after a restart.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo DiskTileCacheLocationInfo = {
+        "DiskTileCacheLocation",
+        "Disk Tile Cache Location",
+        "The folder in which the disk tile cache is stored. Changing this value only has "
+        "an effect after a restart.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo DiskTileCacheSizeInfo = {
+        "DiskTileCacheSize",
+        "Disk Tile Cache Size (MB)",
+        "The maximum size of the disk tile cache in MB. When the cache grows larger, the "
+        "least recently used tiles are removed.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo
+        DiskTileCacheCompressionInfo =
+    {
+        "DiskTileCacheCompression",
+        "Disk Tile Cache Compression",
+        "If this value is enabled, tiles are compressed with LZ4 before they are written "
+        "to the disk tile cache.",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
     openspace::GlobeBrowsingModule::Capabilities
     parseSubDatasets(char** subDatasets, int nSubdatasets)
     {
@@ -192,6 +231,18 @@ namespace {
 
         // [[codegen::verbatim(MRFCacheLocationInfo.description)]]
         std::optional<std::string> mrfCacheLocation [[codegen::key("MRFCacheLocation")]];
+
+        // [[codegen::verbatim(DiskTileCacheEnabledInfo.description)]]
+        std::optional<bool> diskTileCacheEnabled;
+
+        // [[codegen::verbatim(DiskTileCacheLocationInfo.description)]]
+        std::optional<std::string> diskTileCacheLocation;
+
+        // [[codegen::verbatim(DiskTileCacheSizeInfo.description)]]
+        std::optional<int> diskTileCacheSize;
+
+        // [[codegen::verbatim(DiskTileCacheCompressionInfo.description)]]
+        std::optional<bool> diskTileCacheCompression;
     };
 #include "globebrowsingmodule_codegen.cpp"
 } // namespace
@@ -204,6 +255,10 @@ GlobeBrowsingModule::GlobeBrowsingModule()
     , _defaultGeoPointTexturePath(DefaultGeoPointTextureInfo)
     , _mrfCacheEnabled(MRFCacheEnabledInfo, false)
     , _mrfCacheLocation(MRFCacheLocationInfo, "${BASE}/cache_mrf")
+    , _diskTileCacheEnabled(DiskTileCacheEnabledInfo, false)
+    , _diskTileCacheLocation(DiskTileCacheLocationInfo, "${BASE}/cache_tiles")
+    , _diskTileCacheSizeMB(DiskTileCacheSizeInfo, 4096, 16, 1024 * 1024)
+    , _diskTileCacheCompression(DiskTileCacheCompressionInfo, true)
 {
     addProperty(_tileCacheSizeMB);
 
@@ -211,6 +266,11 @@ GlobeBrowsingModule::GlobeBrowsingModule()
 
     addProperty(_mrfCacheEnabled);
     addProperty(_mrfCacheLocation);
+
+    addProperty(_diskTileCacheEnabled);
+    addProperty(_diskTileCacheLocation);
+    addProperty(_diskTileCacheSizeMB);
+    addProperty(_diskTileCacheCompression);
 }
 
 void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
@@ -246,6 +306,37 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
     _mrfCacheEnabled = p.mrfCacheEnabled.value_or(_mrfCacheEnabled);
     _mrfCacheLocation = p.mrfCacheLocation.value_or(_mrfCacheLocation);
 
+    _diskTileCacheEnabled = p.diskTileCacheEnabled.value_or(_diskTileCacheEnabled);
+    _diskTileCacheLocation = p.diskTileCacheLocation.value_or(_diskTileCacheLocation);
+    if (p.diskTileCacheSize.has_value()) {
+        _diskTileCacheSizeMB = static_cast<unsigned int>(*p.diskTileCacheSize);
+    }
+    _diskTileCacheCompression =
+        p.diskTileCacheCompression.value_or(_diskTileCacheCompression);
+
+    _diskTileCacheSizeMB.onChange([this]() {
+        if (_diskTileCache) {
+            _diskTileCache->setBudget(_diskTileCacheSizeMB * 1024ULL * 1024ULL);
+        }
+    });
+    _diskTileCacheCompression.onChange([this]() {
+        if (_diskTileCache) {
+            _diskTileCache->setCompressionEnabled(_diskTileCacheCompression);
+        }
+    });
+
+    // The chunk evaluation runs alongside the main thread, so it only gets to use half of
+    // the available cores to leave room for the tile loading threads
+    _chunkEvaluationScheduler = std::make_unique<TaskScheduler>(
+        std::max(1u, std::thread::hardware_concurrency() / 2)
+    );
+
+    // Building vector tiles can take a long time for large polygons, so they get their
+    // own threads rather than delaying the chunk evaluation that a frame waits for
+    _vectorTileScheduler = std::make_unique<TaskScheduler>(
+        std::max(1u, std::thread::hardware_concurrency() / 4)
+    );
+
     // Initialize
     global::callback::initializeGL->emplace_back([this]() {
         ZoneScopedN("GlobeBrowsingModule");
@@ -253,6 +344,22 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
         _tileCache = std::make_unique<cache::MemoryAwareTileCache>(_tileCacheSizeMB);
         addPropertySubOwner(_tileCache.get());
 
+        if (_diskTileCacheEnabled) {
+            try {
+                _diskTileCache = std::make_unique<cache::DiskTileCache>(
+                    absPath(_diskTileCacheLocation.value()),
+                    _diskTileCacheSizeMB * 1024ULL * 1024ULL,
+                    _diskTileCacheCompression
+                );
+            }
+            catch (const std::filesystem::filesystem_error& e) {
+                LERROR(std::format(
+                    "Could not create disk tile cache in '{}': {}",
+                    _diskTileCacheLocation.value(), e.what()
+                ));
+            }
+        }
+
         TileProvider::initializeDefaultTile();
 
         // Convert from MB to Bytes
@@ -277,9 +384,12 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
     });
 
     // Deinitialize
-    global::callback::deinitialize->emplace_back([]() {
+    global::callback::deinitialize->emplace_back([this]() {
         ZoneScopedN("GlobeBrowsingModule");
 
+        _diskTileCache = nullptr;
+        _chunkEvaluationScheduler = nullptr;
+        _vectorTileScheduler = nullptr;
         GdalWrapper::destroy();
     });
 
@@ -326,6 +436,18 @@ globebrowsing::cache::MemoryAwareTileCache* GlobeBrowsingModule::tileCache() {
     return _tileCache.get();
 }
 
+globebrowsing::cache::DiskTileCache* GlobeBrowsingModule::diskTileCache() {
+    return _diskTileCache.get();
+}
+
+TaskScheduler* GlobeBrowsingModule::chunkEvaluationScheduler() {
+    return _chunkEvaluationScheduler.get();
+}
+
+TaskScheduler* GlobeBrowsingModule::vectorTileScheduler() {
+    return _vectorTileScheduler.get();
+}
+
 std::vector<documentation::Documentation> GlobeBrowsingModule::documentations() const {
     return {
         globebrowsing::Layer::Documentation(),
@@ -40,12 +40,16 @@ namespace openspace::globebrowsing {
     struct Geodetic2;
     struct Geodetic3;
 
-    namespace cache { class MemoryAwareTileCache; }
+    namespace cache {
+        class DiskTileCache;
+        class MemoryAwareTileCache;
+    } // namespace cache
 } // namespace openspace::globebrowsing
 
 namespace openspace {
 
 class Camera;
+class TaskScheduler;
 
 class GlobeBrowsingModule : public OpenSpaceModule {
 public:
@@ -66,6 +70,23 @@ public:
     glm::dvec3 geoPosition() const;
 
     globebrowsing::cache::MemoryAwareTileCache* tileCache();
+
+    /**
+     * \return The persistent tile cache, or `nullptr` if the disk tile cache is disabled
+     */
+    globebrowsing::cache::DiskTileCache* diskTileCache();
+
+    /**
+     * \return The scheduler whose worker threads are shared by all globes to evaluate
+     *         the chunks of their chunk trees
+     */
+    TaskScheduler* chunkEvaluationScheduler();
+
+    /**
+     * \return The scheduler whose worker threads build the vector tiles of the GeoJson
+     *         layers of all globes
+     */
+    TaskScheduler* vectorTileScheduler();
     scripting::LuaLibrary luaLibrary() const override;
     std::vector<documentation::Documentation> documentations() const override;
 
@@ -118,7 +139,15 @@ private:
     properties::BoolProperty _mrfCacheEnabled;
     properties::StringProperty _mrfCacheLocation;
 
+    properties::BoolProperty _diskTileCacheEnabled;
+    properties::StringProperty _diskTileCacheLocation;
+    properties::UIntProperty _diskTileCacheSizeMB;
+    properties::BoolProperty _diskTileCacheCompression;
+
     std::unique_ptr<globebrowsing::cache::MemoryAwareTileCache> _tileCache;
+    std::unique_ptr<globebrowsing::cache::DiskTileCache> _diskTileCache;
+    std::unique_ptr<TaskScheduler> _chunkEvaluationScheduler;
+    std::unique_ptr<TaskScheduler> _vectorTileScheduler;
 
     // name -> capabilities
     std::map<std::string, std::future<Capabilities>> _inFlightCapabilitiesMap;
@@ -40,10 +40,21 @@ namespace {
 } // namespace
 
 AsyncTileDataProvider::AsyncTileDataProvider(std::string name,
-                                    std::unique_ptr<RawTileDataReader> rawTileDataReader)
+                                    std::unique_ptr<RawTileDataReader> rawTileDataReader,
+                                                     cache::DiskTileCache* diskTileCache,
+                                                                 uint64_t diskTileSource,
+                                     TileTextureInitData::Compression textureCompression)
     : _name(std::move(name))
     , _rawTileDataReader(std::move(rawTileDataReader))
-    , _concurrentJobManager(LRUThreadPool<TileIndex::TileHashKey>(1, 10))
+    , _diskTileCache(diskTileCache)
+    , _diskTileSource(diskTileSource)
+    , _textureCompression(textureCompression)
+    // Every reader thread needs its own dataset handle, so there is no point in having
+    // more threads than the reader can provide handles
+    , _concurrentJobManager(LRUThreadPool<TileIndex::TileHashKey>(
+        _rawTileDataReader->nDatasetHandles(),
+        10
+    ))
 {
     ZoneScoped;
 
@@ -58,7 +69,13 @@ bool AsyncTileDataProvider::enqueueTileIO(const TileIndex& tileIndex) {
     ZoneScoped;
 
     if (_resetMode == ResetMode::ShouldNotReset && satisfiesEnqueueCriteria(tileIndex)) {
-        auto job = std::make_unique<TileLoadJob>(*_rawTileDataReader, tileIndex);
+        auto job = std::make_unique<TileLoadJob>(
+            *_rawTileDataReader,
+            tileIndex,
+            _diskTileCache,
+            _diskTileSource,
+            _textureCompression
+        );
         _concurrentJobManager.enqueueJob(std::move(job), tileIndex.hashKey());
         _enqueuedTileRequests.insert(tileIndex.hashKey());
         return true;
@@ -66,32 +83,69 @@ bool AsyncTileDataProvider::enqueueTileIO(const TileIndex& tileIndex) {
     return false;
 }
 
+bool AsyncTileDataProvider::prefetchTileIO(const TileIndex& tileIndex) {
+    ZoneScoped;
+
+    // Not using satisfiesEnqueueCriteria here as that would bump an already enqueued
+    // tile to the front of the queue
+    if (_resetMode != ResetMode::ShouldNotReset ||
+        _enqueuedTileRequests.contains(tileIndex.hashKey()))
+    {
+        return false;
+    }
+
+    auto job = std::make_unique<TileLoadJob>(
+        *_rawTileDataReader,
+        tileIndex,
+        _diskTileCache,
+        _diskTileSource,
+        _textureCompression
+    );
+    const bool enqueued =
+        _concurrentJobManager.enqueueLowPriorityJob(std::move(job), tileIndex.hashKey());
+    if (enqueued) {
+        _enqueuedTileRequests.insert(tileIndex.hashKey());
+    }
+    return enqueued;
+}
+
 void AsyncTileDataProvider::clearTiles() {
-    std::optional<RawTile> finishedJob = popFinishedRawTile();
-    while (finishedJob) {
-        finishedJob = popFinishedRawTile();
+    std::vector<std::shared_ptr<Job<RawTile>>> finishedJobs;
+    _concurrentJobManager.popFinishedJobs(finishedJobs);
+    for (const std::shared_ptr<Job<RawTile>>& job : finishedJobs) {
+        finishJob(*job);
     }
 }
 
-std::optional<RawTile> AsyncTileDataProvider::popFinishedRawTile() {
-    if (_concurrentJobManager.numFinishedJobs() > 0) {
-        // Now the tile load job looses ownerwhip of the data pointer
-        RawTile product = _concurrentJobManager.popFinishedJob()->product();
+std::vector<RawTile> AsyncTileDataProvider::popFinishedRawTiles() {
+    std::vector<std::shared_ptr<Job<RawTile>>> finishedJobs;
+    _concurrentJobManager.popFinishedJobs(finishedJobs);
 
-        const TileIndex::TileHashKey key = product.tileIndex.hashKey();
-        // No longer enqueued. Remove from set of enqueued tiles
-        _enqueuedTileRequests.erase(key);
-        // Pbo is still mapped. Set the id for the raw tile
-        if (product.error != RawTile::ReadError::None) {
-            product.imageData = nullptr;
-            return std::nullopt;
+    std::vector<RawTile> tiles;
+    tiles.reserve(finishedJobs.size());
+    for (const std::shared_ptr<Job<RawTile>>& job : finishedJobs) {
+        std::optional<RawTile> tile = finishJob(*job);
+        if (tile) {
+            tiles.push_back(std::move(*tile));
         }
-
-        return product;
     }
-    else {
+    return tiles;
+}
+
+std::optional<RawTile> AsyncTileDataProvider::finishJob(Job<RawTile>& job) {
+    // Now the tile load job looses ownerwhip of the data pointer
+    RawTile product = job.product();
+
+    const TileIndex::TileHashKey key = product.tileIndex.hashKey();
+    // No longer enqueued. Remove from set of enqueued tiles
+    _enqueuedTileRequests.erase(key);
+    // Pbo is still mapped. Set the id for the raw tile
+    if (product.error != RawTile::ReadError::None) {
+        product.imageData = nullptr;
         return std::nullopt;
     }
+
+    return product;
 }
 
 bool AsyncTileDataProvider::satisfiesEnqueueCriteria(const TileIndex& tileIndex) {
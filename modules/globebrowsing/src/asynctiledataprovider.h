@@ -32,10 +32,12 @@
 #include <map>
 #include <optional>
 #include <set>
+#include <vector>
 
 namespace openspace::globebrowsing {
 
 struct RawTile;
+namespace cache { class DiskTileCache; }
 
 /**
  * The responsibility of this class is to enqueue tile requests and fetching finished
@@ -47,9 +49,18 @@ public:
      * \param name is the name for this provider
      * \param rawTileDataReader is the reader that will be used for the asynchronous tile
      *        loading
+     * \param diskTileCache is an optional persistent cache that is consulted before the
+     *        \p rawTileDataReader is used
+     * \param diskTileSource identifies the tiles of this provider in the
+     *        \p diskTileCache and has to be stable between runs
+     * \param textureCompression is the compression that is applied to the loaded tiles
+     *        before they are handed out for upload
      */
     AsyncTileDataProvider(std::string name,
-        std::unique_ptr<RawTileDataReader> rawTileDataReader);
+        std::unique_ptr<RawTileDataReader> rawTileDataReader,
+        cache::DiskTileCache* diskTileCache = nullptr, uint64_t diskTileSource = 0,
+        TileTextureInitData::Compression textureCompression =
+            TileTextureInitData::Compression::None);
 
     /**
      * Creates a job which asynchronously loads a raw tile. This job is enqueued.
@@ -57,9 +68,19 @@ public:
     bool enqueueTileIO(const TileIndex& tileIndex);
 
     /**
-     * Get one finished job.
+     * Creates a low priority job that loads a tile which is expected to be needed soon.
+     * Contrary to #enqueueTileIO, the job is only enqueued if there is room in the queue
+     * and it never displaces or delays tiles that are needed right now.
+     *
+     * \return `true` if a job was enqueued
      */
-    std::optional<RawTile> popFinishedRawTile();
+    bool prefetchTileIO(const TileIndex& tileIndex);
+
+    /**
+     * Get all jobs that have finished since the last call. Tiles that failed to load are
+     * not included.
+     */
+    std::vector<RawTile> popFinishedRawTiles();
 
     void update();
     void reset();
@@ -94,6 +115,12 @@ protected:
 
     void clearTiles();
 
+    /**
+     * Takes ownership of the product of a finished job, marks it as no longer enqueued,
+     * and returns it unless it failed to load.
+     */
+    std::optional<RawTile> finishJob(Job<RawTile>& job);
+
     void endEnqueuedJobs();
 
     void performReset(ResetRawTileDataReader resetRawTileDataReader);
@@ -102,6 +129,9 @@ private:
     const std::string _name;
     /// The reader used for asynchronous reading
     std::unique_ptr<RawTileDataReader> _rawTileDataReader;
+    cache::DiskTileCache* _diskTileCache;
+    const uint64_t _diskTileSource;
+    const TileTextureInitData::Compression _textureCompression;
 
     PrioritizingConcurrentJobManager<RawTile, TileIndex::TileHashKey>
         _concurrentJobManager;
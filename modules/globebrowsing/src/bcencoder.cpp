@@ -0,0 +1,585 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/globebrowsing/src/bcencoder.h>
+
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace {
+    using Compression = openspace::globebrowsing::TileTextureInitData::Compression;
+
+    // The interpolation weights that BC7 uses for 4-bit indices
+    constexpr std::array<int, 16> BC7Weights = {
+        0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+    };
+
+    template <int N>
+    using Point = std::array<float, N>;
+
+    using Palette = std::array<std::array<int, 4>, 16>;
+
+    /**
+     * Returns the two endpoints of the segment along the principal axis of the first
+     * \p n \p points that covers all of the points when they are projected onto it.
+     */
+    template <int N>
+    std::pair<Point<N>, Point<N>> principalEndpoints(
+                                                const std::array<Point<N>, 16>& points,
+                                                                                 int n)
+    {
+        ghoul_assert(n > 0, "Need at least one point");
+
+        Point<N> mean = {};
+        for (int i = 0; i < n; i++) {
+            for (int c = 0; c < N; c++) {
+                mean[c] += points[i][c];
+            }
+        }
+        for (int c = 0; c < N; c++) {
+            mean[c] /= static_cast<float>(n);
+        }
+
+        std::array<Point<N>, N> covariance = {};
+        for (int i = 0; i < n; i++) {
+            for (int r = 0; r < N; r++) {
+                for (int c = 0; c < N; c++) {
+                    const float dr = points[i][r] - mean[r];
+                    const float dc = points[i][c] - mean[c];
+                    covariance[r][c] += dr * dc;
+                }
+            }
+        }
+
+        // Power iteration starting on the segment between the two points that are
+        // furthest apart in the channel with the largest extent. Unlike a fixed start
+        // such as the diagonal, this can't be orthogonal to the principal axis of blocks
+        // with anti-correlated channels, where the iteration would otherwise collapse
+        int minPoint = 0;
+        int maxPoint = 0;
+        float largestExtent = 0.f;
+        for (int c = 0; c < N; c++) {
+            int minI = 0;
+            int maxI = 0;
+            for (int i = 1; i < n; i++) {
+                minI = points[i][c] < points[minI][c] ? i : minI;
+                maxI = points[i][c] > points[maxI][c] ? i : maxI;
+            }
+            const float extent = points[maxI][c] - points[minI][c];
+            if (extent > largestExtent) {
+                minPoint = minI;
+                maxPoint = maxI;
+                largestExtent = extent;
+            }
+        }
+        Point<N> axis;
+        for (int c = 0; c < N; c++) {
+            axis[c] = points[maxPoint][c] - points[minPoint][c];
+        }
+        if (largestExtent == 0.f) {
+            // All points are identical, so any axis will do
+            axis.fill(1.f);
+        }
+        for (int iteration = 0; iteration < 8; iteration++) {
+            Point<N> next = {};
+            for (int r = 0; r < N; r++) {
+                for (int c = 0; c < N; c++) {
+                    next[r] += covariance[r][c] * axis[c];
+                }
+            }
+            float largest = 0.f;
+            for (int c = 0; c < N; c++) {
+                largest = std::max(largest, std::abs(next[c]));
+            }
+            if (largest < 1e-6f) {
+                // All points are (almost) identical, so any axis will do
+                break;
+            }
+            for (int c = 0; c < N; c++) {
+                axis[c] = next[c] / largest;
+            }
+        }
+        float length = 0.f;
+        for (int c = 0; c < N; c++) {
+            length += axis[c] * axis[c];
+        }
+        length = std::sqrt(length);
+        for (int c = 0; c < N; c++) {
+            axis[c] /= length;
+        }
+
+        float minT = std::numeric_limits<float>::max();
+        float maxT = std::numeric_limits<float>::lowest();
+        for (int i = 0; i < n; i++) {
+            float t = 0.f;
+            for (int c = 0; c < N; c++) {
+                t += (points[i][c] - mean[c]) * axis[c];
+            }
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+
+        Point<N> lo;
+        Point<N> hi;
+        for (int c = 0; c < N; c++) {
+            lo[c] = std::clamp(mean[c] + axis[c] * minT, 0.f, 255.f);
+            hi[c] = std::clamp(mean[c] + axis[c] * maxT, 0.f, 255.f);
+        }
+        return { lo, hi };
+    }
+
+    // Returns the index of the palette entry that is closest to the pixel
+    int closestEntry(const uint8_t* pixel, const Palette& palette, int nEntries,
+                     int nChannels)
+    {
+        int best = 0;
+        int bestError = std::numeric_limits<int>::max();
+        for (int i = 0; i < nEntries; i++) {
+            int error = 0;
+            for (int c = 0; c < nChannels; c++) {
+                const int d = static_cast<int>(pixel[c]) - palette[i][c];
+                error += d * d;
+            }
+            if (error < bestError) {
+                best = i;
+                bestError = error;
+            }
+        }
+        return best;
+    }
+
+    uint16_t pack565(const Point<3>& color) {
+        auto quantize = [](float v, int maxValue) {
+            const int q = static_cast<int>(std::round(v * maxValue / 255.f));
+            return std::clamp(q, 0, maxValue);
+        };
+        return static_cast<uint16_t>(
+            (quantize(color[0], 31) << 11) |
+            (quantize(color[1], 63) << 5) |
+            quantize(color[2], 31)
+        );
+    }
+
+    std::array<int, 3> unpack565(uint16_t color) {
+        const int r = (color >> 11) & 0x1F;
+        const int g = (color >> 5) & 0x3F;
+        const int b = color & 0x1F;
+        return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+    }
+
+    // Computes the colors of a BC1 block. The order of the endpoints determines whether
+    // the block has four opaque colors or three opaque colors and a transparent one
+    Palette bc1Palette(uint16_t c0, uint16_t c1) {
+        const std::array<int, 3> e0 = unpack565(c0);
+        const std::array<int, 3> e1 = unpack565(c1);
+
+        Palette res = {};
+        for (int c = 0; c < 3; c++) {
+            res[0][c] = e0[c];
+            res[1][c] = e1[c];
+            if (c0 > c1) {
+                res[2][c] = (2 * e0[c] + e1[c]) / 3;
+                res[3][c] = (e0[c] + 2 * e1[c]) / 3;
+            }
+            else {
+                res[2][c] = (e0[c] + e1[c]) / 2;
+                res[3][c] = 0;
+            }
+        }
+        res[0][3] = 255;
+        res[1][3] = 255;
+        res[2][3] = 255;
+        res[3][3] = c0 > c1 ? 255 : 0;
+        return res;
+    }
+
+    struct BC7Endpoint {
+        std::array<int, 4> values;
+        int pBit;
+    };
+
+    // Quantizes an endpoint to 7 bits per channel and one p-bit that is shared between
+    // all channels and acts as their least significant bit
+    BC7Endpoint quantizeBC7Endpoint(const Point<4>& endpoint) {
+        BC7Endpoint best = {};
+        float bestError = std::numeric_limits<float>::max();
+        for (int p = 0; p < 2; p++) {
+            BC7Endpoint candidate = { .values = {}, .pBit = p };
+            float error = 0.f;
+            for (int c = 0; c < 4; c++) {
+                const int q = static_cast<int>(std::round((endpoint[c] - p) / 2.f));
+                candidate.values[c] = std::clamp(q, 0, 127);
+                const float d =
+                    static_cast<float>((candidate.values[c] << 1) | p) - endpoint[c];
+                error += d * d;
+            }
+            if (error < bestError) {
+                best = candidate;
+                bestError = error;
+            }
+        }
+        return best;
+    }
+
+    Palette bc7Palette(const BC7Endpoint& e0, const BC7Endpoint& e1) {
+        Palette res;
+        for (int c = 0; c < 4; c++) {
+            const int v0 = (e0.values[c] << 1) | e0.pBit;
+            const int v1 = (e1.values[c] << 1) | e1.pBit;
+            for (int i = 0; i < 16; i++) {
+                const int w = BC7Weights[i];
+                res[i][c] = ((64 - w) * v0 + w * v1 + 32) >> 6;
+            }
+        }
+        return res;
+    }
+
+    // Writes values into a 128-bit block starting at the least significant bit
+    class BitWriter {
+    public:
+        explicit BitWriter(std::byte* dst) : _dst(dst) {
+            std::memset(_dst, 0, 16);
+        }
+
+        void write(int value, int nBits) {
+            for (int i = 0; i < nBits; i++) {
+                if ((value >> i) & 1) {
+                    _dst[_position / 8] |= std::byte(1 << (_position % 8));
+                }
+                _position++;
+            }
+        }
+
+    private:
+        std::byte* _dst;
+        int _position = 0;
+    };
+
+    class BitReader {
+    public:
+        explicit BitReader(const std::byte* src) : _src(src) {}
+
+        int read(int nBits) {
+            int res = 0;
+            for (int i = 0; i < nBits; i++) {
+                const int byte = std::to_integer<int>(_src[_position / 8]);
+                res |= ((byte >> (_position % 8)) & 1) << i;
+                _position++;
+            }
+            return res;
+        }
+
+    private:
+        const std::byte* _src;
+        int _position = 0;
+    };
+
+    // Halves the size of an RGBA image by averaging blocks of 2x2 pixels
+    std::vector<uint8_t> downsample(const std::vector<uint8_t>& rgba, int width,
+                                    int height)
+    {
+        const int w = width / 2;
+        const int h = height / 2;
+        std::vector<uint8_t> res(static_cast<size_t>(w) * h * 4);
+        for (int y = 0; y < h; y++) {
+            const uint8_t* row0 = &rgba[static_cast<size_t>(2 * y) * width * 4];
+            const uint8_t* row1 = row0 + static_cast<size_t>(width) * 4;
+            for (int x = 0; x < w; x++) {
+                for (int c = 0; c < 4; c++) {
+                    const int sum =
+                        row0[8 * x + c] + row0[8 * x + 4 + c] +
+                        row1[8 * x + c] + row1[8 * x + 4 + c];
+                    res[(static_cast<size_t>(y) * w + x) * 4 + c] =
+                        static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+        return res;
+    }
+} // namespace
+
+namespace openspace::globebrowsing::bc {
+
+void encodeBC1Block(const uint8_t* rgba, std::byte* dst) {
+    // Only the opaque pixels contribute to the colors of the block
+    std::array<Point<3>, 16> points;
+    int nOpaque = 0;
+    bool hasTransparency = false;
+    for (int i = 0; i < 16; i++) {
+        const uint8_t* pixel = &rgba[4 * i];
+        if (pixel[3] < 128) {
+            hasTransparency = true;
+            continue;
+        }
+        points[nOpaque] = {
+            static_cast<float>(pixel[0]),
+            static_cast<float>(pixel[1]),
+            static_cast<float>(pixel[2])
+        };
+        nOpaque++;
+    }
+
+    uint16_t c0 = 0;
+    uint16_t c1 = 0;
+    if (nOpaque > 0) {
+        const auto [lo, hi] = principalEndpoints<3>(points, nOpaque);
+        c0 = pack565(hi);
+        c1 = pack565(lo);
+    }
+    if (hasTransparency ? (c0 > c1) : (c0 < c1)) {
+        std::swap(c0, c1);
+    }
+
+    const Palette palette = bc1Palette(c0, c1);
+    // The fourth color is transparent in blocks with three colors
+    const int nColors = c0 > c1 ? 4 : 3;
+    uint32_t indices = 0;
+    for (int i = 0; i < 16; i++) {
+        const uint8_t* pixel = &rgba[4 * i];
+        const int index = pixel[3] < 128 ? 3 : closestEntry(pixel, palette, nColors, 3);
+        indices |= static_cast<uint32_t>(index) << (2 * i);
+    }
+
+    dst[0] = std::byte(c0 & 0xFF);
+    dst[1] = std::byte(c0 >> 8);
+    dst[2] = std::byte(c1 & 0xFF);
+    dst[3] = std::byte(c1 >> 8);
+    for (int i = 0; i < 4; i++) {
+        dst[4 + i] = std::byte((indices >> (8 * i)) & 0xFF);
+    }
+}
+
+void decodeBC1Block(const std::byte* src, uint8_t* rgba) {
+    const uint16_t c0 = static_cast<uint16_t>(
+        std::to_integer<int>(src[0]) | (std::to_integer<int>(src[1]) << 8)
+    );
+    const uint16_t c1 = static_cast<uint16_t>(
+        std::to_integer<int>(src[2]) | (std::to_integer<int>(src[3]) << 8)
+    );
+    uint32_t indices = 0;
+    for (int i = 0; i < 4; i++) {
+        indices |= std::to_integer<uint32_t>(src[4 + i]) << (8 * i);
+    }
+
+    const Palette palette = bc1Palette(c0, c1);
+    for (int i = 0; i < 16; i++) {
+        const int index = (indices >> (2 * i)) & 0b11;
+        for (int c = 0; c < 4; c++) {
+            rgba[4 * i + c] = static_cast<uint8_t>(palette[index][c]);
+        }
+    }
+}
+
+void encodeBC7Block(const uint8_t* rgba, std::byte* dst) {
+    std::array<Point<4>, 16> points;
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) {
+            points[i][c] = static_cast<float>(rgba[4 * i + c]);
+        }
+    }
+    const auto [lo, hi] = principalEndpoints<4>(points, 16);
+    BC7Endpoint e0 = quantizeBC7Endpoint(lo);
+    BC7Endpoint e1 = quantizeBC7Endpoint(hi);
+
+    const Palette palette = bc7Palette(e0, e1);
+    std::array<int, 16> indices;
+    for (int i = 0; i < 16; i++) {
+        indices[i] = closestEntry(&rgba[4 * i], palette, 16, 4);
+    }
+
+    // The most significant bit of the first index is not stored and implicitly 0, which
+    // can always be achieved by swapping the endpoints, as the weights are symmetric
+    if (indices[0] >= 8) {
+        std::swap(e0, e1);
+        for (int& index : indices) {
+            index = 15 - index;
+        }
+    }
+
+    BitWriter writer(dst);
+    // Mode 6 is signalled by six 0 bits followed by a 1 bit
+    writer.write(1 << 6, 7);
+    for (int c = 0; c < 4; c++) {
+        writer.write(e0.values[c], 7);
+        writer.write(e1.values[c], 7);
+    }
+    writer.write(e0.pBit, 1);
+    writer.write(e1.pBit, 1);
+    writer.write(indices[0], 3);
+    for (int i = 1; i < 16; i++) {
+        writer.write(indices[i], 4);
+    }
+}
+
+void decodeBC7Block(const std::byte* src, uint8_t* rgba) {
+    BitReader reader(src);
+    if (reader.read(7) != (1 << 6)) {
+        std::memset(rgba, 0, 64);
+        return;
+    }
+
+    BC7Endpoint e0 = {};
+    BC7Endpoint e1 = {};
+    for (int c = 0; c < 4; c++) {
+        e0.values[c] = reader.read(7);
+        e1.values[c] = reader.read(7);
+    }
+    e0.pBit = reader.read(1);
+    e1.pBit = reader.read(1);
+
+    const Palette palette = bc7Palette(e0, e1);
+    for (int i = 0; i < 16; i++) {
+        const int index = reader.read(i == 0 ? 3 : 4);
+        for (int c = 0; c < 4; c++) {
+            rgba[4 * i + c] = static_cast<uint8_t>(palette[index][c]);
+        }
+    }
+}
+
+void compressImage(TileTextureInitData::Compression compression, const uint8_t* rgba,
+                   int width, int height, std::byte* dst)
+{
+    ghoul_assert(compression != Compression::None, "No compression provided");
+    ghoul_assert(width % 4 == 0 && height % 4 == 0, "Size must be a multiple of 4");
+
+    const size_t blockSize = compression == Compression::BC1 ? 8 : 16;
+    std::array<uint8_t, 64> block;
+    for (int by = 0; by < height; by += 4) {
+        for (int bx = 0; bx < width; bx += 4) {
+            for (int y = 0; y < 4; y++) {
+                const size_t row = (static_cast<size_t>(by + y) * width + bx) * 4;
+                std::memcpy(&block[16 * y], &rgba[row], 16);
+            }
+            if (compression == Compression::BC1) {
+                encodeBC1Block(block.data(), dst);
+            }
+            else {
+                encodeBC7Block(block.data(), dst);
+            }
+            dst += blockSize;
+        }
+    }
+}
+
+void decompressImage(TileTextureInitData::Compression compression, const std::byte* src,
+                     int width, int height, uint8_t* rgba)
+{
+    ghoul_assert(compression != Compression::None, "No compression provided");
+    ghoul_assert(width % 4 == 0 && height % 4 == 0, "Size must be a multiple of 4");
+
+    const size_t blockSize = compression == Compression::BC1 ? 8 : 16;
+    std::array<uint8_t, 64> block;
+    for (int by = 0; by < height; by += 4) {
+        for (int bx = 0; bx < width; bx += 4) {
+            if (compression == Compression::BC1) {
+                decodeBC1Block(src, block.data());
+            }
+            else {
+                decodeBC7Block(src, block.data());
+            }
+            src += blockSize;
+            for (int y = 0; y < 4; y++) {
+                const size_t row = (static_cast<size_t>(by + y) * width + bx) * 4;
+                std::memcpy(&rgba[row], &block[16 * y], 16);
+            }
+        }
+    }
+}
+
+RawTile transcodeTile(RawTile rawTile, TileTextureInitData::Compression compression) {
+    ZoneScoped;
+
+    if (rawTile.error != RawTile::ReadError::None || !rawTile.imageData) {
+        return rawTile;
+    }
+
+    const TileTextureInitData& source = *rawTile.textureInitData;
+    ghoul_assert(supportsCompression(source, compression), "Unsupported compression");
+    // Compressed tiles are only kept on the GPU
+    const TileTextureInitData target = TileTextureInitData(
+        source.dimensions.x,
+        source.dimensions.y,
+        source.glType,
+        source.ghoulTextureFormat,
+        TileTextureInitData::ShouldAllocateDataOnCPU::No,
+        compression
+    );
+
+    int width = source.dimensions.x;
+    int height = source.dimensions.y;
+
+    // The encoders expect tightly packed RGBA pixels
+    using Format = ghoul::opengl::Texture::Format;
+    const bool isBGR =
+        source.ghoulTextureFormat == Format::BGR ||
+        source.ghoulTextureFormat == Format::BGRA;
+    const size_t nChannels = source.nRasters;
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(rawTile.imageData.get());
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = data + y * source.bytesPerLine;
+        for (int x = 0; x < width; x++) {
+            const uint8_t* pixel = row + x * nChannels;
+            uint8_t* dst = &rgba[(static_cast<size_t>(y) * width + x) * 4];
+            dst[0] = isBGR ? pixel[2] : pixel[0];
+            dst[1] = pixel[1];
+            dst[2] = isBGR ? pixel[0] : pixel[2];
+            dst[3] = nChannels == 4 ? pixel[3] : 255;
+        }
+    }
+
+    auto compressed = std::unique_ptr<std::byte[]>(new std::byte[target.textureNumBytes]);
+    std::byte* dst = compressed.get();
+    const int nLevels = nCompressedMipLevels(width, height);
+    for (int level = 0; level < nLevels; level++) {
+        compressImage(compression, rgba.data(), width, height, dst);
+        dst += compressedLevelSize(compression, width, height);
+        if (level + 1 < nLevels) {
+            rgba = downsample(rgba, width, height);
+            width /= 2;
+            height /= 2;
+        }
+    }
+    ghoul_assert(
+        dst == compressed.get() + target.textureNumBytes,
+        "Wrong compressed size"
+    );
+
+    rawTile.imageData = std::move(compressed);
+    // The assignment operator of TileTextureInitData does not copy the values, so the
+    // optional has to be reconstructed
+    rawTile.textureInitData.reset();
+    rawTile.textureInitData.emplace(target);
+    return rawTile;
+}
+
+} // namespace openspace::globebrowsing::bc
@@ -0,0 +1,101 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___BCENCODER___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___BCENCODER___H__
+
+#include <modules/globebrowsing/src/rawtile.h>
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace openspace::globebrowsing::bc {
+
+/**
+ * Compresses a block of 4x4 pixels into 8 bytes of BC1 data. Pixels with an alpha value
+ * below 128 are stored as fully transparent, all other pixels as fully opaque.
+ *
+ * \param rgba The 16 pixels of the block, row by row, with 4 bytes per pixel
+ * \param dst The destination of the 8 bytes of compressed data
+ */
+void encodeBC1Block(const uint8_t* rgba, std::byte* dst);
+
+/**
+ * Decompresses 8 bytes of BC1 data into a block of 4x4 pixels.
+ *
+ * \param src The compressed block
+ * \param rgba The destination of the 16 pixels, row by row, with 4 bytes per pixel
+ */
+void decodeBC1Block(const std::byte* src, uint8_t* rgba);
+
+/**
+ * Compresses a block of 4x4 pixels into 16 bytes of BC7 data. The encoder only uses
+ * mode 6, which stores one pair of RGBA endpoints with 4-bit indices per block.
+ *
+ * \param rgba The 16 pixels of the block, row by row, with 4 bytes per pixel
+ * \param dst The destination of the 16 bytes of compressed data
+ */
+void encodeBC7Block(const uint8_t* rgba, std::byte* dst);
+
+/**
+ * Decompresses 16 bytes of BC7 data into a block of 4x4 pixels. Only mode 6, which is
+ * the mode produced by #encodeBC7Block, is supported. Blocks in any other mode are
+ * decoded as transparent black.
+ *
+ * \param src The compressed block
+ * \param rgba The destination of the 16 pixels, row by row, with 4 bytes per pixel
+ */
+void decodeBC7Block(const std::byte* src, uint8_t* rgba);
+
+/**
+ * Compresses an image with the provided \p compression.
+ *
+ * \param compression The compression format, which must not be `None`
+ * \param rgba The pixels of the image, row by row, with 4 bytes per pixel
+ * \param width The width of the image, which has to be a multiple of 4
+ * \param height The height of the image, which has to be a multiple of 4
+ * \param dst The destination of the compressed image, which has to provide room for
+ *        `compressedLevelSize(compression, width, height)` bytes
+ */
+void compressImage(TileTextureInitData::Compression compression, const uint8_t* rgba,
+    int width, int height, std::byte* dst);
+
+/**
+ * Decompresses an image that was compressed with #compressImage.
+ */
+void decompressImage(TileTextureInitData::Compression compression, const std::byte* src,
+    int width, int height, uint8_t* rgba);
+
+/**
+ * Replaces the pixel data of the \p rawTile with its mipmap chain compressed with the
+ * provided \p compression and updates the texture init data of the tile accordingly.
+ * Tiles that failed to load are returned unchanged. This function is CPU-only and is
+ * meant to be called on the worker thread that has loaded the tile.
+ */
+RawTile transcodeTile(RawTile rawTile, TileTextureInitData::Compression compression);
+
+} // namespace openspace::globebrowsing::bc
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___BCENCODER___H__
@@ -0,0 +1,68 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___CHUNK___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___CHUNK___H__
+
+#include <modules/globebrowsing/src/geodeticpatch.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <ghoul/glm.h>
+#include <array>
+#include <cstdint>
+
+namespace openspace::globebrowsing {
+
+struct BoundingHeights {
+    float min;
+    float max;
+    bool available;
+    bool tileOK;
+};
+
+struct Chunk {
+    enum class Status : uint8_t {
+        DoNothing,
+        WantMerge,
+        WantSplit
+    };
+
+    Chunk(const TileIndex& ti);
+
+    const TileIndex tileIndex;
+    const GeodeticPatch surfacePatch;
+
+    Status status;
+
+    bool isVisible = true;
+    bool colorTileOK = false;
+    bool heightTileOK = false;
+
+    std::array<glm::dvec4, 8> corners;
+    std::array<Chunk*, 4> children = { { nullptr, nullptr, nullptr, nullptr } };
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___CHUNK___H__
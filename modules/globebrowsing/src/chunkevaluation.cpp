@@ -0,0 +1,284 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/globebrowsing/src/chunkevaluation.h>
+
+#include <modules/globebrowsing/src/ellipsoid.h>
+#include <openspace/util/taskscheduler.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <cmath>
+
+namespace {
+    // The number of chunks below which distributing the work to other threads costs
+    // more than it saves
+    constexpr size_t MinChunksPerBatch = 64;
+
+    const openspace::globebrowsing::AABB3 CullingFrustum{
+        glm::vec3(-1.f, -1.f, 0.f),
+        glm::vec3( 1.f,  1.f, 1e35f)
+    };
+
+    void expand(openspace::globebrowsing::AABB3& bb, const glm::vec3& p) {
+        bb.min = glm::min(bb.min, p);
+        bb.max = glm::max(bb.max, p);
+    }
+
+    bool intersects(const openspace::globebrowsing::AABB3& bb,
+                    const openspace::globebrowsing::AABB3& o)
+    {
+        return (bb.min.x <= o.max.x) && (o.min.x <= bb.max.x)
+            && (bb.min.y <= o.max.y) && (o.min.y <= bb.max.y)
+            && (bb.min.z <= o.max.z) && (o.min.z <= bb.max.z);
+    }
+} // namespace
+
+namespace openspace::globebrowsing {
+
+bool isCullableByFrustum(const Chunk& chunk, const glm::dmat4& modelViewProjection) {
+    ZoneScoped;
+
+    const std::array<glm::dvec4, 8>& corners = chunk.corners;
+
+    // Create a bounding box that fits the patch corners
+    AABB3 bounds; // in screen space
+    for (size_t i = 0; i < 8; i++) {
+        const glm::dvec4 cornerClippingSpace = modelViewProjection * corners[i];
+        const glm::dvec3 ndc = glm::dvec3(
+            (1.f / glm::abs(cornerClippingSpace.w)) * cornerClippingSpace
+        );
+        expand(bounds, ndc);
+    }
+
+    return !(intersects(CullingFrustum, bounds));
+}
+
+bool isCullableByHorizon(const Chunk& chunk, const BoundingHeights& heights,
+                         const ChunkEvaluationContext& context)
+{
+    ZoneScoped;
+
+    const Ellipsoid& ellipsoid = *context.ellipsoid;
+    const GeodeticPatch& patch = chunk.surfacePatch;
+    const float maxHeight = heights.max;
+    const glm::dvec3 globePos = glm::dvec3(0.0, 0.0, 0.0); // In model space it is 0
+    const double minimumGlobeRadius = ellipsoid.minimumRadius();
+
+    const glm::dvec3& cameraPos = context.cameraPosition;
+
+    const Geodetic2 closestPatchPoint = patch.closestPoint(context.cameraGeodetic);
+    glm::dvec3 objectPos = ellipsoid.cartesianSurfacePosition(closestPatchPoint);
+
+    // objectPosition is closest in latlon space but not guaranteed to be closest in
+    // castesian coordinates. Therefore we compare it to the corners and pick the
+    // real closest point,
+    std::array<glm::dvec3, 4> corners = {
+        ellipsoid.cartesianSurfacePosition(chunk.surfacePatch.corner(NORTH_WEST)),
+        ellipsoid.cartesianSurfacePosition(chunk.surfacePatch.corner(NORTH_EAST)),
+        ellipsoid.cartesianSurfacePosition(chunk.surfacePatch.corner(SOUTH_WEST)),
+        ellipsoid.cartesianSurfacePosition(chunk.surfacePatch.corner(SOUTH_EAST))
+    };
+
+    for (int i = 0; i < 4; i++) {
+        const double distance = glm::length(cameraPos - corners[i]);
+        if (distance < glm::length(cameraPos - objectPos)) {
+            objectPos = corners[i];
+        }
+    }
+
+    const double objectP = pow(length(objectPos - globePos), 2);
+    const double horizonP = pow(minimumGlobeRadius - maxHeight, 2);
+    if (objectP < horizonP) {
+        return false;
+    }
+
+    const double cameraP = pow(length(cameraPos - globePos), 2);
+    const double minR = pow(minimumGlobeRadius, 2);
+    if (cameraP < minR) {
+        return false;
+    }
+
+    const double minimumAllowedDistanceToObjectFromHorizon = sqrt(objectP - horizonP);
+    const double distanceToHorizon = sqrt(cameraP - minR);
+
+    // Minimum allowed for the object to be occluded
+    const double minimumAllowedDistanceToObjectSquared =
+        pow(distanceToHorizon + minimumAllowedDistanceToObjectFromHorizon, 2) +
+        pow(maxHeight, 2);
+
+    const double distanceToObjectSquared = pow(
+        length(objectPos - cameraPos),
+        2
+    );
+    return distanceToObjectSquared > minimumAllowedDistanceToObjectSquared;
+}
+
+int desiredLevelByDistance(const Chunk& chunk, const BoundingHeights& heights,
+                           const ChunkEvaluationContext& context)
+{
+    ZoneScoped;
+
+    const Ellipsoid& ellipsoid = *context.ellipsoid;
+    const Geodetic2 pointOnPatch =
+        chunk.surfacePatch.closestPoint(context.cameraGeodetic);
+    const glm::dvec3 patchNormal = ellipsoid.geodeticSurfaceNormal(pointOnPatch);
+    glm::dvec3 patchPosition = ellipsoid.cartesianSurfacePosition(pointOnPatch);
+
+    const double heightToChunk = heights.min;
+
+    // Offset position according to height
+    patchPosition += patchNormal * heightToChunk;
+
+    const glm::dvec3 cameraToChunk = patchPosition - context.cameraPosition;
+
+    // Calculate desired level based on distance
+    const double distanceToPatch = glm::length(cameraToChunk);
+    const double distance = distanceToPatch;
+
+    const double scaleFactor = context.lodScaleFactor * ellipsoid.minimumRadius();
+    const double projectedScaleFactor = scaleFactor / distance;
+    const int desiredLevel = static_cast<int>(ceil(log2(projectedScaleFactor)));
+    return desiredLevel;
+}
+
+int desiredLevelByProjectedArea(const Chunk& chunk, const BoundingHeights& heights,
+                                const ChunkEvaluationContext& context)
+{
+    ZoneScoped;
+
+    const Ellipsoid& ellipsoid = *context.ellipsoid;
+
+    // Approach:
+    // The projected area of the chunk will be calculated based on a small area that
+    // is close to the camera, and the scaled up to represent the full area.
+    // The advantage of doing this is that it will better handle the cases where the
+    // full patch is very curved (e.g. stretches from latitude 0 to 90 deg).
+
+    const Geodetic2 closestCorner =
+        chunk.surfacePatch.closestCorner(context.cameraGeodetic);
+
+    //  Camera
+    //  |
+    //  V
+    //
+    //  oo
+    // [  ]<
+    //                     *geodetic space*
+    //
+    //   closestCorner
+    //    +-----------------+  <-- north east corner
+    //    |                 |
+    //    |      center     |
+    //    |                 |
+    //    +-----------------+  <-- south east corner
+
+    const Geodetic2 center = chunk.surfacePatch.center();
+    const Geodetic3 c = { center, heights.min };
+    const Geodetic3 c1 = { Geodetic2{ center.lat, closestCorner.lon }, heights.min };
+    const Geodetic3 c2 = { Geodetic2{ closestCorner.lat, center.lon }, heights.min };
+
+    //  Camera
+    //  |
+    //  V
+    //
+    //  oo
+    // [  ]<
+    //                     *geodetic space*
+    //
+    //    +--------c2-------+  <-- north east corner
+    //    |                 |
+    //    c1       c        |
+    //    |                 |
+    //    +-----------------+  <-- south east corner
+
+
+    // Go from geodetic to cartesian space and project onto unit sphere
+    const glm::dvec3 camToCenter = -context.cameraPosition;
+    const glm::dvec3 A = glm::normalize(camToCenter + ellipsoid.cartesianPosition(c));
+    const glm::dvec3 B = glm::normalize(camToCenter + ellipsoid.cartesianPosition(c1));
+    const glm::dvec3 C = glm::normalize(camToCenter + ellipsoid.cartesianPosition(c2));
+
+    // Camera                      *cartesian space*
+    // |                    +--------+---+
+    // V             __--''   __--''    /
+    //              C-------A--------- +
+    // oo          /       /          /
+    //[  ]<       +-------B----------+
+    //
+
+    // If the geodetic patch is small (i.e. has small width), that means the patch in
+    // cartesian space will be almost flat, and in turn, the triangle ABC will roughly
+    // correspond to 1/8 of the full area
+    const glm::dvec3 AB = B - A;
+    const glm::dvec3 AC = C - A;
+    const double areaABC = 0.5 * glm::length(glm::cross(AC, AB));
+    const double projectedChunkAreaApprox = 8 * areaABC;
+
+    const double scaledArea = context.lodScaleFactor * projectedChunkAreaApprox;
+    return chunk.tileIndex.level + static_cast<int>(round(scaledArea - 1));
+}
+
+ChunkEvaluation evaluateChunk(const Chunk& chunk, const BoundingHeights& heights,
+                              const ChunkEvaluationContext& context)
+{
+    ghoul_assert(context.ellipsoid, "No ellipsoid provided");
+
+    const bool isCullable =
+        (context.performHorizonCulling && isCullableByHorizon(chunk, heights, context)) ||
+        (context.performFrustumCulling &&
+            isCullableByFrustum(chunk, context.modelViewProjection));
+
+    return {
+        .isVisible = !isCullable,
+        .desiredLevel = context.levelByProjectedArea ?
+            desiredLevelByProjectedArea(chunk, heights, context) :
+            desiredLevelByDistance(chunk, heights, context)
+    };
+}
+
+void evaluateChunks(std::span<const Chunk* const> chunks,
+                    std::span<const BoundingHeights> heights,
+                    const ChunkEvaluationContext& context,
+                    std::span<ChunkEvaluation> results, TaskScheduler* scheduler)
+{
+    ZoneScoped;
+    ghoul_assert(chunks.size() == heights.size(), "Need one bounding height per chunk");
+    ghoul_assert(chunks.size() == results.size(), "Need one result per chunk");
+
+    auto evaluateRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            results[i] = evaluateChunk(*chunks[i], heights[i], context);
+        }
+    };
+
+    if (scheduler) {
+        scheduler->parallelFor(chunks.size(), MinChunksPerBatch, evaluateRange);
+    }
+    else {
+        evaluateRange(0, chunks.size());
+    }
+}
+
+} // namespace openspace::globebrowsing
@@ -0,0 +1,123 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___CHUNKEVALUATION___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___CHUNKEVALUATION___H__
+
+#include <modules/globebrowsing/src/basictypes.h>
+#include <modules/globebrowsing/src/chunk.h>
+#include <ghoul/glm.h>
+#include <span>
+
+namespace openspace { class TaskScheduler; }
+
+namespace openspace::globebrowsing {
+
+class Ellipsoid;
+
+/**
+ * The state of the current frame that the visibility and the desired level of the chunks
+ * of a globe depend on. All positions are in the model space of the globe.
+ */
+struct ChunkEvaluationContext {
+    const Ellipsoid* ellipsoid = nullptr;
+    glm::dvec3 cameraPosition = glm::dvec3(0.0);
+    /// The camera position projected onto the ellipsoid. It is the same for all chunks
+    /// and has to be provided as `ellipsoid->cartesianToGeodetic2(cameraPosition)`
+    Geodetic2 cameraGeodetic;
+    glm::dmat4 modelViewProjection = glm::dmat4(1.0);
+    double lodScaleFactor = 1.0;
+    bool levelByProjectedArea = true;
+    bool performHorizonCulling = true;
+    bool performFrustumCulling = true;
+};
+
+/**
+ * The result of the evaluation of a single chunk.
+ */
+struct ChunkEvaluation {
+    bool isVisible = true;
+    /// The level that the chunk should have based on its size on screen, without any
+    /// limits applied to it
+    int desiredLevel = 0;
+};
+
+/**
+ * Returns `true` if the bounding box of the \p chunk lies completely outside of the view
+ * frustum described by the \p modelViewProjection matrix.
+ */
+bool isCullableByFrustum(const Chunk& chunk, const glm::dmat4& modelViewProjection);
+
+/**
+ * Returns `true` if the \p chunk, raised by the maximum of its bounding \p heights, is
+ * hidden behind the horizon of the globe as seen from the camera.
+ */
+bool isCullableByHorizon(const Chunk& chunk, const BoundingHeights& heights,
+    const ChunkEvaluationContext& context);
+
+/**
+ * Returns the desired level of the \p chunk based on the distance between the camera and
+ * the closest point of the chunk.
+ */
+int desiredLevelByDistance(const Chunk& chunk, const BoundingHeights& heights,
+    const ChunkEvaluationContext& context);
+
+/**
+ * Returns the desired level of the \p chunk based on the area that it approximately
+ * covers when projected onto a unit sphere around the camera.
+ */
+int desiredLevelByProjectedArea(const Chunk& chunk, const BoundingHeights& heights,
+    const ChunkEvaluationContext& context);
+
+/**
+ * Determines the visibility and the desired level of the \p chunk. This function only
+ * depends on its parameters and is safe to call from multiple threads concurrently.
+ */
+ChunkEvaluation evaluateChunk(const Chunk& chunk, const BoundingHeights& heights,
+    const ChunkEvaluationContext& context);
+
+/**
+ * Evaluates each of the \p chunks with the bounding \p heights at the same index and
+ * stores the results in \p results. If a \p scheduler is provided and there are enough
+ * chunks, the chunks are split into batches that are evaluated on its worker threads
+ * and the calling thread concurrently. This function returns once all chunks have been
+ * evaluated.
+ *
+ * \param chunks The chunks that are evaluated, usually all chunks of a chunk tree
+ * \param heights The bounding heights of the \p chunks, which have to be gathered
+ *        beforehand as they depend on the tile providers, which are not thread-safe
+ * \param context The state of the frame that is shared by all chunks
+ * \param results The destination of the evaluations, which has to have the same size as
+ *        \p chunks
+ * \param scheduler The scheduler whose worker threads are used. If it is `nullptr`, all
+ *        chunks are evaluated on the calling thread
+ */
+void evaluateChunks(std::span<const Chunk* const> chunks,
+    std::span<const BoundingHeights> heights, const ChunkEvaluationContext& context,
+    std::span<ChunkEvaluation> results, TaskScheduler* scheduler = nullptr);
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___CHUNKEVALUATION___H__
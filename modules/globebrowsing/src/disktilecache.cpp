@@ -0,0 +1,426 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/disktilecache.h>
+
+#include <modules/globebrowsing/src/lz4block.h>
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+    constexpr std::string_view _loggerCat = "DiskTileCache";
+
+    constexpr uint32_t RecordMagic = 0x4C495444; // 'DTIL'
+    constexpr uint32_t FlagCompressed = 1;
+
+    constexpr uint64_t MinSegmentSize = 1ULL << 20;
+    constexpr uint64_t MaxSegmentSize = 64ULL << 20;
+
+    // Header that precedes every tile in a segment file. All members are naturally
+    // aligned so that the struct can be written and read as a whole
+    struct RecordHeader {
+        uint32_t magic = RecordMagic;
+        uint32_t flags = 0;
+        uint64_t source = 0;
+        uint64_t initDataHash = 0;
+        uint32_t storedSize = 0;
+        uint32_t rawSize = 0;
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t level = 0;
+        uint32_t nValues = 0;
+        std::array<float, 4> maxValues = {};
+        std::array<float, 4> minValues = {};
+        std::array<uint8_t, 4> hasMissingData = {};
+        uint32_t padding = 0;
+    };
+    static_assert(sizeof(RecordHeader) == 88);
+
+    uint64_t segmentSize(uint64_t budget) {
+        return std::clamp(budget / 8, MinSegmentSize, MaxSegmentSize);
+    }
+
+    std::optional<uint32_t> segmentId(const std::filesystem::path& path) {
+        const std::string name = path.filename().string();
+        if (!name.starts_with("segment_") || path.extension() != ".bin") {
+            return std::nullopt;
+        }
+        try {
+            return static_cast<uint32_t>(std::stoul(name.substr(8)));
+        }
+        catch (const std::logic_error&) {
+            return std::nullopt;
+        }
+    }
+} // namespace
+
+namespace openspace::globebrowsing::cache {
+
+DiskTileCache::DiskTileCache(std::filesystem::path directory, uint64_t budget,
+                             bool compress)
+    : _directory(std::move(directory))
+    , _budget(budget)
+    , _compress(compress)
+{
+    ZoneScoped;
+
+    std::filesystem::create_directories(_directory);
+
+    std::lock_guard lock(_mutex);
+    scanSegments();
+    openNewSegment();
+    evictSegments();
+}
+
+DiskTileCache::~DiskTileCache() {
+    std::lock_guard lock(_mutex);
+    _activeFile.close();
+}
+
+uint64_t DiskTileCache::sourceHash(std::string_view identity) {
+    // 64-bit FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (const char c : identity) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+std::optional<RawTile> DiskTileCache::get(const DiskTileKey& key,
+                                          const TileTextureInitData& initData)
+{
+    ZoneScoped;
+
+    Entry entry;
+    {
+        std::lock_guard lock(_mutex);
+        auto it = _index.find(key);
+        if (it == _index.end()) {
+            return std::nullopt;
+        }
+        entry = it->second;
+        _segments[entry.segment].lastUsed = ++_useCounter;
+    }
+
+    // The segment might get evicted while we are reading it, in which case the read
+    // fails and the tile is treated as a miss
+    std::ifstream file(segmentPath(entry.segment), std::ios::binary);
+    if (!file.seekg(entry.offset)) {
+        return std::nullopt;
+    }
+    std::vector<char> buffer(entry.size);
+    if (!file.read(buffer.data(), entry.size)) {
+        return std::nullopt;
+    }
+
+    RecordHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(RecordHeader));
+    const bool isValid =
+        header.magic == RecordMagic && header.source == key.source &&
+        header.x == key.tileIndex.x && header.y == key.tileIndex.y &&
+        header.level == key.tileIndex.level &&
+        header.initDataHash == initData.hashKey &&
+        header.rawSize == initData.totalNumBytes &&
+        sizeof(RecordHeader) + header.storedSize == entry.size;
+    if (!isValid) {
+        return std::nullopt;
+    }
+
+    RawTile rawTile;
+    rawTile.imageData = std::unique_ptr<std::byte[]>(new std::byte[header.rawSize]);
+    const std::byte* payload =
+        reinterpret_cast<const std::byte*>(buffer.data()) + sizeof(RecordHeader);
+    if (header.flags & FlagCompressed) {
+        const bool success = lz4::decompress(
+            payload,
+            header.storedSize,
+            rawTile.imageData.get(),
+            header.rawSize
+        );
+        if (!success) {
+            LWARNING(std::format("Corrupt tile in segment {}", entry.segment));
+            return std::nullopt;
+        }
+    }
+    else {
+        if (header.storedSize != header.rawSize) {
+            return std::nullopt;
+        }
+        std::memcpy(rawTile.imageData.get(), payload, header.rawSize);
+    }
+
+    rawTile.tileMetaData.maxValues = header.maxValues;
+    rawTile.tileMetaData.minValues = header.minValues;
+    for (size_t i = 0; i < 4; i++) {
+        rawTile.tileMetaData.hasMissingData[i] = header.hasMissingData[i] != 0;
+    }
+    rawTile.tileMetaData.nValues = static_cast<uint8_t>(header.nValues);
+    rawTile.textureInitData = initData;
+    rawTile.tileIndex = key.tileIndex;
+    rawTile.error = RawTile::ReadError::None;
+    return rawTile;
+}
+
+void DiskTileCache::put(const DiskTileKey& key, const RawTile& rawTile) {
+    ZoneScoped;
+
+    if (rawTile.error != RawTile::ReadError::None || !rawTile.imageData ||
+        !rawTile.textureInitData.has_value() || exist(key))
+    {
+        return;
+    }
+
+    const size_t rawSize = rawTile.textureInitData->totalNumBytes;
+    if (rawSize > std::numeric_limits<uint32_t>::max()) {
+        return;
+    }
+
+    RecordHeader header;
+    header.source = key.source;
+    header.initDataHash = rawTile.textureInitData->hashKey;
+    header.rawSize = static_cast<uint32_t>(rawSize);
+    header.x = key.tileIndex.x;
+    header.y = key.tileIndex.y;
+    header.level = key.tileIndex.level;
+    header.nValues = rawTile.tileMetaData.nValues;
+    header.maxValues = rawTile.tileMetaData.maxValues;
+    header.minValues = rawTile.tileMetaData.minValues;
+    for (size_t i = 0; i < 4; i++) {
+        header.hasMissingData[i] = rawTile.tileMetaData.hasMissingData[i] ? 1 : 0;
+    }
+
+    // Compress outside of the lock, the write itself is only a single append
+    std::vector<std::byte> record(sizeof(RecordHeader) + lz4::compressBound(rawSize));
+    std::byte* payload = record.data() + sizeof(RecordHeader);
+    size_t storedSize = 0;
+    if (_compress) {
+        // Only keep the compressed version if it actually saves space
+        storedSize = lz4::compress(rawTile.imageData.get(), rawSize, payload, rawSize);
+        if (storedSize > 0) {
+            header.flags |= FlagCompressed;
+        }
+    }
+    if (storedSize == 0) {
+        std::memcpy(payload, rawTile.imageData.get(), rawSize);
+        storedSize = rawSize;
+    }
+    header.storedSize = static_cast<uint32_t>(storedSize);
+    std::memcpy(record.data(), &header, sizeof(RecordHeader));
+    const size_t recordSize = sizeof(RecordHeader) + storedSize;
+
+    std::lock_guard lock(_mutex);
+    if (_index.contains(key) || !_activeFile.is_open()) {
+        return;
+    }
+
+    Segment& segment = _segments[_activeSegment];
+    const uint64_t offset = segment.size;
+    _activeFile.write(reinterpret_cast<const char*>(record.data()), recordSize);
+    // Flush right away so that readers on other threads see the complete record
+    _activeFile.flush();
+    if (!_activeFile) {
+        LWARNING(std::format(
+            "Could not write to '{}'", segmentPath(_activeSegment)
+        ));
+        openNewSegment();
+        return;
+    }
+
+    _index[key] = {
+        .segment = _activeSegment,
+        .offset = offset,
+        .size = static_cast<uint32_t>(recordSize)
+    };
+    segment.size += recordSize;
+    segment.lastUsed = ++_useCounter;
+    _totalSize += recordSize;
+
+    if (segment.size >= segmentSize(_budget)) {
+        openNewSegment();
+    }
+    evictSegments();
+}
+
+bool DiskTileCache::exist(const DiskTileKey& key) const {
+    std::lock_guard lock(_mutex);
+    return _index.contains(key);
+}
+
+void DiskTileCache::clear() {
+    ZoneScoped;
+
+    std::lock_guard lock(_mutex);
+    _activeFile.close();
+    for (const std::pair<const uint32_t, Segment>& p : _segments) {
+        std::error_code ec;
+        std::filesystem::remove(segmentPath(p.first), ec);
+    }
+    _segments.clear();
+    _index.clear();
+    _totalSize = 0;
+    openNewSegment();
+}
+
+void DiskTileCache::setBudget(uint64_t budget) {
+    _budget = budget;
+    std::lock_guard lock(_mutex);
+    evictSegments();
+}
+
+void DiskTileCache::setCompressionEnabled(bool enabled) {
+    _compress = enabled;
+}
+
+uint64_t DiskTileCache::sizeOnDisk() const {
+    std::lock_guard lock(_mutex);
+    return _totalSize;
+}
+
+size_t DiskTileCache::numTiles() const {
+    std::lock_guard lock(_mutex);
+    return _index.size();
+}
+
+std::filesystem::path DiskTileCache::segmentPath(uint32_t segment) const {
+    return _directory / std::format("segment_{:06}.bin", segment);
+}
+
+void DiskTileCache::scanSegments() {
+    ZoneScoped;
+
+    std::vector<uint32_t> ids;
+    for (const std::filesystem::directory_entry& e :
+         std::filesystem::directory_iterator(_directory))
+    {
+        if (!e.is_regular_file()) {
+            continue;
+        }
+        const std::optional<uint32_t> id = segmentId(e.path());
+        if (id.has_value()) {
+            ids.push_back(*id);
+        }
+    }
+    // Older segments are considered to be less recently used
+    std::sort(ids.begin(), ids.end());
+
+    for (const uint32_t id : ids) {
+        const std::filesystem::path path = segmentPath(id);
+        const uint64_t fileSize = std::filesystem::file_size(path);
+        if (fileSize == 0) {
+            // Left behind by a session that did not write any tiles
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+            continue;
+        }
+
+        // Records are appended, so a crash can at most leave a partial record at the
+        // end of a segment. Stop at the first record that is not complete
+        std::ifstream file(path, std::ios::binary);
+        uint64_t offset = 0;
+        RecordHeader header;
+        while (offset + sizeof(RecordHeader) <= fileSize &&
+               file.read(reinterpret_cast<char*>(&header), sizeof(RecordHeader)))
+        {
+            const uint64_t size = sizeof(RecordHeader) + header.storedSize;
+            if (header.magic != RecordMagic || offset + size > fileSize) {
+                break;
+            }
+
+            const DiskTileKey key = {
+                .source = header.source,
+                .tileIndex = TileIndex(
+                    header.x,
+                    header.y,
+                    static_cast<uint8_t>(header.level)
+                )
+            };
+            _index[key] = {
+                .segment = id,
+                .offset = offset,
+                .size = static_cast<uint32_t>(size)
+            };
+            offset += size;
+            file.seekg(offset);
+        }
+
+        Segment& segment = _segments[id];
+        segment.size = fileSize;
+        segment.lastUsed = ++_useCounter;
+        _totalSize += fileSize;
+    }
+
+    if (!_index.empty()) {
+        LINFO(std::format(
+            "Found {} tiles ({} MB) in '{}'",
+            _index.size(), _totalSize / (1024 * 1024), _directory
+        ));
+    }
+}
+
+void DiskTileCache::openNewSegment() {
+    _activeFile.close();
+    _activeSegment = _segments.empty() ? 0 : _segments.rbegin()->first + 1;
+    _activeFile.open(segmentPath(_activeSegment), std::ios::binary | std::ios::trunc);
+    if (!_activeFile.is_open()) {
+        LERROR(std::format(
+            "Could not create tile cache segment '{}'", segmentPath(_activeSegment)
+        ));
+        return;
+    }
+    _segments[_activeSegment].lastUsed = ++_useCounter;
+}
+
+void DiskTileCache::evictSegments() {
+    while (_totalSize > _budget && _segments.size() > 1) {
+        // Find the least recently used segment that is not currently being written to
+        auto lru = _segments.end();
+        for (auto it = _segments.begin(); it != _segments.end(); it++) {
+            if (it->first == _activeSegment) {
+                continue;
+            }
+            if (lru == _segments.end() || it->second.lastUsed < lru->second.lastUsed) {
+                lru = it;
+            }
+        }
+        if (lru == _segments.end()) {
+            break;
+        }
+
+        const uint32_t id = lru->first;
+        std::erase_if(_index, [id](const auto& p) { return p.second.segment == id; });
+        _totalSize -= lru->second.size;
+        _segments.erase(lru);
+
+        std::error_code ec;
+        std::filesystem::remove(segmentPath(id), ec);
+    }
+}
+
+} // namespace openspace::globebrowsing::cache
@@ -0,0 +1,162 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
+
+#include <modules/globebrowsing/src/rawtile.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+namespace openspace::globebrowsing {
+    class TileTextureInitData;
+} // namespace openspace::globebrowsing
+
+namespace openspace::globebrowsing::cache {
+
+/**
+ * Identifies a tile on disk. Contrary to the ProviderTileKey used by the
+ * MemoryAwareTileCache, the \c source has to be stable between runs, so it is a hash of
+ * everything that influences the decoded pixels of a tile provider (see #sourceHash).
+ */
+struct DiskTileKey {
+    uint64_t source;
+    TileIndex tileIndex;
+
+    bool operator==(const DiskTileKey& r) const {
+        return (source == r.source) && (tileIndex == r.tileIndex);
+    }
+};
+
+struct DiskTileHasher {
+    size_t operator()(const DiskTileKey& k) const {
+        const uint64_t index = k.tileIndex.hashKey() * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(k.source ^ index);
+    }
+};
+
+/**
+ * A persistent cache of decoded RawTile data that sits beneath the MemoryAwareTileCache.
+ * Tiles that are evicted from RAM or that were loaded in a previous session can be
+ * served from here without going through GDAL again.
+ *
+ * The tiles are appended to a sequence of segment files in the cache directory, each
+ * record consisting of a fixed size header followed by the (optionally LZ4 compressed)
+ * pixel data. The index of which tile lives where is only kept in memory and is rebuilt
+ * by scanning the segments on startup. Eviction happens one segment at a time, removing
+ * the least recently used segment whenever the total size exceeds the budget.
+ *
+ * All public functions are thread-safe and can be called from the tile loading threads.
+ */
+class DiskTileCache {
+public:
+    /**
+     * Opens or creates a disk cache in the \p directory, rebuilding the index from any
+     * segments that were written previously.
+     *
+     * \param directory The folder in which the segment files are stored
+     * \param budget The maximum number of bytes that all segments together should use
+     * \param compress Whether new tiles should be compressed before they are written
+     */
+    DiskTileCache(std::filesystem::path directory, uint64_t budget, bool compress);
+    ~DiskTileCache();
+
+    /**
+     * Computes a hash of the \p identity that is stable across different runs and
+     * platforms and can be used as the DiskTileKey::source.
+     */
+    static uint64_t sourceHash(std::string_view identity);
+
+    /**
+     * Returns the tile for the \p key if it exists on disk and matches the \p initData.
+     * The returned RawTile has its imageData allocated on the CPU.
+     */
+    std::optional<RawTile> get(const DiskTileKey& key,
+        const TileTextureInitData& initData);
+
+    /**
+     * Stores the \p rawTile under the \p key. Tiles that failed to load or that do not
+     * have texture information are ignored, as are tiles that already exist.
+     */
+    void put(const DiskTileKey& key, const RawTile& rawTile);
+
+    bool exist(const DiskTileKey& key) const;
+
+    /**
+     * Removes all segments and starts with an empty cache.
+     */
+    void clear();
+
+    void setBudget(uint64_t budget);
+    void setCompressionEnabled(bool enabled);
+
+    /// The number of bytes currently used by all segments on disk
+    uint64_t sizeOnDisk() const;
+
+    /// The number of tiles in the cache
+    size_t numTiles() const;
+
+private:
+    struct Entry {
+        uint32_t segment;
+        uint64_t offset;
+        uint32_t size;
+    };
+
+    struct Segment {
+        uint64_t size = 0;
+        uint64_t lastUsed = 0;
+    };
+
+    std::filesystem::path segmentPath(uint32_t segment) const;
+
+    void scanSegments();
+    void openNewSegment();
+    void evictSegments();
+
+    const std::filesystem::path _directory;
+    std::atomic<uint64_t> _budget;
+    std::atomic_bool _compress;
+
+    mutable std::mutex _mutex;
+    std::unordered_map<DiskTileKey, Entry, DiskTileHasher> _index;
+    std::map<uint32_t, Segment> _segments;
+    uint64_t _totalSize = 0;
+    uint64_t _useCounter = 0;
+
+    uint32_t _activeSegment = 0;
+    std::ofstream _activeFile;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_CACHE___H__
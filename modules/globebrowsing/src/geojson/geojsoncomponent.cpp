@@ -24,10 +24,14 @@
 
 #include <modules/globebrowsing/src/geojson/geojsoncomponent.h>
 
+#include <modules/globebrowsing/globebrowsingmodule.h>
+#include <modules/globebrowsing/src/geodeticpatch.h>
 #include <modules/globebrowsing/src/geojson/globegeometryhelper.h>
+#include <modules/globebrowsing/src/memoryawaretilecache.h>
 #include <modules/globebrowsing/src/renderableglobe.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
 #include <openspace/json.h>
 #include <openspace/query/query.h>
 #include <openspace/rendering/renderengine.h>
@@ -41,6 +45,7 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/openglstatecache.h>
 #include <ghoul/opengl/programobject.h>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <functional>
@@ -50,6 +55,7 @@ namespace geos_nlohmann = nlohmann;
 #include <geos/geom/Geometry.h>
 #include <geos/io/GeoJSON.h>
 #include <geos/io/GeoJSONReader.h>
+#include <geos/util/GEOSException.h>
 
 namespace {
     constexpr std::string_view _loggerCat = "GeoJsonComponent";
@@ -115,6 +121,26 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo UseVectorTilesInfo = {
+        "UseVectorTiles",
+        "Use Vector Tiles",
+        "If true, the lines and polygons are cut into tiles that follow the level of "
+        "detail of the globe, instead of being created for the whole globe when the "
+        "file is loaded. The tiles are simplified to the resolution of their level and "
+        "are created in the background once they become visible, which is recommended "
+        "for large files. This value can only be set when the layer is created",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo VectorTileMaxLevelInfo = {
+        "VectorTileMaxLevel",
+        "Vector Tile Max Level",
+        "The highest level of the vector tiles. Parts of the globe with a finer level of "
+        "detail use the tiles of this level, which are simplified the least. Only used "
+        "if vector tiles are enabled",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
     constexpr openspace::properties::Property::PropertyInfo PointRenderModeInfo = {
         "PointRenderMode",
         "Points Aligned to",
@@ -199,6 +225,12 @@ namespace {
         // [[codegen::verbatim(PreventHeightUpdateInfo.description)]]
         std::optional<bool> preventHeightUpdate;
 
+        // [[codegen::verbatim(UseVectorTilesInfo.description)]]
+        std::optional<bool> useVectorTiles;
+
+        // [[codegen::verbatim(VectorTileMaxLevelInfo.description)]]
+        std::optional<int> vectorTileMaxLevel [[codegen::inrange(1, 22)]];
+
         // [[codegen::verbatim(FileInfo.description)]]
         std::filesystem::path file;
 
@@ -306,6 +338,8 @@ GeoJsonComponent::GeoJsonComponent(const ghoul::Dictionary& dictionary,
     , _drawWireframe(DrawWireframeInfo, false)
     , _preventUpdatesFromHeightMap(PreventHeightUpdateInfo, false)
     , _forceUpdateHeightData(ForceUpdateHeightDataInfo)
+    , _useVectorTiles(UseVectorTilesInfo, false)
+    , _vectorTileMaxLevel(VectorTileMaxLevelInfo, 12, 1, 22)
     , _globeNode(globe)
     , _centerLatLong(
         CentroidCoordinateInfo,
@@ -396,6 +430,18 @@ GeoJsonComponent::GeoJsonComponent(const ghoul::Dictionary& dictionary,
     _drawWireframe = p.drawWireframe.value_or(_drawWireframe);
     addProperty(_drawWireframe);
 
+    _useVectorTiles = p.useVectorTiles.value_or(_useVectorTiles);
+    _useVectorTiles.setReadOnly(true);
+    addProperty(_useVectorTiles);
+
+    _vectorTileMaxLevel = p.vectorTileMaxLevel.value_or(_vectorTileMaxLevel);
+    _vectorTileMaxLevel.onChange([this]() {
+        if (_vectorTiles) {
+            _vectorTiles->setSettings({ .maxLevel = _vectorTileMaxLevel });
+        }
+    });
+    addProperty(_vectorTileMaxLevel);
+
     using PointRenderMode = GlobeGeometryFeature::PointRenderMode;
     _pointRenderModeOption.addOptions({
         { static_cast<int>(PointRenderMode::AlignToCameraDir), "Camera Direction"},
@@ -423,6 +469,10 @@ GeoJsonComponent::GeoJsonComponent(const ghoul::Dictionary& dictionary,
 
     readFile();
 
+    if (_useVectorTiles) {
+        createVectorTileEngine();
+    }
+
     if (p.lightSources.has_value()) {
         const std::vector<ghoul::Dictionary> lightsources = *p.lightSources;
 
@@ -485,6 +535,10 @@ void GeoJsonComponent::initializeGL() {
 }
 
 void GeoJsonComponent::deinitializeGL() {
+    if (_vectorTiles) {
+        _vectorTiles->clear();
+    }
+
     for (GlobeGeometryFeature& g : _geometryFeatures) {
         g.deinitializeGL();
     }
@@ -532,7 +586,10 @@ void GeoJsonComponent::render(const RenderData& data) {
         _pointSizeScale,
         _lineWidthScale,
         pointRenderMode,
-        _lightsourceRenderData
+        _lightsourceRenderData,
+        _vectorTiles ?
+            std::span<const TileIndex>(_vectorTiles->renderTiles()) :
+            std::span<const TileIndex>()
     };
 
     // Do two render passes, to properly render opacity of overlaying objects
@@ -586,10 +643,102 @@ void GeoJsonComponent::update() {
         g.update(_dataIsDirty, _preventUpdatesFromHeightMap);
     }
 
+    if (_vectorTiles) {
+        if (_dataIsDirty) {
+            updateVectorTileBuildFunction();
+        }
+        updateVectorTiles();
+    }
+
     _textureIsDirty = false;
     _dataIsDirty = false;
 }
 
+void GeoJsonComponent::createVectorTileEngine() {
+    GlobeBrowsingModule* module = global::moduleEngine->module<GlobeBrowsingModule>();
+    _vectorTiles = std::make_unique<VectorTileEngine<VectorTile>>(
+        *module->vectorTileScheduler(),
+        VectorTileEngine<VectorTile>::Settings{ .maxLevel = _vectorTileMaxLevel },
+        [this](const TileIndex& tileIndex) {
+            const GeodeticPatch patch = GeodeticPatch(tileIndex);
+            const glm::vec2 offset = _latLongOffset;
+            return std::any_of(
+                _geometryFeatures.begin(),
+                _geometryFeatures.end(),
+                [&patch, &offset](const GlobeGeometryFeature& f) {
+                    return f.usesVectorTiles() && f.intersects(patch, offset);
+                }
+            );
+        },
+        [this](const TileIndex& tileIndex, VectorTile tile) {
+            for (const auto& [index, vertices] : tile) {
+                _geometryFeatures[index].addTile(tileIndex, vertices);
+            }
+        },
+        [this](const TileIndex& tileIndex) {
+            for (GlobeGeometryFeature& f : _geometryFeatures) {
+                f.removeTile(tileIndex);
+            }
+        }
+    );
+}
+
+void GeoJsonComponent::updateVectorTileBuildFunction() {
+    // The settings are copied, as the tiles are built on worker threads while the
+    // properties might change
+    const glm::vec3 offsets = glm::vec3(_latLongOffset.value(), _heightOffset);
+    std::vector<GlobeGeometryFeature::VertexSettings> settings;
+    settings.reserve(_geometryFeatures.size());
+    for (const GlobeGeometryFeature& f : _geometryFeatures) {
+        GlobeGeometryFeature::VertexSettings s = f.vertexSettings();
+        s.offsets = offsets;
+        settings.push_back(s);
+    }
+
+    _vectorTiles->setBuildFunction(
+        [this, settings = std::move(settings)](const TileIndex& tileIndex) {
+            const GeodeticPatch patch = GeodeticPatch(tileIndex);
+            VectorTile tile;
+            for (size_t i = 0; i < _geometryFeatures.size(); i++) {
+                const GlobeGeometryFeature& f = _geometryFeatures[i];
+                const glm::vec2 offset = glm::vec2(settings[i].offsets);
+                if (!f.usesVectorTiles() || !f.intersects(patch, offset)) {
+                    continue;
+                }
+
+                try {
+                    tile.emplace_back(i, f.createTileVertices(tileIndex, settings[i]));
+                }
+                catch (const geos::util::GEOSException& e) {
+                    LERROR(std::format(
+                        "Error creating vector tile {}, {}, {} of '{}' in GeoJson layer "
+                        "'{}': {}",
+                        tileIndex.x, tileIndex.y, tileIndex.level, f.key(), identifier(),
+                        e.what()
+                    ));
+                }
+            }
+            return tile;
+        }
+    );
+}
+
+void GeoJsonComponent::updateVectorTiles() {
+    ZoneScoped;
+
+    cache::MemoryAwareTileCache* tileCache =
+        global::moduleEngine->module<GlobeBrowsingModule>()->tileCache();
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    _vectorTiles->update(
+        _globeNode.renderedChunkTiles(),
+        tileCache->remainingUploadTime()
+    );
+    const std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    tileCache->addUsedUploadTime(elapsed.count());
+}
+
 void GeoJsonComponent::readFile() {
     std::ifstream file(_geoJsonFile);
 
@@ -673,7 +822,12 @@ void GeoJsonComponent::parseSingleFeature(const geos::io::GeoJSONFeature& featur
         const int index = static_cast<int>(_geometryFeatures.size());
         try {
             GlobeGeometryFeature g(_globeNode, _defaultProperties, propsFromFile);
-            g.createFromSingleGeosGeometry(geometry, index, _ignoreHeightsFromFile);
+            g.createFromSingleGeosGeometry(
+                geometry,
+                index,
+                _ignoreHeightsFromFile,
+                _useVectorTiles
+            );
             g.initializeGL(_pointsProgram.get(), _linesAndPolygonsProgram.get());
             _geometryFeatures.push_back(std::move(g));
 
@@ -31,9 +31,11 @@
 #include <modules/globebrowsing/src/basictypes.h>
 #include <modules/globebrowsing/src/geojson/geojsonproperties.h>
 #include <modules/globebrowsing/src/geojson/globegeometryfeature.h>
+#include <modules/globebrowsing/src/geojson/vectortileengine.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/selectionproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/triggerproperty.h>
@@ -42,7 +44,9 @@
 #include <openspace/rendering/helper.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/glm.h>
+#include <memory>
 #include <optional>
+#include <utility>
 #include <vector>
 
 namespace openspace {
@@ -97,9 +101,28 @@ private:
         float boundingBoxDiagonal = 0.f;
     };
 
+    /// The vertices of the features within a vector tile, by the index of the feature
+    using VectorTile = std::vector<
+        std::pair<size_t, std::vector<GlobeGeometryFeature::RenderFeatureVertices>>
+    >;
+
     void readFile();
     void parseSingleFeature(const geos::io::GeoJSONFeature& feature, int indexInFile);
 
+    void createVectorTileEngine();
+
+    /**
+     * Makes the vector tiles use the current values of the properties that affect the
+     * vertices, which rebuilds all tiles.
+     */
+    void updateVectorTileBuildFunction();
+
+    /**
+     * Requests and uploads the vector tiles that are needed for the chunks that the globe
+     * rendered, sharing the upload budget with the tile cache.
+     */
+    void updateVectorTiles();
+
     /**
      * Add meta properties to the feature, to allow things like flying to it, identifying
      * its location, etc.
@@ -135,6 +158,10 @@ private:
     properties::BoolProperty _preventUpdatesFromHeightMap;
     properties::TriggerProperty _forceUpdateHeightData;
 
+    properties::BoolProperty _useVectorTiles;
+    properties::IntProperty _vectorTileMaxLevel;
+    std::unique_ptr<VectorTileEngine<VectorTile>> _vectorTiles;
+
     RenderableGlobe& _globeNode;
 
     bool _ignoreHeightsFromFile = false;
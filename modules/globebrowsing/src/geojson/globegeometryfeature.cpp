@@ -25,6 +25,7 @@
 #include <modules/globebrowsing/src/geojson/globegeometryfeature.h>
 
 #include <modules/globebrowsing/globebrowsingmodule.h>
+#include <modules/globebrowsing/src/geodeticpatch.h>
 #include <modules/globebrowsing/src/geojson/globegeometryhelper.h>
 #include <modules/globebrowsing/src/renderableglobe.h>
 #include <openspace/documentation/documentation.h>
@@ -37,19 +38,58 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/profiling.h>
 #include <ghoul/opengl/openglstatecache.h>
 #include <ghoul/opengl/programobject.h>
+#include <geos/geom/Envelope.h>
+#include <geos/geom/GeometryFactory.h>
+#include <geos/geom/LineString.h>
+#include <geos/geom/LinearRing.h>
+#include <geos/geom/Polygon.h>
+#include <geos/simplify/DouglasPeuckerSimplifier.h>
 #include <geos/util/GEOSException.h>
 #include <geos/triangulate/polygon/ConstrainedDelaunayTriangulator.h>
 #include <geos/util/IllegalStateException.h>
 #include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 
 namespace {
     constexpr const char* _loggerCat = "GlobeGeometryFeature";
 
     constexpr std::chrono::milliseconds HeightUpdateInterval(10000);
+
+    // The number of samples along the side of a vector tile that the simplification
+    // tolerance is based on. Details smaller than one sample are removed, which is
+    // comparable to the resolution of the raster tiles
+    constexpr double VectorTileResolution = 512.0;
+
+    // Triangulates the polygon and returns the coordinates of the triangles, three
+    // coordinates per triangle
+    std::vector<openspace::globebrowsing::Geodetic3> triangulate(
+                                                             const geos::geom::Polygon* p)
+    {
+        using geos::triangulate::tri::Tri;
+
+        // Note that Constrained Delaunay triangulation supports polygons with holes :)
+        std::vector<geos::geom::Coordinate> triCoords;
+        geos::triangulate::tri::TriList<Tri> triangles;
+        using geos::triangulate::polygon::ConstrainedDelaunayTriangulator;
+        ConstrainedDelaunayTriangulator::triangulatePolygon(p, triangles);
+
+        triCoords.reserve(3 * triangles.size());
+
+        // Add three coordinates per triangle. Note flipped winding order (want counter
+        // clockwise, but GEOS provides clockwise)
+        for (const Tri* t : triangles) {
+            triCoords.push_back(t->getCoordinate(0));
+            triCoords.push_back(t->getCoordinate(2));
+            triCoords.push_back(t->getCoordinate(1));
+        }
+        return openspace::globebrowsing::geometryhelper::coordsToGeodetic(triCoords);
+    }
 } // namespace
 
 namespace openspace::globebrowsing {
@@ -91,10 +131,11 @@ void GlobeGeometryFeature::initializeGL(ghoul::opengl::ProgramObject* pointsProg
 }
 
 void GlobeGeometryFeature::deinitializeGL() {
-    for (const RenderFeature& r : _renderFeatures) {
-        glDeleteVertexArrays(1, &r.vaoId);
-        glDeleteBuffers(1, &r.vboId);
+    deleteBuffers(_renderFeatures);
+    for (const auto& [key, features] : _tileRenderFeatures) {
+        deleteBuffers(features);
     }
+    _tileRenderFeatures.clear();
 
     _pointTexture = nullptr;
 }
@@ -158,7 +199,8 @@ void GlobeGeometryFeature::updateTexture(bool isInitializeStep) {
 }
 
 void GlobeGeometryFeature::createFromSingleGeosGeometry(const geos::geom::Geometry* geo,
-                                                        int index, bool ignoreHeights)
+                                                        int index, bool ignoreHeights,
+                                                        bool useVectorTiles)
 {
     if (!geo) {
         throw std::logic_error("No geometry provided");
@@ -184,24 +226,11 @@ void GlobeGeometryFeature::createFromSingleGeosGeometry(const geos::geom::Geomet
             try {
                 const auto p = dynamic_cast<const geos::geom::Polygon*>(geo);
 
-                // Triangles
-                // Note that Constrained Delaunay triangulation supports polygons with
-                // holes :)
-                std::vector<geos::geom::Coordinate> triCoords;
-                TriList<Tri> triangles;
-                using geos::triangulate::polygon::ConstrainedDelaunayTriangulator;
-                ConstrainedDelaunayTriangulator::triangulatePolygon(p, triangles);
-
-                triCoords.reserve(3 * triangles.size());
-
-                // Add three coordinates per triangle. Note flipped winding order
-                // (want counter clockwise, but GEOS provides clockwise)
-                for (const Tri* t : triangles) {
-                    triCoords.push_back(t->getCoordinate(0));
-                    triCoords.push_back(t->getCoordinate(2));
-                    triCoords.push_back(t->getCoordinate(1));
+                // Triangles. With vector tiles, only the parts within each tile are
+                // triangulated once the tile is needed
+                if (!useVectorTiles) {
+                    _triangleCoordinates = triangulate(p);
                 }
-                _triangleCoordinates = geometryhelper::coordsToGeodetic(triCoords);
 
                 // Boundaries / Lines
 
@@ -263,6 +292,22 @@ void GlobeGeometryFeature::createFromSingleGeosGeometry(const geos::geom::Geomet
         }
     }
 
+    // Points are cheap to create and are never split into vector tiles
+    _usesVectorTiles = useVectorTiles && _type != GeometryType::Point;
+
+    // Compute the bounding box, used to find the vector tiles that contain the feature
+    constexpr double Max = std::numeric_limits<double>::max();
+    _boundsMin = Geodetic2{ Max, Max };
+    _boundsMax = Geodetic2{ -Max, -Max };
+    for (const std::vector<Geodetic3>& vec : _geoCoordinates) {
+        for (const Geodetic3& coord : vec) {
+            _boundsMin.lat = std::min(_boundsMin.lat, coord.geodetic2.lat);
+            _boundsMin.lon = std::min(_boundsMin.lon, coord.geodetic2.lon);
+            _boundsMax.lat = std::max(_boundsMax.lat, coord.geodetic2.lat);
+            _boundsMax.lon = std::max(_boundsMax.lon, coord.geodetic2.lon);
+        }
+    }
+
     // Compute reference positions to use for checking if height map changes
     geos::geom::Coordinate centroid;
     geo->getCentroid(centroid);
@@ -311,16 +356,16 @@ void GlobeGeometryFeature::render(const RenderData& renderData, int pass,
     glLineWidth(1.f);
 #endif
 
-    for (const RenderFeature& r : _renderFeatures) {
+    const auto renderFeature = [&](const RenderFeature& r) {
         if (r.isExtrusionFeature && !_properties.extrude()) {
-            continue;
+            return;
         }
 
         const bool shouldRenderTwice = r.type == RenderType::Polygon &&
             fillOpacity < 1.f && _properties.extrude();
 
         if (pass > 0 && !shouldRenderTwice) {
-            continue;
+            return;
         }
 
         ghoul::opengl::ProgramObject* shader = (r.type == RenderType::Points) ?
@@ -369,6 +414,20 @@ void GlobeGeometryFeature::render(const RenderData& renderData, int pass,
         }
 
         shader->deactivate();
+    };
+
+    for (const RenderFeature& r : _renderFeatures) {
+        renderFeature(r);
+    }
+
+    for (const TileIndex& tileIndex : extraRenderData.vectorTiles) {
+        const auto it = _tileRenderFeatures.find(tileIndex.hashKey());
+        if (it == _tileRenderFeatures.end()) {
+            continue;
+        }
+        for (const RenderFeature& r : it->second) {
+            renderFeature(r);
+        }
     }
 
     glBindVertexArray(0);
@@ -529,13 +588,21 @@ void GlobeGeometryFeature::updateGeometry() {
     // Update vertex data and compute model coordinates based on globe
     _renderFeatures.clear();
 
+    std::vector<RenderFeatureVertices> features;
     if (_type == GeometryType::Point) {
-        createPointGeometry();
+        features = createPointGeometry(vertexSettings());
     }
-    else {
-        const std::vector<std::vector<glm::vec3>> edgeVertices = createLineGeometry();
-        createExtrudedGeometry(edgeVertices);
-        createPolygonGeometry();
+    else if (!_usesVectorTiles) {
+        features = createGeometryVertices(
+            _geoCoordinates,
+            _triangleCoordinates,
+            vertexSettings()
+        );
+    }
+
+    _renderFeatures.reserve(features.size());
+    for (const RenderFeatureVertices& f : features) {
+        _renderFeatures.push_back(createRenderFeature(f));
     }
 
     // Compute new heights - to see if height map changed
@@ -545,20 +612,187 @@ void GlobeGeometryFeature::updateGeometry() {
 void GlobeGeometryFeature::updateHeightsFromHeightMap() {
     // @TODO: do the updating piece by piece, not all in one frame
     for (RenderFeature& f : _renderFeatures) {
-        f.heights = geometryhelper::heightMapHeightsFromGeodetic2List(
-            _globe,
-            f.vertices
-        );
-        bufferDynamicHeightData(f);
+        updateHeights(f);
+    }
+    for (auto& [key, features] : _tileRenderFeatures) {
+        for (RenderFeature& f : features) {
+            updateHeights(f);
+        }
     }
 
     _lastHeightUpdateTime = std::chrono::system_clock::now();
 }
 
-std::vector<std::vector<glm::vec3>> GlobeGeometryFeature::createLineGeometry() {
-    std::vector<std::vector<glm::vec3>> resultPositions;
-    resultPositions.reserve(_geoCoordinates.size());
+bool GlobeGeometryFeature::usesVectorTiles() const {
+    return _usesVectorTiles;
+}
+
+GlobeGeometryFeature::VertexSettings GlobeGeometryFeature::vertexSettings() const {
+    return {
+        .offsets = _offsets,
+        .tessellationEnabled = _properties.tessellationEnabled(),
+        .tessellationStepSize = tessellationStepSize()
+    };
+}
+
+bool GlobeGeometryFeature::intersects(const GeodeticPatch& patch,
+                                      const glm::vec2& latLongOffset) const
+{
+    const double latOffset = glm::radians(static_cast<double>(latLongOffset.x));
+    const double lonOffset = glm::radians(static_cast<double>(latLongOffset.y));
+    return _boundsMin.lat + latOffset <= patch.maxLat() &&
+           _boundsMax.lat + latOffset >= patch.minLat() &&
+           _boundsMin.lon + lonOffset <= patch.maxLon() &&
+           _boundsMax.lon + lonOffset >= patch.minLon();
+}
+
+std::vector<GlobeGeometryFeature::RenderFeatureVertices>
+GlobeGeometryFeature::createTileVertices(const TileIndex& tileIndex,
+                                                     const VertexSettings& settings) const
+{
+    ZoneScoped;
+
+    // The extent of the tile in the coordinates of the file, which are in degrees and
+    // do not include the offset
+    const GeodeticPatch patch = GeodeticPatch(tileIndex);
+    const double minLat = glm::degrees(patch.minLat()) - settings.offsets.x;
+    const double maxLat = glm::degrees(patch.maxLat()) - settings.offsets.x;
+    const double minLon = glm::degrees(patch.minLon()) - settings.offsets.y;
+    const double maxLon = glm::degrees(patch.maxLon()) - settings.offsets.y;
+
+    // Details that are smaller than the resolution of the tile would not be visible
+    const double tolerance = (maxLon - minLon) / VectorTileResolution;
+
+    // Each tile uses its own factory, as the geometries update the reference count of
+    // their factory without synchronization. The factory has to outlive all geometries
+    // that are created with it
+    const geos::geom::GeometryFactory::Ptr factory =
+        geos::geom::GeometryFactory::create();
+    const geos::geom::Envelope envelope = geos::geom::Envelope(
+        minLon,
+        maxLon,
+        minLat,
+        maxLat
+    );
+    const std::unique_ptr<geos::geom::Geometry> tile = factory->toGeometry(&envelope);
+
+    const auto clipAndSimplify = [&tile, tolerance](const geos::geom::Geometry& g) {
+        const std::unique_ptr<geos::geom::Geometry> clipped = g.intersection(tile.get());
+        using geos::simplify::DouglasPeuckerSimplifier;
+        return DouglasPeuckerSimplifier::simplify(clipped.get(), tolerance);
+    };
+
+    // Lines and the boundaries of polygons. The boundaries are clipped as lines rather
+    // than taken from the clipped polygons, which would add lines along the tile edges
+    std::vector<std::vector<Geodetic3>> lines;
     for (const std::vector<Geodetic3>& coordinates : _geoCoordinates) {
+        const std::unique_ptr<geos::geom::LineString> line = factory->createLineString(
+            geometryhelper::geoVectorAsCoordinateSequence(coordinates)
+        );
+        const std::unique_ptr<geos::geom::Geometry> result = clipAndSimplify(*line);
+        for (size_t i = 0; i < result->getNumGeometries(); i++) {
+            const geos::geom::Geometry* part = result->getGeometryN(i);
+            if (part->getGeometryTypeId() == geos::geom::GEOS_LINESTRING &&
+                !part->isEmpty())
+            {
+                lines.push_back(geometryhelper::geometryCoordsAsGeoVector(part));
+            }
+        }
+    }
+
+    // The area of polygons
+    std::vector<Geodetic3> triangles;
+    if (_type == GeometryType::Polygon && !_geoCoordinates.empty()) {
+        std::unique_ptr<geos::geom::LinearRing> shell = factory->createLinearRing(
+            geometryhelper::geoVectorAsCoordinateSequence(_geoCoordinates.front())
+        );
+        std::vector<std::unique_ptr<geos::geom::LinearRing>> holes;
+        for (size_t i = 1; i < _geoCoordinates.size(); i++) {
+            holes.push_back(factory->createLinearRing(
+                geometryhelper::geoVectorAsCoordinateSequence(_geoCoordinates[i])
+            ));
+        }
+        const std::unique_ptr<geos::geom::Polygon> polygon = factory->createPolygon(
+            std::move(shell),
+            std::move(holes)
+        );
+
+        const std::unique_ptr<geos::geom::Geometry> result = clipAndSimplify(*polygon);
+        for (size_t i = 0; i < result->getNumGeometries(); i++) {
+            const auto part =
+                dynamic_cast<const geos::geom::Polygon*>(result->getGeometryN(i));
+            if (part && !part->isEmpty()) {
+                std::vector<Geodetic3> partTriangles = triangulate(part);
+                triangles.insert(
+                    triangles.end(),
+                    partTriangles.begin(),
+                    partTriangles.end()
+                );
+            }
+        }
+    }
+
+    return createGeometryVertices(lines, triangles, settings);
+}
+
+void GlobeGeometryFeature::addTile(const TileIndex& tileIndex,
+                                   const std::vector<RenderFeatureVertices>& vertices)
+{
+    std::vector<RenderFeature> features;
+    features.reserve(vertices.size());
+    for (const RenderFeatureVertices& v : vertices) {
+        features.push_back(createRenderFeature(v));
+    }
+
+    // Tiles are added after the last height map update, so the heights of relative to
+    // ground features have to be uploaded here instead of waiting for the next change of
+    // the reference point heights
+    if (useHeightMap()) {
+        for (RenderFeature& f : features) {
+            updateHeights(f);
+        }
+    }
+
+    const auto it = _tileRenderFeatures.find(tileIndex.hashKey());
+    if (it != _tileRenderFeatures.end()) {
+        deleteBuffers(it->second);
+        it->second = std::move(features);
+    }
+    else {
+        _tileRenderFeatures.emplace(tileIndex.hashKey(), std::move(features));
+    }
+}
+
+void GlobeGeometryFeature::removeTile(const TileIndex& tileIndex) {
+    const auto it = _tileRenderFeatures.find(tileIndex.hashKey());
+    if (it != _tileRenderFeatures.end()) {
+        deleteBuffers(it->second);
+        _tileRenderFeatures.erase(it);
+    }
+}
+
+std::vector<GlobeGeometryFeature::RenderFeatureVertices>
+GlobeGeometryFeature::createGeometryVertices(
+                                         const std::vector<std::vector<Geodetic3>>& lines,
+                                                  const std::vector<Geodetic3>& triangles,
+                                                     const VertexSettings& settings) const
+{
+    std::vector<RenderFeatureVertices> result;
+    const std::vector<std::vector<glm::vec3>> edgeVertices =
+        createLineGeometry(lines, settings, result);
+    createExtrudedGeometry(edgeVertices, result);
+    createPolygonGeometry(triangles, settings, result);
+    return result;
+}
+
+std::vector<std::vector<glm::vec3>> GlobeGeometryFeature::createLineGeometry(
+                                         const std::vector<std::vector<Geodetic3>>& lines,
+                                                           const VertexSettings& settings,
+                                       std::vector<RenderFeatureVertices>& result) const
+{
+    std::vector<std::vector<glm::vec3>> resultPositions;
+    resultPositions.reserve(lines.size());
+    for (const std::vector<Geodetic3>& coordinates : lines) {
         std::vector<Vertex> vertices;
         std::vector<glm::vec3> positions;
         // TODO: this is not correct anymore
@@ -574,8 +808,8 @@ std::vector<std::vector<glm::vec3>> GlobeGeometryFeature::createLineGeometry() {
             const glm::dvec3 v = geometryhelper::computeOffsetedModelCoordinate(
                 geodetic,
                 _globe,
-                _offsets.x,
-                _offsets.y
+                settings.offsets.x,
+                settings.offsets.y
             );
 
             const auto addLinePos = [&vertices, &positions](const glm::vec3& pos) {
@@ -591,11 +825,11 @@ std::vector<std::vector<glm::vec3>> GlobeGeometryFeature::createLineGeometry() {
                 continue;
             }
 
-            if (_properties.tessellationEnabled()) {
+            if (settings.tessellationEnabled) {
                 // Tessellate.
                 // But first, determine the step size for the tessellation (larger
                 // features will not be tesselated)
-                const float stepSize = tessellationStepSize();
+                const float stepSize = settings.tessellationStepSize;
 
                 std::vector<geometryhelper::PosHeightPair> subdividedPositions =
                     geometryhelper::subdivideLine(
@@ -622,12 +856,9 @@ std::vector<std::vector<glm::vec3>> GlobeGeometryFeature::createLineGeometry() {
         }
 
         vertices.shrink_to_fit();
-
-        RenderFeature feature;
-        feature.nVertices = vertices.size();
-        feature.type = RenderType::Lines;
-        initializeRenderFeature(feature, vertices);
-        _renderFeatures.push_back(std::move(feature));
+        result.push_back(
+            createFeatureVertices(RenderType::Lines, false, std::move(vertices))
+        );
 
         positions.shrink_to_fit();
         resultPositions.push_back(std::move(positions));
@@ -637,9 +868,11 @@ std::vector<std::vector<glm::vec3>> GlobeGeometryFeature::createLineGeometry() {
     return resultPositions;
 }
 
-void GlobeGeometryFeature::createPointGeometry() {
+std::vector<GlobeGeometryFeature::RenderFeatureVertices>
+GlobeGeometryFeature::createPointGeometry(const VertexSettings& settings) const {
+    std::vector<RenderFeatureVertices> result;
     if (_type != GeometryType::Point) {
-        return;
+        return result;
     }
 
     for (const std::vector<Geodetic3>& coordinates : _geoCoordinates) {
@@ -653,8 +886,8 @@ void GlobeGeometryFeature::createPointGeometry() {
             const glm::dvec3 v = geometryhelper::computeOffsetedModelCoordinate(
                 geodetic,
                 _globe,
-                _offsets.x,
-                _offsets.y
+                settings.offsets.x,
+                settings.offsets.y
             );
 
             const glm::vec3 vf = static_cast<glm::vec3>(v);
@@ -671,43 +904,43 @@ void GlobeGeometryFeature::createPointGeometry() {
         vertices.shrink_to_fit();
         extrudedLineVertices.shrink_to_fit();
 
-        RenderFeature feature;
-        feature.nVertices = vertices.size();
-        feature.type = RenderType::Points;
-        initializeRenderFeature(feature, vertices);
-        _renderFeatures.push_back(std::move(feature));
+        result.push_back(
+            createFeatureVertices(RenderType::Points, false, std::move(vertices))
+        );
 
         // Create extrusion feature
-        RenderFeature extrudeFeature;
-        extrudeFeature.nVertices = extrudedLineVertices.size();
-        extrudeFeature.type = RenderType::Lines;
-        extrudeFeature.isExtrusionFeature = true;
-        initializeRenderFeature(extrudeFeature, extrudedLineVertices);
-        _renderFeatures.push_back(std::move(extrudeFeature));
+        result.push_back(
+            createFeatureVertices(
+                RenderType::Lines,
+                true,
+                std::move(extrudedLineVertices)
+            )
+        );
     }
+    return result;
 }
 
 void GlobeGeometryFeature::createExtrudedGeometry(
-                                 const std::vector<std::vector<glm::vec3>>& edgeVertices)
+                                  const std::vector<std::vector<glm::vec3>>& edgeVertices,
+                                       std::vector<RenderFeatureVertices>& result) const
 {
     if (edgeVertices.empty()) {
         return;
     }
 
-    const std::vector<Vertex> vertices = geometryhelper::createExtrudedGeometryVertices(
+    std::vector<Vertex> vertices = geometryhelper::createExtrudedGeometryVertices(
         edgeVertices
     );
-
-    RenderFeature feature;
-    feature.type = RenderType::Polygon;
-    feature.nVertices = vertices.size();
-    feature.isExtrusionFeature = true;
-    initializeRenderFeature(feature, vertices);
-    _renderFeatures.push_back(std::move(feature));
+    result.push_back(
+        createFeatureVertices(RenderType::Polygon, true, std::move(vertices))
+    );
 }
 
-void GlobeGeometryFeature::createPolygonGeometry() {
-    if (_triangleCoordinates.empty()) {
+void GlobeGeometryFeature::createPolygonGeometry(const std::vector<Geodetic3>& triangles,
+                                                           const VertexSettings& settings,
+                                       std::vector<RenderFeatureVertices>& result) const
+{
+    if (triangles.empty()) {
         return;
     }
 
@@ -717,12 +950,12 @@ void GlobeGeometryFeature::createPolygonGeometry() {
     int triIndex = 0;
     std::array<glm::vec3, 3> triPositions;
     std::array<double, 3> triHeights;
-    for (const Geodetic3& geodetic : _triangleCoordinates) {
+    for (const Geodetic3& geodetic : triangles) {
         const glm::vec3 vert = geometryhelper::computeOffsetedModelCoordinate(
             geodetic,
             _globe,
-            _offsets.x,
-            _offsets.y
+            settings.offsets.x,
+            settings.offsets.y
         );
         triPositions[triIndex] = vert;
         triHeights[triIndex] = geodetic.height;
@@ -740,10 +973,10 @@ void GlobeGeometryFeature::createPolygonGeometry() {
             const double h1 = triHeights[1];
             const double h2 = triHeights[2];
 
-            if (_properties.tessellationEnabled()) {
+            if (settings.tessellationEnabled) {
                 // First determine the step size for the tessellation (larger features
                 // will not be tesselated)
-                const float stepSize = tessellationStepSize();
+                const float stepSize = settings.tessellationStepSize;
 
                 std::vector<Vertex> verts = geometryhelper::subdivideTriangle(
                     v0, v1, v2,
@@ -763,18 +996,35 @@ void GlobeGeometryFeature::createPolygonGeometry() {
         }
     }
 
-    RenderFeature triFeature;
-    triFeature.type = RenderType::Polygon;
-    triFeature.nVertices = polyVertices.size();
-    initializeRenderFeature(triFeature, polyVertices);
-    _renderFeatures.push_back(std::move(triFeature));
+    result.push_back(
+        createFeatureVertices(RenderType::Polygon, false, std::move(polyVertices))
+    );
+}
+
+GlobeGeometryFeature::RenderFeatureVertices GlobeGeometryFeature::createFeatureVertices(
+                                                                          RenderType type,
+                                                                  bool isExtrusionFeature,
+                                                       std::vector<Vertex> vertices) const
+{
+    RenderFeatureVertices result;
+    result.type = type;
+    result.isExtrusionFeature = isExtrusionFeature;
+    // Store the lat long coordinates, so we can quickly look up the height map heights
+    result.geodetics = geometryhelper::geodetic2FromVertexList(_globe, vertices);
+    result.vertices = std::move(vertices);
+    return result;
 }
 
-void GlobeGeometryFeature::initializeRenderFeature(RenderFeature& feature,
-                                                   const std::vector<Vertex>& vertices)
+GlobeGeometryFeature::RenderFeature GlobeGeometryFeature::createRenderFeature(
+                                                    const RenderFeatureVertices& vertices)
 {
+    RenderFeature feature;
+    feature.type = vertices.type;
+    feature.nVertices = vertices.vertices.size();
+    feature.isExtrusionFeature = vertices.isExtrusionFeature;
+
     // Get height map heights
-    feature.vertices = geometryhelper::geodetic2FromVertexList(_globe, vertices);
+    feature.vertices = vertices.geodetics;
     feature.heights = geometryhelper::heightMapHeightsFromGeodetic2List(
         _globe,
         feature.vertices
@@ -782,7 +1032,16 @@ void GlobeGeometryFeature::initializeRenderFeature(RenderFeature& feature,
 
     // Generate buffers and buffer data
     feature.initializeBuffers();
-    bufferVertexData(feature, vertices);
+    bufferVertexData(feature, vertices.vertices);
+    return feature;
+}
+
+void GlobeGeometryFeature::updateHeights(RenderFeature& feature) {
+    feature.heights = geometryhelper::heightMapHeightsFromGeodetic2List(
+        _globe,
+        feature.vertices
+    );
+    bufferDynamicHeightData(feature);
 }
 
 float GlobeGeometryFeature::tessellationStepSize() const {
@@ -797,18 +1056,32 @@ float GlobeGeometryFeature::tessellationStepSize() const {
     return distance;
 }
 
+void GlobeGeometryFeature::deleteBuffers(const std::vector<RenderFeature>& features) {
+    for (const RenderFeature& r : features) {
+        glDeleteVertexArrays(1, &r.vaoId);
+        glDeleteBuffers(1, &r.vboId);
+    }
+}
+
 std::vector<double> GlobeGeometryFeature::getCurrentReferencePointsHeights() const {
-    std::vector<double> newHeights;
-    newHeights.reserve(_heightUpdateReferencePoints.size());
+    std::vector<glm::dvec3> positions;
+    positions.reserve(_heightUpdateReferencePoints.size());
     for (const Geodetic3& geo : _heightUpdateReferencePoints) {
-        const glm::dvec3 p = geometryhelper::computeOffsetedModelCoordinate(
+        positions.push_back(geometryhelper::computeOffsetedModelCoordinate(
             geo,
             _globe,
             _offsets.x,
             _offsets.y
-        );
-        const SurfacePositionHandle handle = _globe.calculateSurfacePositionHandle(p);
-        newHeights.push_back(handle.heightToSurface);
+        ));
+    }
+
+    std::vector<float> heights = std::vector<float>(positions.size());
+    _globe.calculateHeights(positions, heights);
+
+    std::vector<double> newHeights;
+    newHeights.reserve(heights.size());
+    for (const float h : heights) {
+        newHeights.push_back(std::isnan(h) ? 0.0 : static_cast<double>(h));
     }
     return newHeights;
 }
@@ -29,11 +29,14 @@
 
 #include <modules/globebrowsing/src/basictypes.h>
 #include <modules/globebrowsing/src/geojson/geojsonproperties.h>
+#include <modules/globebrowsing/src/tileindex.h>
 #include <openspace/rendering/helper.h>
 #include <openspace/rendering/texturecomponent.h>
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <chrono>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 namespace openspace::documentation { struct Documentation; }
@@ -46,6 +49,7 @@ namespace geos::geom { class Geometry; }
 
 namespace openspace::globebrowsing {
 
+class GeodeticPatch;
 class RenderableGlobe;
 
 /**
@@ -107,6 +111,30 @@ public:
         std::vector<float> heights;
     };
 
+    /**
+     * The vertex data of a render feature. In contrast to the render feature itself, it
+     * does not require an OpenGL context and can be created on a worker thread.
+     */
+    struct RenderFeatureVertices {
+        RenderType type = RenderType::Uninitialized;
+        bool isExtrusionFeature = false;
+        std::vector<Vertex> vertices;
+
+        /// The geodetic lat long coordinates of each vertex
+        std::vector<Geodetic2> geodetics;
+    };
+
+    /**
+     * The values of the properties that the vertex positions depend on. They are copied,
+     * so that vertices can be created on a worker thread while the properties change.
+     */
+    struct VertexSettings {
+        /// lat, long, distance (meters)
+        glm::vec3 offsets = glm::vec3(0.f);
+        bool tessellationEnabled = false;
+        float tessellationStepSize = 0.f;
+    };
+
     /**
      * Some extra data that we need for doing the rendering.
      */
@@ -115,6 +143,9 @@ public:
         float lineWidthScale;
         PointRenderMode& pointRenderMode;
         rendering::helper::LightSourceRenderData& lightSourceData;
+
+        /// The vector tiles that are rendered for features that use vector tiles
+        std::span<const TileIndex> vectorTiles;
     };
 
     std::string key() const;
@@ -130,8 +161,46 @@ public:
 
     void updateTexture(bool isInitializeStep = false);
 
+    /**
+     * Creates the feature from the \p geo geometry. If \p useVectorTiles is `true`, the
+     * lines and polygons are not triangulated for the whole globe here, but only for the
+     * vector tiles that are added through #addTile.
+     */
     void createFromSingleGeosGeometry(const geos::geom::Geometry* geo, int index,
-        bool ignoreHeights);
+        bool ignoreHeights, bool useVectorTiles);
+
+    /**
+     * \return `true` if the lines and polygons of this feature are rendered from vector
+     *         tiles
+     */
+    bool usesVectorTiles() const;
+
+    VertexSettings vertexSettings() const;
+
+    /**
+     * \return `true` if the bounding box of the feature, moved by the \p latLongOffset in
+     *         degrees, intersects the \p patch
+     */
+    bool intersects(const GeodeticPatch& patch, const glm::vec2& latLongOffset) const;
+
+    /**
+     * Creates the vertices for the part of the feature that lies within the tile with the
+     * \p tileIndex. The lines and polygons are clipped to the tile and simplified with a
+     * tolerance that matches the resolution of the tile's level before they are
+     * triangulated. Only data that does not change after the feature is created is used,
+     * so this function can be called from a worker thread.
+     */
+    std::vector<RenderFeatureVertices> createTileVertices(const TileIndex& tileIndex,
+        const VertexSettings& settings) const;
+
+    /**
+     * Creates the render features for the vector tile with the \p tileIndex from the
+     * \p vertices that were created by #createTileVertices.
+     */
+    void addTile(const TileIndex& tileIndex,
+        const std::vector<RenderFeatureVertices>& vertices);
+
+    void removeTile(const TileIndex& tileIndex);
 
     // 2 pass rendering to get correct culling for polygons
     void render(const RenderData& renderData, int pass, float mainOpacity,
@@ -153,36 +222,62 @@ private:
         int renderPass) const;
 
     /**
-     * Create the vertex information for any line parts of the feature. Returns the
+     * Create the vertex information for the \p lines and the \p triangles, as well as
+     * for the extrusion of the lines.
+     */
+    std::vector<RenderFeatureVertices> createGeometryVertices(
+        const std::vector<std::vector<Geodetic3>>& lines,
+        const std::vector<Geodetic3>& triangles, const VertexSettings& settings) const;
+
+    /**
+     * Create the vertex information for the \p lines and add it to \p result. Returns the
      * resulting vertex positions, so we can use them for extrusion.
      */
-    std::vector<std::vector<glm::vec3>> createLineGeometry();
+    std::vector<std::vector<glm::vec3>> createLineGeometry(
+        const std::vector<std::vector<Geodetic3>>& lines, const VertexSettings& settings,
+        std::vector<RenderFeatureVertices>& result) const;
 
     /**
      * Create the vertex information for any point parts of the feature. Also creates the
      * features for extruded lines for the points.
      */
-    void createPointGeometry();
+    std::vector<RenderFeatureVertices> createPointGeometry(
+        const VertexSettings& settings) const;
 
     /**
      * Create the triangle geometry for the extruded edges of lines/polygons.
      */
-    void createExtrudedGeometry(const std::vector<std::vector<glm::vec3>>& edgeVertices);
+    void createExtrudedGeometry(const std::vector<std::vector<glm::vec3>>& edgeVertices,
+        std::vector<RenderFeatureVertices>& result) const;
 
     /**
      * Create the triangle geometry for the polygon part of the feature (the area
-     * contained by the shape).
+     * contained by the shape), given by the coordinates of its \p triangles.
      */
-    void createPolygonGeometry();
+    void createPolygonGeometry(const std::vector<Geodetic3>& triangles,
+        const VertexSettings& settings, std::vector<RenderFeatureVertices>& result) const;
 
-    void initializeRenderFeature(RenderFeature& feature,
-        const std::vector<Vertex>& vertices);
+    /**
+     * Creates the vertex data for a render feature from the \p vertices.
+     */
+    RenderFeatureVertices createFeatureVertices(RenderType type, bool isExtrusionFeature,
+        std::vector<Vertex> vertices) const;
+
+    /**
+     * Samples the height map and creates the OpenGL buffers for the \p vertices. Has to
+     * be called on the main thread.
+     */
+    RenderFeature createRenderFeature(const RenderFeatureVertices& vertices);
+
+    void updateHeights(RenderFeature& feature);
 
     /**
      * Get the distance that shall be used for tessellation, based on the properties.
      */
     float tessellationStepSize() const;
 
+    static void deleteBuffers(const std::vector<RenderFeature>& features);
+
     /**
      * Compute the heights to the surface at the reference points.
      */
@@ -212,6 +307,16 @@ private:
 
     std::vector<RenderFeature> _renderFeatures;
 
+    /// The render features of the vector tiles, if the feature uses vector tiles
+    std::unordered_map<TileIndex::TileHashKey, std::vector<RenderFeature>>
+        _tileRenderFeatures;
+
+    bool _usesVectorTiles = false;
+
+    /// The bounding box of the coordinates, used to decide which vector tiles are needed
+    Geodetic2 _boundsMin;
+    Geodetic2 _boundsMax;
+
     /// lat, long, distance (meters). Passed from parent on property change
     glm::vec3 _offsets = glm::vec3(0.f);
 
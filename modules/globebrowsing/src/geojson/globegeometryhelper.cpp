@@ -28,9 +28,11 @@
 #include <openspace/rendering/helper.h>
 #include <openspace/util/updatestructures.h>
 #include <geos/geom/Coordinate.h>
+#include <geos/geom/CoordinateSequence.h>
 #include <geos/geom/GeometryFactory.h>
 #include <geos/triangulate/DelaunayTriangulationBuilder.h>
 #include <geos/triangulate/quadedge/QuadEdgeSubdivision.h>
+#include <cmath>
 
 namespace openspace::globebrowsing::geometryhelper {
 
@@ -67,6 +69,18 @@ std::vector<Geodetic3> geometryCoordsAsGeoVector(const geos::geom::Geometry* geo
     return geometryhelper::coordsToGeodetic(coords);
 }
 
+std::unique_ptr<geos::geom::CoordinateSequence> geoVectorAsCoordinateSequence(
+                                                const std::vector<Geodetic3>& coordinates)
+{
+    // The height is stored as the z-coordinate, like in the GeoJson files
+    auto sequence = std::make_unique<geos::geom::CoordinateSequence>(0, true, false);
+    sequence->reserve(coordinates.size());
+    for (const Geodetic3& gd : coordinates) {
+        sequence->add(toGeosCoord(gd));
+    }
+    return sequence;
+}
+
 std::vector<Geodetic2> geodetic2FromVertexList(const RenderableGlobe& globe,
                             const std::vector<rendering::helper::VertexXYZNormal>& verts)
 {
@@ -82,11 +96,16 @@ std::vector<Geodetic2> geodetic2FromVertexList(const RenderableGlobe& globe,
 std::vector<float> heightMapHeightsFromGeodetic2List(const RenderableGlobe& globe,
                                                      const std::vector<Geodetic2>& list)
 {
-    std::vector<float> res;
-    res.reserve(list.size());
+    std::vector<glm::dvec3> positions;
+    positions.reserve(list.size());
     for (const Geodetic2& geo : list) {
-        const float h = static_cast<float>(getHeightToReferenceSurface(geo, globe));
-        res.push_back(h);
+        positions.push_back(globe.ellipsoid().cartesianSurfacePosition(geo));
+    }
+
+    std::vector<float> res = std::vector<float>(list.size());
+    globe.calculateHeights(positions, res);
+    for (float& h : res) {
+        h = std::isnan(h) ? 0.f : h;
     }
     return res;
 }
@@ -26,6 +26,7 @@
 #define __OPENSPACE_MODULE_GLOBEBROWSING___GLOBEGEOMETRYHELPER___H__
 
 #include <ghoul/glm.h>
+#include <memory>
 #include <vector>
 
 namespace openspace::globebrowsing {
@@ -40,6 +41,7 @@ namespace openspace::rendering::helper {
 
 namespace geos::geom {
     class Coordinate;
+    class CoordinateSequence;
     class Geometry;
 } // namespace geos::geom
 
@@ -54,6 +56,13 @@ std::vector<Geodetic3> coordsToGeodetic(
 
 std::vector<Geodetic3> geometryCoordsAsGeoVector(const geos::geom::Geometry* geometry);
 
+/**
+ * Creates a coordinate sequence from the geodetic \p coordinates, which can be used to
+ * create GEOS geometries. This is the inverse of #geometryCoordsAsGeoVector.
+ */
+std::unique_ptr<geos::geom::CoordinateSequence> geoVectorAsCoordinateSequence(
+    const std::vector<Geodetic3>& coordinates);
+
 std::vector<Geodetic2> geodetic2FromVertexList(const RenderableGlobe& globe,
     const std::vector<rendering::helper::VertexXYZNormal>& verts);
 
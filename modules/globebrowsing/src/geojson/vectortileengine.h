@@ -0,0 +1,182 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___VECTORTILEENGINE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___VECTORTILEENGINE___H__
+
+#include <modules/globebrowsing/src/tileindex.h>
+#include <openspace/util/taskscheduler.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace::globebrowsing {
+
+/**
+ * Streams the vector tiles of a layer in and out following the chunks of the globe that
+ * are rendered. Instead of processing the whole layer at load time, the content is cut
+ * into the tiles of the same quadtree that the chunks use, so only the tiles that are
+ * currently visible have to be created, each at the level of detail of its level.
+ *
+ * The tiles are built on the worker threads of a TaskScheduler and are uploaded on the
+ * main thread within a per-frame time budget, in the same way as the raster tiles. Until
+ * a tile is uploaded, its nearest uploaded ancestor is rendered in its place. Once more
+ * than the maximum number of tiles are uploaded, the tiles that are not rendered are
+ * released in least recently used order.
+ *
+ * The engine does not know anything about the contents of the tiles. The building,
+ * uploading, and releasing are done through functions that are passed to it, which makes
+ * it possible to use it without an OpenGL context.
+ */
+template <typename T>
+class VectorTileEngine {
+public:
+    /// Creates the content of a tile. This function is called on a worker thread
+    using BuildFunction = std::function<T(const TileIndex&)>;
+
+    /// Uploads the content of a built tile. This function is called on the main thread
+    using UploadFunction = std::function<void(const TileIndex&, T)>;
+
+    /// Releases an uploaded tile. This function is called on the main thread
+    using ReleaseFunction = std::function<void(const TileIndex&)>;
+
+    /// Returns whether the tile has any content. Called on the main thread
+    using CoverageFunction = std::function<bool(const TileIndex&)>;
+
+    struct Settings {
+        /// The highest level for which tiles are created. Chunks on a higher level use
+        /// the tile of their ancestor on this level
+        int maxLevel = 12;
+
+        /// The number of uploaded tiles after which unused tiles are released
+        size_t nMaxTiles = 256;
+
+        /// The maximum number of tiles that are built at the same time
+        size_t nMaxJobs = 8;
+    };
+
+    VectorTileEngine(TaskScheduler& scheduler, Settings settings, CoverageFunction covers,
+        UploadFunction upload, ReleaseFunction release);
+
+    /**
+     * Waits for the tiles that are currently built, as their build functions might
+     * reference data that is destroyed together with this engine.
+     */
+    ~VectorTileEngine();
+
+    VectorTileEngine(const VectorTileEngine&) = delete;
+    VectorTileEngine& operator=(const VectorTileEngine&) = delete;
+
+    /**
+     * Sets the function that creates the content of the tiles. All uploaded tiles are
+     * released and the tiles that are currently built with the previous function are
+     * discarded once they are finished.
+     */
+    void setBuildFunction(BuildFunction build);
+
+    /**
+     * Changes the settings. Tiles above a lowered maximum level are no longer used and
+     * are released once the maximum number of tiles is exceeded.
+     */
+    void setSettings(Settings settings);
+
+    /**
+     * Requests the tiles that cover the \p chunkTiles that are rendered in this frame,
+     * uploads built tiles until \p budgetMilliseconds is used up, releases unused tiles,
+     * and computes the tiles that should be rendered. At least one tile is uploaded per
+     * call if one is available, to ensure that all tiles are uploaded eventually. This
+     * function has to be called once per frame.
+     */
+    void update(std::span<const TileIndex> chunkTiles, double budgetMilliseconds);
+
+    /**
+     * \return The tiles that should be rendered in the current frame. The tiles do not
+     *         overlap each other
+     */
+    const std::vector<TileIndex>& renderTiles() const;
+
+    /**
+     * Releases all uploaded tiles and discards all tiles that are currently built.
+     */
+    void clear();
+
+    size_t nUploadedTiles() const;
+
+    /// \return The number of tiles that are built or wait to be uploaded
+    size_t nPendingTiles() const;
+
+private:
+    struct Job {
+        TileIndex tileIndex;
+        uint64_t generation = 0;
+        TaskFuture<T> future;
+    };
+
+    struct BuiltTile {
+        TileIndex tileIndex;
+        T content;
+    };
+
+    struct UploadedTile {
+        TileIndex tileIndex;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    void collectFinishedJobs();
+    void requestTiles();
+    void uploadTiles(double budgetMilliseconds);
+    void computeRenderTiles();
+    void releaseUnusedTiles();
+
+    bool isRequested(TileIndex::TileHashKey key) const;
+
+    TaskScheduler& _scheduler;
+    Settings _settings;
+    CoverageFunction _covers;
+    UploadFunction _upload;
+    ReleaseFunction _release;
+    std::shared_ptr<const BuildFunction> _build;
+
+    std::vector<Job> _jobs;
+    std::vector<BuiltTile> _builtTiles;
+    std::unordered_map<TileIndex::TileHashKey, UploadedTile> _uploadedTiles;
+
+    /// The tiles covering the rendered chunks in the current frame
+    std::vector<TileIndex> _desiredTiles;
+    std::vector<TileIndex> _renderTiles;
+
+    /// Incremented whenever the build function changes, to discard outdated jobs
+    uint64_t _generation = 0;
+    uint64_t _frame = 1;
+};
+
+} // namespace openspace::globebrowsing
+
+#include "vectortileengine.inl"
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___VECTORTILEENGINE___H__
@@ -0,0 +1,321 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <ghoul/format.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <unordered_set>
+
+namespace openspace::globebrowsing {
+
+template <typename T>
+VectorTileEngine<T>::VectorTileEngine(TaskScheduler& scheduler, Settings settings,
+                                      CoverageFunction covers, UploadFunction upload,
+                                      ReleaseFunction release)
+    : _scheduler(scheduler)
+    , _settings(std::move(settings))
+    , _covers(std::move(covers))
+    , _upload(std::move(upload))
+    , _release(std::move(release))
+{}
+
+template <typename T>
+VectorTileEngine<T>::~VectorTileEngine() {
+    for (const Job& job : _jobs) {
+        job.future.wait();
+    }
+}
+
+template <typename T>
+void VectorTileEngine<T>::setBuildFunction(BuildFunction build) {
+    clear();
+    _build = std::make_shared<const BuildFunction>(std::move(build));
+}
+
+template <typename T>
+void VectorTileEngine<T>::setSettings(Settings settings) {
+    _settings = std::move(settings);
+}
+
+template <typename T>
+void VectorTileEngine<T>::update(std::span<const TileIndex> chunkTiles,
+                                 double budgetMilliseconds)
+{
+    ZoneScoped;
+
+    _frame++;
+
+    // Many chunks share the same tile if they are above the maximum level
+    _desiredTiles.clear();
+    std::unordered_set<TileIndex::TileHashKey> desiredKeys;
+    for (TileIndex tileIndex : chunkTiles) {
+        while (tileIndex.level > _settings.maxLevel) {
+            tileIndex = tileIndex.parent();
+        }
+        if (!desiredKeys.contains(tileIndex.hashKey()) && _covers(tileIndex)) {
+            desiredKeys.insert(tileIndex.hashKey());
+            _desiredTiles.push_back(tileIndex);
+        }
+    }
+
+    collectFinishedJobs();
+    requestTiles();
+    uploadTiles(budgetMilliseconds);
+    computeRenderTiles();
+    releaseUnusedTiles();
+}
+
+template <typename T>
+const std::vector<TileIndex>& VectorTileEngine<T>::renderTiles() const {
+    return _renderTiles;
+}
+
+template <typename T>
+void VectorTileEngine<T>::clear() {
+    for (const auto& [key, tile] : _uploadedTiles) {
+        _release(tile.tileIndex);
+    }
+    _uploadedTiles.clear();
+    _builtTiles.clear();
+    _renderTiles.clear();
+
+    // The jobs that are currently running can't be cancelled, but their results are
+    // thrown away once they are finished
+    _generation++;
+}
+
+template <typename T>
+size_t VectorTileEngine<T>::nUploadedTiles() const {
+    return _uploadedTiles.size();
+}
+
+template <typename T>
+size_t VectorTileEngine<T>::nPendingTiles() const {
+    return _jobs.size() + _builtTiles.size();
+}
+
+template <typename T>
+void VectorTileEngine<T>::collectFinishedJobs() {
+    auto it = _jobs.begin();
+    while (it != _jobs.end()) {
+        if (!it->future.isReady()) {
+            ++it;
+            continue;
+        }
+
+        if (it->generation == _generation) {
+            try {
+                _builtTiles.push_back({ it->tileIndex, it->future.get() });
+            }
+            catch (const std::exception& e) {
+                LERRORC("VectorTileEngine", std::format(
+                    "Error creating vector tile {}, {}, {}: {}",
+                    it->tileIndex.x, it->tileIndex.y, it->tileIndex.level, e.what()
+                ));
+                // Store an empty tile, as building the tile again would fail again
+                _builtTiles.push_back({ it->tileIndex, T() });
+            }
+        }
+        it = _jobs.erase(it);
+    }
+}
+
+template <typename T>
+void VectorTileEngine<T>::requestTiles() {
+    if (!_build) {
+        return;
+    }
+
+    std::vector<TileIndex> missing;
+    for (const TileIndex& tileIndex : _desiredTiles) {
+        if (!_uploadedTiles.contains(tileIndex.hashKey()) &&
+            !isRequested(tileIndex.hashKey()))
+        {
+            missing.push_back(tileIndex);
+        }
+    }
+
+    // Coarse tiles are requested first, as they serve as the fallback for their children
+    std::stable_sort(
+        missing.begin(),
+        missing.end(),
+        [](const TileIndex& lhs, const TileIndex& rhs) { return lhs.level < rhs.level; }
+    );
+
+    for (const TileIndex& tileIndex : missing) {
+        if (_jobs.size() >= _settings.nMaxJobs) {
+            break;
+        }
+
+        // The job keeps the build function alive, even if it is replaced in the meantime
+        std::shared_ptr<const BuildFunction> build = _build;
+        _jobs.push_back({
+            .tileIndex = tileIndex,
+            .generation = _generation,
+            .future = _scheduler.submit(
+                [build = std::move(build), tileIndex]() { return (*build)(tileIndex); }
+            )
+        });
+    }
+}
+
+template <typename T>
+void VectorTileEngine<T>::uploadTiles(double budgetMilliseconds) {
+    if (_builtTiles.empty()) {
+        return;
+    }
+
+    // Upload the tiles that are needed in this frame first, and coarser tiles before
+    // finer ones, as they cover more of the visible surface
+    std::unordered_set<TileIndex::TileHashKey> desiredKeys;
+    for (const TileIndex& tileIndex : _desiredTiles) {
+        desiredKeys.insert(tileIndex.hashKey());
+    }
+    std::stable_sort(
+        _builtTiles.begin(),
+        _builtTiles.end(),
+        [&desiredKeys](const BuiltTile& lhs, const BuiltTile& rhs) {
+            const bool lhsIsDesired = desiredKeys.contains(lhs.tileIndex.hashKey());
+            const bool rhsIsDesired = desiredKeys.contains(rhs.tileIndex.hashKey());
+            if (lhsIsDesired != rhsIsDesired) {
+                return lhsIsDesired;
+            }
+            return lhs.tileIndex.level < rhs.tileIndex.level;
+        }
+    );
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    size_t nUploaded = 0;
+    for (BuiltTile& tile : _builtTiles) {
+        if (nUploaded > 0) {
+            const std::chrono::duration<double, std::milli> elapsed =
+                Clock::now() - start;
+            if (budgetMilliseconds > 0.0 && elapsed.count() >= budgetMilliseconds) {
+                break;
+            }
+        }
+
+        _upload(tile.tileIndex, std::move(tile.content));
+        _uploadedTiles.insert_or_assign(
+            tile.tileIndex.hashKey(),
+            UploadedTile{ tile.tileIndex, _frame }
+        );
+        nUploaded++;
+    }
+    _builtTiles.erase(
+        _builtTiles.begin(),
+        _builtTiles.begin() + static_cast<std::ptrdiff_t>(nUploaded)
+    );
+}
+
+template <typename T>
+void VectorTileEngine<T>::computeRenderTiles() {
+    // Every desired tile is rendered by itself or by its nearest uploaded ancestor
+    std::vector<TileIndex> candidates;
+    std::unordered_set<TileIndex::TileHashKey> candidateKeys;
+    for (const TileIndex& desired : _desiredTiles) {
+        TileIndex tileIndex = desired;
+        while (!_uploadedTiles.contains(tileIndex.hashKey()) && tileIndex.level > 0) {
+            tileIndex = tileIndex.parent();
+        }
+
+        const auto it = _uploadedTiles.find(tileIndex.hashKey());
+        if (it == _uploadedTiles.end()) {
+            continue;
+        }
+        it->second.lastUsedFrame = _frame;
+        if (!candidateKeys.contains(tileIndex.hashKey())) {
+            candidateKeys.insert(tileIndex.hashKey());
+            candidates.push_back(tileIndex);
+        }
+    }
+
+    // An ancestor that is rendered as a fallback already contains the content of all of
+    // its descendants, so rendering those as well would draw the content twice
+    _renderTiles.clear();
+    for (const TileIndex& candidate : candidates) {
+        bool hasRenderedAncestor = false;
+        TileIndex tileIndex = candidate;
+        while (tileIndex.level > 0 && !hasRenderedAncestor) {
+            tileIndex = tileIndex.parent();
+            hasRenderedAncestor = candidateKeys.contains(tileIndex.hashKey());
+        }
+        if (!hasRenderedAncestor) {
+            _renderTiles.push_back(candidate);
+        }
+    }
+}
+
+template <typename T>
+void VectorTileEngine<T>::releaseUnusedTiles() {
+    if (_uploadedTiles.size() <= _settings.nMaxTiles) {
+        return;
+    }
+
+    std::vector<UploadedTile> unused;
+    for (const auto& [key, tile] : _uploadedTiles) {
+        if (tile.lastUsedFrame < _frame) {
+            unused.push_back(tile);
+        }
+    }
+    std::sort(
+        unused.begin(),
+        unused.end(),
+        [](const UploadedTile& lhs, const UploadedTile& rhs) {
+            return lhs.lastUsedFrame < rhs.lastUsedFrame;
+        }
+    );
+
+    for (const UploadedTile& tile : unused) {
+        if (_uploadedTiles.size() <= _settings.nMaxTiles) {
+            break;
+        }
+        _release(tile.tileIndex);
+        _uploadedTiles.erase(tile.tileIndex.hashKey());
+    }
+}
+
+template <typename T>
+bool VectorTileEngine<T>::isRequested(TileIndex::TileHashKey key) const {
+    const bool isBuilding = std::any_of(
+        _jobs.begin(),
+        _jobs.end(),
+        [this, key](const Job& job) {
+            return job.generation == _generation && job.tileIndex.hashKey() == key;
+        }
+    );
+    const bool isBuilt = std::any_of(
+        _builtTiles.begin(),
+        _builtTiles.end(),
+        [key](const BuiltTile& tile) { return tile.tileIndex.hashKey() == key; }
+    );
+    return isBuilding || isBuilt;
+}
+
+} // namespace openspace::globebrowsing
@@ -0,0 +1,213 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/globebrowsing/src/heightsampler.h>
+
+#include <modules/globebrowsing/src/layer.h>
+#include <modules/globebrowsing/src/tileprovider/tileprovider.h>
+#include <ghoul/misc/profiling.h>
+#include <ghoul/opengl/texture.h>
+#include <cmath>
+#include <limits>
+
+namespace openspace::globebrowsing {
+
+float HeightSampler::HeightTile::sample(const glm::vec2& patchUv) const {
+    if (dimensions.x == 0 || dimensions.y == 0) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    const glm::vec2 uv = uvTransform.uvOffset + uvTransform.uvScale * patchUv;
+    glm::vec2 samplePos = uv * glm::vec2(dimensions);
+    // @TODO (emmbr, 2023-06-14) This 0.5f offset was added as a bandaid for issue
+    // #2696. It seems to improve the behavior, but I am not certain of why. And the
+    // underlying problem is still there and should at some point be looked at again
+    samplePos -= glm::vec2(0.5f);
+
+    glm::uvec2 samplePos00 = samplePos;
+    samplePos00 = glm::clamp(samplePos00, glm::uvec2(0, 0), dimensions - glm::uvec2(1));
+    const glm::vec2 samplePosFract = samplePos - glm::vec2(samplePos00);
+    const glm::uvec2 samplePos11 = glm::min(
+        samplePos00 + glm::uvec2(1, 1),
+        dimensions - glm::uvec2(1)
+    );
+
+    const float sample00 = values[samplePos00.y * dimensions.x + samplePos00.x];
+    const float sample10 = values[samplePos00.y * dimensions.x + samplePos11.x];
+    const float sample01 = values[samplePos11.y * dimensions.x + samplePos00.x];
+    const float sample11 = values[samplePos11.y * dimensions.x + samplePos11.x];
+
+    // In case the texture has NaN or no data values don't use this height map
+    const bool anySampleIsNaN =
+        std::isnan(sample00) ||
+        std::isnan(sample01) ||
+        std::isnan(sample10) ||
+        std::isnan(sample11);
+
+    const bool anySampleIsNoData =
+        sample00 == noDataValue ||
+        sample01 == noDataValue ||
+        sample10 == noDataValue ||
+        sample11 == noDataValue;
+
+    if (anySampleIsNaN || anySampleIsNoData) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    const float sample0 = sample00 * (1.f - samplePosFract.x) +
+        sample10 * samplePosFract.x;
+    const float sample1 = sample01 * (1.f - samplePosFract.x) +
+        sample11 * samplePosFract.x;
+
+    return sample0 * (1.f - samplePosFract.y) + sample1 * samplePosFract.y;
+}
+
+HeightSampler::HeightSampler(size_t maxTiles)
+    : _tiles(maxTiles)
+{}
+
+void HeightSampler::startFrame() {
+    _frame++;
+}
+
+void HeightSampler::clear() {
+    _tiles.clear();
+    _lastEntry = nullptr;
+}
+
+float HeightSampler::height(const TileIndex& tileIndex, const glm::vec2& patchUv,
+                            const std::vector<Layer*>& layers)
+{
+    const Entry& e = entry(tileIndex, layers);
+    if (!e.isComplete) {
+        return 0.f;
+    }
+
+    float height = 0.f;
+    for (size_t i = 0; i < e.layers.size(); i++) {
+        const HeightTile& tile = e.layers[i].tile;
+        const float sample = tile.sample(patchUv);
+
+        // Same as is used in the shader. This is not a perfect solution but if the sample
+        // is actually a no-data-value (min_float) the interpolated value might not be.
+        // Therefore we have a cut-off. Assuming no data value is smaller than -100000.
+        // The comparison is also false for a NaN sample, which keeps the previous height
+        if (sample > -100000.f) {
+            // Perform depth transform to get the value in meters
+            height = tile.depthTransform.offset + tile.depthTransform.scale * sample;
+            // Make sure that the height value follows the layer settings. For example if
+            // the multiplier is set to a value bigger than one, the sampled height should
+            // be modified as well
+            height = layers[i]->renderSettings().performLayerSettings(height);
+        }
+    }
+    return height;
+}
+
+HeightSampler::Entry& HeightSampler::entry(const TileIndex& tileIndex,
+                                           const std::vector<Layer*>& layers)
+{
+    const TileIndex::TileHashKey key = tileIndex.hashKey();
+    if (!_lastEntry || _lastKey != key) {
+        if (_tiles.touch(key)) {
+            _lastEntry = _tiles.get(key);
+        }
+        else {
+            _lastEntry = std::make_shared<Entry>();
+            _tiles.put(key, _lastEntry);
+        }
+        _lastKey = key;
+    }
+
+    Entry& e = *_lastEntry;
+    bool sameLayers = e.layers.size() == layers.size();
+    for (size_t i = 0; sameLayers && i < layers.size(); i++) {
+        sameLayers = e.layers[i].layer == layers[i];
+    }
+
+    if (e.frame != _frame || !sameLayers) {
+        updateEntry(e, tileIndex, layers);
+        e.frame = _frame;
+    }
+    return e;
+}
+
+void HeightSampler::updateEntry(Entry& entry, const TileIndex& tileIndex,
+                                const std::vector<Layer*>& layers) const
+{
+    ZoneScoped;
+
+    entry.layers.resize(layers.size());
+    entry.isComplete = true;
+    for (size_t i = 0; i < layers.size(); i++) {
+        LayerTile& layerTile = entry.layers[i];
+        layerTile.layer = layers[i];
+
+        TileProvider* tileProvider = layers[i]->tileProvider();
+        if (!tileProvider) {
+            // A layer without a tile provider never contributes to the height
+            layerTile.texture = nullptr;
+            layerTile.pixelData = nullptr;
+            layerTile.tile = HeightTile();
+            continue;
+        }
+
+        const ChunkTile chunkTile = tileProvider->chunkTile(tileIndex);
+        const Tile& tile = chunkTile.tile;
+        if (tile.status != Tile::Status::OK || !tile.texture) {
+            entry.isComplete = false;
+            return;
+        }
+
+        HeightTile& heightTile = layerTile.tile;
+        heightTile.depthTransform = tileProvider->depthTransform();
+        heightTile.noDataValue = tileProvider->noDataValueAsFloat();
+
+        heightTile.uvTransform = chunkTile.uvTransform;
+
+        // Textures are reused for other tiles once they are evicted from the tile cache,
+        // but each reuse replaces the pixel data, so the combination identifies the data
+        const bool isSameData =
+            layerTile.texture == tile.texture &&
+            layerTile.pixelData == tile.texture->pixelData();
+        if (isSameData) {
+            continue;
+        }
+
+        const glm::uvec2 dimensions = glm::uvec2(tile.texture->dimensions());
+        heightTile.dimensions = dimensions;
+        heightTile.values.resize(static_cast<size_t>(dimensions.x) * dimensions.y);
+        for (unsigned int y = 0; y < dimensions.y; y++) {
+            for (unsigned int x = 0; x < dimensions.x; x++) {
+                heightTile.values[y * dimensions.x + x] =
+                    tile.texture->texelAsFloat(glm::uvec2(x, y)).x;
+            }
+        }
+        layerTile.texture = tile.texture;
+        layerTile.pixelData = tile.texture->pixelData();
+    }
+}
+
+} // namespace openspace::globebrowsing
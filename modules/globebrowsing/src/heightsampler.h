@@ -0,0 +1,135 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___HEIGHTSAMPLER___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___HEIGHTSAMPLER___H__
+
+#include <modules/globebrowsing/src/basictypes.h>
+#include <modules/globebrowsing/src/lrucache.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace ghoul::opengl { class Texture; }
+
+namespace openspace::globebrowsing {
+
+class Layer;
+
+/**
+ * Samples the height layers of a globe on the CPU. The raw values of the height tiles
+ * that have been sampled recently are kept as floating point copies, which makes the
+ * sampling of many positions that fall into the same tiles cheap. The cached tiles are
+ * compared against the tile providers again once for each call to #startFrame, which
+ * means that the heights might lag behind newly loaded tiles by a frame.
+ */
+class HeightSampler {
+public:
+    /**
+     * The CPU copy of the raw values of a single tile of a height layer.
+     */
+    struct HeightTile {
+        /**
+         * Returns the bilinearly interpolated raw value at the \p patchUv coordinates,
+         * which are relative to the patch that the tile was requested for. If any of the
+         * interpolated values is NaN or equal to the #noDataValue, NaN is returned.
+         */
+        float sample(const glm::vec2& patchUv) const;
+
+        glm::uvec2 dimensions = glm::uvec2(0);
+        /// The raw values of the tile, row by row
+        std::vector<float> values;
+        TileUvTransform uvTransform;
+        TileDepthTransform depthTransform;
+        float noDataValue = 0.f;
+    };
+
+    /**
+     * Creates a sampler that keeps the height tiles of at most \p maxTiles tile indices.
+     */
+    explicit HeightSampler(size_t maxTiles);
+
+    /**
+     * Causes the cached tiles to be compared against the tile providers before they are
+     * used the next time. This function should be called once per frame.
+     */
+    void startFrame();
+
+    /**
+     * Removes all cached tiles. This has to be called whenever the height layers are
+     * added, removed, or reordered.
+     */
+    void clear();
+
+    /**
+     * Returns the height of the \p layers at the \p patchUv coordinates within the patch
+     * of the \p tileIndex. The last layer that has valid data at the position determines
+     * the height. If the tile of any layer is not available, 0 is returned.
+     *
+     * \param tileIndex The index of the tile that contains the position
+     * \param patchUv The position within the patch of the \p tileIndex, where (0,0) is
+     *        the south west corner and (1,1) the north east corner
+     * \param layers The active height layers of the globe
+     * \return The height in meters above the reference ellipsoid
+     */
+    float height(const TileIndex& tileIndex, const glm::vec2& patchUv,
+        const std::vector<Layer*>& layers);
+
+private:
+    struct LayerTile {
+        // Only used to detect changes and never dereferenced
+        const Layer* layer = nullptr;
+        const ghoul::opengl::Texture* texture = nullptr;
+        const void* pixelData = nullptr;
+        HeightTile tile;
+    };
+
+    struct Entry {
+        std::vector<LayerTile> layers;
+        bool isComplete = false;
+        uint64_t frame = 0;
+    };
+
+    Entry& entry(const TileIndex& tileIndex, const std::vector<Layer*>& layers);
+    void updateEntry(Entry& entry, const TileIndex& tileIndex,
+        const std::vector<Layer*>& layers) const;
+
+    cache::LRUCache<
+        TileIndex::TileHashKey, std::shared_ptr<Entry>, std::hash<TileIndex::TileHashKey>
+    > _tiles;
+
+    uint64_t _frame = 1;
+
+    // Consecutive samples often fall into the same tile, which skips the cache lookup
+    TileIndex::TileHashKey _lastKey = 0;
+    std::shared_ptr<Entry> _lastEntry;
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___HEIGHTSAMPLER___H__
@@ -25,6 +25,7 @@
 #ifndef __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 #define __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 
+#include <iterator>
 #include <list>
 #include <unordered_map>
 #include <vector>
@@ -48,6 +49,15 @@ public:
 
     void put(KeyType key, ValueType value);
     std::vector<Item> putAndFetchPopped(KeyType key, ValueType value);
+
+    /**
+     * Adds the value to the back of the queue so that it is the first one to be evicted.
+     * Contrary to #put, no other item is evicted. If the cache is full or the \p key
+     * already exists, nothing is added.
+     *
+     * \return `true` if the value was added
+     */
+    bool putLRU(KeyType key, ValueType value);
     void clear();
     bool exist(const KeyType& key) const;
 
@@ -52,6 +52,16 @@ LRUCache<KeyType, ValueType, HasherType>::putAndFetchPopped(KeyType key, ValueTy
     return cleanAndFetchPopped();
 }
 
+template<typename KeyType, typename ValueType, typename HasherType>
+bool LRUCache<KeyType, ValueType, HasherType>::putLRU(KeyType key, ValueType value) {
+    if (_itemMap.size() >= _maximumCacheSize || _itemMap.contains(key)) {
+        return false;
+    }
+    _itemList.emplace_back(key, std::move(value));
+    _itemMap.emplace(std::move(key), std::prev(_itemList.end()));
+    return true;
+}
+
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::exist(const KeyType& key) const {
     return (_itemMap.count(key) > 0);
@@ -26,28 +26,15 @@
 #define __OPENSPACE_MODULE_GLOBEBROWSING___LRU_THREAD_POOL___H__
 
 #include <modules/globebrowsing/src/lrucache.h>
+#include <openspace/util/taskscheduler.h>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <thread>
 #include <vector>
 
-// Implementation based on http://progsch.net/wordpress/?p=81
-
 namespace openspace::globebrowsing {
 
-template<typename KeyType> class LRUThreadPool;
-
-template<typename KeyType>
-class LRUThreadPoolWorker {
-public:
-    LRUThreadPoolWorker(LRUThreadPool<KeyType>& pool);
-    void operator()();
-
-private:
-    LRUThreadPool<KeyType>& _pool;
-};
-
 /**
  * The `LRUThreadPool` will only enqueue a certain number of tasks. The most recently
  * enqueued task is the one that will be executed first. This class is templated on a key
@@ -57,15 +44,36 @@ private:
  * second enqueued task with the same key. This is because a second enqueued task with the
  * same key will simply be bumped and prioritised before other enqueued tasks. The given
  * task will be ignored.
+ *
+ * The tasks are executed by a TaskScheduler that is either owned by the pool or shared
+ * with other users. For every enqueued task, a small job is posted to the scheduler that
+ * pops and executes the most recently used task at the time it runs.
  */
 template<typename KeyType>
 class LRUThreadPool {
 public:
     LRUThreadPool(size_t numThreads, size_t queueSize);
+
+    /**
+     * Creates a pool that executes its tasks on the provided \p scheduler with the
+     * provided \p priority. The \p scheduler has to outlive this object.
+     */
+    LRUThreadPool(TaskScheduler& scheduler, size_t queueSize,
+        TaskScheduler::Priority priority = TaskScheduler::Priority::Normal);
+
     LRUThreadPool(const LRUThreadPool& toCopy);
     ~LRUThreadPool();
 
     void enqueue(std::function<void()> f, KeyType key);
+
+    /**
+     * Enqueues a task behind all other tasks. The task is not enqueued if the queue is
+     * already full, and it is the first task to be pushed out of the queue when new
+     * tasks are enqueued with #enqueue.
+     *
+     * \return `true` if the task was enqueued
+     */
+    bool enqueueLowPriority(std::function<void()> f, KeyType key);
     bool touch(KeyType key);
     std::vector<KeyType> getQueuedTasksKeys();
     std::vector<KeyType> getUnqueuedTasksKeys();
@@ -77,15 +85,26 @@ private:
             return static_cast<unsigned long long>(key);
         }
     };
-    friend class LRUThreadPoolWorker<KeyType>;
 
-    std::vector<std::thread> _workers;
-    cache::LRUCache<KeyType, std::function<void()>, DefaultHasher> _queuedTasks;
-    std::vector<KeyType> _unqueuedTasks;
-    std::mutex _queueMutex;
-    std::condition_variable _condition;
+    /// State shared with the jobs that were posted to the scheduler, as they might
+    /// outlive this pool when the scheduler is shared
+    struct State {
+        State(size_t queueSize);
+
+        cache::LRUCache<KeyType, std::function<void()>, DefaultHasher> queuedTasks;
+        std::vector<KeyType> unqueuedTasks;
+        std::mutex queueMutex;
+        std::condition_variable condition;
+        size_t nRunning = 0;
+        bool stop = false;
+    };
+
+    static void runNextTask(const std::shared_ptr<State>& state);
 
-    bool _stop = false;
+    std::shared_ptr<State> _state;
+    std::unique_ptr<TaskScheduler> _ownedScheduler;
+    TaskScheduler* _scheduler = nullptr;
+    TaskScheduler::Priority _priority = TaskScheduler::Priority::Normal;
 };
 
 } // namespace openspace::globebrowsing
@@ -25,100 +25,125 @@
 namespace openspace::globebrowsing {
 
 template<typename KeyType>
-LRUThreadPoolWorker<KeyType>::LRUThreadPoolWorker(LRUThreadPool<KeyType>& pool)
-    : _pool(pool)
+LRUThreadPool<KeyType>::State::State(size_t queueSize)
+    : queuedTasks(queueSize)
 {}
 
 template<typename KeyType>
-void LRUThreadPoolWorker<KeyType>::operator()() {
+void LRUThreadPool<KeyType>::runNextTask(const std::shared_ptr<State>& state) {
     std::function<void()> task;
-    while (true) {
-        // acquire lock
-        {
-            std::unique_lock lock(_pool._queueMutex);
-
-            // look for a work item
-            while (!_pool._stop && _pool._queuedTasks.isEmpty()) {
-                // if there are none wait for notification
-                _pool._condition.wait(lock);
-            }
+    {
+        std::unique_lock lock(state->queueMutex);
 
-            if (_pool._stop) { // exit if the pool is stopped
-                return;
-            }
+        // There are at least as many jobs posted to the scheduler as there are tasks in
+        // the queue, so the queue might already have been emptied by an earlier job, by
+        // `clearEnqueuedTasks`, or because the task was pushed out of the cache
+        if (state->stop || state->queuedTasks.isEmpty()) {
+            return;
+        }
 
-            // get the task from the queue
-            task = _pool._queuedTasks.popMRU().second;
+        task = state->queuedTasks.popMRU().second;
+        state->nRunning++;
+    }
 
-        }// release lock
+    task();
 
-        // execute the task
-        task();
+    {
+        std::unique_lock lock(state->queueMutex);
+        state->nRunning--;
     }
+    state->condition.notify_all();
 }
 
 template<typename KeyType>
 LRUThreadPool<KeyType>::LRUThreadPool(size_t numThreads, size_t queueSize)
-    : _queuedTasks(queueSize)
-{
-    for (size_t i = 0; i < numThreads; i++) {
-        _workers.push_back(std::thread(LRUThreadPoolWorker<KeyType>(*this)));
-    }
-}
+    : _state(std::make_shared<State>(queueSize))
+    , _ownedScheduler(std::make_unique<TaskScheduler>(numThreads))
+    , _scheduler(_ownedScheduler.get())
+{}
+
+template<typename KeyType>
+LRUThreadPool<KeyType>::LRUThreadPool(TaskScheduler& scheduler, size_t queueSize,
+                                      TaskScheduler::Priority priority)
+    : _state(std::make_shared<State>(queueSize))
+    , _scheduler(&scheduler)
+    , _priority(priority)
+{}
 
 template<typename KeyType>
 LRUThreadPool<KeyType>::LRUThreadPool(const LRUThreadPool& toCopy)
-    : LRUThreadPool(toCopy._workers.size(), toCopy._queuedTasks.maximumCacheSize())
+    : _state(std::make_shared<State>(toCopy._state->queuedTasks.maximumCacheSize()))
+    , _ownedScheduler(
+        toCopy._ownedScheduler ?
+            std::make_unique<TaskScheduler>(toCopy._ownedScheduler->numThreads()) :
+            nullptr
+    )
+    , _scheduler(_ownedScheduler ? _ownedScheduler.get() : toCopy._scheduler)
+    , _priority(toCopy._priority)
 {}
 
-// the destructor joins all threads
+// the destructor waits for all running tasks
 template<typename KeyType>
 LRUThreadPool<KeyType>::~LRUThreadPool() {
     {
-        std::unique_lock lock(_queueMutex);
-        _stop = true;
+        std::unique_lock lock(_state->queueMutex);
+        _state->stop = true;
+        _state->condition.wait(lock, [this]() { return _state->nRunning == 0; });
     }
-    _condition.notify_all();
 
-    // join them
-    for (size_t i = 0; i < _workers.size(); i++) {
-        _workers[i].join();
-    }
+    // Joins the threads of an owned scheduler; jobs that are still queued in a shared
+    // scheduler will see the `stop` flag and return immediately
+    _ownedScheduler = nullptr;
 }
 
 // add new work item to the pool
 template<typename KeyType>
 void LRUThreadPool<KeyType>::enqueue(std::function<void()> f, KeyType key) {
     {
-        std::unique_lock<std::mutex> lock(_queueMutex);
+        std::unique_lock<std::mutex> lock(_state->queueMutex);
 
         // add the task
-        //_queuedTasks.put(key, f);
         const std::vector<std::pair<KeyType, std::function<void()>>>& unfinishedTasks =
-            _queuedTasks.putAndFetchPopped(key, f);
+            _state->queuedTasks.putAndFetchPopped(key, std::move(f));
         for (const std::pair<KeyType, std::function<void()>>& unfinishedTask :
              unfinishedTasks)
         {
-            _unqueuedTasks.push_back(unfinishedTask.first);
+            _state->unqueuedTasks.push_back(unfinishedTask.first);
+        }
+    }
+
+    // post a job that will pick up the most recent task once a worker is available
+    _scheduler->enqueue([state = _state]() { runNextTask(state); }, _priority);
+}
+
+template<typename KeyType>
+bool LRUThreadPool<KeyType>::enqueueLowPriority(std::function<void()> f, KeyType key) {
+    {
+        std::unique_lock<std::mutex> lock(_state->queueMutex);
+        if (!_state->queuedTasks.putLRU(key, std::move(f))) {
+            return false;
         }
     }
 
-    // wake up one thread
-    _condition.notify_one();
+    _scheduler->enqueue(
+        [state = _state]() { runNextTask(state); },
+        TaskScheduler::Priority::Low
+    );
+    return true;
 }
 
 template<typename KeyType>
 bool LRUThreadPool<KeyType>::touch(KeyType key) {
-    std::unique_lock<std::mutex> lock(_queueMutex);
-    return _queuedTasks.touch(key);
+    std::unique_lock<std::mutex> lock(_state->queueMutex);
+    return _state->queuedTasks.touch(key);
 }
 
 template<typename KeyType>
 std::vector<KeyType> LRUThreadPool<KeyType>::getUnqueuedTasksKeys() {
-    std::vector<KeyType> toReturn = _unqueuedTasks;
+    std::vector<KeyType> toReturn;
     {
-        std::unique_lock<std::mutex> lock(_queueMutex);
-        _unqueuedTasks.clear();
+        std::unique_lock<std::mutex> lock(_state->queueMutex);
+        toReturn.swap(_state->unqueuedTasks);
     }
     return toReturn;
 }
@@ -127,9 +152,9 @@ template<typename KeyType>
 std::vector<KeyType> LRUThreadPool<KeyType>::getQueuedTasksKeys() {
     std::vector<KeyType> queuedTasks;
     {
-        std::unique_lock<std::mutex> lock(_queueMutex);
-        while (!_queuedTasks.isEmpty()) {
-            queuedTasks.push_back(_queuedTasks.popMRU().first);
+        std::unique_lock<std::mutex> lock(_state->queueMutex);
+        while (!_state->queuedTasks.isEmpty()) {
+            queuedTasks.push_back(_state->queuedTasks.popMRU().first);
         }
     }
     return queuedTasks;
@@ -137,8 +162,8 @@ std::vector<KeyType> LRUThreadPool<KeyType>::getQueuedTasksKeys() {
 
 template<typename KeyType>
 void LRUThreadPool<KeyType>::clearEnqueuedTasks() {
-    std::unique_lock<std::mutex> lock(_queueMutex);
-    _queuedTasks.clear();
+    std::unique_lock<std::mutex> lock(_state->queueMutex);
+    _state->queuedTasks.clear();
 }
 
 } // namespace openspace::globebrowsing
@@ -0,0 +1,236 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/lz4block.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace {
+    constexpr size_t MinMatch = 4;
+    // The last match has to start at least 12 bytes before the end of the block and the
+    // last 5 bytes are always literals
+    constexpr size_t MatchFindLimit = 12;
+    constexpr size_t LastLiterals = 5;
+    constexpr size_t MaxOffset = 65535;
+
+    constexpr int HashLog = 12;
+
+    uint32_t read32(const std::byte* p) {
+        uint32_t v = 0;
+        std::memcpy(&v, p, sizeof(uint32_t));
+        return v;
+    }
+
+    uint32_t hash(uint32_t sequence) {
+        return (sequence * 2654435761U) >> (32 - HashLog);
+    }
+
+    // Writes the length \p length that did not fit into the token as a run of bytes
+    bool writeLength(size_t length, std::byte*& op, const std::byte* end) {
+        while (length >= 255) {
+            if (op >= end) {
+                return false;
+            }
+            *op++ = std::byte(255);
+            length -= 255;
+        }
+        if (op >= end) {
+            return false;
+        }
+        *op++ = static_cast<std::byte>(length);
+        return true;
+    }
+
+    bool readLength(size_t& length, const std::byte*& ip, const std::byte* end) {
+        uint8_t b = 255;
+        while (b == 255) {
+            if (ip >= end) {
+                return false;
+            }
+            b = static_cast<uint8_t>(*ip++);
+            length += b;
+        }
+        return true;
+    }
+
+    bool writeSequence(const std::byte* literals, size_t nLiterals, size_t offset,
+                       size_t matchLength, std::byte*& op, const std::byte* end)
+    {
+        if (op >= end) {
+            return false;
+        }
+        std::byte* token = op++;
+        uint8_t tokenValue = static_cast<uint8_t>(std::min<size_t>(nLiterals, 15) << 4);
+        if (nLiterals >= 15 && !writeLength(nLiterals - 15, op, end)) {
+            return false;
+        }
+        if (static_cast<size_t>(end - op) < nLiterals) {
+            return false;
+        }
+        std::memcpy(op, literals, nLiterals);
+        op += nLiterals;
+
+        // The last sequence only consists of literals
+        if (matchLength > 0) {
+            if (end - op < 2) {
+                return false;
+            }
+            *op++ = static_cast<std::byte>(offset & 0xFF);
+            *op++ = static_cast<std::byte>(offset >> 8);
+
+            const size_t length = matchLength - MinMatch;
+            tokenValue |= static_cast<uint8_t>(std::min<size_t>(length, 15));
+            if (length >= 15 && !writeLength(length - 15, op, end)) {
+                return false;
+            }
+        }
+        *token = static_cast<std::byte>(tokenValue);
+        return true;
+    }
+} // namespace
+
+namespace openspace::globebrowsing::lz4 {
+
+size_t compressBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t compress(const std::byte* src, size_t srcSize, std::byte* dst,
+                size_t dstCapacity)
+{
+    if (srcSize > std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    std::byte* op = dst;
+    const std::byte* end = dst + dstCapacity;
+    size_t anchor = 0;
+
+    if (srcSize > MatchFindLimit) {
+        // Most recent position of every hashed 4-byte sequence
+        std::array<uint32_t, 1 << HashLog> table;
+        table.fill(std::numeric_limits<uint32_t>::max());
+
+        const size_t matchLimit = srcSize - MatchFindLimit;
+        const size_t matchEnd = srcSize - LastLiterals;
+        size_t ip = 0;
+        while (ip < matchLimit) {
+            const uint32_t sequence = read32(src + ip);
+            const uint32_t h = hash(sequence);
+            const uint32_t ref = table[h];
+            table[h] = static_cast<uint32_t>(ip);
+
+            if (ref == std::numeric_limits<uint32_t>::max() || ip - ref > MaxOffset ||
+                read32(src + ref) != sequence)
+            {
+                ip++;
+                continue;
+            }
+
+            size_t length = MinMatch;
+            while (ip + length < matchEnd && src[ref + length] == src[ip + length]) {
+                length++;
+            }
+
+            const bool success = writeSequence(
+                src + anchor,
+                ip - anchor,
+                ip - ref,
+                length,
+                op,
+                end
+            );
+            if (!success) {
+                return 0;
+            }
+            ip += length;
+            anchor = ip;
+        }
+    }
+
+    const bool success = writeSequence(src + anchor, srcSize - anchor, 0, 0, op, end);
+    return success ? static_cast<size_t>(op - dst) : 0;
+}
+
+bool decompress(const std::byte* src, size_t srcSize, std::byte* dst, size_t dstSize) {
+    const std::byte* ip = src;
+    const std::byte* inEnd = src + srcSize;
+    std::byte* op = dst;
+    const std::byte* outEnd = dst + dstSize;
+
+    while (ip < inEnd) {
+        const uint8_t token = static_cast<uint8_t>(*ip++);
+
+        size_t nLiterals = token >> 4;
+        if (nLiterals == 15 && !readLength(nLiterals, ip, inEnd)) {
+            return false;
+        }
+        if (static_cast<size_t>(inEnd - ip) < nLiterals ||
+            static_cast<size_t>(outEnd - op) < nLiterals)
+        {
+            return false;
+        }
+        std::memcpy(op, ip, nLiterals);
+        ip += nLiterals;
+        op += nLiterals;
+
+        // The last sequence only contains literals
+        if (ip == inEnd) {
+            break;
+        }
+
+        if (inEnd - ip < 2) {
+            return false;
+        }
+        const size_t offset =
+            static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+            return false;
+        }
+
+        size_t length = token & 0xF;
+        if (length == 15 && !readLength(length, ip, inEnd)) {
+            return false;
+        }
+        length += MinMatch;
+        if (static_cast<size_t>(outEnd - op) < length) {
+            return false;
+        }
+
+        // The match can overlap with the bytes that are written, so copy byte by byte
+        const std::byte* match = op - offset;
+        for (size_t i = 0; i < length; i++) {
+            op[i] = match[i];
+        }
+        op += length;
+    }
+    return op == outEnd;
+}
+
+} // namespace openspace::globebrowsing::lz4
@@ -0,0 +1,65 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___LZ4BLOCK___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___LZ4BLOCK___H__
+
+#include <cstddef>
+
+namespace openspace::globebrowsing::lz4 {
+
+/**
+ * \return The maximum number of bytes that #compress can produce for \p size bytes of
+ *         input
+ */
+size_t compressBound(size_t size);
+
+/**
+ * Compresses \p srcSize bytes from \p src into \p dst using the LZ4 block format. The
+ * result can be decompressed with any LZ4 implementation that supports raw blocks.
+ *
+ * \param src The data that should be compressed
+ * \param srcSize The number of bytes in \p src
+ * \param dst The destination of the compressed data
+ * \param dstCapacity The number of bytes that can be written to \p dst
+ * \return The number of bytes written to \p dst, or 0 if the compressed data does not
+ *         fit into \p dstCapacity bytes
+ */
+size_t compress(const std::byte* src, size_t srcSize, std::byte* dst,
+    size_t dstCapacity);
+
+/**
+ * Decompresses a block in the LZ4 block format.
+ *
+ * \param src The compressed data
+ * \param srcSize The number of bytes in \p src
+ * \param dst The destination of the decompressed data
+ * \param dstSize The number of bytes that the decompressed data has
+ * \return `true` if the block was valid and decompressed to exactly \p dstSize bytes
+ */
+bool decompress(const std::byte* src, size_t srcSize, std::byte* dst, size_t dstSize);
+
+} // namespace openspace::globebrowsing::lz4
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___LZ4BLOCK___H__
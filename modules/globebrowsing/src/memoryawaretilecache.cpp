@@ -30,6 +30,9 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/systemcapabilities/generalcapabilitiescomponent.h>
 #include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <numeric>
 
 namespace {
@@ -72,6 +75,47 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo UploadTimeBudgetInfo = {
+        "UploadTimeBudget",
+        "Upload Time Budget (ms)",
+        "The maximum time in milliseconds that is spent per frame on uploading tiles "
+        "that have finished loading to the GPU. Tiles that do not fit into the budget "
+        "are uploaded in later frames. The budget is shared with the vector tiles of "
+        "GeoJson layers. A value of 0 disables the limit. At least one tile is "
+        "uploaded every frame, regardless of this value",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo UploadByteBudgetInfo = {
+        "UploadByteBudget",
+        "Upload Byte Budget (MB)",
+        "The maximum amount of tile data in MB that is uploaded to the GPU per frame. "
+        "Tiles that do not fit into the budget are uploaded in later frames. A value of "
+        "0 disables the limit. At least one tile is uploaded every frame, regardless of "
+        "this value",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo UsePixelBuffersInfo = {
+        "UsePixelBuffers",
+        "Use Pixel Buffers",
+        "If this value is enabled, tiles are uploaded through pixel buffer objects, "
+        "which lets the driver perform the transfer asynchronously. Otherwise, the tile "
+        "data is uploaded directly from memory",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PendingUploadsInfo = {
+        "PendingUploads",
+        "Pending Uploads",
+        "The number of tiles that have finished loading and are waiting to be uploaded "
+        "to the GPU",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    // The number of pixel buffers that the uploads cycle through
+    constexpr size_t NStagingBuffers = 4;
+
     GLenum toGlTextureFormat(GLenum glType, ghoul::opengl::Texture::Format format) {
         switch (format) {
             case ghoul::opengl::Texture::Format::Red:
@@ -188,7 +232,89 @@ namespace {
         }
     }
 
+    GLenum toGlCompressedTextureFormat(
+                           openspace::globebrowsing::TileTextureInitData::Compression c)
+    {
+        using Compression = openspace::globebrowsing::TileTextureInitData::Compression;
+        switch (c) {
+            case Compression::BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+            case Compression::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+            default:               throw ghoul::MissingCaseException();
+        }
+    }
+
+    // Allocates the storage for all mipmap levels of a compressed texture. The ghoul
+    // texture can neither allocate compressed storage nor use mipmaps for it, as it would
+    // generate them on the GPU, so the storage and sampling is set up directly instead
+    void allocateCompressedTexture(ghoul::opengl::Texture& texture,
+                       const openspace::globebrowsing::TileTextureInitData& initData)
+    {
+        using namespace openspace::globebrowsing;
+
+        const GLenum format = toGlCompressedTextureFormat(initData.compression);
+        const int nLevels =
+            nCompressedMipLevels(initData.dimensions.x, initData.dimensions.y);
+
+        texture.bind();
+        for (int level = 0; level < nLevels; level++) {
+            const int w = initData.dimensions.x >> level;
+            const int h = initData.dimensions.y >> level;
+            glCompressedTexImage2D(
+                GL_TEXTURE_2D,
+                level,
+                format,
+                w,
+                h,
+                0,
+                static_cast<GLsizei>(compressedLevelSize(initData.compression, w, h)),
+                nullptr
+            );
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, nLevels - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
 
+    // Uploads the compressed mipmap chain of a tile either from the pixel buffer \p pbo
+    // or, if that is 0, from the \p data in memory
+    void uploadCompressedTexture(ghoul::opengl::Texture& texture,
+                       const openspace::globebrowsing::TileTextureInitData& initData,
+                                                      GLuint pbo, const std::byte* data)
+    {
+        using namespace openspace::globebrowsing;
+
+        const GLenum format = toGlCompressedTextureFormat(initData.compression);
+        const int nLevels =
+            nCompressedMipLevels(initData.dimensions.x, initData.dimensions.y);
+
+        texture.bind();
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+        size_t offset = 0;
+        for (int level = 0; level < nLevels; level++) {
+            const int w = initData.dimensions.x >> level;
+            const int h = initData.dimensions.y >> level;
+            const size_t nBytes = compressedLevelSize(initData.compression, w, h);
+            // With a bound pixel buffer, the data pointer is an offset into the buffer
+            const void* levelData =
+                pbo != 0 ? reinterpret_cast<const void*>(offset) : data + offset;
+            glCompressedTexSubImage2D(
+                GL_TEXTURE_2D,
+                level,
+                0,
+                0,
+                w,
+                h,
+                format,
+                static_cast<GLsizei>(nBytes),
+                levelData
+            );
+            offset += nBytes;
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
 } // namespace
 
 namespace openspace::globebrowsing::cache {
@@ -225,6 +351,22 @@ void MemoryAwareTileCache::TextureContainer::reset() {
 
         using namespace ghoul::opengl;
 
+        if (_initData.compression != TileTextureInitData::Compression::None) {
+            std::unique_ptr<Texture> tex = std::make_unique<Texture>(
+                _initData.dimensions,
+                GL_TEXTURE_2D,
+                _initData.ghoulTextureFormat,
+                toGlCompressedTextureFormat(_initData.compression),
+                _initData.glType,
+                Texture::FilterMode::Linear,
+                Texture::WrappingMode::ClampToEdge,
+                Texture::AllocateData::No
+            );
+            allocateCompressedTexture(*tex, _initData);
+            _textures.push_back(std::move(tex));
+            continue;
+        }
+
         std::unique_ptr<Texture> tex = std::make_unique<Texture>(
             _initData.dimensions,
             GL_TEXTURE_2D,
@@ -272,6 +414,43 @@ size_t MemoryAwareTileCache::TextureContainer::size() const {
     return _textures.size();
 }
 
+//
+// StagingBufferRing
+//
+MemoryAwareTileCache::StagingBufferRing::StagingBufferRing(size_t nBuffers)
+    : _buffers(nBuffers, 0)
+{
+    glGenBuffers(static_cast<GLsizei>(_buffers.size()), _buffers.data());
+}
+
+MemoryAwareTileCache::StagingBufferRing::~StagingBufferRing() {
+    glDeleteBuffers(static_cast<GLsizei>(_buffers.size()), _buffers.data());
+}
+
+GLuint MemoryAwareTileCache::StagingBufferRing::stage(const std::byte* data,
+                                                      size_t nBytes)
+{
+    ZoneScoped;
+
+    const GLuint buffer = _buffers[_next];
+    _next = (_next + 1) % _buffers.size();
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    glBufferData(
+        GL_PIXEL_UNPACK_BUFFER,
+        static_cast<GLsizeiptr>(nBytes),
+        nullptr,
+        GL_STREAM_DRAW
+    );
+    void* mapped = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+    if (mapped) {
+        std::memcpy(mapped, data, nBytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return mapped ? buffer : 0;
+}
+
 //
 // MemoryAwareTileCache
 //
@@ -279,11 +458,16 @@ size_t MemoryAwareTileCache::TextureContainer::size() const {
 MemoryAwareTileCache::MemoryAwareTileCache(int tileCacheSize)
     : PropertyOwner({ "TileCache", "Tile Cache" })
     , _numTextureBytesAllocatedOnCPU(0)
+    , _stagingBuffers(NStagingBuffers)
     , _cpuAllocatedTileData(CpuAllocatedDataInfo, tileCacheSize, 128, 16384, 1)
     , _gpuAllocatedTileData(GpuAllocatedDataInfo, tileCacheSize, 128, 16384, 1)
     , _tileCacheSize(TileCacheSizeInfo, tileCacheSize, 128, 16384, 1)
     , _applyTileCacheSize(ApplyTileCacheInfo)
     , _clearTileCache(ClearTileCacheInfo)
+    , _uploadTimeBudget(UploadTimeBudgetInfo, 4.f, 0.f, 100.f)
+    , _uploadByteBudget(UploadByteBudgetInfo, 0, 0, 1024)
+    , _usePixelBuffers(UsePixelBuffersInfo, true)
+    , _pendingUploads(PendingUploadsInfo, 0, 0, std::numeric_limits<int>::max())
 {
     ZoneScoped;
 
@@ -314,6 +498,12 @@ MemoryAwareTileCache::MemoryAwareTileCache(int tileCacheSize)
     );
     addProperty(_tileCacheSize);
 
+    addProperty(_uploadTimeBudget);
+    addProperty(_uploadByteBudget);
+    addProperty(_usePixelBuffers);
+    _pendingUploads.setReadOnly(true);
+    addProperty(_pendingUploads);
+
     setSizeEstimated(uint64_t(_tileCacheSize) * 1024ul * 1024ul);
 }
 
@@ -326,6 +516,7 @@ void MemoryAwareTileCache::clear() {
         p.second.first->reset();
         p.second.second->clear();
     }
+    _uploadScheduler.clear();
     LINFO("Tile cache cleared");
 }
 
@@ -368,7 +559,7 @@ void MemoryAwareTileCache::setSizeEstimated(size_t estimatedSize) {
         [](size_t s, const std::pair<const TileTextureInitData::HashKey,
                                      TextureContainerTileCache>& p)
         {
-            return s + p.second.first->tileTextureInitData().totalNumBytes;
+            return s + p.second.first->tileTextureInitData().textureNumBytes;
         }
     );
 
@@ -457,7 +648,11 @@ void MemoryAwareTileCache::createTileAndPut(ProviderTileKey key, RawTile rawTile
         Texture* tex = texture(initData);
 
         // Re-upload texture, either using PBO or by using RAM data
-        if (rawTile.pbo != 0) {
+        if (initData.compression != TileTextureInitData::Compression::None) {
+            // Compressed tiles contain their own mipmaps and are never kept on the CPU
+            uploadCompressedTexture(*tex, initData, rawTile.pbo, rawTile.imageData.get());
+        }
+        else if (rawTile.pbo != 0) {
             tex->reUploadTextureFromPBO(rawTile.pbo);
             if (initData.shouldAllocateDataOnCPU) {
                 if (!tex->dataOwnership()) {
@@ -484,16 +679,18 @@ void MemoryAwareTileCache::createTileAndPut(ProviderTileKey key, RawTile rawTile
             _numTextureBytesAllocatedOnCPU += numBytes - previousExpectedDataSize;
             tex->reUploadTexture();
         }
-        // Hi there, I know someone will be tempted to change this to a Linear filtering
-        // mode at some point. This will introduce rendering artifacts when looking at the
-        // globe at oblique angles (see #2752)
-        using namespace ghoul::systemcapabilities;
-        const ghoul::opengl::Texture::FilterMode mode =
-            OpenGLCap.gpuVendor() == OpenGLCapabilitiesComponent::Vendor::AmdATI ?
-            ghoul::opengl::Texture::FilterMode::Linear :
-            ghoul::opengl::Texture::FilterMode::AnisotropicMipMap;
-
-        tex->setFilter(mode);
+        if (initData.compression == TileTextureInitData::Compression::None) {
+            // Hi there, I know someone will be tempted to change this to a Linear
+            // filtering mode at some point. This will introduce rendering artifacts when
+            // looking at the globe at oblique angles (see #2752)
+            using namespace ghoul::systemcapabilities;
+            const ghoul::opengl::Texture::FilterMode mode =
+                OpenGLCap.gpuVendor() == OpenGLCapabilitiesComponent::Vendor::AmdATI ?
+                ghoul::opengl::Texture::FilterMode::Linear :
+                ghoul::opengl::Texture::FilterMode::AnisotropicMipMap;
+
+            tex->setFilter(mode);
+        }
         Tile tile{ tex, std::move(rawTile.tileMetaData), Tile::Status::OK };
         const TileTextureInitData::HashKey initDataKey = initData.hashKey;
         _textureContainerMap[initDataKey].second->put(std::move(key), std::move(tile));
@@ -507,7 +704,47 @@ void MemoryAwareTileCache::put(const ProviderTileKey& key,
     _textureContainerMap[initDataKey].second->put(key, std::move(tile));
 }
 
+void MemoryAwareTileCache::enqueueUpload(ProviderTileKey key, RawTile rawTile) {
+    _uploadScheduler.enqueue(std::move(key), std::move(rawTile));
+}
+
+bool MemoryAwareTileCache::touchUpload(const ProviderTileKey& key) {
+    return _uploadScheduler.touch(key);
+}
+
+bool MemoryAwareTileCache::isUploadPending(const ProviderTileKey& key) const {
+    return _uploadScheduler.isPending(key);
+}
+
+void MemoryAwareTileCache::uploadTile(ProviderTileKey key, RawTile rawTile) {
+    ZoneScoped;
+
+    if (_usePixelBuffers && rawTile.pbo == 0) {
+        // If the staging fails, the tile is uploaded directly from memory instead
+        rawTile.pbo = _stagingBuffers.stage(
+            rawTile.imageData.get(),
+            rawTile.textureInitData->textureNumBytes
+        );
+    }
+    createTileAndPut(std::move(key), std::move(rawTile));
+}
+
 void MemoryAwareTileCache::update() {
+    ZoneScoped;
+
+    const TileUploadScheduler<ProviderTileKey, ProviderTileHasher>::Budget budget = {
+        .nBytes = static_cast<size_t>(_uploadByteBudget) * 1024 * 1024,
+        .milliseconds = remainingUploadTime()
+    };
+    _uploadScheduler.process(
+        budget,
+        [this](ProviderTileKey key, RawTile rawTile) {
+            uploadTile(std::move(key), std::move(rawTile));
+        }
+    );
+    _pendingUploads = static_cast<int>(_uploadScheduler.nPending());
+    _usedUploadTime = 0.0;
+
     const size_t dataSizeCPU = cpuAllocatedDataSize();
     const size_t dataSizeGPU = gpuAllocatedDataSize();
 
@@ -517,6 +754,18 @@ void MemoryAwareTileCache::update() {
     _gpuAllocatedTileData = static_cast<int>(dataSizeGPU / ByteToMegaByte);
 }
 
+double MemoryAwareTileCache::remainingUploadTime() const {
+    const double budget = _uploadTimeBudget;
+    if (budget <= 0.0) {
+        return 0.0;
+    }
+    return std::max(budget - _usedUploadTime, std::numeric_limits<double>::min());
+}
+
+void MemoryAwareTileCache::addUsedUploadTime(double milliseconds) {
+    _usedUploadTime += milliseconds;
+}
+
 size_t MemoryAwareTileCache::gpuAllocatedDataSize() const {
     return std::accumulate(
         _textureContainerMap.cbegin(),
@@ -526,7 +775,7 @@ size_t MemoryAwareTileCache::gpuAllocatedDataSize() const {
         TextureContainerTileCache>& p)
         {
             const TextureContainer& textureContainer = *p.second.first;
-            const size_t nBytes = textureContainer.tileTextureInitData().totalNumBytes;
+            const size_t nBytes = textureContainer.tileTextureInitData().textureNumBytes;
             return s + nBytes * textureContainer.size();
         }
     );
@@ -28,8 +28,10 @@
 #include <modules/globebrowsing/src/lrucache.h>
 #include <modules/globebrowsing/src/tileindex.h>
 #include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <modules/globebrowsing/src/tileuploadscheduler.h>
 #include <openspace/properties/propertyowner.h>
 #include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/triggerproperty.h>
 #include <memory>
@@ -94,8 +96,43 @@ public:
     void createTileAndPut(ProviderTileKey key, RawTile rawTile);
     void put(const ProviderTileKey& key,
         const TileTextureInitData::HashKey& initDataKey, Tile tile);
+
+    /**
+     * Adds the \p rawTile to the tiles that are uploaded to the GPU in one of the next
+     * calls to #update. The number of tiles that are uploaded per frame is limited by
+     * the upload budget.
+     */
+    void enqueueUpload(ProviderTileKey key, RawTile rawTile);
+
+    /**
+     * Marks the tile with the \p key as needed for rendering if it is waiting to be
+     * uploaded, which prioritizes it over other waiting tiles.
+     *
+     * \return `true` if the tile is waiting to be uploaded, `false` otherwise
+     */
+    bool touchUpload(const ProviderTileKey& key);
+    bool isUploadPending(const ProviderTileKey& key) const;
+
+    /**
+     * Uploads the waiting tiles that fit into the per-frame upload budget and updates the
+     * memory statistics. Has to be called once per frame.
+     */
     void update();
 
+    /**
+     * Returns the part of the per-frame upload time budget that has not been used in the
+     * current frame. Other uploads to the GPU, such as the vector tiles of GeoJson
+     * layers, share the budget with the tiles and have to report the time they used
+     * through #addUsedUploadTime. The tiles get the remaining budget in #update.
+     *
+     * \return The remaining time in milliseconds, or 0 if the budget is unlimited. If
+     *         the budget is used up, the smallest positive value is returned, which
+     *         permits a single upload
+     */
+    double remainingUploadTime() const;
+
+    void addUsedUploadTime(double milliseconds);
+
     size_t gpuAllocatedDataSize() const;
     size_t cpuAllocatedDataSize() const;
 
@@ -140,6 +177,31 @@ private:
     };
 
 
+    /**
+     * A ring of pixel buffer objects through which tiles are uploaded to their textures.
+     * The storage of a buffer is orphaned before it is written to, so the transfer out
+     * of the previous storage can still be in flight while the next tile is staged. The
+     * transfers into the textures are then performed asynchronously by the driver.
+     */
+    class StagingBufferRing {
+    public:
+        explicit StagingBufferRing(size_t nBuffers);
+        ~StagingBufferRing();
+
+        /**
+         * Copies \p nBytes of \p data into the next buffer of the ring.
+         *
+         * \return The name of the buffer or 0 if the data could not be staged
+         */
+        GLuint stage(const std::byte* data, size_t nBytes);
+
+    private:
+        std::vector<GLuint> _buffers;
+        size_t _next = 0;
+    };
+
+    void uploadTile(ProviderTileKey key, RawTile rawTile);
+
     void createDefaultTextureContainers();
     void assureTextureContainerExists(const TileTextureInitData& initData);
     void resetTextureContainerSize(size_t numTexturesPerTextureType);
@@ -157,12 +219,21 @@ private:
     TextureContainerMap _textureContainerMap;
     size_t _numTextureBytesAllocatedOnCPU;
 
+    TileUploadScheduler<ProviderTileKey, ProviderTileHasher> _uploadScheduler;
+    /// The upload time in milliseconds that other uploads used in the current frame
+    double _usedUploadTime = 0.0;
+    StagingBufferRing _stagingBuffers;
+
     // Properties
     properties::IntProperty _cpuAllocatedTileData;
     properties::IntProperty _gpuAllocatedTileData;
     properties::IntProperty _tileCacheSize;
     properties::TriggerProperty _applyTileCacheSize;
     properties::TriggerProperty _clearTileCache;
+    properties::FloatProperty _uploadTimeBudget;
+    properties::IntProperty _uploadByteBudget;
+    properties::BoolProperty _usePixelBuffers;
+    properties::IntProperty _pendingUploads;
 };
 
 } // namespace openspace::globebrowsing::cache
@@ -26,8 +26,10 @@
 #define __OPENSPACE_MODULE_GLOBEBROWSING___PRIORITIZING_CONCURRENT_JOB_MANAGER___H__
 
 #include <modules/globebrowsing/src/lruthreadpool.h>
-#include <openspace/util/concurrentqueue.h>
+#include <openspace/util/lockfreeconcurrentqueue.h>
+#include <atomic>
 #include <mutex>
+#include <vector>
 
 namespace openspace { template <typename T> struct Job; }
 
@@ -42,13 +44,28 @@ namespace openspace::globebrowsing {
 template<typename P, typename KeyType>
 class PrioritizingConcurrentJobManager {
 public:
-    PrioritizingConcurrentJobManager(LRUThreadPool<KeyType> pool);
+    /**
+     * \param pool The thread pool on which the jobs are executed
+     * \param finishedJobsCapacity The number of finished jobs that can be waiting to be
+     *        picked up in the lock-free queue. Jobs that finish while the queue is full
+     *        are stored in a separate, mutex protected list instead
+     */
+    PrioritizingConcurrentJobManager(LRUThreadPool<KeyType> pool,
+        size_t finishedJobsCapacity = 256);
 
     /**
      * Enqueues a job which is identified using a given key.
      */
     void enqueueJob(std::shared_ptr<Job<P>> job, KeyType key);
 
+    /**
+     * Enqueues a job that is only executed once all jobs enqueued with #enqueueJob have
+     * been started. The job is dropped if the queue is already full.
+     *
+     * \return `true` if the job was enqueued
+     */
+    bool enqueueLowPriorityJob(std::shared_ptr<Job<P>> job, KeyType key);
+
     /**
      * The keys returned by this function have been popped from the queue and corresponds
      * to jobs that will not be executed and therefore marked as unfinished. Calling this
@@ -76,15 +93,22 @@ public:
     void clearEnqueuedJobs();
 
     /**
-     * \return one finished job
+     * Moves all jobs that are finished at the time of the call into \p jobs, which is
+     * not cleared beforehand.
+     *
+     * \return The number of jobs that were added to \p jobs
      */
-    std::shared_ptr<Job<P>> popFinishedJob();
+    size_t popFinishedJobs(std::vector<std::shared_ptr<Job<P>>>& jobs);
 
     size_t numFinishedJobs() const;
 
 private:
-    ConcurrentQueue<std::shared_ptr<Job<P>>> _finishedJobs;
-    std::mutex _finishedJobsMutex;
+    void pushFinishedJob(std::shared_ptr<Job<P>> job);
+
+    LockFreeConcurrentQueue<std::shared_ptr<Job<P>>> _finishedJobs;
+    mutable std::mutex _overflowMutex;
+    std::vector<std::shared_ptr<Job<P>>> _overflowJobs;
+    std::atomic_bool _hasOverflowJobs = false;
     /// An LRU thread pool is used since the jobs can be bumped and hence prioritized
     LRUThreadPool<KeyType> _threadPool;
 };
@@ -22,24 +22,36 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
-#include <ghoul/misc/assert.h>
+#include <iterator>
 
 namespace openspace::globebrowsing {
 
 template <typename P, typename KeyType>
 PrioritizingConcurrentJobManager<P, KeyType>::PrioritizingConcurrentJobManager(
-                                                              LRUThreadPool<KeyType> pool)
-    : _threadPool(std::move(pool))
+                                                              LRUThreadPool<KeyType> pool,
+                                                              size_t finishedJobsCapacity)
+    : _finishedJobs(finishedJobsCapacity)
+    , _threadPool(std::move(pool))
 {}
 
 template <typename P, typename KeyType>
 void PrioritizingConcurrentJobManager<P, KeyType>::enqueueJob(std::shared_ptr<Job<P>> job,
                                                               KeyType key)
 {
-    _threadPool.enqueue([this, job]() {
+    _threadPool.enqueue([this, job]() mutable {
         job->execute();
-        std::lock_guard lock(_finishedJobsMutex);
-        _finishedJobs.push(job);
+        pushFinishedJob(std::move(job));
+    }, key);
+}
+
+template <typename P, typename KeyType>
+bool PrioritizingConcurrentJobManager<P, KeyType>::enqueueLowPriorityJob(
+                                                              std::shared_ptr<Job<P>> job,
+                                                                              KeyType key)
+{
+    return _threadPool.enqueueLowPriority([this, job]() mutable {
+        job->execute();
+        pushFinishedJob(std::move(job));
     }, key);
 }
 
@@ -66,17 +78,53 @@ void PrioritizingConcurrentJobManager<P, KeyType>::clearEnqueuedJobs() {
 }
 
 template <typename P, typename KeyType>
-std::shared_ptr<Job<P>> PrioritizingConcurrentJobManager<P, KeyType>::popFinishedJob() {
-    ghoul_assert(!_finishedJobs.empty(), "There is no finished job to pop");
+size_t PrioritizingConcurrentJobManager<P, KeyType>::popFinishedJobs(
+                                               std::vector<std::shared_ptr<Job<P>>>& jobs)
+{
+    // Reserving for the snapshot size lets us drain everything with a single call into
+    // the queue in the common case
+    jobs.reserve(jobs.size() + _finishedJobs.size());
+    size_t nPopped =
+        _finishedJobs.tryPopBulk(std::back_inserter(jobs), _finishedJobs.capacity());
 
-    std::lock_guard lock(_finishedJobsMutex);
-    std::shared_ptr<Job<P>> result = _finishedJobs.pop();
-    return result;
+    if (_hasOverflowJobs) {
+        const std::lock_guard lock(_overflowMutex);
+        nPopped += _overflowJobs.size();
+        jobs.insert(
+            jobs.end(),
+            std::make_move_iterator(_overflowJobs.begin()),
+            std::make_move_iterator(_overflowJobs.end())
+        );
+        _overflowJobs.clear();
+        _hasOverflowJobs = false;
+    }
+    return nPopped;
 }
 
 template <typename P, typename KeyType>
 size_t PrioritizingConcurrentJobManager<P, KeyType>::numFinishedJobs() const {
-    return _finishedJobs.size();
+    size_t nJobs = _finishedJobs.size();
+    if (_hasOverflowJobs) {
+        const std::lock_guard lock(_overflowMutex);
+        nJobs += _overflowJobs.size();
+    }
+    return nJobs;
+}
+
+template <typename P, typename KeyType>
+void PrioritizingConcurrentJobManager<P, KeyType>::pushFinishedJob(
+                                                              std::shared_ptr<Job<P>> job)
+{
+    if (_finishedJobs.tryPush(std::move(job))) {
+        return;
+    }
+
+    // The finished jobs are only picked up from the render thread, so a worker must not
+    // wait for space in the queue. Otherwise destroying the thread pool, which waits for
+    // the workers, could deadlock when the queue is full
+    const std::lock_guard lock(_overflowMutex);
+    _overflowJobs.push_back(std::move(job));
+    _hasOverflowJobs = true;
 }
 
 } // namespace openspace::globebrowsing
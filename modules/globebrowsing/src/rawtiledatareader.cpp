@@ -244,11 +244,13 @@ RawTile::ReadError postProcessErrorCheck(const RawTile& rawTile,
 RawTileDataReader::RawTileDataReader(std::string filePath,
                                      TileTextureInitData initData,
                                      TileCacheProperties cacheProperties,
-                                     PerformPreprocessing preprocess)
+                                     PerformPreprocessing preprocess,
+                                     int nDatasetHandles)
     : _datasetFilePath(std::move(filePath))
     , _initData(std::move(initData))
     , _cacheProperties(std::move(cacheProperties))
     , _preprocess(preprocess)
+    , _maxDatasets(std::max(nDatasetHandles, 1))
 {
     ZoneScoped;
 
@@ -256,11 +258,8 @@ RawTileDataReader::RawTileDataReader(std::string filePath,
 }
 
 RawTileDataReader::~RawTileDataReader() {
-    const std::lock_guard lockGuard(_datasetLock);
-    if (_dataset) {
-        GDALClose(_dataset);
-        _dataset = nullptr;
-    }
+    std::unique_lock lock(_datasetLock);
+    closeDatasets(lock);
 }
 
 std::optional<std::string> RawTileDataReader::mrfCache() {
@@ -393,19 +392,24 @@ void RawTileDataReader::initialize() {
         }
     }
 
+    GDALDataset* dataset = nullptr;
     {
         ZoneScopedN("GDALOpen");
-        _dataset = static_cast<GDALDataset*>(GDALOpen(content.c_str(), GA_ReadOnly));
-        if (!_dataset) {
+        dataset = static_cast<GDALDataset*>(GDALOpen(content.c_str(), GA_ReadOnly));
+        if (!dataset) {
             throw ghoul::RuntimeError(std::format(
                 "Failed to load dataset '{}'. GDAL error: {}",
                 _datasetFilePath, CPLGetLastErrorMsg()
             ));
         }
     }
+    // The remaining handles are opened lazily the first time they are needed
+    _openedFilePath = std::move(content);
+    _datasets.push_back(dataset);
+    _freeDatasets.push_back(dataset);
 
     // Assume all raster bands have the same data type
-    _rasterCount = _dataset->GetRasterCount();
+    _rasterCount = dataset->GetRasterCount();
 
     // calculateTileDepthTransform
     const unsigned long long maximumValue = [](GLenum t) {
@@ -424,27 +428,27 @@ void RawTileDataReader::initialize() {
 
 
     _depthTransform.scale = static_cast<float>(
-        _dataset->GetRasterBand(1)->GetScale() * maximumValue
+        dataset->GetRasterBand(1)->GetScale() * maximumValue
     );
     _depthTransform.offset = static_cast<float>(
-        _dataset->GetRasterBand(1)->GetOffset()
+        dataset->GetRasterBand(1)->GetOffset()
     );
-    _rasterXSize = _dataset->GetRasterXSize();
-    _rasterYSize = _dataset->GetRasterYSize();
-    _noDataValue = static_cast<float>(_dataset->GetRasterBand(1)->GetNoDataValue());
+    _rasterXSize = dataset->GetRasterXSize();
+    _rasterYSize = dataset->GetRasterYSize();
+    _noDataValue = static_cast<float>(dataset->GetRasterBand(1)->GetNoDataValue());
     _dataType = toGDALDataType(_initData.glType);
 
-    const CPLErr error = _dataset->GetGeoTransform(_padfTransform.data());
+    const CPLErr error = dataset->GetGeoTransform(_padfTransform.data());
     if (error == CE_Failure) {
         _padfTransform = geoTransform(_rasterXSize, _rasterYSize);
     }
 
     const double tileLevelDifference = calculateTileLevelDifference(
-        _dataset,
+        dataset,
         _initData.dimensions.x
     );
 
-    const int numOverviews = _dataset->GetRasterBand(1)->GetOverviewCount();
+    const int numOverviews = dataset->GetRasterBand(1)->GetOverviewCount();
     _maxChunkLevel = static_cast<int>(-tileLevelDifference);
     if (numOverviews > 0) {
         _maxChunkLevel += numOverviews;
@@ -453,16 +457,83 @@ void RawTileDataReader::initialize() {
 }
 
 void RawTileDataReader::reset() {
-    const std::lock_guard lockGuard(_datasetLock);
+    std::unique_lock lock(_datasetLock);
+    closeDatasets(lock);
     _maxChunkLevel = -1;
-    if (_dataset) {
-        GDALClose(_dataset);
-        _dataset = nullptr;
-    }
     initialize();
 }
 
-RawTile::ReadError RawTileDataReader::rasterRead(int rasterBand,
+GDALDataset* RawTileDataReader::acquireDataset() const {
+    std::unique_lock lock(_datasetLock);
+    while (_freeDatasets.empty()) {
+        const int nHandles = static_cast<int>(_datasets.size()) + _nOpeningDatasets;
+        if (nHandles < _maxDatasets) {
+            // Opening a handle can be slow, for example for remote datasets, so the lock
+            // is released in the meantime to let other threads return their handles
+            const std::string path = _openedFilePath;
+            _nOpeningDatasets++;
+            lock.unlock();
+            GDALDataset* dataset = nullptr;
+            {
+                ZoneScopedN("GDALOpen");
+                dataset = static_cast<GDALDataset*>(GDALOpen(path.c_str(), GA_ReadOnly));
+            }
+            lock.lock();
+            _nOpeningDatasets--;
+
+            if (dataset) {
+                _datasets.push_back(dataset);
+                _datasetReleased.notify_all();
+                return dataset;
+            }
+
+            LWARNING(std::format(
+                "Failed to open additional handle to dataset '{}'. GDAL error: {}",
+                _datasetFilePath, CPLGetLastErrorMsg()
+            ));
+            // Threads that are waiting for this handle have to try for themselves
+            _datasetReleased.notify_all();
+            if (_datasets.empty()) {
+                // There is no handle that could ever be released, so waiting for one
+                // would block this thread forever
+                return nullptr;
+            }
+
+            // Some datasets, for example remote ones, might limit the number of
+            // connections, so we have to make do with the handles we already have
+            _maxDatasets = static_cast<int>(_datasets.size());
+            continue;
+        }
+        _datasetReleased.wait(lock);
+    }
+
+    GDALDataset* dataset = _freeDatasets.back();
+    _freeDatasets.pop_back();
+    return dataset;
+}
+
+void RawTileDataReader::releaseDataset(GDALDataset* dataset) const {
+    {
+        const std::lock_guard lock(_datasetLock);
+        _freeDatasets.push_back(dataset);
+    }
+    _datasetReleased.notify_one();
+}
+
+void RawTileDataReader::closeDatasets(std::unique_lock<std::mutex>& lock) {
+    // Wait for all reads that are currently in flight to finish
+    _datasetReleased.wait(lock, [this]() {
+        return _freeDatasets.size() == _datasets.size() && _nOpeningDatasets == 0;
+    });
+
+    for (GDALDataset* dataset : _datasets) {
+        GDALClose(dataset);
+    }
+    _datasets.clear();
+    _freeDatasets.clear();
+}
+
+RawTile::ReadError RawTileDataReader::rasterRead(GDALDataset* dataset, int rasterBand,
                                                  const IODescription& io,
                                                  char* dataDestination) const
 {
@@ -489,7 +560,7 @@ RawTile::ReadError RawTileDataReader::rasterRead(int rasterBand,
     dataDest -= io.write.region.start.y * io.write.bytesPerLine;
     dataDest += io.write.region.start.x * _initData.bytesPerPixel;
 
-    GDALRasterBand* gdalRasterBand = _dataset->GetRasterBand(rasterBand);
+    GDALRasterBand* gdalRasterBand = dataset->GetRasterBand(rasterBand);
     CPLErr readError = CE_Failure;
     readError = gdalRasterBand->RasterIO(
         GF_Read,
@@ -525,7 +596,26 @@ RawTile RawTileDataReader::readTileData(TileIndex tileIndex) const {
 
     IODescription io = ioDescription(tileIndex);
     RawTile::ReadError worstError = RawTile::ReadError::None;
-    readImageData(io, worstError, reinterpret_cast<char*>(rawTile.imageData.get()));
+    {
+        // The dataset handle is only needed while reading and decoding the pixels, so
+        // it is returned before the CPU-only post processing below. That way another
+        // thread can already start reading its tile with this handle
+        ZoneScopedN("Read Image Data");
+        GDALDataset* dataset = acquireDataset();
+        if (!dataset) {
+            rawTile.error = RawTile::ReadError::Failure;
+            rawTile.tileIndex = std::move(tileIndex);
+            rawTile.textureInitData = _initData;
+            return rawTile;
+        }
+        defer { releaseDataset(dataset); };
+        readImageData(
+            dataset,
+            io,
+            worstError,
+            reinterpret_cast<char*>(rawTile.imageData.get())
+        );
+    }
 
     rawTile.error = worstError;
     rawTile.tileIndex = std::move(tileIndex);
@@ -542,7 +632,8 @@ RawTile RawTileDataReader::readTileData(TileIndex tileIndex) const {
     return rawTile;
 }
 
-void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& worstError,
+void RawTileDataReader::readImageData(GDALDataset* dataset, IODescription& io,
+                                      RawTile::ReadError& worstError,
                                       char* imageDataDest) const
 {
     // Only read the minimum number of rasters
@@ -551,7 +642,7 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
     switch (_initData.ghoulTextureFormat) {
         case ghoul::opengl::Texture::Format::Red: {
             char* dest = imageDataDest;
-            const RawTile::ReadError err = rasterRead(1, io, dest);
+            const RawTile::ReadError err = rasterRead(dataset, 1, io, dest);
             worstError = std::max(worstError, err);
             break;
         }
@@ -563,7 +654,7 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = rasterRead(1, io, dest);
+                    const RawTile::ReadError err = rasterRead(dataset, 1, io, dest);
                     worstError = std::max(worstError, err);
                 }
             }
@@ -572,12 +663,12 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = rasterRead(1, io, dest);
+                    const RawTile::ReadError err = rasterRead(dataset, 1, io, dest);
                     worstError = std::max(worstError, err);
                 }
                 // Last read is the alpha channel
                 char* dest = imageDataDest + (3 * _initData.bytesPerDatum);
-                const RawTile::ReadError err = rasterRead(2, io, dest);
+                const RawTile::ReadError err = rasterRead(dataset, 2, io, dest);
                 worstError = std::max(worstError, err);
             }
             else { // Three or more rasters
@@ -585,7 +676,7 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = rasterRead(i + 1, io, dest);
+                    const RawTile::ReadError err = rasterRead(dataset, i + 1, io, dest);
                     worstError = std::max(worstError, err);
                 }
             }
@@ -598,7 +689,7 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = rasterRead(1, io, dest);
+                    const RawTile::ReadError err = rasterRead(dataset, 1, io, dest);
                     worstError = std::max(worstError, err);
                 }
             }
@@ -607,12 +698,12 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = rasterRead(1, io, dest);
+                    const RawTile::ReadError err = rasterRead(dataset, 1, io, dest);
                     worstError = std::max(worstError, err);
                 }
                 // Last read is the alpha channel
                 char* dest = imageDataDest + (3 * _initData.bytesPerDatum);
-                const RawTile::ReadError err = rasterRead(2, io, dest);
+                const RawTile::ReadError err = rasterRead(dataset, 2, io, dest);
                 worstError = std::max(worstError, err);
             }
             else { // Three or more rasters
@@ -620,14 +711,14 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = rasterRead(3 - i, io, dest);
+                    const RawTile::ReadError err = rasterRead(dataset, 3 - i, io, dest);
                     worstError = std::max(worstError, err);
                 }
             }
             if (nReadRasters > 3) { // Alpha channel exists
                 // Last read is the alpha channel
                 char* dest = imageDataDest + (3 * _initData.bytesPerDatum);
-                const RawTile::ReadError err = rasterRead(4, io, dest);
+                const RawTile::ReadError err = rasterRead(dataset, 4, io, dest);
                 worstError = std::max(worstError, err);
             }
             break;
@@ -729,6 +820,15 @@ TileMetaData RawTileDataReader::tileMetaData(RawTile& rawTile,
     return ppData;
 }
 
+const TileTextureInitData& RawTileDataReader::textureInitData() const {
+    return _initData;
+}
+
+int RawTileDataReader::nDatasetHandles() const {
+    const std::lock_guard lock(_datasetLock);
+    return _maxDatasets;
+}
+
 int RawTileDataReader::maxChunkLevel() const {
     return _maxChunkLevel;
 }
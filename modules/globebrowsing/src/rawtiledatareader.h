@@ -30,8 +30,10 @@
 #include <modules/globebrowsing/src/tiletextureinitdata.h>
 #include <modules/globebrowsing/src/tilecacheproperties.h>
 #include <ghoul/misc/boolean.h>
+#include <condition_variable>
 #include <string>
 #include <mutex>
+#include <vector>
 #include <gdal.h>
 
 class GDALDataset;
@@ -55,18 +57,24 @@ public:
      *        utilize cache
      * \param preprocess whether the loaded data should be calculate meta data about the
      *        dataset
+     * \param nDatasetHandles the maximum number of GDAL dataset handles that are opened
+     *        for the file. Each handle can only be used by one thread at a time, so this
+     *        is the number of tiles that can be read concurrently
      */
     RawTileDataReader(std::string filePath, TileTextureInitData initData,
         TileCacheProperties cacheProperties,
-        PerformPreprocessing preprocess = PerformPreprocessing::No);
+        PerformPreprocessing preprocess = PerformPreprocessing::No,
+        int nDatasetHandles = 1);
     ~RawTileDataReader();
 
     void reset();
     int maxChunkLevel() const;
     float noDataValueAsFloat() const;
+    int nDatasetHandles() const;
 
     RawTile readTileData(TileIndex tileIndex) const;
     const TileDepthTransform& depthTransform() const;
+    const TileTextureInitData& textureInitData() const;
     glm::ivec2 fullPixelSize() const;
 
 private:
@@ -74,18 +82,33 @@ private:
 
     void initialize();
 
-    RawTile::ReadError rasterRead(int rasterBand, const IODescription& io,
-        char* dataDestination) const;
+    /**
+     * Returns a dataset handle that is not used by any other thread, opening a new one
+     * if all handles are in use and fewer than the maximum number are open. If no handle
+     * can be opened, this function blocks until another thread releases its handle. If
+     * there are no open handles at all and none can be opened, `nullptr` is returned.
+     */
+    GDALDataset* acquireDataset() const;
+    void releaseDataset(GDALDataset* dataset) const;
+
+    /// Closes all dataset handles after waiting for all handles to be released and for
+    /// all handles that are being opened. Has to be called with the `_datasetLock` held
+    void closeDatasets(std::unique_lock<std::mutex>& lock);
+
+    RawTile::ReadError rasterRead(GDALDataset* dataset, int rasterBand,
+        const IODescription& io, char* dataDestination) const;
 
-    void readImageData(IODescription& io, RawTile::ReadError& worstError,
-        char* imageDataDest) const;
+    void readImageData(GDALDataset* dataset, IODescription& io,
+        RawTile::ReadError& worstError, char* imageDataDest) const;
 
     IODescription ioDescription(const TileIndex& tileIndex) const;
 
     TileMetaData tileMetaData(RawTile& rawTile, const PixelRegion& region) const;
 
     const std::string _datasetFilePath;
-    GDALDataset* _dataset = nullptr;
+    /// The file that the dataset handles are opened from, which is either the dataset
+    /// file or its MRF cache
+    std::string _openedFilePath;
 
     // Dataset parameters
     int _rasterCount;
@@ -101,7 +124,14 @@ private:
     const PerformPreprocessing _preprocess;
     TileDepthTransform _depthTransform = { .scale = 0.f, .offset = 0.f };
 
+    // All open dataset handles and the subset of those that are not currently in use
+    mutable std::vector<GDALDataset*> _datasets;
+    mutable std::vector<GDALDataset*> _freeDatasets;
+    mutable int _maxDatasets;
+    /// The number of handles that are currently being opened without holding the lock
+    mutable int _nOpeningDatasets = 0;
     mutable std::mutex _datasetLock;
+    mutable std::condition_variable _datasetReleased;
 };
 
 } // namespace openspace::globebrowsing
@@ -25,15 +25,22 @@
 #include <modules/globebrowsing/src/renderableglobe.h>
 
 #include <modules/debugging/rendering/debugrenderer.h>
+#include <modules/globebrowsing/globebrowsingmodule.h>
 #include <modules/globebrowsing/src/basictypes.h>
 #include <modules/globebrowsing/src/gpulayergroup.h>
 #include <modules/globebrowsing/src/layer.h>
 #include <modules/globebrowsing/src/layergroup.h>
+#include <modules/globebrowsing/src/tileprefetcher.h>
 #include <modules/globebrowsing/src/tileprovider/tileprovider.h>
+#include <openspace/camera/camerapose.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
 #include <openspace/interaction/sessionrecording.h>
+#include <openspace/navigation/navigationhandler.h>
+#include <openspace/navigation/path.h>
+#include <openspace/navigation/pathnavigator.h>
 #include <openspace/query/query.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/scenegraphnode.h>
@@ -51,6 +58,8 @@
 #include <ghoul/opengl/openglstatecache.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
+#include <chrono>
+#include <limits>
 #include <numeric>
 #include <queue>
 #include <vector>
@@ -82,12 +91,12 @@ namespace {
         bool isShadowing = false;
     };
 
-    const openspace::globebrowsing::AABB3 CullingFrustum{
-        glm::vec3(-1.f, -1.f, 0.f),
-        glm::vec3( 1.f,  1.f, 1e35f)
-    };
     constexpr float DefaultHeight = 0.f;
 
+    // The number of tile indices for which the height tiles are kept on the CPU for
+    // height queries
+    constexpr size_t HeightSamplerCacheSize = 128;
+
     // I tried reducing this to 16, but it left the rendering with artifacts when the
     // atmosphere was enabled. The best guess to the circular artifacts are due to the
     // lack of resolution when a height field is enabled, leading the triangles to cut
@@ -133,6 +142,15 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo ParallelChunkEvaluationInfo =
+    {
+        "ParallelChunkEvaluation",
+        "Parallel chunk evaluation",
+        "If this value is set to 'true', the visibility and the desired level of the "
+        "chunks are computed on multiple threads when the chunk tree is large enough",
+        openspace::properties::Property::Visibility::Developer
+    };
+
     constexpr openspace::properties::Property::PropertyInfo ResetTileProviderInfo = {
         "ResetTileProviders",
         "Reset tile providers",
@@ -279,6 +297,67 @@ namespace {
         openspace::properties::Property::Visibility::User
     };
 
+    constexpr openspace::properties::Property::PropertyInfo PrefetchEnabledInfo = {
+        "Enabled",
+        "Enabled",
+        "If enabled, the path of the camera is predicted a few seconds into the future "
+        "and the tiles that will be needed along it are requested ahead of time with a "
+        "low priority. If the camera is flying along a camera path, that path is used, "
+        "otherwise the path is extrapolated from the current camera velocity",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchLookAheadInfo = {
+        "LookAheadTime",
+        "Look-Ahead Time",
+        "The number of seconds into the future for which the tiles are prefetched",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchMaxTilesInfo = {
+        "MaxTilesPerFrame",
+        "Maximum Tiles Per Frame",
+        "The maximum number of tiles that are requested for prefetching in a single "
+        "frame. Every tile is requested for each of the active layers",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchedTilesInfo = {
+        "PrefetchedTiles",
+        "Prefetched Tiles (Read Only)",
+        "The number of tiles that have been requested by the prefetcher",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchHitsInfo = {
+        "Hits",
+        "Hits (Read Only)",
+        "The number of tiles that the chunk tree needed which had been prefetched",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchMissesInfo = {
+        "Misses",
+        "Misses (Read Only)",
+        "The number of tiles that the chunk tree needed which had not been prefetched",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchWastedInfo = {
+        "Wasted",
+        "Wasted (Read Only)",
+        "The number of prefetched tiles that the chunk tree did not need within the "
+        "look-ahead time",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchHitRateInfo = {
+        "HitRate",
+        "Hit Rate (Read Only)",
+        "The fraction of the tiles needed by the chunk tree that had been prefetched",
+        openspace::properties::Property::Visibility::Developer
+    };
+
     struct [[codegen::Dictionary(RenderableGlobe)]] Parameters {
         // Specifies the radii for this planet. If the Double version of this is used, all
         // three radii are assumed to be equal
@@ -323,6 +402,9 @@ namespace {
 
         // [[codegen::verbatim(LightSourceNodeInfo.description)]]
         std::optional<std::string> lightSourceNode;
+
+        // [[codegen::verbatim(PrefetchEnabledInfo.description)]]
+        std::optional<bool> prefetchTiles;
     };
 #include "renderableglobe_codegen.cpp"
 } // namespace
@@ -538,12 +620,6 @@ void expand(AABB3& bb, const glm::vec3& p) {
     bb.max = glm::max(bb.max, p);
 }
 
-bool intersects(const AABB3& bb, const AABB3& o) {
-    return (bb.min.x <= o.max.x) && (o.min.x <= bb.max.x)
-        && (bb.min.y <= o.max.y) && (o.min.y <= bb.max.y)
-        && (bb.min.z <= o.max.z) && (o.min.z <= bb.max.z);
-}
-
 /**
  * Calculates the direction towards the local light source. If \p illumination is a
  * `nullptr`, it is interpreted to be (0,0,0)
@@ -564,12 +640,6 @@ glm::dvec3 directionToLightSource(const glm::dvec3& pos, SceneGraphNode* lightSo
 
 } // namespace
 
-Chunk::Chunk(const TileIndex& ti)
-    : tileIndex(ti)
-    , surfacePatch(ti)
-    , status(Status::DoNothing)
-{}
-
 documentation::Documentation RenderableGlobe::Documentation() {
     return codegen::doc<Parameters>("globebrowsing_renderableglobe");
 }
@@ -581,6 +651,7 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
         BoolProperty(LevelProjectedAreaInfo, true),
         BoolProperty(ResetTileProviderInfo, false),
         BoolProperty(PerformFrustumCullingInfo, true),
+        BoolProperty(ParallelChunkEvaluationInfo, true),
         IntProperty(ModelSpaceRenderingInfo, 14, 1, 22),
         IntProperty(DynamicLodIterationCountInfo, 16, 4, 128)
     })
@@ -599,9 +670,21 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
         FloatProperty(AmbientIntensityInfo, 0.05f, 0.f, 1.f),
         IntProperty(NActiveLayersInfo, 0, 0, OpenGLCap.maxTextureUnits() / 3)
     })
+    , _prefetchProperties({
+        BoolProperty(PrefetchEnabledInfo, false),
+        FloatProperty(PrefetchLookAheadInfo, 2.f, 0.1f, 10.f),
+        IntProperty(PrefetchMaxTilesInfo, 16, 1, 256),
+        IntProperty(PrefetchedTilesInfo, 0, 0, std::numeric_limits<int>::max()),
+        IntProperty(PrefetchHitsInfo, 0, 0, std::numeric_limits<int>::max()),
+        IntProperty(PrefetchMissesInfo, 0, 0, std::numeric_limits<int>::max()),
+        IntProperty(PrefetchWastedInfo, 0, 0, std::numeric_limits<int>::max()),
+        FloatProperty(PrefetchHitRateInfo, 0.f, 0.f, 1.f)
+    })
     , _debugPropertyOwner({ "Debug" })
+    , _prefetchPropertyOwner({ "Prefetch" })
     , _shadowMappingPropertyOwner({ "ShadowMapping" })
     , _grid(DefaultSkirtedGridSegments, DefaultSkirtedGridSegments)
+    , _heightSampler(HeightSamplerCacheSize)
     , _leftRoot(Chunk(LeftHemisphereIndex))
     , _rightRoot(Chunk(RightHemisphereIndex))
     , _lightSourceNodeName(LightSourceNodeInfo)
@@ -707,9 +790,29 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
     _debugPropertyOwner.addProperty(_debugProperties.levelByProjectedAreaElseDistance);
     _debugPropertyOwner.addProperty(_debugProperties.resetTileProviders);
     _debugPropertyOwner.addProperty(_debugProperties.performFrustumCulling);
+    _debugPropertyOwner.addProperty(_debugProperties.parallelChunkEvaluation);
     _debugPropertyOwner.addProperty(_debugProperties.modelSpaceRenderingCutoffLevel);
     _debugPropertyOwner.addProperty(_debugProperties.dynamicLodIterationCount);
 
+    _prefetchProperties.enabled = p.prefetchTiles.value_or(_prefetchProperties.enabled);
+    _prefetchProperties.enabled.onChange([this]() {
+        _tilePrefetcher = TilePrefetcher(_ellipsoid);
+    });
+    _prefetchPropertyOwner.addProperty(_prefetchProperties.enabled);
+    _prefetchPropertyOwner.addProperty(_prefetchProperties.lookAheadTime);
+    _prefetchPropertyOwner.addProperty(_prefetchProperties.maxTilesPerFrame);
+    _prefetchProperties.nPrefetched.setReadOnly(true);
+    _prefetchPropertyOwner.addProperty(_prefetchProperties.nPrefetched);
+    _prefetchProperties.nHits.setReadOnly(true);
+    _prefetchPropertyOwner.addProperty(_prefetchProperties.nHits);
+    _prefetchProperties.nMisses.setReadOnly(true);
+    _prefetchPropertyOwner.addProperty(_prefetchProperties.nMisses);
+    _prefetchProperties.nWasted.setReadOnly(true);
+    _prefetchPropertyOwner.addProperty(_prefetchProperties.nWasted);
+    _prefetchProperties.hitRate.setReadOnly(true);
+    _prefetchPropertyOwner.addProperty(_prefetchProperties.hitRate);
+    _tilePrefetcher.setEllipsoid(_ellipsoid);
+
     auto notifyShaderRecompilation = [this]() {
         _shadersNeedRecompilation = true;
     };
@@ -720,6 +823,7 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
     _debugProperties.showChunkEdges.onChange(notifyShaderRecompilation);
 
     _layerManager.onChange([this](Layer* l) {
+        _heightSampler.clear();
         _shadersNeedRecompilation = true;
         _chunkCornersDirty = true;
         _nLayersIsDirty = true;
@@ -727,6 +831,7 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
     });
 
     addPropertySubOwner(_debugPropertyOwner);
+    addPropertySubOwner(_prefetchPropertyOwner);
     addPropertySubOwner(_layerManager);
 
     _globalChunkBuffer.resize(2048);
@@ -929,6 +1034,10 @@ void RenderableGlobe::renderSecondary(const RenderData& data, RendererTasks&) {
 void RenderableGlobe::update(const UpdateData& data) {
     ZoneScoped;
 
+    // Tiles might have been loaded since the last frame, so the cached height tiles
+    // have to be compared against the tile providers again
+    _heightSampler.startFrame();
+
     if (_localRenderer.program && _localRenderer.program->isDirty()) {
         _localRenderer.program->rebuildFromFile();
 
@@ -1036,6 +1145,10 @@ const glm::dmat4& RenderableGlobe::modelTransform() const {
     return _cachedModelTransform;
 }
 
+const std::vector<TileIndex>& RenderableGlobe::renderedChunkTiles() const {
+    return _renderedChunkTiles;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 //  Rendering code
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1162,9 +1275,11 @@ void RenderableGlobe::renderChunks(const RenderData& data, RendererTasks&,
     const glm::dmat4 mvp = vp * _cachedModelTransform;
 
     _allChunksAvailable = true;
-    updateChunkTree(_leftRoot, data, mvp);
-    updateChunkTree(_rightRoot, data, mvp);
+    updateChunkTrees(data, mvp);
     _chunkCornersDirty = false;
+    if (_prefetchProperties.enabled) {
+        prefetchTiles(data);
+    }
     _iterationsOfAvailableData =
         (_allChunksAvailable ? _iterationsOfAvailableData + 1 : 0);
     _iterationsOfUnavailableData =
@@ -1317,6 +1432,14 @@ void RenderableGlobe::renderChunks(const RenderData& data, RendererTasks&,
         _traversalMemory
     );
 
+    _renderedChunkTiles.clear();
+    for (int i = 0; i < globalCount; i++) {
+        _renderedChunkTiles.push_back(_globalChunkBuffer[i]->tileIndex);
+    }
+    for (int i = 0; i < localCount; i++) {
+        _renderedChunkTiles.push_back(_localChunkBuffer[i]->tileIndex);
+    }
+
     // Render all chunks that want to be rendered globally
     _globalRenderer.program->activate();
     for (int i = 0; i < globalCount; i++) {
@@ -1939,186 +2062,80 @@ SurfacePositionHandle RenderableGlobe::calculateSurfacePositionHandle(
     };
 }
 
-bool RenderableGlobe::testIfCullable(const Chunk& chunk,
-                                     const RenderData& renderData,
-                                     const BoundingHeights& heights,
-                                     const glm::dmat4& mvp) const
-{
-    ZoneScoped;
-
-    return (PreformHorizonCulling && isCullableByHorizon(chunk, renderData, heights)) ||
-           (_debugProperties.performFrustumCulling &&
-               isCullableByFrustum(chunk, renderData, mvp));
-}
-
-int RenderableGlobe::desiredLevel(const Chunk& chunk, const RenderData& renderData,
-                                  const BoundingHeights& heights) const
-{
+int RenderableGlobe::desiredLevel(const Chunk& chunk, int levelByGeometry) const {
     ZoneScoped;
 
-    const int desiredLevel = _debugProperties.levelByProjectedAreaElseDistance ?
-        desiredLevelByProjectedArea(chunk, renderData, heights) :
-        desiredLevelByDistance(chunk, renderData, heights);
     const int levelByAvailableData = desiredLevelByAvailableTileData(chunk);
 
     if (LimitLevelByAvailableData && (levelByAvailableData != UnknownDesiredLevel)) {
-        const int l = glm::min(desiredLevel, levelByAvailableData);
+        const int l = glm::min(levelByGeometry, levelByAvailableData);
         return glm::clamp(l, MinSplitDepth, MaxSplitDepth);
     }
     else {
-        return glm::clamp(desiredLevel, MinSplitDepth, MaxSplitDepth);
+        return glm::clamp(levelByGeometry, MinSplitDepth, MaxSplitDepth);
     }
 }
 
-float RenderableGlobe::getHeight(const glm::dvec3& position) const {
+void RenderableGlobe::calculateHeights(std::span<const glm::dvec3> positions,
+                                       std::span<float> heights) const
+{
     ZoneScoped;
+    ghoul_assert(positions.size() == heights.size(), "Need one height per position");
 
-    float height = 0;
-
-    // Get the uv coordinates to sample from
-    const Geodetic2 geodeticPosition = _ellipsoid.cartesianToGeodetic2(position);
-    const Chunk& node = geodeticPosition.lon < Coverage.center().lon ?
-        findChunkNode(_leftRoot, geodeticPosition) :
-        findChunkNode(_rightRoot, geodeticPosition);
-    const int chunkLevel = node.tileIndex.level;
-
-
-    const int numIndicesAtLevel = 1 << chunkLevel;
-    const double u = 0.5 + geodeticPosition.lon / glm::two_pi<double>();
-    const double v = 0.25 - geodeticPosition.lat / glm::two_pi<double>();
-    const double xIndexSpace = u * numIndicesAtLevel;
-    const double yIndexSpace = v * numIndicesAtLevel;
-
-    const int x = static_cast<int>(floor(xIndexSpace));
-    const int y = static_cast<int>(floor(yIndexSpace));
-
-    ghoul_assert(chunkLevel < std::numeric_limits<uint8_t>::max(), "Too high level");
-    const TileIndex tileIndex(x, y, static_cast<uint8_t>(chunkLevel));
-    const GeodeticPatch patch = GeodeticPatch(tileIndex);
-
-    const Geodetic2 northEast = patch.corner(Quad::NORTH_EAST);
-    const Geodetic2 southWest = patch.corner(Quad::SOUTH_WEST);
-
-    const Geodetic2 geoDiffPatch = {
-        .lat = northEast.lat - southWest.lat,
-        .lon = northEast.lon - southWest.lon
-    };
-
-    const Geodetic2 geoDiffPoint = {
-        .lat = geodeticPosition.lat - southWest.lat,
-        .lon = geodeticPosition.lon - southWest.lon
-    };
-    const glm::vec2 patchUV = glm::vec2(
-        geoDiffPoint.lon / geoDiffPatch.lon,
-        geoDiffPoint.lat / geoDiffPatch.lat
-    );
-
-    // Get the tile providers for the height maps
     const std::vector<Layer*>& heightMapLayers =
         _layerManager.layerGroup(layers::Group::ID::HeightLayers).activeLayers();
 
-    for (Layer* layer : heightMapLayers) {
-        TileProvider* tileProvider = layer->tileProvider();
-        if (!tileProvider) {
-            continue;
-        }
-        // Transform the uv coordinates to the current tile texture
-        const ChunkTile chunkTile = tileProvider->chunkTile(tileIndex);
-        const Tile& tile = chunkTile.tile;
-        const TileUvTransform& uvTransform = chunkTile.uvTransform;
-        const TileDepthTransform& depthTransform = tileProvider->depthTransform();
-        if (tile.status != Tile::Status::OK) {
-            return 0;
-        }
-
-        ghoul::opengl::Texture* tileTexture = tile.texture;
-        if (!tileTexture) {
-            return 0;
+    const Chunk* node = nullptr;
+    for (size_t i = 0; i < positions.size(); i++) {
+        // Get the uv coordinates to sample from
+        const Geodetic2 geodeticPosition = _ellipsoid.cartesianToGeodetic2(positions[i]);
+
+        // Consecutive positions are often close to each other, so the chunk of the
+        // previous position is tested first before traversing the chunk tree again
+        if (!node || !node->surfacePatch.contains(geodeticPosition)) {
+            node = geodeticPosition.lon < Coverage.center().lon ?
+                &findChunkNode(_leftRoot, geodeticPosition) :
+                &findChunkNode(_rightRoot, geodeticPosition);
         }
+        const int chunkLevel = node->tileIndex.level;
 
-        const glm::vec2& transformedUv = layer->tileUvToTextureSamplePosition(
-            uvTransform,
-            patchUV
-        );
+        const int numIndicesAtLevel = 1 << chunkLevel;
+        const double u = 0.5 + geodeticPosition.lon / glm::two_pi<double>();
+        const double v = 0.25 - geodeticPosition.lat / glm::two_pi<double>();
+        const double xIndexSpace = u * numIndicesAtLevel;
+        const double yIndexSpace = v * numIndicesAtLevel;
 
-        // Sample and do linear interpolation
-        // (could possibly be moved as a function in ghoul texture)
-        // Suggestion: a function in ghoul::opengl::Texture that takes uv coordinates
-        // in range [0,1] and uses the set interpolation method and clamping.
+        const int x = static_cast<int>(floor(xIndexSpace));
+        const int y = static_cast<int>(floor(yIndexSpace));
 
-        const glm::uvec3 dimensions = tileTexture->dimensions();
+        ghoul_assert(chunkLevel < std::numeric_limits<uint8_t>::max(), "Too high level");
+        const TileIndex tileIndex(x, y, static_cast<uint8_t>(chunkLevel));
+        const GeodeticPatch patch = GeodeticPatch(tileIndex);
 
-        glm::vec2 samplePos = transformedUv * glm::vec2(dimensions);
-        // @TODO (emmbr, 2023-06-14) This 0.5f offset was added as a bandaid for issue
-        // #2696. It seems to improve the behavior, but I am not certain of why. And the
-        // underlying problem is still there and should at some point be looked at again
-        samplePos -= glm::vec2(0.5f);
+        const Geodetic2 northEast = patch.corner(Quad::NORTH_EAST);
+        const Geodetic2 southWest = patch.corner(Quad::SOUTH_WEST);
 
-        glm::uvec2 samplePos00 = samplePos;
-        samplePos00 = glm::clamp(
-            samplePos00,
-            glm::uvec2(0, 0),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::vec2 samplePosFract = samplePos - glm::vec2(samplePos00);
+        const Geodetic2 geoDiffPatch = {
+            .lat = northEast.lat - southWest.lat,
+            .lon = northEast.lon - southWest.lon
+        };
 
-        const glm::uvec2 samplePos10 = glm::min(
-            samplePos00 + glm::uvec2(1, 0),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::uvec2 samplePos01 = glm::min(
-            samplePos00 + glm::uvec2(0, 1),
-            glm::uvec2(dimensions) - glm::uvec2(1)
-        );
-        const glm::uvec2 samplePos11 = glm::min(
-            samplePos00 + glm::uvec2(1, 1),
-            glm::uvec2(dimensions) - glm::uvec2(1)
+        const Geodetic2 geoDiffPoint = {
+            .lat = geodeticPosition.lat - southWest.lat,
+            .lon = geodeticPosition.lon - southWest.lon
+        };
+        const glm::vec2 patchUV = glm::vec2(
+            geoDiffPoint.lon / geoDiffPatch.lon,
+            geoDiffPoint.lat / geoDiffPatch.lat
         );
 
-        const float sample00 = tileTexture->texelAsFloat(samplePos00).x;
-        const float sample10 = tileTexture->texelAsFloat(samplePos10).x;
-        const float sample01 = tileTexture->texelAsFloat(samplePos01).x;
-        const float sample11 = tileTexture->texelAsFloat(samplePos11).x;
-
-        // In case the texture has NaN or no data values don't use this height map.
-        const bool anySampleIsNaN =
-            std::isnan(sample00) ||
-            std::isnan(sample01) ||
-            std::isnan(sample10) ||
-            std::isnan(sample11);
-
-        const bool anySampleIsNoData =
-            sample00 == tileProvider->noDataValueAsFloat() ||
-            sample01 == tileProvider->noDataValueAsFloat() ||
-            sample10 == tileProvider->noDataValueAsFloat() ||
-            sample11 == tileProvider->noDataValueAsFloat();
-
-        if (anySampleIsNaN || anySampleIsNoData) {
-            continue;
-        }
-
-        const float sample0 = sample00 * (1.f - samplePosFract.x) +
-            sample10 * samplePosFract.x;
-        const float sample1 = sample01 * (1.f - samplePosFract.x) +
-            sample11 * samplePosFract.x;
-
-        const float sample = sample0 * (1.f - samplePosFract.y) +
-            sample1 * samplePosFract.y;
-
-        // Same as is used in the shader. This is not a perfect solution but
-        // if the sample is actually a no-data-value (min_float) the interpolated
-        // value might not be. Therefore we have a cut-off. Assuming no data value
-        // is smaller than -100000
-        if (sample > -100000) {
-            // Perform depth transform to get the value in meters
-            height = depthTransform.offset + depthTransform.scale * sample;
-            // Make sure that the height value follows the layer settings.
-            // For example if the multiplier is set to a value bigger than one,
-            // the sampled height should be modified as well.
-            height = layer->renderSettings().performLayerSettings(height);
-        }
+        heights[i] = _heightSampler.height(tileIndex, patchUV, heightMapLayers);
     }
-    // Return the result
+}
+
+float RenderableGlobe::getHeight(const glm::dvec3& position) const {
+    float height = 0.f;
+    calculateHeights(std::span(&position, 1), std::span(&height, 1));
     return height;
 }
 
@@ -2284,127 +2301,6 @@ void RenderableGlobe::calculateEclipseShadows(ghoul::opengl::ProgramObject& prog
 //  Desired Level
 //////////////////////////////////////////////////////////////////////////////////////////
 
-int RenderableGlobe::desiredLevelByDistance(const Chunk& chunk,
-                                            const RenderData& data,
-                                            const BoundingHeights& heights) const
-{
-    ZoneScoped;
-
-    // Calculations are done in the reference frame of the globe
-    // (model space). Hence, the camera position needs to be transformed
-    // with the inverse model matrix
-    const glm::dvec3 cameraPosition = glm::dvec3(_cachedInverseModelTransform *
-        glm::dvec4(data.camera.positionVec3(), 1.0));
-
-    const Geodetic2 pointOnPatch = chunk.surfacePatch.closestPoint(
-        _ellipsoid.cartesianToGeodetic2(cameraPosition)
-    );
-    const glm::dvec3 patchNormal = _ellipsoid.geodeticSurfaceNormal(pointOnPatch);
-    glm::dvec3 patchPosition = _ellipsoid.cartesianSurfacePosition(pointOnPatch);
-
-    const double heightToChunk = heights.min;
-
-    // Offset position according to height
-    patchPosition += patchNormal * heightToChunk;
-
-    const glm::dvec3 cameraToChunk = patchPosition - cameraPosition;
-
-    // Calculate desired level based on distance
-    const double distanceToPatch = glm::length(cameraToChunk);
-    const double distance = distanceToPatch;
-
-    const double scaleFactor = _generalProperties.currentLodScaleFactor *
-        _ellipsoid.minimumRadius();
-    const double projectedScaleFactor = scaleFactor / distance;
-    const int desiredLevel = static_cast<int>(ceil(log2(projectedScaleFactor)));
-    return desiredLevel;
-}
-
-int RenderableGlobe::desiredLevelByProjectedArea(const Chunk& chunk,
-                                                 const RenderData& data,
-                                                 const BoundingHeights& heights) const
-{
-    ZoneScoped;
-
-    // Calculations are done in the reference frame of the globe
-    // (model space). Hence, the camera position needs to be transformed
-    // with the inverse model matrix
-    const glm::dvec3 cameraPosition = glm::dvec3(
-        _cachedInverseModelTransform * glm::dvec4(data.camera.positionVec3(), 1.0)
-    );
-
-    // Approach:
-    // The projected area of the chunk will be calculated based on a small area that
-    // is close to the camera, and the scaled up to represent the full area.
-    // The advantage of doing this is that it will better handle the cases where the
-    // full patch is very curved (e.g. stretches from latitude 0 to 90 deg).
-
-    const Geodetic2 closestCorner = chunk.surfacePatch.closestCorner(
-        _ellipsoid.cartesianToGeodetic2(cameraPosition)
-    );
-
-    //  Camera
-    //  |
-    //  V
-    //
-    //  oo
-    // [  ]<
-    //                     *geodetic space*
-    //
-    //   closestCorner
-    //    +-----------------+  <-- north east corner
-    //    |                 |
-    //    |      center     |
-    //    |                 |
-    //    +-----------------+  <-- south east corner
-
-    const Geodetic2 center = chunk.surfacePatch.center();
-    const Geodetic3 c = { center, heights.min };
-    const Geodetic3 c1 = { Geodetic2{ center.lat, closestCorner.lon }, heights.min };
-    const Geodetic3 c2 = { Geodetic2{ closestCorner.lat, center.lon }, heights.min };
-
-    //  Camera
-    //  |
-    //  V
-    //
-    //  oo
-    // [  ]<
-    //                     *geodetic space*
-    //
-    //    +--------c2-------+  <-- north east corner
-    //    |                 |
-    //    c1       c        |
-    //    |                 |
-    //    +-----------------+  <-- south east corner
-
-
-    // Go from geodetic to cartesian space and project onto unit sphere
-    const glm::dvec3 camToCenter = -cameraPosition;
-    const glm::dvec3 A = glm::normalize(camToCenter + _ellipsoid.cartesianPosition(c));
-    const glm::dvec3 B = glm::normalize(camToCenter + _ellipsoid.cartesianPosition(c1));
-    const glm::dvec3 C = glm::normalize(camToCenter + _ellipsoid.cartesianPosition(c2));
-
-    // Camera                      *cartesian space*
-    // |                    +--------+---+
-    // V             __--''   __--''    /
-    //              C-------A--------- +
-    // oo          /       /          /
-    //[  ]<       +-------B----------+
-    //
-
-    // If the geodetic patch is small (i.e. has small width), that means the patch in
-    // cartesian space will be almost flat, and in turn, the triangle ABC will roughly
-    // correspond to 1/8 of the full area
-    const glm::dvec3 AB = B - A;
-    const glm::dvec3 AC = C - A;
-    const double areaABC = 0.5 * glm::length(glm::cross(AC, AB));
-    const double projectedChunkAreaApprox = 8 * areaABC;
-
-    const double scaledArea = _generalProperties.currentLodScaleFactor *
-                              projectedChunkAreaApprox;
-    return chunk.tileIndex.level + static_cast<int>(round(scaledArea - 1));
-}
-
 int RenderableGlobe::desiredLevelByAvailableTileData(const Chunk& chunk) const {
     ZoneScoped;
 
@@ -2427,101 +2323,6 @@ int RenderableGlobe::desiredLevelByAvailableTileData(const Chunk& chunk) const {
     return currLevel - 1;
 }
 
-//////////////////////////////////////////////////////////////////////////////////////////
-//  Culling
-//////////////////////////////////////////////////////////////////////////////////////////
-
-bool RenderableGlobe::isCullableByFrustum(const Chunk& chunk,
-                                          const RenderData&,
-                                          const glm::dmat4& mvp) const
-{
-    ZoneScoped;
-
-    const std::array<glm::dvec4, 8>& corners = chunk.corners;
-
-    // Create a bounding box that fits the patch corners
-    AABB3 bounds; // in screen space
-    for (size_t i = 0; i < 8; i++) {
-        const glm::dvec4 cornerClippingSpace = mvp * corners[i];
-        const glm::dvec3 ndc = glm::dvec3(
-            (1.f / glm::abs(cornerClippingSpace.w)) * cornerClippingSpace
-        );
-        expand(bounds, ndc);
-    }
-
-    return !(intersects(CullingFrustum, bounds));
-}
-
-bool RenderableGlobe::isCullableByHorizon(const Chunk& chunk,
-                                          const RenderData& renderData,
-                                          const BoundingHeights& heights) const
-{
-    ZoneScoped;
-
-    // Calculations are done in the reference frame of the globe. Hence, the camera
-    // position needs to be transformed with the inverse model matrix
-    const GeodeticPatch& patch = chunk.surfacePatch;
-    const float maxHeight = heights.max;
-    const glm::dvec3 globePos = glm::dvec3(0.0, 0.0, 0.0); // In model space it is 0
-    const double minimumGlobeRadius = _ellipsoid.minimumRadius();
-
-    const glm::dvec3 cameraPos = glm::dvec3(
-        _cachedInverseModelTransform * glm::dvec4(renderData.camera.positionVec3(), 1.0)
-    );
-
-    const glm::dvec3& globeToCamera = cameraPos;
-
-    const Geodetic2 camPosOnGlobe = _ellipsoid.cartesianToGeodetic2(globeToCamera);
-    const Geodetic2 closestPatchPoint = patch.closestPoint(camPosOnGlobe);
-    glm::dvec3 objectPos = _ellipsoid.cartesianSurfacePosition(closestPatchPoint);
-
-    // objectPosition is closest in latlon space but not guaranteed to be closest in
-    // castesian coordinates. Therefore we compare it to the corners and pick the
-    // real closest point,
-    std::array<glm::dvec3, 4> corners = {
-        _ellipsoid.cartesianSurfacePosition(chunk.surfacePatch.corner(NORTH_WEST)),
-        _ellipsoid.cartesianSurfacePosition(chunk.surfacePatch.corner(NORTH_EAST)),
-        _ellipsoid.cartesianSurfacePosition(chunk.surfacePatch.corner(SOUTH_WEST)),
-        _ellipsoid.cartesianSurfacePosition(chunk.surfacePatch.corner(SOUTH_EAST))
-    };
-
-    for (int i = 0; i < 4; i++) {
-        const double distance = glm::length(cameraPos - corners[i]);
-        if (distance < glm::length(cameraPos - objectPos)) {
-            objectPos = corners[i];
-        }
-    }
-
-
-    const double objectP = pow(length(objectPos - globePos), 2);
-    const double horizonP = pow(minimumGlobeRadius - maxHeight, 2);
-    if (objectP < horizonP) {
-        return false;
-    }
-
-    const double cameraP = pow(length(cameraPos - globePos), 2);
-    const double minR = pow(minimumGlobeRadius, 2);
-    if (cameraP < minR) {
-        return false;
-    }
-
-    const double minimumAllowedDistanceToObjectFromHorizon = sqrt(objectP - horizonP);
-    const double distanceToHorizon = sqrt(cameraP - minR);
-
-    // Minimum allowed for the object to be occluded
-    const double minimumAllowedDistanceToObjectSquared =
-        pow(distanceToHorizon + minimumAllowedDistanceToObjectFromHorizon, 2) +
-        pow(maxHeight, 2);
-
-    const double distanceToObjectSquared = pow(
-        length(objectPos - cameraPos),
-        2
-    );
-    return distanceToObjectSquared > minimumAllowedDistanceToObjectSquared;
-}
-
-
-
 //////////////////////////////////////////////////////////////////////////////////////////
 //  Chunk node handling
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2580,9 +2381,72 @@ void RenderableGlobe::mergeChunkNode(Chunk& cn) {
     cn.children.fill(nullptr);
 }
 
-bool RenderableGlobe::updateChunkTree(Chunk& cn, const RenderData& data,
-                                      const glm::dmat4& mvp)
-{
+void RenderableGlobe::updateChunkTrees(const RenderData& data, const glm::dmat4& mvp) {
+    ZoneScoped;
+
+    // The update is done in three passes. The first one gathers the information that
+    // depends on the tile providers, which are not thread-safe, the second one computes
+    // the visibility and the desired level of each chunk, possibly on multiple threads,
+    // and the last one applies the results by splitting and merging the chunks
+    _evaluationChunks.clear();
+    _evaluationHeights.clear();
+    _evaluationChunks.push_back(&_leftRoot);
+    _evaluationChunks.push_back(&_rightRoot);
+    for (size_t i = 0; i < _evaluationChunks.size(); i++) {
+        Chunk& chunk = *_evaluationChunks[i];
+
+        const BoundingHeights& heights = boundingHeightsForChunk(chunk, _layerManager);
+        chunk.heightTileOK = heights.tileOK;
+        chunk.colorTileOK = colorAvailableForChunk(chunk, _layerManager);
+        if (_chunkCornersDirty) {
+            // The flag gets set to false globally after the chunk trees are updated
+            chunk.corners = boundingCornersForChunk(chunk, _ellipsoid, heights);
+        }
+        _evaluationHeights.push_back(heights);
+
+        if (!isLeaf(chunk)) {
+            _evaluationChunks.insert(
+                _evaluationChunks.end(),
+                chunk.children.begin(),
+                chunk.children.end()
+            );
+        }
+    }
+
+    ChunkEvaluationContext context;
+    context.ellipsoid = &_ellipsoid;
+    context.cameraPosition = glm::dvec3(
+        _cachedInverseModelTransform * glm::dvec4(data.camera.positionVec3(), 1.0)
+    );
+    context.cameraGeodetic = _ellipsoid.cartesianToGeodetic2(context.cameraPosition);
+    context.modelViewProjection = mvp;
+    context.lodScaleFactor = _generalProperties.currentLodScaleFactor;
+    context.levelByProjectedArea = _debugProperties.levelByProjectedAreaElseDistance;
+    context.performHorizonCulling = PreformHorizonCulling;
+    context.performFrustumCulling = _debugProperties.performFrustumCulling;
+
+    TaskScheduler* scheduler = _debugProperties.parallelChunkEvaluation ?
+        global::moduleEngine->module<GlobeBrowsingModule>()->chunkEvaluationScheduler() :
+        nullptr;
+
+    _evaluationResults.resize(_evaluationChunks.size());
+    evaluateChunks(
+        _evaluationChunks,
+        _evaluationHeights,
+        context,
+        _evaluationResults,
+        scheduler
+    );
+
+    for (size_t i = 0; i < _evaluationChunks.size(); i++) {
+        updateChunk(*_evaluationChunks[i], _evaluationResults[i]);
+    }
+
+    updateChunkTree(_leftRoot);
+    updateChunkTree(_rightRoot);
+}
+
+bool RenderableGlobe::updateChunkTree(Chunk& cn) {
     ZoneScoped;
 
     // abock:  I tried turning this into a queue and use iteration, rather than recursion
@@ -2592,8 +2456,6 @@ bool RenderableGlobe::updateChunkTree(Chunk& cn, const RenderData& data,
     //         In addition, this didn't even improve performance ---  2018-10-04
     if (isLeaf(cn)) {
         ZoneScopedN("leaf");
-        updateChunk(cn, data, mvp);
-
         if (cn.status == Chunk::Status::WantSplit) {
             splitChunkNode(cn, 1);
         }
@@ -2608,13 +2470,12 @@ bool RenderableGlobe::updateChunkTree(Chunk& cn, const RenderData& data,
         ZoneScopedN("!leaf");
         char requestedMergeMask = 0;
         for (int i = 0; i < 4; i++) {
-            if (updateChunkTree(*cn.children[i], data, mvp)) {
+            if (updateChunkTree(*cn.children[i])) {
                 requestedMergeMask |= (1 << i);
             }
         }
 
         const bool allChildrenWantsMerge = requestedMergeMask == 0xf;
-        updateChunk(cn, data, mvp);
 
         if (allChildrenWantsMerge && (cn.status != Chunk::Status::WantSplit)) {
             mergeChunkNode(cn);
@@ -2630,30 +2491,102 @@ bool RenderableGlobe::updateChunkTree(Chunk& cn, const RenderData& data,
     }
 }
 
-void RenderableGlobe::updateChunk(Chunk& chunk, const RenderData& data,
-                                  const glm::dmat4& mvp) const
-{
+void RenderableGlobe::prefetchTiles(const RenderData& data) {
     ZoneScoped;
 
-    const BoundingHeights& heights = boundingHeightsForChunk(chunk, _layerManager);
-    chunk.heightTileOK = heights.tileOK;
-    chunk.colorTileOK = colorAvailableForChunk(chunk, _layerManager);
+    // The camera movement happens in wall-clock time regardless of the simulation time
+    const double time = std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+
+    TilePrefetcher::Settings settings;
+    settings.lookAheadTime = _prefetchProperties.lookAheadTime;
+    settings.maxTilesPerUpdate = _prefetchProperties.maxTilesPerFrame;
+    settings.levelMetric = _debugProperties.levelByProjectedAreaElseDistance ?
+        TilePrefetcher::LevelMetric::ProjectedArea :
+        TilePrefetcher::LevelMetric::Distance;
+    settings.lodScaleFactor = _generalProperties.currentLodScaleFactor;
+    settings.minLevel = MinSplitDepth;
+    settings.maxLevel = MaxSplitDepth;
+    _tilePrefetcher.setSettings(settings);
+
+    // All leaves request their tiles when the chunk tree is updated, not only the
+    // visible ones, so they are all counted as needed
+    _prefetchLeafBuffer.clear();
+    std::vector<const Chunk*> stack = { &_leftRoot, &_rightRoot };
+    while (!stack.empty()) {
+        const Chunk* chunk = stack.back();
+        stack.pop_back();
+        if (isLeaf(*chunk)) {
+            _prefetchLeafBuffer.push_back(chunk->tileIndex);
+        }
+        else {
+            stack.insert(stack.end(), chunk->children.begin(), chunk->children.end());
+        }
+    }
+    _tilePrefetcher.recordNeededTiles(_prefetchLeafBuffer, time);
 
-    if (_chunkCornersDirty) {
-        chunk.corners = boundingCornersForChunk(chunk, _ellipsoid, heights);
+    const glm::dvec3 cameraPosition = glm::dvec3(
+        _cachedInverseModelTransform * glm::dvec4(data.camera.positionVec3(), 1.0)
+    );
 
-        // The flag gets set to false globally after the updateChunkTree calls
+    // If a camera path is being flown, the future positions along it are known
+    std::vector<glm::dvec3> plannedPath;
+    const interaction::PathNavigator& pathNavigator =
+        global::navigationHandler->pathNavigator();
+    if (pathNavigator.isPlayingPath()) {
+        const interaction::Path* path = pathNavigator.currentPath();
+        const double remainingDistance = path->remainingDistance();
+        const double remainingTime = path->estimatedRemainingTime(
+            static_cast<float>(pathNavigator.speedScale())
+        );
+        if (remainingTime > 0.0) {
+            const double traveled = path->pathLength() - remainingDistance;
+            const double speed = remainingDistance / remainingTime;
+            for (int i = 1; i <= settings.nSamples; i++) {
+                const double t = settings.lookAheadTime * i / settings.nSamples;
+                const double d = std::min(traveled + speed * t, path->pathLength());
+                const CameraPose pose = path->interpolatedPose(d);
+                plannedPath.emplace_back(
+                    _cachedInverseModelTransform * glm::dvec4(pose.position, 1.0)
+                );
+            }
+        }
     }
 
-    if (testIfCullable(chunk, data, heights, mvp)) {
-        chunk.isVisible = false;
-        chunk.status = Chunk::Status::WantMerge;
-    }
-    else {
-        chunk.isVisible = true;
+    const std::vector<TileIndex> tiles =
+        _tilePrefetcher.update(time, cameraPosition, plannedPath);
+    for (const TileIndex& tileIndex : tiles) {
+        for (const LayerGroup* layerGroup : _layerManager.layerGroups()) {
+            for (Layer* layer : layerGroup->activeLayers()) {
+                if (layer->tileProvider()) {
+                    layer->tileProvider()->prefetch(tileIndex);
+                }
+            }
+        }
     }
 
-    const int dl = desiredLevel(chunk, data, heights);
+    const TilePrefetcher::Statistics& stats = _tilePrefetcher.statistics();
+    auto clampToInt = [](uint64_t v) {
+        return static_cast<int>(
+            std::min<uint64_t>(v, std::numeric_limits<int>::max())
+        );
+    };
+    _prefetchProperties.nPrefetched = clampToInt(stats.nPrefetched);
+    _prefetchProperties.nHits = clampToInt(stats.nHits);
+    _prefetchProperties.nMisses = clampToInt(stats.nMisses);
+    _prefetchProperties.nWasted = clampToInt(stats.nWasted);
+    _prefetchProperties.hitRate = static_cast<float>(stats.hitRate());
+}
+
+void RenderableGlobe::updateChunk(Chunk& chunk,
+                                  const ChunkEvaluation& evaluation) const
+{
+    ZoneScoped;
+
+    chunk.isVisible = evaluation.isVisible;
+
+    const int dl = desiredLevel(chunk, evaluation.desiredLevel);
 
     if (dl < chunk.tileIndex.level) {
         chunk.status = Chunk::Status::WantMerge;
@@ -27,16 +27,20 @@
 
 #include <openspace/rendering/renderable.h>
 
+#include <modules/globebrowsing/src/chunk.h>
+#include <modules/globebrowsing/src/chunkevaluation.h>
 #include <modules/globebrowsing/src/ellipsoid.h>
 #include <modules/globebrowsing/src/geodeticpatch.h>
 #include <modules/globebrowsing/src/geojson/geojsonmanager.h>
 #include <modules/globebrowsing/src/globelabelscomponent.h>
 #include <modules/globebrowsing/src/gpulayergroup.h>
+#include <modules/globebrowsing/src/heightsampler.h>
 #include <modules/globebrowsing/src/layermanager.h>
 #include <modules/globebrowsing/src/ringscomponent.h>
 #include <modules/globebrowsing/src/shadowcomponent.h>
 #include <modules/globebrowsing/src/skirtedgrid.h>
 #include <modules/globebrowsing/src/tileindex.h>
+#include <modules/globebrowsing/src/tileprefetcher.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
@@ -45,6 +49,7 @@
 #include <ghoul/opengl/uniformcache.h>
 #include <cstddef>
 #include <memory>
+#include <span>
 
 namespace openspace::documentation { struct Documentation; }
 
@@ -54,38 +59,6 @@ class GPULayerGroup;
 class RenderableGlobe;
 struct TileIndex;
 
-struct BoundingHeights {
-    float min;
-    float max;
-    bool available;
-    bool tileOK;
-};
-
-namespace chunklevelevaluator { class Evaluator; }
-namespace culling { class ChunkCuller; }
-
-struct Chunk {
-    enum class Status : uint8_t {
-        DoNothing,
-        WantMerge,
-        WantSplit
-    };
-
-    Chunk(const TileIndex& ti);
-
-    const TileIndex tileIndex;
-    const GeodeticPatch surfacePatch;
-
-    Status status;
-
-    bool isVisible = true;
-    bool colorTileOK = false;
-    bool heightTileOK = false;
-
-    std::array<glm::dvec4, 8> corners;
-    std::array<Chunk*, 4> children = { { nullptr, nullptr, nullptr, nullptr } };
-};
-
 enum class ShadowCompType {
     GLOBAL_SHADOW,
     LOCAL_SHADOW
@@ -112,6 +85,20 @@ public:
     SurfacePositionHandle calculateSurfacePositionHandle(
         const glm::dvec3& targetModelSpace) const override;
 
+    /**
+     * Calculates the heights from the surface of the reference ellipsoid to the height
+     * mapped surface for many positions at once. This is considerably faster than
+     * calling #calculateSurfacePositionHandle for each of the positions, in particular
+     * if consecutive positions are close to each other.
+     *
+     * \param positions The positions, in Cartesian model space, that get geodetically
+     *        projected onto the reference ellipsoid
+     * \param heights The destination of the heights, which has to have the same size as
+     *        \p positions. The height for a position without height data is 0
+     */
+    void calculateHeights(std::span<const glm::dvec3> positions,
+        std::span<float> heights) const;
+
     bool renderedWithDesiredData() const override;
 
     const Ellipsoid& ellipsoid() const;
@@ -122,6 +109,12 @@ public:
 
     const glm::dmat4& modelTransform() const;
 
+    /**
+     * \return The tile indices of the visible leaf chunks that were rendered last, which
+     *         are the chunks that determine the level of detail of the globe
+     */
+    const std::vector<TileIndex>& renderedChunkTiles() const;
+
     static documentation::Documentation Documentation();
 
 private:
@@ -133,6 +126,7 @@ private:
         properties::BoolProperty levelByProjectedAreaElseDistance;
         properties::BoolProperty resetTileProviders;
         properties::BoolProperty performFrustumCulling;
+        properties::BoolProperty parallelChunkEvaluation;
         properties::IntProperty  modelSpaceRenderingCutoffLevel;
         properties::IntProperty  dynamicLodIterationCount;
     } _debugProperties;
@@ -153,30 +147,32 @@ private:
         properties::IntProperty   nActiveLayers;
     } _generalProperties;
 
+    struct {
+        properties::BoolProperty  enabled;
+        properties::FloatProperty lookAheadTime;
+        properties::IntProperty   maxTilesPerFrame;
+        properties::IntProperty   nPrefetched;
+        properties::IntProperty   nHits;
+        properties::IntProperty   nMisses;
+        properties::IntProperty   nWasted;
+        properties::FloatProperty hitRate;
+    } _prefetchProperties;
+
     properties::PropertyOwner _debugPropertyOwner;
 
-    properties::PropertyOwner _shadowMappingPropertyOwner;
+    properties::PropertyOwner _prefetchPropertyOwner;
 
-    /**
-     * Test if a specific chunk can safely be culled without affecting the rendered image.
-     *
-     * Goes through all available `ChunkCuller`s and check if any of them allows culling
-     * of the `Chunk`s in question.
-     */
-    bool testIfCullable(const Chunk& chunk, const RenderData& renderData,
-        const BoundingHeights& heights, const glm::dmat4& mvp) const;
+    properties::PropertyOwner _shadowMappingPropertyOwner;
 
     /**
      * Gets the desired level which can be used to determine if a chunk should split or
-     * merge.
+     * merge. The \p levelByGeometry is the level that the chunk should have based on its
+     * size on screen, which is limited by the available tile data and the allowed levels.
      *
-     * Using `ChunkLevelEvaluator`s, the desired level can be higher or lower than the
-     * current level of the `Chunks`s `TileIndex`. If the desired level is higher than
-     * that of the `Chunk`, it wants to split. If it is lower, it wants to merge with its
-     * siblings.
+     * If the desired level is higher than that of the `Chunk`, it wants to split. If it
+     * is lower, it wants to merge with its siblings.
      */
-    int desiredLevel(const Chunk& chunk, const RenderData& renderData,
-        const BoundingHeights& heights) const;
+    int desiredLevel(const Chunk& chunk, int levelByGeometry) const;
 
     /**
      * Calculates the height from the surface of the reference ellipsoid to the height
@@ -224,15 +220,6 @@ private:
     void debugRenderChunk(const Chunk& chunk, const glm::dmat4& mvp,
         bool renderBounds) const;
 
-    bool isCullableByFrustum(const Chunk& chunk, const RenderData& renderData,
-        const glm::dmat4& mvp) const;
-    bool isCullableByHorizon(const Chunk& chunk, const RenderData& renderData,
-        const BoundingHeights& heights) const;
-
-    int desiredLevelByDistance(const Chunk& chunk, const RenderData& data,
-        const BoundingHeights& heights) const;
-    int desiredLevelByProjectedArea(const Chunk& chunk, const RenderData& data,
-        const BoundingHeights& heights) const;
     int desiredLevelByAvailableTileData(const Chunk& chunk) const;
 
 
@@ -248,10 +235,30 @@ private:
 
     void splitChunkNode(Chunk& cn, int depth);
     void mergeChunkNode(Chunk& cn);
-    bool updateChunkTree(Chunk& cn, const RenderData& data, const glm::dmat4& mvp);
-    void updateChunk(Chunk& chunk, const RenderData& data, const glm::dmat4& mvp) const;
+
+    /**
+     * Updates the visibility and the status of all chunks and splits and merges them
+     * accordingly. Everything that depends on the tile providers is gathered on the
+     * calling thread, while the visibility and desired level of the chunks are evaluated
+     * as a flat array, which is distributed to worker threads for large chunk trees.
+     */
+    void updateChunkTrees(const RenderData& data, const glm::dmat4& mvp);
+
+    /**
+     * Applies the previously computed status of the chunks in the tree below \p cn by
+     * splitting and merging them. Returns `true` if \p cn wants to be merged into its
+     * parent.
+     */
+    bool updateChunkTree(Chunk& cn);
+    void updateChunk(Chunk& chunk, const ChunkEvaluation& evaluation) const;
     void freeChunkNode(Chunk* n);
 
+    /**
+     * Requests the tiles that the chunk tree is predicted to need in the next seconds
+     * based on the movement of the camera.
+     */
+    void prefetchTiles(const RenderData& data);
+
     Ellipsoid _ellipsoid;
     SkirtedGrid _grid;
     LayerManager _layerManager;
@@ -266,6 +273,18 @@ private:
     std::vector<const Chunk*> _globalChunkBuffer;
     std::vector<const Chunk*> _localChunkBuffer;
     std::vector<const Chunk*> _traversalMemory;
+    std::vector<TileIndex> _renderedChunkTiles;
+
+    // The flattened chunk trees with the input and the result of their evaluation
+    std::vector<Chunk*> _evaluationChunks;
+    std::vector<BoundingHeights> _evaluationHeights;
+    std::vector<ChunkEvaluation> _evaluationResults;
+
+    TilePrefetcher _tilePrefetcher;
+    std::vector<TileIndex> _prefetchLeafBuffer;
+
+    // Height queries are logically const, but they fill the cache of height tiles
+    mutable HeightSampler _heightSampler;
 
 
     Chunk _leftRoot;  // Covers all negative longitudes
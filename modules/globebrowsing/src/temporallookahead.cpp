@@ -0,0 +1,94 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/temporallookahead.h>
+
+#include <algorithm>
+
+namespace openspace::globebrowsing::lookahead {
+
+std::vector<int> upcomingTimesteps(int timestep, int direction, int nSteps,
+                                   int nTimesteps)
+{
+    std::vector<int> res;
+    res.reserve(nSteps);
+    for (int i = 1; i <= nSteps; i++) {
+        const int next = timestep + i * direction;
+        if (next < 0 || next >= nTimesteps) {
+            break;
+        }
+        res.push_back(next);
+    }
+    return res;
+}
+
+std::vector<int> timestepsToPreload(std::span<const int> upcoming,
+                                    const std::function<bool(int)>& hasTileProvider)
+{
+    std::vector<int> res;
+    bool hasMissingTileProvider = false;
+    for (const int timestep : upcoming) {
+        if (!hasTileProvider(timestep)) {
+            if (hasMissingTileProvider) {
+                break;
+            }
+            hasMissingTileProvider = true;
+        }
+        res.push_back(timestep);
+    }
+    return res;
+}
+
+std::vector<int> timestepsToRetire(std::vector<std::pair<int, uint64_t>> tileProviders,
+                                   size_t budget,
+                                   const std::function<bool(int)>& isInUse)
+{
+    if (tileProviders.size() <= budget) {
+        return std::vector<int>();
+    }
+
+    // The timestep breaks ties so that the result does not depend on the input order
+    std::sort(
+        tileProviders.begin(),
+        tileProviders.end(),
+        [](const std::pair<int, uint64_t>& lhs, const std::pair<int, uint64_t>& rhs) {
+            return std::pair(lhs.second, lhs.first) < std::pair(rhs.second, rhs.first);
+        }
+    );
+
+    std::vector<int> res;
+    size_t nRemaining = tileProviders.size();
+    for (const std::pair<int, uint64_t>& p : tileProviders) {
+        if (nRemaining <= budget) {
+            break;
+        }
+        if (!isInUse(p.first)) {
+            res.push_back(p.first);
+            nRemaining--;
+        }
+    }
+    return res;
+}
+
+} // namespace openspace::globebrowsing::lookahead
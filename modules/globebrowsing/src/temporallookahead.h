@@ -0,0 +1,80 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TEMPORALLOOKAHEAD___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TEMPORALLOOKAHEAD___H__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * The policy that the TemporalTileProvider uses to decide which of its timesteps are
+ * loaded ahead of time and which of its tile providers are retired. The functions only
+ * work on the indices of the timesteps, so they can be used without any tile provider.
+ */
+namespace openspace::globebrowsing::lookahead {
+
+/**
+ * Returns the \p nSteps timesteps that follow the \p timestep in the \p direction of
+ * time, as far as they exist.
+ *
+ * \param timestep The index of the current timestep
+ * \param direction `1` if time moves forward, `-1` if it moves backward
+ * \param nSteps The maximum number of timesteps that are returned
+ * \param nTimesteps The number of timesteps in the dataset
+ * \return The upcoming timesteps, ordered by how soon they are needed
+ */
+std::vector<int> upcomingTimesteps(int timestep, int direction, int nSteps,
+    int nTimesteps);
+
+/**
+ * Returns the leading timesteps of \p upcoming that are preloaded in a single update.
+ * Creating a tile provider opens its dataset synchronously, so only the first timestep
+ * without a tile provider is included, and none of the ones that follow it.
+ *
+ * \param upcoming The timesteps as returned by #upcomingTimesteps
+ * \param hasTileProvider Returns whether a tile provider exists for a timestep
+ */
+std::vector<int> timestepsToPreload(std::span<const int> upcoming,
+    const std::function<bool(int)>& hasTileProvider);
+
+/**
+ * Returns the timesteps whose tile providers are retired so that no more than
+ * \p budget of them remain, starting with the least recently used one. Tile providers
+ * that are in use are never retired, so more than \p budget might remain.
+ *
+ * \param tileProviders The timestep and the last use of every tile provider
+ * \param budget The number of tile providers that should remain
+ * \param isInUse Returns whether the tile provider of a timestep is in use
+ */
+std::vector<int> timestepsToRetire(std::vector<std::pair<int, uint64_t>> tileProviders,
+    size_t budget, const std::function<bool(int)>& isInUse);
+
+} // namespace openspace::globebrowsing::lookahead
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TEMPORALLOOKAHEAD___H__
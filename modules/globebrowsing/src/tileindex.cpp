@@ -24,6 +24,8 @@
 
 #include <modules/globebrowsing/src/tileindex.h>
 
+#include <ghoul/misc/assert.h>
+
 namespace openspace::globebrowsing {
 
 bool operator==(const TileIndex& lhs, const TileIndex& rhs) {
@@ -40,6 +42,11 @@ TileIndex TileIndex::child(Quad q) const {
     return TileIndex(2 * x + q % 2, 2 * y + q / 2, level + 1);
 }
 
+TileIndex TileIndex::parent() const {
+    ghoul_assert(level > 0, "Tiles on level 0 have no parent");
+    return TileIndex(x / 2, y / 2, level - 1);
+}
+
 glm::vec2 TileIndex::positionRelativeParent() const {
     const bool isEastChild = (x % 2 == 1);
     const bool isNorthChild = (y % 2 == 0);
@@ -41,6 +41,12 @@ struct TileIndex {
     uint8_t level = 0;
 
     TileIndex child(Quad q) const;
+
+    /**
+     * \return The tile index of the tile on the next lower level that contains this tile.
+     *         Must not be called for tiles on level 0
+     */
+    TileIndex parent() const;
     glm::vec2 positionRelativeParent() const;
     TileHashKey hashKey() const;
 };
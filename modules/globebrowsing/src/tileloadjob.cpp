@@ -24,12 +24,19 @@
 
 #include <modules/globebrowsing/src/tileloadjob.h>
 
+#include <modules/globebrowsing/src/bcencoder.h>
+#include <modules/globebrowsing/src/disktilecache.h>
 #include <modules/globebrowsing/src/rawtiledatareader.h>
 
 namespace openspace::globebrowsing {
 
-TileLoadJob::TileLoadJob(RawTileDataReader& rawTileDataReader, TileIndex tileIndex)
+TileLoadJob::TileLoadJob(RawTileDataReader& rawTileDataReader, TileIndex tileIndex,
+                         cache::DiskTileCache* diskTileCache, uint64_t diskTileSource,
+                         TileTextureInitData::Compression textureCompression)
     : _rawTileDataReader(rawTileDataReader)
+    , _diskTileCache(diskTileCache)
+    , _diskTileSource(diskTileSource)
+    , _textureCompression(textureCompression)
     , _chunkIndex(std::move(tileIndex))
 {}
 
@@ -40,10 +47,35 @@ TileLoadJob::~TileLoadJob() {
 }
 
 void TileLoadJob::execute() {
-    _rawTile = _rawTileDataReader.readTileData(_chunkIndex);
+    if (_textureCompression == TileTextureInitData::Compression::None) {
+        _rawTile = readTile();
+    }
+    else {
+        _rawTile = bc::transcodeTile(readTile(), _textureCompression);
+    }
     _hasTile = true;
 }
 
+RawTile TileLoadJob::readTile() {
+    if (!_diskTileCache) {
+        return _rawTileDataReader.readTileData(_chunkIndex);
+    }
+
+    const cache::DiskTileKey key = {
+        .source = _diskTileSource,
+        .tileIndex = _chunkIndex
+    };
+    std::optional<RawTile> cached =
+        _diskTileCache->get(key, _rawTileDataReader.textureInitData());
+    if (cached.has_value()) {
+        return std::move(*cached);
+    }
+
+    RawTile rawTile = _rawTileDataReader.readTileData(_chunkIndex);
+    _diskTileCache->put(key, rawTile);
+    return rawTile;
+}
+
 RawTile TileLoadJob::product() {
     _hasTile = false;
     return std::move(_rawTile);
@@ -29,10 +29,12 @@
 
 #include <modules/globebrowsing/src/rawtile.h>
 #include <modules/globebrowsing/src/tileindex.h>
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
 
 namespace openspace::globebrowsing {
 
 class RawTileDataReader;
+namespace cache { class DiskTileCache; }
 
 struct TileLoadJob : public Job<RawTile> {
     /**
@@ -40,8 +42,18 @@ struct TileLoadJob : public Job<RawTile> {
      * data will be released. If `product()` has not been called before the TileLoadJob is
      * finished, the data will be deleted as it has not been exposed outside of this
      * object.
+     *
+     * If a \p diskTileCache is provided, the tile is first looked up there using the
+     * \p diskTileSource and is only read through the \p rawTileDataReader if it is
+     * missing, in which case it is added to the disk cache afterwards.
+     *
+     * If a \p textureCompression is provided, the pixel data of the tile is compressed
+     * after it has been read. The disk cache always stores the uncompressed tile.
      */
-    TileLoadJob(RawTileDataReader& rawTileDataReader, TileIndex tileIndex);
+    TileLoadJob(RawTileDataReader& rawTileDataReader, TileIndex tileIndex,
+        cache::DiskTileCache* diskTileCache = nullptr, uint64_t diskTileSource = 0,
+        TileTextureInitData::Compression textureCompression =
+            TileTextureInitData::Compression::None);
 
     /**
      * Destroys the allocated data pointer if it has been allocated and the TileLoadJob
@@ -63,7 +75,16 @@ struct TileLoadJob : public Job<RawTile> {
     RawTile product() override;
 
 protected:
+    /**
+     * Returns the tile from the disk cache if it exists there and reads it through the
+     * RawTileDataReader otherwise.
+     */
+    RawTile readTile();
+
     RawTileDataReader& _rawTileDataReader;
+    cache::DiskTileCache* _diskTileCache;
+    const uint64_t _diskTileSource;
+    const TileTextureInitData::Compression _textureCompression;
     RawTile _rawTile;
     const TileIndex _chunkIndex;
     bool _hasTile = false;
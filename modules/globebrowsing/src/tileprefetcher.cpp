@@ -0,0 +1,310 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/src/tileprefetcher.h>
+
+#include <modules/globebrowsing/src/basictypes.h>
+#include <modules/globebrowsing/src/geodeticpatch.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    using namespace openspace::globebrowsing;
+
+    // Time constant of the exponential smoothing of the camera velocity, in seconds
+    constexpr double VelocitySmoothing = 0.25;
+
+    // If no camera position was reported for this long, the old velocity is discarded
+    constexpr double MaxVelocityAge = 1.0;
+
+    // These are the same computations as the desiredLevelByDistance and
+    // desiredLevelByProjectedArea functions in chunkevaluation.h, assuming that all
+    // chunks have their minimum height at the surface of the ellipsoid
+    int desiredLevelByDistance(const Ellipsoid& ellipsoid, const GeodeticPatch& patch,
+                               const glm::dvec3& camera, const Geodetic2& cameraGeo,
+                               double lodScaleFactor)
+    {
+        const Geodetic2 pointOnPatch = patch.closestPoint(cameraGeo);
+        const glm::dvec3 patchPosition = ellipsoid.cartesianSurfacePosition(pointOnPatch);
+        const double distance = glm::length(patchPosition - camera);
+
+        const double scaleFactor = lodScaleFactor * ellipsoid.minimumRadius();
+        return static_cast<int>(std::ceil(std::log2(scaleFactor / distance)));
+    }
+
+    int desiredLevelByProjectedArea(const Ellipsoid& ellipsoid,
+                                    const GeodeticPatch& patch, int level,
+                                    const glm::dvec3& camera, const Geodetic2& cameraGeo,
+                                    double lodScaleFactor)
+    {
+        const Geodetic2 closestCorner = patch.closestCorner(cameraGeo);
+        const Geodetic2 center = patch.center();
+        const Geodetic3 c = { center, 0.0 };
+        const Geodetic3 c1 = { Geodetic2{ center.lat, closestCorner.lon }, 0.0 };
+        const Geodetic3 c2 = { Geodetic2{ closestCorner.lat, center.lon }, 0.0 };
+
+        const glm::dvec3 A = glm::normalize(ellipsoid.cartesianPosition(c) - camera);
+        const glm::dvec3 B = glm::normalize(ellipsoid.cartesianPosition(c1) - camera);
+        const glm::dvec3 C = glm::normalize(ellipsoid.cartesianPosition(c2) - camera);
+
+        const double areaABC = 0.5 * glm::length(glm::cross(C - A, B - A));
+        const double scaledArea = lodScaleFactor * 8.0 * areaABC;
+        return level + static_cast<int>(std::round(scaledArea - 1));
+    }
+
+    void selectTilesRecursive(const Ellipsoid& ellipsoid, const TileIndex& tileIndex,
+                              const glm::dvec3& camera, const Geodetic2& cameraGeo,
+                              const TilePrefetcher::Settings& settings,
+                              std::vector<TileIndex>& tiles)
+    {
+        const GeodeticPatch patch = GeodeticPatch(tileIndex);
+        const int level =
+            settings.levelMetric == TilePrefetcher::LevelMetric::ProjectedArea ?
+            desiredLevelByProjectedArea(
+                ellipsoid,
+                patch,
+                tileIndex.level,
+                camera,
+                cameraGeo,
+                settings.lodScaleFactor
+            ) :
+            desiredLevelByDistance(
+                ellipsoid,
+                patch,
+                camera,
+                cameraGeo,
+                settings.lodScaleFactor
+            );
+
+        if (tileIndex.level < std::clamp(level, settings.minLevel, settings.maxLevel)) {
+            for (int q = 0; q < 4; q++) {
+                selectTilesRecursive(
+                    ellipsoid,
+                    tileIndex.child(static_cast<Quad>(q)),
+                    camera,
+                    cameraGeo,
+                    settings,
+                    tiles
+                );
+            }
+        }
+        else {
+            tiles.push_back(tileIndex);
+        }
+    }
+} // namespace
+
+namespace openspace::globebrowsing {
+
+double TilePrefetcher::Statistics::hitRate() const {
+    const uint64_t total = nHits + nMisses;
+    return total > 0 ? static_cast<double>(nHits) / static_cast<double>(total) : 0.0;
+}
+
+TilePrefetcher::TilePrefetcher(Ellipsoid ellipsoid)
+    : _ellipsoid(std::move(ellipsoid))
+{}
+
+void TilePrefetcher::setEllipsoid(Ellipsoid ellipsoid) {
+    _ellipsoid = std::move(ellipsoid);
+}
+
+void TilePrefetcher::setSettings(Settings settings) {
+    _settings = std::move(settings);
+}
+
+const TilePrefetcher::Settings& TilePrefetcher::settings() const {
+    return _settings;
+}
+
+const TilePrefetcher::Statistics& TilePrefetcher::statistics() const {
+    return _statistics;
+}
+
+void TilePrefetcher::resetStatistics() {
+    _statistics = Statistics();
+}
+
+void TilePrefetcher::recordNeededTiles(std::span<const TileIndex> tiles, double time) {
+    ZoneScoped;
+
+    // The first frame has no previous frame to compare against, so all of its tiles
+    // would count as misses
+    const bool isFirstFrame = _needed.empty();
+
+    std::unordered_set<TileIndex::TileHashKey> needed;
+    needed.reserve(tiles.size());
+    for (const TileIndex& tile : tiles) {
+        const TileIndex::TileHashKey key = tile.hashKey();
+        needed.insert(key);
+        if (isFirstFrame || _needed.contains(key)) {
+            continue;
+        }
+
+        if (_prefetched.erase(key) > 0) {
+            _statistics.nHits++;
+        }
+        else {
+            _statistics.nMisses++;
+        }
+    }
+    _needed = std::move(needed);
+
+    std::erase_if(_prefetched, [this, time](const auto& p) {
+        if (p.second < time) {
+            _statistics.nWasted++;
+            return true;
+        }
+        return false;
+    });
+}
+
+std::vector<TileIndex> TilePrefetcher::update(double time,
+                                              const glm::dvec3& cameraPosition,
+                                              std::span<const glm::dvec3> plannedPath)
+{
+    ZoneScoped;
+
+    updateVelocity(time, cameraPosition);
+
+    std::vector<glm::dvec3> path;
+    if (plannedPath.empty()) {
+        path = extrapolatePath(cameraPosition);
+    }
+    else {
+        path.assign(plannedPath.begin(), plannedPath.end());
+    }
+    if (path.empty()) {
+        return {};
+    }
+
+    // Tiles that the chunk tree needs right now are requested through the normal path
+    _selection.clear();
+    selectTiles(_ellipsoid, cameraPosition, _settings, _selection);
+    _currentSelection.clear();
+    for (const TileIndex& tile : _selection) {
+        _currentSelection.insert(tile.hashKey());
+    }
+
+    // Allow for some slack as the prediction gets less accurate further in the future
+    const double expiration = time + 2.0 * _settings.lookAheadTime + MaxVelocityAge;
+
+    std::vector<TileIndex> result;
+    const size_t maxTiles = static_cast<size_t>(std::max(_settings.maxTilesPerUpdate, 0));
+    for (const glm::dvec3& position : path) {
+        _selection.clear();
+        selectTiles(_ellipsoid, position, _settings, _selection);
+
+        // Within a sample, the tiles closest to the future camera are the most urgent
+        std::vector<std::pair<double, TileIndex>> candidates;
+        for (const TileIndex& tile : _selection) {
+            const TileIndex::TileHashKey key = tile.hashKey();
+            if (_currentSelection.contains(key) || _prefetched.contains(key)) {
+                continue;
+            }
+            const glm::dvec3 center =
+                _ellipsoid.cartesianSurfacePosition(GeodeticPatch(tile).center());
+            candidates.emplace_back(glm::length(center - position), tile);
+        }
+        std::sort(
+            candidates.begin(),
+            candidates.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; }
+        );
+
+        for (const std::pair<double, TileIndex>& candidate : candidates) {
+            if (result.size() >= maxTiles) {
+                break;
+            }
+            _prefetched[candidate.second.hashKey()] = expiration;
+            result.push_back(candidate.second);
+        }
+        if (result.size() >= maxTiles) {
+            break;
+        }
+    }
+
+    _statistics.nPrefetched += result.size();
+    return result;
+}
+
+void TilePrefetcher::selectTiles(const Ellipsoid& ellipsoid,
+                                 const glm::dvec3& cameraPosition,
+                                 const Settings& settings, std::vector<TileIndex>& tiles)
+{
+    ZoneScoped;
+
+    const Geodetic2 cameraGeo = ellipsoid.cartesianToGeodetic2(cameraPosition);
+    // The two root chunks of the RenderableGlobe
+    const TileIndex left = TileIndex(0, 0, 1);
+    const TileIndex right = TileIndex(1, 0, 1);
+    selectTilesRecursive(ellipsoid, left, cameraPosition, cameraGeo, settings, tiles);
+    selectTilesRecursive(ellipsoid, right, cameraPosition, cameraGeo, settings, tiles);
+}
+
+void TilePrefetcher::updateVelocity(double time, const glm::dvec3& cameraPosition) {
+    const double dt = time - _lastTime;
+    if (_lastTime < 0.0 || dt > MaxVelocityAge) {
+        _velocity = glm::dvec3(0.0);
+    }
+    else if (dt > 0.0) {
+        const glm::dvec3 velocity = (cameraPosition - _lastPosition) / dt;
+        const double alpha = 1.0 - std::exp(-dt / VelocitySmoothing);
+        _velocity += (velocity - _velocity) * alpha;
+    }
+    else {
+        // Called twice for the same point in time, nothing new to learn
+        return;
+    }
+    _lastTime = time;
+    _lastPosition = cameraPosition;
+}
+
+std::vector<glm::dvec3> TilePrefetcher::extrapolatePath(
+                                                   const glm::dvec3& cameraPosition) const
+{
+    if (_velocity == glm::dvec3(0.0) || _settings.nSamples <= 0) {
+        return {};
+    }
+
+    std::vector<glm::dvec3> path;
+    path.reserve(_settings.nSamples);
+    for (int i = 1; i <= _settings.nSamples; i++) {
+        const double t = _settings.lookAheadTime * i / _settings.nSamples;
+        const glm::dvec3 position = cameraPosition + _velocity * t;
+
+        // A camera that is heading towards the globe will not fly through it
+        const Geodetic2 geo = _ellipsoid.cartesianToGeodetic2(position);
+        const glm::dvec3 surface = _ellipsoid.cartesianSurfacePosition(geo);
+        const glm::dvec3 normal = _ellipsoid.geodeticSurfaceNormal(geo);
+        if (glm::dot(position - surface, normal) <= 0.0) {
+            break;
+        }
+        path.push_back(position);
+    }
+    return path;
+}
+
+} // namespace openspace::globebrowsing
@@ -0,0 +1,148 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILEPREFETCHER___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILEPREFETCHER___H__
+
+#include <modules/globebrowsing/src/ellipsoid.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace openspace::globebrowsing {
+
+/**
+ * Predicts which tiles the chunk tree of a RenderableGlobe is going to need within the
+ * next few seconds, so that they can be requested before the chunk tree asks for them.
+ *
+ * The future camera positions are either provided by the caller (for example sampled
+ * from the camera path that is currently flown) or extrapolated from the velocity of
+ * the camera over the last frames. For each of the positions, the tiles are selected
+ * in the same way as the chunk tree selects its levels, minus the influence of height
+ * data. All positions are in the model space of the globe.
+ */
+class TilePrefetcher {
+public:
+    /// The same metrics that the RenderableGlobe uses to decide on a chunk's level
+    enum class LevelMetric {
+        Distance,
+        ProjectedArea
+    };
+
+    struct Settings {
+        /// The number of seconds into the future for which tiles are predicted
+        double lookAheadTime = 2.0;
+        /// The number of positions along the predicted path for which tiles are selected
+        int nSamples = 4;
+        /// The maximum number of tiles that are returned from a single call to #update
+        int maxTilesPerUpdate = 16;
+
+        LevelMetric levelMetric = LevelMetric::ProjectedArea;
+        double lodScaleFactor = 15.0;
+        int minLevel = 2;
+        int maxLevel = 22;
+    };
+
+    struct Statistics {
+        /// The number of tiles that have been returned for prefetching
+        uint64_t nPrefetched = 0;
+        /// The number of tiles that were needed and had been prefetched beforehand
+        uint64_t nHits = 0;
+        /// The number of tiles that were needed and had not been prefetched
+        uint64_t nMisses = 0;
+        /// The number of prefetched tiles that were not needed within the look-ahead time
+        uint64_t nWasted = 0;
+
+        /// The fraction of needed tiles that were prefetched, or 0 if none were needed
+        double hitRate() const;
+    };
+
+    explicit TilePrefetcher(Ellipsoid ellipsoid = Ellipsoid());
+
+    void setEllipsoid(Ellipsoid ellipsoid);
+    void setSettings(Settings settings);
+    const Settings& settings() const;
+
+    const Statistics& statistics() const;
+    void resetStatistics();
+
+    /**
+     * Informs the prefetcher about the tiles that the chunk tree used at \p time. Tiles
+     * that were not needed in the previous call are counted as either hits or misses
+     * depending on whether they were returned by #update before.
+     *
+     * \param tiles The leaf tiles of the chunk tree
+     * \param time The time in seconds, which has to use the same clock as #update
+     */
+    void recordNeededTiles(std::span<const TileIndex> tiles, double time);
+
+    /**
+     * Predicts the future camera path and returns the tiles that should be requested
+     * now, ordered by how soon they are expected to be needed. Tiles that are needed
+     * for the current \p cameraPosition or that were already returned are excluded.
+     *
+     * \param time The time in seconds, used to estimate the velocity of the camera
+     * \param cameraPosition The current camera position in the model space of the globe
+     * \param plannedPath Future camera positions, evenly spaced over the look-ahead
+     *        time. If this is empty, the path is extrapolated from the camera velocity
+     * \return The tiles that should be prefetched
+     */
+    std::vector<TileIndex> update(double time, const glm::dvec3& cameraPosition,
+        std::span<const glm::dvec3> plannedPath = {});
+
+    /**
+     * Appends the leaves of the chunk tree that would be selected for a camera at the
+     * \p cameraPosition to \p tiles.
+     */
+    static void selectTiles(const Ellipsoid& ellipsoid, const glm::dvec3& cameraPosition,
+        const Settings& settings, std::vector<TileIndex>& tiles);
+
+private:
+    void updateVelocity(double time, const glm::dvec3& cameraPosition);
+    std::vector<glm::dvec3> extrapolatePath(const glm::dvec3& cameraPosition) const;
+
+    Ellipsoid _ellipsoid;
+    Settings _settings;
+    Statistics _statistics;
+
+    double _lastTime = -1.0;
+    glm::dvec3 _lastPosition = glm::dvec3(0.0);
+    glm::dvec3 _velocity = glm::dvec3(0.0);
+
+    /// Tiles that were prefetched and the time until they are expected to be needed
+    std::unordered_map<TileIndex::TileHashKey, double> _prefetched;
+    std::unordered_set<TileIndex::TileHashKey> _needed;
+
+    // Reused between calls to avoid reallocations
+    std::vector<TileIndex> _selection;
+    std::unordered_set<TileIndex::TileHashKey> _currentSelection;
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILEPREFETCHER___H__
@@ -25,10 +25,12 @@
 #include <modules/globebrowsing/src/tileprovider/defaulttileprovider.h>
 
 #include <modules/globebrowsing/globebrowsingmodule.h>
+#include <modules/globebrowsing/src/disktilecache.h>
 #include <modules/globebrowsing/src/memoryawaretilecache.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/moduleengine.h>
+#include <ghoul/logging/logmanager.h>
 #include <optional>
 
 namespace {
@@ -58,6 +60,16 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo ReaderThreadsInfo = {
+        "ReaderThreads",
+        "Reader Threads",
+        "The number of threads that read tiles from the dataset concurrently. Every "
+        "thread uses its own handle to the dataset, so increasing this value can speed "
+        "up the loading of large local datasets on fast drives. Changing this value only "
+        "takes effect when the tile provider is reset",
+        openspace::properties::Property::Visibility::Developer
+    };
+
     enum class [[codegen::stringify()]] Compression {
         PNG = 0,
         JPEG,
@@ -85,6 +97,24 @@ namespace {
         // Determines if the tiles should be preprocessed before uploading to the GPU
         std::optional<bool> performPreProcessing;
 
+        // [[codegen::verbatim(ReaderThreadsInfo.description)]]
+        std::optional<int> readerThreads [[codegen::inrange(1, 64)]];
+
+        enum class
+        [[codegen::map(openspace::globebrowsing::TileTextureInitData::Compression)]]
+        TextureCompression
+        {
+            None,
+            BC1,
+            BC7
+        };
+        // The block compression in which the tiles are stored on the GPU. BC1 tiles use
+        // an eighth of the memory of uncompressed tiles but only support fully opaque or
+        // fully transparent pixels, BC7 tiles use a quarter of the memory at a higher
+        // quality. The tiles are compressed on the threads that read them, which makes
+        // loading slower. Only color tiles with 8 bits per channel can be compressed
+        std::optional<TextureCompression> textureCompression;
+
         struct CacheSettings {
             // Specifies whether to use caching or not
             std::optional<bool> enabled;
@@ -124,6 +154,7 @@ documentation::Documentation DefaultTileProvider::Documentation() {
 DefaultTileProvider::DefaultTileProvider(const ghoul::Dictionary& dictionary)
     : _filePath(FilePathInfo, "")
     , _tilePixelSize(TilePixelSizeInfo, 32, 32, 2048)
+    , _readerThreads(ReaderThreadsInfo, 1, 1, 64)
 {
     ZoneScoped;
 
@@ -145,6 +176,8 @@ DefaultTileProvider::DefaultTileProvider(const ghoul::Dictionary& dictionary)
     _performPreProcessing = (_layerGroupID == layers::Group::ID::HeightLayers);
     _performPreProcessing = p.performPreProcessing.value_or(_performPreProcessing);
 
+    _readerThreads = p.readerThreads.value_or(_readerThreads);
+
     // Get the name of the layergroup to which this layer belongs
     auto it = std::find_if(
         layers::Groups.begin(),
@@ -191,10 +224,23 @@ DefaultTileProvider::DefaultTileProvider(const ghoul::Dictionary& dictionary)
         tileTextureInitData(_layerGroupID, pixelSize)
     );
     _tilePixelSize = initData.dimensions.x;
+
+    if (p.textureCompression.has_value()) {
+        _textureCompression =
+            codegen::map<TileTextureInitData::Compression>(*p.textureCompression);
+        if (!supportsCompression(initData, _textureCompression)) {
+            LWARNING(
+                "Texture compression is only supported for color layers with 8 bits per "
+                "channel and tile sizes that are a multiple of 4"
+            );
+        }
+    }
+
     initAsyncTileDataReader(std::move(initData), _cacheProperties);
 
     addProperty(_filePath);
     addProperty(_tilePixelSize);
+    addProperty(_readerThreads);
 }
 
 void DefaultTileProvider::initAsyncTileDataReader(TileTextureInitData initData,
@@ -202,14 +248,30 @@ void DefaultTileProvider::initAsyncTileDataReader(TileTextureInitData initData,
 {
     ZoneScoped;
 
+    // The unique identifier of the provider changes between runs, so the tiles on disk
+    // are instead identified by everything that determines their pixel values
+    const uint64_t diskTileSource = cache::DiskTileCache::sourceHash(std::format(
+        "{}|{}|{}", _filePath.value(), initData.hashKey, _performPreProcessing
+    ));
+
+    // The tile size might have changed since the compression was requested
+    const TileTextureInitData::Compression compression =
+        supportsCompression(initData, _textureCompression) ?
+        _textureCompression :
+        TileTextureInitData::Compression::None;
+
     _asyncTextureDataProvider = std::make_unique<AsyncTileDataProvider>(
         name,
         std::make_unique<RawTileDataReader>(
             _filePath,
             std::move(initData),
             std::move(cacheProperties),
-            RawTileDataReader::PerformPreprocessing(_performPreProcessing)
-        )
+            RawTileDataReader::PerformPreprocessing(_performPreProcessing),
+            _readerThreads
+        ),
+        global::moduleEngine->module<GlobeBrowsingModule>()->diskTileCache(),
+        diskTileSource,
+        compression
     );
 }
 
@@ -227,7 +289,9 @@ Tile DefaultTileProvider::tile(const TileIndex& tileIndex) {
     cache::MemoryAwareTileCache* tileCache =
         global::moduleEngine->module<GlobeBrowsingModule>()->tileCache();
     Tile tile = tileCache->get(key);
-    if (!tile.texture) {
+    // Tiles that have been loaded but are waiting for their upload must not be loaded
+    // again, but they are uploaded sooner when they are needed
+    if (!tile.texture && !tileCache->touchUpload(key)) {
         _asyncTextureDataProvider->enqueueTileIO(tileIndex);
     }
 
@@ -251,6 +315,24 @@ Tile::Status DefaultTileProvider::tileStatus(const TileIndex& index) {
     return tileCache->get(key).status;
 }
 
+bool DefaultTileProvider::prefetch(const TileIndex& tileIndex) {
+    ghoul_assert(_asyncTextureDataProvider, "No data provider");
+    if (tileIndex.level > maxLevel()) {
+        return false;
+    }
+
+    const cache::ProviderTileKey key = {
+        .tileIndex = tileIndex,
+        .providerID = uniqueIdentifier
+    };
+    cache::MemoryAwareTileCache* tileCache =
+        global::moduleEngine->module<GlobeBrowsingModule>()->tileCache();
+    if (tileCache->exist(key) || tileCache->isUploadPending(key)) {
+        return false;
+    }
+    return _asyncTextureDataProvider->prefetchTileIO(tileIndex);
+}
+
 TileDepthTransform DefaultTileProvider::depthTransform() {
     ghoul_assert(_asyncTextureDataProvider, "No data provider");
     return _asyncTextureDataProvider->rawTileDataReader().depthTransform();
@@ -260,16 +342,18 @@ void DefaultTileProvider::update() {
     ghoul_assert(_asyncTextureDataProvider, "No data provider");
     _asyncTextureDataProvider->update();
 
-    std::optional<RawTile> tile = _asyncTextureDataProvider->popFinishedRawTile();
-    if (tile) {
-        const cache::ProviderTileKey key = {
-            .tileIndex = tile->tileIndex,
-            .providerID = uniqueIdentifier
-        };
+    std::vector<RawTile> tiles = _asyncTextureDataProvider->popFinishedRawTiles();
+    if (!tiles.empty()) {
         cache::MemoryAwareTileCache* tileCache =
             global::moduleEngine->module<GlobeBrowsingModule>()->tileCache();
-        ghoul_assert(!tileCache->exist(key), "Tile must not be existing in cache");
-        tileCache->createTileAndPut(key, std::move(*tile));
+        for (RawTile& tile : tiles) {
+            const cache::ProviderTileKey key = {
+                .tileIndex = tile.tileIndex,
+                .providerID = uniqueIdentifier
+            };
+            ghoul_assert(!tileCache->exist(key), "Tile must not be existing in cache");
+            tileCache->enqueueUpload(key, std::move(tile));
+        }
     }
 
     if (_asyncTextureDataProvider->shouldBeDeleted()) {
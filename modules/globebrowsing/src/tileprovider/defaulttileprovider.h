@@ -38,6 +38,7 @@ public:
 
     Tile tile(const TileIndex& tileIndex) override final;
     Tile::Status tileStatus(const TileIndex& index) override final;
+    bool prefetch(const TileIndex& tileIndex) override final;
     TileDepthTransform depthTransform() override final;
     void update() override final;
     void reset() override final;
@@ -53,10 +54,13 @@ private:
 
     properties::StringProperty _filePath;
     properties::IntProperty _tilePixelSize;
+    properties::IntProperty _readerThreads;
 
     std::unique_ptr<AsyncTileDataProvider> _asyncTextureDataProvider;
     layers::Group::ID _layerGroupID = layers::Group::ID::Unknown;
     bool _performPreProcessing = false;
+    TileTextureInitData::Compression _textureCompression =
+        TileTextureInitData::Compression::None;
     TileCacheProperties _cacheProperties;
 };
 
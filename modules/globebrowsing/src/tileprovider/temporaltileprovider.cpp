@@ -26,6 +26,7 @@
 
 #include <modules/globebrowsing/globebrowsingmodule.h>
 #include <modules/globebrowsing/src/memoryawaretilecache.h>
+#include <modules/globebrowsing/src/temporallookahead.h>
 #include <modules/globebrowsing/src/tileprovider/defaulttileprovider.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/engine/globals.h>
@@ -38,6 +39,7 @@
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/opengl/openglstatecache.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
@@ -46,6 +48,11 @@
 namespace {
     constexpr std::string_view TimePlaceholder = "${OpenSpaceTimeId}";
 
+    // The maximum number of tiles of upcoming timesteps whose loading is started in a
+    // single update, so that the look-ahead does not crowd out the tiles that are needed
+    // right now
+    constexpr int MaxLookAheadPrefetchesPerUpdate = 32;
+
     constexpr openspace::properties::Property::PropertyInfo UseFixedTimeInfo = {
         "UseFixedTime",
         "Use Fixed Time",
@@ -63,6 +70,23 @@ namespace {
         openspace::properties::Property::Visibility::AdvancedUser
     };
 
+    constexpr openspace::properties::Property::PropertyInfo LookAheadStepsInfo = {
+        "LookAheadSteps",
+        "Look-ahead steps",
+        "The number of upcoming timesteps, in the direction in which time is moving, for "
+        "which the currently visible tiles are loaded ahead of time. A value of 0 "
+        "disables the loading ahead of time",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo TileProviderBudgetInfo = {
+        "TileProviderBudget",
+        "Tile provider budget",
+        "The maximum number of timesteps for which the data sources are kept open. If "
+        "there are more, the ones that have been used least recently are closed",
+        openspace::properties::Property::Visibility::AdvancedUser
+    };
+
     struct [[codegen::Dictionary(TemporalTileProvider)]] Parameters {
         // [[codegen::verbatim(UseFixedTimeInfo.description)]]
         std::optional<bool> useFixedTime;
@@ -70,6 +94,12 @@ namespace {
         // [[codegen::verbatim(FixedTimeInfo.description)]]
         std::optional<std::string> fixedTime;
 
+        // [[codegen::verbatim(LookAheadStepsInfo.description)]]
+        std::optional<int> lookAheadSteps [[codegen::inrange(0, 16)]];
+
+        // [[codegen::verbatim(TileProviderBudgetInfo.description)]]
+        std::optional<int> tileProviderBudget [[codegen::inrange(4, 256)]];
+
         enum class Mode {
             Prototyped,
             Folder
@@ -166,6 +196,8 @@ TemporalTileProvider::TemporalTileProvider(const ghoul::Dictionary& dictionary)
     : _initDict(dictionary)
     , _useFixedTime(UseFixedTimeInfo, false)
     , _fixedTime(FixedTimeInfo)
+    , _lookAheadSteps(LookAheadStepsInfo, 2, 0, 16)
+    , _tileProviderBudget(TileProviderBudgetInfo, 16, 4, 256)
 {
     ZoneScoped;
 
@@ -192,6 +224,15 @@ TemporalTileProvider::TemporalTileProvider(const ghoul::Dictionary& dictionary)
     _fixedTime.onChange([this]() { _fixedTimeDirty = true; });
     addProperty(_fixedTime);
 
+    _lookAheadSteps = p.lookAheadSteps.value_or(_lookAheadSteps);
+    _lookAheadSteps.onChange([this]() {
+        _lookAheadBase = -1;
+    });
+    addProperty(_lookAheadSteps);
+
+    _tileProviderBudget = p.tileProviderBudget.value_or(_tileProviderBudget);
+    addProperty(_tileProviderBudget);
+
     _colormap = p.colormap.value_or(_colormap);
 
     if (p.prototyped.has_value()) {
@@ -199,8 +240,6 @@ TemporalTileProvider::TemporalTileProvider(const ghoul::Dictionary& dictionary)
 
         const Time start = Time(p.prototyped->time.start);
         Time end = Time::now();
-        _prototyped.startTimeJ2000 = start.j2000Seconds();
-        _prototyped.endTimeJ2000 = Time(p.prototyped->time.end).j2000Seconds();
         if (p.prototyped->time.end == "Yesterday") {
             end.advanceTime(-60.0 * 60.0 * 24.0); // Go back one day
         }
@@ -214,7 +253,9 @@ TemporalTileProvider::TemporalTileProvider(const ghoul::Dictionary& dictionary)
                 std::string(end.ISO8601())
             );
             _prototyped.timeQuantizer.setResolution(p.prototyped->temporalResolution);
-            _prototyped.temporalResolution = p.prototyped->temporalResolution;
+            // All quantized times are computed once here so that finding the timestep
+            // for a time is a binary search rather than a date calculation every frame
+            _prototyped.timeQuantizer.compile();
         }
         catch (const ghoul::RuntimeError& e) {
             throw ghoul::RuntimeError(std::format(
@@ -222,6 +263,13 @@ TemporalTileProvider::TemporalTileProvider(const ghoul::Dictionary& dictionary)
             ));
         }
 
+        if (_prototyped.timeQuantizer.nTimesteps() == 0) {
+            throw ghoul::RuntimeError(std::format(
+                "Error loading layer '{}'. The time range does not contain any timesteps",
+                _identifier
+            ));
+        }
+
         if (p.prototyped->timeFormat.size() >= 64) {
             throw ghoul::RuntimeError(std::format(
                 "Time format string '{}' too large. Maximum length of 64 is allowed",
@@ -321,6 +369,10 @@ Tile TemporalTileProvider::tile(const TileIndex& tileIndex) {
         update();
     }
 
+    if (_lookAheadSteps > 0 && _requestedTileKeys.insert(tileIndex.hashKey()).second) {
+        _requestedTiles.push_back(tileIndex);
+    }
+
     return _currentTileProvider->tile(tileIndex);
 }
 
@@ -332,6 +384,14 @@ Tile::Status TemporalTileProvider::tileStatus(const TileIndex& index) {
     return _currentTileProvider->tileStatus(index);
 }
 
+bool TemporalTileProvider::prefetch(const TileIndex& tileIndex) {
+    if (!_currentTileProvider) {
+        update();
+    }
+
+    return _currentTileProvider->prefetch(tileIndex);
+}
+
 TileDepthTransform TemporalTileProvider::depthTransform() {
     if (!_currentTileProvider) {
         update();
@@ -342,12 +402,13 @@ TileDepthTransform TemporalTileProvider::depthTransform() {
 
 void TemporalTileProvider::update() {
     TileProvider* newCurr = nullptr;
+    const bool usesFixedTime = _useFixedTime && !_fixedTime.value().empty();
     try {
-        if (_useFixedTime && !_fixedTime.value().empty()) {
+        if (usesFixedTime) {
             if (_fixedTimeDirty) {
                 const std::string fixedTime = _fixedTime.value();
                 const double et = SpiceManager::ref().ephemerisTimeFromDate(fixedTime);
-                newCurr = retrieveTileProvider(Time(et));
+                newCurr = retrieveTileProvider(timestep(et));
                 _fixedTimeDirty = false;
             }
         }
@@ -365,10 +426,28 @@ void TemporalTileProvider::update() {
     if (_currentTileProvider) {
         _currentTileProvider->update();
     }
+
+    if (usesFixedTime) {
+        _lookAheadTimesteps.clear();
+    }
+    else {
+        try {
+            updateLookAhead();
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC("TemporalTileProvider", e.message);
+            _lookAheadTimesteps.clear();
+        }
+    }
+    retireTileProviders();
+
+    _requestedTiles.clear();
+    _requestedTileKeys.clear();
+    _nUpdates++;
 }
 
 void TemporalTileProvider::reset() {
-    for (std::pair<const double, DefaultTileProvider>& it : _tileProviderMap) {
+    for (std::pair<const int, DefaultTileProvider>& it : _tileProviderMap) {
         it.second.reset();
     }
 }
@@ -426,67 +505,190 @@ DefaultTileProvider TemporalTileProvider::createTileProvider(
     return DefaultTileProvider(dict);
 }
 
-DefaultTileProvider* TemporalTileProvider::retrieveTileProvider(const Time& t) {
+DefaultTileProvider* TemporalTileProvider::retrieveTileProvider(int timestep) {
     ZoneScoped;
 
-    const double time = t.j2000Seconds();
-    if (const auto it = _tileProviderMap.find(time);  it != _tileProviderMap.end()) {
+    if (const auto it = _tileProviderMap.find(timestep);  it != _tileProviderMap.end()) {
+        _tileProviderLastUse[timestep] = _nUpdates;
         return &it->second;
     }
 
-    const std::string_view timeStr = [this, time]() {
+    // The time string of a timestep is only needed to create its tile provider, so it is
+    // not part of the lookup that happens every frame
+    DefaultTileProvider tileProvider = [this, timestep]() {
         switch (_mode) {
-            case Mode::Prototype:
-                return timeStringify(_prototyped.timeFormat, Time(time));
-            case Mode::Folder: {
-                // Yes this will have to be done twice since we do the check previously
-                // but it is only happening when the images change, so I think that should
-                // be fine
-                auto it = std::lower_bound(
-                    _folder.files.cbegin(),
-                    _folder.files.cend(),
-                    time,
-                    [](const std::pair<double, std::string>& p, double sec) {
-                        return p.first < sec;
-                    }
-                );
-                return std::string_view(it->second);
+            case Mode::Prototype: {
+                const Time t = Time(_prototyped.timeQuantizer.timestepISO8601(timestep));
+                return createTileProvider(timeStringify(_prototyped.timeFormat, t));
             }
+            case Mode::Folder:
+                return createTileProvider(_folder.files[timestep].second);
             default:
                 throw ghoul::MissingCaseException();
         };
     }();
-
-    DefaultTileProvider tileProvider = createTileProvider(timeStr);
     tileProvider.initialize();
 
-    auto it = _tileProviderMap.insert({ time, std::move(tileProvider) });
+    auto it = _tileProviderMap.insert({ timestep, std::move(tileProvider) });
+    _tileProviderLastUse[timestep] = _nUpdates;
     return &it.first->second;
 }
 
-template <>
-TileProvider*
-TemporalTileProvider::tileProvider<TemporalTileProvider::Mode::Folder, false>(
-                                                                         const Time& time)
-{
-    // Find the most current image that matches the current time. We can't pass the `time`
-    // variable into the retrieveTileProvider function as it would generate a new
-    // non-existing TileProvider for every new frame
-    auto it = std::lower_bound(
-        _folder.files.begin(),
-        _folder.files.end(),
-        time.j2000Seconds(),
-        [](const std::pair<double, std::string>& p, double t) {
-            return p.first < t;
+int TemporalTileProvider::timestep(double j2000) const {
+    switch (_mode) {
+        case Mode::Prototype:
+            return _prototyped.timeQuantizer.timestep(j2000);
+        case Mode::Folder: {
+            // Find the most current image that matches the time
+            auto it = std::upper_bound(
+                _folder.files.begin(),
+                _folder.files.end(),
+                j2000,
+                [](double t, const std::pair<double, std::string>& p) {
+                    return t < p.first;
+                }
+            );
+
+            if (it != _folder.files.begin()) {
+                it -= 1;
+            }
+            return static_cast<int>(std::distance(_folder.files.begin(), it));
+        }
+        default:
+            throw ghoul::MissingCaseException();
+    }
+}
+
+int TemporalTileProvider::nTimesteps() const {
+    switch (_mode) {
+        case Mode::Prototype:
+            return _prototyped.timeQuantizer.nTimesteps();
+        case Mode::Folder:
+            return static_cast<int>(_folder.files.size());
+        default:
+            throw ghoul::MissingCaseException();
+    }
+}
+
+void TemporalTileProvider::updateLookAhead() {
+    ZoneScoped;
+
+    const double deltaTime = global::timeManager->deltaTime();
+    if (_lookAheadSteps == 0 || deltaTime == 0.0) {
+        _lookAheadTimesteps.clear();
+        return;
+    }
+
+    // When interpolating, the earlier of the two interpolated timesteps is the current
+    const TileProvider* current =
+        _isInterpolating ? _interpolateTileProvider->t1 : _currentTileProvider;
+    const auto it = std::find_if(
+        _tileProviderMap.cbegin(),
+        _tileProviderMap.cend(),
+        [current](const std::pair<const int, DefaultTileProvider>& p) {
+            return &p.second == current;
+        }
+    );
+    if (it == _tileProviderMap.cend()) {
+        _lookAheadTimesteps.clear();
+        return;
+    }
+
+    const int direction = deltaTime > 0.0 ? 1 : -1;
+    if (it->first != _lookAheadBase || direction != _lookAheadDirection) {
+        _lookAheadTimesteps = lookahead::upcomingTimesteps(
+            it->first,
+            direction,
+            _lookAheadSteps,
+            nTimesteps()
+        );
+        _lookAheadBase = it->first;
+        _lookAheadDirection = direction;
+    }
+
+    // The timesteps are ordered by how soon they are needed, so the closest ones get
+    // their tiles first
+    const std::vector<int> preloaded = lookahead::timestepsToPreload(
+        _lookAheadTimesteps,
+        [this](int timestep) { return _tileProviderMap.contains(timestep); }
+    );
+    int nPrefetches = 0;
+    for (const int timestep : preloaded) {
+        DefaultTileProvider* tileProvider = retrieveTileProvider(timestep);
+
+        // The tile provider has to be updated to pass its finished tiles on to the cache
+        tileProvider->update();
+        for (const TileIndex& tileIndex : _requestedTiles) {
+            if (nPrefetches >= MaxLookAheadPrefetchesPerUpdate) {
+                return;
+            }
+            if (tileProvider->prefetch(tileIndex)) {
+                nPrefetches++;
+            }
+        }
+    }
+}
+
+void TemporalTileProvider::retireTileProviders() {
+    ZoneScoped;
+
+    const size_t budget = static_cast<size_t>(_tileProviderBudget.value());
+    if (_tileProviderMap.size() <= budget) {
+        return;
+    }
+
+    std::vector<std::pair<int, uint64_t>> tileProviders;
+    tileProviders.reserve(_tileProviderMap.size());
+    for (const std::pair<const int, DefaultTileProvider>& p : _tileProviderMap) {
+        const auto lastUse = _tileProviderLastUse.find(p.first);
+        tileProviders.emplace_back(
+            p.first,
+            lastUse != _tileProviderLastUse.end() ? lastUse->second : 0
+        );
+    }
+
+    const std::vector<int> retired = lookahead::timestepsToRetire(
+        std::move(tileProviders),
+        budget,
+        [this](int timestep) {
+            return isInUse(timestep, _tileProviderMap.at(timestep));
         }
     );
+    for (const int timestep : retired) {
+        const auto it = _tileProviderMap.find(timestep);
+        it->second.deinitialize();
+        _tileProviderMap.erase(it);
+        _tileProviderLastUse.erase(timestep);
+    }
+}
 
-    if (it != _folder.files.begin()) {
-        it -= 1;
+bool TemporalTileProvider::isInUse(int timestep,
+                                   const DefaultTileProvider& tileProvider) const
+{
+    const TileProvider* p = &tileProvider;
+    if (p == _currentTileProvider) {
+        return true;
     }
+    if (_interpolateTileProvider &&
+        (p == _interpolateTileProvider->t1 || p == _interpolateTileProvider->t2 ||
+         p == _interpolateTileProvider->before || p == _interpolateTileProvider->future))
+    {
+        return true;
+    }
+    const auto it = std::find(
+        _lookAheadTimesteps.cbegin(),
+        _lookAheadTimesteps.cend(),
+        timestep
+    );
+    return it != _lookAheadTimesteps.cend();
+}
 
-    const double t = it->first;
-    return retrieveTileProvider(Time(t));
+template <>
+TileProvider*
+TemporalTileProvider::tileProvider<TemporalTileProvider::Mode::Folder, false>(
+                                                                         const Time& time)
+{
+    return retrieveTileProvider(timestep(time.j2000Seconds()));
 }
 
 template <>
@@ -494,7 +696,7 @@ TileProvider*
 TemporalTileProvider::tileProvider<TemporalTileProvider::Mode::Folder, true>(
                                                                          const Time& time)
 {
-    auto next = std::lower_bound(
+    auto it = std::lower_bound(
         _folder.files.begin(),
         _folder.files.end(),
         time.j2000Seconds(),
@@ -503,26 +705,23 @@ TemporalTileProvider::tileProvider<TemporalTileProvider::Mode::Folder, true>(
         }
     );
 
-    auto curr = next != _folder.files.begin() ? next - 1 : next;
-    auto nextNext = next != _folder.files.end() ? next + 1 : curr;
-
-    if (next == _folder.files.end()) {
-        curr = _folder.files.end() - 1;
-        next = curr;
-        nextNext = curr;
-    }
-
-    auto prev = curr != _folder.files.begin() ? curr - 1 : curr;
-
-    _interpolateTileProvider->t1 = retrieveTileProvider(Time(curr->first));
-    _interpolateTileProvider->t2 = retrieveTileProvider(Time(next->first));
-    _interpolateTileProvider->future = retrieveTileProvider(Time(nextNext->first));
-    _interpolateTileProvider->before = retrieveTileProvider(Time(prev->first));
-
-    const float factor = static_cast<float>(
-        (time.j2000Seconds() - curr->first) / (next->first - curr->first)
+    const int last = static_cast<int>(_folder.files.size()) - 1;
+    const int next = std::min(
+        static_cast<int>(std::distance(_folder.files.begin(), it)),
+        last
     );
-
+    const int curr = it != _folder.files.end() ? std::max(next - 1, 0) : last;
+
+    _interpolateTileProvider->t1 = retrieveTileProvider(curr);
+    _interpolateTileProvider->t2 = retrieveTileProvider(next);
+    _interpolateTileProvider->future = retrieveTileProvider(std::min(next + 1, last));
+    _interpolateTileProvider->before = retrieveTileProvider(std::max(curr - 1, 0));
+
+    const double currTime = _folder.files[curr].first;
+    const double nextTime = _folder.files[next].first;
+    const float factor = next != curr ?
+        static_cast<float>((time.j2000Seconds() - currTime) / (nextTime - currTime)) :
+        1.f;
     _interpolateTileProvider->factor = std::clamp(factor, 0.f, 1.f);
 
     return _interpolateTileProvider.get();
@@ -533,13 +732,7 @@ TileProvider*
 TemporalTileProvider::tileProvider<TemporalTileProvider::Mode::Prototype, false>(
                                                                          const Time& time)
 {
-    Time tCopy(time);
-    if (_prototyped.timeQuantizer.quantize(tCopy, true)) {
-        return retrieveTileProvider(tCopy);
-    }
-    else {
-        return nullptr;
-    }
+    return retrieveTileProvider(timestep(time.j2000Seconds()));
 }
 
 template <>
@@ -547,98 +740,23 @@ TileProvider*
 TemporalTileProvider::tileProvider<TemporalTileProvider::Mode::Prototype, true>(
                                                                          const Time& time)
 {
-    Time tCopy(time);
-    if (!_prototyped.timeQuantizer.quantize(tCopy, true)) {
-        return nullptr;
-    }
-
-    Time nextTile = tCopy;
-    Time nextNextTile = tCopy;
-    Time prevTile = tCopy;
-    Time secondToLast = Time(_prototyped.endTimeJ2000);
-    Time secondToFirst = Time(_prototyped.startTimeJ2000);
-
-    _interpolateTileProvider->t1 = retrieveTileProvider(tCopy);
-
-    // if the images are for each hour
-    if (_prototyped.temporalResolution == "1h") {
-        constexpr int Hour = 60 * 60;
-        // the second tile to interpolate between
-        nextTile.advanceTime(Hour);
-        // the tile after the second tile
-        nextNextTile.advanceTime(2 * Hour);
-        // the tile before the first tile
-        prevTile.advanceTime(-Hour + 1);
-        // to make sure that an image outside the dataset is not searched for both
-        // ends of the dataset are calculated
-        secondToLast.advanceTime(-Hour);
-        secondToFirst.advanceTime(Hour);
-    }
-    // if the images are for each month
-    if (_prototyped.temporalResolution == "1M") {
-        constexpr int Day = 24 * 60 * 60;
-
-        // the second tile to interpolate between
-        nextTile.advanceTime(32 * Day);
-        // the tile after the second tile
-        nextNextTile.advanceTime(64 * Day);
-        // the tile before the first tile
-        prevTile.advanceTime(-2 * Day);
-        // to make sure that an image outside the dataset is not searched for both
-        // ends of the dataset are calculated
-        secondToLast.advanceTime(-2 * Day);
-        secondToFirst.advanceTime(32 * Day);
-
-        // since months vary in length the time is set to the first of each month
-        auto setToFirstOfMonth = [](Time& t) {
-            std::string timeString = std::string(t.ISO8601());
-            timeString[8] = '0';
-            timeString[9] = '1';
-            t.setTime(timeString);
-        };
-
-        setToFirstOfMonth(nextTile);
-        setToFirstOfMonth(nextNextTile);
-        setToFirstOfMonth(prevTile);
-        setToFirstOfMonth(secondToLast);
-        setToFirstOfMonth(secondToFirst);
-    }
-
-    // the necessary tile providers are loaded if they exist within the timespan
-    if (secondToLast.j2000Seconds() > time.j2000Seconds() &&
-        secondToFirst.j2000Seconds() < time.j2000Seconds())
-    {
-        _interpolateTileProvider->t2 = retrieveTileProvider(nextTile);
-        _interpolateTileProvider->future = retrieveTileProvider(nextNextTile);
-        _interpolateTileProvider->before = retrieveTileProvider(prevTile);
-    }
-    else if (secondToLast.j2000Seconds() < time.j2000Seconds() &&
-        _prototyped.endTimeJ2000 > time.j2000Seconds())
-    {
-        _interpolateTileProvider->t2 = retrieveTileProvider(nextTile);
-        _interpolateTileProvider->future = retrieveTileProvider(tCopy);
-        _interpolateTileProvider->before = retrieveTileProvider(prevTile);
-    }
-    else if (secondToFirst.j2000Seconds() > time.j2000Seconds() &&
-        _prototyped.startTimeJ2000 < time.j2000Seconds())
-    {
-        _interpolateTileProvider->t2 = retrieveTileProvider(nextTile);
-        _interpolateTileProvider->future = retrieveTileProvider(nextNextTile);
-        _interpolateTileProvider->before = retrieveTileProvider(tCopy);
-    }
-    else {
-        _interpolateTileProvider->t2 = retrieveTileProvider(tCopy);
-        _interpolateTileProvider->future = retrieveTileProvider(tCopy);
-        _interpolateTileProvider->before = retrieveTileProvider(tCopy);
-    }
-    _interpolateTileProvider->factor = static_cast<float>(
-        (time.j2000Seconds() - tCopy.j2000Seconds()) /
-        (nextTile.j2000Seconds() - tCopy.j2000Seconds())
-    );
+    const TimeQuantizer& quantizer = _prototyped.timeQuantizer;
+    const int last = quantizer.nTimesteps() - 1;
+    const int curr = quantizer.timestep(time.j2000Seconds());
+    const int next = std::min(curr + 1, last);
+
+    _interpolateTileProvider->t1 = retrieveTileProvider(curr);
+    _interpolateTileProvider->t2 = retrieveTileProvider(next);
+    _interpolateTileProvider->future = retrieveTileProvider(std::min(curr + 2, last));
+    _interpolateTileProvider->before = retrieveTileProvider(std::max(curr - 1, 0));
+
+    const double currTime = quantizer.timestepJ2000(curr);
+    const double nextTime = quantizer.timestepJ2000(next);
+    const float factor = next != curr ?
+        static_cast<float>((time.j2000Seconds() - currTime) / (nextTime - currTime)) :
+        1.f;
+    _interpolateTileProvider->factor = std::clamp(factor, 0.f, 1.f);
 
-    if (_interpolateTileProvider->factor > 1.f) {
-        _interpolateTileProvider->factor = 1.f;
-    }
     return _interpolateTileProvider.get();
 }
 
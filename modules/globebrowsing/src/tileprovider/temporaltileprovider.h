@@ -29,6 +29,8 @@
 
 #include <modules/globebrowsing/src/tileprovider/defaulttileprovider.h>
 #include <modules/globebrowsing/src/tileprovider/singleimagetileprovider.h>
+#include <unordered_set>
+#include <vector>
 
 namespace openspace::globebrowsing {
 
@@ -49,6 +51,7 @@ public:
 
     Tile tile(const TileIndex& tileIndex) override final;
     Tile::Status tileStatus(const TileIndex& index) override final;
+    bool prefetch(const TileIndex& tileIndex) override final;
     TileDepthTransform depthTransform() override final;
     void update() override final;
     void reset() override final;
@@ -90,7 +93,34 @@ private:
     };
 
     DefaultTileProvider createTileProvider(std::string_view timekey) const;
-    DefaultTileProvider* retrieveTileProvider(const Time& t);
+    DefaultTileProvider* retrieveTileProvider(int timestep);
+
+    /**
+     * Returns the timestep that contains the time \p j2000, which is the latest timestep
+     * that does not start after that time, clamped to the timesteps of the dataset.
+     */
+    int timestep(double j2000) const;
+
+    /**
+     * Returns the number of timesteps of the dataset. The timesteps are identified by
+     * their index, which is the index of the file in the `Folder` mode and the index into
+     * the compiled TimeQuantizer table in the `Prototype` mode.
+     */
+    int nTimesteps() const;
+
+    /**
+     * Creates the tile providers for the timesteps that follow the current one in the
+     * direction that time is moving and starts loading the tiles that have been
+     * requested from the current tile provider in the previous frame.
+     */
+    void updateLookAhead();
+
+    /**
+     * Removes the least recently used tile providers until there are no more than the
+     * budget left, skipping the ones that are currently in use or looked ahead to.
+     */
+    void retireTileProviders();
+    bool isInUse(int timestep, const DefaultTileProvider& tileProvider) const;
 
     template <Mode mode, bool interpolation>
     TileProvider* tileProvider(const Time& time);
@@ -100,10 +130,6 @@ private:
     Mode _mode;
 
     struct {
-        double startTimeJ2000 = 0.0;
-        double endTimeJ2000 = 0.0;
-
-        std::string temporalResolution;
         std::string timeFormat;
         TimeQuantizer timeQuantizer;
         std::string prototype;
@@ -119,10 +145,26 @@ private:
     ghoul::Dictionary _initDict;
     properties::BoolProperty _useFixedTime;
     properties::StringProperty _fixedTime;
+    properties::IntProperty _lookAheadSteps;
+    properties::IntProperty _tileProviderBudget;
     bool _fixedTimeDirty = true;
 
     TileProvider* _currentTileProvider = nullptr;
-    std::unordered_map<double, DefaultTileProvider> _tileProviderMap;
+    std::unordered_map<int, DefaultTileProvider> _tileProviderMap;
+    // The value of `_nUpdates` when a tile provider was last retrieved
+    std::unordered_map<int, uint64_t> _tileProviderLastUse;
+    uint64_t _nUpdates = 0;
+
+    // The tiles that have been requested from the current tile provider since the last
+    // update, which are the ones that are loaded ahead of time for upcoming timesteps
+    std::vector<TileIndex> _requestedTiles;
+    std::unordered_set<TileIndex::TileHashKey> _requestedTileKeys;
+
+    // The timesteps that are looked ahead to, which are recomputed whenever the current
+    // timestep or the direction of time changes
+    std::vector<int> _lookAheadTimesteps;
+    int _lookAheadBase = -1;
+    int _lookAheadDirection = 0;
 
     bool _isInterpolating = false;
 
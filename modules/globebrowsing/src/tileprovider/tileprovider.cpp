@@ -192,6 +192,10 @@ ChunkTile TileProvider::traverseTree(TileIndex tileIndex, int parents, int maxPa
     return ChunkTile{ Tile(), uvTransform, TileDepthTransform() };
 }
 
+bool TileProvider::prefetch(const TileIndex&) {
+    return false;
+}
+
 void TileProvider::internalInitialize() {}
 void TileProvider::internalDeinitialize() {}
 
@@ -95,6 +95,15 @@ struct TileProvider : public properties::PropertyOwner {
      */
     virtual Tile::Status tileStatus(const TileIndex& index) = 0;
 
+    /**
+     * Hints that the `Tile` for the \p tileIndex is likely to be requested soon. Tile
+     * providers that load their data asynchronously can use this to start loading the
+     * tile with a low priority. The default implementation does nothing.
+     *
+     * \return `true` if the tile is now being loaded because of this call
+     */
+    virtual bool prefetch(const TileIndex& tileIndex);
+
     /**
      * Get the associated depth transform for this TileProvider. This is necessary for
      * TileProviders serving height map data, in order to correcly map pixel values to
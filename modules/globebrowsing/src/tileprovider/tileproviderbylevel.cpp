@@ -126,6 +126,11 @@ Tile::Status TileProviderByLevel::tileStatus(const TileIndex& index) {
     return provider ? provider->tileStatus(index) : Tile::Status::Unavailable;
 }
 
+bool TileProviderByLevel::prefetch(const TileIndex& tileIndex) {
+    TileProvider* provider = levelProvider(tileIndex.level);
+    return provider ? provider->prefetch(tileIndex) : false;
+}
+
 TileProvider* TileProviderByLevel::levelProvider(int level) const {
     ZoneScoped;
 
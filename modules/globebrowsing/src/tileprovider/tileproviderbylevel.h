@@ -35,6 +35,7 @@ public:
 
     Tile tile(const TileIndex& tileIndex) override final;
     Tile::Status tileStatus(const TileIndex& index) override final;
+    bool prefetch(const TileIndex& tileIndex) override final;
     TileDepthTransform depthTransform() override final;
     void update() override final;
     void reset() override final;
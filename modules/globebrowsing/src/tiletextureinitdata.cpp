@@ -72,10 +72,32 @@ unsigned int uniqueIdForTextureFormat(ghoul::opengl::Texture::Format textureForm
     }
 }
 
+using Compression = openspace::globebrowsing::TileTextureInitData::Compression;
+
+size_t textureNumberOfBytes(size_t width, size_t height, size_t totalNumBytes,
+                            Compression compression)
+{
+    using namespace openspace::globebrowsing;
+
+    if (compression == Compression::None) {
+        return totalNumBytes;
+    }
+
+    const int w = static_cast<int>(width);
+    const int h = static_cast<int>(height);
+    const int nLevels = nCompressedMipLevels(w, h);
+    size_t res = 0;
+    for (int level = 0; level < nLevels; level++) {
+        res += compressedLevelSize(compression, w >> level, h >> level);
+    }
+    return res;
+}
+
 openspace::globebrowsing::TileTextureInitData::HashKey calculateHashKey(
                                                              const glm::ivec3& dimensions,
                                              const ghoul::opengl::Texture::Format& format,
-                                                                     const GLenum& glType)
+                                                                     const GLenum& glType,
+                                                                  Compression compression)
 {
     ghoul_assert(dimensions.x > 0, "Incorrect dimension");
     ghoul_assert(dimensions.y > 0, "Incorrect dimension");
@@ -91,6 +113,7 @@ openspace::globebrowsing::TileTextureInitData::HashKey calculateHashKey(
     res |= dimensions.y << 10;
     res |= static_cast<std::underlying_type_t<GLenum>>(glType) << (10 + 16);
     res |= formatId << (10 + 16 + 4);
+    res |= static_cast<uint64_t>(compression) << 56;
 
     return res;
 }
@@ -156,7 +179,8 @@ TileTextureInitData tileTextureInitData(layers::Group::ID id,
 
 TileTextureInitData::TileTextureInitData(size_t width, size_t height, GLenum type,
                                          ghoul::opengl::Texture::Format textureFormat,
-                                         ShouldAllocateDataOnCPU allocCpu)
+                                         ShouldAllocateDataOnCPU allocCpu,
+                                         Compression textureCompression)
     : dimensions(width, height, 1)
     , glType(type)
     , ghoulTextureFormat(textureFormat)
@@ -166,8 +190,15 @@ TileTextureInitData::TileTextureInitData(size_t width, size_t height, GLenum typ
     , bytesPerLine(bytesPerPixel * width)
     , totalNumBytes(bytesPerLine * height)
     , shouldAllocateDataOnCPU(allocCpu)
-    , hashKey(calculateHashKey(dimensions, ghoulTextureFormat, glType))
-{}
+    , compression(textureCompression)
+    , textureNumBytes(textureNumberOfBytes(width, height, totalNumBytes, compression))
+    , hashKey(calculateHashKey(dimensions, ghoulTextureFormat, glType, compression))
+{
+    ghoul_assert(
+        compression == Compression::None || supportsCompression(*this, compression),
+        "Unsupported compression"
+    );
+}
 
 TileTextureInitData& TileTextureInitData::operator=(const TileTextureInitData& rhs) {
     if (this == &rhs) {
@@ -185,4 +216,41 @@ TileTextureInitData& TileTextureInitData::operator=(TileTextureInitData&& rhs) n
     return *this;
 }
 
+bool supportsCompression(const TileTextureInitData& initData,
+                         TileTextureInitData::Compression compression)
+{
+    if (compression == TileTextureInitData::Compression::None) {
+        return true;
+    }
+
+    using Format = ghoul::opengl::Texture::Format;
+    const Format format = initData.ghoulTextureFormat;
+    const bool isColor = format == Format::RGB || format == Format::BGR ||
+                         format == Format::RGBA || format == Format::BGRA;
+    return isColor && initData.glType == GL_UNSIGNED_BYTE &&
+           initData.dimensions.x % 4 == 0 && initData.dimensions.y % 4 == 0;
+}
+
+int nCompressedMipLevels(int width, int height) {
+    int res = 0;
+    while (width >= 4 && height >= 4 && width % 4 == 0 && height % 4 == 0) {
+        res++;
+        width /= 2;
+        height /= 2;
+    }
+    return res;
+}
+
+size_t compressedLevelSize(TileTextureInitData::Compression compression, int width,
+                           int height)
+{
+    const size_t nBlocks =
+        static_cast<size_t>(width / 4) * static_cast<size_t>(height / 4);
+    switch (compression) {
+        case TileTextureInitData::Compression::BC1: return nBlocks * 8;
+        case TileTextureInitData::Compression::BC7: return nBlocks * 16;
+        default:                                    throw ghoul::MissingCaseException();
+    }
+}
+
 } // namespace openspace::globebrowsing
@@ -41,9 +41,22 @@ public:
     using HashKey = uint64_t;
     BooleanType(ShouldAllocateDataOnCPU);
 
+    /**
+     * The block compression format in which the texture is stored on the GPU. Compressed
+     * textures are only supported for 8-bit RGB(A) and BGR(A) data whose dimensions are
+     * multiples of 4. Their pixel data contains the compressed mipmap chain down to a
+     * size of 4x4 pixels, as mipmaps cannot be generated for them on the GPU.
+     */
+    enum class Compression {
+        None = 0,
+        BC1,
+        BC7
+    };
+
     TileTextureInitData(size_t width, size_t height, GLenum type,
         ghoul::opengl::Texture::Format textureFormat,
-        ShouldAllocateDataOnCPU allocCpu = ShouldAllocateDataOnCPU::No);
+        ShouldAllocateDataOnCPU allocCpu = ShouldAllocateDataOnCPU::No,
+        Compression compression = Compression::None);
 
     TileTextureInitData(const TileTextureInitData& original) = default;
     TileTextureInitData(TileTextureInitData&& original) = default;
@@ -62,9 +75,34 @@ public:
     const size_t bytesPerLine;
     const size_t totalNumBytes;
     const bool shouldAllocateDataOnCPU;
+    const Compression compression;
+    /// The number of bytes that are uploaded to the texture of a tile. For compressed
+    /// textures, this is the size of the compressed mipmap chain, otherwise it is equal
+    /// to `totalNumBytes`
+    const size_t textureNumBytes;
     const HashKey hashKey;
 };
 
+/**
+ * Returns whether textures described by \p initData can be stored with the provided
+ * \p compression.
+ */
+bool supportsCompression(const TileTextureInitData& initData,
+    TileTextureInitData::Compression compression);
+
+/**
+ * Returns the number of mipmap levels that are stored for a compressed texture of the
+ * provided size, which are all levels that are at least 4 pixels wide and high.
+ */
+int nCompressedMipLevels(int width, int height);
+
+/**
+ * Returns the number of bytes that a single mipmap level with the provided \p width and
+ * \p height occupies with the \p compression.
+ */
+size_t compressedLevelSize(TileTextureInitData::Compression compression, int width,
+    int height);
+
 TileTextureInitData tileTextureInitData(layers::Group::ID id,
     size_t preferredTileSize = 0);
 
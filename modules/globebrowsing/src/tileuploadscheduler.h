@@ -0,0 +1,119 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILE_UPLOAD_SCHEDULER___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILE_UPLOAD_SCHEDULER___H__
+
+#include <modules/globebrowsing/src/rawtile.h>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace openspace::globebrowsing::cache {
+
+/**
+ * Decides which of the tiles that have finished loading are uploaded to the GPU in the
+ * current frame. Without a limit, a burst of finished tiles would be uploaded within a
+ * single frame and cause a visible hitch. Instead, the tiles are uploaded within a per
+ * frame budget of bytes and/or time and the remaining tiles are carried over to the
+ * following frames.
+ *
+ * The tiles are uploaded in the order of their contribution to the screen-space error.
+ * Tiles that have been requested for rendering in the current or the previous frame are
+ * uploaded first, since the chunks that use them are currently drawn with a coarser
+ * tile. Among those, tiles on lower levels are uploaded first, since the chunks
+ * requesting them otherwise fall back to even coarser tiles. Tiles with the same
+ * priority are uploaded in the order in which they were enqueued.
+ *
+ * The scheduler does not perform the upload itself, but calls a function for every tile
+ * that should be uploaded. This makes it possible to use it without an OpenGL context.
+ */
+template<typename KeyType, typename HasherType>
+class TileUploadScheduler {
+public:
+    struct Budget {
+        /// The maximum number of bytes that are uploaded per frame. 0 is unlimited
+        size_t nBytes = 0;
+
+        /// The maximum time in milliseconds spent uploading per frame. 0 is unlimited
+        double milliseconds = 0.0;
+    };
+
+    using UploadFunction = std::function<void(KeyType, RawTile)>;
+
+    /**
+     * Adds the \p rawTile to the list of tiles that wait to be uploaded. If a tile with
+     * the same \p key is already waiting, it is replaced. Tiles that failed to load are
+     * discarded.
+     */
+    void enqueue(KeyType key, RawTile rawTile);
+
+    /**
+     * Marks the tile with the provided \p key as being needed for rendering, which moves
+     * it in front of the tiles that are not currently needed.
+     *
+     * \return `true` if the tile is waiting to be uploaded, `false` otherwise
+     */
+    bool touch(const KeyType& key);
+
+    bool isPending(const KeyType& key) const;
+
+    /**
+     * Calls the \p upload function for the tiles with the highest priority until the
+     * \p budget is used up. At least one tile is uploaded per call, even if that tile
+     * is larger than the budget, to ensure that all tiles are uploaded eventually. This
+     * function should be called once per frame.
+     *
+     * \return The number of tiles that were uploaded
+     */
+    size_t process(const Budget& budget, const UploadFunction& upload);
+
+    void clear();
+
+    /// \return The number of tiles that are waiting to be uploaded
+    size_t nPending() const;
+
+    /// \return The number of bytes of all tiles that are waiting to be uploaded
+    size_t nPendingBytes() const;
+
+private:
+    struct Entry {
+        RawTile rawTile;
+        uint64_t enqueueOrder = 0;
+        uint64_t lastTouchedFrame = 0;
+    };
+
+    std::unordered_map<KeyType, Entry, HasherType> _pending;
+    size_t _nPendingBytes = 0;
+    uint64_t _nEnqueued = 0;
+    // Starts at 1, as a frame of 0 denotes that a tile was never touched
+    uint64_t _frame = 1;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#include "tileuploadscheduler.inl"
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILE_UPLOAD_SCHEDULER___H__
@@ -0,0 +1,165 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace openspace::globebrowsing::cache {
+
+template<typename KeyType, typename HasherType>
+void TileUploadScheduler<KeyType, HasherType>::enqueue(KeyType key, RawTile rawTile) {
+    if (rawTile.error != RawTile::ReadError::None) {
+        return;
+    }
+
+    const size_t nBytes = rawTile.textureInitData->textureNumBytes;
+    const auto it = _pending.find(key);
+    if (it != _pending.end()) {
+        _nPendingBytes -= it->second.rawTile.textureInitData->textureNumBytes;
+        // Assigning a TileTextureInitData does not change it, so the init data of the
+        // replaced tile has to be removed before the new tile can take its place
+        it->second.rawTile.textureInitData.reset();
+        it->second.rawTile = std::move(rawTile);
+        it->second.enqueueOrder = _nEnqueued;
+    }
+    else {
+        _pending.emplace(
+            std::move(key),
+            Entry{ .rawTile = std::move(rawTile), .enqueueOrder = _nEnqueued }
+        );
+    }
+    _nPendingBytes += nBytes;
+    _nEnqueued++;
+}
+
+template<typename KeyType, typename HasherType>
+bool TileUploadScheduler<KeyType, HasherType>::touch(const KeyType& key) {
+    const auto it = _pending.find(key);
+    if (it == _pending.end()) {
+        return false;
+    }
+    it->second.lastTouchedFrame = _frame;
+    return true;
+}
+
+template<typename KeyType, typename HasherType>
+bool TileUploadScheduler<KeyType, HasherType>::isPending(const KeyType& key) const {
+    return _pending.contains(key);
+}
+
+template<typename KeyType, typename HasherType>
+size_t TileUploadScheduler<KeyType, HasherType>::process(const Budget& budget,
+                                                         const UploadFunction& upload)
+{
+    ZoneScoped;
+
+    // Tiles can be touched before or after this function is called within a frame, so
+    // the tiles touched in the previous frame are still considered to be needed
+    const uint64_t frame = _frame;
+    _frame++;
+
+    if (_pending.empty()) {
+        return 0;
+    }
+
+    struct Candidate {
+        bool isNeeded;
+        uint8_t level;
+        uint64_t enqueueOrder;
+        KeyType key;
+    };
+    std::vector<Candidate> candidates;
+    candidates.reserve(_pending.size());
+    for (const auto& [key, entry] : _pending) {
+        candidates.push_back({
+            .isNeeded =
+                entry.lastTouchedFrame > 0 && entry.lastTouchedFrame + 1 >= frame,
+            .level = entry.rawTile.tileIndex.level,
+            .enqueueOrder = entry.enqueueOrder,
+            .key = key
+        });
+    }
+    std::sort(
+        candidates.begin(),
+        candidates.end(),
+        [](const Candidate& lhs, const Candidate& rhs) {
+            if (lhs.isNeeded != rhs.isNeeded) {
+                return lhs.isNeeded;
+            }
+            if (lhs.level != rhs.level) {
+                return lhs.level < rhs.level;
+            }
+            return lhs.enqueueOrder < rhs.enqueueOrder;
+        }
+    );
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    size_t nUploaded = 0;
+    size_t nUploadedBytes = 0;
+    for (Candidate& candidate : candidates) {
+        const auto it = _pending.find(candidate.key);
+        const size_t nBytes = it->second.rawTile.textureInitData->textureNumBytes;
+        if (nUploaded > 0) {
+            if (budget.nBytes > 0 && nUploadedBytes + nBytes > budget.nBytes) {
+                break;
+            }
+            const std::chrono::duration<double, std::milli> elapsed =
+                Clock::now() - start;
+            if (budget.milliseconds > 0.0 && elapsed.count() >= budget.milliseconds) {
+                break;
+            }
+        }
+
+        RawTile rawTile = std::move(it->second.rawTile);
+        _pending.erase(it);
+        _nPendingBytes -= nBytes;
+
+        upload(std::move(candidate.key), std::move(rawTile));
+        nUploaded++;
+        nUploadedBytes += nBytes;
+    }
+    return nUploaded;
+}
+
+template<typename KeyType, typename HasherType>
+void TileUploadScheduler<KeyType, HasherType>::clear() {
+    _pending.clear();
+    _nPendingBytes = 0;
+}
+
+template<typename KeyType, typename HasherType>
+size_t TileUploadScheduler<KeyType, HasherType>::nPending() const {
+    return _pending.size();
+}
+
+template<typename KeyType, typename HasherType>
+size_t TileUploadScheduler<KeyType, HasherType>::nPendingBytes() const {
+    return _nPendingBytes;
+}
+
+} // namespace openspace::globebrowsing::cache
@@ -363,11 +363,13 @@ void TimeQuantizer::setStartEndRange(const std::string& start, const std::string
 
     _timerange.setStart(start);
     _timerange.setEnd(end);
+    _timesteps.clear();
 }
 
 void TimeQuantizer::setResolution(const std::string& resolutionString) {
     _resolution = parseTimeResolutionStr(resolutionString);
     verifyStartTimeRestrictions();
+    _timesteps.clear();
 }
 
 void TimeQuantizer::verifyStartTimeRestrictions() {
@@ -649,4 +651,72 @@ std::vector<std::string> TimeQuantizer::quantized(Time& start, Time& end) {
     return result;
 }
 
+void TimeQuantizer::compile() {
+    ZoneScoped;
+
+    _timesteps.clear();
+
+    const int value = static_cast<int>(_resolutionValue);
+    DateTime quantized = _start;
+
+    // Leap seconds are only ever inserted at the end of a day, so the times within a day
+    // are offset from its midnight and SPICE only has to convert one time per day
+    DateTime midnight;
+    double midnightJ2000 = 0.0;
+    bool hasMidnight = false;
+    while (true) {
+        const bool isSameDay = hasMidnight && quantized.year() == midnight.year() &&
+            quantized.month() == midnight.month() && quantized.day() == midnight.day();
+        if (!isSameDay) {
+            midnight = quantized;
+            midnight.setHour(0);
+            midnight.setMinute(0);
+            midnight.setSecond(0);
+            midnightJ2000 = midnight.J2000();
+            hasMidnight = true;
+        }
+
+        const double t = midnightJ2000 + quantized.hour() * 3600.0 +
+            quantized.minute() * 60.0 + quantized.second();
+        if (!_timerange.includes(Time(t))) {
+            break;
+        }
+        _timesteps.push_back(t);
+        quantized.incrementOnce(value, _resolutionUnit);
+    }
+}
+
+int TimeQuantizer::nTimesteps() const {
+    return static_cast<int>(_timesteps.size());
+}
+
+int TimeQuantizer::timestep(double j2000) const {
+    ghoul_assert(!_timesteps.empty(), "TimeQuantizer has not been compiled");
+
+    const auto it = std::upper_bound(_timesteps.cbegin(), _timesteps.cend(), j2000);
+    if (it == _timesteps.cbegin()) {
+        return 0;
+    }
+    return static_cast<int>(std::distance(_timesteps.cbegin(), it)) - 1;
+}
+
+double TimeQuantizer::timestepJ2000(int timestep) const {
+    ghoul_assert(timestep >= 0 && timestep < nTimesteps(), "Timestep out of range");
+
+    return _timesteps[timestep];
+}
+
+std::string TimeQuantizer::timestepISO8601(int timestep) const {
+    ghoul_assert(timestep >= 0 && timestep < nTimesteps(), "Timestep out of range");
+
+    // This walks the calendar in the same way as the table was created, which is cheap
+    // compared to the loading of the data that the string is used for
+    const int value = static_cast<int>(_resolutionValue);
+    DateTime quantized = _start;
+    for (int i = 0; i < timestep; i++) {
+        quantized.incrementOnce(value, _resolutionUnit);
+    }
+    return quantized.ISO8601();
+}
+
 } // namespace openspace::globebrowsing
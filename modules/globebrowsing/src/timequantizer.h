@@ -359,6 +359,57 @@ public:
      */
     std::vector<std::string> quantized(Time& start, Time& end);
 
+    /**
+     * Precomputes the J2000 seconds of all quantized times within the time range, which
+     * is required for using #timestep, #timestepJ2000, and #timestepISO8601. This has to
+     * be called again whenever the time range or the resolution is changed.
+     */
+    void compile();
+
+    /**
+     * Returns the number of quantized times within the time range, or 0 if #compile has
+     * not been called.
+     *
+     * \return The number of timesteps in the compiled table
+     */
+    int nTimesteps() const;
+
+    /**
+     * Returns the index of the timestep that contains the time \p j2000, which is the
+     * latest quantized time that is not after \p j2000. Times outside of the time range
+     * are clamped to the first or the last timestep. Other than #quantize, this only
+     * performs a binary search in the table that was created by #compile.
+     *
+     * \param j2000 The time in J2000 seconds for which to find the timestep
+     * \return The index of the timestep containing \p j2000
+     *
+     * \pre #compile must have been called and the table must contain at least one
+     *      timestep
+     */
+    int timestep(double j2000) const;
+
+    /**
+     * Returns the quantized time of the timestep with the index \p timestep.
+     *
+     * \param timestep The index of the timestep
+     * \return The quantized time of the timestep in J2000 seconds
+     *
+     * \pre \p timestep must be smaller than #nTimesteps
+     */
+    double timestepJ2000(int timestep) const;
+
+    /**
+     * Returns the quantized time of the timestep with the index \p timestep as an ISO8601
+     * date/time string. As the string is created from the calendar date rather than from
+     * the J2000 seconds, it is exact and independent of any rounding.
+     *
+     * \param timestep The index of the timestep
+     * \return The ISO8601 date/time string (`YYYY-MM-DDTHH:mm:ss`) of the timestep
+     *
+     * \pre \p timestep must be smaller than #nTimesteps
+     */
+    std::string timestepISO8601(int timestep) const;
+
 private:
     void verifyStartTimeRestrictions();
     void verifyResolutionRestrictions(const int value, const char unit);
@@ -370,6 +421,7 @@ private:
     DateTime _dt;
     DateTime _start;
     RangedTime _timerange;
+    std::vector<double> _timesteps;
 };
 
 } // namespace openspace::globebrowsing
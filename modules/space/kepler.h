@@ -46,6 +46,8 @@ struct Parameters {
     double meanAnomaly = 0.0;
     double epoch = 0.0;
     double period = 0.0;
+
+    bool operator==(const Parameters&) const = default;
 };
 
 /**
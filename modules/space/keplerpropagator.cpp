@@ -0,0 +1,490 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/space/keplerpropagator.h>
+
+#include <openspace/util/taskscheduler.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/profiling.h>
+#include <glm/gtx/transform.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // The number of samples whose eccentric anomalies are solved together
+    constexpr size_t BlockSize = 256;
+
+    // Batches with fewer samples are not worth the overhead of scheduling them
+    constexpr size_t MinSamplesPerBatch = 16384;
+
+    // Newton's method stops once the correction in all lanes is below this value
+    constexpr double Tolerance = 1e-12;
+    constexpr int MaxIterations = 20;
+
+    constexpr double TwoPi = 6.28318530717958647692;
+    constexpr double TwoOverPi = 0.63661977236758134308;
+    // pi/2 split into three parts so that the range reduction is exact (Cody & Waite)
+    constexpr double PiOver2A = 1.57079625129699707031;
+    constexpr double PiOver2B = 7.54978941586159635336e-8;
+    constexpr double PiOver2C = 5.39030285815811905290e-15;
+
+    // The lane operations are provided for plain doubles and for the SIMD vector type of
+    // the build, so that the solver is only written once and the samples at the end of a
+    // block that do not fill a whole vector go through the same math
+    namespace lanes {
+        template <typename V> V splat(double v);
+        template <typename V> V load(const double* p);
+
+        template <> double splat<double>(double v) { return v; }
+        template <> double load<double>(const double* p) { return *p; }
+        void store(double* p, double v) { *p = v; }
+        double add(double a, double b) { return a + b; }
+        double sub(double a, double b) { return a - b; }
+        double mul(double a, double b) { return a * b; }
+        double div(double a, double b) { return a / b; }
+        double neg(double v) { return -v; }
+        double abs(double v) { return std::abs(v); }
+        double round(double v) { return std::nearbyint(v); }
+        bool lt(double a, double b) { return a < b; }
+        bool eq(double a, double b) { return a == b; }
+        bool either(bool a, bool b) { return a || b; }
+        double select(bool mask, double a, double b) { return mask ? a : b; }
+        bool any(bool mask) { return mask; }
+
+#if defined(__AVX__)
+        // Using AVX, a SIMD register holds 4 doubles
+        using Vector = __m256d;
+        constexpr size_t VectorWidth = 4;
+
+        template <> Vector splat<Vector>(double v) { return _mm256_set1_pd(v); }
+        template <> Vector load<Vector>(const double* p) { return _mm256_loadu_pd(p); }
+        void store(double* p, Vector v) { _mm256_storeu_pd(p, v); }
+        Vector add(Vector a, Vector b) { return _mm256_add_pd(a, b); }
+        Vector sub(Vector a, Vector b) { return _mm256_sub_pd(a, b); }
+        Vector mul(Vector a, Vector b) { return _mm256_mul_pd(a, b); }
+        Vector div(Vector a, Vector b) { return _mm256_div_pd(a, b); }
+        Vector neg(Vector v) { return _mm256_xor_pd(v, _mm256_set1_pd(-0.0)); }
+        Vector abs(Vector v) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v); }
+        Vector round(Vector v) {
+            return _mm256_round_pd(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        }
+        Vector lt(Vector a, Vector b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+        Vector eq(Vector a, Vector b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+        Vector either(Vector a, Vector b) { return _mm256_or_pd(a, b); }
+        Vector select(Vector mask, Vector a, Vector b) {
+            return _mm256_blendv_pd(b, a, mask);
+        }
+        bool any(Vector mask) { return _mm256_movemask_pd(mask) != 0; }
+#define OPENSPACE_HAS_SIMD_KEPLER
+#elif defined(__SSE2__) || defined(_M_X64)
+        // Using SSE2, which is available on all x86-64 processors, a register holds 2
+        // doubles
+        using Vector = __m128d;
+        constexpr size_t VectorWidth = 2;
+
+        template <> Vector splat<Vector>(double v) { return _mm_set1_pd(v); }
+        template <> Vector load<Vector>(const double* p) { return _mm_loadu_pd(p); }
+        void store(double* p, Vector v) { _mm_storeu_pd(p, v); }
+        Vector add(Vector a, Vector b) { return _mm_add_pd(a, b); }
+        Vector sub(Vector a, Vector b) { return _mm_sub_pd(a, b); }
+        Vector mul(Vector a, Vector b) { return _mm_mul_pd(a, b); }
+        Vector div(Vector a, Vector b) { return _mm_div_pd(a, b); }
+        Vector neg(Vector v) { return _mm_xor_pd(v, _mm_set1_pd(-0.0)); }
+        Vector abs(Vector v) { return _mm_andnot_pd(_mm_set1_pd(-0.0), v); }
+        Vector round(Vector v) {
+            // SSE2 has no rounding instruction. Adding and subtracting 1.5 * 2^52 rounds
+            // all values with a magnitude below 2^51 to the nearest integer
+            const Vector magic = _mm_set1_pd(6755399441055744.0);
+            return _mm_sub_pd(_mm_add_pd(v, magic), magic);
+        }
+        Vector lt(Vector a, Vector b) { return _mm_cmplt_pd(a, b); }
+        Vector eq(Vector a, Vector b) { return _mm_cmpeq_pd(a, b); }
+        Vector either(Vector a, Vector b) { return _mm_or_pd(a, b); }
+        Vector select(Vector mask, Vector a, Vector b) {
+            return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+        }
+        bool any(Vector mask) { return _mm_movemask_pd(mask) != 0; }
+#define OPENSPACE_HAS_SIMD_KEPLER
+#endif
+
+        /**
+         * Computes the sine and cosine of \p x, which has to be smaller than 2^51 in
+         * magnitude. The argument is reduced to [-pi/4, pi/4] and the two functions are
+         * approximated by the minimax polynomials of the Cephes library, which are
+         * accurate to about one unit in the last place.
+         */
+        template <typename V>
+        void sinCos(V x, V& s, V& c) {
+            const V q = round(mul(x, splat<V>(TwoOverPi)));
+            V r = sub(x, mul(q, splat<V>(PiOver2A)));
+            r = sub(r, mul(q, splat<V>(PiOver2B)));
+            r = sub(r, mul(q, splat<V>(PiOver2C)));
+            const V z = mul(r, r);
+
+            V ps = splat<V>(1.58962301576546568060e-10);
+            ps = add(mul(ps, z), splat<V>(-2.50507477628578072866e-8));
+            ps = add(mul(ps, z), splat<V>(2.75573136213857245213e-6));
+            ps = add(mul(ps, z), splat<V>(-1.98412698295895385996e-4));
+            ps = add(mul(ps, z), splat<V>(8.33333333332211858878e-3));
+            ps = add(mul(ps, z), splat<V>(-1.66666666666666307295e-1));
+            const V sinR = add(r, mul(mul(r, z), ps));
+
+            V pc = splat<V>(-1.13585365213876817300e-11);
+            pc = add(mul(pc, z), splat<V>(2.08757008419747316778e-9));
+            pc = add(mul(pc, z), splat<V>(-2.75573141792967388112e-7));
+            pc = add(mul(pc, z), splat<V>(2.48015872888517045348e-5));
+            pc = add(mul(pc, z), splat<V>(-1.38888888888730564116e-3));
+            pc = add(mul(pc, z), splat<V>(4.16666666666665929218e-2));
+            const V cosR = add(
+                sub(splat<V>(1.0), mul(splat<V>(0.5), z)),
+                mul(mul(z, z), pc)
+            );
+
+            // The quadrant in {-2, -1, 0, 1, 2} determines which of the two values is
+            // used for each function and whether it is negated
+            const V quadrant = sub(
+                q,
+                mul(splat<V>(4.0), round(mul(q, splat<V>(0.25))))
+            );
+            const V absQuadrant = abs(quadrant);
+            const auto isOdd = eq(absQuadrant, splat<V>(1.0));
+            const auto isHalfTurn = eq(absQuadrant, splat<V>(2.0));
+            const V sinBase = select(isOdd, cosR, sinR);
+            const V cosBase = select(isOdd, sinR, cosR);
+            s = select(
+                either(isHalfTurn, eq(quadrant, splat<V>(-1.0))),
+                neg(sinBase),
+                sinBase
+            );
+            c = select(
+                either(isHalfTurn, eq(quadrant, splat<V>(1.0))),
+                neg(cosBase),
+                cosBase
+            );
+        }
+
+        /**
+         * Solves Kepler's equation with Newton's method for as many samples as fit into
+         * one V. All lanes iterate until the slowest one has converged.
+         */
+        template <typename V>
+        void solve(const double* meanAnomaly, const double* eccentricity, double* sinE,
+                   double* cosE)
+        {
+            const V e = load<V>(eccentricity);
+
+            // Reduce the mean anomaly to [-pi, pi]
+            V m = load<V>(meanAnomaly);
+            m = sub(m, mul(splat<V>(TwoPi), round(mul(m, splat<V>(1.0 / TwoPi)))));
+
+            // The starting value M + 0.85 e sign(sin M) (Danby 1987) converges for all
+            // eccentricities in [0, 1)
+            V s;
+            V c;
+            sinCos(m, s, c);
+            const V sign = select(lt(s, splat<V>(0.0)), splat<V>(-1.0), splat<V>(1.0));
+            V ea = add(m, mul(mul(splat<V>(0.85), e), sign));
+
+            for (int i = 0; i < MaxIterations; i++) {
+                sinCos(ea, s, c);
+                const V f = sub(sub(ea, mul(e, s)), m);
+                const V df = sub(splat<V>(1.0), mul(e, c));
+                const V delta = div(f, df);
+                ea = sub(ea, delta);
+                if (!any(lt(splat<V>(Tolerance), abs(delta)))) {
+                    break;
+                }
+            }
+
+            sinCos(ea, s, c);
+            store(sinE, s);
+            store(cosE, c);
+        }
+    } // namespace lanes
+
+    /**
+     * Calls \p function with consecutive ranges [begin, end) that together cover
+     * [0, \p nSamples), distributed over the workers of the \p scheduler if one is
+     * provided.
+     */
+    template <typename Func>
+    void runBatches(size_t nSamples, openspace::TaskScheduler* scheduler,
+                    const Func& function)
+    {
+        if (scheduler) {
+            scheduler->parallelFor(nSamples, MinSamplesPerBatch, function);
+        }
+        else {
+            function(size_t(0), nSamples);
+        }
+    }
+} // namespace
+
+namespace openspace::kepler {
+
+void solveEccentricAnomaly(std::span<const double> meanAnomaly,
+                           std::span<const double> eccentricity, std::span<double> sinE,
+                           std::span<double> cosE)
+{
+    ghoul_assert(
+        meanAnomaly.size() == eccentricity.size() &&
+        meanAnomaly.size() == sinE.size() && meanAnomaly.size() == cosE.size(),
+        "All spans must have the same size"
+    );
+
+    const size_t n = meanAnomaly.size();
+    size_t i = 0;
+#ifdef OPENSPACE_HAS_SIMD_KEPLER
+    for (; i + lanes::VectorWidth <= n; i += lanes::VectorWidth) {
+        lanes::solve<lanes::Vector>(
+            meanAnomaly.data() + i,
+            eccentricity.data() + i,
+            sinE.data() + i,
+            cosE.data() + i
+        );
+    }
+#endif // OPENSPACE_HAS_SIMD_KEPLER
+
+    for (; i < n; i++) {
+        lanes::solve<double>(
+            meanAnomaly.data() + i,
+            eccentricity.data() + i,
+            sinE.data() + i,
+            cosE.data() + i
+        );
+    }
+}
+
+Propagator::Propagator(std::span<const Parameters> parameters) {
+    setParameters(parameters);
+}
+
+void Propagator::setParameters(std::span<const Parameters> parameters) {
+    const size_t n = parameters.size();
+    _eccentricity.resize(n);
+    _semiMajorAxis.resize(n);
+    _semiMinorAxis.resize(n);
+    _meanAnomalyAtEpoch.resize(n);
+    _meanMotion.resize(n);
+    _epoch.resize(n);
+    _px.resize(n);
+    _py.resize(n);
+    _pz.resize(n);
+    _qx.resize(n);
+    _qy.resize(n);
+    _qz.resize(n);
+
+    for (size_t i = 0; i < n; i++) {
+        setParameters(i, parameters[i]);
+    }
+}
+
+void Propagator::setParameters(size_t object, const Parameters& parameters) {
+    ghoul_assert(object < size(), "Object index out of range");
+
+    const double e = parameters.eccentricity;
+    if (!(e >= 0.0 && e < 1.0)) {
+        throw ghoul::RuntimeError(
+            std::format(
+                "Eccentricity {} of object '{}' is not in [0, 1)", e, parameters.name
+            ),
+            "Kepler"
+        );
+    }
+
+    const double a = parameters.semiMajorAxis * 1000.0;
+    _eccentricity[object] = e;
+    _semiMajorAxis[object] = a;
+    _semiMinorAxis[object] = a * std::sqrt(1.0 - e * e);
+    _meanAnomalyAtEpoch[object] = glm::radians(parameters.meanAnomaly);
+    _meanMotion[object] = glm::two_pi<double>() / parameters.period;
+    _epoch[object] = parameters.epoch;
+
+    // The same rotations as in the KeplerTranslation: place the ascending node, tilt the
+    // orbit by the inclination, then rotate the periapsis into place
+    const glm::dmat4 rotation =
+        glm::rotate(glm::radians(parameters.ascendingNode), glm::dvec3(0.0, 0.0, 1.0)) *
+        glm::rotate(glm::radians(parameters.inclination), glm::dvec3(1.0, 0.0, 0.0)) *
+        glm::rotate(
+            glm::radians(parameters.argumentOfPeriapsis),
+            glm::dvec3(0.0, 0.0, 1.0)
+        );
+    _px[object] = rotation[0].x;
+    _py[object] = rotation[0].y;
+    _pz[object] = rotation[0].z;
+    _qx[object] = rotation[1].x;
+    _qy[object] = rotation[1].y;
+    _qz[object] = rotation[1].z;
+}
+
+size_t Propagator::size() const {
+    return _eccentricity.size();
+}
+
+void Propagator::propagate(std::span<const SampleRange> ranges,
+                           std::span<glm::vec3> positions, TaskScheduler* scheduler) const
+{
+    ZoneScoped;
+
+    // The index of the first position of each range in the positions
+    std::vector<size_t> offsets(ranges.size() + 1, 0);
+    for (size_t i = 0; i < ranges.size(); i++) {
+        ghoul_assert(ranges[i].object < size(), "Object index out of range");
+        offsets[i + 1] = offsets[i] + ranges[i].nSamples;
+    }
+    ghoul_assert(positions.size() == offsets.back(), "Need one position per sample");
+
+    auto propagateSamples = [&](size_t begin, size_t end) {
+        // The last range that starts at or before the first sample of this batch is the
+        // one that contains it, as empty ranges start at the same sample as the next
+        size_t range = static_cast<size_t>(
+            std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin() - 1
+        );
+        uint32_t j = static_cast<uint32_t>(begin - offsets[range]);
+
+        std::array<uint32_t, BlockSize> objects;
+        std::array<double, BlockSize> times;
+        size_t sample = begin;
+        while (sample < end) {
+            const size_t blockBegin = sample;
+            size_t n = 0;
+            while (n < BlockSize && sample < end) {
+                while (j >= ranges[range].nSamples) {
+                    range++;
+                    j = 0;
+                }
+                const SampleRange& r = ranges[range];
+                objects[n] = r.object;
+                times[n] = r.start + static_cast<double>(j) * r.step;
+                n++;
+                j++;
+                sample++;
+            }
+            propagateBlock(
+                std::span(objects.data(), n),
+                std::span(times.data(), n),
+                positions.data() + blockBegin
+            );
+        }
+    };
+    runBatches(offsets.back(), scheduler, propagateSamples);
+}
+
+void Propagator::propagate(double time, std::span<glm::vec3> positions,
+                           TaskScheduler* scheduler) const
+{
+    ZoneScoped;
+    ghoul_assert(positions.size() == size(), "Need one position per object");
+
+    auto propagateObjects = [&](size_t begin, size_t end) {
+        std::array<uint32_t, BlockSize> objects;
+        std::array<double, BlockSize> times;
+        times.fill(time);
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += BlockSize) {
+            const size_t n = std::min(BlockSize, end - blockBegin);
+            for (size_t i = 0; i < n; i++) {
+                objects[i] = static_cast<uint32_t>(blockBegin + i);
+            }
+            propagateBlock(
+                std::span(objects.data(), n),
+                std::span(times.data(), n),
+                positions.data() + blockBegin
+            );
+        }
+    };
+    runBatches(size(), scheduler, propagateObjects);
+}
+
+glm::dvec3 Propagator::position(size_t object, double time) const {
+    ghoul_assert(object < size(), "Object index out of range");
+
+    const double meanAnomaly =
+        _meanAnomalyAtEpoch[object] + (time - _epoch[object]) * _meanMotion[object];
+    double sinE = 0.0;
+    double cosE = 0.0;
+    solveEccentricAnomaly(
+        std::span(&meanAnomaly, 1),
+        std::span(&_eccentricity[object], 1),
+        std::span(&sinE, 1),
+        std::span(&cosE, 1)
+    );
+
+    const double x = _semiMajorAxis[object] * (cosE - _eccentricity[object]);
+    const double y = _semiMinorAxis[object] * sinE;
+    return glm::dvec3(
+        x * _px[object] + y * _qx[object],
+        x * _py[object] + y * _qy[object],
+        x * _pz[object] + y * _qz[object]
+    );
+}
+
+void Propagator::propagateBlock(std::span<const uint32_t> objects,
+                                std::span<const double> times,
+                                glm::vec3* positions) const
+{
+    ghoul_assert(objects.size() == times.size(), "Need one time per object");
+    ghoul_assert(objects.size() <= BlockSize, "Too many samples for one block");
+
+    std::array<double, BlockSize> meanAnomaly;
+    std::array<double, BlockSize> eccentricity;
+    std::array<double, BlockSize> sinE;
+    std::array<double, BlockSize> cosE;
+
+    const size_t n = objects.size();
+    for (size_t i = 0; i < n; i++) {
+        const uint32_t o = objects[i];
+        meanAnomaly[i] = _meanAnomalyAtEpoch[o] + (times[i] - _epoch[o]) * _meanMotion[o];
+        eccentricity[i] = _eccentricity[o];
+    }
+
+    solveEccentricAnomaly(
+        std::span(meanAnomaly.data(), n),
+        std::span(eccentricity.data(), n),
+        std::span(sinE.data(), n),
+        std::span(cosE.data(), n)
+    );
+
+    for (size_t i = 0; i < n; i++) {
+        const uint32_t o = objects[i];
+        const double x = _semiMajorAxis[o] * (cosE[i] - eccentricity[i]);
+        const double y = _semiMinorAxis[o] * sinE[i];
+        positions[i] = glm::vec3(
+            x * _px[o] + y * _qx[o],
+            x * _py[o] + y * _qy[o],
+            x * _pz[o] + y * _qz[o]
+        );
+    }
+}
+
+} // namespace openspace::kepler
@@ -0,0 +1,164 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_SPACE___KEPLERPROPAGATOR___H__
+#define __OPENSPACE_MODULE_SPACE___KEPLERPROPAGATOR___H__
+
+#include <modules/space/kepler.h>
+#include <ghoul/glm.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace openspace { class TaskScheduler; }
+
+namespace openspace::kepler {
+
+/**
+ * Computes the positions of many objects on Keplerian orbits at once. The orbital
+ * elements are stored as a structure of arrays and Kepler's equation is solved for
+ * blocks of samples with SIMD instructions (AVX if the build enables it, SSE2 on all
+ * x86-64 builds, a scalar loop otherwise). Large requests are split into batches that
+ * are computed on the worker threads of a TaskScheduler.
+ *
+ * All positions are in meters relative to the central body, in the reference frame in
+ * which the elements are defined. As for the KeplerTranslation, only elliptical orbits
+ * are supported.
+ */
+class Propagator {
+public:
+    /**
+     * Describes `nSamples` positions of the object with the index `object` at the
+     * times `start`, `start + step`, `start + 2 * step`, and so on. A trail is one range
+     * that covers one period, a point is a range with a single sample.
+     */
+    struct SampleRange {
+        uint32_t object = 0;
+        uint32_t nSamples = 0;
+        /// The time of the first sample in seconds past the J2000 epoch
+        double start = 0.0;
+        /// The time between two consecutive samples in seconds
+        double step = 0.0;
+    };
+
+    Propagator() = default;
+    explicit Propagator(std::span<const Parameters> parameters);
+
+    /**
+     * Replaces all stored orbits with the orbits described by \p parameters. The index of
+     * each object is its position in \p parameters.
+     */
+    void setParameters(std::span<const Parameters> parameters);
+
+    /**
+     * Replaces the orbital elements of the object with the index \p object.
+     *
+     * \pre \p object must be smaller than #size
+     */
+    void setParameters(size_t object, const Parameters& parameters);
+
+    /// Returns the number of objects whose orbits are stored in this propagator
+    size_t size() const;
+
+    /**
+     * Computes the positions for all samples of the \p ranges. The positions of each
+     * range are written consecutively into \p positions, in the order of the ranges.
+     *
+     * \param ranges The samples whose positions are computed
+     * \param positions The destination of the positions, which has to contain as many
+     *        elements as there are samples in all \p ranges
+     * \param scheduler The scheduler on which large requests are computed in parallel.
+     *        If it is `nullptr`, all positions are computed on the calling thread
+     *
+     * \pre All objects of the \p ranges must be smaller than #size
+     */
+    void propagate(std::span<const SampleRange> ranges, std::span<glm::vec3> positions,
+        TaskScheduler* scheduler = nullptr) const;
+
+    /**
+     * Computes the positions of all objects at the same \p time, for example to render
+     * each object as a point.
+     *
+     * \param time The time in seconds past the J2000 epoch
+     * \param positions The destination of the positions, which has to contain #size
+     *        elements
+     * \param scheduler The scheduler on which large requests are computed in parallel.
+     *        If it is `nullptr`, all positions are computed on the calling thread
+     */
+    void propagate(double time, std::span<glm::vec3> positions,
+        TaskScheduler* scheduler = nullptr) const;
+
+    /**
+     * Computes the position of a single \p object at the \p time in double precision.
+     *
+     * \pre \p object must be smaller than #size
+     */
+    glm::dvec3 position(size_t object, double time) const;
+
+private:
+    /**
+     * Computes the positions of up to BlockSize samples whose objects and times are
+     * provided in \p objects and \p times.
+     */
+    void propagateBlock(std::span<const uint32_t> objects, std::span<const double> times,
+        glm::vec3* positions) const;
+
+    /// The eccentricity of each orbit
+    std::vector<double> _eccentricity;
+    /// The semi-major and semi-minor axis of each orbit in meters
+    std::vector<double> _semiMajorAxis;
+    std::vector<double> _semiMinorAxis;
+    /// The mean anomaly at the epoch in radians
+    std::vector<double> _meanAnomalyAtEpoch;
+    /// The mean motion in radians per second
+    std::vector<double> _meanMotion;
+    /// The epoch in seconds past the J2000 epoch
+    std::vector<double> _epoch;
+
+    /// The direction of the periapsis (P) and the direction 90 degrees ahead of it in the
+    /// orbital plane (Q), which are the first two columns of the orbit plane rotation
+    std::vector<double> _px;
+    std::vector<double> _py;
+    std::vector<double> _pz;
+    std::vector<double> _qx;
+    std::vector<double> _qy;
+    std::vector<double> _qz;
+};
+
+/**
+ * Solves Kepler's equation `M = E - e sin(E)` for the eccentric anomaly `E` of each pair
+ * of mean anomaly \p meanAnomaly and eccentricity \p eccentricity and returns the sine
+ * and cosine of the eccentric anomaly in \p sinE and \p cosE, which is what is needed to
+ * compute a position on the orbit.
+ *
+ * \pre All spans must have the same size
+ * \pre All eccentricities must be in [0, 1)
+ */
+void solveEccentricAnomaly(std::span<const double> meanAnomaly,
+    std::span<const double> eccentricity, std::span<double> sinE, std::span<double> cosE);
+
+} // namespace openspace::kepler
+
+#endif // __OPENSPACE_MODULE_SPACE___KEPLERPROPAGATOR___H__
@@ -0,0 +1,119 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/space/keplertrails.h>
+
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Trails of orbits that appear smaller than this angle (in radians) from the camera
+    // use fewer segments. Each detail level halves the number of segments
+    constexpr double FullDetailAngularSize = 0.5;
+    constexpr int MaxDetailLevel = 3;
+    constexpr int MinSegments = 8;
+} // namespace
+
+namespace openspace::kepler {
+
+int fullDetailSegments(unsigned int quality, double eccentricity) {
+    const double scale = static_cast<double>(quality) * 10.0;
+    return static_cast<int>(scale + (scale / std::pow(1.0 - eccentricity, 1.2)));
+}
+
+int segmentsForLevel(int capacity, int level) {
+    return std::max(std::min(capacity, MinSegments), capacity >> level);
+}
+
+int detailLevel(double semiMajorAxis, double cameraDistance) {
+    if (cameraDistance <= 0.0) {
+        return 0;
+    }
+    const double angularSize = semiMajorAxis * 1000.0 / cameraDistance;
+    if (angularSize >= FullDetailAngularSize) {
+        return 0;
+    }
+    if (angularSize <= 0.0) {
+        return MaxDetailLevel;
+    }
+    const double level = std::log2(FullDetailAngularSize / angularSize);
+    return static_cast<int>(std::min(level, static_cast<double>(MaxDetailLevel)));
+}
+
+bool hasSameLayout(std::span<const Trail> lhs, std::span<const Trail> rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); i++) {
+        if (lhs[i].fileIndex != rhs[i].fileIndex || lhs[i].capacity != rhs[i].capacity) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool markChangedTrails(std::span<Trail> trails, std::span<const Trail> updated) {
+    ghoul_assert(trails.size() == updated.size(), "Trails must have the same layout");
+
+    bool hasChanged = false;
+    for (size_t i = 0; i < trails.size(); i++) {
+        if (trails[i].parameters != updated[i].parameters) {
+            trails[i].parameters = updated[i].parameters;
+            trails[i].isDirty = true;
+            hasChanged = true;
+        }
+    }
+    return hasChanged;
+}
+
+std::vector<VertexRange> dirtyRanges(std::span<const Trail> trails,
+                                     std::span<const int> startIndex,
+                                     std::span<const int> segmentSize)
+{
+    ghoul_assert(startIndex.size() == trails.size(), "Wrong number of start indices");
+    ghoul_assert(segmentSize.size() == trails.size(), "Wrong number of segment sizes");
+
+    std::vector<VertexRange> res;
+    for (size_t i = 0; i < trails.size();) {
+        if (!trails[i].isDirty) {
+            i++;
+            continue;
+        }
+        size_t last = i;
+        while (last + 1 < trails.size() && trails[last + 1].isDirty) {
+            last++;
+        }
+
+        res.push_back({
+            .begin = static_cast<size_t>(startIndex[i]),
+            .end = static_cast<size_t>(startIndex[last] + segmentSize[last])
+        });
+        i = last + 1;
+    }
+    return res;
+}
+
+} // namespace openspace::kepler
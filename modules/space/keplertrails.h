@@ -0,0 +1,130 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_SPACE___KEPLERTRAILS___H__
+#define __OPENSPACE_MODULE_SPACE___KEPLERTRAILS___H__
+
+#include <modules/space/kepler.h>
+#include <span>
+#include <vector>
+
+namespace openspace::kepler {
+
+/**
+ * The state of the trail of a single orbit in a vertex buffer that contains the trails of
+ * many orbits. Each trail reserves enough vertices for its full detail, but only uses as
+ * many vertices as its detail level requires.
+ */
+struct Trail {
+    /// The index of the object in the data file
+    size_t fileIndex = 0;
+    Parameters parameters;
+    /// The number of vertices that are reserved for the trail in the vertex buffer
+    int capacity = 0;
+    /// The detail level of the trail, where each level halves the number of segments
+    int level = 0;
+    /// Whether the vertices of the trail have to be recomputed and uploaded
+    bool isDirty = true;
+};
+
+/// A range of vertices in the vertex buffer, where `end` is one past the last vertex
+struct VertexRange {
+    size_t begin = 0;
+    size_t end = 0;
+
+    bool operator==(const VertexRange&) const = default;
+};
+
+/**
+ * Returns the number of vertices of a trail at full detail, which increases with the
+ * \p eccentricity of the orbit.
+ *
+ * \param quality The segment quality between 1 (lowest) and 10 (highest)
+ * \param eccentricity The eccentricity of the orbit
+ * \return The number of vertices of the trail at full detail
+ */
+int fullDetailSegments(unsigned int quality, double eccentricity);
+
+/**
+ * Returns the number of vertices that a trail with \p capacity reserved vertices uses at
+ * the detail level \p level. Each level halves the number of vertices, but a trail never
+ * uses fewer than a small minimum number of vertices unless its capacity is smaller.
+ *
+ * \param capacity The number of vertices that are reserved for the trail
+ * \param level The detail level of the trail
+ * \return The number of vertices that are used by the trail
+ */
+int segmentsForLevel(int capacity, int level);
+
+/**
+ * Returns the detail level for an orbit with the \p semiMajorAxis that is seen from the
+ * \p cameraDistance. Orbits that appear smaller from the camera get a higher detail
+ * level, and thus fewer vertices. An unknown camera distance of 0 results in the full
+ * detail.
+ *
+ * \param semiMajorAxis The semi-major axis of the orbit in km
+ * \param cameraDistance The distance of the camera in m
+ * \return The detail level of the orbit, where 0 is the full detail
+ */
+int detailLevel(double semiMajorAxis, double cameraDistance);
+
+/**
+ * Returns whether \p lhs and \p rhs render the same objects in the same order with the
+ * same number of reserved vertices, in which case they share the layout of the vertex
+ * buffer.
+ */
+bool hasSameLayout(std::span<const Trail> lhs, std::span<const Trail> rhs);
+
+/**
+ * Copies the orbital elements from \p updated into \p trails and marks only the trails
+ * whose elements have changed as dirty.
+ *
+ * \param trails The trails that are currently in the vertex buffer
+ * \param updated The trails with the new orbital elements
+ * \return `true` if at least one trail was marked as dirty
+ *
+ * \pre \p trails and \p updated must have the same layout (see #hasSameLayout)
+ */
+bool markChangedTrails(std::span<Trail> trails, std::span<const Trail> updated);
+
+/**
+ * Returns the ranges of vertices of all dirty \p trails that have to be uploaded.
+ * Consecutive dirty trails are merged into a single range, so that each run of changed
+ * trails is uploaded with a single call.
+ *
+ * \param trails The trails in the order in which they are stored in the vertex buffer
+ * \param startIndex The index of the first vertex of each trail
+ * \param segmentSize The number of vertices that are used by each trail
+ * \return The ranges of vertices that have to be uploaded, in increasing order
+ *
+ * \pre \p startIndex and \p segmentSize must have the same size as \p trails
+ */
+std::vector<VertexRange> dirtyRanges(std::span<const Trail> trails,
+                                     std::span<const int> startIndex,
+                                     std::span<const int> segmentSize);
+
+} // namespace openspace::kepler
+
+#endif // __OPENSPACE_MODULE_SPACE___KEPLERTRAILS___H__
@@ -24,13 +24,14 @@
 
 #include <modules/space/rendering/renderableorbitalkepler.h>
 
-#include <modules/space/translation/keplertranslation.h>
 #include <modules/space/spacemodule.h>
+#include <openspace/engine/moduleengine.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/engine/globals.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/util/taskscheduler.h>
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -38,13 +39,24 @@
 #include <ghoul/misc/csvreader.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <fstream>
+#include <numeric>
 #include <random>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 namespace {
+    // The largest number of trail vertices whose positions are computed at once
+    constexpr size_t MaxSamplesPerGroup = 1 << 22;
+
+    // The detail levels are only reevaluated if the camera distance changes by more than
+    // this factor, to avoid touching every orbit in every frame
+    constexpr double DetailLevelDistanceChange = 1.1;
+
     constexpr openspace::properties::Property::PropertyInfo PathInfo = {
         "Path",
         "Path",
@@ -58,7 +70,8 @@ namespace {
         "A segment quality value for the orbital trail. A value from 1 (lowest) to "
         "10 (highest) that controls the number of line segments in the rendering of the "
         "orbital trail. This does not control the direct number of segments because "
-        "these automatically increase according to the eccentricity of the orbit",
+        "these automatically increase according to the eccentricity of the orbit and "
+        "decrease for orbits that appear small from the camera",
         // @VISIBILITY(2.5)
         openspace::properties::Property::Visibility::User
     };
@@ -170,7 +183,7 @@ RenderableOrbitalKepler::RenderableOrbitalKepler(const ghoul::Dictionary& dict)
     addProperty(Fadeable::_opacity);
 
     _segmentQuality = static_cast<unsigned int>(p.segmentQuality);
-    _segmentQuality.onChange([this]() { updateBuffers(); });
+    _segmentQuality.onChange([this]() { _updateDataBuffersAtNextRender = true; });
     addProperty(_segmentQuality);
 
     _appearance.lineColor = p.color;
@@ -179,7 +192,10 @@ RenderableOrbitalKepler::RenderableOrbitalKepler(const ghoul::Dictionary& dict)
     addPropertySubOwner(_appearance);
 
     _path = p.path.string();
-    _path.onChange([this]() { updateBuffers(); });
+    _path.onChange([this]() {
+        _fileIsDirty = true;
+        _updateDataBuffersAtNextRender = true;
+    });
     addProperty(_path);
 
     _format = codegen::map<kepler::Format>(p.format);
@@ -235,7 +251,26 @@ void RenderableOrbitalKepler::initializeGL() {
     _uniformCache.color = _programObject->uniformLocation("color");
     _uniformCache.opacity = _programObject->uniformLocation("opacity");
 
+    glBindVertexArray(_vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TrailVBOLayout), nullptr);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(
+        1,
+        2,
+        GL_DOUBLE,
+        GL_FALSE,
+        sizeof(TrailVBOLayout),
+        reinterpret_cast<GLvoid*>(4 * sizeof(GL_FLOAT))
+    );
+
+    glBindVertexArray(0);
+
     updateBuffers();
+    updateTrails();
 }
 
 void RenderableOrbitalKepler::deinitializeGL() {
@@ -260,9 +295,25 @@ void RenderableOrbitalKepler::update(const UpdateData&) {
         _updateDataBuffersAtNextRender = false;
         updateBuffers();
     }
+
+    if (_cameraDistance > 0.0 &&
+        (_detailLevelDistance <= 0.0 ||
+         _cameraDistance > _detailLevelDistance * DetailLevelDistanceChange ||
+         _cameraDistance * DetailLevelDistanceChange < _detailLevelDistance))
+    {
+        updateDetailLevels();
+    }
+
+    updateTrails();
 }
 
 void RenderableOrbitalKepler::render(const RenderData& data, RendererTasks&) {
+    // The detail levels of the trails are updated in the next update from this distance
+    const TransformData& transform = data.modelTransform;
+    _cameraDistance =
+        glm::distance(data.camera.positionVec3(), transform.translation) /
+        std::max({ transform.scale.x, transform.scale.y, transform.scale.z });
+
     if (_vertexBufferData.empty()) {
         return;
     }
@@ -299,12 +350,12 @@ void RenderableOrbitalKepler::render(const RenderData& data, RendererTasks&) {
 }
 
 void RenderableOrbitalKepler::updateBuffers() {
-    std::vector<kepler::Parameters> parameters = kepler::readFile(
-       _path.value(),
-        _format
-    );
+    if (_fileIsDirty) {
+        _parameters = kepler::readFile(_path.value(), _format);
+        _fileIsDirty = false;
+    }
 
-    _numObjects = parameters.size();
+    _numObjects = _parameters.size();
 
     if (_startRenderIdx >= _numObjects) {
         throw ghoul::RuntimeError(std::format(
@@ -326,124 +377,232 @@ void RenderableOrbitalKepler::updateBuffers() {
         _sizeRender = static_cast<unsigned int>(_numObjects);
     }
 
+    // The indices of the objects in the file that are rendered
+    std::vector<size_t> selection;
     if (_contiguousMode) {
-        if (_startRenderIdx >= parameters.size() ||
-            (_startRenderIdx + _sizeRender) >= parameters.size())
+        if (_startRenderIdx >= _parameters.size() ||
+            (_startRenderIdx + _sizeRender) >= _parameters.size())
         {
             throw ghoul::RuntimeError(std::format(
                 "Tried to load {} objects but only {} are available",
-                _startRenderIdx + _sizeRender, parameters.size()
+                _startRenderIdx + _sizeRender, _parameters.size()
             ));
         }
 
         // Extract subset that starts at _startRenderIdx and contains _sizeRender obejcts
-        parameters = std::vector<kepler::Parameters>(
-            parameters.begin() + _startRenderIdx,
-            parameters.begin() + _startRenderIdx + _sizeRender
-        );
+        selection.resize(_sizeRender);
+        std::iota(selection.begin(), selection.end(), size_t(_startRenderIdx));
     }
     else {
         // First shuffle the whole array
+        selection.resize(_parameters.size());
+        std::iota(selection.begin(), selection.end(), size_t(0));
         std::default_random_engine rng;
-        std::shuffle(parameters.begin(), parameters.end(), rng);
+        std::shuffle(selection.begin(), selection.end(), rng);
 
         // Then take the first _sizeRender values
-        parameters = std::vector<kepler::Parameters>(
-            parameters.begin(),
-            parameters.begin() + _sizeRender
-        );
+        selection.resize(_sizeRender);
     }
 
-    _segmentSize.clear();
-    _startIndex.clear();
-    _startIndex.push_back(0);
-    for (size_t i = 0; i < parameters.size(); i++) {
-        const double scale = static_cast<double>(_segmentQuality) * 10.0;
-        const kepler::Parameters& p = parameters[i];
-        _segmentSize.push_back(
-            static_cast<int>(scale + (scale / pow(1.0 - p.eccentricity, 1.2)))
+    std::vector<kepler::Trail> orbits = std::vector<kepler::Trail>(selection.size());
+    for (size_t i = 0; i < selection.size(); i++) {
+        kepler::Trail& orbit = orbits[i];
+        orbit.fileIndex = selection[i];
+        orbit.parameters = _parameters[selection[i]];
+        orbit.capacity = kepler::fullDetailSegments(
+            _segmentQuality,
+            orbit.parameters.eccentricity
+        );
+        orbit.level = kepler::detailLevel(
+            orbit.parameters.semiMajorAxis,
+            _detailLevelDistance
         );
-        _startIndex.push_back(_startIndex[i] + static_cast<GLint>(_segmentSize[i]));
     }
-    _startIndex.pop_back();
-
-    size_t nVerticesTotal = 0;
 
-    const int numOrbits = static_cast<int>(parameters.size());
-    for (int i = 0; i < numOrbits; i++) {
-        nVerticesTotal += _segmentSize[i];
+    // If the same objects are rendered with the same number of reserved vertices, the
+    // layout of the vertex buffer stays the same and only changed trails are uploaded
+    if (kepler::hasSameLayout(orbits, _orbits)) {
+        if (kepler::markChangedTrails(_orbits, orbits)) {
+            _hasDirtyTrails = true;
+        }
     }
-    _vertexBufferData.resize(nVerticesTotal);
-
-    size_t vertexBufIdx = 0;
-    KeplerTranslation keplerTranslator;
-    for (int orbitIdx = 0; orbitIdx < numOrbits; ++orbitIdx) {
-        const kepler::Parameters& orbit = parameters[orbitIdx];
-
-        keplerTranslator.setKeplerElements(
-            orbit.eccentricity,
-            orbit.semiMajorAxis,
-            orbit.inclination,
-            orbit.ascendingNode,
-            orbit.argumentOfPeriapsis,
-            orbit.meanAnomaly,
-            orbit.period,
-            orbit.epoch
-        );
+    else {
+        // Orbits that were rendered before with the same elements and capacity keep
+        // their vertices, which are moved to their new location
+        std::unordered_map<size_t, size_t> previous;
+        for (size_t i = 0; i < _orbits.size(); i++) {
+            previous[_orbits[i].fileIndex] = i;
+        }
+
+        std::vector<GLint> startIndex = std::vector<GLint>(orbits.size());
+        std::vector<GLint> segmentSize = std::vector<GLint>(orbits.size());
+        size_t nVerticesTotal = 0;
+        for (size_t i = 0; i < orbits.size(); i++) {
+            startIndex[i] = static_cast<GLint>(nVerticesTotal);
+            segmentSize[i] =
+                kepler::segmentsForLevel(orbits[i].capacity, orbits[i].level);
+            nVerticesTotal += orbits[i].capacity;
+        }
 
-        for (GLint j = 0 ; j < (_segmentSize[orbitIdx]); j++) {
-            const double timeOffset = orbit.period *
-                static_cast<double>(j) / static_cast<double>(_segmentSize[orbitIdx] - 1);
+        std::vector<TrailVBOLayout> vertexBufferData =
+            std::vector<TrailVBOLayout>(nVerticesTotal);
+        for (size_t i = 0; i < orbits.size(); i++) {
+            const auto it = previous.find(orbits[i].fileIndex);
+            if (it == previous.end()) {
+                continue;
+            }
+            const kepler::Trail& old = _orbits[it->second];
+            if (old.isDirty || old.parameters != orbits[i].parameters ||
+                old.capacity != orbits[i].capacity)
+            {
+                continue;
+            }
 
-            const glm::dvec3 position = keplerTranslator.position({
-                {},
-                Time(timeOffset + orbit.epoch),
-                Time(0.0)
-            });
+            std::copy_n(
+                _vertexBufferData.begin() + _startIndex[it->second],
+                _segmentSize[it->second],
+                vertexBufferData.begin() + startIndex[i]
+            );
+            segmentSize[i] = _segmentSize[it->second];
+            orbits[i].level = old.level;
+            orbits[i].isDirty = false;
+        }
 
-            _vertexBufferData[vertexBufIdx].x = static_cast<float>(position.x);
-            _vertexBufferData[vertexBufIdx].y = static_cast<float>(position.y);
-            _vertexBufferData[vertexBufIdx].z = static_cast<float>(position.z);
-            _vertexBufferData[vertexBufIdx].time = static_cast<float>(timeOffset);
-            _vertexBufferData[vertexBufIdx].epoch = orbit.epoch;
-            _vertexBufferData[vertexBufIdx].period = orbit.period;
+        _orbits = std::move(orbits);
+        _startIndex = std::move(startIndex);
+        _segmentSize = std::move(segmentSize);
+        _vertexBufferData = std::move(vertexBufferData);
+        _bufferNeedsReallocation = true;
+        _hasDirtyTrails = true;
+    }
 
-            vertexBufIdx++;
+    std::vector<kepler::Parameters> parameters;
+    parameters.reserve(_orbits.size());
+    double maxSemiMajorAxis = 0.0;
+    for (const kepler::Trail& orbit : _orbits) {
+        parameters.push_back(orbit.parameters);
+        maxSemiMajorAxis = std::max(maxSemiMajorAxis, orbit.parameters.semiMajorAxis);
+    }
+    _propagator.setParameters(parameters);
+    setBoundingSphere(maxSemiMajorAxis * 1000);
+}
+
+void RenderableOrbitalKepler::updateDetailLevels() {
+    for (size_t i = 0; i < _orbits.size(); i++) {
+        kepler::Trail& orbit = _orbits[i];
+        const int level =
+            kepler::detailLevel(orbit.parameters.semiMajorAxis, _cameraDistance);
+        if (level == orbit.level) {
+            continue;
+        }
+
+        orbit.level = level;
+        const GLint nSegments = kepler::segmentsForLevel(orbit.capacity, level);
+        if (nSegments != _segmentSize[i]) {
+            _segmentSize[i] = nSegments;
+            orbit.isDirty = true;
+            _hasDirtyTrails = true;
         }
     }
+    _detailLevelDistance = _cameraDistance;
+}
 
-    glBindVertexArray(_vertexArray);
+void RenderableOrbitalKepler::updateTrails() {
+    if (!_hasDirtyTrails) {
+        return;
+    }
 
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        _vertexBufferData.size() * sizeof(TrailVBOLayout),
-        _vertexBufferData.data(),
-        GL_STATIC_DRAW
-    );
+    // Each trail samples one period of its orbit, starting at the epoch
+    std::vector<kepler::Propagator::SampleRange> ranges;
+    for (size_t i = 0; i < _orbits.size(); i++) {
+        const kepler::Trail& orbit = _orbits[i];
+        if (!orbit.isDirty) {
+            continue;
+        }
+        ranges.push_back({
+            .object = static_cast<uint32_t>(i),
+            .nSamples = static_cast<uint32_t>(_segmentSize[i]),
+            .start = orbit.parameters.epoch,
+            .step = orbit.parameters.period / static_cast<double>(_segmentSize[i] - 1)
+        });
+    }
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TrailVBOLayout), nullptr);
+    TaskScheduler* scheduler =
+        global::moduleEngine->module<SpaceModule>()->keplerPropagationScheduler();
+
+    // The positions are computed for groups of orbits at a time to limit the size of the
+    // intermediate buffer for very large data sets
+    std::vector<glm::vec3> positions;
+    for (size_t first = 0; first < ranges.size();) {
+        size_t last = first;
+        size_t nSamples = 0;
+        while (last < ranges.size() &&
+               (nSamples == 0 || nSamples + ranges[last].nSamples <= MaxSamplesPerGroup))
+        {
+            nSamples += ranges[last].nSamples;
+            last++;
+        }
 
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(
-        1,
-        2,
-        GL_DOUBLE,
-        GL_FALSE,
-        sizeof(TrailVBOLayout),
-        reinterpret_cast<GLvoid*>(4 * sizeof(GL_FLOAT))
-    );
+        positions.resize(nSamples);
+        _propagator.propagate(
+            std::span(ranges).subspan(first, last - first),
+            positions,
+            scheduler
+        );
 
-    glBindVertexArray(0);
+        size_t positionIdx = 0;
+        for (size_t rangeIdx = first; rangeIdx < last; rangeIdx++) {
+            const kepler::Propagator::SampleRange& range = ranges[rangeIdx];
+            const kepler::Parameters& orbit = _orbits[range.object].parameters;
+            size_t vertexBufIdx = _startIndex[range.object];
+            for (uint32_t j = 0; j < range.nSamples; j++) {
+                const double timeOffset = orbit.period * static_cast<double>(j) /
+                    static_cast<double>(range.nSamples - 1);
+
+                const glm::vec3& position = positions[positionIdx];
+                _vertexBufferData[vertexBufIdx].x = position.x;
+                _vertexBufferData[vertexBufIdx].y = position.y;
+                _vertexBufferData[vertexBufIdx].z = position.z;
+                _vertexBufferData[vertexBufIdx].time = static_cast<float>(timeOffset);
+                _vertexBufferData[vertexBufIdx].epoch = orbit.epoch;
+                _vertexBufferData[vertexBufIdx].period = orbit.period;
+
+                positionIdx++;
+                vertexBufIdx++;
+            }
+        }
+        first = last;
+    }
 
-    double maxSemiMajorAxis = 0.0;
-    for (const kepler::Parameters& kp : parameters) {
-        if (kp.semiMajorAxis > maxSemiMajorAxis) {
-            maxSemiMajorAxis = kp.semiMajorAxis;
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    if (_bufferNeedsReallocation) {
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            _vertexBufferData.size() * sizeof(TrailVBOLayout),
+            _vertexBufferData.data(),
+            GL_STATIC_DRAW
+        );
+        _bufferNeedsReallocation = false;
+    }
+    else {
+        // Upload consecutive runs of changed trails with one call each
+        const std::vector<kepler::VertexRange> ranges =
+            kepler::dirtyRanges(_orbits, _startIndex, _segmentSize);
+        for (const kepler::VertexRange& range : ranges) {
+            glBufferSubData(
+                GL_ARRAY_BUFFER,
+                range.begin * sizeof(TrailVBOLayout),
+                (range.end - range.begin) * sizeof(TrailVBOLayout),
+                _vertexBufferData.data() + range.begin
+            );
         }
     }
-    setBoundingSphere(maxSemiMajorAxis * 1000);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    for (kepler::Trail& orbit : _orbits) {
+        orbit.isDirty = false;
+    }
+    _hasDirtyTrails = false;
 }
 
 } // namespace openspace
@@ -29,7 +29,8 @@
 
 #include <modules/base/rendering/renderabletrail.h>
 #include <modules/space/kepler.h>
-#include <modules/space/translation/keplertranslation.h>
+#include <modules/space/keplerpropagator.h>
+#include <modules/space/keplertrails.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/scalar/uintproperty.h>
 #include <ghoul/glm.h>
@@ -54,12 +55,41 @@ public:
     static documentation::Documentation Documentation();
 
 private:
+    /**
+     * Reads the data file if it has changed, selects the orbits that are rendered, and
+     * lays them out in the vertex buffer. Orbits that were rendered before with the same
+     * elements and number of vertices keep their vertices.
+     */
     void updateBuffers();
 
+    /**
+     * Updates the detail level of all orbits for the current camera distance and marks
+     * the trails whose number of segments changes.
+     */
+    void updateDetailLevels();
+
+    /**
+     * Recomputes the vertices of all orbits that are marked as dirty and uploads them.
+     */
+    void updateTrails();
+
     bool _updateDataBuffersAtNextRender = false;
+    bool _fileIsDirty = true;
+    bool _bufferNeedsReallocation = true;
+    bool _hasDirtyTrails = false;
     std::streamoff _numObjects;
+    /// All objects in the data file
+    std::vector<kepler::Parameters> _parameters;
+    /// The rendered orbits
+    std::vector<kepler::Trail> _orbits;
+    /// The number of vertices of each rendered trail
     std::vector<GLint> _segmentSize;
+    /// The index of the first vertex of each rendered trail in the vertex buffer
     std::vector<GLint> _startIndex;
+    /// The distance of the camera in model coordinates, or 0 if it is not known yet
+    double _cameraDistance = 0.0;
+    /// The camera distance for which the detail levels were last computed
+    double _detailLevelDistance = 0.0;
     properties::UIntProperty _segmentQuality;
     properties::UIntProperty _startRenderIdx;
     properties::UIntProperty _sizeRender;
@@ -77,6 +107,9 @@ private:
     /// The backend storage for the vertex buffer object containing all points
     std::vector<TrailVBOLayout> _vertexBufferData;
 
+    /// Computes the positions of the trail vertices for all rendered orbits
+    kepler::Propagator _propagator;
+
     GLuint _vertexArray;
     GLuint _vertexBuffer;
 
@@ -1027,7 +1027,7 @@ void RenderableStars::renderPSFToTexture() {
 }
 
 void RenderableStars::render(const RenderData& data, RendererTasks&) {
-    if (_dataset.entries.empty()) {
+    if (_dataset.size() == 0) {
         return;
     }
 
@@ -1126,7 +1126,7 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
 
 
     glBindVertexArray(_vao);
-    const GLsizei nStars = static_cast<GLsizei>(_dataset.entries.size());
+    const GLsizei nStars = static_cast<GLsizei>(_dataset.size());
     glDrawArrays(GL_POINTS, 0, nStars);
 
     glBindVertexArray(0);
@@ -1144,7 +1144,7 @@ void RenderableStars::update(const UpdateData&) {
         _dataIsDirty = true;
     }
 
-    if (_dataset.entries.empty()) {
+    if (_dataset.size() == 0) {
         return;
     }
 
@@ -1175,7 +1175,7 @@ void RenderableStars::update(const UpdateData&) {
             "in_bvLumAbsMagAppMag"
         );
 
-        const size_t nStars = _dataset.entries.size();
+        const size_t nStars = _dataset.size();
         const size_t nValues = slice.size() / nStars;
 
         const GLsizei stride = static_cast<GLsizei>(sizeof(GLfloat) * nValues);
@@ -1356,7 +1356,7 @@ void RenderableStars::loadData() {
     }
 
     _dataset = dataloader::data::loadFileWithCache(file);
-    if (_dataset.entries.empty()) {
+    if (_dataset.size() == 0) {
         return;
     }
 
@@ -1398,9 +1398,10 @@ std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
 
     std::vector<float> result;
     // 7 for the default Color option of 3 positions + bv + lum + abs + app magnitude
-    result.reserve(_dataset.entries.size() * 7);
-    for (const dataloader::Dataset::Entry& e : _dataset.entries) {
-        glm::dvec3 position = glm::dvec3(e.position) * distanceconstants::Parsec;
+    result.reserve(_dataset.size() * 7);
+    for (size_t i = 0; i < _dataset.size(); i++) {
+        glm::dvec3 position =
+            glm::dvec3(_dataset.positions[i]) * distanceconstants::Parsec;
         maxRadius = std::max(maxRadius, glm::length(position));
 
         switch (option) {
@@ -1418,10 +1419,10 @@ std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
                     static_cast<float>(position[2])
                 }};
 
-                layout.value.value = e.data[bvIdx];
-                layout.value.luminance = e.data[lumIdx];
-                layout.value.absoluteMagnitude = e.data[absMagIdx];
-                layout.value.apparentMagnitude = e.data[appMagIdx];
+                layout.value.value = _dataset.columns[bvIdx][i];
+                layout.value.luminance = _dataset.columns[lumIdx][i];
+                layout.value.absoluteMagnitude = _dataset.columns[absMagIdx][i];
+                layout.value.apparentMagnitude = _dataset.columns[appMagIdx][i];
 
                 result.insert(result.end(), layout.data.begin(), layout.data.end());
                 break;
@@ -1439,14 +1440,14 @@ std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
                     static_cast<float>(position[2])
                 }};
 
-                layout.value.value = e.data[bvIdx];
-                layout.value.luminance = e.data[lumIdx];
-                layout.value.absoluteMagnitude = e.data[absMagIdx];
-                layout.value.apparentMagnitude = e.data[appMagIdx];
+                layout.value.value = _dataset.columns[bvIdx][i];
+                layout.value.luminance = _dataset.columns[lumIdx][i];
+                layout.value.absoluteMagnitude = _dataset.columns[absMagIdx][i];
+                layout.value.apparentMagnitude = _dataset.columns[appMagIdx][i];
 
-                layout.value.vx = e.data[vxIdx];
-                layout.value.vy = e.data[vyIdx];
-                layout.value.vz = e.data[vzIdx];
+                layout.value.vx = _dataset.columns[vxIdx][i];
+                layout.value.vy = _dataset.columns[vyIdx][i];
+                layout.value.vz = _dataset.columns[vzIdx][i];
 
                 result.insert(result.end(), layout.data.begin(), layout.data.end());
                 break;
@@ -1464,11 +1465,11 @@ std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
                     static_cast<float>(position[2])
                 }};
 
-                layout.value.value = e.data[bvIdx];
-                layout.value.luminance = e.data[lumIdx];
-                layout.value.absoluteMagnitude = e.data[absMagIdx];
-                layout.value.apparentMagnitude = e.data[appMagIdx];
-                layout.value.speed = e.data[speedIdx];
+                layout.value.value = _dataset.columns[bvIdx][i];
+                layout.value.luminance = _dataset.columns[lumIdx][i];
+                layout.value.absoluteMagnitude = _dataset.columns[absMagIdx][i];
+                layout.value.apparentMagnitude = _dataset.columns[appMagIdx][i];
+                layout.value.speed = _dataset.columns[speedIdx][i];
 
                 result.insert(result.end(), layout.data.begin(), layout.data.end());
                 break;
@@ -1488,10 +1489,10 @@ std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
 
                 const int index = _otherDataOption.value();
                 // plus 3 because of the position
-                layout.value.value = e.data[index];
+                const float value = _dataset.columns[index][i];
+                layout.value.value = value;
 
-                if (_staticFilterValue.has_value() && e.data[index] == _staticFilterValue)
-                {
+                if (_staticFilterValue.has_value() && value == _staticFilterValue) {
                     layout.value.value = _staticFilterReplacementValue;
                 }
 
@@ -1502,9 +1503,9 @@ std::vector<float> RenderableStars::createDataSlice(ColorOption option) {
                 _otherDataRange.setMinValue(glm::vec2(range.x));
                 _otherDataRange.setMaxValue(glm::vec2(range.y));
 
-                layout.value.luminance = e.data[lumIdx];
-                layout.value.absoluteMagnitude = e.data[absMagIdx];
-                layout.value.apparentMagnitude = e.data[appMagIdx];
+                layout.value.luminance = _dataset.columns[lumIdx][i];
+                layout.value.absoluteMagnitude = _dataset.columns[absMagIdx][i];
+                layout.value.apparentMagnitude = _dataset.columns[appMagIdx][i];
 
                 result.insert(result.end(), layout.data.begin(), layout.data.end());
                 break;
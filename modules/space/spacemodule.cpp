@@ -45,9 +45,12 @@
 #include <openspace/util/coordinateconversion.h>
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/spicemanager.h>
+#include <openspace/util/taskscheduler.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/templatefactory.h>
+#include <algorithm>
+#include <thread>
 
 #include "spacemodule_lua.inl"
 
@@ -75,6 +78,8 @@ SpaceModule::SpaceModule()
     addProperty(_showSpiceExceptions);
 }
 
+SpaceModule::~SpaceModule() {}
+
 void SpaceModule::internalInitialize(const ghoul::Dictionary& dictionary) {
     ghoul::TemplateFactory<Renderable>* fRenderable =
         FactoryManager::ref().factory<Renderable>();
@@ -112,6 +117,16 @@ void SpaceModule::internalInitialize(const ghoul::Dictionary& dictionary) {
     if (dictionary.hasValue<bool>(SpiceExceptionInfo.identifier)) {
         _showSpiceExceptions = dictionary.value<bool>(SpiceExceptionInfo.identifier);
     }
+
+    // The orbits are only propagated while loading or changing a data set, during which
+    // the main thread waits for the result, so the propagation can use all cores
+    _keplerPropagationScheduler = std::make_unique<TaskScheduler>(
+        std::max(2u, std::thread::hardware_concurrency()) - 1
+    );
+}
+
+void SpaceModule::internalDeinitialize() {
+    _keplerPropagationScheduler = nullptr;
 }
 
 void SpaceModule::internalDeinitializeGL() {
@@ -137,6 +152,10 @@ std::vector<documentation::Documentation> SpaceModule::documentations() const {
     };
 }
 
+TaskScheduler* SpaceModule::keplerPropagationScheduler() {
+    return _keplerPropagationScheduler.get();
+}
+
 scripting::LuaLibrary SpaceModule::luaLibrary() const {
     return {
         .name = "space",
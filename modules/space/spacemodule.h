@@ -29,26 +29,38 @@
 
 #include <openspace/properties/scalar/boolproperty.h>
 #include <ghoul/opengl/programobjectmanager.h>
+#include <memory>
 
 namespace openspace {
 
+class TaskScheduler;
+
 class SpaceModule : public OpenSpaceModule {
 public:
     constexpr static const char* Name = "Space";
 
     SpaceModule();
-    ~SpaceModule() override = default;
+    ~SpaceModule() override;
     std::vector<documentation::Documentation> documentations() const override;
 
     static ghoul::opengl::ProgramObjectManager ProgramObjectManager;
 
     scripting::LuaLibrary luaLibrary() const override;
 
+    /**
+     * \return The scheduler whose worker threads are shared by all renderables to
+     *         propagate large numbers of Keplerian orbits
+     */
+    TaskScheduler* keplerPropagationScheduler();
+
 private:
     void internalInitialize(const ghoul::Dictionary&) override;
+    void internalDeinitialize() override;
     void internalDeinitializeGL() override;
 
     properties::BoolProperty _showSpiceExceptions;
+
+    std::unique_ptr<TaskScheduler> _keplerPropagationScheduler;
 };
 
 } // namespace openspace
@@ -27,12 +27,14 @@
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/util/spicemanager.h>
+#include <openspace/util/spicequeryservice.h>
 #include <openspace/util/time.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/profiling.h>
+#include <algorithm>
 #include <filesystem>
 #include <optional>
 #include <variant>
@@ -173,4 +175,32 @@ glm::dvec3 SpiceTranslation::position(const UpdateData& data) const {
     ) * 1000.0;
 }
 
+std::optional<TaskFuture<std::vector<glm::dvec3>>> SpiceTranslation::requestPositions(
+                                                          std::vector<double> times) const
+{
+    if (_fixedEphemerisTime.has_value()) {
+        std::fill(times.begin(), times.end(), *_fixedEphemerisTime);
+    }
+
+    return SpiceManager::ref().queryService().submit(
+        [target = _cachedTarget, observer = _cachedObserver, frame = _cachedFrame,
+         times = std::move(times)]()
+        {
+            std::vector<glm::dvec3> res;
+            res.reserve(times.size());
+            for (const double time : times) {
+                const glm::dvec3 p = SpiceManager::ref().targetPosition(
+                    target,
+                    observer,
+                    frame,
+                    {},
+                    time
+                );
+                res.push_back(p * 1000.0);
+            }
+            return res;
+        }
+    );
+}
+
 } // namespace openspace
@@ -37,6 +37,8 @@ public:
     SpiceTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    std::optional<TaskFuture<std::vector<glm::dvec3>>> requestPositions(
+        std::vector<double> times) const override;
 
     static documentation::Documentation Documentation();
 
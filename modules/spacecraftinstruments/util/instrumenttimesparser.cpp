@@ -26,6 +26,7 @@
 
 #include <openspace/documentation/documentation.h>
 #include <openspace/util/spicemanager.h>
+#include <openspace/util/spicequeryservice.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/format.h>
@@ -81,6 +82,14 @@ bool InstrumentTimesParser::create() {
         return false;
     }
 
+    // The files are read on this thread, while the dates of each file are converted
+    // into ephemeris times on the thread of the SpiceQueryService
+    struct InstrumentFile {
+        std::string instrumentID;
+        TaskFuture<std::vector<double>> times;
+    };
+    std::vector<InstrumentFile> instrumentFiles;
+
     using K = std::string;
     using V = std::vector<std::string>;
     for (const std::pair<const K, V>& p : _instrumentFiles) {
@@ -97,7 +106,8 @@ bool InstrumentTimesParser::create() {
             std::ifstream inFile(filepath);
             std::string line;
             std::smatch matches;
-            TimeRange instrumentActiveTimeRange;
+            // The start and stop time of each event are stored consecutively
+            std::vector<std::string> dates;
             bool successfulRead = true;
             while (ghoul::getline(inFile, line)) {
                 if (!std::regex_match(line, matches, _pattern)) {
@@ -113,41 +123,55 @@ bool InstrumentTimesParser::create() {
                     break;
                 }
 
-                TimeRange tr;
-                try { // parse date strings
-                    const std::string start = matches[1].str();
-                    const std::string stop = matches[2].str();
-                    tr.start = SpiceManager::ref().ephemerisTimeFromDate(start);
-                    tr.end = SpiceManager::ref().ephemerisTimeFromDate(stop);
-                }
-                catch (const SpiceManager::SpiceException& e) {
-                    LERROR(e.what());
-                    successfulRead = false;
-                    break;
-                }
-
-                instrumentActiveTimeRange.include(tr);
-
-                _targetTimes.emplace_back(tr.start, _target);
-                _captureProgression.push_back(tr.start);
-
-                Image image = {
-                    .timeRange = tr,
-                    .path = std::string(),
-                    .activeInstruments = { instrumentID },
-                    .target = _target,
-                    .isPlaceholder = true,
-                    .projected = false
-                };
-                _subsetMap[_target]._subset.push_back(std::move(image));
+                dates.push_back(matches[1].str());
+                dates.push_back(matches[2].str());
             }
-            if (successfulRead){
-                _subsetMap[_target]._range.include(instrumentActiveTimeRange);
-                _instrumentTimes.emplace_back(instrumentID, instrumentActiveTimeRange);
+            if (successfulRead) {
+                instrumentFiles.push_back({
+                    .instrumentID = instrumentID,
+                    .times = SpiceManager::ref().queryService().ephemerisTimesFromDates(
+                        std::move(dates)
+                    )
+                });
             }
         }
     }
 
+    for (InstrumentFile& file : instrumentFiles) {
+        std::vector<double> times;
+        try { // parse date strings
+            times = file.times.get();
+        }
+        catch (const SpiceManager::SpiceException& e) {
+            LERROR(e.what());
+            continue;
+        }
+
+        TimeRange instrumentActiveTimeRange;
+        for (size_t i = 0; i + 1 < times.size(); i += 2) {
+            TimeRange tr;
+            tr.start = times[i];
+            tr.end = times[i + 1];
+
+            instrumentActiveTimeRange.include(tr);
+
+            _targetTimes.emplace_back(tr.start, _target);
+            _captureProgression.push_back(tr.start);
+
+            Image image = {
+                .timeRange = tr,
+                .path = std::string(),
+                .activeInstruments = { file.instrumentID },
+                .target = _target,
+                .isPlaceholder = true,
+                .projected = false
+            };
+            _subsetMap[_target]._subset.push_back(std::move(image));
+        }
+        _subsetMap[_target]._range.include(instrumentActiveTimeRange);
+        _instrumentTimes.emplace_back(file.instrumentID, instrumentActiveTimeRange);
+    }
+
     std::stable_sort(_captureProgression.begin(), _captureProgression.end());
     std::stable_sort(
         _targetTimes.begin(),
@@ -0,0 +1,180 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/data/columnkernels.h>
+
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace {
+#if defined(__AVX__)
+    // Using AVX, a SIMD register holds 8 floats
+    using Vector = __m256;
+    constexpr size_t VectorWidth = 8;
+
+    Vector load(const float* p) { return _mm256_loadu_ps(p); }
+    void store(float* p, Vector v) { _mm256_storeu_ps(p, v); }
+    Vector splat(float v) { return _mm256_set1_ps(v); }
+    // If either operand is NaN, the second operand is returned, so passing the
+    // accumulator as the second argument skips NaN values without an extra test
+    Vector min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+    Vector max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+    Vector sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+    Vector div(Vector a, Vector b) { return _mm256_div_ps(a, b); }
+    int inRangeMask(Vector v, Vector lo, Vector hi) {
+        // Ordered comparisons are false for NaN values
+        const Vector ge = _mm256_cmp_ps(v, lo, _CMP_GE_OQ);
+        const Vector le = _mm256_cmp_ps(v, hi, _CMP_LE_OQ);
+        return _mm256_movemask_ps(_mm256_and_ps(ge, le));
+    }
+#define OPENSPACE_HAS_SIMD_KERNELS
+#elif defined(__SSE2__) || defined(_M_X64)
+    // Using SSE2, which is available on all x86-64 processors, a register holds 4 floats
+    using Vector = __m128;
+    constexpr size_t VectorWidth = 4;
+
+    Vector load(const float* p) { return _mm_loadu_ps(p); }
+    void store(float* p, Vector v) { _mm_storeu_ps(p, v); }
+    Vector splat(float v) { return _mm_set1_ps(v); }
+    // If either operand is NaN, the second operand is returned, so passing the
+    // accumulator as the second argument skips NaN values without an extra test
+    Vector min(Vector a, Vector b) { return _mm_min_ps(a, b); }
+    Vector max(Vector a, Vector b) { return _mm_max_ps(a, b); }
+    Vector sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+    Vector div(Vector a, Vector b) { return _mm_div_ps(a, b); }
+    int inRangeMask(Vector v, Vector lo, Vector hi) {
+        // Ordered comparisons are false for NaN values
+        const Vector ge = _mm_cmpge_ps(v, lo);
+        const Vector le = _mm_cmple_ps(v, hi);
+        return _mm_movemask_ps(_mm_and_ps(ge, le));
+    }
+#define OPENSPACE_HAS_SIMD_KERNELS
+#endif
+} // namespace
+
+namespace openspace::dataloader::kernels {
+
+glm::vec2 findValueRange(std::span<const float> values) {
+    float minValue = std::numeric_limits<float>::max();
+    float maxValue = -std::numeric_limits<float>::max();
+
+    size_t i = 0;
+#ifdef OPENSPACE_HAS_SIMD_KERNELS
+    // Two independent accumulators per bound hide the latency of the min/max operations
+    Vector min0 = splat(minValue);
+    Vector min1 = min0;
+    Vector max0 = splat(maxValue);
+    Vector max1 = max0;
+    for (; i + 2 * VectorWidth <= values.size(); i += 2 * VectorWidth) {
+        const Vector v0 = load(values.data() + i);
+        const Vector v1 = load(values.data() + i + VectorWidth);
+        min0 = min(v0, min0);
+        min1 = min(v1, min1);
+        max0 = max(v0, max0);
+        max1 = max(v1, max1);
+    }
+
+    std::array<float, VectorWidth> mins;
+    std::array<float, VectorWidth> maxs;
+    store(mins.data(), min(min0, min1));
+    store(maxs.data(), max(max0, max1));
+    minValue = *std::min_element(mins.begin(), mins.end());
+    maxValue = *std::max_element(maxs.begin(), maxs.end());
+#endif // OPENSPACE_HAS_SIMD_KERNELS
+
+    for (; i < values.size(); i++) {
+        const float value = values[i];
+        if (std::isnan(value)) {
+            continue;
+        }
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+
+    return glm::vec2(minValue, maxValue);
+}
+
+void normalize(std::span<float> values, float minValue, float maxValue) {
+    const float range = maxValue - minValue;
+
+    size_t i = 0;
+#ifdef OPENSPACE_HAS_SIMD_KERNELS
+    const Vector minV = splat(minValue);
+    const Vector rangeV = splat(range);
+    for (; i + VectorWidth <= values.size(); i += VectorWidth) {
+        const Vector v = load(values.data() + i);
+        store(values.data() + i, div(sub(v, minV), rangeV));
+    }
+#endif // OPENSPACE_HAS_SIMD_KERNELS
+
+    for (; i < values.size(); i++) {
+        values[i] = (values[i] - minValue) / range;
+    }
+}
+
+size_t filterInRange(std::span<const float> values, float minValue, float maxValue,
+                     std::vector<uint32_t>& result)
+{
+    ghoul_assert(
+        values.size() <= std::numeric_limits<uint32_t>::max(),
+        "Too many values for 32-bit indices"
+    );
+
+    const size_t startSize = result.size();
+
+    size_t i = 0;
+#ifdef OPENSPACE_HAS_SIMD_KERNELS
+    const Vector lo = splat(minValue);
+    const Vector hi = splat(maxValue);
+    for (; i + VectorWidth <= values.size(); i += VectorWidth) {
+        unsigned int mask = static_cast<unsigned int>(
+            inRangeMask(load(values.data() + i), lo, hi)
+        );
+        while (mask != 0) {
+            result.push_back(static_cast<uint32_t>(i + std::countr_zero(mask)));
+            mask &= mask - 1;
+        }
+    }
+#endif // OPENSPACE_HAS_SIMD_KERNELS
+
+    for (; i < values.size(); i++) {
+        if (values[i] >= minValue && values[i] <= maxValue) {
+            result.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    return result.size() - startSize;
+}
+
+} // namespace openspace::dataloader::kernels
@@ -25,6 +25,8 @@
 #include <openspace/data/csvloader.h>
 
 #include <openspace/data/datamapping.h>
+#include <openspace/data/parallelparsing.h>
+#include <openspace/util/memorymappedfile.h>
 #include <openspace/util/progressbar.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/file.h>
@@ -35,51 +37,309 @@
 #include <ghoul/misc/exception.h>
 #include <ghoul/misc/stringhelper.h>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cctype>
 #include <fstream>
 #include <functional>
+#include <set>
 #include <sstream>
 #include <string_view>
 
 namespace {
     constexpr std::string_view _loggerCat = "DataLoader: CSV";
-} // namespace
 
-namespace openspace::dataloader::csv {
+    // The number of rows that are parsed between two updates of the progress bar
+    constexpr size_t ProgressInterval = 4096;
 
-Dataset loadCsvFile(std::filesystem::path filePath, std::optional<DataMapping> specs) {
-    ghoul_assert(std::filesystem::exists(filePath), "File must exist");
+    using namespace openspace::dataloader;
+
+    // Describes what a column in the CSV file is used for
+    enum class ColumnUsage {
+        Skip = 0,
+        X,
+        Y,
+        Z,
+        Name,
+        Value
+    };
+
+    struct Column {
+        ColumnUsage usage = ColumnUsage::Skip;
+        // The index of the column in the resulting Dataset if the usage is `Value`
+        int valueIndex = -1;
+        bool isTexture = false;
+    };
+
+    // The result of parsing one chunk of the rows of the CSV file. The position and data
+    // values are written directly into the final Dataset, so only the values that cannot
+    // be placed in advance are stored here
+    struct CsvChunk {
+        // The index of the first row of this chunk in the final Dataset
+        size_t firstRow = 0;
+        size_t nRows = 0;
+
+        // The end of each row's comment in the commentPool
+        std::vector<uint64_t> commentEnds;
+        std::string commentPool;
+        float maxPositionComponent = 0.f;
+        std::set<int> textureIndices;
+    };
+
+    float readFloatData(std::string_view str) {
+        while (!str.empty() && std::isspace(static_cast<unsigned char>(str.front()))) {
+            str.remove_prefix(1);
+        }
+        if (!str.empty() && str.front() == '+') {
+            str.remove_prefix(1);
+        }
 
-    auto readFloatData = [](const std::string& str) -> float {
         float result = 0.f;
-#ifdef WIN32
-        auto [p, ec] = std::from_chars(str.data(), str.data() + str.size(), result);
+        auto [p, ec] = floatFromChars(str.data(), str.data() + str.size(), result);
         if (ec == std::errc() && std::isfinite(result)) {
             return result;
         }
         return std::numeric_limits<float>::quiet_NaN();
-#else // ^^^^ WIN32 // !WIN32 vvvv
-        // clang is missing float support for std::from_chars
-        try {
-            result = std::stof(str, nullptr);
-            if (std::isfinite(result)) {
-                return result;
+    }
+
+    // Returns the line that starts at the \p cursor without the line ending and moves the
+    // cursor to the beginning of the next line
+    std::string_view nextLine(std::string_view data, size_t& cursor) {
+        const size_t newline = data.find('\n', cursor);
+        const size_t end = newline == std::string_view::npos ? data.size() : newline;
+        std::string_view line = data.substr(cursor, end - cursor);
+        cursor = end + 1;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+
+    bool isEmptyLine(std::string_view line) {
+        return std::all_of(
+            line.begin(),
+            line.end(),
+            [](char c) { return std::isspace(static_cast<unsigned char>(c)); }
+        );
+    }
+
+    // Splits the line at all commas that are not inside quotes. The surrounding quotes of
+    // a quoted field are removed, but escaped quotes ("") inside of it are left in place
+    void tokenizeLine(std::string_view line, std::vector<std::string_view>& fields) {
+        fields.clear();
+
+        size_t cursor = 0;
+        while (true) {
+            if (cursor < line.size() && line[cursor] == '"') {
+                // Find the closing quote, skipping over escaped quotes
+                size_t end = cursor + 1;
+                while (end < line.size()) {
+                    if (line[end] == '"') {
+                        if (end + 1 < line.size() && line[end + 1] == '"') {
+                            end += 2;
+                            continue;
+                        }
+                        break;
+                    }
+                    end++;
+                }
+                fields.push_back(line.substr(cursor + 1, end - cursor - 1));
+
+                const size_t comma = line.find(',', end);
+                if (comma == std::string_view::npos) {
+                    return;
+                }
+                cursor = comma + 1;
+            }
+            else {
+                const size_t comma = line.find(',', cursor);
+                if (comma == std::string_view::npos) {
+                    fields.push_back(line.substr(std::min(cursor, line.size())));
+                    return;
+                }
+                fields.push_back(line.substr(cursor, comma - cursor));
+                cursor = comma + 1;
             }
         }
-        catch (const std::invalid_argument&) {}
-        return NAN;
-#endif // WIN32
-    };
+    }
+
+    // Appends the \p field to \p result and replaces all escaped quotes in the process
+    void appendUnescaped(std::string_view field, std::string& result) {
+        size_t quote = field.find("\"\"");
+        while (quote != std::string_view::npos) {
+            result += field.substr(0, quote + 1);
+            field.remove_prefix(quote + 2);
+            quote = field.find("\"\"");
+        }
+        result += field;
+    }
+
+    size_t countRows(std::string_view chunk) {
+        size_t nRows = 0;
+        size_t cursor = 0;
+        while (cursor < chunk.size()) {
+            if (!isEmptyLine(nextLine(chunk, cursor))) {
+                nRows++;
+            }
+        }
+        return nRows;
+    }
+
+    void parseCsvChunk(std::string_view chunk, const std::vector<Column>& columns,
+                       bool hasNameColumn, Dataset& dataset, CsvChunk& res,
+                       std::atomic<size_t>& nParsedRows,
+                       openspace::ProgressBar* progress)
+    {
+        ZoneScoped;
+
+        std::vector<std::string_view> fields;
+        size_t row = res.firstRow;
+        size_t cursor = 0;
+        while (cursor < chunk.size()) {
+            const std::string_view line = nextLine(chunk, cursor);
+            if (isEmptyLine(line)) {
+                continue;
+            }
+
+            tokenizeLine(line, fields);
+
+            glm::vec3 position = glm::vec3(0.f);
+            std::string_view comment;
+
+            // Rows that are shorter than the header keep the missing values that the
+            // columns were initialized with. Additional values are ignored
+            const size_t nFields = std::min(fields.size(), columns.size());
+            for (size_t i = 0; i < nFields; i++) {
+                const Column& column = columns[i];
+                switch (column.usage) {
+                    case ColumnUsage::Skip:
+                        // Excluded columns are never converted
+                        continue;
+                    case ColumnUsage::Name:
+                        // Note that were we use the original string value, rather than
+                        // the converted one
+                        comment = fields[i];
+                        continue;
+                    default:
+                        break;
+                }
+
+                // For now, all values are converted to float
+                const float value = readFloatData(fields[i]);
+
+                switch (column.usage) {
+                    case ColumnUsage::X:
+                        position.x = value;
+                        break;
+                    case ColumnUsage::Y:
+                        position.y = value;
+                        break;
+                    case ColumnUsage::Z:
+                        position.z = value;
+                        break;
+                    case ColumnUsage::Value:
+                        dataset.columns[column.valueIndex][row] = value;
+                        break;
+                    default:
+                        break;
+                }
+
+                if (column.isTexture) {
+                    res.textureIndices.emplace(static_cast<int>(value));
+                }
+            }
+
+            const glm::vec3 positive = glm::abs(position);
+            const float max = glm::compMax(positive);
+            if (max > res.maxPositionComponent) {
+                res.maxPositionComponent = max;
+            }
+            dataset.positions[row] = position;
+
+            if (hasNameColumn) {
+                appendUnescaped(comment, res.commentPool);
+            }
+            res.commentEnds.push_back(res.commentPool.size());
+
+            row++;
+            if ((row - res.firstRow) % ProgressInterval == 0) {
+                nParsedRows += ProgressInterval;
+                if (progress) {
+                    progress->print(static_cast<int>(nParsedRows.load()));
+                }
+            }
+        }
+    }
+} // namespace
+
+namespace openspace::dataloader::csv {
+
+Dataset loadCsvFile(std::filesystem::path filePath, std::optional<DataMapping> specs) {
+    ZoneScoped;
+
+    ghoul_assert(std::filesystem::exists(filePath), "File must exist");
 
     LDEBUG("Parsing CSV file");
 
-    std::vector<std::vector<std::string>> rows = ghoul::loadCSVFile(
-        filePath.string(),
-        true
+    // The file is mapped into memory and tokenized in place, so apart from the page
+    // cache, the only memory that is needed is the one for the resulting Dataset
+    MemoryMappedFile file;
+    try {
+        file = MemoryMappedFile(filePath);
+    }
+    catch (const ghoul::RuntimeError&) {
+        throw ghoul::RuntimeError(std::format(
+            "Failed to open CSV file '{}'", filePath
+        ));
+    }
+    const std::string_view content = std::string_view(
+        reinterpret_cast<const char*>(file.data().data()),
+        file.size()
+    );
+
+    // First non-empty row is the column names
+    size_t cursor = 0;
+    std::string_view header;
+    while (cursor < content.size() && isEmptyLine(header)) {
+        header = nextLine(content, cursor);
+    }
+    const std::string_view dataSection = content.substr(
+        std::min(cursor, content.size())
+    );
+
+    std::vector<std::string> columns;
+    {
+        std::vector<std::string_view> fields;
+        tokenizeLine(header, fields);
+        columns.reserve(fields.size());
+        for (std::string_view field : fields) {
+            std::string name;
+            appendUnescaped(field, name);
+            columns.push_back(std::move(name));
+        }
+    }
+
+    // Count the rows up front so that the values can be written directly into their
+    // final location. Counting is much cheaper than parsing, so this pays off by not
+    // having to copy the values of each chunk afterwards
+    const std::vector<std::string_view> chunks = splitIntoLineChunks(
+        dataSection,
+        parsingThreadCount(dataSection.size())
+    );
+    std::vector<CsvChunk> results = std::vector<CsvChunk>(chunks.size());
+    runInParallel(
+        chunks.size(),
+        [&chunks, &results](size_t i) { results[i].nRows = countRows(chunks[i]); }
     );
 
-    if (rows.size() < 2) {
+    size_t nRows = 0;
+    for (CsvChunk& chunk : results) {
+        chunk.firstRow = nRows;
+        nRows += chunk.nRows;
+    }
+
+    if (isEmptyLine(header) || nRows == 0) {
         LWARNING(std::format(
             "Error loading data file '{}'. No data items read", filePath
         ));
@@ -87,23 +347,15 @@ Dataset loadCsvFile(std::filesystem::path filePath, std::optional<DataMapping> s
     }
 
     Dataset res;
-    res.entries.reserve(rows.size() - 1);
-
-    // First row is the column names
-    const std::vector<std::string>& columns = rows.front();
 
+    std::vector<Column> columnUsage = std::vector<Column>(columns.size());
     int xColumn = -1;
     int yColumn = -1;
     int zColumn = -1;
     int nameColumn = -1;
-    int textureColumn = -1;
 
     int nDataColumns = 0;
     const bool hasExcludeColumns = specs.has_value() && specs->hasExcludeColumns();
-    std::vector<size_t> skipColumns;
-    if (hasExcludeColumns) {
-        skipColumns.reserve((*specs).excludeColumns.size());
-    }
 
     for (size_t i = 0; i < columns.size(); i++) {
         const std::string& col = columns[i];
@@ -123,16 +375,18 @@ Dataset loadCsvFile(std::filesystem::path filePath, std::optional<DataMapping> s
             nameColumn = static_cast<int>(i);
         }
         else if (hasExcludeColumns && specs->isExcludeColumn(col)) {
-            skipColumns.push_back(i);
             continue;
         }
         else {
             // Note that the texture column is also a regular column. Just save the index
             if (isTextureColumn(col, specs)) {
                 res.textureDataIndex = nDataColumns;
-                textureColumn = static_cast<int>(i);
+                columnUsage[i].isTexture = true;
             }
 
+            columnUsage[i].usage = ColumnUsage::Value;
+            columnUsage[i].valueIndex = nDataColumns;
+
             res.variables.push_back({
                 .index = nDataColumns,
                 .name = col
@@ -141,6 +395,20 @@ Dataset loadCsvFile(std::filesystem::path filePath, std::optional<DataMapping> s
         }
     }
 
+    // If a column is mapped more than once, the last one wins
+    if (xColumn >= 0) {
+        columnUsage[xColumn].usage = ColumnUsage::X;
+    }
+    if (yColumn >= 0) {
+        columnUsage[yColumn].usage = ColumnUsage::Y;
+    }
+    if (zColumn >= 0) {
+        columnUsage[zColumn].usage = ColumnUsage::Z;
+    }
+    if (nameColumn >= 0) {
+        columnUsage[nameColumn].usage = ColumnUsage::Name;
+    }
+
     // Some errors / warnings
     if (specs.has_value()) {
         bool hasAllProvided = specs->checkIfAllProvidedColumnsExist(columns);
@@ -175,64 +443,52 @@ Dataset loadCsvFile(std::filesystem::path filePath, std::optional<DataMapping> s
         ));
     }
 
-    LINFO(std::format("Loading {} rows with {} columns", rows.size(), columns.size()));
-    ProgressBar progress = ProgressBar(static_cast<int>(rows.size()));
-
-    std::set<int> uniqueTextureIndicesInData;
-
-    // Skip first row (column names)
-    for (size_t rowIdx = 1; rowIdx < rows.size(); ++rowIdx) {
-        const std::vector<std::string>& row = rows[rowIdx];
-
-        Dataset::Entry entry;
-        entry.data.reserve(nDataColumns);
-
-        for (size_t i = 0; i < row.size(); i++) {
-            // Check if column should be exluded. Note that list of indices is sorted
-            // so we can do a binary search
-            if (hasExcludeColumns &&
-                std::binary_search(skipColumns.begin(), skipColumns.end(), i))
-            {
-                continue;
-            }
-
-            const std::string& strValue = row[i];
-
-            // For now, all values are converted to float
-            const float value = readFloatData(strValue);
-
-            if (i == xColumn) {
-                entry.position.x = value;
-            }
-            else if (i == yColumn) {
-                entry.position.y = value;
-            }
-            else if (i == zColumn) {
-                entry.position.z = value;
-            }
-            else if (i == nameColumn) {
-                // Note that were we use the original stirng value, rather than the
-                // converted one
-                entry.comment = strValue;
-            }
-            else {
-                entry.data.push_back(value);
-            }
+    // Missing values stay NaN, which is also used for rows that are too short
+    res.positions.resize(nRows);
+    res.columns.resize(nDataColumns);
+    for (std::vector<float>& column : res.columns) {
+        column.resize(nRows, std::numeric_limits<float>::quiet_NaN());
+    }
 
-            if (i == textureColumn) {
-                uniqueTextureIndicesInData.emplace(static_cast<int>(value));
-            }
+    LINFO(std::format("Loading {} rows with {} columns", nRows, columns.size()));
+    ProgressBar progress = ProgressBar(static_cast<int>(nRows));
+    std::atomic<size_t> nParsedRows = 0;
+
+    runInParallel(
+        chunks.size(),
+        [&](size_t i) {
+            parseCsvChunk(
+                chunks[i],
+                columnUsage,
+                nameColumn >= 0,
+                res,
+                results[i],
+                nParsedRows,
+                // Only the calling thread is allowed to print the progress
+                i == 0 ? &progress : nullptr
+            );
         }
+    );
+    progress.print(static_cast<int>(nRows));
 
-        const glm::vec3 positive = glm::abs(entry.position);
-        const float max = glm::compMax(positive);
-        if (max > res.maxPositionComponent) {
-            res.maxPositionComponent = max;
+    // Merge the comments and the per-chunk information in order
+    std::set<int> uniqueTextureIndicesInData;
+    res.commentOffsets.reserve(nRows + 1);
+    for (CsvChunk& chunk : results) {
+        const uint64_t commentOffset = res.commentPool.size();
+        for (const uint64_t commentEnd : chunk.commentEnds) {
+            res.commentOffsets.push_back(commentOffset + commentEnd);
         }
+        res.commentPool += chunk.commentPool;
 
-        res.entries.push_back(entry);
+        res.maxPositionComponent = std::max(
+            res.maxPositionComponent,
+            chunk.maxPositionComponent
+        );
+        uniqueTextureIndicesInData.merge(chunk.textureIndices);
 
-        progress.print(static_cast<int>(rowIdx + 1));
+        // Release the memory of the chunk as soon as it has been merged
+        chunk = CsvChunk();
     }
 
     // Load the textures. Skip textures that are not included in the dataset
@@ -24,6 +24,7 @@
 
 #include <openspace/data/dataloader.h>
 
+#include <openspace/data/columnkernels.h>
 #include <openspace/data/csvloader.h>
 #include <openspace/data/speckloader.h>
 #include <ghoul/filesystem/cachemanager.h>
@@ -34,13 +35,15 @@
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/exception.h>
 #include <ghoul/misc/stringhelper.h>
+#include <array>
 #include <cctype>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <string_view>
 
 namespace {
-    constexpr int8_t DataCacheFileVersion = 13;
+    constexpr int8_t DataCacheFileVersion = 14;
     constexpr int8_t LabelCacheFileVersion = 11;
     constexpr int8_t ColorCacheFileVersion = 11;
 
@@ -51,6 +54,61 @@ namespace {
         }
     }
 
+    // The data cache file starts with this header, followed by the variables and
+    // textures. The positions, data values, comment offsets, and comments are then stored
+    // in separate sections that each start at a multiple of SectionAlignment bytes, which
+    // means that they can be used in place when the file is memory-mapped
+    constexpr uint64_t SectionAlignment = 16;
+
+    struct DataCacheHeader {
+        int8_t version = DataCacheFileVersion;
+        std::array<uint8_t, 7> padding = {};
+        uint64_t nEntries = 0;
+        uint32_t nValues = 0;
+        uint16_t nVariables = 0;
+        uint16_t nTextures = 0;
+        int16_t textureDataIndex = -1;
+        int16_t orientationDataIndex = -1;
+        float maxPositionComponent = 0.f;
+        uint64_t positionsOffset = 0;
+        uint64_t valuesOffset = 0;
+        uint64_t commentOffsetsOffset = 0;
+        uint64_t commentPoolOffset = 0;
+        uint64_t commentPoolSize = 0;
+        uint64_t fileSize = 0;
+    };
+    static_assert(sizeof(DataCacheHeader) == 80, "Unexpected padding in header");
+    static_assert(std::is_trivially_copyable_v<DataCacheHeader>);
+
+    constexpr uint64_t alignOffset(uint64_t offset) {
+        return (offset + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+    }
+
+    std::optional<std::string_view> commentAt(std::span<const uint64_t> offsets,
+                                              std::string_view pool, size_t entry)
+    {
+        if (entry + 1 >= offsets.size()) {
+            return std::nullopt;
+        }
+
+        const uint64_t begin = offsets[entry];
+        const uint64_t end = offsets[entry + 1];
+        if (begin >= end || end > pool.size()) {
+            return std::nullopt;
+        }
+        return pool.substr(begin, end - begin);
+    }
+
+    std::filesystem::path cachedFilePath(const std::filesystem::path& filePath,
+                          const std::optional<openspace::dataloader::DataMapping>& specs)
+    {
+        std::string info;
+        if (specs.has_value()) {
+            info = openspace::dataloader::generateHashString(*specs);
+        }
+        return FileSys.cacheManager()->cachedFilename(filePath, info);
+    }
+
     template <typename T>
     using LoadCacheFunc = std::function<std::optional<T>(std::filesystem::path)>;
 
@@ -77,14 +135,7 @@ namespace {
 
         ZoneScoped;
 
-        std::string info;
-        if (specs.has_value()) {
-            info = openspace::dataloader::generateHashString(*specs);
-        }
-        std::filesystem::path cached = FileSys.cacheManager()->cachedFilename(
-            filePath,
-            info
-        );
+        const std::filesystem::path cached = cachedFilePath(filePath, specs);
 
         if (std::filesystem::exists(cached)) {
             LINFOC(
@@ -105,7 +156,15 @@ namespace {
         LINFOC("DataLoader", std::format("Loading file '{}'", filePath));
         T dataset = loadFunction(filePath, specs);
 
-        if (!dataset.entries.empty()) {
+        bool hasEntries = false;
+        if constexpr (std::is_same_v<T, openspace::dataloader::Dataset>) {
+            hasEntries = dataset.size() > 0;
+        }
+        else {
+            hasEntries = !dataset.entries.empty();
+        }
+
+        if (hasEntries) {
             LINFOC("DataLoader", "Saving cache");
             saveCacheFunction(dataset, cached);
         }
@@ -150,169 +209,71 @@ Dataset loadFile(std::filesystem::path path, std::optional<DataMapping> specs) {
 std::optional<Dataset> loadCachedFile(const std::filesystem::path& path) {
     ZoneScoped;
 
-    std::ifstream file = std::ifstream(path, std::ios::binary);
-    if (!file.good()) {
-        return std::nullopt;
-    }
-
-    Dataset result;
-
-    int8_t fileVersion = 0;
-    file.read(reinterpret_cast<char*>(&fileVersion), sizeof(int8_t));
-    if (fileVersion != DataCacheFileVersion) {
-        // Incompatible version and we won't be able to read the file
+    std::optional<MappedDataset> mapped = mapCachedFile(path);
+    if (!mapped.has_value()) {
         return std::nullopt;
     }
+    return toDataset(mapped->view);
+}
 
-    //
-    // Read variables
-    uint16_t nVariables = 0;
-    file.read(reinterpret_cast<char*>(&nVariables), sizeof(uint16_t));
-    result.variables.resize(nVariables);
-    for (int i = 0; i < nVariables; i += 1) {
-        ZoneScopedN("Variable");
+void saveCachedFile(const Dataset& dataset, const std::filesystem::path& path) {
+    ZoneScoped;
 
-        Dataset::Variable var;
+    const DatasetView view = dataset.view();
 
-        int16_t idx = 0;
-        file.read(reinterpret_cast<char*>(&idx), sizeof(int16_t));
-        var.index = idx;
+    DataCacheHeader header;
 
-        uint16_t len = 0;
-        file.read(reinterpret_cast<char*>(&len), sizeof(uint16_t));
-        var.name.resize(len);
-        file.read(var.name.data(), len);
+    checkSize<uint16_t>(view.variables.size(), "Too many variables");
+    header.nVariables = static_cast<uint16_t>(view.variables.size());
+    checkSize<uint16_t>(view.textures.size(), "Too many textures");
+    header.nTextures = static_cast<uint16_t>(view.textures.size());
+    checkSize<int16_t>(view.textureDataIndex, "Texture index too large");
+    header.textureDataIndex = static_cast<int16_t>(view.textureDataIndex);
+    checkSize<int16_t>(view.orientationDataIndex, "Orientation index too large");
+    header.orientationDataIndex = static_cast<int16_t>(view.orientationDataIndex);
+    header.maxPositionComponent = view.maxPositionComponent;
 
-        result.variables[i] = std::move(var);
-    }
+    header.nEntries = static_cast<uint64_t>(view.size());
+    checkSize<uint32_t>(view.nValues(), "Too many data variables");
+    header.nValues = static_cast<uint32_t>(view.nValues());
 
     //
-    // Read textures
-    uint16_t nTextures = 0;
-    file.read(reinterpret_cast<char*>(&nTextures), sizeof(uint16_t));
-    result.textures.resize(nTextures);
-    for (int i = 0; i < nTextures; i += 1) {
-        ZoneScopedN("Texture");
-
-        Dataset::Texture tex;
-
-        int16_t idx = 0;
-        file.read(reinterpret_cast<char*>(&idx), sizeof(int16_t));
-        tex.index = idx;
-
-        uint16_t len = 0;
-        file.read(reinterpret_cast<char*>(&len), sizeof(uint16_t));
-        tex.file.resize(len);
-        file.read(tex.file.data(), len);
-
-        result.textures[i] = std::move(tex);
+    // Compute the layout of the file first, so that every section can be placed at an
+    // aligned offset
+    uint64_t metadataSize = 0;
+    for (const Dataset::Variable& var : view.variables) {
+        metadataSize += sizeof(int16_t) + sizeof(uint16_t) + var.name.size();
     }
-
-    //
-    // Read indices
-    int16_t texDataIdx = 0;
-    file.read(reinterpret_cast<char*>(&texDataIdx), sizeof(int16_t));
-    result.textureDataIndex = texDataIdx;
-
-    int16_t oriDataIdx = 0;
-    file.read(reinterpret_cast<char*>(&oriDataIdx), sizeof(int16_t));
-    result.orientationDataIndex = oriDataIdx;
-
-    //
-    // Read entries
-    uint64_t nEntries = 0;
-    file.read(reinterpret_cast<char*>(&nEntries), sizeof(uint64_t));
-    result.entries.reserve(nEntries);
-    for (uint64_t i = 0; i < nEntries; i += 1) {
-        Dataset::Entry e;
-        file.read(reinterpret_cast<char*>(&e.position.x), 3 * sizeof(float));
-
-        // For now we just store the length of the comment. Since the comments are stored
-        // in one block after the data entries, we can use the length later to extract the
-        // contents of this entries comment out of the big block
-        uint16_t len = 0;
-        file.read(reinterpret_cast<char*>(&len), sizeof(uint16_t));
-        if (len > 0) {
-            // If there is a comment, we already allocate the space for it here. This way
-            // we don't need to separately store the length of it, but can use the size of
-            // the vector instead
-            std::string comment;
-            comment.resize(len);
-            e.comment = std::move(comment);
-        }
-
-        result.entries.push_back(std::move(e));
+    for (const Dataset::Texture& tex : view.textures) {
+        metadataSize += sizeof(int16_t) + sizeof(uint16_t) + tex.file.size();
     }
 
-    //
-    // Read the data values next
-    uint16_t nValues = 0;
-    file.read(reinterpret_cast<char*>(&nValues), sizeof(uint16_t));
-    std::vector<float> entriesBuffer;
-    entriesBuffer.resize(nEntries * nValues);
-    file.read(
-        reinterpret_cast<char*>(entriesBuffer.data()),
-        nEntries * nValues * sizeof(float)
+    header.positionsOffset = alignOffset(sizeof(DataCacheHeader) + metadataSize);
+    header.valuesOffset = alignOffset(
+        header.positionsOffset + header.nEntries * sizeof(glm::vec3)
     );
-
-    //
-    // Read comments in one block and then assign them to the data entries
-    uint64_t totalCommentLength = 0;
-    file.read(reinterpret_cast<char*>(&totalCommentLength), sizeof(uint64_t));
-    std::vector<char> commentBuffer;
-    commentBuffer.resize(totalCommentLength);
-    file.read(commentBuffer.data(), totalCommentLength);
-
-    //
-    // Now we have the comments and the data values, we need to implant them into the
-    // data entries
-
-    // commentIdx is the running index into the total comment buffer
-    int commentIdx = 0;
-    int valuesIdx = 0;
-    for (Dataset::Entry& e : result.entries) {
-        e.data.resize(nValues);
-        std::memcpy(
-            e.data.data(),
-            entriesBuffer.data() + valuesIdx,
-            nValues * sizeof(float)
-        );
-        valuesIdx += nValues;
-
-        if (e.comment.has_value()) {
-            ghoul_assert(commentIdx < commentBuffer.size(), "Index too large");
-
-            // If we have a comment, we need to extract its length's worth of characters
-            // from the buffer
-            std::memcpy(e.comment->data(), &commentBuffer[commentIdx], e.comment->size());
-
-            // and then advance the index
-            commentIdx += static_cast<int>(e.comment->size());
-        }
-    }
-
-    //
-    // Read max data point variable
-    float max = 0.f;
-    file.read(reinterpret_cast<char*>(&max), sizeof(float));
-    result.maxPositionComponent = max;
-
-    return result;
-}
-
-void saveCachedFile(const Dataset& dataset, const std::filesystem::path& path) {
-    ZoneScoped;
+    header.commentOffsetsOffset = alignOffset(
+        header.valuesOffset + header.nEntries * header.nValues * sizeof(float)
+    );
+    header.commentPoolOffset = alignOffset(
+        header.commentOffsetsOffset + (header.nEntries + 1) * sizeof(uint64_t)
+    );
+    header.commentPoolSize = view.commentPool.size();
+    header.fileSize = header.commentPoolOffset + header.commentPoolSize;
 
     std::ofstream file = std::ofstream(path, std::ofstream::binary);
+    auto padTo = [&file](uint64_t offset) {
+        constexpr std::array<char, SectionAlignment> Zeros = {};
+        const uint64_t position = static_cast<uint64_t>(file.tellp());
+        ghoul_assert(position <= offset, "Sections overlap");
+        file.write(Zeros.data(), static_cast<std::streamsize>(offset - position));
+    };
 
-    file.write(reinterpret_cast<const char*>(&DataCacheFileVersion), sizeof(int8_t));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(DataCacheHeader));
 
     //
-    // Store variables
-    checkSize<uint16_t>(dataset.variables.size(), "Too many variables");
-    uint16_t nVariables = static_cast<uint16_t>(dataset.variables.size());
-    file.write(reinterpret_cast<const char*>(&nVariables), sizeof(uint16_t));
-    for (const Dataset::Variable& var : dataset.variables) {
+    // Store variables and textures
+    for (const Dataset::Variable& var : view.variables) {
         checkSize<int16_t>(var.index, "Variable index too large");
         int16_t idx = static_cast<int16_t>(var.index);
         file.write(reinterpret_cast<const char*>(&idx), sizeof(int16_t));
@@ -323,17 +284,11 @@ void saveCachedFile(const Dataset& dataset, const std::filesystem::path& path) {
         file.write(var.name.data(), len);
     }
 
-    //
-    // Store textures
-    checkSize<uint16_t>(dataset.textures.size(), "Too many textures");
-    uint16_t nTextures = static_cast<uint16_t>(dataset.textures.size());
-    file.write(reinterpret_cast<const char*>(&nTextures), sizeof(uint16_t));
-    for (const Dataset::Texture& tex : dataset.textures) {
+    for (const Dataset::Texture& tex : view.textures) {
         checkSize<int16_t>(tex.index, "Texture index too large");
         int16_t idx = static_cast<int16_t>(tex.index);
         file.write(reinterpret_cast<const char*>(&idx), sizeof(int16_t));
 
-
         checkSize<uint16_t>(tex.file.size(), "Texture file too long");
         uint16_t len = static_cast<uint16_t>(tex.file.size());
         file.write(reinterpret_cast<const char*>(&len), sizeof(uint16_t));
@@ -341,69 +296,29 @@ void saveCachedFile(const Dataset& dataset, const std::filesystem::path& path) {
     }
 
     //
-    // Store indices
-    checkSize<int16_t>(dataset.textureDataIndex, "Texture index too large");
-    int16_t texIdx = static_cast<int16_t>(dataset.textureDataIndex);
-    file.write(reinterpret_cast<const char*>(&texIdx), sizeof(int16_t));
-
-    checkSize<int16_t>(dataset.orientationDataIndex, "Orientation index too large");
-    int16_t orientationIdx = static_cast<int16_t>(dataset.orientationDataIndex);
-    file.write(reinterpret_cast<const char*>(&orientationIdx), sizeof(int16_t));
-
-    //
-    // Store entries
-    checkSize<uint64_t>(dataset.entries.size(), "Too many entries");
-    uint64_t nEntries = static_cast<uint64_t>(dataset.entries.size());
-    file.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint64_t));
-
-    // We assume the number of values for each dataset to be the same, so we can store
-    // them upfront
-    size_t nValuesF = dataset.entries.empty() ? 0 : dataset.entries[0].data.size();
-    checkSize<uint16_t>(nValuesF, "Too many data variables");
-    uint16_t nValues = static_cast<uint16_t>(nValuesF);
-    std::vector<float> valuesBuffer;
-    valuesBuffer.reserve(dataset.entries.size() * nValues);
-
-    uint64_t totalCommentLength = 0;
-    for (const Dataset::Entry& e : dataset.entries) {
-        file.write(reinterpret_cast<const char*>(&e.position.x), 3 * sizeof(float));
-
-        valuesBuffer.insert(valuesBuffer.end(), e.data.begin(), e.data.end());
-
-        if (e.comment.has_value()) {
-            checkSize<uint16_t>(e.comment->size(), "Comment too long");
-        }
-        uint16_t commentLen = e.comment.has_value() ?
-            static_cast<uint16_t>(e.comment->size()) :
-            0;
-        file.write(reinterpret_cast<const char*>(&commentLen), sizeof(uint16_t));
-        totalCommentLength += commentLen;
-    }
-
-    // Write all of the datavalues next
-    file.write(reinterpret_cast<const char*>(&nValues), sizeof(uint16_t));
+    // Store the positions and the data columns, which already have the file's layout
+    padTo(header.positionsOffset);
     file.write(
-        reinterpret_cast<const char*>(valuesBuffer.data()),
-        valuesBuffer.size() * sizeof(float)
+        reinterpret_cast<const char*>(view.positions.data()),
+        view.positions.size_bytes()
     );
 
-    //
-    // Write all of the comments next. We don't have to store the individual comment
-    // lengths as the data values written before already have those stored. And since we
-    // are reading the comments in the same order as the dataset entries, we're good
-    file.write(reinterpret_cast<const char*>(&totalCommentLength), sizeof(uint64_t));
-    for (const Dataset::Entry& e : dataset.entries) {
-        if (e.comment.has_value()) {
-            file.write(e.comment->data(), e.comment->size());
-        }
+    padTo(header.valuesOffset);
+    for (const std::span<const float>& column : view.columns) {
+        ghoul_assert(column.size() == view.size(), "Column has wrong size");
+        file.write(reinterpret_cast<const char*>(column.data()), column.size_bytes());
     }
 
     //
-    // Store max data point variable
+    // Store the comment offsets followed by the string pool that they index into
+    padTo(header.commentOffsetsOffset);
     file.write(
-        reinterpret_cast<const char*>(&dataset.maxPositionComponent),
-        sizeof(float)
+        reinterpret_cast<const char*>(view.commentOffsets.data()),
+        view.commentOffsets.size_bytes()
     );
+
+    padTo(header.commentPoolOffset);
+    file.write(view.commentPool.data(), view.commentPool.size());
 }
 
 Dataset loadFileWithCache(std::filesystem::path path, std::optional<DataMapping> specs) {
@@ -416,6 +331,204 @@ Dataset loadFileWithCache(std::filesystem::path path, std::optional<DataMapping>
     );
 }
 
+std::optional<MappedDataset> mapCachedFile(const std::filesystem::path& path) {
+    ZoneScoped;
+
+    if (!std::filesystem::is_regular_file(path)) {
+        return std::nullopt;
+    }
+
+    MappedDataset result;
+    try {
+        result.file = MemoryMappedFile(path);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LWARNINGC("DataLoader", e.message);
+        return std::nullopt;
+    }
+    const std::span<const std::byte> data = result.file.data();
+
+    if (data.size() < sizeof(DataCacheHeader)) {
+        return std::nullopt;
+    }
+    DataCacheHeader header;
+    std::memcpy(&header, data.data(), sizeof(DataCacheHeader));
+    if (header.version != DataCacheFileVersion || header.fileSize != data.size()) {
+        // Incompatible version or a truncated file, so we won't be able to use it
+        return std::nullopt;
+    }
+
+    // The counts are read from the file, so they have to be bounded by the file size
+    // before any of the section sizes are computed from them, as those could otherwise
+    // overflow
+    const bool hasValidCounts =
+        header.nEntries <= header.fileSize / sizeof(glm::vec3) &&
+        (header.nValues == 0 ||
+         header.nEntries <= header.fileSize / (header.nValues * sizeof(float)));
+    if (!hasValidCounts) {
+        return std::nullopt;
+    }
+
+    // Check that all sections are aligned and fit inside the file before handing out
+    // any views into it
+    auto isValidSection = [&header](uint64_t offset, uint64_t count, uint64_t size) {
+        return offset % SectionAlignment == 0 && offset <= header.fileSize &&
+            count <= (header.fileSize - offset) / size;
+    };
+    const bool isValid =
+        isValidSection(header.positionsOffset, header.nEntries, sizeof(glm::vec3)) &&
+        isValidSection(
+            header.valuesOffset,
+            header.nEntries * header.nValues,
+            sizeof(float)
+        ) &&
+        isValidSection(
+            header.commentOffsetsOffset,
+            header.nEntries + 1,
+            sizeof(uint64_t)
+        ) &&
+        isValidSection(header.commentPoolOffset, header.commentPoolSize, sizeof(char));
+    if (!isValid) {
+        return std::nullopt;
+    }
+
+    //
+    // Read variables and textures
+    size_t cursor = sizeof(DataCacheHeader);
+    using MetadataEntry = std::pair<int, std::string>;
+    auto readEntry = [&data, &cursor, &header]() -> std::optional<MetadataEntry> {
+        int16_t idx = 0;
+        uint16_t len = 0;
+        if (cursor + sizeof(int16_t) + sizeof(uint16_t) > header.positionsOffset) {
+            return std::nullopt;
+        }
+        std::memcpy(&idx, data.data() + cursor, sizeof(int16_t));
+        cursor += sizeof(int16_t);
+        std::memcpy(&len, data.data() + cursor, sizeof(uint16_t));
+        cursor += sizeof(uint16_t);
+        if (cursor + len > header.positionsOffset) {
+            return std::nullopt;
+        }
+        std::string value = std::string(
+            reinterpret_cast<const char*>(data.data() + cursor),
+            len
+        );
+        cursor += len;
+        return std::pair(idx, std::move(value));
+    };
+
+    result.variables.reserve(header.nVariables);
+    for (uint16_t i = 0; i < header.nVariables; i++) {
+        std::optional<MetadataEntry> entry = readEntry();
+        if (!entry.has_value()) {
+            return std::nullopt;
+        }
+        result.variables.push_back({ entry->first, std::move(entry->second) });
+    }
+
+    result.textures.reserve(header.nTextures);
+    for (uint16_t i = 0; i < header.nTextures; i++) {
+        std::optional<MetadataEntry> entry = readEntry();
+        if (!entry.has_value()) {
+            return std::nullopt;
+        }
+        result.textures.push_back({ entry->first, std::move(entry->second) });
+    }
+
+    //
+    // Create the view directly on top of the mapped sections
+    DatasetView& view = result.view;
+    view.variables = result.variables;
+    view.textures = result.textures;
+    view.textureDataIndex = header.textureDataIndex;
+    view.orientationDataIndex = header.orientationDataIndex;
+    view.maxPositionComponent = header.maxPositionComponent;
+    view.positions = std::span<const glm::vec3>(
+        reinterpret_cast<const glm::vec3*>(data.data() + header.positionsOffset),
+        header.nEntries
+    );
+    const float* values =
+        reinterpret_cast<const float*>(data.data() + header.valuesOffset);
+    view.columns.reserve(header.nValues);
+    for (uint32_t i = 0; i < header.nValues; i++) {
+        view.columns.emplace_back(values + i * header.nEntries, header.nEntries);
+    }
+    view.commentOffsets = std::span<const uint64_t>(
+        reinterpret_cast<const uint64_t*>(data.data() + header.commentOffsetsOffset),
+        header.nEntries + 1
+    );
+    view.commentPool = std::string_view(
+        reinterpret_cast<const char*>(data.data() + header.commentPoolOffset),
+        header.commentPoolSize
+    );
+
+    if (view.commentOffsets.front() != 0 ||
+        view.commentOffsets.back() != header.commentPoolSize)
+    {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+std::optional<MappedDataset> mapFileWithCache(std::filesystem::path path,
+                                              std::optional<DataMapping> specs)
+{
+    ZoneScoped;
+
+    const std::filesystem::path cached = cachedFilePath(path, specs);
+    if (std::filesystem::exists(cached)) {
+        LINFOC(
+            "DataLoader",
+            std::format("Cached file {} used for file {}", cached, path)
+        );
+
+        std::optional<MappedDataset> mapped = mapCachedFile(cached);
+        if (mapped.has_value()) {
+            return mapped;
+        }
+        else {
+            FileSys.cacheManager()->removeCacheFile(cached);
+        }
+    }
+
+    LINFOC("DataLoader", std::format("Loading file '{}'", path));
+    const Dataset dataset = loadFile(path, std::move(specs));
+    if (dataset.size() == 0) {
+        return std::nullopt;
+    }
+
+    LINFOC("DataLoader", "Saving cache");
+    saveCachedFile(dataset, cached);
+    return mapCachedFile(cached);
+}
+
+Dataset toDataset(const DatasetView& view) {
+    ZoneScoped;
+
+    Dataset result;
+    result.variables.assign(view.variables.begin(), view.variables.end());
+    result.textures.assign(view.textures.begin(), view.textures.end());
+    result.textureDataIndex = view.textureDataIndex;
+    result.orientationDataIndex = view.orientationDataIndex;
+    result.maxPositionComponent = view.maxPositionComponent;
+
+    result.positions.assign(view.positions.begin(), view.positions.end());
+    result.columns.reserve(view.columns.size());
+    for (const std::span<const float>& column : view.columns) {
+        result.columns.emplace_back(column.begin(), column.end());
+    }
+    if (!view.commentOffsets.empty()) {
+        result.commentOffsets.assign(
+            view.commentOffsets.begin(),
+            view.commentOffsets.end()
+        );
+    }
+    result.commentPool = view.commentPool;
+
+    return result;
+}
+
 } // namespace data
 
 namespace label {
@@ -538,16 +651,19 @@ Labelset loadFileWithCache(std::filesystem::path path) {
 }
 
 Labelset loadFromDataset(const Dataset& dataset) {
+    return loadFromDataset(dataset.view());
+}
+
+Labelset loadFromDataset(const DatasetView& dataset) {
     Labelset res;
-    res.entries.reserve(dataset.entries.size());
+    res.entries.reserve(dataset.size());
 
-    int count = 0;
-    for (const Dataset::Entry& entry : dataset.entries) {
+    for (size_t i = 0; i < dataset.size(); i++) {
         Labelset::Entry label;
-        label.position = entry.position;
-        label.text = entry.comment.value_or("MISSING LABEL");
+        label.position = dataset.positions[i];
+        label.text = std::string(dataset.comment(i).value_or("MISSING LABEL"));
         // @TODO: make is possible to configure this identifier?
-        label.identifier = std::format("Point-{}", count);
+        label.identifier = std::format("Point-{}", i);
         res.entries.push_back(std::move(label));
     }
 
@@ -698,8 +814,68 @@ ColorMap loadFileWithCache(std::filesystem::path path) {
 
 } // namespace color
 
+size_t Dataset::size() const {
+    return positions.size();
+}
+
 bool Dataset::isEmpty() const {
-    return variables.empty() || entries.empty();
+    return variables.empty() || positions.empty();
+}
+
+size_t Dataset::nValues() const {
+    return columns.size();
+}
+
+void Dataset::addEntry(const glm::vec3& position, std::span<const float> values,
+                       std::optional<std::string_view> comment)
+{
+    if (positions.empty() && columns.empty()) {
+        columns.resize(values.size());
+    }
+    ghoul_assert(values.size() == columns.size(), "Wrong number of values");
+
+    positions.push_back(position);
+    for (size_t i = 0; i < columns.size(); i++) {
+        columns[i].push_back(values[i]);
+    }
+
+    if (commentOffsets.empty()) {
+        commentOffsets.push_back(0);
+    }
+    if (comment.has_value()) {
+        commentPool += *comment;
+    }
+    commentOffsets.push_back(commentPool.size());
+}
+
+void Dataset::reserve(size_t nEntries) {
+    positions.reserve(nEntries);
+    for (std::vector<float>& column : columns) {
+        column.reserve(nEntries);
+    }
+    commentOffsets.reserve(nEntries + 1);
+}
+
+std::optional<std::string_view> Dataset::comment(size_t entry) const {
+    ghoul_assert(entry < size(), "Entry out of range");
+    return commentAt(commentOffsets, commentPool, entry);
+}
+
+DatasetView Dataset::view() const {
+    DatasetView res;
+    res.variables = variables;
+    res.textures = textures;
+    res.textureDataIndex = textureDataIndex;
+    res.orientationDataIndex = orientationDataIndex;
+    res.positions = positions;
+    res.columns.reserve(columns.size());
+    for (const std::vector<float>& column : columns) {
+        res.columns.emplace_back(column);
+    }
+    res.commentOffsets = commentOffsets;
+    res.commentPool = commentPool;
+    res.maxPositionComponent = maxPositionComponent;
+    return res;
 }
 
 int Dataset::index(std::string_view variableName) const {
@@ -714,65 +890,69 @@ int Dataset::index(std::string_view variableName) const {
 bool Dataset::normalizeVariable(std::string_view variableName) {
     const int idx = index(variableName);
 
-    if (idx == -1) {
+    if (idx == -1 || static_cast<size_t>(idx) >= columns.size()) {
         // We didn't find the variable that was specified
         return false;
     }
 
-    float minValue = std::numeric_limits<float>::max();
-    float maxValue = -std::numeric_limits<float>::max();
-    for (Dataset::Entry& e : entries) {
-        const float value = e.data[idx];
-        if (std::isnan(value)) {
-            continue;
-        }
-        minValue = std::min(minValue, value);
-        maxValue = std::max(maxValue, value);
-    }
-
-    for (Dataset::Entry& e : entries) {
-        const float value = e.data[idx];
-        if (std::isnan(value)) {
-            continue;
-        }
-        e.data[idx] = (value - minValue) / (maxValue - minValue);
-    }
-
+    const glm::vec2 range = kernels::findValueRange(columns[idx]);
+    kernels::normalize(columns[idx], range.x, range.y);
     return true;
 }
 
 glm::vec2 Dataset::findValueRange(int variableIndex) const {
-    if (entries.empty()) {
-        // Can't find range if there are no entries
-        return glm::vec2(0.f);
-    }
+    return view().findValueRange(variableIndex);
+}
+
+glm::vec2 Dataset::findValueRange(std::string_view variableName) const {
+    const int idx = index(variableName);
 
-    if (variableIndex >= entries[0].data.size()) {
-        // The index is not a valid variable index
+    if (idx == -1) {
+        // We didn't find the variable that was specified
         return glm::vec2(0.f);
     }
 
-    float minValue = std::numeric_limits<float>::max();
-    float maxValue = -std::numeric_limits<float>::max();
-    for (const Dataset::Entry& e : entries) {
-        if (!e.data.empty()) {
-            const float value = e.data[variableIndex];
-            if (std::isnan(value)) {
-                continue;
-            }
-            minValue = std::min(value, minValue);
-            maxValue = std::max(value, maxValue);
-        }
-        else {
-            minValue = 0.f;
-            maxValue = 0.f;
+    return findValueRange(idx);
+}
+
+size_t DatasetView::size() const {
+    return positions.size();
+}
+
+bool DatasetView::isEmpty() const {
+    return variables.empty() || positions.empty();
+}
+
+size_t DatasetView::nValues() const {
+    return columns.size();
+}
+
+std::optional<std::string_view> DatasetView::comment(size_t entry) const {
+    ghoul_assert(entry < size(), "Entry out of range");
+    return commentAt(commentOffsets, commentPool, entry);
+}
+
+int DatasetView::index(std::string_view variableName) const {
+    for (const Dataset::Variable& v : variables) {
+        if (v.name == variableName) {
+            return v.index;
         }
     }
+    return -1;
+}
+
+glm::vec2 DatasetView::findValueRange(int variableIndex) const {
+    if (positions.empty() || variableIndex < 0 ||
+        static_cast<size_t>(variableIndex) >= columns.size())
+    {
+        // Can't find range if there are no entries or the index is not valid
+        return glm::vec2(0.f);
+    }
 
-    return glm::vec2(minValue, maxValue);
+    return kernels::findValueRange(columns[variableIndex]);
 }
 
-glm::vec2 Dataset::findValueRange(std::string_view variableName) const {
+glm::vec2 DatasetView::findValueRange(std::string_view variableName) const {
     const int idx = index(variableName);
 
     if (idx == -1) {
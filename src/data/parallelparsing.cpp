@@ -0,0 +1,127 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/data/parallelparsing.h>
+
+#include <openspace/util/taskscheduler.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace {
+    // Below this number of bytes per thread, starting a thread costs more than it gains
+    constexpr size_t MinBytesPerThread = 4 * 1024 * 1024;
+} // namespace
+
+namespace openspace::dataloader {
+
+size_t parsingThreadCount(size_t nBytes) {
+    const size_t nHardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    return std::clamp<size_t>(nBytes / MinBytesPerThread, 1, nHardwareThreads);
+}
+
+std::vector<std::string_view> splitIntoLineChunks(std::string_view data, size_t nChunks) {
+    ghoul_assert(nChunks > 0, "Need at least one chunk");
+
+    std::vector<std::string_view> res;
+    res.reserve(nChunks);
+
+    const size_t chunkSize = data.size() / nChunks;
+    size_t begin = 0;
+    for (size_t i = 1; i < nChunks && begin < data.size(); i++) {
+        // Move the boundary forward to the next newline character, so that the line that
+        // would otherwise be split ends up in the current chunk
+        const size_t target = std::max(begin, i * chunkSize);
+        const size_t newline = data.find('\n', target);
+        if (newline == std::string_view::npos) {
+            break;
+        }
+        res.push_back(data.substr(begin, newline + 1 - begin));
+        begin = newline + 1;
+    }
+    if (begin < data.size() || res.empty()) {
+        res.push_back(data.substr(begin));
+    }
+
+    return res;
+}
+
+std::from_chars_result floatFromChars(const char* first, const char* last, float& value)
+{
+#ifdef WIN32
+    return std::from_chars(first, last, value);
+#else // ^^^^ WIN32 // !WIN32 vvvv
+    // clang is missing float support for std::from_chars. std::strtof requires a
+    // null-terminated string and accepts more than std::from_chars does, so only the
+    // characters that can be part of a decimal floating point value are passed to it
+    auto isFloatCharacter = [](char c) {
+        return (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' ||
+               c == 'e' || c == 'E';
+    };
+    const char* tokenEnd = first;
+    while (tokenEnd != last && isFloatCharacter(*tokenEnd)) {
+        tokenEnd++;
+    }
+    if (first == tokenEnd || *first == '+') {
+        // std::from_chars does not accept an explicit positive sign
+        return { first, std::errc::invalid_argument };
+    }
+
+    const std::string token = std::string(first, tokenEnd);
+    char* parsedEnd = nullptr;
+    errno = 0;
+    const float v = std::strtof(token.c_str(), &parsedEnd);
+    if (parsedEnd == token.c_str()) {
+        return { first, std::errc::invalid_argument };
+    }
+    const char* ptr = first + (parsedEnd - token.c_str());
+    if (errno == ERANGE) {
+        return { ptr, std::errc::result_out_of_range };
+    }
+    value = v;
+    return { ptr, std::errc() };
+#endif // WIN32
+}
+
+void runInParallel(size_t n, const std::function<void(size_t)>& function) {
+    // The calling thread parses one of the chunks, so one worker fewer than the number
+    // of chunks returned by parsingThreadCount is enough
+    static TaskScheduler scheduler(
+        std::max(std::thread::hardware_concurrency(), 2u) - 1
+    );
+    scheduler.parallelFor(
+        n,
+        1,
+        [&function](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                function(i);
+            }
+        }
+    );
+}
+
+} // namespace openspace::dataloader
@@ -24,6 +24,8 @@
 
 #include <openspace/data/speckloader.h>
 
+#include <openspace/data/parallelparsing.h>
+#include <openspace/util/memorymappedfile.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -32,6 +34,8 @@
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/stringhelper.h>
 #include <cctype>
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
 #include <functional>
 #include <sstream>
@@ -44,26 +48,230 @@ namespace {
         return (rhs.size() <= lhs.size()) && (lhs.substr(0, rhs.size()) == rhs);
     }
 
-    void strip(std::string& line) noexcept {
+    std::string_view strip(std::string_view line) noexcept {
         // 1. Remove all spaces from the beginning
         // 2. Remove #
         // 3. Remove all spaces from the new beginning
         // 4. Remove all spaces from the end
 
         while (!line.empty() && (line[0] == ' ' || line[0] == '\t')) {
-            line = line.substr(1);
+            line.remove_prefix(1);
         }
 
         if (!line.empty() && line[0] == '#') {
-            line = line.substr(1);
+            line.remove_prefix(1);
         }
 
         while (!line.empty() && (line[0] == ' ' || line[0] == '\t')) {
-            line = line.substr(1);
+            line.remove_prefix(1);
         }
 
         while (!line.empty() && (line.back() == ' ' || line.back() == '\t')) {
-            line = line.substr(0, line.size() - 1);
+            line.remove_suffix(1);
+        }
+
+        return line;
+    }
+
+    void strip(std::string& line) noexcept {
+        line = std::string(strip(std::string_view(line)));
+    }
+
+    bool isDigit(char c) {
+        return std::isdigit(static_cast<unsigned char>(c));
+    }
+
+    // Characters that are skipped by `std::istream::operator>>`
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+    }
+
+    void skipSpaces(const char*& p, const char* end) {
+        while (p != end && isSpace(*p)) {
+            p++;
+        }
+    }
+
+    // Parses a floating point value at the beginning of [p, end) and moves p past it.
+    // This accepts the same input and produces the same value as extracting a float from
+    // a std::istream, which is what the previous line-based parser used
+    bool parseFloat(const char*& p, const char* end, float& value) {
+        const char* begin = p;
+        if (begin != end && *begin == '+') {
+            // floatFromChars does not accept an explicit positive sign
+            begin++;
+        }
+        const char* digits = (begin != end && *begin == '-') ? begin + 1 : begin;
+        if (digits == end || !(isDigit(*digits) || *digits == '.')) {
+            // Streams don't accept the 'nan' or 'inf' spellings that std::from_chars does
+            return false;
+        }
+
+        auto [ptr, ec] = openspace::dataloader::floatFromChars(begin, end, value);
+        if (ec == std::errc::result_out_of_range) {
+            // Streams reject values that overflow, but accept the result of strtof for
+            // values that underflow
+            const std::string token = std::string(begin, ptr);
+            const float v = std::strtof(token.c_str(), nullptr);
+            if (std::isinf(v)) {
+                return false;
+            }
+            value = v;
+        }
+        else if (ec != std::errc()) {
+            return false;
+        }
+
+        p = ptr;
+        return true;
+    }
+
+    // The result of parsing one chunk of the data section of a speck file
+    struct SpeckChunk {
+        enum class Error {
+            None = 0,
+            Intermixed,
+            Position,
+            Value
+        };
+
+        std::vector<glm::vec3> positions;
+        std::vector<std::vector<float>> columns;
+        // The end of each entry's comment in the commentPool
+        std::vector<uint64_t> commentEnds;
+        std::string commentPool;
+        float maxPositionComponent = 0.f;
+
+        // The number of lines in this chunk, including the ones that were skipped
+        size_t nLines = 0;
+
+        // Information about the first error in this chunk, if there was one. The line is
+        // relative to the beginning of the chunk
+        Error error = Error::None;
+        size_t errorLine = 0;
+        int errorValueIndex = 0;
+    };
+
+    void parseSpeckChunk(std::string_view chunk, int nDataValues,
+                         std::optional<float> missingDataValue, SpeckChunk& res)
+    {
+        ZoneScoped;
+
+        res.columns.resize(nDataValues);
+        std::vector<float> values = std::vector<float>(nDataValues);
+
+        size_t cursor = 0;
+        while (cursor < chunk.size()) {
+            const size_t newline = chunk.find('\n', cursor);
+            const size_t lineEnd = newline == std::string_view::npos ?
+                chunk.size() :
+                newline;
+            std::string_view line = chunk.substr(cursor, lineEnd - cursor);
+            cursor = lineEnd + 1;
+
+            const size_t lineIndex = res.nLines;
+            res.nLines++;
+
+            // Ignore empty line or commented-out lines
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+
+            // Guard against wrong line endings (copying files from Windows to Mac) causes
+            // lines to have a final \r
+            if (line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+
+            line = strip(line);
+
+            if (line.empty()) {
+                continue;
+            }
+
+            if (!isDigit(line[0]) && line[0] != '-') {
+                res.error = SpeckChunk::Error::Intermixed;
+                res.errorLine = lineIndex;
+                return;
+            }
+
+            const char* p = line.data();
+            const char* end = line.data() + line.size();
+
+            bool allZero = true;
+
+            // For SPECK we know that the first 3 values are the position, so no need to
+            // check agains data mapping
+            glm::vec3 position = glm::vec3(0.f);
+            bool isValidPosition = true;
+            for (int i = 0; i < 3 && isValidPosition; i++) {
+                skipSpaces(p, end);
+                isValidPosition = parseFloat(p, end, position[i]);
+            }
+            allZero &= (position == glm::vec3(0.0));
+
+            const glm::vec3 positive = glm::abs(position);
+            const float max = glm::compMax(positive);
+            if (max > res.maxPositionComponent) {
+                res.maxPositionComponent = max;
+            }
+
+            // The stream-based parser also treated a line that ends directly after the
+            // position as an error, as the stream would no longer be good
+            if (!isValidPosition || p == end) {
+                res.error = SpeckChunk::Error::Position;
+                res.errorLine = lineIndex;
+                return;
+            }
+
+            for (int i = 0; i < nDataValues; i += 1) {
+                skipSpaces(p, end);
+                const char* tokenBegin = p;
+                while (p != end && !isSpace(*p)) {
+                    p++;
+                }
+                const std::string_view value = std::string_view(tokenBegin, p);
+
+                if (value == "nan" || value == "NaN") {
+                    values[i] = std::numeric_limits<float>::quiet_NaN();
+                    continue;
+                }
+
+                const char* valueBegin = tokenBegin;
+                values[i] = 0.f;
+                const bool success = parseFloat(valueBegin, p, values[i]);
+
+                // Check if value corresponds to a missing value
+                if (missingDataValue.has_value()) {
+                    const float diff = std::abs(values[i] - *missingDataValue);
+                    if (diff < std::numeric_limits<float>::epsilon()) {
+                        values[i] = std::numeric_limits<float>::quiet_NaN();
+                    }
+                }
+
+                allZero &= (values[i] == 0.0);
+                if (!success) {
+                    res.error = SpeckChunk::Error::Value;
+                    res.errorLine = lineIndex;
+                    res.errorValueIndex = i;
+                    return;
+                }
+            }
+
+            if (allZero) {
+                continue;
+            }
+
+            res.positions.push_back(position);
+            for (int i = 0; i < nDataValues; i += 1) {
+                res.columns[i].push_back(values[i]);
+            }
+
+            const std::string_view rest = std::string_view(p, end);
+            if (!rest.empty()) {
+                res.commentPool += strip(rest);
+            }
+            res.commentEnds.push_back(res.commentPool.size());
         }
     }
 
@@ -72,21 +280,41 @@ namespace {
 namespace openspace::dataloader::speck {
 
 Dataset loadSpeckFile(std::filesystem::path path, std::optional<DataMapping> specs) {
+    ZoneScoped;
+
     ghoul_assert(std::filesystem::exists(path), "File must exist");
 
-    std::ifstream file(path);
-    if (!file.good()) {
+    MemoryMappedFile file;
+    try {
+        file = MemoryMappedFile(path);
+    }
+    catch (const ghoul::RuntimeError&) {
         throw ghoul::RuntimeError(std::format("Failed to open speck file '{}'", path));
     }
+    const std::string_view content = std::string_view(
+        reinterpret_cast<const char*>(file.data().data()),
+        file.size()
+    );
 
     Dataset res;
 
     int nDataValues = 0;
     int currentLineNumber = 0;
 
+    // The offset in the file at which the data section starts
+    size_t dataOffset = content.size();
+    size_t cursor = 0;
+
     std::string line;
     // First phase: Loading the header information
-    while (ghoul::getline(file, line)) {
+    while (cursor < content.size()) {
+        const size_t lineStart = cursor;
+        const size_t newline = content.find('\n', cursor);
+        const size_t lineEnd = newline == std::string_view::npos ?
+            content.size() :
+            newline;
+        line = std::string(content.substr(lineStart, lineEnd - lineStart));
+        cursor = lineEnd + 1;
         currentLineNumber++;
 
         // Guard against wrong line endings (copying files from Windows to Mac) causes
@@ -105,6 +333,8 @@ Dataset loadSpeckFile(std::filesystem::path path, std::optional<DataMapping> spe
         // If the first character is a digit, we have left the preamble and are in the
         // data section of the file
         if (std::isdigit(line[0]) || line[0] == '-') {
+            dataOffset = lineStart;
+            currentLineNumber--;
             break;
         }
 
@@ -246,127 +476,90 @@ Dataset loadSpeckFile(std::filesystem::path path, std::optional<DataMapping> spe
         }
     );
 
-    // For the first line, we already loaded it and rejected it above, so if we do another
-    // ghoul::getline, we'd miss the first data value line
-    bool isFirst = true;
-    while (isFirst || ghoul::getline(file, line)) {
-        currentLineNumber++;
-        isFirst = false;
-
-        // Ignore empty line or commented-out lines
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
-
-        strip(line);
-
-        if (line.empty()) {
-            continue;
-        }
-
-        // If the first character is a digit, we have left the preamble and are in the
-        // data section of the file
-        if (!std::isdigit(line[0]) && line[0] != '-') {
-            throw ghoul::RuntimeError(std::format(
-                "Error loading speck file '{}': Header information and datasegment "
-                "intermixed", path
-            ));
-        }
-
-        bool allZero = true;
+    //
+    // Second phase: Parse the data section in chunks that only contain complete lines
+    const std::string_view dataSection = content.substr(dataOffset);
+    const std::vector<std::string_view> chunks = splitIntoLineChunks(
+        dataSection,
+        parsingThreadCount(dataSection.size())
+    );
 
-        // For SPECK we know that the first 3 values are the position, so no need to
-        // check agains data mapping
-        std::stringstream str(line);
-        Dataset::Entry entry;
-        str >> entry.position.x >> entry.position.y >> entry.position.z;
-        allZero &= (entry.position == glm::vec3(0.0));
+    std::optional<float> missingDataValue;
+    if (specs.has_value()) {
+        missingDataValue = specs->missingDataValue;
+    }
 
-        const glm::vec3 positive = glm::abs(entry.position);
-        const float max = glm::compMax(positive);
-        if (max > res.maxPositionComponent) {
-            res.maxPositionComponent = max;
+    std::vector<SpeckChunk> results = std::vector<SpeckChunk>(chunks.size());
+    runInParallel(
+        chunks.size(),
+        [&chunks, &results, nDataValues, missingDataValue](size_t i) {
+            parseSpeckChunk(chunks[i], nDataValues, missingDataValue, results[i]);
         }
+    );
 
-        if (!str.good()) {
-            // Need to subtract one of the line number here as we increase the current
-            // line count in the beginning of the while loop we are currently in
-            throw ghoul::RuntimeError(std::format(
-                "Error loading position information out of data line {} in file '{}'. "
-                "Value was not a number",
-                currentLineNumber - 1, path
-            ));
+    // Report the first error in file order. The chunks stop at their first error, so
+    // the line count of all chunks before the first erroneous one is complete
+    size_t lineOffset = static_cast<size_t>(currentLineNumber);
+    size_t nEntries = 0;
+    for (const SpeckChunk& chunk : results) {
+        const size_t lineNumber = lineOffset + chunk.errorLine + 1;
+        switch (chunk.error) {
+            case SpeckChunk::Error::None:
+                break;
+            case SpeckChunk::Error::Intermixed:
+                throw ghoul::RuntimeError(std::format(
+                    "Error loading speck file '{}': Header information and datasegment "
+                    "intermixed", path
+                ));
+            case SpeckChunk::Error::Position:
+                throw ghoul::RuntimeError(std::format(
+                    "Error loading position information out of data line {} in file "
+                    "'{}'. Value was not a number",
+                    lineNumber, path
+                ));
+            case SpeckChunk::Error::Value:
+                throw ghoul::RuntimeError(std::format(
+                    "Error loading data value {} out of data line {} in file '{}'. "
+                    "Value was not a number",
+                    chunk.errorValueIndex, lineNumber, path
+                ));
         }
+        lineOffset += chunk.nLines;
+        nEntries += chunk.positions.size();
+    }
 
-        entry.data.resize(nDataValues);
-        std::stringstream valueStream;
+    //
+    // Third phase: Merge the chunks in order
+    res.columns.resize(nDataValues);
+    res.reserve(nEntries);
+    for (SpeckChunk& chunk : results) {
+        res.positions.insert(
+            res.positions.end(),
+            chunk.positions.begin(),
+            chunk.positions.end()
+        );
         for (int i = 0; i < nDataValues; i += 1) {
-            std::string value;
-            str >> value;
-            if (value == "nan" || value == "NaN") {
-                entry.data[i] = std::numeric_limits<float>::quiet_NaN();
-            }
-            else {
-                valueStream.clear();
-                valueStream.str(value);
-                valueStream >> entry.data[i];
-
-                // Check if value corresponds to a missing value
-                if (specs.has_value() && specs->missingDataValue.has_value()) {
-                    const float missingDataValue = specs->missingDataValue.value();
-                    const float diff = std::abs(entry.data[i] - missingDataValue);
-                    if (diff < std::numeric_limits<float>::epsilon()) {
-                        entry.data[i] = std::numeric_limits<float>::quiet_NaN();
-                    }
-                }
-
-                allZero &= (entry.data[i] == 0.0);
-                if (valueStream.fail()) {
-                    // Need to subtract one of the line number here as we increase the
-                    // current line count in the beginning of the while loop we are
-                    // currently in
-                    throw ghoul::RuntimeError(std::format(
-                        "Error loading data value {} out of data line {} in file '{}'. "
-                        "Value was not a number",
-                        i, currentLineNumber - 1, path
-                    ));
-                }
-            }
-        }
-
-        if (allZero) {
-            continue;
+            res.columns[i].insert(
+                res.columns[i].end(),
+                chunk.columns[i].begin(),
+                chunk.columns[i].end()
+            );
         }
 
-        std::string rest;
-        ghoul::getline(str, rest);
-        if (!rest.empty()) {
-
-            strip(rest);
-            entry.comment = rest;
+        const uint64_t commentOffset = res.commentPool.size();
+        for (const uint64_t commentEnd : chunk.commentEnds) {
+            res.commentOffsets.push_back(commentOffset + commentEnd);
         }
+        res.commentPool += chunk.commentPool;
 
-        res.entries.push_back(std::move(entry));
-    }
+        res.maxPositionComponent = std::max(
+            res.maxPositionComponent,
+            chunk.maxPositionComponent
+        );
 
-#ifdef _DEBUG
-    if (!res.entries.empty()) {
-        size_t nValues = res.entries[0].data.size();
-        ghoul_assert(nDataValues == nValues, "nDataValues calculation went wrong");
-        for (const Dataset::Entry& e : res.entries) {
-            ghoul_assert(
-                e.data.size() == nDataValues,
-                "Row had different number of data values"
-            );
-        }
+        // Release the memory of the chunk as soon as it has been merged
+        chunk = SpeckChunk();
     }
-#endif
 
     return res;
 }
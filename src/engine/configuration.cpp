@@ -167,6 +167,25 @@ namespace {
         // master computer does not have the resources to render a scene
         std::optional<bool> disableRenderingOnMaster;
 
+        // If this value is set to 'true', the master in a multi-application setup only
+        // sends the parts of the synchronized state that have changed since the previous
+        // frame, which reduces the amount of data that is sent to the clients every frame
+        std::optional<bool> deltaSynchronization;
+
+        // The number of frames between two full, checksummed copies of the synchronized
+        // state when 'DeltaSynchronization' is enabled. Clients that missed a frame are
+        // resynchronized with the next of these keyframes
+        std::optional<int> synchronizationKeyframeInterval [[codegen::greater(0)]];
+
+        // If this value is set to 'true', positions and rotations that are requested
+        // from SPICE are approximated by polynomials that are fitted to a few samples of
+        // the exact values, rather than computing the exact value for every request
+        std::optional<bool> ephemerisCache;
+
+        // The maximum error, in meters, of positions that are computed through the
+        // cache when 'EphemerisCache' is enabled
+        std::optional<double> ephemerisCacheTolerance [[codegen::greater(0.0)]];
+
         // Applies a global view rotation. Use this to rotate the position of the focus
         // node away from the default location on the screen. This setting persists even
         // when a new focus node is selected. Defined using roll, pitch, yaw in radians
@@ -408,6 +427,10 @@ ghoul::Dictionary Configuration::createDictionary() {
     res.setValue("OnScreenTextScaling", onScreenTextScaling);
     res.setValue("UsePerProfileCache", usePerProfileCache);
     res.setValue("IsRenderingOnMasterDisabled", isRenderingOnMasterDisabled);
+    res.setValue("UseDeltaSynchronization", useDeltaSynchronization);
+    res.setValue("SynchronizationKeyframeInterval", synchronizationKeyframeInterval);
+    res.setValue("UseEphemerisCache", useEphemerisCache);
+    res.setValue("EphemerisCacheTolerance", ephemerisCacheTolerance);
     res.setValue("GlobalRotation", static_cast<glm::dvec3>(globalRotation));
     res.setValue("ScreenSpaceRotation", static_cast<glm::dvec3>(screenSpaceRotation));
     res.setValue("MasterRotation", static_cast<glm::dvec3>(masterRotation));
@@ -566,6 +589,14 @@ void parseLuaState(Configuration& configuration) {
     c.usePerProfileCache = p.perProfileCache.value_or(c.usePerProfileCache);
     c.isRenderingOnMasterDisabled =
         p.disableRenderingOnMaster.value_or(c.isRenderingOnMasterDisabled);
+    c.useDeltaSynchronization =
+        p.deltaSynchronization.value_or(c.useDeltaSynchronization);
+    c.synchronizationKeyframeInterval = p.synchronizationKeyframeInterval.value_or(
+        c.synchronizationKeyframeInterval
+    );
+    c.useEphemerisCache = p.ephemerisCache.value_or(c.useEphemerisCache);
+    c.ephemerisCacheTolerance =
+        p.ephemerisCacheTolerance.value_or(c.ephemerisCacheTolerance);
     c.globalRotation = p.globalRotation.value_or(c.globalRotation);
     c.masterRotation = p.masterRotation.value_or(c.masterRotation);
     c.screenSpaceRotation = p.screenSpaceRotation.value_or(c.screenSpaceRotation);
@@ -267,6 +267,14 @@ void OpenSpaceEngine::initialize() {
     _printEvents = global::configuration->isPrintingEvents;
     _visibility = static_cast<int>(global::configuration->propertyVisibility);
 
+    if (global::configuration->useEphemerisCache) {
+        EphemerisCache::Settings settings;
+        // The tolerance is specified in meters, but SPICE uses kilometers
+        settings.positionTolerance = global::configuration->ephemerisCacheTolerance /
+                                     1000.0;
+        SpiceManager::ref().setEphemerisCacheEnabled(true, std::move(settings));
+    }
+
     std::string cacheFolder = absPath("${CACHE}").string();
     if (global::configuration->usePerProfileCache) {
         cacheFolder = cacheFolder + "-" + global::configuration->profile;
@@ -794,6 +802,10 @@ void OpenSpaceEngine::loadAssets() {
 
     global::renderEngine->updateScene();
 
+    global::syncEngine->setDeltaEncoding(
+        global::configuration->useDeltaSynchronization,
+        global::configuration->synchronizationKeyframeInterval
+    );
     global::syncEngine->addSyncables(global::timeManager->syncables());
     if (_scene && _scene->camera()) {
         global::syncEngine->addSyncables(_scene->camera()->syncables());
@@ -1414,16 +1426,16 @@ void OpenSpaceEngine::handleDragDrop(std::filesystem::path file) {
     );
 }
 
-std::vector<std::byte> OpenSpaceEngine::encode() {
+std::span<const std::byte> OpenSpaceEngine::encode() {
     ZoneScoped;
 
     return global::syncEngine->encodeSyncables();
 }
 
-void OpenSpaceEngine::decode(std::vector<std::byte> data) {
+void OpenSpaceEngine::decode(std::span<const std::byte> data) {
     ZoneScoped;
 
-    global::syncEngine->decodeSyncables(std::move(data));
+    global::syncEngine->decodeSyncables(data);
 }
 
 properties::Property::Visibility OpenSpaceEngine::visibility() const {
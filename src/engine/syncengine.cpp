@@ -25,9 +25,43 @@
 #include <openspace/engine/syncengine.h>
 
 #include <openspace/util/syncdata.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/profiling.h>
 #include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr std::string_view _loggerCat = "SyncEngine";
+
+    template <typename T>
+    void append(std::vector<std::byte>& buffer, T value) {
+        const size_t offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+    template <typename T>
+    bool read(std::span<const std::byte> data, size_t& offset, T& value) {
+        if (offset + sizeof(T) > data.size()) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    // 64-bit FNV-1a. Passing the result of one call as the `hash` of the next call
+    // results in the checksum of the concatenated data
+    constexpr uint64_t ChecksumSeed = 14695981039346656037ULL;
+    uint64_t checksum(std::span<const std::byte> data, uint64_t hash = ChecksumSeed) {
+        for (const std::byte b : data) {
+            hash ^= static_cast<uint64_t>(b);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+} // namespace
 
 namespace openspace {
 
@@ -38,19 +72,93 @@ SyncEngine::SyncEngine(unsigned int syncBufferSize)
 }
 
 // Should be called on sgct master
-std::vector<std::byte> SyncEngine::encodeSyncables() {
+std::span<const std::byte> SyncEngine::encodeSyncables() {
+    ZoneScoped;
+
+    // The previous frame is only discarded now, since the returned view points into the
+    // buffers. Resetting them keeps their memory, so no allocation happens once they
+    // have grown to the size of the synchronized state
+    _syncBuffer.reset();
+
+    if (_useDeltaEncoding) {
+        return encodeDelta();
+    }
+
+    // Encoding the frame type first lets the SyncBuffer's memory be sent as is
+    _syncBuffer.encode(FrameType::Full);
     for (Syncable* syncable : _syncables) {
         syncable->encode(&_syncBuffer);
     }
+    return _syncBuffer.data();
+}
 
-    std::vector<std::byte> data = _syncBuffer.data();
-    _syncBuffer.reset();
+std::span<const std::byte> SyncEngine::encodeDelta() {
+    _syncableOffsets.clear();
+    for (Syncable* syncable : _syncables) {
+        _syncableOffsets.push_back(_syncBuffer.data().size());
+        syncable->encode(&_syncBuffer);
+    }
+    _syncableOffsets.push_back(_syncBuffer.data().size());
+    const std::span<const std::byte> encoded = _syncBuffer.data();
+
+    const bool isKeyframe =
+        _forceKeyframe || _frameNumber % static_cast<uint32_t>(_keyframeInterval) == 0;
+    _forceKeyframe = false;
+    _syncableState.resize(_syncables.size());
+
+    // Layout: frame type, frame number, number of syncables, number of entries, entries
+    // of (syncable index, size, bytes), checksum of the full state
+    std::vector<std::byte>& data = _encodedFrame;
+    data.clear();
+    data.push_back(static_cast<std::byte>(
+        isKeyframe ? FrameType::Keyframe : FrameType::Delta
+    ));
+    append(data, _frameNumber);
+    append(data, static_cast<uint32_t>(_syncables.size()));
+    const size_t nEntriesOffset = data.size();
+    append(data, uint32_t(0));
+
+    uint32_t nEntries = 0;
+    for (size_t i = 0; i < _syncables.size(); i++) {
+        const std::span<const std::byte> bytes = encoded.subspan(
+            _syncableOffsets[i],
+            _syncableOffsets[i + 1] - _syncableOffsets[i]
+        );
+        std::vector<std::byte>& state = _syncableState[i];
+        const bool hasChanged = isKeyframe ||
+            !std::equal(bytes.begin(), bytes.end(), state.begin(), state.end());
+        if (!hasChanged) {
+            continue;
+        }
+
+        state.assign(bytes.begin(), bytes.end());
+        append(data, static_cast<uint32_t>(i));
+        append(data, static_cast<uint32_t>(bytes.size()));
+        data.insert(data.end(), bytes.begin(), bytes.end());
+        nEntries++;
+    }
+    std::memcpy(data.data() + nEntriesOffset, &nEntries, sizeof(uint32_t));
+    append(data, checksum(encoded));
+
+    _frameNumber++;
     return data;
 }
 
 // Should be called on sgct clients
-void SyncEngine::decodeSyncables(std::vector<std::byte> data) {
-    _syncBuffer.setData(std::move(data));
+void SyncEngine::decodeSyncables(std::span<const std::byte> data) {
+    ZoneScoped;
+
+    if (data.empty()) {
+        return;
+    }
+
+    const FrameType type = static_cast<FrameType>(data[0]);
+    if (type != FrameType::Full) {
+        decodeDelta(type, data.subspan(1));
+        return;
+    }
+
+    _syncBuffer.setData(data.subspan(1));
     for (Syncable* syncable : _syncables) {
         syncable->decode(&_syncBuffer);
     }
@@ -58,6 +166,112 @@ void SyncEngine::decodeSyncables(std::vector<std::byte> data) {
     _syncBuffer.reset();
 }
 
+void SyncEngine::decodeDelta(FrameType type, std::span<const std::byte> data) {
+    const bool isKeyframe = type == FrameType::Keyframe;
+
+    size_t offset = 0;
+    uint32_t frameNumber = 0;
+    uint32_t nSyncables = 0;
+    uint32_t nEntries = 0;
+    bool isValid = read(data, offset, frameNumber) && read(data, offset, nSyncables) &&
+        read(data, offset, nEntries);
+    if (!isValid || nSyncables != _syncables.size()) {
+        LERROR(std::format(
+            "Received synchronization data for {} syncables, but {} are registered",
+            nSyncables, _syncables.size()
+        ));
+        _isInSync = false;
+        return;
+    }
+
+    if (!isKeyframe && !_hasReceivedKeyframe) {
+        // A delta frame can only be applied to a state that was verified before
+        _isInSync = false;
+    }
+    else if (!isKeyframe && frameNumber != _frameNumber + 1 && _isInSync) {
+        LWARNING(std::format(
+            "Missed synchronization frames {} to {}, waiting for the next keyframe",
+            _frameNumber + 1, frameNumber - 1
+        ));
+        _isInSync = false;
+    }
+    _frameNumber = frameNumber;
+    _syncableState.resize(_syncables.size());
+
+    for (uint32_t i = 0; i < nEntries && isValid; i++) {
+        uint32_t index = 0;
+        uint32_t size = 0;
+        isValid = read(data, offset, index) && read(data, offset, size) &&
+            index < _syncableState.size() && offset + size <= data.size();
+        if (isValid) {
+            const std::span<const std::byte> bytes = data.subspan(offset, size);
+            _syncableState[index].assign(bytes.begin(), bytes.end());
+            offset += size;
+        }
+    }
+
+    uint64_t expectedChecksum = 0;
+    isValid = isValid && read(data, offset, expectedChecksum);
+    if (!isValid) {
+        LERROR("Received malformed synchronization data");
+        _isInSync = false;
+        return;
+    }
+
+    uint64_t stateChecksum = ChecksumSeed;
+    for (const std::vector<std::byte>& state : _syncableState) {
+        stateChecksum = checksum(state, stateChecksum);
+    }
+
+    if (stateChecksum != expectedChecksum) {
+        if (isKeyframe) {
+            // A keyframe contains the full state, so it has to be corrupted
+            LERROR(std::format("Synchronization keyframe {} is corrupted", frameNumber));
+            _isInSync = false;
+            return;
+        }
+        if (_isInSync) {
+            LWARNING("Synchronization state diverged, waiting for the next keyframe");
+            _isInSync = false;
+        }
+    }
+    else if (isKeyframe) {
+        if (!_isInSync) {
+            LINFO(std::format("Resynchronized at frame {}", frameNumber));
+        }
+        _isInSync = true;
+        _hasReceivedKeyframe = true;
+    }
+
+    if (!_isInSync) {
+        // The state is stale or incomplete, so decoding it would replay values that the
+        // master has already moved past, such as scripts. The Syncables keep the last
+        // verified state until a keyframe arrives
+        return;
+    }
+
+    // Each Syncable decodes its latest state every frame, regardless of whether it was
+    // part of this frame, which produces the same result as sending the full state
+    for (size_t i = 0; i < _syncables.size(); i++) {
+        _syncBuffer.setData(std::span<const std::byte>(_syncableState[i]));
+        _syncables[i]->decode(&_syncBuffer);
+    }
+
+    _syncBuffer.reset();
+}
+
+void SyncEngine::setDeltaEncoding(bool enabled, int keyframeInterval) {
+    ghoul_assert(keyframeInterval > 0, "keyframeInterval must be bigger than 0");
+
+    _useDeltaEncoding = enabled;
+    _keyframeInterval = keyframeInterval;
+    _forceKeyframe = true;
+}
+
+bool SyncEngine::isInSync() const {
+    return _isInSync;
+}
+
 void SyncEngine::preSynchronization(IsMaster isMaster) {
     ZoneScoped;
 
@@ -78,6 +292,7 @@ void SyncEngine::addSyncable(Syncable* syncable) {
     ghoul_assert(syncable, "Syncable must not be nullptr");
 
     _syncables.push_back(syncable);
+    _forceKeyframe = true;
 }
 
 void SyncEngine::addSyncables(const std::vector<Syncable*>& syncables) {
@@ -92,6 +307,7 @@ void SyncEngine::removeSyncable(Syncable* syncable) {
         std::remove(_syncables.begin(), _syncables.end(), syncable),
         _syncables.end()
     );
+    _forceKeyframe = true;
 }
 
 void SyncEngine::removeSyncables(const std::vector<Syncable*>& syncables) {
@@ -329,7 +329,7 @@ ghoul::opengl::Texture* ColorMappingComponent::texture() const {
     return _texture.get();
 }
 
-void ColorMappingComponent::initialize(const dataloader::Dataset& dataset) {
+void ColorMappingComponent::initialize(const dataloader::DatasetView& dataset) {
     ZoneScoped;
 
     _colorMap = dataloader::color::loadFileWithCache(colorMapFile.value());
@@ -389,7 +389,7 @@ void ColorMappingComponent::initializeTexture() {
     _texture->uploadTexture();
 }
 
-void ColorMappingComponent::update(const dataloader::Dataset& dataset) {
+void ColorMappingComponent::update(const dataloader::DatasetView& dataset) {
     if (_colorMapFileIsDirty) {
         initialize(dataset);
         _colorMapTextureIsDirty = true;
@@ -431,7 +431,9 @@ glm::vec4 ColorMappingComponent::colorFromColorMap(float valueToColorFrom) const
     return _colorMap.entries[colorIndex];
 }
 
-void ColorMappingComponent::initializeParameterData(const dataloader::Dataset& dataset) {
+void ColorMappingComponent::initializeParameterData(
+                                                   const dataloader::DatasetView& dataset)
+{
     if (dataset.isEmpty()) {
         return;
     }
@@ -451,7 +453,7 @@ void ColorMappingComponent::initializeParameterData(const dataloader::Dataset& d
     int indexOfProvidedOption = -1;
 
     // If no options were added, add each dataset parameter and its range as options
-    if (dataColumn.options().empty() && !dataset.entries.empty()) {
+    if (dataColumn.options().empty() && dataset.size() > 0) {
         int i = 0;
         _colorRangeData.reserve(dataset.variables.size());
         for (const dataloader::Dataset::Variable& v : dataset.variables) {
@@ -244,7 +244,7 @@ void LabelsComponent::initialize() {
     loadLabels();
 }
 
-void LabelsComponent::loadLabelsFromDataset(const dataloader::Dataset& dataset,
+void LabelsComponent::loadLabelsFromDataset(const dataloader::DatasetView& dataset,
                                             DistanceUnit unit)
 {
     ZoneScoped;
@@ -71,6 +71,12 @@ bool Translation::initialize() {
     return true;
 }
 
+std::optional<TaskFuture<std::vector<glm::dvec3>>> Translation::requestPositions(
+                                                                std::vector<double>) const
+{
+    return std::nullopt;
+}
+
 void Translation::update(const UpdateData& data) {
     if (!_needsUpdate && data.time.j2000Seconds() == _cachedTime) {
         return;
@@ -0,0 +1,314 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/ephemeriscache.h>
+
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <numbers>
+
+namespace {
+    constexpr std::string_view _loggerCat = "EphemerisCache";
+
+    // The number of Chebyshev coefficients, and thus of samples, for each segment
+    constexpr int NCoefficients = 12;
+
+    // The locations in the segment, mapped to [-1, 1], at which the fitted polynomial is
+    // compared against additional samples. These lie in between the Chebyshev nodes and
+    // include the ends of the segment, where the error of the fit is the largest
+    constexpr std::array<double, 6> ValidationPoints = {
+        -1.0, -0.6, -0.2, 0.2, 0.6, 1.0
+    };
+
+    // The speed of light in km/s, used to convert the position tolerance into a
+    // tolerance for the light time
+    constexpr double SpeedOfLight = 299792.458;
+
+    // Evaluates the Chebyshev series with the provided coefficients at x in [-1, 1]
+    // using Clenshaw's recurrence. The first coefficient is expected to be halved already
+    double evaluateChebyshev(std::span<const double> coefficients, double x) {
+        double b1 = 0.0;
+        double b2 = 0.0;
+        for (size_t j = coefficients.size() - 1; j > 0; j--) {
+            const double b = 2.0 * x * b1 - b2 + coefficients[j];
+            b2 = b1;
+            b1 = b;
+        }
+        return x * b1 - b2 + coefficients[0];
+    }
+
+    size_t combineHash(size_t seed, size_t value) {
+        return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+} // namespace
+
+namespace openspace {
+
+EphemerisCache::EphemerisCache() : EphemerisCache(Settings()) {}
+
+EphemerisCache::EphemerisCache(Settings settings)
+    : _settings(std::move(settings))
+{
+    ghoul_assert(_settings.segmentLength > 0.0, "Segment length must be positive");
+    ghoul_assert(
+        _settings.minimumSegmentLength > 0.0,
+        "Minimum segment length must be positive"
+    );
+    ghoul_assert(_settings.nSegmentsPerEntry > 0, "Need at least one segment");
+}
+
+bool EphemerisCache::find(Quantity quantity, const Key& key, double time,
+                          std::span<double> result)
+{
+    ghoul_assert(
+        static_cast<int>(result.size()) == nComponents(quantity),
+        "Wrong number of components"
+    );
+
+    Table& table = _tables[static_cast<int>(quantity)];
+    const auto it = table.find(key);
+    if (it == table.end()) {
+        return false;
+    }
+
+    for (Segment& segment : it->second.segments) {
+        if (time < segment.begin || time >= segment.end) {
+            continue;
+        }
+
+        const double x = 2.0 * (time - segment.begin) / (segment.end - segment.begin) -
+                         1.0;
+        const std::span<const double> coefficients = segment.coefficients;
+        for (size_t i = 0; i < result.size(); i++) {
+            result[i] = evaluateChebyshev(
+                coefficients.subspan(i * NCoefficients, NCoefficients),
+                x
+            );
+        }
+        segment.lastUsed = ++_useCounter;
+        return true;
+    }
+    return false;
+}
+
+void EphemerisCache::miss(Quantity quantity, const Key& key, double time,
+                          const Sampler& sampler)
+{
+    Table& table = _tables[static_cast<int>(quantity)];
+    auto it = table.find(key);
+    if (it == table.end()) {
+        StoredKey storedKey = {
+            .target = std::string(key.target),
+            .observer = std::string(key.observer),
+            .frame = std::string(key.frame),
+            .aberrationCorrection = std::string(key.aberrationCorrection)
+        };
+        it = table.emplace(std::move(storedKey), Entry()).first;
+    }
+    Entry& entry = it->second;
+
+    double length = segmentLength(entry.level);
+    int64_t slot = static_cast<int64_t>(std::floor(time / length));
+    if (!entry.hasMissed || entry.lastMissSlot != slot) {
+        // Only the second miss in the same segment creates it, as the time might be
+        // jumping around too much for the segment to ever be used again
+        entry.hasMissed = true;
+        entry.lastMissSlot = slot;
+        return;
+    }
+    entry.hasMissed = false;
+
+    while (true) {
+        Segment segment;
+        segment.begin = static_cast<double>(slot) * length;
+        segment.end = segment.begin + length;
+
+        bool success = false;
+        try {
+            success = fitSegment(quantity, segment, sampler);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LDEBUG(std::format(
+                "Not caching '{}' -> '{}' in [{}, {}]: {}",
+                key.observer, key.target, segment.begin, segment.end, e.message
+            ));
+            return;
+        }
+
+        if (success) {
+            if (static_cast<int>(entry.segments.size()) >= _settings.nSegmentsPerEntry) {
+                const auto lru = std::min_element(
+                    entry.segments.begin(),
+                    entry.segments.end(),
+                    [](const Segment& lhs, const Segment& rhs) {
+                        return lhs.lastUsed < rhs.lastUsed;
+                    }
+                );
+                entry.segments.erase(lru);
+            }
+            segment.lastUsed = ++_useCounter;
+            entry.segments.push_back(std::move(segment));
+            return;
+        }
+
+        // The quantity changes too quickly for the segment, so we try again with a
+        // shorter one and keep using the shorter length for this entry from now on
+        if (length / 2.0 < _settings.minimumSegmentLength) {
+            return;
+        }
+        entry.level++;
+        length = segmentLength(entry.level);
+        slot = static_cast<int64_t>(std::floor(time / length));
+    }
+}
+
+void EphemerisCache::clear() {
+    for (Table& table : _tables) {
+        table.clear();
+    }
+}
+
+void EphemerisCache::setSettings(Settings settings) {
+    ghoul_assert(settings.segmentLength > 0.0, "Segment length must be positive");
+    ghoul_assert(
+        settings.minimumSegmentLength > 0.0,
+        "Minimum segment length must be positive"
+    );
+    ghoul_assert(settings.nSegmentsPerEntry > 0, "Need at least one segment");
+
+    _settings = std::move(settings);
+    clear();
+}
+
+const EphemerisCache::Settings& EphemerisCache::settings() const {
+    return _settings;
+}
+
+size_t EphemerisCache::nSegments() const {
+    size_t res = 0;
+    for (const Table& table : _tables) {
+        for (const auto& [key, entry] : table) {
+            res += entry.segments.size();
+        }
+    }
+    return res;
+}
+
+bool EphemerisCache::fitSegment(Quantity quantity, Segment& segment,
+                                const Sampler& sampler) const
+{
+    const int n = nComponents(quantity);
+    const double center = (segment.begin + segment.end) / 2.0;
+    const double halfLength = (segment.end - segment.begin) / 2.0;
+
+    // Sample the quantity at the Chebyshev nodes
+    std::array<double, NCoefficients * 9> samples;
+    for (int k = 0; k < NCoefficients; k++) {
+        const double x = std::cos(std::numbers::pi * (k + 0.5) / NCoefficients);
+        sampler(
+            center + halfLength * x,
+            std::span<double>(samples.data() + k * n, n)
+        );
+    }
+
+    segment.coefficients.assign(static_cast<size_t>(n) * NCoefficients, 0.0);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < NCoefficients; j++) {
+            double sum = 0.0;
+            for (int k = 0; k < NCoefficients; k++) {
+                sum += samples[k * n + i] *
+                       std::cos(std::numbers::pi * j * (k + 0.5) / NCoefficients);
+            }
+            segment.coefficients[i * NCoefficients + j] = 2.0 * sum / NCoefficients;
+        }
+        segment.coefficients[i * NCoefficients] /= 2.0;
+    }
+
+    // Compare the fit against samples in between the nodes
+    const std::span<const double> coefficients = segment.coefficients;
+    std::array<double, 9> exact;
+    for (const double x : ValidationPoints) {
+        sampler(center + halfLength * x, std::span<double>(exact.data(), n));
+        for (int i = 0; i < n; i++) {
+            double tolerance = 0.0;
+            if (quantity == Quantity::Position) {
+                tolerance = i < 3 ?
+                    _settings.positionTolerance :
+                    _settings.positionTolerance / SpeedOfLight;
+            }
+            else {
+                tolerance = _settings.rotationTolerance;
+            }
+
+            const double approximation = evaluateChebyshev(
+                coefficients.subspan(i * NCoefficients, NCoefficients),
+                x
+            );
+            if (std::abs(approximation - exact[i]) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+double EphemerisCache::segmentLength(int level) const {
+    return std::ldexp(_settings.segmentLength, -level);
+}
+
+size_t EphemerisCache::KeyHash::operator()(const Key& key) const {
+    size_t res = std::hash<std::string_view>()(key.target);
+    res = combineHash(res, std::hash<std::string_view>()(key.observer));
+    res = combineHash(res, std::hash<std::string_view>()(key.frame));
+    res = combineHash(res, std::hash<std::string_view>()(key.aberrationCorrection));
+    return res;
+}
+
+size_t EphemerisCache::KeyHash::operator()(const StoredKey& key) const {
+    return operator()(
+        Key{ key.target, key.observer, key.frame, key.aberrationCorrection }
+    );
+}
+
+bool EphemerisCache::KeyEqual::operator()(const Key& lhs, const StoredKey& rhs) const {
+    return lhs.target == rhs.target && lhs.observer == rhs.observer &&
+           lhs.frame == rhs.frame && lhs.aberrationCorrection == rhs.aberrationCorrection;
+}
+
+bool EphemerisCache::KeyEqual::operator()(const StoredKey& lhs, const Key& rhs) const {
+    return operator()(rhs, lhs);
+}
+
+bool EphemerisCache::KeyEqual::operator()(const StoredKey& lhs,
+                                          const StoredKey& rhs) const
+{
+    return lhs.target == rhs.target && lhs.observer == rhs.observer &&
+           lhs.frame == rhs.frame && lhs.aberrationCorrection == rhs.aberrationCorrection;
+}
+
+} // namespace openspace
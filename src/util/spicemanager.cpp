@@ -26,6 +26,7 @@
 
 #include <openspace/engine/globals.h>
 #include <openspace/scripting/lualibrary.h>
+#include <openspace/util/spicequeryservice.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -166,9 +167,14 @@ SpiceManager::SpiceManager() {
 
     loadLeapSecondsSpiceKernel();
     loadGeophysicalConstantsKernel();
+
+    _queryService = std::make_unique<SpiceQueryService>();
 }
 
 SpiceManager::~SpiceManager() {
+    // Requests in the query service might still be using the kernels
+    _queryService = nullptr;
+
     for (const KernelInformation& i : _loadedKernels) {
         unload_c(i.path.c_str());
     }
@@ -215,6 +221,7 @@ void throwSpiceError(const std::string& errorMessage) {
 }
 
 SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!filePath.empty(), "Empty file path");
     ghoul_assert(
         std::filesystem::is_regular_file(filePath),
@@ -255,6 +262,10 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
     // Reset the current directory to the previous one
     std::filesystem::current_path(currentDirectory);
 
+    // Cached values might have been computed from data that this kernel overrides
+    _ephemerisCache.clear();
+    clearCoverageBoundaries();
+
     if (failed_c()) {
         throwSpiceError("Kernel loading");
     }
@@ -274,6 +285,7 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
 }
 
 void SpiceManager::unloadKernel(KernelHandle kernelId) {
+    std::lock_guard lock(_mutex);
     ghoul_assert(kernelId <= _lastAssignedKernel, "Invalid unassigned kernel");
     ghoul_assert(kernelId != KernelHandle(0), "Invalid zero handle");
 
@@ -290,6 +302,8 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
             LINFO(std::format("Unloading SPICE kernel '{}'", it->path));
             unload_c(it->path.c_str());
             _loadedKernels.erase(it);
+            _ephemerisCache.clear();
+            clearCoverageBoundaries();
         }
         // Otherwise, we hold on to it, but reduce the reference counter by 1
         else {
@@ -300,6 +314,7 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
 }
 
 void SpiceManager::unloadKernel(std::string filePath) {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!filePath.empty(), "Empty filename");
 
     const std::filesystem::path path = absPath(std::move(filePath));
@@ -326,6 +341,8 @@ void SpiceManager::unloadKernel(std::string filePath) {
             LINFO(std::format("Unloading SPICE kernel '{}'", path));
             unload_c(path.string().c_str());
             _loadedKernels.erase(it);
+            _ephemerisCache.clear();
+            clearCoverageBoundaries();
         }
         else {
             // Otherwise, we hold on to it, but reduce the reference counter by 1
@@ -336,6 +353,7 @@ void SpiceManager::unloadKernel(std::string filePath) {
 }
 
 std::vector<std::string> SpiceManager::loadedKernels() const {
+    std::lock_guard lock(_mutex);
     std::vector<std::string> res;
     res.reserve(_loadedKernels.size());
     for (const KernelInformation& info : _loadedKernels) {
@@ -345,6 +363,7 @@ std::vector<std::string> SpiceManager::loadedKernels() const {
 }
 
 bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Empty target");
 
     const int id = naifId(target);
@@ -353,27 +372,20 @@ bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
         return true;
     }
 
-    const auto it = _spkIntervals.find(id);
-    if (it != _spkIntervals.end()) {
-        const std::vector<std::pair<double, double>>& intervalVector = it->second;
-        for (const std::pair<double, double>& vecElement : intervalVector) {
-            if ((vecElement.first < et) && (vecElement.second > et)) {
-                return true;
-            }
-        }
-    }
-    return false;
+    const auto it = _spkCoverage.find(id);
+    return it != _spkCoverage.end() && isCovered(it->second, et);
 }
 
 std::vector<std::pair<double, double>> SpiceManager::spkCoverage(
                                                           const std::string& target) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Empty target");
 
     const int id = naifId(target);
-    const auto it = _spkIntervals.find(id);
-    if (it != _spkIntervals.end()) {
-        return it->second;
+    const auto it = _spkCoverage.find(id);
+    if (it != _spkCoverage.end()) {
+        return it->second.intervals;
     }
     else {
         std::vector<std::pair<double, double>> emptyList;
@@ -383,36 +395,30 @@ std::vector<std::pair<double, double>> SpiceManager::spkCoverage(
 
 
 bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!frame.empty(), "Empty target");
 
     const int id = frameId(frame);
-    const auto it = _ckIntervals.find(id);
-    if (it != _ckIntervals.end()) {
-        const std::vector<std::pair<double, double>>& intervalVector = it->second;
-        for (const std::pair<double, double>& i : intervalVector) {
-            if ((i.first < et) && (i.second > et)) {
-                return true;
-            }
-        }
-    }
-    return false;
+    const auto it = _ckCoverage.find(id);
+    return it != _ckCoverage.end() && isCovered(it->second, et);
 }
 
 std::vector<std::pair<double, double>> SpiceManager::ckCoverage(
                                                           const std::string& target) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Empty target");
 
     int id = naifId(target);
-    const auto it = _ckIntervals.find(id);
-    if (it != _ckIntervals.end()) {
-        return it->second;
+    const auto it = _ckCoverage.find(id);
+    if (it != _ckCoverage.end()) {
+        return it->second.intervals;
     }
     else {
         id *= 1000;
-        const auto it2 = _ckIntervals.find(id);
-        if (it2 != _ckIntervals.end()) {
-            return it2->second;
+        const auto it2 = _ckCoverage.find(id);
+        if (it2 != _ckCoverage.end()) {
+            return it2->second.intervals;
         }
         else {
             std::vector<std::pair<double, double>> emptyList;
@@ -424,6 +430,7 @@ std::vector<std::pair<double, double>> SpiceManager::ckCoverage(
 std::vector<std::pair<int, std::string>> SpiceManager::spiceBodies(
                                                                  bool builtInFrames) const
 {
+    std::lock_guard lock(_mutex);
     std::vector<std::pair<int, std::string>> bodies;
 
     static std::array<SpiceInt, SPICE_CELL_CTRLSZ + 8192> idsetBuffer;
@@ -476,10 +483,12 @@ std::vector<std::pair<int, std::string>> SpiceManager::spiceBodies(
 }
 
 bool SpiceManager::hasValue(int naifId, const std::string& item) const {
+    std::lock_guard lock(_mutex);
     return bodfnd_c(naifId, item.c_str());
 }
 
 bool SpiceManager::hasValue(const std::string& body, const std::string& item) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!body.empty(), "Empty body");
     ghoul_assert(!item.empty(), "Empty item");
 
@@ -488,6 +497,7 @@ bool SpiceManager::hasValue(const std::string& body, const std::string& item) co
 }
 
 int SpiceManager::naifId(const std::string& body) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!body.empty(), "Empty body");
 
     SpiceBoolean success = SPICEFALSE;
@@ -500,6 +510,7 @@ int SpiceManager::naifId(const std::string& body) const {
 }
 
 bool SpiceManager::hasNaifId(const std::string& body) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!body.empty(), "Empty body");
 
     SpiceBoolean success = SPICEFALSE;
@@ -510,6 +521,7 @@ bool SpiceManager::hasNaifId(const std::string& body) const {
 }
 
 int SpiceManager::frameId(const std::string& frame) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!frame.empty(), "Empty frame");
 
     SpiceInt id = 0;
@@ -521,6 +533,7 @@ int SpiceManager::frameId(const std::string& frame) const {
 }
 
 bool SpiceManager::hasFrameId(const std::string& frame) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!frame.empty(), "Empty frame");
 
     SpiceInt id = 0;
@@ -548,30 +561,35 @@ void getValueInternal(const std::string& body, const std::string& value, int siz
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             double& v) const
 {
+    std::lock_guard lock(_mutex);
     getValueInternal(body, value, 1, &v);
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec2& v) const
 {
+    std::lock_guard lock(_mutex);
     getValueInternal(body, value, 2, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec3& v) const
 {
+    std::lock_guard lock(_mutex);
     getValueInternal(body, value, 3, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec4& v) const
 {
+    std::lock_guard lock(_mutex);
     getValueInternal(body, value, 4, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             std::vector<double>& v) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!v.empty(), "Array for values has to be preallocaed");
 
     getValueInternal(body, value, static_cast<int>(v.size()), v.data());
@@ -580,6 +598,7 @@ void SpiceManager::getValue(const std::string& body, const std::string& value,
 double SpiceManager::spacecraftClockToET(const std::string& craft,
                                          double craftTicks) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!craft.empty(), "Empty craft");
 
     const int craftId = naifId(craft);
@@ -594,12 +613,14 @@ double SpiceManager::spacecraftClockToET(const std::string& craft,
 }
 
 double SpiceManager::ephemerisTimeFromDate(const std::string& timeString) const {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!timeString.empty(), "Empty timeString");
 
     return ephemerisTimeFromDate(timeString.c_str());
 }
 
 double SpiceManager::ephemerisTimeFromDate(const char* timeString) const {
+    std::lock_guard lock(_mutex);
     double et = 0.0;
     str2et_c(timeString, &et);
     if (failed_c()) {
@@ -610,6 +631,7 @@ double SpiceManager::ephemerisTimeFromDate(const char* timeString) const {
 
 std::string SpiceManager::dateFromEphemerisTime(double ephemerisTime, const char* format)
 {
+    std::lock_guard lock(_mutex);
     constexpr int BufferSize = 128;
     std::array<char, BufferSize> Buffer;
     std::memset(Buffer.data(), char(0), BufferSize);
@@ -637,10 +659,73 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
                                         AberrationCorrection aberrationCorrection,
                                         double ephemerisTime, double& lightTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target is not empty");
     ghoul_assert(!observer.empty(), "Observer is not empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame is not empty");
 
+    if (!_isEphemerisCacheEnabled) {
+        return uncachedTargetPosition(
+            target,
+            observer,
+            referenceFrame,
+            aberrationCorrection,
+            ephemerisTime,
+            lightTime
+        );
+    }
+
+    using Quantity = EphemerisCache::Quantity;
+    const EphemerisCache::Key key = {
+        .target = target,
+        .observer = observer,
+        .frame = referenceFrame,
+        .aberrationCorrection = static_cast<const char*>(aberrationCorrection)
+    };
+    std::array<double, EphemerisCache::nComponents(Quantity::Position)> values;
+    if (_ephemerisCache.find(Quantity::Position, key, ephemerisTime, values)) {
+        lightTime = values[3];
+        return glm::dvec3(values[0], values[1], values[2]);
+    }
+
+    const glm::dvec3 position = uncachedTargetPosition(
+        target,
+        observer,
+        referenceFrame,
+        aberrationCorrection,
+        ephemerisTime,
+        lightTime
+    );
+    _ephemerisCache.miss(
+        Quantity::Position,
+        key,
+        ephemerisTime,
+        [&](double time, std::span<double> result) {
+            double lt = 0.0;
+            const glm::dvec3 p = uncachedTargetPosition(
+                target,
+                observer,
+                referenceFrame,
+                aberrationCorrection,
+                time,
+                lt
+            );
+            result[0] = p.x;
+            result[1] = p.y;
+            result[2] = p.z;
+            result[3] = lt;
+        }
+    );
+    return position;
+}
+
+glm::dvec3 SpiceManager::uncachedTargetPosition(const std::string& target,
+                                                const std::string& observer,
+                                                const std::string& referenceFrame,
+                                                AberrationCorrection aberrationCorrection,
+                                                double ephemerisTime,
+                                                double& lightTime) const
+{
     const bool targetHasCoverage = hasSpkCoverage(target, ephemerisTime);
     const bool observerHasCoverage = hasSpkCoverage(observer, ephemerisTime);
     if (!targetHasCoverage && !observerHasCoverage) {
@@ -707,6 +792,7 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
                                         AberrationCorrection aberrationCorrection,
                                         double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     double unused = 0.0;
     return targetPosition(
         target,
@@ -722,6 +808,7 @@ glm::dmat3 SpiceManager::frameTransformationMatrix(const std::string& from,
                                                    const std::string& to,
                                                    double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!from.empty(), "From must not be empty");
     ghoul_assert(!to.empty(), "To must not be empty");
 
@@ -756,6 +843,7 @@ SpiceManager::SurfaceInterceptResult SpiceManager::surfaceIntercept(
                                                                      double ephemerisTime,
                                                   const glm::dvec3& directionVector) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(target != observer, "Target and observer must be different");
@@ -802,6 +890,7 @@ bool SpiceManager::isTargetInFieldOfView(const std::string& target,
                                          AberrationCorrection aberrationCorrection,
                                          double& ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(target != observer, "Target and observer must be different");
@@ -836,6 +925,7 @@ SpiceManager::TargetStateResult SpiceManager::targetState(const std::string& tar
                                                 AberrationCorrection aberrationCorrection,
                                                                double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
@@ -873,6 +963,7 @@ SpiceManager::TransformMatrix SpiceManager::stateTransformMatrix(
                                                       const std::string& destinationFrame,
                                                                double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "toFrame must not be empty");
 
@@ -897,9 +988,63 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
                                                  const std::string& destinationFrame,
                                                  double ephemerisTime) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
+    if (!_isEphemerisCacheEnabled) {
+        return uncachedPositionTransformMatrix(
+            sourceFrame,
+            destinationFrame,
+            ephemerisTime
+        );
+    }
+
+    using Quantity = EphemerisCache::Quantity;
+    const EphemerisCache::Key key = {
+        .target = sourceFrame,
+        .observer = destinationFrame
+    };
+    std::array<double, EphemerisCache::nComponents(Quantity::Rotation)> values;
+    if (_ephemerisCache.find(Quantity::Rotation, key, ephemerisTime, values)) {
+        glm::dmat3 result;
+        for (int c = 0; c < 3; c++) {
+            for (int r = 0; r < 3; r++) {
+                result[c][r] = values[c * 3 + r];
+            }
+        }
+        return result;
+    }
+
+    const glm::dmat3 result = uncachedPositionTransformMatrix(
+        sourceFrame,
+        destinationFrame,
+        ephemerisTime
+    );
+    _ephemerisCache.miss(
+        Quantity::Rotation,
+        key,
+        ephemerisTime,
+        [&](double time, std::span<double> res) {
+            const glm::dmat3 m = uncachedPositionTransformMatrix(
+                sourceFrame,
+                destinationFrame,
+                time
+            );
+            for (int c = 0; c < 3; c++) {
+                for (int r = 0; r < 3; r++) {
+                    res[c * 3 + r] = m[c][r];
+                }
+            }
+        }
+    );
+    return result;
+}
+
+glm::dmat3 SpiceManager::uncachedPositionTransformMatrix(const std::string& sourceFrame,
+                                                      const std::string& destinationFrame,
+                                                               double ephemerisTime) const
+{
     glm::dmat3 result = glm::dmat3(1.0);
     pxform_c(
         sourceFrame.c_str(),
@@ -929,6 +1074,7 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
                                                  double ephemerisTimeFrom,
                                                  double ephemerisTimeTo) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
@@ -954,11 +1100,13 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
 SpiceManager::FieldOfViewResult
 SpiceManager::fieldOfView(const std::string& instrument) const
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!instrument.empty(), "Instrument must not be empty");
     return fieldOfView(naifId(instrument));
 }
 
 SpiceManager::FieldOfViewResult SpiceManager::fieldOfView(int instrument) const {
+    std::lock_guard lock(_mutex);
     constexpr int MaxBoundsSize = 64;
     constexpr int BufferSize = 128;
 
@@ -1014,6 +1162,7 @@ SpiceManager::TerminatorEllipseResult SpiceManager::terminatorEllipse(
                                                                      double ephemerisTime,
                                                              int numberOfTerminatorPoints)
 {
+    std::lock_guard lock(_mutex);
     ghoul_assert(!target.empty(), "Target must not be empty");
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(!frame.empty(), "Frame must not be empty");
@@ -1092,6 +1241,7 @@ void SpiceManager::findCkCoverage(const std::string& path) {
         // Get the number of intervals in the coverage window.
         const SpiceInt numberOfIntervals = wncard_c(&cover);
 
+        Coverage& coverage = _ckCoverage[frame];
         for (SpiceInt j = 0; j < numberOfIntervals; j++) {
             // Get the endpoints of the jth interval.
             SpiceDouble b = 0.0;
@@ -1101,10 +1251,9 @@ void SpiceManager::findCkCoverage(const std::string& path) {
                 throwSpiceError("Error finding Ck Coverage");
             }
 
-            _ckCoverageTimes[frame].insert(e);
-            _ckCoverageTimes[frame].insert(b);
-            _ckIntervals[frame].emplace_back(b, e);
+            coverage.intervals.emplace_back(b, e);
         }
+        updateWindows(coverage);
     }
 }
 
@@ -1152,6 +1301,7 @@ void SpiceManager::findSpkCoverage(const std::string& path) {
         // Get the number of intervals in the coverage window.
         const SpiceInt numberOfIntervals = wncard_c(&cover);
 
+        Coverage& coverage = _spkCoverage[obj];
         for (SpiceInt j = 0; j < numberOfIntervals; j++) {
             //Get the endpoints of the jth interval.
             SpiceDouble b = 0.0;
@@ -1161,11 +1311,92 @@ void SpiceManager::findSpkCoverage(const std::string& path) {
                 throwSpiceError("Error finding Spk coverage");
             }
 
-            // insert all into coverage time set, the windows could be merged @AA
-            _spkCoverageTimes[obj].insert(e);
-            _spkCoverageTimes[obj].insert(b);
-            _spkIntervals[obj].emplace_back(b, e);
+            coverage.intervals.emplace_back(b, e);
         }
+        updateWindows(coverage);
+    }
+}
+
+void SpiceManager::updateWindows(Coverage& coverage) {
+    std::vector<std::pair<double, double>> sorted = coverage.intervals;
+    std::sort(sorted.begin(), sorted.end());
+
+    coverage.windows.clear();
+    for (const std::pair<double, double>& interval : sorted) {
+        if (!coverage.windows.empty() && interval.first <= coverage.windows.back().second)
+        {
+            // The interval overlaps or touches the previous window
+            coverage.windows.back().second = std::max(
+                coverage.windows.back().second,
+                interval.second
+            );
+        }
+        else {
+            coverage.windows.push_back(interval);
+        }
+    }
+
+    // The boundaries have changed, so the cached values might no longer be boundaries
+    coverage.boundaryPositions.clear();
+    coverage.boundaryTransforms.clear();
+}
+
+bool SpiceManager::isCovered(const Coverage& coverage, double time) {
+    // Find the first window that starts after the time; the window before it is the
+    // only one that can contain the time
+    const auto it = std::upper_bound(
+        coverage.windows.begin(),
+        coverage.windows.end(),
+        time,
+        [](double t, const std::pair<double, double>& w) { return t < w.first; }
+    );
+    if (it == coverage.windows.begin()) {
+        return false;
+    }
+    const std::pair<double, double>& window = *std::prev(it);
+    return window.first < time && time < window.second;
+}
+
+std::pair<double, double> SpiceManager::estimationBracket(const Coverage& coverage,
+                                                          double time)
+{
+    ghoul_assert(!coverage.windows.empty(), "No coverage windows");
+
+    const std::vector<std::pair<double, double>>& windows = coverage.windows;
+    const auto it = std::upper_bound(
+        windows.begin(),
+        windows.end(),
+        time,
+        [](double t, const std::pair<double, double>& w) { return t < w.first; }
+    );
+
+    if (it == windows.begin()) {
+        // coverage later, use the first boundary
+        return { windows.front().first, windows.front().first };
+    }
+
+    const std::pair<double, double>& previous = *std::prev(it);
+    if (time < previous.second) {
+        // The time is covered, but the value could not be computed. Interpolate between
+        // the boundaries of the window that contains the time
+        return previous;
+    }
+    else if (it == windows.end()) {
+        // coverage earlier, use the last boundary
+        return { previous.second, previous.second };
+    }
+    else {
+        // coverage gap, interpolate between the surrounding boundaries
+        return { previous.second, it->first };
+    }
+}
+
+void SpiceManager::clearCoverageBoundaries() {
+    for (std::pair<const int, Coverage>& p : _spkCoverage) {
+        p.second.boundaryPositions.clear();
+    }
+    for (std::pair<const int, Coverage>& p : _ckCoverage) {
+        p.second.boundaryTransforms.clear();
     }
 }
 
@@ -1190,7 +1421,8 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
         return glm::dvec3(0.0);
     }
 
-    if (_spkCoverageTimes.find(targetId) == _spkCoverageTimes.end()) {
+    const auto it = _spkCoverage.find(targetId);
+    if (it == _spkCoverage.end() || it->second.windows.empty()) {
         if (_useExceptions) {
             // no coverage
             throw SpiceException(std::format("No position for '{}' at any time", target));
@@ -1199,99 +1431,71 @@ glm::dvec3 SpiceManager::getEstimatedPosition(const std::string& target,
             return glm::dvec3(0.0);
         }
     }
+    const Coverage& coverage = it->second;
 
-    const std::set<double>& coveredTimes = _spkCoverageTimes.find(targetId)->second;
-
-    glm::dvec3 pos = glm::dvec3(0.0);
-    if (coveredTimes.lower_bound(ephemerisTime) == coveredTimes.begin()) {
-        // coverage later, fetch first position
-        spkpos_c(
-            target.c_str(),
-            *(coveredTimes.begin()),
-            referenceFrame.c_str(),
-            aberrationCorrection,
-            observer.c_str(),
-            glm::value_ptr(pos),
-            &lightTime
+    // The positions at the boundaries are cached, as the same boundaries are used for
+    // all times in the same gap
+    const std::string context = std::format(
+        "{}|{}|{}",
+        observer, referenceFrame, static_cast<const char*>(aberrationCorrection)
+    );
+    auto boundaryPosition = [&](double time) -> glm::dvec4 {
+        const auto [b, inserted] = coverage.boundaryPositions.try_emplace(
+            std::pair(context, time)
         );
-        if (failed_c()) {
-            throwSpiceError(std::format(
-                "Error estimating position for '{}' with observer '{}' in frame '{}'",
-                target, observer, referenceFrame
-            ));
+        if (inserted) {
+            glm::dvec3 pos = glm::dvec3(0.0);
+            double lt = 0.0;
+            spkpos_c(
+                target.c_str(),
+                time,
+                referenceFrame.c_str(),
+                aberrationCorrection,
+                observer.c_str(),
+                glm::value_ptr(pos),
+                &lt
+            );
+            if (failed_c()) {
+                coverage.boundaryPositions.erase(b);
+                throwSpiceError(std::format(
+                    "Error estimating position for '{}' with observer '{}' in frame '{}'",
+                    target, observer, referenceFrame
+                ));
+                return glm::dvec4(pos, lt);
+            }
+            b->second = glm::dvec4(pos, lt);
         }
+        return b->second;
+    };
 
-    }
-    else if (coveredTimes.upper_bound(ephemerisTime) == coveredTimes.end()) {
-        // coverage earlier, fetch last position
-        spkpos_c(
-            target.c_str(),
-            *(coveredTimes.rbegin()),
-            referenceFrame.c_str(),
-            aberrationCorrection,
-            observer.c_str(),
-            glm::value_ptr(pos),
-            &lightTime
-        );
-        if (failed_c()) {
-            throwSpiceError(std::format(
-                "Error estimating position for '{}' with observer '{}' in frame '{}'",
-                target, observer, referenceFrame
-            ));
-        }
+    const auto [timeEarlier, timeLater] = estimationBracket(coverage, ephemerisTime);
+    if (timeEarlier == timeLater) {
+        // coverage only earlier or later, use the closest boundary
+        const glm::dvec4 value = boundaryPosition(timeEarlier);
+        lightTime = value.w;
+        return glm::dvec3(value);
     }
     else {
         // coverage both earlier and later, interpolate these positions
-        glm::dvec3 posEarlier = glm::dvec3(0.0);
-        double ltEarlier = 0.0;
-        const double timeEarlier = *std::prev((coveredTimes.lower_bound(ephemerisTime)));
-        spkpos_c(
-            target.c_str(),
-            timeEarlier,
-            referenceFrame.c_str(),
-            aberrationCorrection,
-            observer.c_str(),
-            glm::value_ptr(posEarlier),
-            &ltEarlier
-        );
-
-        glm::dvec3 posLater = glm::dvec3(0.0);
-        double ltLater = 0.0;
-        const double timeLater = *(coveredTimes.upper_bound(ephemerisTime));
-        spkpos_c(
-            target.c_str(),
-            timeLater,
-            referenceFrame.c_str(),
-            aberrationCorrection,
-            observer.c_str(),
-            glm::value_ptr(posLater),
-            &ltLater
-        );
-
-        if (failed_c()) {
-            throwSpiceError(std::format(
-                "Error estimating position for '{}' with observer '{}' in frame '{}'",
-                target, observer, referenceFrame
-            ));
-        }
+        const glm::dvec4 earlier = boundaryPosition(timeEarlier);
+        const glm::dvec4 later = boundaryPosition(timeLater);
 
         // linear interpolation
         const double t = (ephemerisTime - timeEarlier) / (timeLater - timeEarlier);
-        pos = posEarlier * (1.0 - t) + posLater * t;
-        lightTime = ltEarlier * (1.0 - t) + ltLater * t;
+        const glm::dvec4 value = earlier * (1.0 - t) + later * t;
+        lightTime = value.w;
+        return glm::dvec3(value);
     }
-
-    return pos;
 }
 
 glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFrame,
                                                      const std::string& toFrame,
                                                      double time) const
 {
-    glm::dmat3 result = glm::dmat3(1.0);
     const int idFrame = frameId(fromFrame);
 
-    if (_ckCoverageTimes.find(idFrame) == _ckCoverageTimes.end()) {
+    const auto it = _ckCoverage.find(idFrame);
+    if (it == _ckCoverage.end() || it->second.windows.empty()) {
         if (_useExceptions) {
             // no coverage
             throw SpiceException(std::format(
@@ -1303,77 +1507,47 @@ glm::dmat3 SpiceManager::getEstimatedTransformMatrix(const std::string& fromFram
             return glm::dmat3(1.0);
         }
     }
+    const Coverage& coverage = it->second;
 
-    std::set<double> coveredTimes = _ckCoverageTimes.find(idFrame)->second;
-
-    if (coveredTimes.lower_bound(time) == coveredTimes.begin()) {
-        // coverage later, fetch first transform
-        pxform_c(
-            fromFrame.c_str(),
-            toFrame.c_str(),
-            *(coveredTimes.begin()),
-            reinterpret_cast<double(*)[3]>(glm::value_ptr(result))
-        );
-        if (failed_c()) {
-            throwSpiceError(std::format(
-                "Error estimating transform matrix from '{}' to from '{}' at time '{}'",
-                fromFrame, toFrame, time
-            ));
-        }
-    }
-    else if (coveredTimes.upper_bound(time) == coveredTimes.end()) {
-        // coverage earlier, fetch last transform
-        pxform_c(
-            fromFrame.c_str(),
-            toFrame.c_str(),
-            *(coveredTimes.rbegin()),
-            reinterpret_cast<double(*)[3]>(glm::value_ptr(result))
+    auto boundaryTransform = [&](double t) -> glm::dmat3 {
+        const auto [b, inserted] = coverage.boundaryTransforms.try_emplace(
+            std::pair(toFrame, t)
         );
-        if (failed_c()) {
-            throwSpiceError(std::format(
-                "Error estimating transform matrix from frame '{}' to '{}' at time '{}'",
-                fromFrame, toFrame, time
-            ));
+        if (inserted) {
+            glm::dmat3 transform = glm::dmat3(1.0);
+            pxform_c(
+                fromFrame.c_str(),
+                toFrame.c_str(),
+                t,
+                reinterpret_cast<double(*)[3]>(glm::value_ptr(transform))
+            );
+            if (failed_c()) {
+                coverage.boundaryTransforms.erase(b);
+                throwSpiceError(std::format(
+                    "Error estimating transform matrix from frame '{}' to '{}' at time "
+                    "'{}'",
+                    fromFrame, toFrame, time
+                ));
+                return transform;
+            }
+            b->second = transform;
         }
+        return b->second;
+    };
+
+    const auto [earlier, later] = estimationBracket(coverage, time);
+    if (earlier == later) {
+        // coverage only earlier or later, use the closest boundary
+        return boundaryTransform(earlier);
     }
     else {
         // coverage both earlier and later, interpolate these transformations
-        const double earlier = *std::prev((coveredTimes.lower_bound(time)));
-        const double later = *(coveredTimes.upper_bound(time));
-
-        glm::dmat3 earlierTransform = glm::dmat3(1.0);
-        pxform_c(
-            fromFrame.c_str(),
-            toFrame.c_str(),
-            earlier,
-            reinterpret_cast<double(*)[3]>(glm::value_ptr(earlierTransform))
-        );
-        if (failed_c()) {
-            throwSpiceError(std::format(
-                "Error estimating transform matrix from frame '{}' to '{}' at time '{}'",
-                fromFrame, toFrame, time
-            ));
-        }
-
-        glm::dmat3 laterTransform = glm::dmat3(1.0);
-        pxform_c(
-            fromFrame.c_str(),
-            toFrame.c_str(),
-            later,
-            reinterpret_cast<double(*)[3]>(glm::value_ptr(laterTransform))
-        );
-        if (failed_c()) {
-            throwSpiceError(std::format(
-                "Error estimating transform matrix from frame '{}' to '{}' at time '{}'",
-                fromFrame, toFrame, time
-            ));
-        }
+        const glm::dmat3 earlierTransform = boundaryTransform(earlier);
+        const glm::dmat3 laterTransform = boundaryTransform(later);
 
         const double t = (time - earlier) / (later - earlier);
-        result = earlierTransform * (1.0 - t) + laterTransform * t;
+        return earlierTransform * (1.0 - t) + laterTransform * t;
     }
-
-    return result;
 }
 
 void SpiceManager::loadLeapSecondsSpiceKernel() {
@@ -1676,6 +1850,7 @@ References:
 }
 
 void SpiceManager::setExceptionHandling(UseException useException) {
+    std::lock_guard lock(_mutex);
     _useExceptions = useException;
 }
 
@@ -1683,6 +1858,33 @@ SpiceManager::UseException SpiceManager::exceptionHandling() const {
     return _useExceptions;
 }
 
+SpiceQueryService& SpiceManager::queryService() {
+    ghoul_assert(_queryService, "No query service");
+    return *_queryService;
+}
+
+std::recursive_mutex& SpiceManager::spiceMutex() const {
+    return _mutex;
+}
+
+void SpiceManager::setEphemerisCacheEnabled(bool enabled,
+                                            EphemerisCache::Settings settings)
+{
+    std::lock_guard lock(_mutex);
+    _isEphemerisCacheEnabled = enabled;
+    _ephemerisCache.setSettings(std::move(settings));
+}
+
+bool SpiceManager::isEphemerisCacheEnabled() const {
+    std::lock_guard lock(_mutex);
+    return _isEphemerisCacheEnabled;
+}
+
+void SpiceManager::invalidateEphemerisCache() {
+    std::lock_guard lock(_mutex);
+    _ephemerisCache.clear();
+}
+
 scripting::LuaLibrary SpiceManager::luaLibrary() {
     return {
         "spice",
@@ -146,6 +146,7 @@ namespace {
 {
     // Code adopted from
     // https://naif.jpl.nasa.gov/pub/naif/toolkit_docs/C/cspice/getelm_c.html
+    const std::lock_guard lock(openspace::SpiceManager::ref().spiceMutex());
     SpiceInt n = 0;
 
     //
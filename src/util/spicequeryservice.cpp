@@ -0,0 +1,112 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/spicequeryservice.h>
+
+#include <ghoul/misc/profiling.h>
+
+namespace openspace {
+
+SpiceQueryService::SpiceQueryService()
+    // A single thread, as all calls into CSPICE are serialized anyway
+    : _scheduler(1)
+{}
+
+TaskFuture<std::vector<glm::dvec3>> SpiceQueryService::targetPositions(std::string target,
+                                                                     std::string observer,
+                                                               std::string referenceFrame,
+                                  SpiceManager::AberrationCorrection aberrationCorrection,
+                                                       std::vector<double> ephemerisTimes)
+{
+    return _scheduler.submit(
+        [target = std::move(target), observer = std::move(observer),
+         referenceFrame = std::move(referenceFrame), aberrationCorrection,
+         ephemerisTimes = std::move(ephemerisTimes)]()
+        {
+            ZoneScopedN("SpiceQueryService::targetPositions");
+
+            std::vector<glm::dvec3> res;
+            res.reserve(ephemerisTimes.size());
+            for (const double time : ephemerisTimes) {
+                res.push_back(SpiceManager::ref().targetPosition(
+                    target,
+                    observer,
+                    referenceFrame,
+                    aberrationCorrection,
+                    time
+                ));
+            }
+            return res;
+        }
+    );
+}
+
+TaskFuture<std::vector<glm::dmat3>> SpiceQueryService::positionTransformMatrices(
+                                                                  std::string sourceFrame,
+                                                             std::string destinationFrame,
+                                                       std::vector<double> ephemerisTimes)
+{
+    return _scheduler.submit(
+        [sourceFrame = std::move(sourceFrame),
+         destinationFrame = std::move(destinationFrame),
+         ephemerisTimes = std::move(ephemerisTimes)]()
+        {
+            ZoneScopedN("SpiceQueryService::positionTransformMatrices");
+
+            std::vector<glm::dmat3> res;
+            res.reserve(ephemerisTimes.size());
+            for (const double time : ephemerisTimes) {
+                res.push_back(SpiceManager::ref().positionTransformMatrix(
+                    sourceFrame,
+                    destinationFrame,
+                    time
+                ));
+            }
+            return res;
+        }
+    );
+}
+
+TaskFuture<std::vector<double>> SpiceQueryService::ephemerisTimesFromDates(
+                                                           std::vector<std::string> dates)
+{
+    return _scheduler.submit(
+        [dates = std::move(dates)]() {
+            ZoneScopedN("SpiceQueryService::ephemerisTimesFromDates");
+
+            std::vector<double> res;
+            res.reserve(dates.size());
+            for (const std::string& date : dates) {
+                res.push_back(SpiceManager::ref().ephemerisTimeFromDate(date));
+            }
+            return res;
+        }
+    );
+}
+
+size_t SpiceQueryService::nQueuedRequests() const {
+    return _scheduler.numQueuedTasks();
+}
+
+} // namespace openspace
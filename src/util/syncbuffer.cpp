@@ -25,6 +25,7 @@
 #include <openspace/util/syncbuffer.h>
 
 #include <ghoul/misc/profiling.h>
+#include <algorithm>
 
 namespace openspace {
 
@@ -32,16 +33,17 @@ SyncBuffer::SyncBuffer(size_t n)
     : _n(n)
 {
     _dataStream.resize(_n);
+    _decodeData = _dataStream;
 }
 
 void SyncBuffer::encode(const std::string& s) {
     ZoneScoped;
 
-    const int32_t anticpatedBufferSize = static_cast<int32_t>(
-        _encodeOffset + (sizeof(char) * s.size()) + sizeof(int32_t)
-    );
-    if (anticpatedBufferSize >= static_cast<int32_t>(_n)) {
-        _dataStream.resize(anticpatedBufferSize);
+    const size_t anticpatedBufferSize =
+        _encodeOffset + (sizeof(char) * s.size()) + sizeof(int32_t);
+    if (anticpatedBufferSize > _dataStream.size()) {
+        // Grow geometrically so that the buffer quickly settles on its final size
+        _dataStream.resize(std::max(anticpatedBufferSize, 2 * _dataStream.size()));
     }
 
     int32_t length = static_cast<int32_t>(s.size() * sizeof(char));
@@ -61,15 +63,16 @@ std::string SyncBuffer::decode() {
     int32_t length = 0;
     std::memcpy(
         reinterpret_cast<char*>(&length),
-        _dataStream.data() + _decodeOffset,
+        _decodeData.data() + _decodeOffset,
         sizeof(int32_t)
     );
-    std::vector<char> tmp(length + 1);
     _decodeOffset += sizeof(int32_t);
-    memcpy(tmp.data(), _dataStream.data() + _decodeOffset, length);
+    ghoul_assert(_decodeOffset + length <= _decodeData.size(), "Reading past the end");
+    std::string ret(
+        reinterpret_cast<const char*>(_decodeData.data() + _decodeOffset),
+        length
+    );
     _decodeOffset += length;
-    tmp[length] = '\0';
-    std::string ret(tmp.data());
     return ret;
 }
 
@@ -79,44 +82,52 @@ void SyncBuffer::decode(std::string& s) {
 
 void SyncBuffer::decode(glm::quat& value) {
     const size_t size = sizeof(glm::quat);
-    ghoul_assert(_decodeOffset + size < _n, "");
-    std::memcpy(glm::value_ptr(value), _dataStream.data() + _decodeOffset, size);
+    ghoul_assert(_decodeOffset + size <= _decodeData.size(), "Reading past the end");
+    std::memcpy(glm::value_ptr(value), _decodeData.data() + _decodeOffset, size);
     _decodeOffset += size;
 }
 
 void SyncBuffer::decode(glm::dquat& value) {
     const size_t size = sizeof(glm::dquat);
-    ghoul_assert(_decodeOffset + size < _n, "");
-    std::memcpy(glm::value_ptr(value), _dataStream.data() + _decodeOffset, size);
+    ghoul_assert(_decodeOffset + size <= _decodeData.size(), "Reading past the end");
+    std::memcpy(glm::value_ptr(value), _decodeData.data() + _decodeOffset, size);
     _decodeOffset += size;
 }
 
 void SyncBuffer::decode(glm::vec3& value) {
     const size_t size = sizeof(glm::vec3);
-    ghoul_assert(_decodeOffset + size < _n, "");
-    std::memcpy(glm::value_ptr(value), _dataStream.data() + _decodeOffset, size);
+    ghoul_assert(_decodeOffset + size <= _decodeData.size(), "Reading past the end");
+    std::memcpy(glm::value_ptr(value), _decodeData.data() + _decodeOffset, size);
     _decodeOffset += size;
 }
 
 void SyncBuffer::decode(glm::dvec3& value) {
     const size_t size = sizeof(glm::dvec3);
-    ghoul_assert(_decodeOffset + size < _n, "");
-    std::memcpy(glm::value_ptr(value), _dataStream.data() + _decodeOffset, size);
+    ghoul_assert(_decodeOffset + size <= _decodeData.size(), "Reading past the end");
+    std::memcpy(glm::value_ptr(value), _decodeData.data() + _decodeOffset, size);
     _decodeOffset += size;
 }
 
 void SyncBuffer::setData(std::vector<std::byte> data) {
     _dataStream = std::move(data);
+    _decodeData = _dataStream;
+    _decodeOffset = 0;
 }
 
-std::vector<std::byte> SyncBuffer::data() {
-    _dataStream.resize(_encodeOffset);
+void SyncBuffer::setData(std::span<const std::byte> data) {
+    _decodeData = data;
+    _decodeOffset = 0;
+}
 
-    return _dataStream;
+std::span<const std::byte> SyncBuffer::data() const {
+    return std::span<const std::byte>(_dataStream.data(), _encodeOffset);
 }
 
 void SyncBuffer::reset() {
-    _dataStream.resize(_n);
+    if (_dataStream.size() < _n) {
+        _dataStream.resize(_n);
+    }
+    _decodeData = _dataStream;
     _encodeOffset = 0;
     _decodeOffset = 0;
 }
@@ -0,0 +1,255 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/taskscheduler.h>
+
+#include <algorithm>
+
+namespace {
+    // The scheduler and queue index of the worker thread that is currently running, if
+    // any. Used to push tasks that are enqueued from inside a task onto the queue of the
+    // worker that created them
+    thread_local const openspace::TaskScheduler* CurrentScheduler = nullptr;
+    thread_local size_t CurrentQueueIndex = 0;
+} // namespace
+
+namespace openspace {
+
+ScheduledTask::ScheduledTask(ScheduledTask&& other) noexcept {
+    if (other._vtable) {
+        other._vtable->move(other._storage, _storage);
+        _vtable = other._vtable;
+        _isInline = other._isInline;
+        other._vtable = nullptr;
+    }
+}
+
+ScheduledTask& ScheduledTask::operator=(ScheduledTask&& other) noexcept {
+    if (this != &other) {
+        reset();
+        if (other._vtable) {
+            other._vtable->move(other._storage, _storage);
+            _vtable = other._vtable;
+            _isInline = other._isInline;
+            other._vtable = nullptr;
+        }
+    }
+    return *this;
+}
+
+ScheduledTask::~ScheduledTask() {
+    reset();
+}
+
+void ScheduledTask::operator()() {
+    _vtable->invoke(_storage);
+}
+
+ScheduledTask::operator bool() const {
+    return _vtable != nullptr;
+}
+
+bool ScheduledTask::isStoredInline() const {
+    return _vtable && _isInline;
+}
+
+void ScheduledTask::reset() noexcept {
+    if (_vtable) {
+        _vtable->destroy(_storage);
+        _vtable = nullptr;
+    }
+}
+
+TaskScheduler::TaskScheduler(size_t numThreads) {
+    numThreads = std::max<size_t>(numThreads, 1);
+
+    _queues.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++) {
+        _queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    _workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++) {
+        _workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        const std::lock_guard lock(_sleepMutex);
+        _stop = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (std::thread& w : _workers) {
+        w.join();
+    }
+
+    // Destroying the remaining tasks might break promises, which in turn tries to enqueue
+    // continuations. Those are dropped in `enqueue` since `_stop` is already set
+    clearTasks();
+}
+
+void TaskScheduler::enqueue(ScheduledTask task, Priority priority) {
+    if (_stop) {
+        return;
+    }
+
+    const size_t p = static_cast<size_t>(priority);
+
+    // Increment the counters before the task becomes visible so that a worker that pops
+    // it can never observe a negative count
+    _numQueued++;
+    _numQueuedPerPriority[p]++;
+
+    if (CurrentScheduler == this) {
+        WorkerQueue& queue = *_queues[CurrentQueueIndex];
+        const std::lock_guard lock(queue.mutex);
+        queue.tasks[p].push_back(std::move(task));
+    }
+    else {
+        // Try to find an uncontended queue first and only block if all queues are busy
+        const size_t n = _queues.size();
+        const size_t start = _nextQueue++ % n;
+        bool hasPushed = false;
+        for (size_t i = 0; i < n && !hasPushed; i++) {
+            WorkerQueue& queue = *_queues[(start + i) % n];
+            std::unique_lock lock(queue.mutex, std::try_to_lock);
+            if (lock.owns_lock()) {
+                queue.tasks[p].push_back(std::move(task));
+                hasPushed = true;
+            }
+        }
+        if (!hasPushed) {
+            WorkerQueue& queue = *_queues[start];
+            const std::lock_guard lock(queue.mutex);
+            queue.tasks[p].push_back(std::move(task));
+        }
+    }
+
+    if (_numSleeping > 0) {
+        // Taking the lock here guarantees that a worker that is about to go to sleep has
+        // either seen the new task count or is already waiting on the condition
+        { const std::lock_guard lock(_sleepMutex); }
+        _sleepCondition.notify_one();
+    }
+}
+
+void TaskScheduler::clearTasks() {
+    std::vector<ScheduledTask> removed;
+    for (std::unique_ptr<WorkerQueue>& queue : _queues) {
+        const std::lock_guard lock(queue->mutex);
+        for (size_t p = 0; p < NumPriorities; p++) {
+            std::deque<ScheduledTask>& tasks = queue->tasks[p];
+            const int64_t n = static_cast<int64_t>(tasks.size());
+            _numQueued -= n;
+            _numQueuedPerPriority[p] -= n;
+            std::move(tasks.begin(), tasks.end(), std::back_inserter(removed));
+            tasks.clear();
+        }
+    }
+    // `removed` is destroyed here, outside of the queue locks, as destroying a task might
+    // enqueue new tasks
+}
+
+size_t TaskScheduler::numQueuedTasks() const {
+    return static_cast<size_t>(std::max<int64_t>(_numQueued, 0));
+}
+
+size_t TaskScheduler::numThreads() const {
+    return _workers.size();
+}
+
+bool TaskScheduler::isWorkerThread() const {
+    return CurrentScheduler == this;
+}
+
+void TaskScheduler::workerLoop(size_t index) {
+    CurrentScheduler = this;
+    CurrentQueueIndex = index;
+
+    ScheduledTask task;
+    while (!_stop) {
+        if (tryPop(index, task)) {
+            task();
+            task = ScheduledTask();
+            continue;
+        }
+
+        std::unique_lock lock(_sleepMutex);
+        _numSleeping++;
+        _sleepCondition.wait(lock, [this]() { return _stop || _numQueued > 0; });
+        _numSleeping--;
+    }
+}
+
+bool TaskScheduler::tryPop(size_t index, ScheduledTask& task) {
+    const size_t n = _queues.size();
+    for (size_t p = 0; p < NumPriorities; p++) {
+        if (_numQueuedPerPriority[p] <= 0) {
+            continue;
+        }
+
+        // Own queue first, then try to steal from the others without blocking, and only
+        // if that fails block on each of the other queues in turn
+        if (tryPopFrom(*_queues[index], p, task, true)) {
+            return true;
+        }
+        for (size_t i = 1; i < n; i++) {
+            if (tryPopFrom(*_queues[(index + i) % n], p, task, false)) {
+                return true;
+            }
+        }
+        for (size_t i = 1; i < n; i++) {
+            if (tryPopFrom(*_queues[(index + i) % n], p, task, true)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::tryPopFrom(WorkerQueue& queue, size_t priority, ScheduledTask& task,
+                               bool block)
+{
+    std::unique_lock lock(queue.mutex, std::defer_lock);
+    if (block) {
+        lock.lock();
+    }
+    else if (!lock.try_lock()) {
+        return false;
+    }
+
+    std::deque<ScheduledTask>& tasks = queue.tasks[priority];
+    if (tasks.empty()) {
+        return false;
+    }
+    task = std::move(tasks.front());
+    tasks.pop_front();
+    _numQueued--;
+    _numQueuedPerPriority[priority]--;
+    return true;
+}
+
+} // namespace openspace
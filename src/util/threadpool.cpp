@@ -26,77 +26,83 @@
 
 namespace openspace {
 
-Worker::Worker(ThreadPool& p) : pool(p) {}
+ThreadPool::ThreadPool(size_t numThreads)
+    : _ownedScheduler(std::make_unique<TaskScheduler>(numThreads))
+    , _scheduler(_ownedScheduler.get())
+{}
+
+ThreadPool::ThreadPool(TaskScheduler& scheduler)
+    : _scheduler(&scheduler)
+{}
+
+ThreadPool::ThreadPool(const ThreadPool& toCopy)
+    : _ownedScheduler(
+        toCopy._ownedScheduler ?
+            std::make_unique<TaskScheduler>(toCopy._ownedScheduler->numThreads()) :
+            nullptr
+    )
+    , _scheduler(_ownedScheduler ? _ownedScheduler.get() : toCopy._scheduler)
+{}
 
-void Worker::operator()() {
-    std::function<void()> task;
-    while (true) {
-        {
-            std::unique_lock lock(pool.queue_mutex);
-
-            // look for a work item
-            while (!pool.stop && pool.tasks.empty()) {
-                // if there are none wait for notification
-                pool.condition.wait(lock);
-            }
-
-            if (pool.stop) { // exit if the pool is stopped
-                return;
-            }
-
-            // get the task from the queue
-            task = pool.tasks.front();
-            pool.tasks.pop_front();
-        }
+ThreadPool::~ThreadPool() {
+    std::unique_lock lock(_state->mutex);
+    _state->isStopped = true;
+    _state->condition.wait(lock, [this]() { return _state->nRunning == 0; });
+    lock.unlock();
+
+    // Destroying the owned scheduler joins its threads, the remaining tasks will be
+    // discarded. Tasks in a shared scheduler will see the stopped state and return
+    _ownedScheduler = nullptr;
+}
 
-        // execute the task
-        task();
-    }
+uint64_t ThreadPool::State::registerTask() {
+    const std::lock_guard lock(mutex);
+    nQueued++;
+    return generation;
 }
 
-ThreadPool::ThreadPool(size_t numThreads) : stop(false) {
-    for (size_t i = 0; i < numThreads; i++) {
-        workers.emplace_back(Worker(*this));
+bool ThreadPool::State::beginTask(uint64_t taskGeneration) {
+    const std::lock_guard lock(mutex);
+    if (generation != taskGeneration) {
+        // This task was already removed from the queued count by clearTasks
+        return false;
+    }
+    nQueued--;
+    if (isStopped) {
+        return false;
     }
+    nRunning++;
+    return true;
 }
 
-ThreadPool::ThreadPool(const ThreadPool& toCopy) : ThreadPool(toCopy.workers.size()) {}
-
-// the destructor joins all threads
-ThreadPool::~ThreadPool() {
-    // stop all threads
+void ThreadPool::State::endTask() {
     {
-        const std::unique_lock lock(queue_mutex);
-        stop = true;
+        const std::lock_guard lock(mutex);
+        nRunning--;
     }
     condition.notify_all();
-
-    // join them
-    for (std::thread& w : workers) {
-        w.join();
-    }
 }
 
-// add new work item to the pool
-void ThreadPool::enqueue(std::function<void()> f) {
+void ThreadPool::clearTasks() {
+    // Tasks that were enqueued before this call will see the new generation and return
+    // without doing any work or touching the queued count. Only an owned scheduler can
+    // be cleared outright
     {
-        const std::unique_lock lock(queue_mutex);
-
-        // add the task
-        tasks.push_back(std::move(f));
+        const std::lock_guard lock(_state->mutex);
+        _state->generation++;
+        _state->nQueued = 0;
+    }
+    if (_ownedScheduler) {
+        _ownedScheduler->clearTasks();
     }
-
-    // wake up one thread
-    condition.notify_one();
 }
 
-void ThreadPool::clearTasks() {
-    const std::unique_lock lock(queue_mutex);
-    tasks.clear();
+bool ThreadPool::hasOutstandingTasks() const {
+    return _state->nQueued > 0;
 }
 
-bool ThreadPool::hasOutstandingTasks() const {
-    return !tasks.empty();
+TaskScheduler& ThreadPool::scheduler() {
+    return *_scheduler;
 }
 
 } // namespace openspace
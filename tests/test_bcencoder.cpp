@@ -0,0 +1,254 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/globebrowsing/src/bcencoder.h>
+#include <modules/globebrowsing/src/rawtile.h>
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <array>
+#include <cstdlib>
+#include <vector>
+
+using namespace openspace::globebrowsing;
+
+namespace {
+    using Compression = TileTextureInitData::Compression;
+
+    // Returns the largest difference of any channel between the two images
+    int maxError(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+        int res = 0;
+        for (size_t i = 0; i < a.size(); i++) {
+            const int d = static_cast<int>(a[i]) - static_cast<int>(b[i]);
+            res = std::max(res, std::abs(d));
+        }
+        return res;
+    }
+
+    std::vector<uint8_t> gradientImage(int width, int height) {
+        std::vector<uint8_t> res(static_cast<size_t>(width) * height * 4);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                uint8_t* pixel = &res[(static_cast<size_t>(y) * width + x) * 4];
+                pixel[0] = static_cast<uint8_t>(x * 255 / (width - 1));
+                pixel[1] = static_cast<uint8_t>(y * 255 / (height - 1));
+                pixel[2] = static_cast<uint8_t>(128);
+                pixel[3] = static_cast<uint8_t>(255 - x * 255 / (width - 1));
+            }
+        }
+        return res;
+    }
+
+    std::vector<uint8_t> roundTrip(Compression compression,
+                                   const std::vector<uint8_t>& rgba, int width,
+                                   int height)
+    {
+        const size_t nBytes = compressedLevelSize(compression, width, height);
+        std::vector<std::byte> compressed(nBytes);
+        bc::compressImage(compression, rgba.data(), width, height, compressed.data());
+        std::vector<uint8_t> res(rgba.size());
+        bc::decompressImage(compression, compressed.data(), width, height, res.data());
+        return res;
+    }
+} // namespace
+
+TEST_CASE("BCEncoder: Compressed Size", "[bcencoder]") {
+    CHECK(nCompressedMipLevels(256, 256) == 7);
+    CHECK(nCompressedMipLevels(512, 256) == 7);
+    CHECK(nCompressedMipLevels(12, 12) == 1);
+    CHECK(nCompressedMipLevels(2, 2) == 0);
+
+    CHECK(compressedLevelSize(Compression::BC1, 256, 256) == 64 * 64 * 8);
+    CHECK(compressedLevelSize(Compression::BC7, 256, 256) == 64 * 64 * 16);
+
+    const TileTextureInitData bc1 = TileTextureInitData(
+        16,
+        16,
+        GL_UNSIGNED_BYTE,
+        ghoul::opengl::Texture::Format::RGBA,
+        TileTextureInitData::ShouldAllocateDataOnCPU::No,
+        Compression::BC1
+    );
+    // 16x16, 8x8, and 4x4 pixels with 16, 4, and 1 blocks
+    CHECK(bc1.textureNumBytes == (16 + 4 + 1) * 8);
+    CHECK(bc1.totalNumBytes == 16 * 16 * 4);
+
+    const TileTextureInitData uncompressed = TileTextureInitData(
+        16,
+        16,
+        GL_UNSIGNED_BYTE,
+        ghoul::opengl::Texture::Format::RGBA
+    );
+    CHECK(uncompressed.textureNumBytes == uncompressed.totalNumBytes);
+    CHECK(uncompressed.hashKey != bc1.hashKey);
+
+    CHECK(supportsCompression(uncompressed, Compression::BC7));
+    const TileTextureInitData height = TileTextureInitData(
+        16,
+        16,
+        GL_FLOAT,
+        ghoul::opengl::Texture::Format::Red
+    );
+    CHECK_FALSE(supportsCompression(height, Compression::BC1));
+    CHECK(supportsCompression(height, Compression::None));
+}
+
+TEST_CASE("BCEncoder: Solid Color", "[bcencoder]") {
+    std::array<uint8_t, 64> block;
+    for (size_t i = 0; i < 16; i++) {
+        block[4 * i + 0] = 200;
+        block[4 * i + 1] = 100;
+        block[4 * i + 2] = 50;
+        block[4 * i + 3] = 255;
+    }
+
+    std::array<std::byte, 16> compressed;
+    std::array<uint8_t, 64> decoded;
+
+    bc::encodeBC1Block(block.data(), compressed.data());
+    bc::decodeBC1Block(compressed.data(), decoded.data());
+    for (size_t i = 0; i < 64; i++) {
+        // Limited by the 5 bits of the red and blue channels
+        CHECK(std::abs(static_cast<int>(decoded[i]) - static_cast<int>(block[i])) <= 4);
+    }
+
+    bc::encodeBC7Block(block.data(), compressed.data());
+    bc::decodeBC7Block(compressed.data(), decoded.data());
+    for (size_t i = 0; i < 64; i++) {
+        CHECK(std::abs(static_cast<int>(decoded[i]) - static_cast<int>(block[i])) <= 1);
+    }
+}
+
+TEST_CASE("BCEncoder: Anti-Correlated Colors", "[bcencoder]") {
+    // A checkerboard of red and green pixels, whose channels are anti-correlated, so
+    // that the principal axis is orthogonal to the diagonal of the color space
+    std::array<uint8_t, 64> block;
+    for (size_t i = 0; i < 16; i++) {
+        const bool isRed = (i % 2 == 0) != ((i / 4) % 2 == 0);
+        block[4 * i + 0] = isRed ? 255 : 0;
+        block[4 * i + 1] = isRed ? 0 : 255;
+        block[4 * i + 2] = 0;
+        block[4 * i + 3] = 255;
+    }
+
+    std::array<std::byte, 16> compressed;
+    std::array<uint8_t, 64> decoded;
+
+    bc::encodeBC1Block(block.data(), compressed.data());
+    bc::decodeBC1Block(compressed.data(), decoded.data());
+    for (size_t i = 0; i < 64; i++) {
+        CHECK(std::abs(static_cast<int>(decoded[i]) - static_cast<int>(block[i])) <= 4);
+    }
+
+    bc::encodeBC7Block(block.data(), compressed.data());
+    bc::decodeBC7Block(compressed.data(), decoded.data());
+    for (size_t i = 0; i < 64; i++) {
+        CHECK(std::abs(static_cast<int>(decoded[i]) - static_cast<int>(block[i])) <= 1);
+    }
+}
+
+TEST_CASE("BCEncoder: BC1 Gradient", "[bcencoder]") {
+    std::vector<uint8_t> image = gradientImage(64, 64);
+    // BC1 only stores opaque pixels
+    for (size_t i = 3; i < image.size(); i += 4) {
+        image[i] = 255;
+    }
+
+    const std::vector<uint8_t> decoded = roundTrip(Compression::BC1, image, 64, 64);
+    CHECK(maxError(image, decoded) <= 16);
+}
+
+TEST_CASE("BCEncoder: BC1 Transparency", "[bcencoder]") {
+    std::array<uint8_t, 64> block;
+    for (size_t i = 0; i < 16; i++) {
+        block[4 * i + 0] = static_cast<uint8_t>(i * 16);
+        block[4 * i + 1] = 64;
+        block[4 * i + 2] = 32;
+        block[4 * i + 3] = i % 2 == 0 ? 0 : 255;
+    }
+
+    std::array<std::byte, 8> compressed;
+    bc::encodeBC1Block(block.data(), compressed.data());
+    std::array<uint8_t, 64> decoded;
+    bc::decodeBC1Block(compressed.data(), decoded.data());
+    for (size_t i = 0; i < 16; i++) {
+        CHECK(decoded[4 * i + 3] == block[4 * i + 3]);
+    }
+}
+
+TEST_CASE("BCEncoder: BC7 Gradient", "[bcencoder]") {
+    const std::vector<uint8_t> image = gradientImage(64, 64);
+    const std::vector<uint8_t> decoded = roundTrip(Compression::BC7, image, 64, 64);
+    CHECK(maxError(image, decoded) <= 8);
+}
+
+TEST_CASE("BCEncoder: Transcode Tile", "[bcencoder]") {
+    constexpr int Size = 32;
+
+    RawTile tile;
+    tile.textureInitData = TileTextureInitData(
+        Size,
+        Size,
+        GL_UNSIGNED_BYTE,
+        ghoul::opengl::Texture::Format::BGRA
+    );
+    const size_t nBytes = tile.textureInitData->totalNumBytes;
+    tile.imageData = std::unique_ptr<std::byte[]>(new std::byte[nBytes]);
+    for (size_t i = 0; i < nBytes; i += 4) {
+        // Pure blue in BGRA order
+        tile.imageData[i + 0] = std::byte(255);
+        tile.imageData[i + 1] = std::byte(0);
+        tile.imageData[i + 2] = std::byte(0);
+        tile.imageData[i + 3] = std::byte(255);
+    }
+
+    const RawTile compressed = bc::transcodeTile(std::move(tile), Compression::BC7);
+    REQUIRE(compressed.textureInitData.has_value());
+    CHECK(compressed.textureInitData->compression == Compression::BC7);
+    CHECK(compressed.textureInitData->dimensions.x == Size);
+    const size_t expected =
+        compressedLevelSize(Compression::BC7, 32, 32) +
+        compressedLevelSize(Compression::BC7, 16, 16) +
+        compressedLevelSize(Compression::BC7, 8, 8) +
+        compressedLevelSize(Compression::BC7, 4, 4);
+    CHECK(compressed.textureInitData->textureNumBytes == expected);
+
+    // The smallest mipmap level is the last block of the data and is stored in RGBA order
+    std::array<uint8_t, 64> decoded;
+    bc::decodeBC7Block(&compressed.imageData[expected - 16], decoded.data());
+    CHECK(decoded[0] <= 1);
+    CHECK(decoded[1] <= 1);
+    CHECK(decoded[2] >= 254);
+    CHECK(decoded[3] >= 254);
+}
+
+TEST_CASE("BCEncoder: Transcode Failed Tile", "[bcencoder]") {
+    RawTile tile;
+    tile.error = RawTile::ReadError::Failure;
+    const RawTile res = bc::transcodeTile(std::move(tile), Compression::BC1);
+    CHECK(res.error == RawTile::ReadError::Failure);
+    CHECK(!res.imageData);
+    CHECK(!res.textureInitData.has_value());
+}
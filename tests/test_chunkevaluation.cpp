@@ -0,0 +1,210 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <modules/globebrowsing/src/chunkevaluation.h>
+#include <modules/globebrowsing/src/ellipsoid.h>
+#include <openspace/util/taskscheduler.h>
+#include <ghoul/glm.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace openspace::globebrowsing;
+
+namespace {
+    const Ellipsoid Earth = Ellipsoid(glm::dvec3(6378137.0, 6378137.0, 6356752.3));
+
+    constexpr BoundingHeights Heights = {
+        .min = 0.f,
+        .max = 8000.f,
+        .available = true,
+        .tileOK = true
+    };
+
+    // Creates all chunks between level 2 and the provided level, with their corners
+    // spanning the surface and the maximum height of the chunk
+    std::vector<Chunk> createChunks(int maxLevel) {
+        std::vector<Chunk> chunks;
+        for (int level = 2; level <= maxLevel; level++) {
+            const uint32_t nX = 1u << level;
+            const uint32_t nY = 1u << (level - 1);
+            for (uint32_t y = 0; y < nY; y++) {
+                for (uint32_t x = 0; x < nX; x++) {
+                    Chunk& chunk = chunks.emplace_back(
+                        TileIndex(x, y, static_cast<uint8_t>(level))
+                    );
+
+                    const std::array<Quad, 4> quads = {
+                        NORTH_WEST, NORTH_EAST, SOUTH_WEST, SOUTH_EAST
+                    };
+                    for (size_t i = 0; i < quads.size(); i++) {
+                        const Geodetic2 c = chunk.surfacePatch.corner(quads[i]);
+                        const glm::dvec3 low =
+                            Earth.cartesianPosition({ c, Heights.min });
+                        const glm::dvec3 high =
+                            Earth.cartesianPosition({ c, Heights.max });
+                        chunk.corners[i] = glm::dvec4(low, 1.0);
+                        chunk.corners[i + 4] = glm::dvec4(high, 1.0);
+                    }
+                }
+            }
+        }
+        return chunks;
+    }
+
+    ChunkEvaluationContext contextAt(const glm::dvec3& cameraPosition) {
+        const glm::dmat4 projection = glm::perspective(
+            glm::radians(60.0),
+            16.0 / 9.0,
+            1.0,
+            1e9
+        );
+        const glm::dmat4 view = glm::lookAt(
+            cameraPosition,
+            glm::dvec3(0.0),
+            glm::dvec3(0.0, 0.0, 1.0)
+        );
+
+        ChunkEvaluationContext context;
+        context.ellipsoid = &Earth;
+        context.cameraPosition = cameraPosition;
+        context.cameraGeodetic = Earth.cartesianToGeodetic2(cameraPosition);
+        context.modelViewProjection = projection * view;
+        return context;
+    }
+
+    glm::dvec3 positionAt(double latitude, double longitude, double altitude) {
+        const Geodetic3 g = {
+            .geodetic2 = Geodetic2{ glm::radians(latitude), glm::radians(longitude) },
+            .height = altitude
+        };
+        return Earth.cartesianPosition(g);
+    }
+} // namespace
+
+TEST_CASE("ChunkEvaluation: Horizon culling", "[chunkevaluation]") {
+    ChunkEvaluationContext context = contextAt(positionAt(0.0, 0.0, 1000000.0));
+
+    // A chunk directly below the camera and one on the opposite side of the globe
+    const Chunk below = Chunk(TileIndex(8, 4, 4));
+    const Chunk opposite = Chunk(TileIndex(0, 4, 4));
+
+    CHECK_FALSE(isCullableByHorizon(below, Heights, context));
+    CHECK(isCullableByHorizon(opposite, Heights, context));
+
+    context.performFrustumCulling = false;
+    CHECK(evaluateChunk(below, Heights, context).isVisible);
+    CHECK_FALSE(evaluateChunk(opposite, Heights, context).isVisible);
+
+    context.performHorizonCulling = false;
+    CHECK(evaluateChunk(opposite, Heights, context).isVisible);
+}
+
+TEST_CASE(
+    "ChunkEvaluation: Desired level increases closer to the chunk",
+    "[chunkevaluation]"
+)
+{
+    const Chunk chunk = Chunk(TileIndex(8, 4, 4));
+
+    ChunkEvaluationContext farContext = contextAt(positionAt(0.0, 0.0, 5000000.0));
+    ChunkEvaluationContext nearContext = contextAt(positionAt(0.0, 0.0, 5000.0));
+
+    farContext.levelByProjectedArea = true;
+    nearContext.levelByProjectedArea = true;
+    CHECK(
+        desiredLevelByProjectedArea(chunk, Heights, farContext) <
+        desiredLevelByProjectedArea(chunk, Heights, nearContext)
+    );
+
+    farContext.levelByProjectedArea = false;
+    nearContext.levelByProjectedArea = false;
+    CHECK(
+        evaluateChunk(chunk, Heights, farContext).desiredLevel <
+        evaluateChunk(chunk, Heights, nearContext).desiredLevel
+    );
+}
+
+TEST_CASE("ChunkEvaluation: Parallel evaluation matches serial", "[chunkevaluation]") {
+    const std::vector<Chunk> chunks = createChunks(7);
+    std::vector<const Chunk*> pointers;
+    for (const Chunk& chunk : chunks) {
+        pointers.push_back(&chunk);
+    }
+    const std::vector<BoundingHeights> heights = std::vector(chunks.size(), Heights);
+
+    const ChunkEvaluationContext context = contextAt(positionAt(45.0, 10.0, 20000.0));
+
+    std::vector<ChunkEvaluation> serial = std::vector<ChunkEvaluation>(chunks.size());
+    evaluateChunks(pointers, heights, context, serial);
+
+    openspace::TaskScheduler scheduler(4);
+    std::vector<ChunkEvaluation> parallel = std::vector<ChunkEvaluation>(chunks.size());
+    evaluateChunks(pointers, heights, context, parallel, &scheduler);
+
+    size_t nVisible = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        CHECK(serial[i].isVisible == parallel[i].isVisible);
+        CHECK(serial[i].desiredLevel == parallel[i].desiredLevel);
+        if (serial[i].isVisible) {
+            nVisible++;
+        }
+    }
+
+    // Some, but not all, of the chunks should be visible from the camera position
+    CHECK(nVisible > 0);
+    CHECK(nVisible < chunks.size());
+}
+
+TEST_CASE(
+    "ChunkEvaluation: Benchmark serial and parallel evaluation",
+    "[.][chunkevaluation][benchmark]"
+)
+{
+    const std::vector<Chunk> chunks = createChunks(9);
+    std::vector<const Chunk*> pointers;
+    for (const Chunk& chunk : chunks) {
+        pointers.push_back(&chunk);
+    }
+    const std::vector<BoundingHeights> heights = std::vector(chunks.size(), Heights);
+    const ChunkEvaluationContext context = contextAt(positionAt(45.0, 10.0, 20000.0));
+    std::vector<ChunkEvaluation> results = std::vector<ChunkEvaluation>(chunks.size());
+
+    BENCHMARK("Serial") {
+        evaluateChunks(pointers, heights, context, results);
+        return results.front().desiredLevel;
+    };
+
+    openspace::TaskScheduler scheduler(
+        std::max(std::thread::hardware_concurrency() / 2, 1u)
+    );
+    BENCHMARK("Parallel") {
+        evaluateChunks(pointers, heights, context, results, &scheduler);
+        return results.front().desiredLevel;
+    };
+}
@@ -23,8 +23,21 @@
  ****************************************************************************************/
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 
 #include <openspace/util/concurrentqueue.h>
+#include <openspace/util/lockfreeconcurrentqueue.h>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr int NProducers = 4;
+    constexpr int NConsumers = 4;
+    constexpr int NItemsPerProducer = 25000;
+} // namespace
 
 TEST_CASE("ConcurrentQueue: Basic", "[concurrentqueue]") {
     using namespace openspace;
@@ -34,3 +47,217 @@ TEST_CASE("ConcurrentQueue: Basic", "[concurrentqueue]") {
     const int val = q1.pop();
     CHECK(val == 4);
 }
+
+TEST_CASE("LockFreeConcurrentQueue: Basic", "[concurrentqueue]") {
+    using namespace openspace;
+
+    LockFreeConcurrentQueue<int> q(3);
+    CHECK(q.capacity() == 4);
+    CHECK(q.empty());
+
+    CHECK(q.tryPush(1));
+    CHECK(q.tryPush(2));
+    CHECK(q.size() == 2);
+
+    int val = 0;
+    CHECK(q.tryPop(val));
+    CHECK(val == 1);
+    CHECK(q.tryPop(val));
+    CHECK(val == 2);
+    CHECK_FALSE(q.tryPop(val));
+}
+
+TEST_CASE("LockFreeConcurrentQueue: Full", "[concurrentqueue]") {
+    using namespace openspace;
+
+    LockFreeConcurrentQueue<int> q(4);
+    for (int i = 0; i < 4; i++) {
+        CHECK(q.tryPush(i));
+    }
+    CHECK_FALSE(q.tryPush(4));
+
+    // Wrapping around has to keep the order intact
+    int val = 0;
+    CHECK(q.tryPop(val));
+    CHECK(val == 0);
+    CHECK(q.tryPush(4));
+
+    std::vector<int> res;
+    CHECK(q.tryPopBulk(std::back_inserter(res), 10) == 4);
+    CHECK(res == std::vector<int>{ 1, 2, 3, 4 });
+}
+
+TEST_CASE("LockFreeConcurrentQueue: Bulk", "[concurrentqueue]") {
+    using namespace openspace;
+
+    LockFreeConcurrentQueue<int> q(8);
+    std::vector<int> values(10);
+    std::iota(values.begin(), values.end(), 0);
+    CHECK(q.tryPushBulk(values.data(), values.size()) == 8);
+    CHECK(q.size() == 8);
+
+    std::vector<int> res;
+    CHECK(q.tryPopBulk(std::back_inserter(res), 3) == 3);
+    CHECK(res == std::vector<int>{ 0, 1, 2 });
+    CHECK(q.tryPushBulk(values.data() + 8, 2) == 2);
+
+    res.clear();
+    CHECK(q.tryPopBulk(std::back_inserter(res), 100) == 7);
+    CHECK(res == std::vector<int>{ 3, 4, 5, 6, 7, 8, 9 });
+    CHECK(q.empty());
+}
+
+TEST_CASE("LockFreeConcurrentQueue: Stress", "[concurrentqueue]") {
+    using namespace openspace;
+
+    // Every producer pushes a distinct range of values, some of them in bulk. All values
+    // have to arrive exactly once and values of each producer have to arrive in order
+    LockFreeConcurrentQueue<int> q(64);
+    std::atomic_int nConsumed = 0;
+    constexpr int NTotal = NProducers * NItemsPerProducer;
+
+    std::vector<std::vector<int>> consumed(NConsumers);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < NConsumers; c++) {
+        threads.emplace_back([&, c]() {
+            std::vector<int>& res = consumed[c];
+            while (nConsumed < NTotal) {
+                const size_t n = q.tryPopBulk(std::back_inserter(res), 16);
+                nConsumed += static_cast<int>(n);
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int p = 0; p < NProducers; p++) {
+        threads.emplace_back([&q, p]() {
+            const int base = p * NItemsPerProducer;
+            int i = 0;
+            while (i < NItemsPerProducer) {
+                if (i % 3 == 0) {
+                    q.push(base + i);
+                    i++;
+                }
+                else {
+                    std::vector<int> batch;
+                    for (int j = i; j < std::min(i + 7, NItemsPerProducer); j++) {
+                        batch.push_back(base + j);
+                    }
+                    q.pushBulk(batch.data(), batch.size());
+                    i += static_cast<int>(batch.size());
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    for (const std::vector<int>& res : consumed) {
+        std::vector<int> last(NProducers, -1);
+        bool isOrdered = true;
+        for (int v : res) {
+            const int p = v / NItemsPerProducer;
+            isOrdered &= v > last[p];
+            last[p] = v;
+        }
+        CHECK(isOrdered);
+    }
+
+    std::vector<int> all;
+    for (const std::vector<int>& res : consumed) {
+        all.insert(all.end(), res.begin(), res.end());
+    }
+    std::sort(all.begin(), all.end());
+    REQUIRE(all.size() == static_cast<size_t>(NTotal));
+    bool isComplete = true;
+    for (int i = 0; i < NTotal; i++) {
+        isComplete &= all[i] == i;
+    }
+    CHECK(isComplete);
+    CHECK(q.empty());
+}
+
+TEST_CASE("ConcurrentQueue: Throughput Benchmark", "[.][concurrentqueue][benchmark]") {
+    using namespace openspace;
+
+    constexpr int NTotal = NProducers * NItemsPerProducer;
+
+    BENCHMARK("ConcurrentQueue") {
+        ConcurrentQueue<int> q;
+        std::vector<std::thread> threads;
+        for (int p = 0; p < NProducers; p++) {
+            threads.emplace_back([&q]() {
+                for (int i = 0; i < NItemsPerProducer; i++) {
+                    q.push(i);
+                }
+            });
+        }
+        for (int c = 0; c < NConsumers; c++) {
+            threads.emplace_back([&q]() {
+                for (int i = 0; i < NTotal / NConsumers; i++) {
+                    q.pop();
+                }
+            });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    };
+
+    BENCHMARK("LockFreeConcurrentQueue") {
+        LockFreeConcurrentQueue<int> q(1024);
+        std::vector<std::thread> threads;
+        for (int p = 0; p < NProducers; p++) {
+            threads.emplace_back([&q]() {
+                for (int i = 0; i < NItemsPerProducer; i++) {
+                    q.push(i);
+                }
+            });
+        }
+        for (int c = 0; c < NConsumers; c++) {
+            threads.emplace_back([&q]() {
+                int val = 0;
+                for (int i = 0; i < NTotal / NConsumers;) {
+                    if (q.tryPop(val)) {
+                        i++;
+                    }
+                    else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    };
+
+    BENCHMARK("LockFreeConcurrentQueue (bulk)") {
+        LockFreeConcurrentQueue<int> q(1024);
+        std::vector<std::thread> threads;
+        for (int p = 0; p < NProducers; p++) {
+            threads.emplace_back([&q]() {
+                for (int i = 0; i < NItemsPerProducer; i++) {
+                    q.push(i);
+                }
+            });
+        }
+        for (int c = 0; c < NConsumers; c++) {
+            threads.emplace_back([&q]() {
+                std::vector<int> res;
+                res.reserve(NTotal / NConsumers);
+                while (res.size() < static_cast<size_t>(NTotal / NConsumers)) {
+                    const size_t remaining = NTotal / NConsumers - res.size();
+                    if (q.tryPopBulk(std::back_inserter(res), remaining) == 0) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    };
+}
@@ -0,0 +1,422 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <openspace/data/columnkernels.h>
+#include <openspace/data/csvloader.h>
+#include <openspace/data/dataloader.h>
+#include <openspace/data/datamapping.h>
+#include <openspace/data/parallelparsing.h>
+#include <atomic>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace openspace::dataloader;
+
+namespace {
+    Dataset createDataset(int nEntries) {
+        Dataset res;
+        res.variables = { { 0, "first" }, { 1, "second" } };
+        res.textures = { { 2, "texture.png" } };
+        res.textureDataIndex = 1;
+        res.maxPositionComponent = 3.f * (nEntries - 1);
+        res.columns.resize(2);
+        res.reserve(nEntries);
+        for (int i = 0; i < nEntries; i++) {
+            const std::array<float, 2> values = {
+                static_cast<float>(i),
+                static_cast<float>(-i)
+            };
+            std::optional<std::string> comment;
+            if (i % 3 == 0) {
+                comment = "Comment " + std::to_string(i);
+            }
+            res.addEntry(glm::vec3(i, 2.f * i, 3.f * i), values, comment);
+        }
+        return res;
+    }
+
+    std::vector<float> createColumn(size_t nValues) {
+        std::mt19937 gen(1337);
+        std::uniform_real_distribution<float> dist(-1000.f, 1000.f);
+        std::vector<float> res;
+        res.reserve(nValues);
+        for (size_t i = 0; i < nValues; i++) {
+            // Sprinkle in some missing values
+            res.push_back(
+                i % 97 == 0 ? std::numeric_limits<float>::quiet_NaN() : dist(gen)
+            );
+        }
+        return res;
+    }
+} // namespace
+
+TEST_CASE("DataLoader: Columnar Dataset", "[dataloader]") {
+    const Dataset dataset = createDataset(10);
+    REQUIRE(dataset.size() == 10);
+    REQUIRE(dataset.nValues() == 2);
+    CHECK(dataset.positions[4] == glm::vec3(4.f, 8.f, 12.f));
+    CHECK(dataset.columns[1][4] == -4.f);
+    CHECK(dataset.comment(3) == "Comment 3");
+    CHECK(!dataset.comment(4).has_value());
+    CHECK(dataset.findValueRange("first") == glm::vec2(0.f, 9.f));
+    CHECK(dataset.findValueRange("missing") == glm::vec2(0.f));
+
+    Dataset normalized = dataset;
+    REQUIRE(normalized.normalizeVariable("second"));
+    CHECK(normalized.columns[1].front() == 1.f);
+    CHECK(normalized.columns[1].back() == 0.f);
+    CHECK(!normalized.normalizeVariable("missing"));
+}
+
+TEST_CASE("DataLoader: Cache Roundtrip", "[dataloader]") {
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_dataloader_roundtrip.cache";
+
+    const Dataset dataset = createDataset(1000);
+    data::saveCachedFile(dataset, file);
+
+    const std::optional<Dataset> loaded = data::loadCachedFile(file);
+    REQUIRE(loaded.has_value());
+    CHECK(loaded->variables.size() == dataset.variables.size());
+    CHECK(loaded->variables[1].name == "second");
+    CHECK(loaded->textures[0].file == "texture.png");
+    CHECK(loaded->textureDataIndex == 1);
+    CHECK(loaded->orientationDataIndex == -1);
+    CHECK(loaded->maxPositionComponent == dataset.maxPositionComponent);
+    CHECK(loaded->positions == dataset.positions);
+    CHECK(loaded->columns == dataset.columns);
+    CHECK(loaded->commentOffsets == dataset.commentOffsets);
+    CHECK(loaded->commentPool == dataset.commentPool);
+}
+
+TEST_CASE("DataLoader: Mapped View", "[dataloader]") {
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_dataloader_view.cache";
+
+    data::saveCachedFile(createDataset(100), file);
+
+    const std::optional<MappedDataset> mapped = data::mapCachedFile(file);
+    REQUIRE(mapped.has_value());
+    const DatasetView& view = mapped->view;
+    REQUIRE(view.size() == 100);
+    REQUIRE(view.nValues() == 2);
+    CHECK(view.index("second") == 1);
+    CHECK(view.positions[10] == glm::vec3(10.f, 20.f, 30.f));
+    CHECK(view.columns[0][42] == 42.f);
+    CHECK(view.columns[1][42] == -42.f);
+    CHECK(view.comment(3) == "Comment 3");
+    CHECK(!view.comment(4).has_value());
+    CHECK(view.findValueRange("second") == glm::vec2(-99.f, 0.f));
+
+    const Labelset labels = label::loadFromDataset(view);
+    REQUIRE(labels.entries.size() == 100);
+    CHECK(labels.entries[6].text == "Comment 6");
+    CHECK(labels.entries[7].text == "MISSING LABEL");
+}
+
+TEST_CASE("DataLoader: Invalid Cache", "[dataloader]") {
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_dataloader_invalid.cache";
+
+    data::saveCachedFile(createDataset(100), file);
+    std::filesystem::resize_file(file, std::filesystem::file_size(file) - 1);
+    CHECK(!data::mapCachedFile(file).has_value());
+    CHECK(!data::loadCachedFile(file).has_value());
+
+    CHECK(!data::mapCachedFile(file.string() + ".missing").has_value());
+}
+
+TEST_CASE("DataLoader: Invalid Cache Header", "[dataloader]") {
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_dataloader_header.cache";
+
+    // Overwrites the number of entries and values, which are stored at byte 8 and 16 of
+    // the header, with counts whose product overflows
+    auto writeCounts = [&file](uint64_t nEntries, uint32_t nValues) {
+        data::saveCachedFile(createDataset(100), file);
+        std::fstream f = std::fstream(
+            file,
+            std::ios::in | std::ios::out | std::ios::binary
+        );
+        f.seekp(8);
+        f.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint64_t));
+        f.seekp(16);
+        f.write(reinterpret_cast<const char*>(&nValues), sizeof(uint32_t));
+    };
+
+    writeCounts(100, 2);
+    CHECK(data::mapCachedFile(file).has_value());
+
+    writeCounts(uint64_t(1) << 62, 4);
+    CHECK(!data::mapCachedFile(file).has_value());
+
+    writeCounts(100, std::numeric_limits<uint32_t>::max());
+    CHECK(!data::mapCachedFile(file).has_value());
+
+    writeCounts(std::numeric_limits<uint64_t>::max(), 0);
+    CHECK(!data::mapCachedFile(file).has_value());
+}
+
+TEST_CASE("DataLoader: Kernels", "[dataloader]") {
+    // Use an odd size so that the scalar tail of the kernels is exercised as well
+    const std::vector<float> values = createColumn(1001);
+
+    float minValue = std::numeric_limits<float>::max();
+    float maxValue = -std::numeric_limits<float>::max();
+    for (float v : values) {
+        if (!std::isnan(v)) {
+            minValue = std::min(minValue, v);
+            maxValue = std::max(maxValue, v);
+        }
+    }
+    CHECK(kernels::findValueRange(values) == glm::vec2(minValue, maxValue));
+
+    const std::vector<float> allNan = std::vector<float>(
+        17,
+        std::numeric_limits<float>::quiet_NaN()
+    );
+    CHECK(
+        kernels::findValueRange(allNan) ==
+        glm::vec2(std::numeric_limits<float>::max(), -std::numeric_limits<float>::max())
+    );
+
+    std::vector<float> normalized = values;
+    kernels::normalize(normalized, minValue, maxValue);
+    for (size_t i = 0; i < values.size(); i++) {
+        if (std::isnan(values[i])) {
+            CHECK(std::isnan(normalized[i]));
+        }
+        else {
+            CHECK(normalized[i] == (values[i] - minValue) / (maxValue - minValue));
+        }
+    }
+
+    std::vector<uint32_t> indices = { 12345 };
+    const size_t nFound = kernels::filterInRange(values, -10.f, 500.f, indices);
+    std::vector<uint32_t> expected = { 12345 };
+    for (size_t i = 0; i < values.size(); i++) {
+        if (values[i] >= -10.f && values[i] <= 500.f) {
+            expected.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    CHECK(nFound == expected.size() - 1);
+    CHECK(indices == expected);
+}
+
+TEST_CASE("DataLoader: Line Chunks", "[dataloader]") {
+    std::string data;
+    for (int i = 0; i < 1000; i++) {
+        data += std::to_string(i) + " " + std::string(i % 17, 'x') + "\n";
+    }
+    // Leave out the final newline to check that the last line is kept anyway
+    data += "last";
+
+    for (size_t nChunks : { 1, 2, 3, 7, 64, 5000 }) {
+        const std::vector<std::string_view> chunks =
+            splitIntoLineChunks(data, nChunks);
+        REQUIRE(!chunks.empty());
+        CHECK(chunks.size() <= nChunks);
+
+        std::string joined;
+        for (size_t i = 0; i < chunks.size(); i++) {
+            if (i + 1 < chunks.size()) {
+                CHECK(chunks[i].back() == '\n');
+            }
+            joined += chunks[i];
+        }
+        CHECK(joined == data);
+    }
+
+    CHECK(splitIntoLineChunks("", 4).size() == 1);
+
+    std::atomic_int sum = 0;
+    runInParallel(8, [&sum](size_t i) { sum += static_cast<int>(i); });
+    CHECK(sum == 28);
+}
+
+TEST_CASE("DataLoader: Float From Chars", "[dataloader]") {
+    auto parse = [](std::string_view str, float& value) {
+        const std::from_chars_result res =
+            floatFromChars(str.data(), str.data() + str.size(), value);
+        return std::pair(res.ptr - str.data(), res.ec);
+    };
+
+    float value = 0.f;
+    CHECK(parse("1.5e3 rest", value) == std::pair<ptrdiff_t, std::errc>(5, std::errc()));
+    CHECK(value == 1500.f);
+    CHECK(parse("-0.25,1", value) == std::pair<ptrdiff_t, std::errc>(5, std::errc()));
+    CHECK(value == -0.25f);
+    CHECK(parse("1e", value) == std::pair<ptrdiff_t, std::errc>(1, std::errc()));
+    CHECK(value == 1.f);
+
+    // The end of the range has to be respected even if more digits follow
+    CHECK(parse(std::string_view("12345").substr(0, 3), value).second == std::errc());
+    CHECK(value == 123.f);
+
+    value = 7.f;
+    CHECK(parse("+1", value).second == std::errc::invalid_argument);
+    CHECK(parse("abc", value).second == std::errc::invalid_argument);
+    CHECK(parse("", value).second == std::errc::invalid_argument);
+    CHECK(parse("1e999", value).second == std::errc::result_out_of_range);
+    CHECK(value == 7.f);
+}
+
+TEST_CASE("DataLoader: CSV", "[dataloader]") {
+    const std::filesystem::path file =
+        std::filesystem::temp_directory_path() / "test_dataloader.csv";
+    {
+        std::ofstream f = std::ofstream(file);
+        f << "x,y,z,skip,value,name,\"other,value\"\n";
+        f << "1,2,3,skip,4,first,5\n";
+        f << "\n";
+        f << "-1,-2,-8,skip,nan,\"second, \"\"quoted\"\"\",6\r\n";
+        f << "7,8\n";
+        f << "1,1,1,skip,abc,,1e50";
+    }
+
+    DataMapping mapping;
+    mapping.nameColumn = "name";
+    mapping.excludeColumns = { "skip" };
+    const Dataset dataset = csv::loadCsvFile(file, mapping);
+
+    REQUIRE(dataset.size() == 4);
+    REQUIRE(dataset.variables.size() == 2);
+    CHECK(dataset.variables[0].name == "value");
+    CHECK(dataset.variables[1].name == "other,value");
+    CHECK(dataset.maxPositionComponent == 8.f);
+
+    CHECK(dataset.positions[0] == glm::vec3(1.f, 2.f, 3.f));
+    CHECK(dataset.positions[1] == glm::vec3(-1.f, -2.f, -8.f));
+    // Missing position values are 0, missing data values are NaN
+    CHECK(dataset.positions[2] == glm::vec3(7.f, 8.f, 0.f));
+
+    CHECK(dataset.columns[0][0] == 4.f);
+    CHECK(std::isnan(dataset.columns[0][1]));
+    CHECK(std::isnan(dataset.columns[0][2]));
+    CHECK(std::isnan(dataset.columns[0][3]));
+    CHECK(dataset.columns[1][1] == 6.f);
+    CHECK(std::isnan(dataset.columns[1][3]));
+
+    CHECK(dataset.comment(0) == "first");
+    CHECK(dataset.comment(1) == "second, \"quoted\"");
+    CHECK(!dataset.comment(2).has_value());
+    CHECK(!dataset.comment(3).has_value());
+}
+
+TEST_CASE("DataLoader: Columnar Benchmark", "[.][dataloader][benchmark]") {
+    constexpr size_t NRows = 10'000'000;
+    constexpr int NValues = 8;
+    constexpr int Column = 5;
+
+    // The previous array-of-structs (AoS) layout in which every entry owned its values
+    struct Entry {
+        glm::vec3 position = glm::vec3(0.f);
+        std::vector<float> data;
+    };
+    std::vector<Entry> entries = std::vector<Entry>(NRows);
+
+    Dataset dataset;
+    dataset.variables = { { Column, "value" } };
+    dataset.columns.resize(NValues);
+    const std::vector<float> column = createColumn(NRows);
+    for (int i = 0; i < NValues; i++) {
+        dataset.columns[i] = column;
+    }
+    dataset.positions.resize(NRows);
+    dataset.commentOffsets.resize(NRows + 1, 0);
+    for (size_t i = 0; i < NRows; i++) {
+        entries[i].data = std::vector<float>(NValues, column[i]);
+    }
+
+    BENCHMARK("Value range (AoS)") {
+        float minValue = std::numeric_limits<float>::max();
+        float maxValue = -std::numeric_limits<float>::max();
+        for (const Entry& e : entries) {
+            const float value = e.data[Column];
+            if (std::isnan(value)) {
+                continue;
+            }
+            minValue = std::min(minValue, value);
+            maxValue = std::max(maxValue, value);
+        }
+        return glm::vec2(minValue, maxValue);
+    };
+
+    BENCHMARK("Value range (columnar)") {
+        return dataset.findValueRange(Column);
+    };
+
+    BENCHMARK_ADVANCED("Normalize (AoS)")(Catch::Benchmark::Chronometer meter) {
+        std::vector<Entry> copy = entries;
+        meter.measure([&copy]() {
+            float minValue = std::numeric_limits<float>::max();
+            float maxValue = -std::numeric_limits<float>::max();
+            for (const Entry& e : copy) {
+                const float value = e.data[Column];
+                if (std::isnan(value)) {
+                    continue;
+                }
+                minValue = std::min(minValue, value);
+                maxValue = std::max(maxValue, value);
+            }
+            for (Entry& e : copy) {
+                e.data[Column] = (e.data[Column] - minValue) / (maxValue - minValue);
+            }
+        });
+    };
+
+    BENCHMARK_ADVANCED("Normalize (columnar)")(Catch::Benchmark::Chronometer meter) {
+        Dataset copy = dataset;
+        meter.measure([&copy]() { copy.normalizeVariable("value"); });
+    };
+
+    BENCHMARK("Filter (AoS)") {
+        std::vector<uint32_t> result;
+        for (size_t i = 0; i < entries.size(); i++) {
+            const float value = entries[i].data[Column];
+            if (value >= -10.f && value <= 10.f) {
+                result.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        return result;
+    };
+
+    BENCHMARK("Filter (columnar)") {
+        std::vector<uint32_t> result;
+        kernels::filterInRange(dataset.columns[Column], -10.f, 10.f, result);
+        return result;
+    };
+}
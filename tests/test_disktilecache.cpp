@@ -0,0 +1,271 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/globebrowsing/src/disktilecache.h>
+#include <modules/globebrowsing/src/lz4block.h>
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+using namespace openspace::globebrowsing;
+
+namespace {
+    constexpr size_t TileSize = 64;
+
+    TileTextureInitData initData() {
+        return TileTextureInitData(
+            TileSize,
+            TileSize,
+            GL_UNSIGNED_BYTE,
+            ghoul::opengl::Texture::Format::RGBA
+        );
+    }
+
+    // Creates a tile whose content depends on the tile index so that different tiles
+    // can be told apart. \p noise controls how compressible the data is
+    RawTile createTile(const TileIndex& index, bool noise = false) {
+        const TileTextureInitData data = initData();
+        RawTile tile;
+        tile.imageData = std::unique_ptr<std::byte[]>(new std::byte[data.totalNumBytes]);
+        std::mt19937 gen(static_cast<unsigned int>(index.hashKey()));
+        for (size_t i = 0; i < data.totalNumBytes; i++) {
+            const size_t v = noise ? gen() : (i / 16 + index.x + index.y + index.level);
+            tile.imageData[i] = static_cast<std::byte>(v & 0xFF);
+        }
+        tile.tileMetaData.maxValues = { 1.f, 2.f, 3.f, 4.f };
+        tile.tileMetaData.minValues = { -1.f, -2.f, -3.f, -4.f };
+        tile.tileMetaData.hasMissingData = { false, true, false, true };
+        tile.tileMetaData.nValues = 4;
+        tile.textureInitData = data;
+        tile.tileIndex = index;
+        return tile;
+    }
+
+    bool isEqual(const RawTile& a, const RawTile& b) {
+        const size_t size = a.textureInitData->totalNumBytes;
+        return b.textureInitData->totalNumBytes == size &&
+            std::memcmp(a.imageData.get(), b.imageData.get(), size) == 0 &&
+            a.tileMetaData.maxValues == b.tileMetaData.maxValues &&
+            a.tileMetaData.minValues == b.tileMetaData.minValues &&
+            a.tileMetaData.hasMissingData == b.tileMetaData.hasMissingData &&
+            a.tileMetaData.nValues == b.tileMetaData.nValues &&
+            a.tileIndex == b.tileIndex;
+    }
+
+    std::filesystem::path cacheDirectory(std::string_view name) {
+        std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "openspace-disktilecache" / name;
+        std::filesystem::remove_all(path);
+        return path;
+    }
+} // namespace
+
+TEST_CASE("DiskTileCache: LZ4 Roundtrip", "[disktilecache]") {
+    std::mt19937 gen(1337);
+    std::vector<std::vector<std::byte>> inputs = {
+        {},
+        { std::byte(1) },
+        std::vector<std::byte>(13, std::byte(7)),
+        std::vector<std::byte>(100000, std::byte(0))
+    };
+    std::vector<std::byte> random(4096);
+    for (std::byte& b : random) {
+        b = static_cast<std::byte>(gen() & 0xFF);
+    }
+    inputs.push_back(random);
+    std::vector<std::byte> repeating(70000);
+    for (size_t i = 0; i < repeating.size(); i++) {
+        repeating[i] = static_cast<std::byte>((i % 251) ^ (i / 300));
+    }
+    inputs.push_back(repeating);
+
+    for (const std::vector<std::byte>& input : inputs) {
+        std::vector<std::byte> compressed(lz4::compressBound(input.size()));
+        const size_t size = lz4::compress(
+            input.data(),
+            input.size(),
+            compressed.data(),
+            compressed.size()
+        );
+        REQUIRE(size > 0);
+
+        std::vector<std::byte> output(input.size());
+        CHECK(lz4::decompress(compressed.data(), size, output.data(), output.size()));
+        CHECK(output == input);
+    }
+
+    // Highly redundant data should compress well and a truncated block must be rejected
+    const std::vector<std::byte>& zeros = inputs[3];
+    std::vector<std::byte> compressed(lz4::compressBound(zeros.size()));
+    const size_t size =
+        lz4::compress(zeros.data(), zeros.size(), compressed.data(), compressed.size());
+    CHECK(size < zeros.size() / 100);
+    std::vector<std::byte> output(zeros.size());
+    const bool success =
+        lz4::decompress(compressed.data(), size - 1, output.data(), output.size());
+    CHECK_FALSE(success);
+}
+
+TEST_CASE("DiskTileCache: Put Get", "[disktilecache]") {
+    const std::filesystem::path dir = cacheDirectory("putget");
+    cache::DiskTileCache cache(dir, 64 << 20, true);
+
+    const cache::DiskTileKey key = { .source = 1, .tileIndex = TileIndex(3, 2, 4) };
+    CHECK_FALSE(cache.get(key, initData()).has_value());
+
+    const RawTile tile = createTile(key.tileIndex);
+    cache.put(key, tile);
+    CHECK(cache.exist(key));
+    CHECK(cache.numTiles() == 1);
+    // Compressible data should take less space than the raw tile
+    CHECK(cache.sizeOnDisk() < initData().totalNumBytes);
+
+    std::optional<RawTile> result = cache.get(key, initData());
+    REQUIRE(result.has_value());
+    CHECK(isEqual(tile, *result));
+
+    // Different sources and tile indices must not collide
+    CHECK_FALSE(cache.exist({ .source = 2, .tileIndex = key.tileIndex }));
+    CHECK_FALSE(cache.exist({ .source = 1, .tileIndex = TileIndex(3, 2, 5) }));
+
+    // A request for a different texture layout must not return the stored tile
+    const TileTextureInitData other = TileTextureInitData(
+        TileSize,
+        TileSize,
+        GL_FLOAT,
+        ghoul::opengl::Texture::Format::Red
+    );
+    CHECK_FALSE(cache.get(key, other).has_value());
+
+    // Failed tiles are not stored
+    const cache::DiskTileKey failedKey = { .source = 1, .tileIndex = TileIndex(0, 0, 1) };
+    RawTile failed = createTile(failedKey.tileIndex);
+    failed.error = RawTile::ReadError::Failure;
+    cache.put(failedKey, failed);
+    CHECK_FALSE(cache.exist(failedKey));
+
+    // Incompressible data is stored as-is
+    const cache::DiskTileKey noiseKey = { .source = 1, .tileIndex = TileIndex(1, 1, 1) };
+    const RawTile noise = createTile(noiseKey.tileIndex, true);
+    cache.setCompressionEnabled(true);
+    cache.put(noiseKey, noise);
+    std::optional<RawTile> noiseResult = cache.get(noiseKey, initData());
+    REQUIRE(noiseResult.has_value());
+    CHECK(isEqual(noise, *noiseResult));
+
+    cache.clear();
+    CHECK(cache.numTiles() == 0);
+    CHECK(cache.sizeOnDisk() == 0);
+    CHECK_FALSE(cache.get(key, initData()).has_value());
+}
+
+TEST_CASE("DiskTileCache: Persistence", "[disktilecache]") {
+    const std::filesystem::path dir = cacheDirectory("persistence");
+
+    constexpr int NumTiles = 20;
+    {
+        cache::DiskTileCache cache(dir, 64 << 20, false);
+        for (int i = 0; i < NumTiles; i++) {
+            const TileIndex index = TileIndex(i, 2 * i, 10);
+            cache.put({ .source = 42, .tileIndex = index }, createTile(index));
+        }
+        CHECK(cache.numTiles() == NumTiles);
+    }
+
+    cache::DiskTileCache cache(dir, 64 << 20, true);
+    CHECK(cache.numTiles() == NumTiles);
+    for (int i = 0; i < NumTiles; i++) {
+        const TileIndex index = TileIndex(i, 2 * i, 10);
+        const cache::DiskTileKey key = { .source = 42, .tileIndex = index };
+        std::optional<RawTile> tile = cache.get(key, initData());
+        REQUIRE(tile.has_value());
+        CHECK(isEqual(createTile(index), *tile));
+    }
+}
+
+TEST_CASE("DiskTileCache: Truncated Segment", "[disktilecache]") {
+    const std::filesystem::path dir = cacheDirectory("truncated");
+
+    std::filesystem::path segment;
+    {
+        cache::DiskTileCache cache(dir, 64 << 20, false);
+        for (int i = 0; i < 3; i++) {
+            const TileIndex index = TileIndex(i, 0, 2);
+            cache.put({ .source = 7, .tileIndex = index }, createTile(index));
+        }
+    }
+    for (const std::filesystem::directory_entry& e :
+         std::filesystem::directory_iterator(dir))
+    {
+        segment = e.path();
+    }
+    REQUIRE(!segment.empty());
+
+    // Simulate a crash in the middle of writing the last tile
+    const uintmax_t size = std::filesystem::file_size(segment);
+    std::filesystem::resize_file(segment, size - 100);
+
+    cache::DiskTileCache cache(dir, 64 << 20, false);
+    CHECK(cache.numTiles() == 2);
+    CHECK(cache.get({ .source = 7, .tileIndex = TileIndex(1, 0, 2) }, initData()));
+    CHECK_FALSE(cache.exist({ .source = 7, .tileIndex = TileIndex(2, 0, 2) }));
+
+    // New tiles can still be added and read back
+    const TileIndex index = TileIndex(2, 0, 2);
+    const cache::DiskTileKey key = { .source = 7, .tileIndex = index };
+    cache.put(key, createTile(index));
+    std::optional<RawTile> tile = cache.get(key, initData());
+    REQUIRE(tile.has_value());
+    CHECK(isEqual(createTile(index), *tile));
+}
+
+TEST_CASE("DiskTileCache: Eviction", "[disktilecache]") {
+    const std::filesystem::path dir = cacheDirectory("eviction");
+
+    // With the smallest segment size, a 4 MB budget fits a handful of segments
+    constexpr uint64_t Budget = 4 << 20;
+    cache::DiskTileCache cache(dir, Budget, false);
+
+    const cache::DiskTileKey first = { .source = 3, .tileIndex = TileIndex(0, 0, 12) };
+    cache.put(first, createTile(first.tileIndex));
+
+    constexpr int NumTiles = 400;
+    for (int i = 1; i < NumTiles; i++) {
+        const TileIndex index = TileIndex(i, 0, 12);
+        cache.put({ .source = 3, .tileIndex = index }, createTile(index));
+        // Keep using the first tile so that its segment is never the oldest one
+        CHECK(cache.get(first, initData()).has_value());
+    }
+
+    CHECK(cache.sizeOnDisk() <= Budget);
+    CHECK(cache.numTiles() < NumTiles);
+    CHECK(cache.exist(first));
+    // Tiles from the segments after the first one were not used since they were written
+    CHECK_FALSE(cache.exist({ .source = 3, .tileIndex = TileIndex(100, 0, 12) }));
+    CHECK(cache.exist({ .source = 3, .tileIndex = TileIndex(NumTiles - 1, 0, 12) }));
+}
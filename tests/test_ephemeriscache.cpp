@@ -0,0 +1,290 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/util/ephemeriscache.h>
+#include <openspace/util/spicemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/misc/exception.h>
+#include <cmath>
+#include "SpiceUsr.h"
+#include "SpiceZpr.h"
+
+using namespace openspace;
+
+namespace {
+    using Quantity = EphemerisCache::Quantity;
+
+    // A circular orbit with a radius of 1e6 km and a period of one day
+    void circularOrbit(double time, std::span<double> values) {
+        constexpr double Radius = 1e6;
+        constexpr double Omega = 2.0 * 3.14159265358979323846 / 86400.0;
+        values[0] = Radius * std::cos(Omega * time);
+        values[1] = Radius * std::sin(Omega * time);
+        values[2] = 0.0;
+        values[3] = Radius / 299792.458;
+    }
+
+    // Queries the cache the same way the SpiceManager does and returns whether the value
+    // was found in the cache
+    bool query(EphemerisCache& cache, const EphemerisCache::Key& key, double time,
+               const EphemerisCache::Sampler& sampler, std::span<double> result)
+    {
+        if (cache.find(Quantity::Position, key, time, result)) {
+            return true;
+        }
+        sampler(time, result);
+        cache.miss(Quantity::Position, key, time, sampler);
+        return false;
+    }
+
+    void loadKernels() {
+        constexpr std::array<std::string_view, 5> Kernels = {
+            "naif0008.tls",
+            "981005_PLTEPH-DE405S.bsp",
+            "020514_SE_SAT105.bsp",
+            "030201AP_SK_SM546_T45.bsp",
+            "cpck05Mar2004.tpc"
+        };
+        for (std::string_view kernel : Kernels) {
+            const std::string path =
+                "${TESTDIR}/SpiceTest/spicekernels/" + std::string(kernel);
+            SpiceManager::ref().loadKernel(absPath(path).string());
+        }
+    }
+} // namespace
+
+TEST_CASE("EphemerisCache: Cached Values Within Tolerance", "[ephemeriscache]") {
+    EphemerisCache cache;
+    const EphemerisCache::Key key = { .target = "A", .observer = "B", .frame = "C" };
+
+    int nSamples = 0;
+    const EphemerisCache::Sampler sampler = [&nSamples](double t, std::span<double> v) {
+        nSamples++;
+        circularOrbit(t, v);
+    };
+
+    int nHits = 0;
+    constexpr int NQueries = 10000;
+    std::array<double, 4> result;
+    std::array<double, 4> exact;
+    for (int i = 0; i < NQueries; i++) {
+        const double time = 1e8 + i * 10.0;
+        if (query(cache, key, time, sampler, result)) {
+            nHits++;
+        }
+        circularOrbit(time, exact);
+        for (int j = 0; j < 3; j++) {
+            CHECK(std::abs(result[j] - exact[j]) <= cache.settings().positionTolerance);
+        }
+        CHECK(result[3] == Catch::Approx(exact[3]));
+    }
+
+    // The queries cover 100000 seconds and each segment covers an hour
+    CHECK(nHits > NQueries * 9 / 10);
+    CHECK(nSamples < NQueries / 10);
+    CHECK(cache.nSegments() <= static_cast<size_t>(cache.settings().nSegmentsPerEntry));
+}
+
+TEST_CASE("EphemerisCache: Segments Are Split", "[ephemeriscache]") {
+    EphemerisCache::Settings settings;
+    settings.segmentLength = 86400.0 * 32.0;
+    EphemerisCache cache = EphemerisCache(settings);
+    const EphemerisCache::Key key = { .target = "A", .observer = "B" };
+
+    // A segment of 32 days is far too long to approximate an orbit of one day, so the
+    // cache has to use shorter segments to stay within the tolerance
+    std::array<double, 4> result;
+    std::array<double, 4> exact;
+    int nHits = 0;
+    for (int i = 0; i < 1000; i++) {
+        const double time = i * 30.0;
+        if (query(cache, key, time, circularOrbit, result)) {
+            nHits++;
+        }
+        circularOrbit(time, exact);
+        for (int j = 0; j < 3; j++) {
+            CHECK(std::abs(result[j] - exact[j]) <= settings.positionTolerance);
+        }
+    }
+    CHECK(nHits > 0);
+}
+
+TEST_CASE("EphemerisCache: Distant Times Are Not Cached", "[ephemeriscache]") {
+    EphemerisCache cache;
+    const EphemerisCache::Key key = { .target = "A", .observer = "B" };
+
+    int nSamples = 0;
+    const EphemerisCache::Sampler sampler = [&nSamples](double t, std::span<double> v) {
+        nSamples++;
+        circularOrbit(t, v);
+    };
+
+    // Every query lies in a different segment, so sampling a segment would be wasted
+    std::array<double, 4> result;
+    for (int i = 0; i < 100; i++) {
+        CHECK_FALSE(query(cache, key, i * 1e5, sampler, result));
+    }
+    CHECK(nSamples == 100);
+    CHECK(cache.nSegments() == 0);
+}
+
+TEST_CASE("EphemerisCache: Clear", "[ephemeriscache]") {
+    EphemerisCache cache;
+    const EphemerisCache::Key key = { .target = "A", .observer = "B" };
+
+    std::array<double, 4> result;
+    query(cache, key, 0.0, circularOrbit, result);
+    query(cache, key, 1.0, circularOrbit, result);
+    CHECK(cache.nSegments() == 1);
+    CHECK(query(cache, key, 2.0, circularOrbit, result));
+
+    cache.clear();
+    CHECK(cache.nSegments() == 0);
+    CHECK_FALSE(query(cache, key, 2.0, circularOrbit, result));
+}
+
+TEST_CASE("EphemerisCache: Failed Sampling Is Not Cached", "[ephemeriscache]") {
+    EphemerisCache cache;
+    const EphemerisCache::Key key = { .target = "A", .observer = "B" };
+
+    const EphemerisCache::Sampler sampler = [](double t, std::span<double> v) {
+        if (t > 10.0) {
+            throw ghoul::RuntimeError("No coverage");
+        }
+        circularOrbit(t, v);
+    };
+
+    std::array<double, 4> result;
+    query(cache, key, 0.0, sampler, result);
+    query(cache, key, 1.0, sampler, result);
+    CHECK(cache.nSegments() == 0);
+}
+
+TEST_CASE("EphemerisCache: Spice Positions", "[ephemeriscache]") {
+    SpiceManager::initialize();
+    loadKernels();
+
+    EphemerisCache::Settings settings;
+    SpiceManager::ref().setEphemerisCacheEnabled(true, settings);
+
+    double et = 0.0;
+    str2et_c("2004 JUN 11 07:32:00", &et);
+
+    constexpr std::array<std::string_view, 3> Targets = { "EARTH", "SATURN", "PHOEBE" };
+    const SpiceManager::AberrationCorrection corr = {
+        SpiceManager::AberrationCorrection::Type::LightTimeStellar,
+        SpiceManager::AberrationCorrection::Direction::Reception
+    };
+
+    // Query a day around the Phoebe flyby of Cassini once every minute. The check of the
+    // fits only happens at a few points, so the comparison allows for a larger error
+    const double Tolerance = 10.0 * settings.positionTolerance;
+    for (int i = 0; i < 24 * 60; i++) {
+        const double time = et + i * 60.0;
+        for (std::string_view target : Targets) {
+            std::array<double, 3> pos;
+            double lt = 0.0;
+            spkpos_c(target.data(), time, "J2000", "LT+S", "CASSINI", pos.data(), &lt);
+
+            double lightTime = 0.0;
+            const glm::dvec3 p = SpiceManager::ref().targetPosition(
+                std::string(target),
+                "CASSINI",
+                "J2000",
+                corr,
+                time,
+                lightTime
+            );
+            CHECK(std::abs(p.x - pos[0]) <= Tolerance);
+            CHECK(std::abs(p.y - pos[1]) <= Tolerance);
+            CHECK(std::abs(p.z - pos[2]) <= Tolerance);
+            CHECK(lightTime == Catch::Approx(lt));
+        }
+    }
+
+    SpiceManager::deinitialize();
+}
+
+TEST_CASE("EphemerisCache: Spice Rotations", "[ephemeriscache]") {
+    SpiceManager::initialize();
+    loadKernels();
+
+    EphemerisCache::Settings settings;
+    SpiceManager::ref().setEphemerisCacheEnabled(true, settings);
+
+    double et = 0.0;
+    str2et_c("2004 JUN 11 07:32:00", &et);
+
+    const double Tolerance = 10.0 * settings.rotationTolerance;
+    for (int i = 0; i < 24 * 60; i++) {
+        const double time = et + i * 60.0;
+
+        std::array<double[3], 3> reference;
+        pxform_c("IAU_PHOEBE", "J2000", time, reference.data());
+
+        const glm::dmat3 m = SpiceManager::ref().positionTransformMatrix(
+            "IAU_PHOEBE",
+            "J2000",
+            time
+        );
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) {
+                CHECK(std::abs(m[c][r] - reference[r][c]) <= Tolerance);
+            }
+        }
+    }
+
+    SpiceManager::deinitialize();
+}
+
+TEST_CASE("EphemerisCache: Unloading Kernel Invalidates Cache", "[ephemeriscache]") {
+    SpiceManager::initialize();
+    loadKernels();
+    SpiceManager::ref().setEphemerisCacheEnabled(true);
+
+    double et = 0.0;
+    str2et_c("2004 JUN 11 19:32:00", &et);
+
+    const SpiceManager::AberrationCorrection corr = {
+        SpiceManager::AberrationCorrection::Type::None,
+        SpiceManager::AberrationCorrection::Direction::Reception
+    };
+    SpiceManager::ref().targetPosition("EARTH", "SUN", "J2000", corr, et);
+    SpiceManager::ref().targetPosition("EARTH", "SUN", "J2000", corr, et + 1.0);
+
+    // Without the planetary ephemeris there is no position for the Earth anymore, which
+    // would go unnoticed if the position was still cached
+    SpiceManager::ref().unloadKernel(
+        absPath("${TESTDIR}/SpiceTest/spicekernels/981005_PLTEPH-DE405S.bsp").string()
+    );
+    CHECK_THROWS_AS(
+        SpiceManager::ref().targetPosition("EARTH", "SUN", "J2000", corr, et + 2.0),
+        SpiceManager::SpiceException
+    );
+
+    SpiceManager::deinitialize();
+}
@@ -0,0 +1,108 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/globebrowsing/src/heightsampler.h>
+#include <cmath>
+#include <limits>
+
+using namespace openspace::globebrowsing;
+
+namespace {
+    // A 4x4 tile whose values increase by 1 along x and by 10 along y
+    HeightSampler::HeightTile gradientTile() {
+        HeightSampler::HeightTile tile;
+        tile.dimensions = glm::uvec2(4, 4);
+        for (unsigned int y = 0; y < 4; y++) {
+            for (unsigned int x = 0; x < 4; x++) {
+                tile.values.push_back(static_cast<float>(x + 10 * y));
+            }
+        }
+        tile.uvTransform.uvOffset = glm::vec2(0.f);
+        tile.uvTransform.uvScale = glm::vec2(1.f);
+        tile.noDataValue = -9999.f;
+        return tile;
+    }
+} // namespace
+
+TEST_CASE("HeightSampler: Texel centers", "[heightsampler]") {
+    const HeightSampler::HeightTile tile = gradientTile();
+
+    // The center of texel (x, y) is at ((x + 0.5) / 4, (y + 0.5) / 4)
+    CHECK(tile.sample(glm::vec2(0.125f, 0.125f)) == Catch::Approx(0.f));
+    CHECK(tile.sample(glm::vec2(0.375f, 0.125f)) == Catch::Approx(1.f));
+    CHECK(tile.sample(glm::vec2(0.125f, 0.375f)) == Catch::Approx(10.f));
+    CHECK(tile.sample(glm::vec2(0.875f, 0.875f)) == Catch::Approx(33.f));
+}
+
+TEST_CASE("HeightSampler: Bilinear interpolation", "[heightsampler]") {
+    const HeightSampler::HeightTile tile = gradientTile();
+
+    // Halfway between the centers of texels (1, 1), (2, 1), (1, 2), and (2, 2)
+    CHECK(tile.sample(glm::vec2(0.5f, 0.5f)) == Catch::Approx(16.5f));
+    // A quarter of the way from (0, 0) to (1, 0)
+    CHECK(tile.sample(glm::vec2(0.1875f, 0.125f)) == Catch::Approx(0.25f));
+}
+
+TEST_CASE("HeightSampler: Clamping at the edges", "[heightsampler]") {
+    const HeightSampler::HeightTile tile = gradientTile();
+
+    CHECK(tile.sample(glm::vec2(1.f, 0.875f)) == Catch::Approx(33.f));
+    CHECK(tile.sample(glm::vec2(0.875f, 1.f)) == Catch::Approx(33.f));
+}
+
+TEST_CASE("HeightSampler: UV transform", "[heightsampler]") {
+    HeightSampler::HeightTile tile = gradientTile();
+
+    // The tile covers the patch of a child in its north east quadrant
+    tile.uvTransform.uvOffset = glm::vec2(0.5f, 0.5f);
+    tile.uvTransform.uvScale = glm::vec2(0.5f, 0.5f);
+
+    CHECK(tile.sample(glm::vec2(0.25f, 0.25f)) == Catch::Approx(22.f));
+    CHECK(tile.sample(glm::vec2(0.75f, 0.75f)) == Catch::Approx(33.f));
+}
+
+TEST_CASE("HeightSampler: Missing data", "[heightsampler]") {
+    HeightSampler::HeightTile tile = gradientTile();
+    tile.values[0] = tile.noDataValue;
+    tile.values[15] = std::numeric_limits<float>::quiet_NaN();
+
+    // Any interpolation that involves one of the missing values is invalid
+    CHECK(std::isnan(tile.sample(glm::vec2(0.125f, 0.125f))));
+    CHECK(std::isnan(tile.sample(glm::vec2(0.25f, 0.25f))));
+    CHECK(std::isnan(tile.sample(glm::vec2(0.875f, 0.875f))));
+    CHECK(tile.sample(glm::vec2(0.5f, 0.5f)) == Catch::Approx(16.5f));
+
+    const HeightSampler::HeightTile empty;
+    CHECK(std::isnan(empty.sample(glm::vec2(0.5f, 0.5f))));
+}
+
+TEST_CASE("HeightSampler: No height layers", "[heightsampler]") {
+    HeightSampler sampler(4);
+    sampler.startFrame();
+    CHECK(sampler.height(TileIndex(0, 0, 2), glm::vec2(0.5f, 0.5f), {}) == 0.f);
+}
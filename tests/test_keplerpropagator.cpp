@@ -0,0 +1,222 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <modules/space/keplerpropagator.h>
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
+#include <openspace/util/taskscheduler.h>
+#include <ghoul/glm.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+
+using namespace openspace;
+
+namespace {
+    constexpr double Day = 86400.0;
+
+    // Creates orbits with random elements, including circular and highly eccentric ones
+    std::vector<kepler::Parameters> createOrbits(size_t n) {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<double> angle(0.0, 360.0);
+        std::uniform_real_distribution<double> eccentricity(0.0, 0.99);
+        std::uniform_real_distribution<double> axis(7000.0, 5e8);
+
+        std::vector<kepler::Parameters> orbits(n);
+        for (size_t i = 0; i < n; i++) {
+            kepler::Parameters& p = orbits[i];
+            p.eccentricity = i % 10 == 0 ? 0.0 : eccentricity(rng);
+            p.semiMajorAxis = axis(rng);
+            p.inclination = angle(rng) / 2.0;
+            p.ascendingNode = angle(rng);
+            p.argumentOfPeriapsis = angle(rng);
+            p.meanAnomaly = angle(rng);
+            p.epoch = angle(rng) * Day;
+            p.period = (1.0 + angle(rng)) * Day;
+        }
+        return orbits;
+    }
+
+    void checkPosition(const glm::vec3& actual, const glm::dvec3& expected) {
+        const double scale = glm::length(expected);
+        CHECK(std::abs(actual.x - expected.x) <= scale * 1e-6);
+        CHECK(std::abs(actual.y - expected.y) <= scale * 1e-6);
+        CHECK(std::abs(actual.z - expected.z) <= scale * 1e-6);
+    }
+} // namespace
+
+TEST_CASE("KeplerPropagator: Solve eccentric anomaly", "[keplerpropagator]") {
+    std::vector<double> meanAnomaly;
+    std::vector<double> eccentricity;
+    for (double e : { 0.0, 0.1, 0.5, 0.9, 0.99, 0.999 }) {
+        for (double m = -20.0; m <= 20.0; m += 0.01) {
+            meanAnomaly.push_back(m);
+            eccentricity.push_back(e);
+        }
+    }
+    std::vector<double> sinE = std::vector<double>(meanAnomaly.size());
+    std::vector<double> cosE = std::vector<double>(meanAnomaly.size());
+    kepler::solveEccentricAnomaly(meanAnomaly, eccentricity, sinE, cosE);
+
+    for (size_t i = 0; i < meanAnomaly.size(); i++) {
+        CHECK(sinE[i] * sinE[i] + cosE[i] * cosE[i] == Catch::Approx(1.0));
+
+        // The eccentric anomaly has to solve Kepler's equation up to multiples of 2 pi
+        const double ea = std::atan2(sinE[i], cosE[i]);
+        double residual = ea - eccentricity[i] * sinE[i] - meanAnomaly[i];
+        residual -= glm::two_pi<double>() * std::round(residual / glm::two_pi<double>());
+        CHECK(std::abs(residual) < 1e-12);
+    }
+}
+
+TEST_CASE("KeplerPropagator: Periapsis and apoapsis", "[keplerpropagator]") {
+    kepler::Parameters p;
+    p.eccentricity = 0.5;
+    p.semiMajorAxis = 10000.0;
+    p.epoch = 100.0;
+    p.period = 1000.0;
+
+    const kepler::Propagator propagator = kepler::Propagator(std::vector{ p });
+    REQUIRE(propagator.size() == 1);
+
+    // Without any rotation, the periapsis is on the positive x axis
+    const glm::dvec3 periapsis = propagator.position(0, p.epoch);
+    CHECK(periapsis.x == Catch::Approx(5000.0 * 1000.0));
+    CHECK(periapsis.y == Catch::Approx(0.0).margin(1e-6));
+    CHECK(periapsis.z == Catch::Approx(0.0).margin(1e-6));
+
+    const glm::dvec3 apoapsis = propagator.position(0, p.epoch + p.period / 2.0);
+    CHECK(apoapsis.x == Catch::Approx(-15000.0 * 1000.0));
+    CHECK(apoapsis.y == Catch::Approx(0.0).margin(1e-3));
+    CHECK(apoapsis.z == Catch::Approx(0.0).margin(1e-6));
+
+    // An inclination of 90 degrees turns the orbit into the x-z plane
+    p.inclination = 90.0;
+    kepler::Propagator inclined = kepler::Propagator(std::vector{ p });
+    const glm::dvec3 quarter = inclined.position(0, p.epoch + p.period / 4.0);
+    CHECK(quarter.y == Catch::Approx(0.0).margin(1e-3));
+    CHECK(quarter.z > 0.0);
+}
+
+TEST_CASE("KeplerPropagator: Sample ranges", "[keplerpropagator]") {
+    const std::vector<kepler::Parameters> orbits = createOrbits(100);
+    const kepler::Propagator propagator = kepler::Propagator(orbits);
+
+    std::vector<kepler::Propagator::SampleRange> ranges;
+    size_t nSamples = 0;
+    for (size_t i = 0; i < orbits.size(); i++) {
+        // Include empty ranges and ranges that do not fill a whole block
+        const uint32_t n = static_cast<uint32_t>(i % 7 == 0 ? 0 : 10 + i * 3);
+        ranges.push_back({
+            .object = static_cast<uint32_t>(orbits.size() - 1 - i),
+            .nSamples = n,
+            .start = orbits[i].epoch,
+            .step = orbits[i].period / 50.0
+        });
+        nSamples += n;
+    }
+
+    std::vector<glm::vec3> positions = std::vector<glm::vec3>(nSamples);
+    propagator.propagate(ranges, positions);
+
+    size_t idx = 0;
+    for (const kepler::Propagator::SampleRange& range : ranges) {
+        for (uint32_t j = 0; j < range.nSamples; j++) {
+            const double time = range.start + j * range.step;
+            checkPosition(positions[idx], propagator.position(range.object, time));
+            idx++;
+        }
+    }
+
+    // All objects at the same time
+    std::vector<glm::vec3> points = std::vector<glm::vec3>(orbits.size());
+    propagator.propagate(1e7, points);
+    for (size_t i = 0; i < orbits.size(); i++) {
+        checkPosition(points[i], propagator.position(i, 1e7));
+    }
+}
+
+TEST_CASE("KeplerPropagator: Parallel propagation matches serial", "[keplerpropagator]") {
+    const std::vector<kepler::Parameters> orbits = createOrbits(2000);
+    const kepler::Propagator propagator = kepler::Propagator(orbits);
+
+    std::vector<kepler::Propagator::SampleRange> ranges;
+    for (size_t i = 0; i < orbits.size(); i++) {
+        ranges.push_back({
+            .object = static_cast<uint32_t>(i),
+            .nSamples = static_cast<uint32_t>(20 + i % 80),
+            .start = orbits[i].epoch,
+            .step = orbits[i].period / 99.0
+        });
+    }
+    size_t nSamples = 0;
+    for (const kepler::Propagator::SampleRange& range : ranges) {
+        nSamples += range.nSamples;
+    }
+
+    std::vector<glm::vec3> serial = std::vector<glm::vec3>(nSamples);
+    propagator.propagate(ranges, serial);
+
+    TaskScheduler scheduler(4);
+    std::vector<glm::vec3> parallel = std::vector<glm::vec3>(nSamples);
+    propagator.propagate(ranges, parallel, &scheduler);
+
+    // The batch boundaries can move samples between SIMD lanes and the scalar remainder
+    // of a block, which may change the last bits of the result
+    for (size_t i = 0; i < nSamples; i++) {
+        checkPosition(parallel[i], glm::dvec3(serial[i]));
+    }
+}
+
+TEST_CASE(
+    "KeplerPropagator: Benchmark serial and parallel propagation",
+    "[.][keplerpropagator][benchmark]"
+)
+{
+    const std::vector<kepler::Parameters> orbits = createOrbits(1000000);
+    const kepler::Propagator propagator = kepler::Propagator(orbits);
+    std::vector<glm::vec3> positions = std::vector<glm::vec3>(orbits.size());
+
+    BENCHMARK("Serial") {
+        propagator.propagate(0.0, positions);
+        return positions.front();
+    };
+
+    TaskScheduler scheduler(std::max(std::thread::hardware_concurrency(), 1u));
+    BENCHMARK("Parallel") {
+        propagator.propagate(0.0, positions, &scheduler);
+        return positions.front();
+    };
+}
+
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
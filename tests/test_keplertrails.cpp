@@ -0,0 +1,160 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <modules/space/keplertrails.h>
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
+#include <vector>
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+
+using namespace openspace;
+
+namespace {
+    // Creates trails with distinct elements that are laid out one after the other, with
+    // each trail using all of its reserved vertices
+    std::vector<kepler::Trail> createTrails(size_t n, int capacity) {
+        std::vector<kepler::Trail> trails(n);
+        for (size_t i = 0; i < n; i++) {
+            trails[i].fileIndex = i;
+            trails[i].parameters.semiMajorAxis = 7000.0 + 100.0 * i;
+            trails[i].parameters.eccentricity = 0.1;
+            trails[i].parameters.period = 5400.0;
+            trails[i].capacity = capacity;
+            trails[i].isDirty = false;
+        }
+        return trails;
+    }
+} // namespace
+
+TEST_CASE("KeplerTrails: Detail Level", "[keplertrails]") {
+    // An unknown camera distance and orbits that appear large use the full detail
+    CHECK(kepler::detailLevel(7000.0, 0.0) == 0);
+    CHECK(kepler::detailLevel(7000.0, 7000.0 * 1000.0) == 0);
+
+    // Each halving of the angular size increases the detail level by one
+    const double fullDetailDistance = 7000.0 * 1000.0 / 0.5;
+    CHECK(kepler::detailLevel(7000.0, fullDetailDistance * 2.5) == 1);
+    CHECK(kepler::detailLevel(7000.0, fullDetailDistance * 4.5) == 2);
+
+    // Very distant orbits are clamped to the lowest detail
+    const int maxLevel = kepler::detailLevel(7000.0, fullDetailDistance * 1e6);
+    CHECK(maxLevel > 0);
+    CHECK(kepler::detailLevel(0.0, fullDetailDistance) == maxLevel);
+}
+
+TEST_CASE("KeplerTrails: Segments For Level", "[keplertrails]") {
+    CHECK(kepler::segmentsForLevel(400, 0) == 400);
+    CHECK(kepler::segmentsForLevel(400, 1) == 200);
+    CHECK(kepler::segmentsForLevel(400, 3) == 50);
+
+    // Trails never drop below a minimum number of vertices, unless they are smaller
+    const int minSegments = kepler::segmentsForLevel(400, 20);
+    CHECK(minSegments > 1);
+    CHECK(kepler::segmentsForLevel(minSegments * 2, 20) == minSegments);
+    CHECK(kepler::segmentsForLevel(2, 20) == 2);
+
+    CHECK(kepler::fullDetailSegments(2, 0.0) == 40);
+    CHECK(kepler::fullDetailSegments(2, 0.5) > kepler::fullDetailSegments(2, 0.0));
+}
+
+TEST_CASE("KeplerTrails: Same Layout", "[keplertrails]") {
+    const std::vector<kepler::Trail> trails = createTrails(4, 100);
+
+    std::vector<kepler::Trail> updated = trails;
+    updated[2].parameters.inclination = 45.0;
+    CHECK(kepler::hasSameLayout(trails, updated));
+
+    updated = trails;
+    updated[1].capacity = 200;
+    CHECK_FALSE(kepler::hasSameLayout(trails, updated));
+
+    updated = trails;
+    updated[3].fileIndex = 10;
+    CHECK_FALSE(kepler::hasSameLayout(trails, updated));
+
+    updated = createTrails(3, 100);
+    CHECK_FALSE(kepler::hasSameLayout(trails, updated));
+}
+
+TEST_CASE("KeplerTrails: Only Changed Trails Are Dirty", "[keplertrails]") {
+    std::vector<kepler::Trail> trails = createTrails(6, 100);
+
+    // Unchanged elements do not mark any trail
+    std::vector<kepler::Trail> updated = createTrails(6, 100);
+    CHECK_FALSE(kepler::markChangedTrails(trails, updated));
+    for (const kepler::Trail& trail : trails) {
+        CHECK_FALSE(trail.isDirty);
+    }
+
+    updated[1].parameters.inclination = 30.0;
+    updated[4].parameters.epoch = 1000.0;
+    CHECK(kepler::markChangedTrails(trails, updated));
+    for (size_t i = 0; i < trails.size(); i++) {
+        CHECK(trails[i].isDirty == (i == 1 || i == 4));
+        CHECK(trails[i].parameters == updated[i].parameters);
+    }
+}
+
+TEST_CASE("KeplerTrails: Dirty Ranges", "[keplertrails]") {
+    std::vector<kepler::Trail> trails = createTrails(8, 100);
+    std::vector<int> startIndex(trails.size());
+    std::vector<int> segmentSize(trails.size());
+    for (size_t i = 0; i < trails.size(); i++) {
+        startIndex[i] = static_cast<int>(i) * 100;
+        segmentSize[i] = 100;
+    }
+
+    CHECK(kepler::dirtyRanges(trails, startIndex, segmentSize).empty());
+
+    // Consecutive dirty trails are merged into one range, separated ones are not
+    trails[1].isDirty = true;
+    trails[2].isDirty = true;
+    trails[3].isDirty = true;
+    trails[5].isDirty = true;
+    // A trail at a lower detail level only uploads the vertices that it uses
+    trails[7].isDirty = true;
+    segmentSize[7] = 25;
+
+    const std::vector<kepler::VertexRange> ranges =
+        kepler::dirtyRanges(trails, startIndex, segmentSize);
+    REQUIRE(ranges.size() == 3);
+    CHECK(ranges[0] == kepler::VertexRange{ .begin = 100, .end = 400 });
+    CHECK(ranges[1] == kepler::VertexRange{ .begin = 500, .end = 600 });
+    CHECK(ranges[2] == kepler::VertexRange{ .begin = 700, .end = 725 });
+
+    // A single run of all trails is uploaded at once
+    for (kepler::Trail& trail : trails) {
+        trail.isDirty = true;
+    }
+    const std::vector<kepler::VertexRange> all =
+        kepler::dirtyRanges(trails, startIndex, segmentSize);
+    REQUIRE(all.size() == 1);
+    CHECK(all[0] == kepler::VertexRange{ .begin = 0, .end = 725 });
+}
+
+#endif // OPENSPACE_MODULE_SPACE_ENABLED
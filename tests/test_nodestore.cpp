@@ -0,0 +1,149 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_GAIA_ENABLED
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/gaia/rendering/nodelru.h>
+#include <modules/gaia/rendering/nodestore.h>
+#include <ghoul/misc/exception.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <vector>
+
+using namespace openspace;
+
+namespace {
+    // Writes a node file in the format of OctreeManager::writeToMultipleFiles
+    void writeNodeFile(const std::filesystem::path& path, const std::vector<float>& data)
+    {
+        std::ofstream file = std::ofstream(path, std::ofstream::binary);
+        const int32_t nValues = static_cast<int32_t>(data.size());
+        file.write(reinterpret_cast<const char*>(&nValues), sizeof(int32_t));
+        file.write(
+            reinterpret_cast<const char*>(data.data()),
+            data.size() * sizeof(float)
+        );
+    }
+} // namespace
+
+TEST_CASE("NodeLru: Eviction Order", "[nodelru]") {
+    NodeLru lru;
+    lru.touch(81, 100);
+    lru.touch(82, 100);
+    lru.touch(83, 100);
+    lru.touch(84, 100);
+    CHECK(lru.size() == 4);
+    CHECK(lru.totalBytes() == 400);
+
+    // Using a node again makes it the most recently used one
+    lru.touch(81, 100);
+
+    CHECK(lru.evict(400).empty());
+    CHECK(lru.evict(250) == std::vector<unsigned long long>{ 82, 83 });
+    CHECK(lru.totalBytes() == 200);
+    CHECK_FALSE(lru.contains(82));
+    CHECK_FALSE(lru.contains(83));
+    CHECK(lru.contains(81));
+    CHECK(lru.contains(84));
+
+    CHECK(lru.evict(0) == std::vector<unsigned long long>{ 84, 81 });
+    CHECK(lru.size() == 0);
+    CHECK(lru.totalBytes() == 0);
+}
+
+TEST_CASE("NodeLru: Byte Accounting", "[nodelru]") {
+    NodeLru lru;
+    lru.touch(81, 100);
+    lru.touch(82, 50);
+    CHECK(lru.totalBytes() == 150);
+
+    // A node that is reloaded with a different amount of data replaces its old size
+    lru.touch(81, 300);
+    CHECK(lru.size() == 2);
+    CHECK(lru.totalBytes() == 350);
+    lru.touch(81, 20);
+    CHECK(lru.totalBytes() == 70);
+
+    lru.erase(82);
+    CHECK(lru.totalBytes() == 20);
+    lru.erase(82);
+    CHECK(lru.totalBytes() == 20);
+
+    lru.touch(83, 10);
+    CHECK(lru.evict(25) == std::vector<unsigned long long>{ 81 });
+    CHECK(lru.totalBytes() == 10);
+
+    lru.clear();
+    CHECK(lru.size() == 0);
+    CHECK(lru.totalBytes() == 0);
+}
+
+TEST_CASE("NodeStore: Pack And Lookup", "[nodestore]") {
+    const std::filesystem::path folder =
+        std::filesystem::temp_directory_path() / "test_nodestore";
+    std::filesystem::remove_all(folder);
+    std::filesystem::create_directories(folder);
+
+    writeNodeFile(folder / "0.bin", { 1.f, 2.f, 3.f });
+    writeNodeFile(folder / "07.bin", { 4.f });
+    writeNodeFile(folder / "1.bin", {});
+    // Files that are not named after a node are ignored
+    writeNodeFile(folder / "9.bin", { 5.f });
+    writeNodeFile(folder / "0.txt", { 6.f });
+
+    const std::filesystem::path storePath = folder / NodeStore::FileName;
+    NodeStore::pack(folder, storePath);
+    CHECK_FALSE(std::filesystem::exists(storePath.string() + ".tmp"));
+
+    const NodeStore store = NodeStore(storePath);
+    CHECK(store.numNodes() == 3);
+
+    const std::span<const float> root0 = store.nodeData(80);
+    CHECK(std::vector<float>(root0.begin(), root0.end()) == std::vector{ 1.f, 2.f, 3.f });
+    const std::span<const float> child = store.nodeData(807);
+    CHECK(std::vector<float>(child.begin(), child.end()) == std::vector{ 4.f });
+    CHECK(store.nodeData(81).empty());
+    CHECK(store.nodeData(89).empty());
+    CHECK(store.nodeData(82).empty());
+
+    // Data of every node has to be aligned so that it can be used in place
+    CHECK(reinterpret_cast<uintptr_t>(root0.data()) % 16 == 0);
+    CHECK(reinterpret_cast<uintptr_t>(child.data()) % 16 == 0);
+}
+
+TEST_CASE("NodeStore: Invalid File", "[nodestore]") {
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_nodestore_invalid.store";
+    {
+        std::ofstream file = std::ofstream(path, std::ofstream::binary);
+        file << "This is not a node store file";
+    }
+    CHECK_THROWS_AS(NodeStore(path), ghoul::RuntimeError);
+}
+
+#endif // OPENSPACE_MODULE_GAIA_ENABLED
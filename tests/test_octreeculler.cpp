@@ -0,0 +1,372 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifdef OPENSPACE_MODULE_GAIA_ENABLED
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <modules/gaia/rendering/octreeculler.h>
+#include <modules/gaia/rendering/octreemanager.h>
+#include <openspace/util/distanceconstants.h>
+#include <ghoul/glm.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace openspace;
+
+namespace {
+    // The view frustum in normalized device coordinates that is used by OctreeManager
+    globebrowsing::AABB3 viewFrustum() {
+        globebrowsing::AABB3 box;
+        box.min = glm::vec3(-1.f, -1.f, 0.f);
+        box.max = glm::vec3(1.f, 1.f, 100.f);
+        return box;
+    }
+
+    std::array<glm::dvec4, 8> nodeCorners(const glm::dvec3& origin, double halfSize) {
+        std::array<glm::dvec4, 8> corners;
+        for (int i = 0; i < 8; i++) {
+            const double x = (i % 2 == 0) ? halfSize : -halfSize;
+            const double y = (i % 4 < 2) ? halfSize : -halfSize;
+            const double z = (i < 4) ? halfSize : -halfSize;
+            corners[i] = glm::dvec4(origin + glm::dvec3(x, y, z), 1.0);
+        }
+        return corners;
+    }
+
+    // A camera in the origin that is rotated by `angle` radians around the y axis
+    glm::dmat4 cameraMatrix(double angle, double near, double far) {
+        const glm::dmat4 projection = glm::perspective(
+            glm::radians(60.0),
+            16.0 / 9.0,
+            near,
+            far
+        );
+        const glm::dvec3 direction = glm::dvec3(std::sin(angle), 0.0, -std::cos(angle));
+        const glm::dmat4 view = glm::lookAt(
+            glm::dvec3(0.0),
+            direction,
+            glm::dvec3(0.0, 1.0, 0.0)
+        );
+        return projection * view;
+    }
+
+    // A complete octree that is stored in depth-first order with the same node layout as
+    // the Gaia octree
+    struct SyntheticNode {
+        std::array<glm::dvec4, 8> corners;
+        bool isLeaf = true;
+    };
+
+    void createSyntheticOctree(std::vector<SyntheticNode>& nodes,
+                               const glm::dvec3& origin, double halfSize, int depth)
+    {
+        SyntheticNode node;
+        node.corners = nodeCorners(origin, halfSize);
+        node.isLeaf = depth == 0;
+        nodes.push_back(node);
+        if (depth == 0) {
+            return;
+        }
+
+        const double childSize = halfSize / 2.0;
+        for (int i = 0; i < 8; i++) {
+            const glm::dvec3 childOrigin = origin + glm::dvec3(
+                (i % 2 == 0) ? childSize : -childSize,
+                (i % 4 < 2) ? childSize : -childSize,
+                (i < 4) ? childSize : -childSize
+            );
+            createSyntheticOctree(nodes, childOrigin, childSize, depth - 1);
+        }
+    }
+
+    // Traverses the synthetic octree the same way as OctreeManager::traverseData and
+    // returns the number of nodes that would be rendered. `index` is advanced past the
+    // subtree of the traversed node
+    size_t traverseSyntheticOctree(OctreeCuller& culler,
+                                   const std::vector<SyntheticNode>& nodes,
+                                   size_t& index, int depth, const glm::dmat4& mvp,
+                                   const glm::vec2& screenSize, float lodPixelThreshold)
+    {
+        const SyntheticNode& node = nodes[index];
+        const size_t subtreeSize = (static_cast<size_t>(1) << (3 * (depth + 1))) / 7;
+        const size_t next = index + subtreeSize;
+
+        if (!culler.isVisible(node.corners, mvp)) {
+            index = next;
+            return 0;
+        }
+        if (node.isLeaf) {
+            index = next;
+            return 1;
+        }
+        const glm::vec2 size = culler.getNodeSizeInPixels(screenSize);
+        if (size.x * size.y < lodPixelThreshold) {
+            index = next;
+            return 1;
+        }
+
+        index++;
+        size_t nRendered = 0;
+        for (int i = 0; i < 8; i++) {
+            nRendered += traverseSyntheticOctree(
+                culler,
+                nodes,
+                index,
+                depth - 1,
+                mvp,
+                screenSize,
+                lodPixelThreshold
+            );
+        }
+        return nRendered;
+    }
+
+    void createSyntheticStars(OctreeManager& manager, size_t nStars) {
+        constexpr int MaxDist = 10;
+        manager.initOctree(0, MaxDist, 100);
+
+        std::mt19937 random(1337);
+        std::uniform_real_distribution<float> position(-MaxDist, MaxDist);
+        std::uniform_real_distribution<float> magnitude(0.f, 20.f);
+        std::vector<float> star(8, 0.f);
+        for (size_t i = 0; i < nStars; i++) {
+            star[0] = position(random);
+            star[1] = position(random);
+            star[2] = position(random);
+            star[3] = magnitude(random);
+            manager.insert(star);
+        }
+        manager.sliceLodData();
+        manager.initBufferIndexStack(manager.totalNodes(), false, true);
+    }
+
+    glm::dmat4 starCameraMatrix(double angle) {
+        // The Octree is stored in kiloparsec, but traversed in meters
+        constexpr double KiloParsec = 1000.0 * distanceconstants::Parsec;
+        return cameraMatrix(angle, 1e-6 * KiloParsec, 100.0 * KiloParsec);
+    }
+} // namespace
+
+TEST_CASE("OctreeCuller: Visibility", "[octreeculler]") {
+    OctreeCuller culler = OctreeCuller(viewFrustum());
+    const glm::dmat4 mvp = cameraMatrix(0.0, 0.1, 1000.0);
+
+    CHECK(culler.isVisible(nodeCorners(glm::dvec3(0.0, 0.0, -10.0), 1.0), mvp));
+    CHECK_FALSE(culler.isVisible(nodeCorners(glm::dvec3(0.0, 0.0, 10.0), 1.0), mvp));
+    CHECK_FALSE(culler.isVisible(nodeCorners(glm::dvec3(100.0, 0.0, -10.0), 1.0), mvp));
+    CHECK_FALSE(culler.isVisible(nodeCorners(glm::dvec3(0.0, -100.0, -10.0), 1.0), mvp));
+}
+
+TEST_CASE("OctreeCuller: Node Size", "[octreeculler]") {
+    OctreeCuller culler = OctreeCuller(viewFrustum());
+    const glm::dmat4 mvp = cameraMatrix(0.0, 0.1, 1000.0);
+    const glm::vec2 screenSize = glm::vec2(1920.f, 1080.f);
+
+    const std::array<glm::dvec4, 8> closeNode =
+        nodeCorners(glm::dvec3(0.0, 0.0, -10.0), 1.0);
+    const std::array<glm::dvec4, 8> distantNode =
+        nodeCorners(glm::dvec3(0.0, 0.0, -100.0), 1.0);
+    const glm::vec2 nearSize = culler.getNodeSizeInPixels(closeNode, mvp, screenSize);
+    const glm::vec2 farSize = culler.getNodeSizeInPixels(distantNode, mvp, screenSize);
+    CHECK(nearSize.x > farSize.x);
+    CHECK(nearSize.y > farSize.y);
+
+    // The size of the node that was last checked for visibility is reused
+    REQUIRE(culler.isVisible(closeNode, mvp));
+    const glm::vec2 cachedSize = culler.getNodeSizeInPixels(screenSize);
+    CHECK(cachedSize.x == Catch::Approx(nearSize.x));
+    CHECK(cachedSize.y == Catch::Approx(nearSize.y));
+}
+
+TEST_CASE("OctreeManager: Traversal", "[octreeculler]") {
+    OctreeManager manager;
+    createSyntheticStars(manager, 20000);
+    const glm::dmat4 mvp = starCameraMatrix(0.0);
+    const glm::vec2 screenSize = glm::vec2(1920.f, 1080.f);
+
+    const OctreeManager::TraversalResult& first =
+        manager.traverseData(mvp, screenSize, gaia::RenderMode::Static, 250.f);
+    REQUIRE_FALSE(first.updates.empty());
+    CHECK(first.deltaStars > 0);
+    for (size_t i = 1; i < first.updates.size(); i++) {
+        CHECK(first.updates[i - 1].bufferIndex < first.updates[i].bufferIndex);
+    }
+
+    // Nothing changes if the camera stays in place
+    const OctreeManager::TraversalResult& second =
+        manager.traverseData(mvp, screenSize, gaia::RenderMode::Static, 250.f);
+    CHECK(second.updates.empty());
+    CHECK(second.deltaStars == 0);
+
+    // Turning the camera around removes the previously visible nodes
+    const OctreeManager::TraversalResult& third = manager.traverseData(
+        starCameraMatrix(glm::pi<double>()),
+        screenSize,
+        gaia::RenderMode::Static,
+        250.f
+    );
+    CHECK_FALSE(third.updates.empty());
+}
+
+TEST_CASE("OctreeManager: Asynchronous Traversal", "[octreeculler]") {
+    OctreeManager syncManager;
+    createSyntheticStars(syncManager, 20000);
+    OctreeManager asyncManager;
+    createSyntheticStars(asyncManager, 20000);
+    const glm::vec2 screenSize = glm::vec2(1920.f, 1080.f);
+
+    // No traversal has been started yet
+    CHECK(asyncManager.finishTraversal().updates.empty());
+
+    for (int frame = 0; frame < 8; frame++) {
+        const glm::dmat4 mvp = starCameraMatrix(frame * 0.3);
+
+        const OctreeManager::TraversalResult& expected =
+            syncManager.traverseData(mvp, screenSize, gaia::RenderMode::Color, 250.f);
+
+        asyncManager.beginTraversal(mvp, screenSize, gaia::RenderMode::Color, 250.f);
+        const OctreeManager::TraversalResult& result = asyncManager.finishTraversal();
+
+        CHECK(result.deltaStars == expected.deltaStars);
+        CHECK(result.biggestChunkIndexInUse == expected.biggestChunkIndexInUse);
+        REQUIRE(result.updates.size() == expected.updates.size());
+        for (size_t i = 0; i < result.updates.size(); i++) {
+            const OctreeManager::TraversalResult::Update& a = result.updates[i];
+            const OctreeManager::TraversalResult::Update& b = expected.updates[i];
+            CHECK(a.bufferIndex == b.bufferIndex);
+            const std::span<const float> dataA = result.data(a);
+            const std::span<const float> dataB = expected.data(b);
+            CHECK(std::equal(dataA.begin(), dataA.end(), dataB.begin(), dataB.end()));
+        }
+    }
+}
+
+TEST_CASE("OctreeManager: Toggle Asynchronous Traversal", "[octreeculler]") {
+    // Applies the traversal results to a copy of the streaming buffer, the same way as
+    // RenderableGaiaStars uploads them
+    using Buffer = std::map<int, std::vector<float>>;
+    auto apply = [](Buffer& buffer, const OctreeManager::TraversalResult& result) {
+        for (const OctreeManager::TraversalResult::Update& update : result.updates) {
+            const std::span<const float> data = result.data(update);
+            if (data.empty()) {
+                buffer.erase(update.bufferIndex);
+            }
+            else {
+                buffer[update.bufferIndex].assign(data.begin(), data.end());
+            }
+        }
+        return result.deltaStars;
+    };
+
+    OctreeManager syncManager;
+    createSyntheticStars(syncManager, 20000);
+    OctreeManager toggledManager;
+    createSyntheticStars(toggledManager, 20000);
+    const glm::vec2 screenSize = glm::vec2(1920.f, 1080.f);
+
+    Buffer expected;
+    int nExpectedStars = 0;
+    Buffer buffer;
+    int nStars = 0;
+    for (int frame = 0; frame < 12; frame++) {
+        const glm::dmat4 mvp = starCameraMatrix(frame * 0.3);
+        nExpectedStars += apply(
+            expected,
+            syncManager.traverseData(mvp, screenSize, gaia::RenderMode::Color, 250.f)
+        );
+
+        // Every third frame is traversed synchronously. The asynchronous traversal of
+        // the previous frame is never finished in that case
+        if (frame % 3 == 2) {
+            nStars += apply(
+                buffer,
+                toggledManager.traverseData(
+                    mvp,
+                    screenSize,
+                    gaia::RenderMode::Color,
+                    250.f
+                )
+            );
+            CHECK(nStars == nExpectedStars);
+            CHECK(buffer == expected);
+        }
+        else {
+            nStars += apply(buffer, toggledManager.finishTraversal());
+            toggledManager.beginTraversal(
+                mvp,
+                screenSize,
+                gaia::RenderMode::Color,
+                250.f
+            );
+        }
+    }
+}
+
+TEST_CASE("OctreeCuller: Benchmark", "[.][octreeculler][benchmark]") {
+    // A complete octree with 6 levels below the root has 299593 nodes
+    constexpr int Depth = 6;
+    std::vector<SyntheticNode> nodes;
+    createSyntheticOctree(nodes, glm::dvec3(0.0), 1000.0, Depth);
+
+    OctreeCuller culler = OctreeCuller(viewFrustum());
+    const glm::vec2 screenSize = glm::vec2(1920.f, 1080.f);
+
+    int frame = 0;
+    BENCHMARK("Synthetic octree traversal per frame") {
+        // Rotate the camera a bit every frame, like a user panning around
+        const glm::dmat4 mvp = cameraMatrix(frame * 0.01, 0.1, 1e5);
+        frame++;
+        size_t index = 0;
+        return traverseSyntheticOctree(
+            culler,
+            nodes,
+            index,
+            Depth,
+            mvp,
+            screenSize,
+            250.f
+        );
+    };
+
+    OctreeManager manager;
+    createSyntheticStars(manager, 500000);
+
+    int managerFrame = 0;
+    BENCHMARK("OctreeManager::traverseData per frame") {
+        const glm::dmat4 mvp = starCameraMatrix(managerFrame * 0.01);
+        managerFrame++;
+        return manager.traverseData(mvp, screenSize, gaia::RenderMode::Motion, 250.f)
+            .updates.size();
+    };
+}
+
+#endif // OPENSPACE_MODULE_GAIA_ENABLED
@@ -0,0 +1,265 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <modules/globebrowsing/src/rawtiledatareader.h>
+#include <modules/globebrowsing/src/tilecacheproperties.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <modules/globebrowsing/src/tiletextureinitdata.h>
+#include <cpl_string.h>
+#include <gdal.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace openspace::globebrowsing;
+
+namespace {
+    constexpr int TileSize = 256;
+    // At this level, every tile is read from exactly TileSize x TileSize pixels
+    constexpr int Level = 3;
+    constexpr int RasterWidth = TileSize << (Level + 1);
+    constexpr int RasterHeight = TileSize << Level;
+
+    /**
+     * Creates a tiled and compressed RGB GeoTIFF that covers the whole globe. The
+     * dataset is only written once per test run and is shared between all tests in this
+     * file.
+     *
+     * \return The path to the dataset or an empty string if it could not be created
+     */
+    std::string testDataset() {
+        static const std::string Path = []() -> std::string {
+            GDALAllRegister();
+
+            const std::filesystem::path path =
+                std::filesystem::temp_directory_path() / "test_rawtiledatareader.tif";
+            std::filesystem::remove(path);
+
+            GDALDriverH driver = GDALGetDriverByName("GTiff");
+            if (!driver) {
+                return "";
+            }
+            char** options = nullptr;
+            options = CSLSetNameValue(options, "TILED", "YES");
+            options = CSLSetNameValue(options, "COMPRESS", "DEFLATE");
+            GDALDatasetH dataset = GDALCreate(
+                driver,
+                path.string().c_str(),
+                RasterWidth,
+                RasterHeight,
+                3,
+                GDT_Byte,
+                options
+            );
+            CSLDestroy(options);
+            if (!dataset) {
+                return "";
+            }
+
+            std::array<double, 6> transform = {
+                -180.0, 360.0 / RasterWidth, 0.0,
+                90.0, 0.0, -180.0 / RasterHeight
+            };
+            GDALSetGeoTransform(dataset, transform.data());
+
+            // A pattern that differs between bands and lines so that misplaced reads are
+            // detected, but that still has to be decompressed with some effort
+            std::vector<uint8_t> line(RasterWidth);
+            bool success = true;
+            for (int band = 1; band <= 3; band++) {
+                GDALRasterBandH rasterBand = GDALGetRasterBand(dataset, band);
+                for (int y = 0; y < RasterHeight; y++) {
+                    for (int x = 0; x < RasterWidth; x++) {
+                        line[x] = static_cast<uint8_t>((x * band) ^ (y + x / 7));
+                    }
+                    const CPLErr err = GDALRasterIO(
+                        rasterBand,
+                        GF_Write,
+                        0, y, RasterWidth, 1,
+                        line.data(), RasterWidth, 1,
+                        GDT_Byte,
+                        0, 0
+                    );
+                    success &= (err == CE_None);
+                }
+            }
+            GDALClose(dataset);
+            return success ? path.string() : "";
+        }();
+        return Path;
+    }
+
+    std::unique_ptr<RawTileDataReader> createReader(int nDatasetHandles) {
+        return std::make_unique<RawTileDataReader>(
+            testDataset(),
+            tileTextureInitData(layers::Group::ID::ColorLayers, TileSize),
+            TileCacheProperties(),
+            RawTileDataReader::PerformPreprocessing::No,
+            nDatasetHandles
+        );
+    }
+
+    std::vector<TileIndex> tiles() {
+        std::vector<TileIndex> res;
+        for (uint32_t y = 0; y < (1u << Level); y++) {
+            for (uint32_t x = 0; x < (2u << Level); x++) {
+                res.emplace_back(x, y, static_cast<uint8_t>(Level));
+            }
+        }
+        return res;
+    }
+
+    // Reads all \p indices using \p nThreads threads that all share the same reader
+    std::vector<RawTile> readTiles(const RawTileDataReader& reader,
+                                   const std::vector<TileIndex>& indices, int nThreads)
+    {
+        std::vector<RawTile> res(indices.size());
+        std::vector<std::thread> threads;
+        for (int t = 0; t < nThreads; t++) {
+            threads.emplace_back([&, t]() {
+                for (size_t i = t; i < indices.size(); i += nThreads) {
+                    res[i] = reader.readTileData(indices[i]);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        return res;
+    }
+
+    bool isEqual(const std::vector<RawTile>& lhs, const std::vector<RawTile>& rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < lhs.size(); i++) {
+            const size_t size = lhs[i].textureInitData->totalNumBytes;
+            const bool equal =
+                lhs[i].tileIndex == rhs[i].tileIndex &&
+                lhs[i].error == rhs[i].error &&
+                std::memcmp(lhs[i].imageData.get(), rhs[i].imageData.get(), size) == 0;
+            if (!equal) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+TEST_CASE("RawTileDataReader: Serial Reads", "[rawtiledatareader]") {
+    REQUIRE(!testDataset().empty());
+
+    std::unique_ptr<RawTileDataReader> reader = createReader(1);
+    CHECK(reader->nDatasetHandles() == 1);
+    CHECK(reader->maxChunkLevel() >= Level);
+
+    const std::vector<RawTile> res = readTiles(*reader, tiles(), 1);
+    REQUIRE(res.size() == tiles().size());
+
+    bool allRead = true;
+    bool alphaUntouched = true;
+    for (const RawTile& tile : res) {
+        allRead &= tile.error == RawTile::ReadError::None;
+        // The dataset has no alpha band, so the alpha channel keeps its initial value
+        const size_t size = tile.textureInitData->totalNumBytes;
+        for (size_t i = 3; i < size; i += 4) {
+            alphaUntouched &= tile.imageData[i] == std::byte(0xFF);
+        }
+    }
+    CHECK(allRead);
+    CHECK(alphaUntouched);
+}
+
+TEST_CASE("RawTileDataReader: Concurrent Reads", "[rawtiledatareader]") {
+    REQUIRE(!testDataset().empty());
+
+    std::unique_ptr<RawTileDataReader> serial = createReader(1);
+    const std::vector<RawTile> expected = readTiles(*serial, tiles(), 1);
+
+    std::unique_ptr<RawTileDataReader> concurrent = createReader(4);
+    CHECK(concurrent->nDatasetHandles() == 4);
+    CHECK(isEqual(readTiles(*concurrent, tiles(), 4), expected));
+}
+
+TEST_CASE("RawTileDataReader: More Threads Than Handles", "[rawtiledatareader]") {
+    REQUIRE(!testDataset().empty());
+
+    std::unique_ptr<RawTileDataReader> serial = createReader(1);
+    const std::vector<RawTile> expected = readTiles(*serial, tiles(), 1);
+
+    // The threads that do not get a handle have to wait for one to be released
+    std::unique_ptr<RawTileDataReader> reader = createReader(2);
+    CHECK(isEqual(readTiles(*reader, tiles(), 8), expected));
+}
+
+TEST_CASE("RawTileDataReader: Reset", "[rawtiledatareader]") {
+    REQUIRE(!testDataset().empty());
+
+    std::unique_ptr<RawTileDataReader> reader = createReader(4);
+    const std::vector<RawTile> before = readTiles(*reader, tiles(), 4);
+    reader->reset();
+    CHECK(reader->nDatasetHandles() == 4);
+    CHECK(isEqual(readTiles(*reader, tiles(), 4), before));
+}
+
+TEST_CASE("RawTileDataReader: Throughput", "[.][rawtiledatareader][benchmark]") {
+    REQUIRE(!testDataset().empty());
+
+    const std::vector<TileIndex> indices = tiles();
+    const int nMaxThreads = static_cast<int>(
+        std::max(std::thread::hardware_concurrency(), 1u)
+    );
+
+    BENCHMARK_ADVANCED("1 handle")(Catch::Benchmark::Chronometer meter) {
+        std::unique_ptr<RawTileDataReader> reader = createReader(1);
+        meter.measure([&]() { return readTiles(*reader, indices, 1).size(); });
+    };
+
+    BENCHMARK_ADVANCED("1 handle, shared by all threads")(
+        Catch::Benchmark::Chronometer meter)
+    {
+        std::unique_ptr<RawTileDataReader> reader = createReader(1);
+        meter.measure([&]() { return readTiles(*reader, indices, nMaxThreads).size(); });
+    };
+
+    BENCHMARK_ADVANCED("4 handles")(Catch::Benchmark::Chronometer meter) {
+        std::unique_ptr<RawTileDataReader> reader = createReader(4);
+        meter.measure([&]() { return readTiles(*reader, indices, 4).size(); });
+    };
+
+    BENCHMARK_ADVANCED("1 handle per thread")(Catch::Benchmark::Chronometer meter) {
+        std::unique_ptr<RawTileDataReader> reader = createReader(nMaxThreads);
+        meter.measure([&]() {
+            return readTiles(*reader, indices, nMaxThreads).size();
+        });
+    };
+}
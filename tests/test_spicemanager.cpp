@@ -26,7 +26,11 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <openspace/util/spicemanager.h>
+#include <openspace/util/spicequeryservice.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <algorithm>
+#include <filesystem>
+#include <thread>
 #include "SpiceUsr.h"
 #include "SpiceZpr.h"
 
@@ -97,6 +101,52 @@ namespace {
         CHECK(kernelID == 1);
         return kernelID;
     }
+
+    struct Segment {
+        double start = 0.0;
+        double end = 0.0;
+        double x = 0.0;
+    };
+
+    // Writes an SPK kernel in which the \p body is at rest at (x, 0, 0) relative to the
+    // Sun during each of the \p segments and which has no coverage in between
+    void writeSpkKernel(const std::filesystem::path& path, int body,
+                        const std::vector<Segment>& segments)
+    {
+        std::filesystem::remove(path);
+
+        SpiceInt handle = 0;
+        spkopn_c(path.string().c_str(), "test", 0, &handle);
+        for (const Segment& segment : segments) {
+            const SpiceDouble states[2][6] = {
+                { segment.x, 0.0, 0.0, 0.0, 0.0, 0.0 },
+                { segment.x, 0.0, 0.0, 0.0, 0.0, 0.0 }
+            };
+            spkw08_c(
+                handle,
+                body,
+                10,
+                "J2000",
+                segment.start,
+                segment.end,
+                "test",
+                1,
+                2,
+                states,
+                segment.start,
+                segment.end - segment.start
+            );
+        }
+        spkcls_c(handle);
+        REQUIRE_FALSE(failed_c());
+    }
+
+    double sunCoverageStart() {
+        const std::vector<std::pair<double, double>> coverage =
+            SpiceManager::ref().spkCoverage("SUN");
+        REQUIRE(!coverage.empty());
+        return std::min_element(coverage.begin(), coverage.end())->first;
+    }
 } // namespace
 
 TEST_CASE("SpiceManager: Load Single Kernel", "[spicemanager]") {
@@ -352,6 +402,149 @@ TEST_CASE("SpiceManager: Get Target Position", "[spicemanager]") {
     SpiceManager::deinitialize();
 }
 
+TEST_CASE("SpiceManager: Estimated Target Position", "[spicemanager]") {
+    SpiceManager::initialize();
+
+    loadMetaKernel();
+
+    const std::vector<std::pair<double, double>> coverage =
+        SpiceManager::ref().spkCoverage("CASSINI");
+    REQUIRE(!coverage.empty());
+    const auto first = std::min_element(coverage.begin(), coverage.end());
+    const double start = first->first;
+    const double end = std::max_element(
+        coverage.begin(),
+        coverage.end(),
+        [](const std::pair<double, double>& lhs, const std::pair<double, double>& rhs) {
+            return lhs.second < rhs.second;
+        }
+    )->second;
+
+    const double center = (first->first + first->second) / 2.0;
+    CHECK(SpiceManager::ref().hasSpkCoverage("CASSINI", center));
+    CHECK_FALSE(SpiceManager::ref().hasSpkCoverage("CASSINI", start - 1.0));
+    CHECK_FALSE(SpiceManager::ref().hasSpkCoverage("CASSINI", end + 1.0));
+
+    // Before and after the coverage, the position at the closest boundary is returned,
+    // regardless of how often it is asked for
+    std::array<double, 3> pos = { 0.0, 0.0, 0.0 };
+    double lt = 0.0;
+    spkpos_c("CASSINI", start, "J2000", "NONE", "SUN", pos.data(), &lt);
+    for (int i = 0; i < 2; i++) {
+        const glm::dvec3 estimated = SpiceManager::ref().targetPosition(
+            "CASSINI",
+            "SUN",
+            "J2000",
+            SpiceManager::AberrationCorrection(),
+            start - 86400.0 * (i + 1)
+        );
+        CHECK(pos[0] == Catch::Approx(estimated[0]));
+        CHECK(pos[1] == Catch::Approx(estimated[1]));
+        CHECK(pos[2] == Catch::Approx(estimated[2]));
+    }
+
+    spkpos_c("CASSINI", end, "J2000", "NONE", "SUN", pos.data(), &lt);
+    const glm::dvec3 estimated = SpiceManager::ref().targetPosition(
+        "CASSINI",
+        "SUN",
+        "J2000",
+        SpiceManager::AberrationCorrection(),
+        end + 86400.0
+    );
+    CHECK(pos[0] == Catch::Approx(estimated[0]));
+    CHECK(pos[1] == Catch::Approx(estimated[1]));
+    CHECK(pos[2] == Catch::Approx(estimated[2]));
+
+    SpiceManager::deinitialize();
+}
+
+TEST_CASE("SpiceManager: Estimated Target Position In Coverage Gap", "[spicemanager]") {
+    SpiceManager::initialize();
+
+    loadMetaKernel();
+
+    const double t0 = sunCoverageStart() + 86400.0;
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "test_spicemanager_gap.bsp";
+    writeSpkKernel(
+        path,
+        -999,
+        { { t0, t0 + 1000.0, 1.0 }, { t0 + 2000.0, t0 + 3000.0, 3.0 } }
+    );
+    SpiceManager::ref().loadKernel(path.string());
+
+    CHECK(SpiceManager::ref().hasSpkCoverage("-999", t0 + 500.0));
+    CHECK_FALSE(SpiceManager::ref().hasSpkCoverage("-999", t0 + 1500.0));
+    CHECK(SpiceManager::ref().hasSpkCoverage("-999", t0 + 2500.0));
+
+    // In the gap, the position is interpolated between the end of the first and the
+    // start of the second segment rather than clamped to either of them
+    for (const double t : { 1250.0, 1500.0, 1750.0 }) {
+        const glm::dvec3 estimated = SpiceManager::ref().targetPosition(
+            "-999",
+            "SUN",
+            "J2000",
+            SpiceManager::AberrationCorrection(),
+            t0 + t
+        );
+        const double expected = 1.0 + 2.0 * (t - 1000.0) / 1000.0;
+        CHECK(estimated.x == Catch::Approx(expected));
+        CHECK(estimated.y == Catch::Approx(0.0));
+        CHECK(estimated.z == Catch::Approx(0.0));
+    }
+
+    SpiceManager::deinitialize();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("SpiceManager: Estimated Target Position After Kernel Change", "[spicemanager]")
+{
+    SpiceManager::initialize();
+
+    loadMetaKernel();
+
+    const double t0 = sunCoverageStart() + 86400.0;
+    const std::filesystem::path gapPath =
+        std::filesystem::temp_directory_path() / "test_spicemanager_change_gap.bsp";
+    writeSpkKernel(
+        gapPath,
+        -999,
+        { { t0, t0 + 1000.0, 1.0 }, { t0 + 2000.0, t0 + 3000.0, 3.0 } }
+    );
+    // Covers the first segment of the other kernel again, so the coverage windows stay
+    // the same and only the position at the boundary changes
+    const std::filesystem::path overridePath =
+        std::filesystem::temp_directory_path() / "test_spicemanager_change_override.bsp";
+    writeSpkKernel(overridePath, -999, { { t0, t0 + 1000.0, 5.0 } });
+
+    auto estimate = [t0]() {
+        return SpiceManager::ref().targetPosition(
+            "-999",
+            "SUN",
+            "J2000",
+            SpiceManager::AberrationCorrection(),
+            t0 + 1500.0
+        );
+    };
+
+    SpiceManager::ref().loadKernel(gapPath.string());
+    CHECK(estimate().x == Catch::Approx(2.0));
+
+    // Later kernels take precedence, so the cached boundary position is outdated
+    const SpiceManager::KernelHandle handle =
+        SpiceManager::ref().loadKernel(overridePath.string());
+    CHECK(estimate().x == Catch::Approx(4.0));
+
+    // Unloading the kernel does not change the coverage windows, but the boundary
+    // position has to be computed from the remaining kernel again
+    SpiceManager::ref().unloadKernel(handle);
+    CHECK(estimate().x == Catch::Approx(2.0));
+
+    SpiceManager::deinitialize();
+    std::filesystem::remove(gapPath);
+    std::filesystem::remove(overridePath);
+}
+
 TEST_CASE("SpiceManager: Get Target State", "[spicemanager]") {
     SpiceManager::initialize();
 
@@ -526,3 +719,124 @@ TEST_CASE("SpiceManager: Get Field Of View", "[spicemanager]") {
 
     SpiceManager::deinitialize();
 }
+
+TEST_CASE("SpiceManager: Query Service Target Positions", "[spicemanager]") {
+    SpiceManager::initialize();
+
+    loadMetaKernel();
+
+    double et = 0.0;
+    str2et_c("2004 JUN 11 19:32:00", &et);
+
+    std::vector<double> times;
+    for (int i = 0; i < 100; i++) {
+        times.push_back(et + i * 60.0);
+    }
+
+    const SpiceManager::AberrationCorrection corr = {
+        SpiceManager::AberrationCorrection::Type::LightTimeStellar,
+        SpiceManager::AberrationCorrection::Direction::Reception
+    };
+
+    // Submit the request from a different thread than the one that waits for it
+    TaskFuture<std::vector<glm::dvec3>> future;
+    std::thread t([&]() {
+        future = SpiceManager::ref().queryService().targetPositions(
+            "EARTH",
+            "CASSINI",
+            "J2000",
+            corr,
+            times
+        );
+    });
+    t.join();
+    const std::vector<glm::dvec3> positions = future.get();
+
+    REQUIRE(positions.size() == times.size());
+    for (size_t i = 0; i < times.size(); i++) {
+        std::array<double, 3> pos = { 0.0, 0.0, 0.0 };
+        double lt = 0.0;
+        spkpos_c("EARTH", times[i], "J2000", "LT+S", "CASSINI", pos.data(), &lt);
+        CHECK(pos[0] == Catch::Approx(positions[i].x));
+        CHECK(pos[1] == Catch::Approx(positions[i].y));
+        CHECK(pos[2] == Catch::Approx(positions[i].z));
+    }
+
+    SpiceManager::deinitialize();
+}
+
+TEST_CASE("SpiceManager: Query Service Concurrent Requests", "[spicemanager]") {
+    SpiceManager::initialize();
+
+    loadMetaKernel();
+
+    double et = 0.0;
+    str2et_c("2004 JUN 11 19:32:00", &et);
+
+    std::vector<double> times;
+    for (int i = 0; i < 100; i++) {
+        times.push_back(et + i * 60.0);
+    }
+
+    std::vector<glm::dmat3> reference;
+    for (const double time : times) {
+        reference.push_back(
+            SpiceManager::ref().positionTransformMatrix("CASSINI_HGA", "J2000", time)
+        );
+    }
+
+    // Requests from multiple threads are interleaved with direct calls into the
+    // SpiceManager, which all have to be serialized
+    constexpr int NThreads = 4;
+    std::array<std::vector<glm::dmat3>, NThreads> requested;
+    std::array<std::vector<glm::dmat3>, NThreads> direct;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NThreads; i++) {
+        threads.emplace_back([&, i]() {
+            TaskFuture<std::vector<glm::dmat3>> future =
+                SpiceManager::ref().queryService().positionTransformMatrices(
+                    "CASSINI_HGA",
+                    "J2000",
+                    times
+                );
+            for (const double time : times) {
+                direct[i].push_back(
+                    SpiceManager::ref().positionTransformMatrix(
+                        "CASSINI_HGA",
+                        "J2000",
+                        time
+                    )
+                );
+            }
+            requested[i] = future.get();
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    for (int i = 0; i < NThreads; i++) {
+        REQUIRE(requested[i].size() == reference.size());
+        REQUIRE(direct[i].size() == reference.size());
+        for (size_t j = 0; j < reference.size(); j++) {
+            CHECK(requested[i][j] == reference[j]);
+            CHECK(direct[i][j] == reference[j]);
+        }
+    }
+
+    SpiceManager::deinitialize();
+}
+
+TEST_CASE("SpiceManager: Query Service Forwards Exceptions", "[spicemanager]") {
+    SpiceManager::initialize();
+
+    loadLSKKernel();
+
+    TaskFuture<std::vector<double>> future =
+        SpiceManager::ref().queryService().ephemerisTimesFromDates(
+            { "2004 JUN 11 19:32:00", "not a date" }
+        );
+    CHECK_THROWS_AS(future.get(), SpiceManager::SpiceException);
+
+    SpiceManager::deinitialize();
+}
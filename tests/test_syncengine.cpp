@@ -0,0 +1,233 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <openspace/engine/syncengine.h>
+#include <openspace/util/syncable.h>
+#include <openspace/util/syncbuffer.h>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+    struct TestSyncable : public openspace::Syncable {
+        void encode(openspace::SyncBuffer* syncBuffer) override {
+            syncBuffer->encode(value);
+            syncBuffer->encode(text);
+        }
+
+        void decode(openspace::SyncBuffer* syncBuffer) override {
+            syncBuffer->decode(value);
+            syncBuffer->decode(text);
+        }
+
+        int value = 0;
+        std::string text;
+    };
+
+    // Sends each script only once, in the same way as the ScriptEngine does
+    struct ScriptSyncable : public openspace::Syncable {
+        void encode(openspace::SyncBuffer* syncBuffer) override {
+            syncBuffer->encode(scriptsToSync.size());
+            for (const std::string& s : scriptsToSync) {
+                syncBuffer->encode(s);
+            }
+            scriptsToSync.clear();
+        }
+
+        void decode(openspace::SyncBuffer* syncBuffer) override {
+            size_t nScripts = 0;
+            syncBuffer->decode(nScripts);
+            for (size_t i = 0; i < nScripts; i++) {
+                std::string script;
+                syncBuffer->decode(script);
+                executedScripts.push_back(std::move(script));
+            }
+        }
+
+        std::vector<std::string> scriptsToSync;
+        std::vector<std::string> executedScripts;
+    };
+
+    struct SyncPair {
+        SyncPair(int nSyncables)
+            : master(4096)
+            , client(4096)
+            , masterSyncables(nSyncables)
+            , clientSyncables(nSyncables)
+        {
+            for (int i = 0; i < nSyncables; i++) {
+                master.addSyncable(&masterSyncables[i]);
+                client.addSyncable(&clientSyncables[i]);
+            }
+        }
+
+        openspace::SyncEngine master;
+        openspace::SyncEngine client;
+        std::vector<TestSyncable> masterSyncables;
+        std::vector<TestSyncable> clientSyncables;
+    };
+
+    bool isEqual(const SyncPair& p) {
+        for (size_t i = 0; i < p.masterSyncables.size(); i++) {
+            if (p.masterSyncables[i].value != p.clientSyncables[i].value ||
+                p.masterSyncables[i].text != p.clientSyncables[i].text)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+TEST_CASE("SyncEngine: Full", "[syncengine]") {
+    SyncPair p(3);
+    p.masterSyncables[0].value = 1;
+    p.masterSyncables[1].text = "abc";
+    p.masterSyncables[2].value = 3;
+
+    const std::span<const std::byte> data = p.master.encodeSyncables();
+    p.client.decodeSyncables(data);
+    CHECK(isEqual(p));
+}
+
+TEST_CASE("SyncEngine: Delta", "[syncengine]") {
+    SyncPair p(8);
+    p.master.setDeltaEncoding(true, 10);
+
+    const std::span<const std::byte> keyframe = p.master.encodeSyncables();
+    const size_t keyframeSize = keyframe.size();
+    p.client.decodeSyncables(keyframe);
+    CHECK(isEqual(p));
+
+    // Only a single syncable has changed, so the delta has to be much smaller
+    p.masterSyncables[5].text = "Some text";
+    const std::span<const std::byte> delta = p.master.encodeSyncables();
+    const size_t deltaSize = delta.size();
+    CHECK(deltaSize < keyframeSize);
+    p.client.decodeSyncables(delta);
+    CHECK(isEqual(p));
+    CHECK(p.client.isInSync());
+
+    // Nothing has changed
+    const std::span<const std::byte> empty = p.master.encodeSyncables();
+    CHECK(empty.size() < deltaSize);
+    p.client.decodeSyncables(empty);
+    CHECK(isEqual(p));
+}
+
+TEST_CASE("SyncEngine: Reused Buffer", "[syncengine]") {
+    SyncPair p(4);
+    p.masterSyncables[0].text = "abc";
+
+    // Encoding the same state again has to reuse the memory of the previous frame
+    const std::byte* full = p.master.encodeSyncables().data();
+    CHECK(p.master.encodeSyncables().data() == full);
+
+    p.master.setDeltaEncoding(true, 10);
+    const std::byte* delta = p.master.encodeSyncables().data();
+    p.masterSyncables[1].value = 2;
+    CHECK(p.master.encodeSyncables().data() == delta);
+}
+
+TEST_CASE("SyncEngine: Delta Resynchronization", "[syncengine]") {
+    SyncPair p(4);
+    p.master.setDeltaEncoding(true, 3);
+
+    p.client.decodeSyncables(p.master.encodeSyncables());
+    CHECK(p.client.isInSync());
+
+    // The client misses a frame with a change and is out of sync afterwards
+    p.masterSyncables[1].value = 42;
+    p.master.encodeSyncables();
+    p.masterSyncables[2].value = 7;
+    p.client.decodeSyncables(p.master.encodeSyncables());
+    CHECK_FALSE(p.client.isInSync());
+    CHECK_FALSE(isEqual(p));
+
+    // Frame 3 is the next keyframe
+    p.client.decodeSyncables(p.master.encodeSyncables());
+    CHECK(p.client.isInSync());
+    CHECK(isEqual(p));
+}
+
+TEST_CASE("SyncEngine: Corrupted Keyframe", "[syncengine]") {
+    SyncPair p(2);
+    p.master.setDeltaEncoding(true, 10);
+    p.masterSyncables[0].value = 1;
+
+    const std::span<const std::byte> encoded = p.master.encodeSyncables();
+    std::vector<std::byte> data(encoded.begin(), encoded.end());
+    // Flip one byte of the payload, but not of the header or the checksum
+    data[data.size() / 2] ^= std::byte(0xFF);
+    p.client.decodeSyncables(data);
+    CHECK_FALSE(p.client.isInSync());
+    CHECK(p.clientSyncables[0].value == 0);
+}
+
+TEST_CASE("SyncEngine: Missed Frame Does Not Replay Scripts", "[syncengine]") {
+    openspace::SyncEngine master(4096);
+    openspace::SyncEngine client(4096);
+    ScriptSyncable masterScripts;
+    ScriptSyncable clientScripts;
+    master.addSyncable(&masterScripts);
+    client.addSyncable(&clientScripts);
+    master.setDeltaEncoding(true, 4);
+
+    client.decodeSyncables(master.encodeSyncables());
+
+    masterScripts.scriptsToSync.push_back("openspace.printInfo('a')");
+    client.decodeSyncables(master.encodeSyncables());
+    CHECK(clientScripts.executedScripts.size() == 1);
+
+    // The client misses the frame that removes the script from the synchronized state,
+    // so its stored state still contains the script
+    master.encodeSyncables();
+    client.decodeSyncables(master.encodeSyncables());
+    CHECK_FALSE(client.isInSync());
+    CHECK(clientScripts.executedScripts.size() == 1);
+
+    // Frame 4 is the next keyframe, which does not contain any scripts
+    client.decodeSyncables(master.encodeSyncables());
+    CHECK(client.isInSync());
+    CHECK(clientScripts.executedScripts.size() == 1);
+}
+
+TEST_CASE("SyncEngine: Late Client Waits For Keyframe", "[syncengine]") {
+    SyncPair p(2);
+    p.master.setDeltaEncoding(true, 3);
+    p.master.encodeSyncables();
+
+    // The client has never received the full state, so it cannot apply a delta frame
+    p.masterSyncables[0].value = 5;
+    p.client.decodeSyncables(p.master.encodeSyncables());
+    CHECK_FALSE(p.client.isInSync());
+    CHECK(p.clientSyncables[0].value == 0);
+
+    p.master.encodeSyncables();
+    p.client.decodeSyncables(p.master.encodeSyncables());
+    CHECK(p.client.isInSync());
+    CHECK(isEqual(p));
+}
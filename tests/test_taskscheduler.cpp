@@ -0,0 +1,384 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <openspace/util/taskscheduler.h>
+#include <openspace/util/threadpool.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace openspace;
+
+namespace {
+    // Waits until the provided predicate becomes true or the timeout is reached
+    template <typename Pred>
+    bool waitFor(Pred pred) {
+        using namespace std::chrono;
+        const auto start = steady_clock::now();
+        while (!pred()) {
+            if (steady_clock::now() - start > seconds(10)) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    // A copy of the previous single-lock thread pool that is used as a baseline in the
+    // contention benchmark
+    class SingleLockPool {
+    public:
+        SingleLockPool(size_t numThreads) {
+            for (size_t i = 0; i < numThreads; i++) {
+                _workers.emplace_back([this]() {
+                    while (true) {
+                        std::function<void()> task;
+                        {
+                            std::unique_lock lock(_mutex);
+                            _condition.wait(lock, [this]() {
+                                return _stop || !_tasks.empty();
+                            });
+                            if (_stop) {
+                                return;
+                            }
+                            task = std::move(_tasks.front());
+                            _tasks.pop_front();
+                        }
+                        task();
+                    }
+                });
+            }
+        }
+
+        ~SingleLockPool() {
+            {
+                const std::lock_guard lock(_mutex);
+                _stop = true;
+            }
+            _condition.notify_all();
+            for (std::thread& w : _workers) {
+                w.join();
+            }
+        }
+
+        void enqueue(std::function<void()> f) {
+            {
+                const std::lock_guard lock(_mutex);
+                _tasks.push_back(std::move(f));
+            }
+            _condition.notify_one();
+        }
+
+    private:
+        std::vector<std::thread> _workers;
+        std::deque<std::function<void()>> _tasks;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        bool _stop = false;
+    };
+
+    template <typename Pool>
+    void runContention(Pool& pool, int nProducers, int nTasksPerProducer) {
+        std::atomic_int counter = 0;
+        std::vector<std::thread> producers;
+        for (int i = 0; i < nProducers; i++) {
+            producers.emplace_back([&]() {
+                for (int j = 0; j < nTasksPerProducer; j++) {
+                    pool.enqueue([&counter]() { counter++; });
+                }
+            });
+        }
+        for (std::thread& p : producers) {
+            p.join();
+        }
+        const int total = nProducers * nTasksPerProducer;
+        waitFor([&]() { return counter == total; });
+    }
+} // namespace
+
+TEST_CASE("TaskScheduler: ScheduledTask Small Buffer", "[taskscheduler]") {
+    int value = 0;
+    ScheduledTask small = [&value]() { value = 1; };
+    CHECK(small.isStoredInline());
+    small();
+    CHECK(value == 1);
+
+    std::array<char, 2 * ScheduledTask::InlineSize> large = {};
+    ScheduledTask big = [&value, large]() { value = static_cast<int>(large.size()); };
+    CHECK_FALSE(big.isStoredInline());
+
+    ScheduledTask moved = std::move(big);
+    CHECK_FALSE(static_cast<bool>(big));
+    moved();
+    CHECK(value == static_cast<int>(2 * ScheduledTask::InlineSize));
+}
+
+TEST_CASE("TaskScheduler: Execute", "[taskscheduler]") {
+    TaskScheduler scheduler(4);
+    std::atomic_int counter = 0;
+    for (int i = 0; i < 1000; i++) {
+        scheduler.enqueue([&counter]() { counter++; });
+    }
+    CHECK(waitFor([&]() { return counter == 1000; }));
+    CHECK(scheduler.numQueuedTasks() == 0);
+}
+
+TEST_CASE("TaskScheduler: Priorities", "[taskscheduler]") {
+    TaskScheduler scheduler(1);
+
+    // Block the only worker so that all subsequent tasks are queued up
+    std::promise<void> release;
+    std::shared_future<void> blocker = release.get_future().share();
+    std::atomic_bool isBlocked = false;
+    scheduler.enqueue([&isBlocked, blocker]() {
+        isBlocked = true;
+        blocker.wait();
+    });
+    REQUIRE(waitFor([&]() { return isBlocked.load(); }));
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    auto record = [&order, &orderMutex](int v) {
+        return [&order, &orderMutex, v]() {
+            const std::lock_guard lock(orderMutex);
+            order.push_back(v);
+        };
+    };
+    scheduler.enqueue(record(3), TaskScheduler::Priority::Low);
+    scheduler.enqueue(record(2), TaskScheduler::Priority::Normal);
+    scheduler.enqueue(record(1), TaskScheduler::Priority::High);
+    scheduler.enqueue(record(4), TaskScheduler::Priority::Low);
+    release.set_value();
+
+    REQUIRE(waitFor([&]() {
+        const std::lock_guard lock(orderMutex);
+        return order.size() == 4;
+    }));
+    CHECK(order == std::vector<int>{ 1, 2, 3, 4 });
+}
+
+TEST_CASE("TaskScheduler: Futures", "[taskscheduler]") {
+    TaskScheduler scheduler(2);
+
+    TaskFuture<int> f = scheduler.submit([]() { return 21; });
+    TaskFuture<int> doubled = f.then([](int v) { return v * 2; });
+    TaskFuture<void> done = doubled.then([](int) {});
+    CHECK(doubled.get() == 42);
+    done.wait();
+    CHECK(done.isReady());
+
+    TaskFuture<int> failing = scheduler.submit([]() -> int {
+        throw std::runtime_error("error");
+    });
+    TaskFuture<int> chained = failing.then([](int v) { return v + 1; });
+    CHECK_THROWS_AS(chained.get(), std::runtime_error);
+}
+
+TEST_CASE("TaskScheduler: Work Stealing", "[taskscheduler]") {
+    // All subtasks are enqueued onto the queue of the worker executing the parent task,
+    // so they can only run in parallel if the other workers steal them
+    TaskScheduler scheduler(4);
+    std::mutex idMutex;
+    std::vector<std::thread::id> ids;
+    std::atomic_int counter = 0;
+    scheduler.enqueue([&]() {
+        for (int i = 0; i < 64; i++) {
+            scheduler.enqueue([&]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                {
+                    const std::lock_guard lock(idMutex);
+                    ids.push_back(std::this_thread::get_id());
+                }
+                counter++;
+            });
+        }
+    });
+    REQUIRE(waitFor([&]() { return counter == 64; }));
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    CHECK(ids.size() > 1);
+}
+
+TEST_CASE("TaskScheduler: Clear Tasks", "[taskscheduler]") {
+    TaskScheduler scheduler(1);
+
+    std::promise<void> release;
+    std::shared_future<void> blocker = release.get_future().share();
+    std::atomic_bool isBlocked = false;
+    scheduler.enqueue([&isBlocked, blocker]() {
+        isBlocked = true;
+        blocker.wait();
+    });
+    REQUIRE(waitFor([&]() { return isBlocked.load(); }));
+
+    std::atomic_int counter = 0;
+    for (int i = 0; i < 10; i++) {
+        scheduler.enqueue([&counter]() { counter++; });
+    }
+    TaskFuture<int> f = scheduler.submit([]() { return 1; });
+    CHECK(scheduler.numQueuedTasks() == 11);
+    scheduler.clearTasks();
+    CHECK(scheduler.numQueuedTasks() == 0);
+    release.set_value();
+
+    CHECK_THROWS_AS(f.get(), std::future_error);
+    CHECK(counter == 0);
+}
+
+TEST_CASE("TaskScheduler: Parallel For", "[taskscheduler]") {
+    TaskScheduler scheduler(3);
+
+    for (size_t n : { 0, 1, 7, 100, 1001 }) {
+        std::vector<std::atomic_int> visited(n);
+        std::atomic_int nCalls = 0;
+        scheduler.parallelFor(n, 10, [&](size_t begin, size_t end) {
+            nCalls++;
+            for (size_t i = begin; i < end; i++) {
+                visited[i]++;
+            }
+        });
+        CHECK(std::all_of(
+            visited.begin(),
+            visited.end(),
+            [](const std::atomic_int& v) { return v == 1; }
+        ));
+        // At most one batch per worker thread and one for the calling thread
+        CHECK(nCalls <= 4);
+        CHECK(nCalls <= std::max<int>(static_cast<int>(n) / 10, 1));
+    }
+
+    // Called from a worker thread, everything is done on that thread
+    std::thread::id caller;
+    std::atomic_bool isSameThread = true;
+    scheduler.submit([&]() {
+        caller = std::this_thread::get_id();
+        scheduler.parallelFor(1000, 1, [&](size_t, size_t) {
+            if (std::this_thread::get_id() != caller) {
+                isSameThread = false;
+            }
+        });
+    }).get();
+    CHECK(isSameThread);
+
+    // Exceptions are only rethrown after all batches have finished
+    std::atomic_int nFinished = 0;
+    auto throwing = [&](size_t begin, size_t) {
+        if (begin == 0) {
+            throw std::runtime_error("Error");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        nFinished++;
+    };
+    CHECK_THROWS_AS(scheduler.parallelFor(100, 1, throwing), std::runtime_error);
+    CHECK(nFinished == 3);
+}
+
+TEST_CASE("TaskScheduler: ThreadPool On Shared Scheduler", "[taskscheduler]") {
+    TaskScheduler scheduler(2);
+    std::atomic_int counter = 0;
+    {
+        ThreadPool pool(scheduler);
+        ThreadPool copy(pool);
+        CHECK(&copy.scheduler() == &scheduler);
+        for (int i = 0; i < 100; i++) {
+            pool.enqueue([&counter]() { counter++; });
+        }
+        CHECK(waitFor([&]() { return counter == 100; }));
+        CHECK_FALSE(pool.hasOutstandingTasks());
+    }
+}
+
+TEST_CASE("TaskScheduler: ThreadPool Move-Only Task", "[taskscheduler]") {
+    // The callable is moved into the scheduler without a std::function in between, so
+    // callables that cannot be copied can be enqueued as well
+    ThreadPool pool(1);
+    std::promise<int> result;
+    std::future<int> future = result.get_future();
+    auto value = std::make_unique<int>(42);
+    pool.enqueue([value = std::move(value), &result]() { result.set_value(*value); });
+    CHECK(future.get() == 42);
+}
+
+TEST_CASE("TaskScheduler: ThreadPool Clear Tasks", "[taskscheduler]") {
+    TaskScheduler scheduler(1);
+
+    std::promise<void> release;
+    std::shared_future<void> blocker = release.get_future().share();
+    std::atomic_bool isBlocked = false;
+    scheduler.enqueue([&isBlocked, blocker]() {
+        isBlocked = true;
+        blocker.wait();
+    });
+    REQUIRE(waitFor([&]() { return isBlocked.load(); }));
+
+    // The cleared tasks are still in the shared scheduler and are popped after the
+    // clear, which must not change the number of outstanding tasks
+    std::atomic_int counter = 0;
+    ThreadPool pool(scheduler);
+    for (int i = 0; i < 10; i++) {
+        pool.enqueue([&counter]() { counter++; });
+    }
+    CHECK(pool.hasOutstandingTasks());
+    pool.clearTasks();
+    CHECK_FALSE(pool.hasOutstandingTasks());
+
+    std::atomic_bool isDone = false;
+    pool.enqueue([&isDone]() { isDone = true; });
+    CHECK(pool.hasOutstandingTasks());
+    release.set_value();
+
+    REQUIRE(waitFor([&]() { return isDone.load(); }));
+    REQUIRE(waitFor([&]() { return scheduler.numQueuedTasks() == 0; }));
+    CHECK(counter == 0);
+    CHECK_FALSE(pool.hasOutstandingTasks());
+}
+
+TEST_CASE("TaskScheduler: Contention Benchmark", "[.][taskscheduler][benchmark]") {
+    const int nThreads =
+        static_cast<int>(std::max(std::thread::hardware_concurrency(), 2u));
+    constexpr int NTasks = 20000;
+
+    BENCHMARK("Single lock pool") {
+        SingleLockPool pool(nThreads);
+        runContention(pool, nThreads, NTasks);
+    };
+
+    BENCHMARK("TaskScheduler") {
+        TaskScheduler scheduler(nThreads);
+        runContention(scheduler, nThreads, NTasks);
+    };
+}
@@ -0,0 +1,113 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/globebrowsing/src/temporallookahead.h>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace openspace::globebrowsing;
+
+TEST_CASE("TemporalLookAhead: Upcoming Timesteps", "[temporallookahead]") {
+    CHECK(lookahead::upcomingTimesteps(3, 1, 3, 10) == std::vector{ 4, 5, 6 });
+    CHECK(lookahead::upcomingTimesteps(3, -1, 3, 10) == std::vector{ 2, 1, 0 });
+
+    // The timesteps stop at either end of the dataset
+    CHECK(lookahead::upcomingTimesteps(8, 1, 3, 10) == std::vector{ 9 });
+    CHECK(lookahead::upcomingTimesteps(1, -1, 3, 10) == std::vector{ 0 });
+    CHECK(lookahead::upcomingTimesteps(9, 1, 3, 10).empty());
+    CHECK(lookahead::upcomingTimesteps(0, -1, 3, 10).empty());
+    CHECK(lookahead::upcomingTimesteps(3, 1, 0, 10).empty());
+}
+
+TEST_CASE("TemporalLookAhead: Preloaded Timesteps", "[temporallookahead]") {
+    const std::vector<int> upcoming = { 4, 5, 6, 7 };
+
+    // Only the first missing tile provider is created in an update, but the timesteps
+    // before the next missing one are still preloaded
+    std::set<int> loaded = { 5 };
+    auto hasTileProvider = [&loaded](int timestep) { return loaded.contains(timestep); };
+    CHECK(
+        lookahead::timestepsToPreload(upcoming, hasTileProvider) ==
+        std::vector{ 4, 5 }
+    );
+
+    // Simulates the following updates, which create one tile provider each
+    loaded.insert(4);
+    CHECK(
+        lookahead::timestepsToPreload(upcoming, hasTileProvider) ==
+        std::vector{ 4, 5, 6 }
+    );
+    loaded.insert(6);
+    CHECK(
+        lookahead::timestepsToPreload(upcoming, hasTileProvider) ==
+        std::vector{ 4, 5, 6, 7 }
+    );
+    loaded.insert(7);
+    CHECK(
+        lookahead::timestepsToPreload(upcoming, hasTileProvider) ==
+        std::vector{ 4, 5, 6, 7 }
+    );
+
+    CHECK(lookahead::timestepsToPreload(std::vector<int>(), hasTileProvider).empty());
+}
+
+TEST_CASE("TemporalLookAhead: Retired Tile Providers", "[temporallookahead]") {
+    // Pairs of timestep and the update in which its tile provider was last used
+    const std::vector<std::pair<int, uint64_t>> tileProviders = {
+        { 0, 5 }, { 1, 2 }, { 2, 9 }, { 3, 1 }, { 4, 7 }
+    };
+    auto noneInUse = [](int) { return false; };
+
+    CHECK(lookahead::timestepsToRetire(tileProviders, 5, noneInUse).empty());
+    CHECK(lookahead::timestepsToRetire(tileProviders, 8, noneInUse).empty());
+    CHECK(
+        lookahead::timestepsToRetire(tileProviders, 3, noneInUse) ==
+        std::vector{ 3, 1 }
+    );
+    CHECK(
+        lookahead::timestepsToRetire(tileProviders, 0, noneInUse) ==
+        std::vector{ 3, 1, 0, 4, 2 }
+    );
+
+    // The current and the looked ahead to timesteps are skipped even if they are the
+    // least recently used ones and the next oldest ones are retired instead
+    const std::set<int> inUse = { 3, 0 };
+    auto isInUse = [&inUse](int timestep) { return inUse.contains(timestep); };
+    CHECK(lookahead::timestepsToRetire(tileProviders, 3, isInUse) == std::vector{ 1, 4 });
+
+    // If too many of them are in use, the budget is exceeded
+    CHECK(
+        lookahead::timestepsToRetire(tileProviders, 1, isInUse) ==
+        std::vector{ 1, 4, 2 }
+    );
+
+    // Tile providers with the same last use are retired in the order of their timesteps
+    const std::vector<std::pair<int, uint64_t>> sameUse = {
+        { 7, 1 }, { 2, 1 }, { 5, 1 }
+    };
+    CHECK(lookahead::timestepsToRetire(sameUse, 1, noneInUse) == std::vector{ 2, 5 });
+}
@@ -0,0 +1,199 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/globebrowsing/src/ellipsoid.h>
+#include <modules/globebrowsing/src/tileprefetcher.h>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+using namespace openspace::globebrowsing;
+
+namespace {
+    const Ellipsoid Earth = Ellipsoid(glm::dvec3(6378137.0, 6378137.0, 6356752.3));
+
+    constexpr double FrameTime = 1.0 / 60.0;
+
+    TilePrefetcher::Settings testSettings() {
+        TilePrefetcher::Settings settings;
+        settings.lookAheadTime = 2.0;
+        settings.nSamples = 4;
+        settings.maxTilesPerUpdate = 64;
+        return settings;
+    }
+
+    glm::dvec3 positionAt(double latitude, double longitude, double altitude) {
+        const Geodetic3 g = {
+            .geodetic2 = Geodetic2{ glm::radians(latitude), glm::radians(longitude) },
+            .height = altitude
+        };
+        return Earth.cartesianPosition(g);
+    }
+
+    // A camera that flies along the equator at a constant altitude and speed
+    glm::dvec3 equatorialFlight(double time) {
+        constexpr double Altitude = 200000.0;
+        constexpr double DegreesPerSecond = 1.0;
+        return positionAt(0.0, time * DegreesPerSecond, Altitude);
+    }
+
+    // Replays a camera path through the prefetcher, using the tiles that the chunk tree
+    // would select for the camera as the tiles that are needed in every frame
+    TilePrefetcher::Statistics replay(TilePrefetcher& prefetcher, double duration,
+                                      const std::function<glm::dvec3(double)>& path,
+                                      bool usePlannedPath, bool prefetch = true)
+    {
+        std::vector<TileIndex> needed;
+        for (double t = 0.0; t < duration; t += FrameTime) {
+            const glm::dvec3 camera = path(t);
+
+            needed.clear();
+            TilePrefetcher::selectTiles(Earth, camera, prefetcher.settings(), needed);
+            prefetcher.recordNeededTiles(needed, t);
+
+            if (!prefetch) {
+                continue;
+            }
+
+            std::vector<glm::dvec3> planned;
+            if (usePlannedPath) {
+                const TilePrefetcher::Settings& s = prefetcher.settings();
+                for (int i = 1; i <= s.nSamples; i++) {
+                    planned.push_back(path(t + s.lookAheadTime * i / s.nSamples));
+                }
+            }
+            prefetcher.update(t, camera, planned);
+        }
+        return prefetcher.statistics();
+    }
+} // namespace
+
+TEST_CASE("TilePrefetcher: Select Tiles", "[tileprefetcher]") {
+    const TilePrefetcher::Settings settings = testSettings();
+
+    // Far away from the globe, the chunk tree consists of the minimum level only
+    std::vector<TileIndex> far;
+    TilePrefetcher::selectTiles(Earth, positionAt(0.0, 0.0, 1e10), settings, far);
+    CHECK(far.size() == 8);
+    for (const TileIndex& tile : far) {
+        CHECK(tile.level == settings.minLevel);
+    }
+
+    // Close to the surface, the tiles below the camera are more detailed, but the tiles
+    // still have to cover the entire globe
+    std::vector<TileIndex> close;
+    TilePrefetcher::selectTiles(Earth, positionAt(10.0, 20.0, 1000.0), settings, close);
+    CHECK(close.size() > far.size());
+
+    int maxLevel = 0;
+    double coverage = 0.0;
+    for (const TileIndex& tile : close) {
+        maxLevel = std::max(maxLevel, static_cast<int>(tile.level));
+        coverage += std::pow(0.25, tile.level - 1);
+    }
+    CHECK(maxLevel > 10);
+    CHECK(std::abs(coverage - 2.0) < 1e-9);
+
+    // Both level metrics should agree on the rough amount of detail
+    TilePrefetcher::Settings distance = settings;
+    distance.levelMetric = TilePrefetcher::LevelMetric::Distance;
+    std::vector<TileIndex> byDistance;
+    const glm::dvec3 camera = positionAt(10.0, 20.0, 1000.0);
+    TilePrefetcher::selectTiles(Earth, camera, distance, byDistance);
+    CHECK(byDistance.size() > far.size());
+}
+
+TEST_CASE("TilePrefetcher: Stationary Camera", "[tileprefetcher]") {
+    TilePrefetcher prefetcher(Earth);
+    prefetcher.setSettings(testSettings());
+
+    // A camera that does not move needs no prefetching and never misses a tile
+    const TilePrefetcher::Statistics stats = replay(
+        prefetcher,
+        2.0,
+        [](double) { return positionAt(45.0, 45.0, 5000.0); },
+        false
+    );
+    CHECK(stats.nPrefetched == 0);
+    CHECK(stats.nMisses == 0);
+}
+
+TEST_CASE("TilePrefetcher: Replay Extrapolated Flight", "[tileprefetcher]") {
+    // Without prefetching, every tile that the chunk tree needs is a miss
+    TilePrefetcher baseline(Earth);
+    baseline.setSettings(testSettings());
+    const TilePrefetcher::Statistics none =
+        replay(baseline, 10.0, equatorialFlight, false, false);
+    CHECK(none.nHits == 0);
+    CHECK(none.nMisses > 100);
+
+    // Extrapolating the camera velocity has to predict most of the needed tiles. The
+    // first frames are always misses as the velocity is not known yet
+    TilePrefetcher prefetcher(Earth);
+    prefetcher.setSettings(testSettings());
+    const TilePrefetcher::Statistics stats =
+        replay(prefetcher, 10.0, equatorialFlight, false);
+    CHECK(stats.nHits + stats.nMisses == none.nMisses);
+    CHECK(stats.hitRate() > 0.8);
+    CHECK(stats.nPrefetched >= stats.nHits);
+}
+
+TEST_CASE("TilePrefetcher: Replay Planned Path", "[tileprefetcher]") {
+    // A flight that descends towards the surface while turning, which is poorly
+    // predicted by a straight line
+    auto path = [](double t) {
+        const double altitude = 2000000.0 * std::exp(-0.4 * t) + 2000.0;
+        return positionAt(20.0 * std::sin(0.5 * t), 30.0 * t / 10.0, altitude);
+    };
+
+    TilePrefetcher extrapolated(Earth);
+    extrapolated.setSettings(testSettings());
+    const TilePrefetcher::Statistics e = replay(extrapolated, 10.0, path, false);
+
+    TilePrefetcher planned(Earth);
+    planned.setSettings(testSettings());
+    const TilePrefetcher::Statistics p = replay(planned, 10.0, path, true);
+
+    CHECK(p.nHits + p.nMisses == e.nHits + e.nMisses);
+    CHECK(p.hitRate() > 0.8);
+    CHECK(p.hitRate() >= e.hitRate());
+}
+
+TEST_CASE("TilePrefetcher: Wasted Tiles", "[tileprefetcher]") {
+    TilePrefetcher prefetcher(Earth);
+    prefetcher.setSettings(testSettings());
+
+    // Fly east and suddenly stop; the tiles that were predicted further east are never
+    // used and expire
+    auto path = [](double t) { return equatorialFlight(std::min(t, 3.0)); };
+    const TilePrefetcher::Statistics stats = replay(prefetcher, 10.0, path, false);
+    CHECK(stats.nWasted > 0);
+    CHECK(stats.nHits + stats.nWasted <= stats.nPrefetched);
+
+    prefetcher.resetStatistics();
+    CHECK(prefetcher.statistics().nPrefetched == 0);
+    CHECK(prefetcher.statistics().hitRate() == 0.0);
+}
@@ -0,0 +1,189 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/globebrowsing/src/rawtile.h>
+#include <modules/globebrowsing/src/tileuploadscheduler.h>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace openspace::globebrowsing;
+
+namespace {
+    using Scheduler = cache::TileUploadScheduler<int, std::hash<int>>;
+
+    constexpr size_t TileSize = 64;
+    constexpr size_t TileBytes = TileSize * TileSize * 4;
+
+    RawTile createTile(uint8_t level, std::byte value = std::byte(0)) {
+        RawTile tile;
+        tile.textureInitData = TileTextureInitData(
+            TileSize,
+            TileSize,
+            GL_UNSIGNED_BYTE,
+            ghoul::opengl::Texture::Format::RGBA
+        );
+        tile.imageData = std::unique_ptr<std::byte[]>(new std::byte[TileBytes]);
+        tile.imageData[0] = value;
+        tile.tileIndex = TileIndex(0, 0, level);
+        return tile;
+    }
+
+    // Processes one frame and returns the keys of the uploaded tiles in upload order
+    std::vector<int> processFrame(Scheduler& scheduler, const Scheduler::Budget& budget)
+    {
+        std::vector<int> uploaded;
+        scheduler.process(budget, [&uploaded](int key, RawTile) {
+            uploaded.push_back(key);
+        });
+        return uploaded;
+    }
+} // namespace
+
+TEST_CASE("TileUploadScheduler: Unlimited Budget", "[tileuploadscheduler]") {
+    Scheduler scheduler;
+    for (int i = 0; i < 10; i++) {
+        scheduler.enqueue(i, createTile(5));
+    }
+    CHECK(scheduler.nPending() == 10);
+    CHECK(scheduler.nPendingBytes() == 10 * TileBytes);
+
+    const std::vector<int> uploaded = processFrame(scheduler, Scheduler::Budget());
+    CHECK(uploaded == std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    CHECK(scheduler.nPending() == 0);
+    CHECK(scheduler.nPendingBytes() == 0);
+}
+
+TEST_CASE("TileUploadScheduler: Byte Budget", "[tileuploadscheduler]") {
+    Scheduler scheduler;
+    for (int i = 0; i < 10; i++) {
+        scheduler.enqueue(i, createTile(5));
+    }
+
+    const Scheduler::Budget budget = { .nBytes = 3 * TileBytes + TileBytes / 2 };
+    CHECK(processFrame(scheduler, budget) == std::vector<int>{ 0, 1, 2 });
+    CHECK(scheduler.nPending() == 7);
+    CHECK(processFrame(scheduler, budget) == std::vector<int>{ 3, 4, 5 });
+    CHECK(processFrame(scheduler, budget) == std::vector<int>{ 6, 7, 8 });
+    CHECK(processFrame(scheduler, budget) == std::vector<int>{ 9 });
+    CHECK(processFrame(scheduler, budget).empty());
+    CHECK(scheduler.nPending() == 0);
+}
+
+TEST_CASE("TileUploadScheduler: Budget Smaller Than Tile", "[tileuploadscheduler]") {
+    Scheduler scheduler;
+    scheduler.enqueue(0, createTile(5));
+    scheduler.enqueue(1, createTile(5));
+
+    // A tile that is larger than the budget is still uploaded on its own
+    const Scheduler::Budget budget = { .nBytes = TileBytes / 2 };
+    CHECK(processFrame(scheduler, budget) == std::vector<int>{ 0 });
+    CHECK(processFrame(scheduler, budget) == std::vector<int>{ 1 });
+}
+
+TEST_CASE("TileUploadScheduler: Time Budget", "[tileuploadscheduler]") {
+    Scheduler scheduler;
+    for (int i = 0; i < 10; i++) {
+        scheduler.enqueue(i, createTile(5));
+    }
+
+    const Scheduler::Budget budget = { .milliseconds = 10.0 };
+    int nFrames = 0;
+    while (scheduler.nPending() > 0) {
+        const size_t nUploaded = scheduler.process(budget, [](int, RawTile) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(4));
+        });
+        // Every frame uploads at least one tile, and the third upload exceeds the budget
+        CHECK(nUploaded >= 1);
+        CHECK(nUploaded <= 3);
+        nFrames++;
+    }
+    CHECK(nFrames >= 4);
+}
+
+TEST_CASE("TileUploadScheduler: Priorities", "[tileuploadscheduler]") {
+    Scheduler scheduler;
+    scheduler.enqueue(0, createTile(8));
+    scheduler.enqueue(1, createTile(3));
+    scheduler.enqueue(2, createTile(8));
+    scheduler.enqueue(3, createTile(12));
+    scheduler.enqueue(4, createTile(3));
+
+    // Needed tiles first, then lower levels first, then the order of enqueueing
+    CHECK(scheduler.touch(3));
+    CHECK(scheduler.touch(2));
+    CHECK_FALSE(scheduler.touch(42));
+
+    const std::vector<int> uploaded = processFrame(scheduler, Scheduler::Budget());
+    CHECK(uploaded == std::vector<int>{ 2, 3, 1, 4, 0 });
+}
+
+TEST_CASE("TileUploadScheduler: Needed Tiles Expire", "[tileuploadscheduler]") {
+    Scheduler scheduler;
+    scheduler.enqueue(0, createTile(3));
+    for (int i = 1; i <= 3; i++) {
+        scheduler.enqueue(i, createTile(8));
+        scheduler.touch(i);
+    }
+
+    const Scheduler::Budget budget = { .nBytes = TileBytes };
+    // Touched in the current frame
+    CHECK(processFrame(scheduler, budget) == std::vector<int>{ 1 });
+    // Touched in the previous frame, which still counts as needed
+    CHECK(processFrame(scheduler, budget) == std::vector<int>{ 2 });
+    // No longer needed, so the tile on the lower level is uploaded first
+    CHECK(processFrame(scheduler, budget) == std::vector<int>{ 0 });
+    CHECK(processFrame(scheduler, budget) == std::vector<int>{ 3 });
+}
+
+TEST_CASE("TileUploadScheduler: Replace And Discard", "[tileuploadscheduler]") {
+    Scheduler scheduler;
+    scheduler.enqueue(0, createTile(5, std::byte(1)));
+    scheduler.enqueue(0, createTile(5, std::byte(2)));
+    CHECK(scheduler.nPending() == 1);
+    CHECK(scheduler.nPendingBytes() == TileBytes);
+    CHECK(scheduler.isPending(0));
+
+    RawTile failed = createTile(5);
+    failed.error = RawTile::ReadError::Failure;
+    scheduler.enqueue(1, std::move(failed));
+    CHECK_FALSE(scheduler.isPending(1));
+
+    std::vector<std::byte> values;
+    scheduler.process(Scheduler::Budget(), [&values](int, RawTile tile) {
+        values.push_back(tile.imageData[0]);
+    });
+    CHECK(values == std::vector<std::byte>{ std::byte(2) });
+    CHECK_FALSE(scheduler.isPending(0));
+
+    scheduler.enqueue(2, createTile(5));
+    scheduler.clear();
+    CHECK(scheduler.nPending() == 0);
+    CHECK(scheduler.nPendingBytes() == 0);
+    CHECK(processFrame(scheduler, Scheduler::Budget()).empty());
+}
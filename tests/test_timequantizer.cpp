@@ -50,6 +50,13 @@ namespace {
         CHECK(t.ISO8601() == expected);
     }
 
+    void singleTimestepTest(const globebrowsing::TimeQuantizer& tq,
+                            const std::string& input, const std::string& expected)
+    {
+        const int timestep = tq.timestep(Time::convertTime(input));
+        CHECK(tq.timestepISO8601(timestep) == expected);
+    }
+
     void singleResolutionTest(globebrowsing::TimeQuantizer& tq,
                               const std::string& resolution,
                               const std::string& expectedType, bool expectFailure)
@@ -368,3 +375,65 @@ TEST_CASE("TimeQuantizer: Test start time using constructor", "[timequantizer]")
 
     SpiceManager::deinitialize();
 }
+
+TEST_CASE("TimeQuantizer: Test compiled timesteps", "[timequantizer]") {
+    SpiceManager::initialize();
+
+    loadLSKKernel();
+    globebrowsing::TimeQuantizer t1;
+
+    t1.setStartEndRange("2019-12-09T00:00:00", "2020-03-01T00:00:00");
+    t1.setResolution("1d");
+    CHECK(t1.nTimesteps() == 0);
+    t1.compile();
+    CHECK(t1.nTimesteps() == 84);
+
+    singleTimestepTest(t1, "2020-01-07T05:15:45", "2020-01-07T00:00:00");
+    singleTimestepTest(t1, "2020-01-07T00:00:00", "2020-01-07T00:00:00");
+    singleTimestepTest(t1, "2020-01-06T23:59:59", "2020-01-06T00:00:00");
+    singleTimestepTest(t1, "2020-02-29T00:00:02", "2020-02-29T00:00:00");
+    singleTimestepTest(t1, "2020-03-02T14:00:00", "2020-03-01T00:00:00");
+    singleTimestepTest(t1, "2019-12-05T14:29:00", "2019-12-09T00:00:00");
+
+    // The compiled times have to be the same as the ones from quantizing
+    Time testT;
+    testT.setTime("2020-02-14T18:00:00");
+    const int timestep = t1.timestep(testT.j2000Seconds());
+    t1.quantize(testT, true);
+    CHECK(t1.timestepJ2000(timestep) == testT.j2000Seconds());
+
+    t1.setStartEndRange("2016-05-28T00:00:00", "2021-09-01T00:00:00");
+    t1.setResolution("4d");
+    t1.compile();
+    singleTimestepTest(t1, "2016-06-01T00:00:01", "2016-06-01T00:00:00");
+    singleTimestepTest(t1, "2016-07-03T10:00:00", "2016-07-03T00:00:00");
+    singleTimestepTest(t1, "2016-07-07T00:00:00", "2016-07-07T00:00:00");
+
+    t1.setStartEndRange("2016-01-17T00:00:00", "2020-09-01T00:00:00");
+    t1.setResolution("2M");
+    t1.compile();
+    singleTimestepTest(t1, "2016-03-16T08:15:45", "2016-01-17T00:00:00");
+    singleTimestepTest(t1, "2016-03-17T18:00:02", "2016-03-17T00:00:00");
+    singleTimestepTest(t1, "2017-01-18T05:15:45", "2017-01-17T00:00:00");
+
+    t1.setStartEndRange("2019-12-09T00:00:00", "2030-03-01T00:00:00");
+    t1.setResolution("3y");
+    t1.compile();
+    CHECK(t1.nTimesteps() == 4);
+    singleTimestepTest(t1, "2028-12-08T23:59:59", "2025-12-09T00:00:00");
+    singleTimestepTest(t1, "2028-12-09T00:00:01", "2028-12-09T00:00:00");
+
+    t1.setStartEndRange("2019-02-21T00:00:00", "2021-09-01T00:00:00");
+    t1.setResolution("3h");
+    t1.compile();
+    singleTimestepTest(t1, "2019-02-28T21:10:00", "2019-02-28T21:00:00");
+    singleTimestepTest(t1, "2019-02-28T12:00:00", "2019-02-28T12:00:00");
+
+    t1.setResolution("15m");
+    t1.compile();
+    singleTimestepTest(t1, "2019-02-28T22:29:59", "2019-02-28T22:15:00");
+    singleTimestepTest(t1, "2019-02-28T22:59:59", "2019-02-28T22:45:00");
+    singleTimestepTest(t1, "2019-03-01T00:00:00", "2019-03-01T00:00:00");
+
+    SpiceManager::deinitialize();
+}
@@ -0,0 +1,280 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2024                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <modules/globebrowsing/src/geojson/vectortileengine.h>
+#include <openspace/util/taskscheduler.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace openspace;
+using namespace openspace::globebrowsing;
+
+namespace {
+    using Engine = VectorTileEngine<int>;
+
+    // Records the calls that the engine makes, so that the tests can inspect them
+    struct Recorder {
+        std::vector<TileIndex> uploaded;
+        std::vector<int> uploadedContent;
+        std::vector<TileIndex> released;
+    };
+
+    Engine createEngine(TaskScheduler& scheduler, Recorder& recorder,
+                        Engine::Settings settings = Engine::Settings(),
+                        Engine::CoverageFunction covers =
+                            [](const TileIndex&) { return true; })
+    {
+        return Engine(
+            scheduler,
+            settings,
+            std::move(covers),
+            [&recorder](const TileIndex& tileIndex, int content) {
+                recorder.uploaded.push_back(tileIndex);
+                recorder.uploadedContent.push_back(content);
+            },
+            [&recorder](const TileIndex& tileIndex) {
+                recorder.released.push_back(tileIndex);
+            }
+        );
+    }
+
+    // Updates the engine with the same chunks until all requested tiles are uploaded
+    void updateUntilDone(Engine& engine, const std::vector<TileIndex>& chunks) {
+        for (int i = 0; i < 1000; i++) {
+            engine.update(chunks, 0.0);
+            if (engine.nPendingTiles() == 0) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        FAIL("Tiles were not finished in time");
+    }
+
+    bool contains(const std::vector<TileIndex>& tiles, const TileIndex& tileIndex) {
+        return std::find(tiles.begin(), tiles.end(), tileIndex) != tiles.end();
+    }
+} // namespace
+
+TEST_CASE("VectorTileEngine: Build Desired Tiles", "[vectortileengine]") {
+    TaskScheduler scheduler(2);
+    Recorder recorder;
+    Engine engine = createEngine(scheduler, recorder);
+    engine.setBuildFunction([](const TileIndex& tileIndex) { return tileIndex.level; });
+
+    const std::vector<TileIndex> chunks = { TileIndex(0, 0, 3), TileIndex(1, 0, 3) };
+    updateUntilDone(engine, chunks);
+
+    CHECK(engine.nUploadedTiles() == 2);
+    CHECK(recorder.uploadedContent == std::vector<int>{ 3, 3 });
+    REQUIRE(engine.renderTiles().size() == 2);
+    CHECK(contains(engine.renderTiles(), TileIndex(0, 0, 3)));
+    CHECK(contains(engine.renderTiles(), TileIndex(1, 0, 3)));
+}
+
+TEST_CASE("VectorTileEngine: Maximum Level", "[vectortileengine]") {
+    TaskScheduler scheduler(2);
+    Recorder recorder;
+    Engine engine = createEngine(scheduler, recorder, { .maxLevel = 3 });
+    engine.setBuildFunction([](const TileIndex& tileIndex) { return tileIndex.level; });
+
+    // All four chunks are contained in the same tile on level 3
+    const std::vector<TileIndex> chunks = {
+        TileIndex(8, 4, 5), TileIndex(9, 4, 5), TileIndex(8, 5, 5), TileIndex(9, 5, 5)
+    };
+    updateUntilDone(engine, chunks);
+
+    REQUIRE(recorder.uploaded.size() == 1);
+    CHECK(recorder.uploaded.front() == TileIndex(2, 1, 3));
+    CHECK(engine.renderTiles() == std::vector<TileIndex>{ TileIndex(2, 1, 3) });
+}
+
+TEST_CASE("VectorTileEngine: Coverage", "[vectortileengine]") {
+    TaskScheduler scheduler(2);
+    Recorder recorder;
+    Engine engine = createEngine(
+        scheduler,
+        recorder,
+        Engine::Settings(),
+        [](const TileIndex& tileIndex) { return tileIndex.x == 0; }
+    );
+    engine.setBuildFunction([](const TileIndex& tileIndex) { return tileIndex.level; });
+
+    const std::vector<TileIndex> chunks = { TileIndex(0, 0, 3), TileIndex(1, 0, 3) };
+    updateUntilDone(engine, chunks);
+
+    CHECK(recorder.uploaded == std::vector<TileIndex>{ TileIndex(0, 0, 3) });
+    CHECK(engine.renderTiles() == std::vector<TileIndex>{ TileIndex(0, 0, 3) });
+}
+
+TEST_CASE("VectorTileEngine: Ancestor Fallback", "[vectortileengine]") {
+    TaskScheduler scheduler(2);
+    Recorder recorder;
+    Engine engine = createEngine(scheduler, recorder);
+
+    std::atomic_bool isBlocked = false;
+    engine.setBuildFunction([&isBlocked](const TileIndex& tileIndex) {
+        while (isBlocked) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return tileIndex.level;
+    });
+
+    const TileIndex parent = TileIndex(1, 1, 2);
+    updateUntilDone(engine, { parent });
+    CHECK(engine.renderTiles() == std::vector<TileIndex>{ parent });
+
+    // While the children are built, the parent is rendered in their place, but only once
+    isBlocked = true;
+    const std::vector<TileIndex> children = {
+        parent.child(Quad::NORTH_WEST),
+        parent.child(Quad::NORTH_EAST),
+        parent.child(Quad::SOUTH_WEST),
+        parent.child(Quad::SOUTH_EAST)
+    };
+    engine.update(children, 0.0);
+    CHECK(engine.renderTiles() == std::vector<TileIndex>{ parent });
+    CHECK(engine.nPendingTiles() == 4);
+
+    isBlocked = false;
+    updateUntilDone(engine, children);
+    REQUIRE(engine.renderTiles().size() == 4);
+    for (const TileIndex& child : children) {
+        CHECK(contains(engine.renderTiles(), child));
+    }
+}
+
+TEST_CASE("VectorTileEngine: Mixed Levels Render Once", "[vectortileengine]") {
+    TaskScheduler scheduler(2);
+    Recorder recorder;
+    Engine engine = createEngine(scheduler, recorder);
+
+    std::atomic_bool isBlocked = false;
+    engine.setBuildFunction([&isBlocked](const TileIndex& tileIndex) {
+        while (isBlocked && tileIndex.level > 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return tileIndex.level;
+    });
+
+    // One child is uploaded, the other falls back to the parent, which already contains
+    // the content of the uploaded child
+    const TileIndex parent = TileIndex(0, 0, 2);
+    const TileIndex child = parent.child(Quad::NORTH_WEST);
+    updateUntilDone(engine, { parent, child });
+
+    isBlocked = true;
+    engine.update(std::vector<TileIndex>{ child, parent.child(Quad::SOUTH_EAST) }, 0.0);
+    CHECK(engine.renderTiles() == std::vector<TileIndex>{ parent });
+    isBlocked = false;
+}
+
+TEST_CASE("VectorTileEngine: Release Unused Tiles", "[vectortileengine]") {
+    TaskScheduler scheduler(2);
+    Recorder recorder;
+    Engine engine = createEngine(scheduler, recorder, { .nMaxTiles = 2 });
+    engine.setBuildFunction([](const TileIndex& tileIndex) { return tileIndex.level; });
+
+    updateUntilDone(engine, { TileIndex(0, 0, 3) });
+    updateUntilDone(engine, { TileIndex(1, 0, 3) });
+    CHECK(recorder.released.empty());
+
+    // The least recently used tile is released once there are too many tiles
+    updateUntilDone(engine, { TileIndex(2, 0, 3) });
+    CHECK(recorder.released == std::vector<TileIndex>{ TileIndex(0, 0, 3) });
+    CHECK(engine.nUploadedTiles() == 2);
+
+    // Tiles that are rendered are never released
+    const std::vector<TileIndex> chunks = {
+        TileIndex(1, 0, 3), TileIndex(2, 0, 3), TileIndex(3, 0, 3)
+    };
+    updateUntilDone(engine, chunks);
+    CHECK(recorder.released.size() == 1);
+    CHECK(engine.nUploadedTiles() == 3);
+}
+
+TEST_CASE("VectorTileEngine: Upload Budget", "[vectortileengine]") {
+    TaskScheduler scheduler(2);
+    Recorder recorder;
+    Engine engine = createEngine(scheduler, recorder);
+
+    std::atomic_int nBuilt = 0;
+    engine.setBuildFunction([&nBuilt](const TileIndex& tileIndex) {
+        nBuilt++;
+        return tileIndex.level;
+    });
+
+    const std::vector<TileIndex> chunks = {
+        TileIndex(0, 0, 3), TileIndex(1, 0, 3), TileIndex(2, 0, 3)
+    };
+    engine.update(chunks, 1e-6);
+    while (nBuilt < 3) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    // With a budget that is used up by the first tile, one tile is uploaded per frame
+    engine.update(chunks, 1e-6);
+    CHECK(recorder.uploaded.size() == 1);
+    engine.update(chunks, 1e-6);
+    CHECK(recorder.uploaded.size() == 2);
+    engine.update(chunks, 1e-6);
+    CHECK(recorder.uploaded.size() == 3);
+    CHECK(engine.renderTiles().size() == 3);
+}
+
+TEST_CASE("VectorTileEngine: Replace Build Function", "[vectortileengine]") {
+    TaskScheduler scheduler(2);
+    Recorder recorder;
+    Engine engine = createEngine(scheduler, recorder);
+
+    std::atomic_bool isBlocked = false;
+    engine.setBuildFunction([&isBlocked](const TileIndex&) {
+        while (isBlocked) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return 1;
+    });
+
+    const std::vector<TileIndex> chunks = { TileIndex(0, 0, 3) };
+    updateUntilDone(engine, chunks);
+    CHECK(recorder.uploadedContent == std::vector<int>{ 1 });
+
+    // Outdated tiles are released and tiles that are still built are discarded
+    isBlocked = true;
+    engine.update(std::vector<TileIndex>{ TileIndex(1, 0, 3) }, 0.0);
+    CHECK(engine.nPendingTiles() == 1);
+    engine.setBuildFunction([](const TileIndex&) { return 2; });
+    CHECK(recorder.released == std::vector<TileIndex>{ TileIndex(0, 0, 3) });
+    CHECK(engine.renderTiles().empty());
+    isBlocked = false;
+
+    updateUntilDone(engine, chunks);
+    CHECK(recorder.uploadedContent == std::vector<int>{ 1, 2 });
+    CHECK(engine.renderTiles() == chunks);
+}